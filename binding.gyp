@@ -14,10 +14,39 @@
         "lib/grandi_receive.cc",
         "lib/grandi_framesync.cc",
         "lib/grandi_routing.cc",
+        "lib/grandi_syncgroup.cc",
+        "lib/grandi_avsync.cc",
+        "lib/grandi_clock.cc",
+        "lib/grandi_framerate.cc",
+        "lib/grandi_simd.cc",
+        "lib/grandi_deinterlace.cc",
+        "lib/grandi_fields.cc",
+        "lib/grandi_draw.cc",
+        "lib/grandi_scale.cc",
+        "lib/grandi_thread.cc",
+        "lib/grandi_pool.cc",
+        "lib/grandi_copy.cc",
+        "lib/grandi_alloc.cc",
+        "lib/grandi_budget.cc",
+        "lib/grandi_transfer.cc",
+        "lib/grandi_multiviewer.cc",
+        "lib/grandi_overlay.cc",
+        "lib/grandi_timecode.cc",
+        "lib/grandi_scopes.cc",
+        "lib/grandi_quality.cc",
+        "lib/grandi_hash.cc",
+        "lib/grandi_motion.cc",
+        "lib/grandi_shmring.cc",
+        "lib/grandi_pipe.cc",
+        "lib/grandi_lz4.cc",
+        "lib/grandi_record.cc",
+        "lib/grandi_playback.cc",
         "lib/grandi.cc"
       ],
       "include_dirs": [
-        "<(ndi_include_dir)"
+        "<(ndi_include_dir)",
+        "deps/xxhash",
+        "include"
       ],
       "copies": [
         {
@@ -89,7 +118,8 @@
                 "-Wl,-rpath,'$$ORIGIN'"
               ],
               "libraries": [
-                "-lndi"
+                "-lndi",
+                "-lrt"
               ],
               "library_dirs": [
                 "<(ndi_dir)/lib/lnx-x64"
@@ -114,7 +144,8 @@
                 "-Wl,-rpath,'$$ORIGIN'"
               ],
               "libraries": [
-                "-lndi"
+                "-lndi",
+                "-lrt"
               ],
               "library_dirs": [
                 "<(ndi_dir)/lib/lnx-armv7l"
@@ -139,7 +170,8 @@
                 "-Wl,-rpath,'$$ORIGIN'"
               ],
               "libraries": [
-                "-lndi"
+                "-lndi",
+                "-lrt"
               ],
               "library_dirs": [
                 "<(ndi_dir)/lib/lnx-arm64"
@@ -76,6 +76,11 @@ export default defineConfig({
 						{ text: "Receive media", link: "/guide/receiving" },
 						{ text: "Send media", link: "/guide/sending" },
 						{ text: "Frame synchronization", link: "/guide/frame-sync" },
+						{ text: "Sync groups", link: "/guide/sync-groups" },
+						{ text: "Multiviewer", link: "/guide/multiviewer" },
+						{ text: "Shared memory", link: "/guide/shared-memory" },
+						{ text: "Pipe to an encoder", link: "/guide/pipes" },
+						{ text: "Record to disk", link: "/guide/recording" },
 						{ text: "Route sources", link: "/guide/routing" },
 					],
 				},
@@ -0,0 +1,343 @@
+/* Copyright 2025 Sarhan Aissi <github@tux.tn>.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+*/
+
+/*
+ * Layout of the POSIX shared-memory frame rings that grandi.publishShm()
+ * writes and grandi.sendShm() reads, with helpers for the processes on the
+ * other side. The header is C99 and
+ * depends only on libc; copy it into the reader's source tree. It needs the
+ * POSIX and syscall declarations of gnu99, or _DEFAULT_SOURCE with c99.
+ *
+ * A ring is a grandi_shm_header, slot_count grandi_shm_slot descriptors, and
+ * slot_count data areas of slot_bytes each, starting at data_offset. Frame n
+ * lives in slot n % slot_count. Every slot is a seqlock: its sequence is odd
+ * while the writer fills it and 2 * n + 2 once frame n is complete. Readers
+ * use frame data in place and check afterwards that the slot was not
+ * overwritten meanwhile:
+ *
+ *   size_t size;
+ *   grandi_shm_header *ring = grandi_shm_map("/studio-cam-1", 0, &size);
+ *   uint64_t next = grandi_shm_load(&ring->write_count);
+ *   while (grandi_shm_load32(&ring->state) == GRANDI_SHM_OPEN) {
+ *     uint32_t seen = grandi_shm_load32(&ring->write_futex);
+ *     if (grandi_shm_load(&ring->write_count) == next) {
+ *       grandi_shm_wait(&ring->write_futex, seen, 1000);
+ *       continue;
+ *     }
+ *     const grandi_shm_slot *slot = grandi_shm_begin_read(ring, next);
+ *     if (slot != NULL) {
+ *       encode(slot, grandi_shm_slot_data(ring, next));
+ *       if (!grandi_shm_end_read(slot, next))
+ *         discard();  // overwritten while encoding: the reader fell behind
+ *     }
+ *     next++;
+ *   }
+ *   grandi_shm_unmap(ring, size);
+ *
+ * Rings that grandi.sendShm() reads are created and written by the other
+ * process, with at least 2 slots. Its writer waits until grandi released
+ * the frame that last used a slot, so no frame is overwritten while the NDI
+ * SDK still sends it. The frame sent last stays held until the next one, or
+ * until grandi sees the ring closed:
+ *
+ *   grandi_shm_header *ring = grandi_shm_create("/renderer", 4, bytes, &size);
+ *   for (uint64_t frame = 0; running; frame++) {
+ *     while (!grandi_shm_wait_writable(ring, frame, 1000))
+ *       ;
+ *     grandi_shm_slot *slot = grandi_shm_begin_write(ring, frame);
+ *     render(slot, grandi_shm_slot_data(ring, frame));
+ *     grandi_shm_end_write(ring, slot, frame);
+ *   }
+ *   grandi_shm_close(ring);
+ *   grandi_shm_unmap(ring, size);
+ *   shm_unlink("/renderer");
+ *
+ * Notifications use futexes on Linux. Elsewhere grandi_shm_wait polls.
+ */
+
+#ifndef GRANDI_SHM_H
+#define GRANDI_SHM_H
+
+#include <errno.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* "GSHM" read as a little-endian 32-bit word. */
+#define GRANDI_SHM_MAGIC 0x4d485347u
+#define GRANDI_SHM_VERSION 1u
+/* data_offset and slot_bytes are multiples of this. */
+#define GRANDI_SHM_ALIGNMENT 4096u
+
+#define GRANDI_SHM_OPEN 1u
+#define GRANDI_SHM_CLOSED 2u
+
+/* Describes the frame in one slot. Fields other than sequence are only
+   meaningful between a successful begin_read and end_read. */
+typedef struct grandi_shm_slot {
+  uint64_t sequence;
+  uint64_t frame;
+  /* NDI timecode and timestamp in 100 ns units; timestamp is INT64_MAX
+     when the SDK did not provide one. Writers for grandi.sendShm() set
+     timecode to INT64_MAX to have the SDK synthesize it; timestamp is not
+     sent. */
+  int64_t timecode;
+  int64_t timestamp;
+  /* NDIlib_FourCC_video_type_e and NDIlib_frame_format_type_e values. */
+  uint32_t fourcc;
+  int32_t frame_format_type;
+  int32_t xres;
+  int32_t yres;
+  int32_t line_stride;
+  int32_t frame_rate_n;
+  int32_t frame_rate_d;
+  float picture_aspect_ratio;
+  /* Bytes of frame data at the start of the slot's data area, laid out as
+     the SDK delivers it: line_stride * yres for one plane, plus the chroma
+     planes that follow for P216, PA16, NV12, I420, and YV12. */
+  uint64_t data_size;
+  uint64_t reserved[3];
+} grandi_shm_slot;
+
+typedef struct grandi_shm_header {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t slot_count;
+  /* GRANDI_SHM_OPEN, then GRANDI_SHM_CLOSED once the writer is gone. */
+  uint32_t state;
+  uint64_t slot_bytes;
+  uint64_t data_offset;
+  uint64_t total_bytes;
+  /* Frames completed; the next frame written is number write_count. */
+  uint64_t write_count;
+  /* Frames the consumer has released, for rings that grandi reads from.
+     Writers must not reuse a slot until its frame has been released. */
+  uint64_t read_count;
+  /* Incremented after every completed frame and on close. */
+  uint32_t write_futex;
+  /* Incremented after every release. */
+  uint32_t read_futex;
+  uint64_t reserved[4];
+} grandi_shm_header;
+
+static inline uint64_t grandi_shm_load(const uint64_t *word) {
+  return __atomic_load_n(word, __ATOMIC_ACQUIRE);
+}
+
+static inline uint32_t grandi_shm_load32(const uint32_t *word) {
+  return __atomic_load_n(word, __ATOMIC_ACQUIRE);
+}
+
+/* Bytes before the first data area of a ring with slot_count slots. */
+static inline uint64_t grandi_shm_data_offset(uint32_t slot_count) {
+  uint64_t used = sizeof(grandi_shm_header) +
+                  (uint64_t)slot_count * sizeof(grandi_shm_slot);
+  return (used + GRANDI_SHM_ALIGNMENT - 1) / GRANDI_SHM_ALIGNMENT *
+         GRANDI_SHM_ALIGNMENT;
+}
+
+static inline grandi_shm_slot *grandi_shm_slot_at(const grandi_shm_header *ring,
+                                                  uint64_t frame) {
+  return (grandi_shm_slot *)(ring + 1) + frame % ring->slot_count;
+}
+
+static inline uint8_t *grandi_shm_slot_data(const grandi_shm_header *ring,
+                                            uint64_t frame) {
+  return (uint8_t *)ring + ring->data_offset +
+         frame % ring->slot_count * ring->slot_bytes;
+}
+
+/* Returns the slot of frame, or NULL when frame is not complete yet or its
+   slot already holds a later frame. */
+static inline const grandi_shm_slot *
+grandi_shm_begin_read(const grandi_shm_header *ring, uint64_t frame) {
+  const grandi_shm_slot *slot = grandi_shm_slot_at(ring, frame);
+  if (__atomic_load_n(&slot->sequence, __ATOMIC_ACQUIRE) != 2 * frame + 2)
+    return NULL;
+  return slot;
+}
+
+/* Returns nonzero when frame was not overwritten since begin_read, so what
+   was read from the slot and its data is consistent. */
+static inline int grandi_shm_end_read(const grandi_shm_slot *slot,
+                                      uint64_t frame) {
+  __atomic_thread_fence(__ATOMIC_ACQUIRE);
+  return __atomic_load_n(&slot->sequence, __ATOMIC_RELAXED) == 2 * frame + 2;
+}
+
+/* Marks the slot of frame as being written. */
+static inline grandi_shm_slot *grandi_shm_begin_write(grandi_shm_header *ring,
+                                                      uint64_t frame) {
+  grandi_shm_slot *slot = grandi_shm_slot_at(ring, frame);
+  __atomic_store_n(&slot->sequence, 2 * frame + 1, __ATOMIC_RELAXED);
+  __atomic_thread_fence(__ATOMIC_RELEASE);
+  return slot;
+}
+
+#if defined(__linux__)
+static inline void grandi_shm_wake(uint32_t *word) {
+  syscall(SYS_futex, word, FUTEX_WAKE, INT32_MAX, NULL, NULL, 0);
+}
+
+/* Blocks while *word equals seen, for at most timeout_ms. */
+static inline void grandi_shm_wait(const uint32_t *word, uint32_t seen,
+                                   uint32_t timeout_ms) {
+  struct timespec timeout;
+  timeout.tv_sec = timeout_ms / 1000;
+  timeout.tv_nsec = (long)(timeout_ms % 1000) * 1000000L;
+  syscall(SYS_futex, word, FUTEX_WAIT, seen, &timeout, NULL, 0);
+}
+#else
+static inline void grandi_shm_wake(uint32_t *word) { (void)word; }
+
+static inline void grandi_shm_wait(const uint32_t *word, uint32_t seen,
+                                   uint32_t timeout_ms) {
+  struct timespec step;
+  step.tv_sec = 0;
+  step.tv_nsec = 500000L;
+  for (uint32_t waited = 0; waited < timeout_ms * 2; waited++) {
+    if (__atomic_load_n(word, __ATOMIC_ACQUIRE) != seen)
+      return;
+    nanosleep(&step, NULL);
+  }
+}
+#endif
+
+/* Publishes frame after its slot and data were filled, then wakes readers. */
+static inline void grandi_shm_end_write(grandi_shm_header *ring,
+                                        grandi_shm_slot *slot,
+                                        uint64_t frame) {
+  slot->frame = frame;
+  __atomic_store_n(&slot->sequence, 2 * frame + 2, __ATOMIC_RELEASE);
+  __atomic_store_n(&ring->write_count, frame + 1, __ATOMIC_RELEASE);
+  __atomic_add_fetch(&ring->write_futex, 1, __ATOMIC_RELEASE);
+  grandi_shm_wake(&ring->write_futex);
+}
+
+/* Marks every frame before frame as released and wakes writers. */
+static inline void grandi_shm_release(grandi_shm_header *ring, uint64_t frame) {
+  __atomic_store_n(&ring->read_count, frame, __ATOMIC_RELEASE);
+  __atomic_add_fetch(&ring->read_futex, 1, __ATOMIC_RELEASE);
+  grandi_shm_wake(&ring->read_futex);
+}
+
+/* Waits for at most timeout_ms until the slot of frame holds no frame the
+   reader still uses. Returns nonzero when frame can be written. */
+static inline int grandi_shm_wait_writable(grandi_shm_header *ring,
+                                           uint64_t frame,
+                                           uint32_t timeout_ms) {
+  uint32_t seen = grandi_shm_load32(&ring->read_futex);
+  if (frame - grandi_shm_load(&ring->read_count) < ring->slot_count)
+    return 1;
+  grandi_shm_wait(&ring->read_futex, seen, timeout_ms);
+  return frame - grandi_shm_load(&ring->read_count) < ring->slot_count;
+}
+
+/* Marks the ring closed and wakes readers. */
+static inline void grandi_shm_close(grandi_shm_header *ring) {
+  __atomic_store_n(&ring->state, GRANDI_SHM_CLOSED, __ATOMIC_RELEASE);
+  __atomic_add_fetch(&ring->write_futex, 1, __ATOMIC_RELEASE);
+  grandi_shm_wake(&ring->write_futex);
+}
+
+/* Creates and maps a new ring, failing with errno EEXIST when the name is
+   taken. slot_bytes is rounded up to GRANDI_SHM_ALIGNMENT. Returns NULL with
+   errno set on failure; *size receives the length to pass to unmap. */
+static inline grandi_shm_header *grandi_shm_create(const char *name,
+                                                   uint32_t slot_count,
+                                                   uint64_t slot_bytes,
+                                                   size_t *size) {
+  slot_bytes = (slot_bytes + GRANDI_SHM_ALIGNMENT - 1) / GRANDI_SHM_ALIGNMENT *
+               GRANDI_SHM_ALIGNMENT;
+  uint64_t data_offset = grandi_shm_data_offset(slot_count);
+  uint64_t total = data_offset + (uint64_t)slot_count * slot_bytes;
+  int fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0600);
+  if (fd < 0)
+    return NULL;
+  void *mapping = MAP_FAILED;
+  if (ftruncate(fd, (off_t)total) == 0)
+    mapping = mmap(NULL, (size_t)total, PROT_READ | PROT_WRITE, MAP_SHARED,
+                   fd, 0);
+  int error = errno;
+  close(fd);
+  if (mapping == MAP_FAILED) {
+    shm_unlink(name);
+    errno = error;
+    return NULL;
+  }
+  /* ftruncate zero-fills, so every slot starts with sequence 0: empty. */
+  grandi_shm_header *ring = (grandi_shm_header *)mapping;
+  ring->magic = GRANDI_SHM_MAGIC;
+  ring->version = GRANDI_SHM_VERSION;
+  ring->slot_count = slot_count;
+  ring->slot_bytes = slot_bytes;
+  ring->data_offset = data_offset;
+  ring->total_bytes = total;
+  __atomic_store_n(&ring->state, GRANDI_SHM_OPEN, __ATOMIC_RELEASE);
+  *size = (size_t)total;
+  return ring;
+}
+
+/* Maps an existing ring and checks its magic and version. Returns NULL with
+   errno set on failure; *size receives the length to pass to unmap. */
+static inline grandi_shm_header *grandi_shm_map(const char *name, int writable,
+                                                size_t *size) {
+  int fd = shm_open(name, writable ? O_RDWR : O_RDONLY, 0);
+  if (fd < 0)
+    return NULL;
+  struct stat info;
+  void *mapping = MAP_FAILED;
+  if (fstat(fd, &info) == 0 &&
+      (size_t)info.st_size >= sizeof(grandi_shm_header))
+    mapping = mmap(NULL, (size_t)info.st_size,
+                   writable ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED,
+                   fd, 0);
+  close(fd);
+  if (mapping == MAP_FAILED)
+    return NULL;
+  grandi_shm_header *ring = (grandi_shm_header *)mapping;
+  if (ring->magic != GRANDI_SHM_MAGIC || ring->version != GRANDI_SHM_VERSION ||
+      ring->total_bytes > (uint64_t)info.st_size) {
+    munmap(mapping, (size_t)info.st_size);
+    errno = EINVAL;
+    return NULL;
+  }
+  *size = (size_t)info.st_size;
+  return ring;
+}
+
+static inline void grandi_shm_unmap(grandi_shm_header *ring, size_t size) {
+  munmap(ring, size);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* GRANDI_SHM_H */
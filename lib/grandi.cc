@@ -15,6 +15,7 @@
 
 #include <cstdio>
 #include <chrono>
+#include <mutex>
 #include <Processing.NDI.Lib.h>
 
 #ifdef _WIN32
@@ -31,6 +32,23 @@
 #include "grandi_receive.h"
 #include "grandi_framesync.h"
 #include "grandi_routing.h"
+#include "grandi_syncgroup.h"
+#include "grandi_clock.h"
+#include "grandi_fields.h"
+#include "grandi_multiviewer.h"
+#include "grandi_timecode.h"
+#include "grandi_quality.h"
+#include "grandi_hash.h"
+#include "grandi_shmring.h"
+#include "grandi_pipe.h"
+#include "grandi_record.h"
+#include "grandi_playback.h"
+#include "grandi_pool.h"
+#include "grandi_copy.h"
+#include "grandi_alloc.h"
+#include "grandi_budget.h"
+#include "grandi_thread.h"
+#include "grandi_transfer.h"
 #include "node_api.h"
 
 napi_value version(napi_env env, napi_callback_info info) {
@@ -54,10 +72,51 @@ napi_value isSupportedCPU(napi_env env, napi_callback_info info) {
   return result;
 }
 
+namespace {
+// Worker threads that load the addon get their own napi_env and exports,
+// but the SDK and every static here, the transfer registry, frame allocator,
+// and frame budget included, are shared by the whole process. So
+// initialize() and destroy() count the environments that hold the SDK and
+// only the last destroy() tears it down.
+std::mutex runtimeMutex;
+uint32_t runtimeUsers = 0;
+
+struct envState {
+  bool initialized = false;
+};
+
+envState *currentEnvState(napi_env env) {
+  void *data = nullptr;
+  if (napi_get_instance_data(env, &data) != napi_ok)
+    return nullptr;
+  return (envState *)data;
+}
+
+// Runs when an environment, typically a worker's, shuts down without
+// calling destroy(). Its hold is dropped but the SDK is left running, since
+// frames of other environments may still be in flight.
+void cleanupEnvState(void *data) {
+  envState *state = (envState *)data;
+  {
+    std::lock_guard<std::mutex> lock(runtimeMutex);
+    if (state->initialized)
+      runtimeUsers--;
+  }
+  delete state;
+}
+} // namespace
+
 napi_value initialize(napi_env env, napi_callback_info info) {
   napi_status status;
 
   bool ok = NDIlib_initialize();
+  envState *state = currentEnvState(env);
+  if (ok && state != nullptr) {
+    std::lock_guard<std::mutex> lock(runtimeMutex);
+    if (!state->initialized)
+      runtimeUsers++;
+    state->initialized = true;
+  }
   napi_value result;
   status = napi_get_boolean(env, ok, &result);
   CHECK_STATUS;
@@ -68,7 +127,19 @@ napi_value initialize(napi_env env, napi_callback_info info) {
 napi_value destroy(napi_env env, napi_callback_info info) {
   napi_status status;
 
-  NDIlib_destroy();
+  envState *state = currentEnvState(env);
+  {
+    std::lock_guard<std::mutex> lock(runtimeMutex);
+    if (state != nullptr && state->initialized) {
+      state->initialized = false;
+      runtimeUsers--;
+    }
+    if (runtimeUsers == 0) {
+      // Instances no environment adopted cannot outlive the runtime.
+      destroyDetached();
+      NDIlib_destroy();
+    }
+  }
   napi_value result;
   status = napi_get_boolean(env, true, &result);
   CHECK_STATUS;
@@ -78,6 +149,17 @@ napi_value destroy(napi_env env, napi_callback_info info) {
 
 napi_value Init(napi_env env, napi_value exports) {
   napi_status status;
+  envState *state = new (std::nothrow) envState;
+  if (state == nullptr)
+    NAPI_THROW_ERROR("Failed to allocate addon state.");
+  status = napi_add_env_cleanup_hook(env, cleanupEnvState, state);
+  if (status != napi_ok) {
+    delete state;
+    CHECK_STATUS;
+  }
+  // Freed by the cleanup hook from here on.
+  status = napi_set_instance_data(env, state, nullptr, nullptr);
+  CHECK_STATUS;
   napi_property_descriptor desc[] = {
       DECLARE_NAPI_METHOD("version", version),
       DECLARE_NAPI_METHOD("isSupportedCPU", isSupportedCPU),
@@ -87,7 +169,36 @@ napi_value Init(napi_env env, napi_value exports) {
       DECLARE_NAPI_METHOD("send", send),
       DECLARE_NAPI_METHOD("receive", receive),
       DECLARE_NAPI_METHOD("framesync", framesync),
-      DECLARE_NAPI_METHOD("routing", routing)};
+      DECLARE_NAPI_METHOD("routing", routing),
+      DECLARE_NAPI_METHOD("syncGroup", syncGroup),
+      DECLARE_NAPI_METHOD("multiviewer", multiviewer),
+      DECLARE_NAPI_METHOD("clockNow", clockNow),
+      DECLARE_NAPI_METHOD("clockToMonotonic", clockToMonotonic),
+      DECLARE_NAPI_METHOD("clockSources", clockSources),
+      DECLARE_NAPI_METHOD("splitFields", splitFields),
+      DECLARE_NAPI_METHOD("weaveFields", weaveFields),
+      DECLARE_NAPI_METHOD("formatTimecode", formatTimecode),
+      DECLARE_NAPI_METHOD("frameTimecode", frameTimecode),
+      DECLARE_NAPI_METHOD("compareFrames", compareFrames),
+      DECLARE_NAPI_METHOD("hashFrame", hashFrame),
+      DECLARE_NAPI_METHOD("publishShm", publishShm),
+      DECLARE_NAPI_METHOD("sendShm", sendShm),
+      DECLARE_NAPI_METHOD("pipe", pipeFrames),
+      DECLARE_NAPI_METHOD("record", record),
+      DECLARE_NAPI_METHOD("openRecording", openRecording),
+      DECLARE_NAPI_METHOD("workerThreads", workerThreads),
+      DECLARE_NAPI_METHOD("setWorkerThreads", setWorkerThreads),
+      DECLARE_NAPI_METHOD("copyStrategy", copyStrategy),
+      DECLARE_NAPI_METHOD("setCopyStrategy", setCopyStrategy),
+      DECLARE_NAPI_METHOD("copyBuffer", copyBuffer),
+      DECLARE_NAPI_METHOD("frameAllocator", frameAllocator),
+      DECLARE_NAPI_METHOD("setFrameAllocator", setFrameAllocator),
+      DECLARE_NAPI_METHOD("frameAllocatorStats", frameAllocatorStats),
+      DECLARE_NAPI_METHOD("frameBudget", frameBudget),
+      DECLARE_NAPI_METHOD("setFrameBudget", setFrameBudget),
+      DECLARE_NAPI_METHOD("frameBudgetStats", frameBudgetStats),
+      DECLARE_NAPI_METHOD("threadTopology", threadTopology),
+      DECLARE_NAPI_METHOD("adopt", adopt)};
   status = napi_define_properties(env, exports, sizeof(desc) / sizeof(desc[0]),
                                   desc);
   CHECK_STATUS;
@@ -0,0 +1,415 @@
+/* Copyright 2025 Sarhan Aissi <github@tux.tn>.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+*/
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#include <malloc.h>
+#else
+#include <sys/mman.h>
+#endif
+
+#include "grandi_alloc.h"
+#include "grandi_budget.h"
+#include "grandi_util.h"
+
+#if defined(__linux__) && defined(MADV_HUGEPAGE) && defined(MAP_HUGETLB)
+#define GRANDI_HUGE_PAGES 1
+#endif
+
+namespace {
+const size_t kPageBytes = 4096;
+// Low token bit marking a hugetlbfs mapping; capacities are multiples of
+// kFrameAlignment, so the low bits are free.
+const uintptr_t kMappedBlock = 1;
+const size_t kMaxCachedBlocks = 64;
+// Largest integer a JavaScript number holds exactly.
+const double kMaxCacheBytes = 9007199254740991.0;
+
+const char *modeNames[3] = {"off", "transparent", "hugetlb"};
+
+struct cachedBlock {
+  void *data;
+  uintptr_t token;
+};
+
+struct frameAllocatorState {
+  std::mutex mutex;
+  // Released page-aligned blocks, oldest first. Guarded by mutex, like the
+  // settings below.
+  std::vector<cachedBlock> cache;
+  size_t cachedBytes = 0;
+  size_t cacheLimit = kDefaultFrameCacheBytes;
+  hugePageMode mode = hugePageMode::transparent;
+
+  std::atomic<uint64_t> allocations{0};
+  std::atomic<uint64_t> recycled{0};
+  std::atomic<uint64_t> failures{0};
+  std::atomic<uint64_t> transparentBlocks{0};
+  std::atomic<uint64_t> hugetlbBlocks{0};
+  std::atomic<uint64_t> hugetlbFallbacks{0};
+  std::atomic<size_t> bytesInUse{0};
+  std::atomic<size_t> peakBytesInUse{0};
+};
+
+frameAllocatorState &state() {
+  // Never destroyed: buffers handed to JavaScript may be finalized while
+  // the process exits.
+  static frameAllocatorState *allocator = [] {
+    frameAllocatorState *created = new frameAllocatorState;
+    created->cache.reserve(kMaxCachedBlocks);
+#ifndef GRANDI_HUGE_PAGES
+    created->mode = hugePageMode::off;
+#endif
+    return created;
+  }();
+  return *allocator;
+}
+
+size_t roundUp(size_t length, size_t multiple) {
+  return (length + multiple - 1) / multiple * multiple;
+}
+
+void *alignedAllocate(size_t length, size_t alignment) {
+#ifdef _WIN32
+  return _aligned_malloc(length, alignment);
+#else
+  void *data = nullptr;
+  return posix_memalign(&data, alignment, length) == 0 ? data : nullptr;
+#endif
+}
+
+void freeBlock(void *data, uintptr_t token) {
+#ifdef GRANDI_HUGE_PAGES
+  if (token & kMappedBlock) {
+    munmap(data, frameMemoryCapacity(token));
+    return;
+  }
+#endif
+#ifdef _WIN32
+  _aligned_free(data);
+#else
+  free(data);
+#endif
+}
+
+void countInUse(frameAllocatorState &allocator, size_t capacity) {
+  size_t inUse = allocator.bytesInUse.fetch_add(capacity) + capacity;
+  size_t peak = allocator.peakBytesInUse.load();
+  while (inUse > peak &&
+         !allocator.peakBytesInUse.compare_exchange_weak(peak, inUse)) {
+  }
+}
+
+// Takes a cached block that fits capacity without wasting more than an
+// eighth of it, newest first, since its pages are the likeliest to still be
+// in the TLB and cache.
+bool takeCached(frameAllocatorState &allocator, size_t capacity, void **data,
+                uintptr_t *token) {
+  std::lock_guard<std::mutex> lock(allocator.mutex);
+  for (size_t i = allocator.cache.size(); i-- > 0;) {
+    size_t cached = frameMemoryCapacity(allocator.cache[i].token);
+    if (cached < capacity || cached - capacity > capacity / 8)
+      continue;
+    *data = allocator.cache[i].data;
+    *token = allocator.cache[i].token;
+    allocator.cache.erase(allocator.cache.begin() + i);
+    allocator.cachedBytes -= cached;
+    return true;
+  }
+  return false;
+}
+
+// Frees cached blocks, oldest first, until the cache holds at most bytes
+// bytes in at most blocks blocks. Blocks are freed outside the lock.
+void trimCache(frameAllocatorState &allocator, size_t bytes, size_t blocks) {
+  while (true) {
+    cachedBlock oldest;
+    {
+      std::lock_guard<std::mutex> lock(allocator.mutex);
+      if (allocator.cachedBytes <= bytes && allocator.cache.size() <= blocks)
+        return;
+      oldest = allocator.cache.front();
+      allocator.cache.erase(allocator.cache.begin());
+      allocator.cachedBytes -= frameMemoryCapacity(oldest.token);
+    }
+    freeBlock(oldest.data, oldest.token);
+  }
+}
+
+void *allocateLarge(frameAllocatorState &allocator, size_t length,
+                    hugePageMode mode, uintptr_t *token) {
+  size_t capacity = roundUp(length, kPageBytes);
+#ifdef GRANDI_HUGE_PAGES
+  if (mode == hugePageMode::hugetlb && capacity >= kHugePageBytes) {
+    size_t mapped = roundUp(length, kHugePageBytes);
+    void *data = mmap(nullptr, mapped, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (data != MAP_FAILED) {
+      allocator.hugetlbBlocks++;
+      *token = (uintptr_t)mapped | kMappedBlock;
+      return data;
+    }
+    allocator.hugetlbFallbacks++;
+    mode = hugePageMode::transparent;
+  }
+#endif
+  bool huge = mode != hugePageMode::off && capacity >= kHugePageBytes;
+  void *data = alignedAllocate(capacity, huge ? kHugePageBytes : kPageBytes);
+  if (data == nullptr)
+    return nullptr;
+#ifdef GRANDI_HUGE_PAGES
+  // Advisory: the kernel backs whole huge pages of the block when it can,
+  // and the tail with normal pages.
+  if (huge && madvise(data, capacity, MADV_HUGEPAGE) == 0)
+    allocator.transparentBlocks++;
+#endif
+  *token = (uintptr_t)capacity;
+  return data;
+}
+
+napi_status setNumber(napi_env env, napi_value object, const char *name,
+                      double value) {
+  napi_value param;
+  napi_status status = napi_create_double(env, value, &param);
+  PASS_STATUS;
+  return napi_set_named_property(env, object, name, param);
+}
+} // namespace
+
+void *allocateFrameMemory(size_t length, uintptr_t *token) {
+  frameAllocatorState &allocator = state();
+  void *data = nullptr;
+  if (length < kPageAlignedBytes) {
+    size_t capacity = roundUp(std::max<size_t>(length, 1), kFrameAlignment);
+    data = alignedAllocate(capacity, kFrameAlignment);
+    *token = (uintptr_t)capacity;
+  } else if (takeCached(allocator, roundUp(length, kPageBytes), &data,
+                        token)) {
+    allocator.recycled++;
+  } else {
+    hugePageMode mode;
+    {
+      std::lock_guard<std::mutex> lock(allocator.mutex);
+      mode = allocator.mode;
+    }
+    data = allocateLarge(allocator, length, mode, token);
+  }
+  if (data == nullptr) {
+    allocator.failures++;
+    return nullptr;
+  }
+  allocator.allocations++;
+  countInUse(allocator, frameMemoryCapacity(*token));
+  return data;
+}
+
+size_t frameMemoryCapacity(uintptr_t token) {
+  return (size_t)(token & ~(uintptr_t)(kFrameAlignment - 1));
+}
+
+void releaseFrameMemory(void *data, uintptr_t token) {
+  if (data == nullptr)
+    return;
+  frameAllocatorState &allocator = state();
+  size_t capacity = frameMemoryCapacity(token);
+  allocator.bytesInUse -= capacity;
+  frameMemoryReleased();
+  if (capacity >= kPageAlignedBytes) {
+    std::unique_lock<std::mutex> lock(allocator.mutex);
+    if (capacity <= allocator.cacheLimit) {
+      size_t limit = allocator.cacheLimit - capacity;
+      if (allocator.cache.size() >= kMaxCachedBlocks ||
+          allocator.cachedBytes > limit) {
+        lock.unlock();
+        trimCache(allocator, limit, kMaxCachedBlocks - 1);
+        lock.lock();
+      }
+      // Another release may have filled the cache meanwhile.
+      if (allocator.cache.size() < kMaxCachedBlocks &&
+          allocator.cachedBytes + capacity <= allocator.cacheLimit) {
+        allocator.cache.push_back({data, token});
+        allocator.cachedBytes += capacity;
+        return;
+      }
+    }
+  }
+  freeBlock(data, token);
+}
+
+size_t frameBytesInUse() { return state().bytesInUse.load(); }
+
+size_t peakFrameBytesInUse() { return state().peakBytesInUse.load(); }
+
+napi_value frameAllocator(napi_env env, napi_callback_info info) {
+  napi_status status;
+  frameAllocatorState &allocator = state();
+  hugePageMode mode;
+  size_t cacheBytes;
+  {
+    std::lock_guard<std::mutex> lock(allocator.mutex);
+    mode = allocator.mode;
+    cacheBytes = allocator.cacheLimit;
+  }
+
+  napi_value result, param;
+  status = napi_create_object(env, &result);
+  CHECK_STATUS;
+  status = napi_create_string_utf8(env, modeNames[(int)mode],
+                                   NAPI_AUTO_LENGTH, &param);
+  CHECK_STATUS;
+  status = napi_set_named_property(env, result, "hugePages", param);
+  CHECK_STATUS;
+  status = setNumber(env, result, "cacheBytes", (double)cacheBytes);
+  CHECK_STATUS;
+#ifdef GRANDI_HUGE_PAGES
+  status = napi_get_boolean(env, true, &param);
+#else
+  status = napi_get_boolean(env, false, &param);
+#endif
+  CHECK_STATUS;
+  status = napi_set_named_property(env, result, "hugePagesAvailable", param);
+  CHECK_STATUS;
+  return result;
+}
+
+napi_value setFrameAllocator(napi_env env, napi_callback_info info) {
+  napi_status status;
+  size_t argc = 1;
+  napi_value args[1];
+  status = napi_get_cb_info(env, info, &argc, args, nullptr, nullptr);
+  CHECK_STATUS;
+
+  napi_valuetype type = napi_undefined;
+  bool isArray = false;
+  if (argc >= 1) {
+    status = napi_typeof(env, args[0], &type);
+    CHECK_STATUS;
+    status = napi_is_array(env, args[0], &isArray);
+    CHECK_STATUS;
+  }
+  if (type != napi_object || isArray)
+    NAPI_THROW_ERROR("Frame allocator options must be an object.");
+
+  frameAllocatorState &allocator = state();
+  hugePageMode mode;
+  size_t cacheBytes;
+  {
+    std::lock_guard<std::mutex> lock(allocator.mutex);
+    mode = allocator.mode;
+    cacheBytes = allocator.cacheLimit;
+  }
+  hugePageMode previousMode = mode;
+
+  napi_value value;
+  status = napi_get_named_property(env, args[0], "hugePages", &value);
+  CHECK_STATUS;
+  status = napi_typeof(env, value, &type);
+  CHECK_STATUS;
+  if (type != napi_undefined) {
+    char name[16];
+    size_t length = 0;
+    if (type == napi_string) {
+      status = napi_get_value_string_utf8(env, value, name, sizeof(name),
+                                          &length);
+      CHECK_STATUS;
+    }
+    int parsed = -1;
+    for (int i = 0; i < 3 && type == napi_string; i++) {
+      if (std::string(name, length) == modeNames[i])
+        parsed = i;
+    }
+    if (parsed < 0)
+      NAPI_THROW_ERROR(
+          "hugePages must be \"off\", \"transparent\", or \"hugetlb\".");
+#ifndef GRANDI_HUGE_PAGES
+    if (parsed != (int)hugePageMode::off)
+      NAPI_THROW_ERROR("Huge pages are only supported on Linux.");
+#endif
+    mode = (hugePageMode)parsed;
+  }
+
+  status = napi_get_named_property(env, args[0], "cacheBytes", &value);
+  CHECK_STATUS;
+  status = napi_typeof(env, value, &type);
+  CHECK_STATUS;
+  if (type != napi_undefined) {
+    double parsed = -1.0;
+    if (type == napi_number) {
+      status = napi_get_value_double(env, value, &parsed);
+      CHECK_STATUS;
+    }
+    if (!(parsed >= 0.0 && parsed <= kMaxCacheBytes) ||
+        std::floor(parsed) != parsed)
+      NAPI_THROW_ERROR("cacheBytes must be a byte count of 0 or more.");
+    cacheBytes = (size_t)parsed;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(allocator.mutex);
+    allocator.mode = mode;
+    allocator.cacheLimit = cacheBytes;
+  }
+  // Cached blocks keep the backing they were allocated with, so a new mode
+  // starts from an empty cache.
+  trimCache(allocator, mode != previousMode ? 0 : cacheBytes,
+            kMaxCachedBlocks);
+
+  napi_value result;
+  status = napi_get_undefined(env, &result);
+  CHECK_STATUS;
+  return result;
+}
+
+napi_value frameAllocatorStats(napi_env env, napi_callback_info info) {
+  napi_status status;
+  frameAllocatorState &allocator = state();
+  size_t cachedBytes, cachedBlocks;
+  {
+    std::lock_guard<std::mutex> lock(allocator.mutex);
+    cachedBytes = allocator.cachedBytes;
+    cachedBlocks = allocator.cache.size();
+  }
+
+  napi_value result;
+  status = napi_create_object(env, &result);
+  CHECK_STATUS;
+  const char *names[10] = {"allocations",       "recycled",
+                           "failures",          "transparentBlocks",
+                           "hugetlbBlocks",     "hugetlbFallbacks",
+                           "bytesInUse",        "peakBytesInUse",
+                           "cachedBytes",       "cachedBlocks"};
+  double values[10] = {(double)allocator.allocations.load(),
+                       (double)allocator.recycled.load(),
+                       (double)allocator.failures.load(),
+                       (double)allocator.transparentBlocks.load(),
+                       (double)allocator.hugetlbBlocks.load(),
+                       (double)allocator.hugetlbFallbacks.load(),
+                       (double)allocator.bytesInUse.load(),
+                       (double)allocator.peakBytesInUse.load(),
+                       (double)cachedBytes,
+                       (double)cachedBlocks};
+  for (int i = 0; i < 10; i++) {
+    status = setNumber(env, result, names[i], values[i]);
+    CHECK_STATUS;
+  }
+  return result;
+}
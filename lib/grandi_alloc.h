@@ -0,0 +1,54 @@
+/* Copyright 2025 Sarhan Aissi <github@tux.tn>.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+*/
+
+#ifndef GRANDI_ALLOC_H
+#define GRANDI_ALLOC_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "node_api.h"
+
+// Memory for frame buffers. Blocks below kPageAlignedBytes are aligned to
+// cache lines; larger ones start on a page and span whole pages, and go
+// back to a bounded cache when released so the next frame of the same size
+// reuses memory that is already faulted in. On Linux, blocks of at least
+// one huge page can also be backed by transparent huge pages
+// (MADV_HUGEPAGE) or by the preallocated hugetlbfs pool (MAP_HUGETLB),
+// which falls back to transparent huge pages once the pool runs out.
+enum class hugePageMode { off, transparent, hugetlb };
+
+const size_t kFrameAlignment = 64;
+const size_t kPageAlignedBytes = 64 << 10;
+const size_t kHugePageBytes = 2 << 20;
+const size_t kDefaultFrameCacheBytes = 64 << 20;
+
+// Returns a block of at least length bytes, or null. token records how to
+// release it and must be passed back unchanged.
+void *allocateFrameMemory(size_t length, uintptr_t *token);
+// Capacity of the block a token describes.
+size_t frameMemoryCapacity(uintptr_t token);
+void releaseFrameMemory(void *data, uintptr_t token);
+// Capacity of the blocks handed out and not yet released, and its peak.
+size_t frameBytesInUse();
+size_t peakFrameBytesInUse();
+
+// Exposed as frameAllocator(), setFrameAllocator(options), and
+// frameAllocatorStats().
+napi_value frameAllocator(napi_env env, napi_callback_info info);
+napi_value setFrameAllocator(napi_env env, napi_callback_info info);
+napi_value frameAllocatorStats(napi_env env, napi_callback_info info);
+
+#endif /* GRANDI_ALLOC_H */
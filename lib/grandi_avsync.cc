@@ -0,0 +1,302 @@
+/* Copyright 2025 Sarhan Aissi <github@tux.tn>.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdlib>
+
+#include "grandi_avsync.h"
+#include "grandi_util.h"
+
+namespace {
+// NDI timestamps and the local clock are both expressed in 100ns ticks.
+const int64_t kTicksPerMs = 10000;
+const int64_t kTicksPerSecond = 10000000;
+// Flashes and beeps further apart than this are not treated as a pair.
+const int64_t kMaxPatternGap = kTicksPerSecond;
+// Mean picture luma hysteresis for the flash detector, on a 0-255 scale.
+const double kFlashOnLuma = 160.0;
+const double kFlashOffLuma = 96.0;
+// Beep detector hysteresis on the first audio channel, in full scale units.
+const float kBeepOnLevel = 0.1f;
+const float kBeepOffLevel = 0.02f;
+// Luma is estimated from a sparse grid rather than every pixel.
+const int kLumaGrid = 16;
+
+int64_t ticksSince(std::chrono::steady_clock::time_point time) {
+  return std::chrono::duration_cast<
+             std::chrono::duration<int64_t, std::ratio<1, kTicksPerSecond>>>(
+             time.time_since_epoch())
+      .count();
+}
+
+double lumaAt(const NDIlib_video_frame_v2_t &frame, int x, int y) {
+  const uint8_t *line =
+      frame.p_data + (size_t)y * (size_t)frame.line_stride_in_bytes;
+  switch (frame.FourCC) {
+  case NDIlib_FourCC_type_UYVY:
+  case NDIlib_FourCC_type_UYVA:
+    return line[(size_t)x * 2 + 1];
+  case NDIlib_FourCC_type_P216:
+  case NDIlib_FourCC_type_PA16:
+    return ((const uint16_t *)line)[x] >> 8;
+  case NDIlib_FourCC_type_NV12:
+  case NDIlib_FourCC_type_I420:
+  case NDIlib_FourCC_type_YV12:
+    return line[x];
+  case NDIlib_FourCC_type_BGRA:
+  case NDIlib_FourCC_type_BGRX: {
+    const uint8_t *pixel = line + (size_t)x * 4;
+    return (pixel[0] + 5.0 * pixel[1] + 2.0 * pixel[2]) / 8.0;
+  }
+  case NDIlib_FourCC_type_RGBA:
+  case NDIlib_FourCC_type_RGBX: {
+    const uint8_t *pixel = line + (size_t)x * 4;
+    return (2.0 * pixel[0] + 5.0 * pixel[1] + pixel[2]) / 8.0;
+  }
+  default:
+    return -1.0;
+  }
+}
+
+// Returns the mean luma of a grid of samples, or a negative value when the
+// frame layout is not understood.
+double sampleLuma(const NDIlib_video_frame_v2_t &frame) {
+  if (frame.p_data == nullptr || frame.xres <= 0 || frame.yres <= 0 ||
+      frame.line_stride_in_bytes <= 0)
+    return -1.0;
+  double sum = 0.0;
+  for (int row = 0; row < kLumaGrid; row++) {
+    int y = (int)(((int64_t)row * 2 + 1) * frame.yres / (kLumaGrid * 2));
+    for (int column = 0; column < kLumaGrid; column++) {
+      int x = (int)(((int64_t)column * 2 + 1) * frame.xres / (kLumaGrid * 2));
+      double luma = lumaAt(frame, x, y);
+      if (luma < 0.0)
+        return -1.0;
+      sum += luma;
+    }
+  }
+  return sum / (kLumaGrid * kLumaGrid);
+}
+
+napi_status setDouble(napi_env env, napi_value object, const char *name,
+                      double value) {
+  napi_status status;
+  napi_value param;
+  status = napi_create_double(env, value, &param);
+  PASS_STATUS;
+  return napi_set_named_property(env, object, name, param);
+}
+} // namespace
+
+avSyncTracker::avSyncTracker(const avSyncOptions &options)
+    : testPattern(options.testPattern), offsets(options.window, 0.0) {}
+
+void avSyncTracker::addOffset(double offsetMs) {
+  offsets[nextOffset] = offsetMs;
+  nextOffset = (nextOffset + 1) % offsets.size();
+  if (offsetCount < offsets.size())
+    offsetCount++;
+  lastOffset = offsetMs;
+}
+
+void avSyncTracker::matchPattern() {
+  if (!flashPending || !beepPending)
+    return;
+  int64_t gap = flashTime - beepTime;
+  if (std::llabs(gap) > kMaxPatternGap) {
+    // Keep whichever event is newer; it may still find its partner.
+    if (gap > 0)
+      beepPending = false;
+    else
+      flashPending = false;
+    return;
+  }
+  double offsetMs = (double)gap / kTicksPerMs;
+  if (pattern.count == 0 || offsetMs < pattern.min)
+    pattern.min = offsetMs;
+  if (pattern.count == 0 || offsetMs > pattern.max)
+    pattern.max = offsetMs;
+  pattern.count++;
+  pattern.sum += offsetMs;
+  pattern.last = offsetMs;
+  flashPending = false;
+  beepPending = false;
+}
+
+void avSyncTracker::trackVideo(const NDIlib_video_frame_v2_t &frame,
+                               std::chrono::steady_clock::time_point arrival) {
+  int64_t arrivalTicks = ticksSince(arrival);
+  // The detector reads pixels, so keep it outside the lock.
+  double luma = testPattern ? sampleLuma(frame) : -1.0;
+
+  std::lock_guard<std::mutex> lock(mutex);
+  videoFrames++;
+  if (frame.timestamp == NDIlib_recv_timestamp_undefined) {
+    untimedFrames++;
+  } else {
+    videoTransit = arrivalTicks - frame.timestamp;
+    haveVideoTransit = true;
+    if (haveAudioTransit)
+      addOffset((double)(videoTransit - audioTransit) / kTicksPerMs);
+  }
+
+  if (luma < 0.0)
+    return;
+  if (!flashLit && luma >= kFlashOnLuma) {
+    flashLit = true;
+    flashes++;
+    flashPending = true;
+    flashTime = arrivalTicks;
+    matchPattern();
+  } else if (flashLit && luma <= kFlashOffLuma) {
+    flashLit = false;
+  }
+}
+
+void avSyncTracker::trackAudio(const NDIlib_audio_frame_v3_t &frame,
+                               std::chrono::steady_clock::time_point arrival) {
+  int64_t arrivalTicks = ticksSince(arrival);
+  int onset = -1;
+  float peak = 0.0f;
+  bool scan = testPattern && frame.FourCC == NDIlib_FourCC_audio_type_FLTP &&
+              frame.p_data != nullptr && frame.no_channels > 0 &&
+              frame.no_samples > 0 && frame.sample_rate > 0;
+  if (scan) {
+    const float *samples = (const float *)frame.p_data;
+    for (int i = 0; i < frame.no_samples; i++) {
+      float level = std::fabs(samples[i]);
+      if (onset < 0 && level >= kBeepOnLevel)
+        onset = i;
+      peak = std::max(peak, level);
+    }
+  }
+
+  std::lock_guard<std::mutex> lock(mutex);
+  audioFrames++;
+  if (frame.timestamp == NDIlib_recv_timestamp_undefined) {
+    untimedFrames++;
+  } else {
+    audioTransit = arrivalTicks - frame.timestamp;
+    haveAudioTransit = true;
+  }
+
+  if (!scan)
+    return;
+  if (!beepActive && onset >= 0) {
+    beepActive = true;
+    beeps++;
+    beepPending = true;
+    beepTime = arrivalTicks + (int64_t)onset * kTicksPerSecond /
+                                  (int64_t)frame.sample_rate;
+    matchPattern();
+  } else if (beepActive && peak < kBeepOffLevel) {
+    beepActive = false;
+  }
+}
+
+napi_status avSyncTracker::report(napi_env env, napi_value *result) {
+  std::vector<double> window;
+  double last;
+  uint64_t video, audio, untimed, flashCount, beepCount;
+  avSyncStats patternStats;
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    window.assign(offsets.begin(), offsets.begin() + offsetCount);
+    last = lastOffset;
+    video = videoFrames;
+    audio = audioFrames;
+    untimed = untimedFrames;
+    flashCount = flashes;
+    beepCount = beeps;
+    patternStats = pattern;
+  }
+
+  napi_status status;
+  status = napi_create_object(env, result);
+  PASS_STATUS;
+  status = setDouble(env, *result, "videoFrames", (double)video);
+  PASS_STATUS;
+  status = setDouble(env, *result, "audioFrames", (double)audio);
+  PASS_STATUS;
+  status = setDouble(env, *result, "untimedFrames", (double)untimed);
+  PASS_STATUS;
+  status = setDouble(env, *result, "samples", (double)window.size());
+  PASS_STATUS;
+
+  if (!window.empty()) {
+    double sum = 0.0;
+    double min = window[0];
+    double max = window[0];
+    for (double value : window) {
+      sum += value;
+      min = std::min(min, value);
+      max = std::max(max, value);
+    }
+    double mean = sum / (double)window.size();
+    double variance = 0.0;
+    for (double value : window)
+      variance += (value - mean) * (value - mean);
+    variance /= (double)window.size();
+
+    napi_value offset;
+    status = napi_create_object(env, &offset);
+    PASS_STATUS;
+    status = setDouble(env, offset, "mean", mean);
+    PASS_STATUS;
+    status = setDouble(env, offset, "stddev", std::sqrt(variance));
+    PASS_STATUS;
+    status = setDouble(env, offset, "min", min);
+    PASS_STATUS;
+    status = setDouble(env, offset, "max", max);
+    PASS_STATUS;
+    status = setDouble(env, offset, "last", last);
+    PASS_STATUS;
+    status = napi_set_named_property(env, *result, "offsetMs", offset);
+    PASS_STATUS;
+  }
+
+  if (!testPattern)
+    return napi_ok;
+
+  napi_value patternValue;
+  status = napi_create_object(env, &patternValue);
+  PASS_STATUS;
+  status = setDouble(env, patternValue, "flashes", (double)flashCount);
+  PASS_STATUS;
+  status = setDouble(env, patternValue, "beeps", (double)beepCount);
+  PASS_STATUS;
+  status =
+      setDouble(env, patternValue, "matches", (double)patternStats.count);
+  PASS_STATUS;
+  if (patternStats.count > 0) {
+    napi_value offset;
+    status = napi_create_object(env, &offset);
+    PASS_STATUS;
+    status = setDouble(env, offset, "mean",
+                       patternStats.sum / (double)patternStats.count);
+    PASS_STATUS;
+    status = setDouble(env, offset, "min", patternStats.min);
+    PASS_STATUS;
+    status = setDouble(env, offset, "max", patternStats.max);
+    PASS_STATUS;
+    status = setDouble(env, offset, "last", patternStats.last);
+    PASS_STATUS;
+    status = napi_set_named_property(env, patternValue, "offsetMs", offset);
+    PASS_STATUS;
+  }
+  return napi_set_named_property(env, *result, "testPattern", patternValue);
+}
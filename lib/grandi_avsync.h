@@ -0,0 +1,85 @@
+/* Copyright 2025 Sarhan Aissi <github@tux.tn>.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+*/
+
+#ifndef GRANDI_AVSYNC_H
+#define GRANDI_AVSYNC_H
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#include <Processing.NDI.Lib.h>
+
+#include "node_api.h"
+
+struct avSyncOptions {
+  uint32_t window = 100;
+  bool testPattern = false;
+};
+
+struct avSyncStats {
+  uint64_t count = 0;
+  double sum = 0.0;
+  double min = 0.0;
+  double max = 0.0;
+  double last = 0.0;
+};
+
+// Tracks the offset between video and audio as they leave a receiver. Each
+// captured frame contributes its transit time (local arrival minus sender
+// timestamp); the offset is the video transit time minus the audio transit
+// time, so positive values mean picture is late relative to sound. Capture
+// threads call trackVideo/trackAudio concurrently; report runs on the JS
+// thread.
+struct avSyncTracker {
+  explicit avSyncTracker(const avSyncOptions &options);
+  void trackVideo(const NDIlib_video_frame_v2_t &frame,
+                  std::chrono::steady_clock::time_point arrival);
+  void trackAudio(const NDIlib_audio_frame_v3_t &frame,
+                  std::chrono::steady_clock::time_point arrival);
+  napi_status report(napi_env env, napi_value *result);
+
+private:
+  void addOffset(double offsetMs);
+  void matchPattern();
+
+  std::mutex mutex;
+  bool testPattern;
+  std::vector<double> offsets;
+  size_t nextOffset = 0;
+  size_t offsetCount = 0;
+  double lastOffset = 0.0;
+  uint64_t videoFrames = 0;
+  uint64_t audioFrames = 0;
+  uint64_t untimedFrames = 0;
+  bool haveVideoTransit = false;
+  bool haveAudioTransit = false;
+  int64_t videoTransit = 0;
+  int64_t audioTransit = 0;
+
+  // Test pattern state. Times are local arrival times in 100ns units.
+  bool flashLit = false;
+  bool beepActive = false;
+  bool flashPending = false;
+  bool beepPending = false;
+  int64_t flashTime = 0;
+  int64_t beepTime = 0;
+  uint64_t flashes = 0;
+  uint64_t beeps = 0;
+  avSyncStats pattern;
+};
+
+#endif /* GRANDI_AVSYNC_H */
@@ -0,0 +1,275 @@
+/* Copyright 2025 Sarhan Aissi <github@tux.tn>.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+*/
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+#include "grandi_budget.h"
+#include "grandi_alloc.h"
+#include "grandi_util.h"
+
+namespace {
+const uint32_t kDefaultBudgetWaitMs = 100;
+const uint32_t kMaxBudgetWaitMs = 10000;
+// Largest integer a JavaScript number holds exactly.
+const double kMaxBudgetBytes = 9007199254740991.0;
+
+const char *policyNames[3] = {"drop", "wait", "reduce"};
+
+struct frameBudgetState {
+  // Zero for no budget.
+  std::atomic<size_t> limit{0};
+  // Held by budgetReservation objects.
+  std::atomic<size_t> reserved{0};
+  std::atomic<int> policy{(int)budgetPolicy::drop};
+  std::atomic<uint32_t> waitMs{kDefaultBudgetWaitMs};
+  // Captures blocked in admitFrameBytes(), so releases only take the mutex
+  // when someone waits.
+  std::atomic<uint32_t> waiting{0};
+  std::mutex mutex;
+  std::condition_variable released;
+
+  std::atomic<uint64_t> overBudget{0};
+  std::atomic<uint64_t> dropped{0};
+  std::atomic<uint64_t> waited{0};
+  std::atomic<uint64_t> reduced{0};
+};
+
+frameBudgetState &state() {
+  // Never destroyed, like the frame allocator whose releases it hears of.
+  static frameBudgetState *budget = new frameBudgetState;
+  return *budget;
+}
+
+// Adds bytes to the reservations if they fit next to the memory in use and
+// the other reservations. A reservation is only given back after its copy
+// is allocated, so the sum never undercounts.
+bool reserve(frameBudgetState &budget, size_t bytes, size_t limit) {
+  size_t reserved = budget.reserved.load();
+  do {
+    size_t inUse = frameBytesInUse() + reserved;
+    if (limit != 0 && (inUse > limit || bytes > limit - inUse))
+      return false;
+  } while (!budget.reserved.compare_exchange_weak(reserved, reserved + bytes));
+  return true;
+}
+
+napi_status setNumber(napi_env env, napi_value object, const char *name,
+                      double value) {
+  napi_value param;
+  napi_status status = napi_create_double(env, value, &param);
+  PASS_STATUS;
+  return napi_set_named_property(env, object, name, param);
+}
+} // namespace
+
+void budgetReservation::release() {
+  if (bytes == 0)
+    return;
+  state().reserved -= bytes;
+  bytes = 0;
+  frameMemoryReleased();
+}
+
+budgetDecision admitFrameBytes(size_t bytes, bool reducible,
+                               budgetReservation *reservation) {
+  frameBudgetState &budget = state();
+  reservation->release();
+  size_t limit = budget.limit.load();
+  if (limit == 0)
+    return budgetDecision::admit;
+  if (reserve(budget, bytes, limit)) {
+    reservation->bytes = bytes;
+    return budgetDecision::admit;
+  }
+
+  budget.overBudget++;
+  switch ((budgetPolicy)budget.policy.load()) {
+  case budgetPolicy::reduce:
+    if (reducible && reserve(budget, bytes / 4, limit)) {
+      reservation->bytes = bytes / 4;
+      budget.reduced++;
+      return budgetDecision::reduce;
+    }
+    break;
+  case budgetPolicy::wait: {
+    budget.waited++;
+    budget.waiting++;
+    bool admitted;
+    {
+      std::unique_lock<std::mutex> lock(budget.mutex);
+      admitted = budget.released.wait_for(
+          lock, std::chrono::milliseconds(budget.waitMs.load()),
+          [&] { return reserve(budget, bytes, budget.limit.load()); });
+    }
+    budget.waiting--;
+    if (admitted) {
+      reservation->bytes = bytes;
+      return budgetDecision::admit;
+    }
+    break;
+  }
+  case budgetPolicy::drop:
+    break;
+  }
+  budget.dropped++;
+  return budgetDecision::drop;
+}
+
+void frameMemoryReleased() {
+  frameBudgetState &budget = state();
+  if (budget.waiting.load() == 0)
+    return;
+  // Taking the mutex orders this wakeup after a waiter's last check.
+  std::lock_guard<std::mutex> lock(budget.mutex);
+  budget.released.notify_all();
+}
+
+napi_value frameBudget(napi_env env, napi_callback_info info) {
+  napi_status status;
+  frameBudgetState &budget = state();
+
+  napi_value result, param;
+  status = napi_create_object(env, &result);
+  CHECK_STATUS;
+  status = setNumber(env, result, "bytes", (double)budget.limit.load());
+  CHECK_STATUS;
+  status = napi_create_string_utf8(env, policyNames[budget.policy.load()],
+                                   NAPI_AUTO_LENGTH, &param);
+  CHECK_STATUS;
+  status = napi_set_named_property(env, result, "policy", param);
+  CHECK_STATUS;
+  status = setNumber(env, result, "waitMs", (double)budget.waitMs.load());
+  CHECK_STATUS;
+  return result;
+}
+
+napi_value setFrameBudget(napi_env env, napi_callback_info info) {
+  napi_status status;
+  size_t argc = 1;
+  napi_value args[1];
+  status = napi_get_cb_info(env, info, &argc, args, nullptr, nullptr);
+  CHECK_STATUS;
+
+  napi_valuetype type = napi_undefined;
+  bool isArray = false;
+  if (argc >= 1) {
+    status = napi_typeof(env, args[0], &type);
+    CHECK_STATUS;
+    status = napi_is_array(env, args[0], &isArray);
+    CHECK_STATUS;
+  }
+  if (type != napi_object || isArray)
+    NAPI_THROW_ERROR("Frame budget options must be an object.");
+
+  frameBudgetState &budget = state();
+  size_t limit = budget.limit.load();
+  int policy = budget.policy.load();
+  uint32_t waitMs = budget.waitMs.load();
+
+  napi_value value;
+  status = napi_get_named_property(env, args[0], "bytes", &value);
+  CHECK_STATUS;
+  status = napi_typeof(env, value, &type);
+  CHECK_STATUS;
+  if (type != napi_undefined) {
+    double parsed = -1.0;
+    if (type == napi_number) {
+      status = napi_get_value_double(env, value, &parsed);
+      CHECK_STATUS;
+    }
+    if (!(parsed >= 0.0 && parsed <= kMaxBudgetBytes) ||
+        std::floor(parsed) != parsed)
+      NAPI_THROW_ERROR("bytes must be a byte count of 0 or more.");
+    limit = (size_t)parsed;
+  }
+
+  status = napi_get_named_property(env, args[0], "policy", &value);
+  CHECK_STATUS;
+  status = napi_typeof(env, value, &type);
+  CHECK_STATUS;
+  if (type != napi_undefined) {
+    char name[16];
+    size_t length = 0;
+    if (type == napi_string) {
+      status = napi_get_value_string_utf8(env, value, name, sizeof(name),
+                                          &length);
+      CHECK_STATUS;
+    }
+    int parsed = -1;
+    for (int i = 0; i < 3 && type == napi_string; i++) {
+      if (std::string(name, length) == policyNames[i])
+        parsed = i;
+    }
+    if (parsed < 0)
+      NAPI_THROW_ERROR("policy must be \"drop\", \"wait\", or \"reduce\".");
+    policy = parsed;
+  }
+
+  status = napi_get_named_property(env, args[0], "waitMs", &value);
+  CHECK_STATUS;
+  status = napi_typeof(env, value, &type);
+  CHECK_STATUS;
+  if (type != napi_undefined) {
+    std::string error;
+    status = parseUint32Value(env, value, "waitMs", &waitMs, &error);
+    CHECK_STATUS;
+    if (!error.empty() || waitMs > kMaxBudgetWaitMs)
+      NAPI_THROW_ERROR("waitMs must be an integer between 0 and 10000.");
+  }
+
+  budget.limit = limit;
+  budget.policy = policy;
+  budget.waitMs = waitMs;
+  // A larger budget or a new policy may release waiting captures.
+  {
+    std::lock_guard<std::mutex> lock(budget.mutex);
+    budget.released.notify_all();
+  }
+
+  napi_value result;
+  status = napi_get_undefined(env, &result);
+  CHECK_STATUS;
+  return result;
+}
+
+napi_value frameBudgetStats(napi_env env, napi_callback_info info) {
+  napi_status status;
+  frameBudgetState &budget = state();
+
+  napi_value result;
+  status = napi_create_object(env, &result);
+  CHECK_STATUS;
+  const char *names[7] = {"bytes",      "bytesInUse", "peakBytesInUse",
+                          "overBudget", "dropped",    "waited",
+                          "reduced"};
+  double values[7] = {(double)budget.limit.load(),
+                      (double)frameBytesInUse(),
+                      (double)peakFrameBytesInUse(),
+                      (double)budget.overBudget.load(),
+                      (double)budget.dropped.load(),
+                      (double)budget.waited.load(),
+                      (double)budget.reduced.load()};
+  for (int i = 0; i < 7; i++) {
+    status = setNumber(env, result, names[i], values[i]);
+    CHECK_STATUS;
+  }
+  return result;
+}
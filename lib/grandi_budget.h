@@ -0,0 +1,59 @@
+/* Copyright 2025 Sarhan Aissi <github@tux.tn>.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+*/
+
+#ifndef GRANDI_BUDGET_H
+#define GRANDI_BUDGET_H
+
+#include <cstddef>
+
+#include "node_api.h"
+
+// Process-wide cap on frame memory in use: every live allocateFrameMemory()
+// block, whether queued natively or held by a Buffer JavaScript has not yet
+// collected, plus the bytes admitted captures have reserved but not yet
+// allocated. Capture paths ask before copying a frame; with no budget, the
+// default, every frame is admitted.
+enum class budgetPolicy { drop, wait, reduce };
+enum class budgetDecision { admit, reduce, drop };
+
+// Bytes admitted against the budget ahead of the frame copy. Release it once
+// the copy is allocated, from then on counted by the allocator; it is also
+// released when it goes out of scope, as when a capture gives a frame up.
+struct budgetReservation {
+  size_t bytes = 0;
+  budgetReservation() = default;
+  ~budgetReservation() { release(); }
+  void release();
+  budgetReservation(const budgetReservation &) = delete;
+  budgetReservation &operator=(const budgetReservation &) = delete;
+};
+
+// Decides whether a capture may copy a frame of bytes, and reserves what it
+// admits in reservation, replacing what that held before. Over budget, drop
+// refuses it, wait blocks for up to waitMs for buffers to be released, and
+// reduce admits a half-size copy when reducible and a quarter of bytes
+// fits. Reservations are taken with a compare-and-swap, so concurrent
+// captures cannot pass the same headroom together.
+budgetDecision admitFrameBytes(size_t bytes, bool reducible,
+                               budgetReservation *reservation);
+// Wakes captures waiting for memory; called when a block is released.
+void frameMemoryReleased();
+
+// Exposed as frameBudget(), setFrameBudget(options), and frameBudgetStats().
+napi_value frameBudget(napi_env env, napi_callback_info info);
+napi_value setFrameBudget(napi_env env, napi_callback_info info);
+napi_value frameBudgetStats(napi_env env, napi_callback_info info);
+
+#endif /* GRANDI_BUDGET_H */
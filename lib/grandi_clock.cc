@@ -0,0 +1,321 @@
+/* Copyright 2025 Sarhan Aissi <github@tux.tn>.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+*/
+
+#include <chrono>
+#include <cmath>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <uv.h>
+
+#include "grandi_clock.h"
+#include "grandi_util.h"
+
+namespace {
+// Points kept for each regression.
+const size_t kClockWindow = 256;
+// A source contributes the fastest frame seen in each bucket, which filters
+// out most queueing delay before the fit.
+const uint64_t kSourceBucketNs = 100000000;
+// The local wall clock is sampled against the monotonic clock this often.
+const uint64_t kLocalBucketNs = 250000000;
+const int64_t kTickNs = 100;
+
+struct clockPoint {
+  int64_t x;
+  int64_t y;
+};
+
+// Arrival time minus the sender timestamp, both in nanoseconds.
+int64_t transitNs(const clockPoint &point) {
+  return point.y - point.x * kTickNs;
+}
+
+// y = y0 + intercept + slope * (x - x0). Offsets are kept relative to the
+// newest point so the doubles keep nanosecond precision.
+struct clockLine {
+  int64_t x0 = 0;
+  int64_t y0 = 0;
+  double slope;
+  double intercept = 0.0;
+  explicit clockLine(double nominal) : slope(nominal) {}
+  int64_t map(int64_t x) const {
+    return y0 + std::llround(intercept + slope * (double)(x - x0));
+  }
+  int64_t unmap(int64_t y) const {
+    return x0 + std::llround(((double)(y - y0) - intercept) / slope);
+  }
+};
+
+struct clockFit {
+  std::deque<clockPoint> points;
+  double nominal;
+  clockLine line;
+  double residual = 0.0;
+  explicit clockFit(double nominal) : nominal(nominal), line(nominal) {}
+
+  void add(clockPoint point) {
+    points.push_back(point);
+    if (points.size() > kClockWindow)
+      points.pop_front();
+
+    line.x0 = point.x;
+    line.y0 = point.y;
+    double n = (double)points.size();
+    double meanX = 0.0, meanY = 0.0;
+    for (const clockPoint &p : points) {
+      meanX += (double)(p.x - line.x0);
+      meanY += (double)(p.y - line.y0);
+    }
+    meanX /= n;
+    meanY /= n;
+    double sxx = 0.0, sxy = 0.0;
+    for (const clockPoint &p : points) {
+      double dx = (double)(p.x - line.x0) - meanX;
+      sxx += dx * dx;
+      sxy += dx * ((double)(p.y - line.y0) - meanY);
+    }
+    line.slope = sxx > 0.0 ? sxy / sxx : nominal;
+    line.intercept = meanY - line.slope * meanX;
+
+    double squares = 0.0;
+    for (const clockPoint &p : points) {
+      double error = (double)(p.y - line.y0) -
+                     (line.intercept + line.slope * (double)(p.x - line.x0));
+      squares += error * error;
+    }
+    residual = std::sqrt(squares / n);
+  }
+};
+
+// Maps monotonic nanoseconds to wall clock time in NDI timestamp units.
+struct localClock {
+  std::mutex mutex;
+  clockFit fit{1.0 / (double)kTickNs};
+  uint64_t lastSample = 0;
+};
+
+struct sourceClock {
+  clockFit fit{(double)kTickNs};
+  bool bucketOpen = false;
+  uint64_t bucketStart = 0;
+  clockPoint fastest{};
+  int64_t lastTimestamp = 0;
+  uint64_t observations = 0;
+};
+
+struct sourceClocks {
+  std::mutex mutex;
+  std::map<std::string, sourceClock> sources;
+};
+
+localClock local;
+sourceClocks remote;
+
+int64_t wallClockTicks() {
+  return std::chrono::duration_cast<
+             std::chrono::duration<int64_t, std::ratio<1, 10000000>>>(
+             std::chrono::system_clock::now().time_since_epoch())
+      .count();
+}
+
+// Returns the current local mapping, refreshing it when it is stale. The
+// wall clock read is bracketed by two monotonic reads to halve its error.
+clockLine localLine(uint64_t now) {
+  std::lock_guard<std::mutex> lock(local.mutex);
+  if (local.fit.points.empty() || now - local.lastSample >= kLocalBucketNs) {
+    uint64_t before = clockMonotonicNs();
+    int64_t wall = wallClockTicks();
+    uint64_t after = clockMonotonicNs();
+    local.fit.add({(int64_t)(before + (after - before) / 2), wall});
+    local.lastSample = after;
+  }
+  return local.fit.line;
+}
+
+napi_value createBigint(napi_env env, int64_t value) {
+  napi_status status;
+  napi_value result;
+  status = napi_create_bigint_int64(env, value, &result);
+  CHECK_STATUS;
+  return result;
+}
+
+napi_status setDouble(napi_env env, napi_value object, const char *name,
+                      double value) {
+  napi_status status;
+  napi_value param;
+  status = napi_create_double(env, value, &param);
+  PASS_STATUS;
+  return napi_set_named_property(env, object, name, param);
+}
+
+struct sourceEstimate {
+  std::string name;
+  size_t samples;
+  uint64_t observations;
+  double offsetMs;
+  double skewPpm;
+  double jitterMs;
+};
+} // namespace
+
+uint64_t clockMonotonicNs() { return uv_hrtime(); }
+
+void observeClockSample(const std::string &source, int64_t timestamp,
+                        uint64_t arrivalNs) {
+  bool refreshLocal = false;
+  {
+    std::lock_guard<std::mutex> lock(remote.mutex);
+    sourceClock &clock = remote.sources[source];
+    clock.observations++;
+    clock.lastTimestamp = timestamp;
+    clockPoint point = {timestamp, (int64_t)arrivalNs};
+    if (!clock.bucketOpen) {
+      clock.bucketOpen = true;
+      clock.bucketStart = arrivalNs;
+      clock.fastest = point;
+    } else if (arrivalNs - clock.bucketStart >= kSourceBucketNs) {
+      clock.fit.add(clock.fastest);
+      clock.bucketStart = arrivalNs;
+      clock.fastest = point;
+      refreshLocal = true;
+    } else if (transitNs(point) < transitNs(clock.fastest)) {
+      clock.fastest = point;
+    }
+  }
+  // Keep the local mapping fresh while frames flow so queries stay cheap.
+  if (refreshLocal)
+    localLine(arrivalNs);
+}
+
+napi_value clockNow(napi_env env, napi_callback_info info) {
+  uint64_t now = clockMonotonicNs();
+  return createBigint(env, localLine(now).map((int64_t)now));
+}
+
+napi_value clockToMonotonic(napi_env env, napi_callback_info info) {
+  napi_status status;
+
+  size_t argc = 2;
+  napi_value args[2];
+  status = napi_get_cb_info(env, info, &argc, args, nullptr, nullptr);
+  CHECK_STATUS;
+
+  if (argc < 1)
+    NAPI_THROW_ERROR("timestamp must be a bigint.");
+  napi_valuetype type;
+  status = napi_typeof(env, args[0], &type);
+  CHECK_STATUS;
+  if (type != napi_bigint)
+    NAPI_THROW_ERROR("timestamp must be a bigint.");
+  int64_t timestamp;
+  bool lossless;
+  status = napi_get_value_bigint_int64(env, args[0], &timestamp, &lossless);
+  CHECK_STATUS;
+  if (!lossless)
+    NAPI_THROW_ERROR("timestamp is out of range.");
+
+  std::unique_ptr<char[]> source;
+  if (argc >= 2) {
+    status = napi_typeof(env, args[1], &type);
+    CHECK_STATUS;
+    if (type != napi_undefined) {
+      if (type != napi_string)
+        NAPI_THROW_ERROR("source must be a string when present.");
+      size_t length;
+      status = napi_get_value_string_utf8(env, args[1], nullptr, 0, &length);
+      CHECK_STATUS;
+      source.reset(new (std::nothrow) char[length + 1]);
+      if (source == nullptr)
+        NAPI_THROW_ERROR("Failed to allocate source name.");
+      status = napi_get_value_string_utf8(env, args[1], source.get(),
+                                          length + 1, &length);
+      CHECK_STATUS;
+    }
+  }
+
+  if (source != nullptr) {
+    std::unique_lock<std::mutex> lock(remote.mutex);
+    auto found = remote.sources.find(source.get());
+    if (found != remote.sources.end() && !found->second.fit.points.empty()) {
+      int64_t result = found->second.fit.line.map(timestamp);
+      lock.unlock();
+      return createBigint(env, result);
+    }
+  }
+  // Unknown sources fall back to the local wall clock mapping.
+  return createBigint(env, localLine(clockMonotonicNs()).unmap(timestamp));
+}
+
+napi_value clockSources(napi_env env, napi_callback_info info) {
+  napi_status status;
+
+  clockLine line = localLine(clockMonotonicNs());
+  std::vector<sourceEstimate> estimates;
+  {
+    std::lock_guard<std::mutex> lock(remote.mutex);
+    for (const auto &entry : remote.sources) {
+      const sourceClock &clock = entry.second;
+      if (clock.fit.points.empty())
+        continue;
+      sourceEstimate estimate;
+      estimate.name = entry.first;
+      estimate.samples = clock.fit.points.size();
+      estimate.observations = clock.observations;
+      estimate.offsetMs = (double)(clock.fit.line.map(clock.lastTimestamp) -
+                                   line.unmap(clock.lastTimestamp)) /
+                          1e6;
+      estimate.skewPpm =
+          estimate.samples > 1
+              ? (clock.fit.line.slope / (double)kTickNs - 1.0) * 1e6
+              : 0.0;
+      estimate.jitterMs = clock.fit.residual / 1e6;
+      estimates.push_back(estimate);
+    }
+  }
+
+  napi_value result;
+  status = napi_create_array_with_length(env, estimates.size(), &result);
+  CHECK_STATUS;
+  for (size_t i = 0; i < estimates.size(); i++) {
+    napi_value item, value;
+    status = napi_create_object(env, &item);
+    CHECK_STATUS;
+    status = napi_create_string_utf8(env, estimates[i].name.c_str(),
+                                     NAPI_AUTO_LENGTH, &value);
+    CHECK_STATUS;
+    status = napi_set_named_property(env, item, "name", value);
+    CHECK_STATUS;
+    status = setDouble(env, item, "samples", (double)estimates[i].samples);
+    CHECK_STATUS;
+    status = setDouble(env, item, "observations",
+                       (double)estimates[i].observations);
+    CHECK_STATUS;
+    status = setDouble(env, item, "offsetMs", estimates[i].offsetMs);
+    CHECK_STATUS;
+    status = setDouble(env, item, "skewPpm", estimates[i].skewPpm);
+    CHECK_STATUS;
+    status = setDouble(env, item, "jitterMs", estimates[i].jitterMs);
+    CHECK_STATUS;
+    status = napi_set_element(env, result, (uint32_t)i, item);
+    CHECK_STATUS;
+  }
+  return result;
+}
@@ -0,0 +1,35 @@
+/* Copyright 2025 Sarhan Aissi <github@tux.tn>.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+*/
+
+#ifndef GRANDI_CLOCK_H
+#define GRANDI_CLOCK_H
+
+#include <cstdint>
+#include <string>
+
+#include "node_api.h"
+
+napi_value clockNow(napi_env env, napi_callback_info info);
+napi_value clockToMonotonic(napi_env env, napi_callback_info info);
+napi_value clockSources(napi_env env, napi_callback_info info);
+
+// Monotonic time in nanoseconds, on the same clock as process.hrtime.
+uint64_t clockMonotonicNs();
+// Records that a frame stamped with an NDI timestamp (100ns units) from the
+// named source was captured at arrivalNs. Safe to call from any thread.
+void observeClockSample(const std::string &source, int64_t timestamp,
+                        uint64_t arrivalNs);
+
+#endif /* GRANDI_CLOCK_H */
@@ -0,0 +1,206 @@
+/* Copyright 2025 Sarhan Aissi <github@tux.tn>.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+*/
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+#include "grandi_copy.h"
+#include "grandi_pool.h"
+#include "grandi_simd.h"
+#include "grandi_util.h"
+
+namespace {
+const size_t kCopyStripeBytes = 1 << 20;
+// Copies below this size run on the calling thread, where they cost less
+// than waking workers.
+const size_t kStripedCopyBytes = 4 * kCopyStripeBytes;
+
+std::atomic<int> currentMode{(int)copyMode::automatic};
+std::atomic<size_t> currentThreshold{kDefaultStreamingThreshold};
+
+const char *modeNames[3] = {"auto", "cached", "streaming"};
+
+struct copyJob {
+  uint8_t *dst;
+  const uint8_t *src;
+  bool streaming;
+};
+
+void copyStripe(void *context, size_t, size_t begin, size_t end) {
+  copyJob *job = (copyJob *)context;
+  if (job->streaming)
+    streamBytes(job->dst + begin, job->src + begin, end - begin);
+  else
+    memcpy(job->dst + begin, job->src + begin, end - begin);
+}
+
+bool streamCopy(size_t length) {
+  switch ((copyMode)currentMode.load(std::memory_order_relaxed)) {
+  case copyMode::cached:
+    return false;
+  case copyMode::streaming:
+    return true;
+  default:
+    return length >= currentThreshold.load(std::memory_order_relaxed);
+  }
+}
+
+napi_status getBuffer(napi_env env, napi_value value, void **data,
+                      size_t *length, bool *isBuffer) {
+  napi_status status = napi_is_buffer(env, value, isBuffer);
+  if (status != napi_ok || !*isBuffer)
+    return status;
+  return napi_get_buffer_info(env, value, data, length);
+}
+} // namespace
+
+void copyFrameBytes(void *dst, const void *src, size_t length) {
+  copyJob job = {(uint8_t *)dst, (const uint8_t *)src, streamCopy(length)};
+  if (length < kStripedCopyBytes) {
+    copyStripe(&job, 0, 0, length);
+    return;
+  }
+  workerPool &pool = sharedPool();
+  runStripes(pool, length, stripeCount(pool, length, kCopyStripeBytes),
+             copyStripe, &job);
+}
+
+napi_value copyStrategy(napi_env env, napi_callback_info info) {
+  napi_status status;
+  napi_value result, param;
+  status = napi_create_object(env, &result);
+  CHECK_STATUS;
+
+  status = napi_create_string_utf8(
+      env, modeNames[currentMode.load()], NAPI_AUTO_LENGTH, &param);
+  CHECK_STATUS;
+  status = napi_set_named_property(env, result, "mode", param);
+  CHECK_STATUS;
+
+  status = napi_create_double(env, (double)currentThreshold.load(), &param);
+  CHECK_STATUS;
+  status = napi_set_named_property(env, result, "threshold", param);
+  CHECK_STATUS;
+
+  status = napi_get_boolean(env, streamingStores(), &param);
+  CHECK_STATUS;
+  status = napi_set_named_property(env, result, "streamingStores", param);
+  CHECK_STATUS;
+  return result;
+}
+
+napi_value setCopyStrategy(napi_env env, napi_callback_info info) {
+  napi_status status;
+  size_t argc = 1;
+  napi_value args[1];
+  status = napi_get_cb_info(env, info, &argc, args, nullptr, nullptr);
+  CHECK_STATUS;
+
+  napi_valuetype type = napi_undefined;
+  bool isArray = false;
+  if (argc >= 1) {
+    status = napi_typeof(env, args[0], &type);
+    CHECK_STATUS;
+    status = napi_is_array(env, args[0], &isArray);
+    CHECK_STATUS;
+  }
+  if (type != napi_object || isArray)
+    NAPI_THROW_ERROR("Copy strategy must be an object.");
+
+  int mode = currentMode.load();
+  napi_value value;
+  status = napi_get_named_property(env, args[0], "mode", &value);
+  CHECK_STATUS;
+  status = napi_typeof(env, value, &type);
+  CHECK_STATUS;
+  if (type != napi_undefined) {
+    char name[16];
+    size_t length = 0;
+    if (type == napi_string) {
+      status = napi_get_value_string_utf8(env, value, name, sizeof(name),
+                                          &length);
+      CHECK_STATUS;
+    }
+    mode = -1;
+    for (int i = 0; i < 3 && type == napi_string; i++) {
+      if (std::string(name, length) == modeNames[i])
+        mode = i;
+    }
+    if (mode < 0)
+      NAPI_THROW_ERROR("mode must be \"auto\", \"cached\", or \"streaming\".");
+  }
+
+  size_t threshold = currentThreshold.load();
+  status = napi_get_named_property(env, args[0], "threshold", &value);
+  CHECK_STATUS;
+  status = napi_typeof(env, value, &type);
+  CHECK_STATUS;
+  if (type != napi_undefined) {
+    uint32_t parsed = 0;
+    std::string error;
+    status = parseUint32Value(env, value, "threshold", &parsed, &error);
+    CHECK_STATUS;
+    if (!error.empty())
+      NAPI_THROW_ERROR("threshold must be a byte count from 0 to 4294967295.");
+    threshold = parsed;
+  }
+
+  currentMode.store(mode);
+  currentThreshold.store(threshold);
+  napi_value result;
+  status = napi_get_undefined(env, &result);
+  CHECK_STATUS;
+  return result;
+}
+
+napi_value copyBuffer(napi_env env, napi_callback_info info) {
+  napi_status status;
+  size_t argc = 2;
+  napi_value args[2];
+  status = napi_get_cb_info(env, info, &argc, args, nullptr, nullptr);
+  CHECK_STATUS;
+  if (argc < 2)
+    NAPI_THROW_ERROR("target and source must be provided.");
+
+  void *target = nullptr;
+  void *source = nullptr;
+  size_t targetLength = 0;
+  size_t sourceLength = 0;
+  bool isBuffer = false;
+  status = getBuffer(env, args[0], &target, &targetLength, &isBuffer);
+  CHECK_STATUS;
+  if (!isBuffer)
+    NAPI_THROW_ERROR("target must be provided as a Node Buffer");
+  status = getBuffer(env, args[1], &source, &sourceLength, &isBuffer);
+  CHECK_STATUS;
+  if (!isBuffer)
+    NAPI_THROW_ERROR("source must be provided as a Node Buffer");
+  if (targetLength < sourceLength)
+    NAPI_THROW_ERROR("target is smaller than source.");
+
+  uint8_t *dst = (uint8_t *)target;
+  const uint8_t *src = (const uint8_t *)source;
+  if (dst < src + sourceLength && src < dst + sourceLength)
+    memmove(dst, src, sourceLength);
+  else if (sourceLength > 0)
+    copyFrameBytes(dst, src, sourceLength);
+
+  napi_value result;
+  status = napi_get_undefined(env, &result);
+  CHECK_STATUS;
+  return result;
+}
@@ -0,0 +1,43 @@
+/* Copyright 2025 Sarhan Aissi <github@tux.tn>.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+*/
+
+#ifndef GRANDI_COPY_H
+#define GRANDI_COPY_H
+
+#include <cstddef>
+
+#include "node_api.h"
+
+// How copies of received frames write their destination. Cached copies use
+// memcpy. Streaming copies use non-temporal stores, which leave the caches
+// to the stages that work on frames but do not leave the copy itself in
+// cache. Automatic copies stream from a size threshold up.
+enum class copyMode { automatic, cached, streaming };
+
+// Copies that reach the threshold in automatic mode stream. Frames this
+// large are rarely read back before the cache would have evicted them.
+const size_t kDefaultStreamingThreshold = 8 << 20;
+
+// memcpy for frame-sized buffers: copies of several megabytes are split over
+// the shared pool, and each part follows the copy mode.
+void copyFrameBytes(void *dst, const void *src, size_t length);
+
+// Exposed as copyStrategy(), setCopyStrategy(options), and
+// copyBuffer(target, source).
+napi_value copyStrategy(napi_env env, napi_callback_info info);
+napi_value setCopyStrategy(napi_env env, napi_callback_info info);
+napi_value copyBuffer(napi_env env, napi_callback_info info);
+
+#endif /* GRANDI_COPY_H */
@@ -0,0 +1,384 @@
+/* Copyright 2025 Sarhan Aissi <github@tux.tn>.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+*/
+
+#include <cstring>
+#include <utility>
+
+#include "grandi_deinterlace.h"
+#include "grandi_fields.h"
+#include "grandi_pool.h"
+#include "grandi_simd.h"
+
+namespace {
+const int64_t kTicksPerSecond = 10000000;
+// Output bytes per stripe below which rebuilding stays on fewer threads.
+const size_t kMinStripeBytes = 256 * 1024;
+
+// The lines of one field, either every other line of an interleaved frame
+// or every line of a buffer holding only that field.
+struct fieldView {
+  const uint8_t *data = nullptr;
+  const frameLayout *layout = nullptr;
+  size_t first = 0;
+  size_t step = 1;
+  const uint8_t *line(int plane, size_t index) const {
+    return data + layout->offset[plane] +
+           (first + index * step) * layout->stride[plane];
+  }
+};
+
+void averageLine(uint8_t *dst, const uint8_t *a, const uint8_t *b,
+                 size_t bytes, bool words) {
+  if (words)
+    averageWords((uint16_t *)dst, (const uint16_t *)a, (const uint16_t *)b,
+                 bytes / 2);
+  else
+    averageBytes(dst, a, b, bytes);
+}
+
+struct rebuildJob {
+  uint8_t *out;
+  const frameLayout *output;
+  size_t fieldLines;
+  int field;
+  const fieldView *current;
+  const fieldView *other;
+  const fieldView *previous;
+  const deinterlaceOptions *options;
+};
+
+// Rebuilds rows begin to end of every plane. Each output row reads only
+// source fields, so stripes are independent.
+void rebuildRows(void *context, size_t, size_t begin, size_t end) {
+  const rebuildJob &job = *(const rebuildJob *)context;
+  uint8_t *out = job.out;
+  const frameLayout &output = *job.output;
+  int field = job.field;
+  const fieldView &current = *job.current;
+  const fieldView *other = job.other;
+  const fieldView *previous = job.previous;
+  const deinterlaceOptions &options = *job.options;
+  size_t rows = job.fieldLines * 2;
+  bool blend = options.mode == deinterlaceMode::blend && other != nullptr;
+  bool adaptive = options.mode == deinterlaceMode::adaptive &&
+                  other != nullptr && previous != nullptr;
+  for (int plane = 0; plane < output.planes; plane++) {
+    size_t bytes = output.stride[plane];
+    auto row = [&](size_t r) {
+      return (int)(r & 1) == field ? current.line(plane, r / 2)
+                                   : other->line(plane, r / 2);
+    };
+    for (size_t r = begin; r < end; r++) {
+      uint8_t *dst = out + output.offset[plane] + r * bytes;
+      if (blend) {
+        // Linear blend: (up + 2 * line + down) / 4 over the woven frame.
+        const uint8_t *line = row(r);
+        averageLine(dst, row(r > 0 ? r - 1 : r), row(r + 1 < rows ? r + 1 : r),
+                    bytes, output.words);
+        averageLine(dst, dst, line, bytes, output.words);
+        continue;
+      }
+      if ((int)(r & 1) == field) {
+        memcpy(dst, current.line(plane, r / 2), bytes);
+        continue;
+      }
+      size_t aboveIndex = r > 0 ? (r - 1) / 2 : (r + 1) / 2;
+      size_t belowIndex = r + 1 < rows ? (r + 1) / 2 : aboveIndex;
+      const uint8_t *above = current.line(plane, aboveIndex);
+      const uint8_t *below = current.line(plane, belowIndex);
+      if (!adaptive) {
+        averageLine(dst, above, below, bytes, output.words);
+      } else if (output.words) {
+        selectStaticWords(
+            (uint16_t *)dst, (const uint16_t *)other->line(plane, r / 2),
+            (const uint16_t *)above, (const uint16_t *)below,
+            (const uint16_t *)previous->line(plane, aboveIndex),
+            (const uint16_t *)previous->line(plane, belowIndex),
+            (uint16_t)(options.threshold << 8), bytes / 2);
+      } else {
+        selectStaticBytes(dst, other->line(plane, r / 2), above, below,
+                          previous->line(plane, aboveIndex),
+                          previous->line(plane, belowIndex),
+                          (uint8_t)options.threshold, bytes);
+      }
+    }
+  }
+}
+
+// Rebuilds the lines `field` lacks. `other` is the opposite field and
+// `previous` the last field of the same parity; either may be null.
+void rebuildFrame(uint8_t *out, const frameLayout &output, size_t fieldLines,
+                  int field, const fieldView &current, const fieldView *other,
+                  const fieldView *previous,
+                  const deinterlaceOptions &options) {
+  size_t rows = fieldLines * 2;
+  size_t rowBytes = 0;
+  for (int plane = 0; plane < output.planes; plane++)
+    rowBytes += output.stride[plane];
+  rebuildJob job = {out,   &output, fieldLines, field,
+                    &current, other, previous, &options};
+  workerPool &pool = sharedPool();
+  size_t minRows = kMinStripeBytes / (rowBytes > 0 ? rowBytes : 1);
+  runStripes(pool, rows, stripeCount(pool, rows, minRows > 0 ? minRows : 1),
+             rebuildRows, &job);
+}
+
+// Doubles the frame rate, halving the denominator when it stays exact.
+void doubleFrameRate(NDIlib_video_frame_v2_t *frame) {
+  if (frame->frame_rate_D % 2 == 0)
+    frame->frame_rate_D /= 2;
+  else
+    frame->frame_rate_N *= 2;
+}
+
+napi_status readString(napi_env env, napi_value value, char *buffer,
+                       size_t length, bool *fits) {
+  size_t copied;
+  napi_status status =
+      napi_get_value_string_utf8(env, value, buffer, length, &copied);
+  *fits = copied + 1 < length;
+  return status;
+}
+} // namespace
+
+napi_status parseDeinterlaceOptions(napi_env env, napi_value value,
+                                    deinterlaceOptions *options,
+                                    std::string *error) {
+  error->clear();
+  napi_status status;
+  napi_valuetype type;
+  bool isArray;
+  status = napi_typeof(env, value, &type);
+  PASS_STATUS;
+  status = napi_is_array(env, value, &isArray);
+  PASS_STATUS;
+  if (type != napi_object || isArray) {
+    *error = "deinterlace property must be an object.";
+    return napi_ok;
+  }
+
+  napi_value mode;
+  status = napi_get_named_property(env, value, "mode", &mode);
+  PASS_STATUS;
+  status = napi_typeof(env, mode, &type);
+  PASS_STATUS;
+  if (type != napi_undefined) {
+    char name[16] = {};
+    bool fits = false;
+    if (type == napi_string) {
+      status = readString(env, mode, name, sizeof(name), &fits);
+      PASS_STATUS;
+    }
+    if (fits && strcmp(name, "bob") == 0) {
+      options->mode = deinterlaceMode::bob;
+    } else if (fits && strcmp(name, "blend") == 0) {
+      options->mode = deinterlaceMode::blend;
+    } else if (fits && strcmp(name, "adaptive") == 0) {
+      options->mode = deinterlaceMode::adaptive;
+    } else {
+      *error = "deinterlace.mode must be \"bob\", \"blend\", or \"adaptive\".";
+      return napi_ok;
+    }
+  }
+
+  napi_value fieldRate;
+  status = napi_get_named_property(env, value, "fieldRate", &fieldRate);
+  PASS_STATUS;
+  status = napi_typeof(env, fieldRate, &type);
+  PASS_STATUS;
+  if (type != napi_undefined) {
+    if (type != napi_boolean) {
+      *error = "deinterlace.fieldRate must be a Boolean.";
+      return napi_ok;
+    }
+    status = napi_get_value_bool(env, fieldRate, &options->fieldRate);
+    PASS_STATUS;
+  }
+  if (options->fieldRate && options->mode == deinterlaceMode::blend) {
+    *error = "deinterlace.fieldRate cannot be combined with blend mode.";
+    return napi_ok;
+  }
+
+  napi_value threshold;
+  status = napi_get_named_property(env, value, "threshold", &threshold);
+  PASS_STATUS;
+  status = napi_typeof(env, threshold, &type);
+  PASS_STATUS;
+  if (type != napi_undefined) {
+    status = parseUint32Value(env, threshold, "deinterlace.threshold",
+                              &options->threshold, error);
+    PASS_STATUS;
+    if (error->empty() && options->threshold > 255)
+      *error = "deinterlace.threshold must be between 0 and 255.";
+  }
+  return napi_ok;
+}
+
+deinterlacer::deinterlacer(const deinterlaceOptions &options)
+    : options(options) {}
+
+deinterlaceResult deinterlacer::process(const NDIlib_video_frame_v2_t &frame,
+                                        int field, bool emit,
+                                        ownedBuffer *buffer,
+                                        NDIlib_video_frame_v2_t *output) {
+  bool interleaved =
+      frame.frame_format_type == NDIlib_frame_format_type_interleaved;
+  bool single = frame.frame_format_type == NDIlib_frame_format_type_field_0 ||
+                frame.frame_format_type == NDIlib_frame_format_type_field_1;
+  if (frame.p_data == nullptr || frame.yres <= 0 || (!interleaved && !single))
+    return deinterlaceResult::passthrough;
+  if (interleaved && frame.yres % 2 != 0)
+    return deinterlaceResult::passthrough;
+
+  size_t fieldLines = interleaved ? (size_t)frame.yres / 2 : (size_t)frame.yres;
+  frameLayout source, compact, target;
+  if (!describeFrame(frame.FourCC, frame.line_stride_in_bytes,
+                     (size_t)frame.yres, &source) ||
+      !describeFrame(frame.FourCC, frame.line_stride_in_bytes, fieldLines,
+                     &compact) ||
+      !describeFrame(frame.FourCC, frame.line_stride_in_bytes, fieldLines * 2,
+                     &target))
+    return deinterlaceResult::passthrough;
+
+  int parity = interleaved ? field
+               : frame.frame_format_type == NDIlib_frame_format_type_field_1
+                   ? 1
+                   : 0;
+  fieldView current;
+  current.data = frame.p_data;
+  current.layout = &source;
+  current.first = interleaved ? (size_t)parity : 0;
+  current.step = interleaved ? 2 : 1;
+
+  auto matches = [&](const storedField &stored) {
+    return stored.valid && stored.fourCC == frame.FourCC &&
+           stored.xres == frame.xres && stored.lines == (int)fieldLines &&
+           stored.lineStride == frame.line_stride_in_bytes;
+  };
+  fieldView otherView, previousView;
+  const fieldView *other = nullptr;
+  const fieldView *previous = nullptr;
+  if (interleaved) {
+    otherView = current;
+    otherView.first = (size_t)(1 - parity);
+    other = &otherView;
+  } else if (matches(fields[1 - parity])) {
+    otherView.data = (const uint8_t *)fields[1 - parity].buffer.data;
+    otherView.layout = &compact;
+    other = &otherView;
+  }
+  if (matches(fields[parity])) {
+    previousView.data = (const uint8_t *)fields[parity].buffer.data;
+    previousView.layout = &compact;
+    previous = &previousView;
+  }
+
+  if (emit) {
+    if (!buffer->allocate(target.size))
+      return deinterlaceResult::allocationFailure;
+    rebuildFrame((uint8_t *)buffer->data, target, fieldLines, parity, current,
+                 other, previous, options);
+    *output = frame;
+    output->p_data = nullptr;
+    output->p_metadata = nullptr;
+    output->yres = (int)(fieldLines * 2);
+    output->frame_format_type = NDIlib_frame_format_type_progressive;
+  }
+
+  // Bob needs no history. Keep the current field for the next call; a
+  // failed allocation only costs that call its history.
+  if (options.mode != deinterlaceMode::bob) {
+    storedField &stored = fields[parity];
+    stored.valid = false;
+    if (stored.buffer.size == compact.size ||
+        stored.buffer.allocate(compact.size)) {
+      for (int plane = 0; plane < compact.planes; plane++)
+        for (size_t i = 0; i < fieldLines; i++)
+          memcpy((uint8_t *)stored.buffer.data + compact.offset[plane] +
+                     i * compact.stride[plane],
+                 current.line(plane, i), compact.stride[plane]);
+      stored.valid = true;
+      stored.fourCC = frame.FourCC;
+      stored.xres = frame.xres;
+      stored.lines = (int)fieldLines;
+      stored.lineStride = frame.line_stride_in_bytes;
+    }
+  }
+  return emit ? deinterlaceResult::converted : deinterlaceResult::needField;
+}
+
+deinterlaceResult
+deinterlacer::convertField(const NDIlib_video_frame_v2_t &frame, int field,
+                           ownedBuffer *buffer,
+                           NDIlib_video_frame_v2_t *output) {
+  return process(frame, field == 1 ? 1 : 0, true, buffer, output);
+}
+
+deinterlaceResult deinterlacer::convert(const NDIlib_video_frame_v2_t &frame,
+                                        ownedBuffer *buffer,
+                                        NDIlib_video_frame_v2_t *output,
+                                        std::string *metadata) {
+  pendingValid = false;
+  // Without fieldRate a frame is emitted once its second field arrives.
+  if (!options.fieldRate &&
+      frame.frame_format_type == NDIlib_frame_format_type_field_0) {
+    deinterlaceResult result = process(frame, 0, false, nullptr, nullptr);
+    if (result == deinterlaceResult::passthrough)
+      return result;
+    return deinterlaceResult::needField;
+  }
+
+  deinterlaceResult result = process(frame, 0, true, buffer, output);
+  if (result != deinterlaceResult::converted)
+    return result;
+  if (frame.p_metadata != nullptr)
+    metadata->assign(frame.p_metadata);
+  else
+    metadata->clear();
+  if (!options.fieldRate)
+    return result;
+
+  doubleFrameRate(output);
+  if (frame.frame_format_type != NDIlib_frame_format_type_interleaved)
+    return result;
+
+  result = process(frame, 1, true, &pendingBuffer, &pendingFrame);
+  if (result != deinterlaceResult::converted)
+    return result;
+  doubleFrameRate(&pendingFrame);
+  if (frame.frame_rate_N > 0 && frame.frame_rate_D > 0) {
+    int64_t halfPeriod = kTicksPerSecond * frame.frame_rate_D /
+                         (2 * (int64_t)frame.frame_rate_N);
+    if (pendingFrame.timestamp != NDIlib_recv_timestamp_undefined)
+      pendingFrame.timestamp += halfPeriod;
+    if (pendingFrame.timecode != NDIlib_send_timecode_synthesize)
+      pendingFrame.timecode += halfPeriod;
+  }
+  pendingMetadata = *metadata;
+  pendingValid = true;
+  return deinterlaceResult::converted;
+}
+
+bool deinterlacer::takePending(ownedBuffer *buffer,
+                               NDIlib_video_frame_v2_t *output,
+                               std::string *metadata) {
+  if (!pendingValid)
+    return false;
+  pendingValid = false;
+  buffer->swap(pendingBuffer);
+  *output = pendingFrame;
+  metadata->swap(pendingMetadata);
+  return true;
+}
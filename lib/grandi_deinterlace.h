@@ -0,0 +1,101 @@
+/* Copyright 2025 Sarhan Aissi <github@tux.tn>.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+*/
+
+#ifndef GRANDI_DEINTERLACE_H
+#define GRANDI_DEINTERLACE_H
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+#include <Processing.NDI.Lib.h>
+
+#include "grandi_util.h"
+
+enum class deinterlaceMode {
+  bob,
+  blend,
+  adaptive,
+};
+
+struct deinterlaceOptions {
+  deinterlaceMode mode = deinterlaceMode::bob;
+  bool fieldRate = false;
+  // Largest 8-bit sample change still treated as static in adaptive mode.
+  uint32_t threshold = 10;
+};
+
+// Parses a `deinterlace` option object. Invalid values set error and return
+// napi_ok, like parseUint32Value.
+napi_status parseDeinterlaceOptions(napi_env env, napi_value value,
+                                    deinterlaceOptions *options,
+                                    std::string *error);
+
+enum class deinterlaceResult {
+  converted,
+  needField,
+  passthrough,
+  allocationFailure,
+};
+
+// Rebuilds progressive frames from interleaved frames and from field_0 and
+// field_1 frames. Progressive input, 4:2:0 formats, and flipped strides pass
+// through. Blend and adaptive modes keep the latest field of each parity;
+// callers hold `mutex` around every call.
+struct deinterlacer {
+  explicit deinterlacer(const deinterlaceOptions &options);
+  std::mutex mutex;
+
+  // Receiver policy. With fieldRate, every field becomes a frame at twice
+  // the frame rate and the second field of an interleaved frame waits in
+  // takePending. Otherwise field_0 frames are only stored and return
+  // needField. output.p_data and output.p_metadata are left null; metadata
+  // receives a copy of the frame metadata.
+  deinterlaceResult convert(const NDIlib_video_frame_v2_t &frame,
+                            ownedBuffer *buffer,
+                            NDIlib_video_frame_v2_t *output,
+                            std::string *metadata);
+  bool takePending(ownedBuffer *buffer, NDIlib_video_frame_v2_t *output,
+                   std::string *metadata);
+  // Rebuilds one field into a full frame. `field` picks the field of an
+  // interleaved frame; field frames use their own parity.
+  deinterlaceResult convertField(const NDIlib_video_frame_v2_t &frame,
+                                 int field, ownedBuffer *buffer,
+                                 NDIlib_video_frame_v2_t *output);
+
+private:
+  struct storedField {
+    bool valid = false;
+    NDIlib_FourCC_video_type_e fourCC = NDIlib_FourCC_type_UYVY;
+    int xres = 0;
+    int lines = 0;
+    int lineStride = 0;
+    ownedBuffer buffer;
+  };
+
+  deinterlaceResult process(const NDIlib_video_frame_v2_t &frame, int field,
+                            bool emit, ownedBuffer *buffer,
+                            NDIlib_video_frame_v2_t *output);
+
+  deinterlaceOptions options;
+  storedField fields[2];
+
+  bool pendingValid = false;
+  ownedBuffer pendingBuffer;
+  NDIlib_video_frame_v2_t pendingFrame{};
+  std::string pendingMetadata;
+};
+
+#endif /* GRANDI_DEINTERLACE_H */
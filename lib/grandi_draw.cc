@@ -0,0 +1,310 @@
+/* Copyright 2025 Sarhan Aissi <github@tux.tn>.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+*/
+
+#include <algorithm>
+#include <cstring>
+
+#include "grandi_draw.h"
+
+namespace {
+// Glyphs for 0x20-0x7e, one byte per row with the leftmost pixel in bit 0.
+const uint8_t kFont[95][kGlyphSize] = {
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // space
+    {0x18, 0x3c, 0x3c, 0x18, 0x18, 0x00, 0x18, 0x00}, // '!'
+    {0x36, 0x36, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // '"'
+    {0x36, 0x36, 0x7f, 0x36, 0x7f, 0x36, 0x36, 0x00}, // '#'
+    {0x0c, 0x3e, 0x03, 0x1e, 0x30, 0x1f, 0x0c, 0x00}, // '$'
+    {0x00, 0x63, 0x33, 0x18, 0x0c, 0x66, 0x63, 0x00}, // '%'
+    {0x1c, 0x36, 0x1c, 0x6e, 0x3b, 0x33, 0x6e, 0x00}, // '&'
+    {0x06, 0x06, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00}, // "'"
+    {0x18, 0x0c, 0x06, 0x06, 0x06, 0x0c, 0x18, 0x00}, // '('
+    {0x06, 0x0c, 0x18, 0x18, 0x18, 0x0c, 0x06, 0x00}, // ')'
+    {0x00, 0x66, 0x3c, 0xff, 0x3c, 0x66, 0x00, 0x00}, // '*'
+    {0x00, 0x0c, 0x0c, 0x3f, 0x0c, 0x0c, 0x00, 0x00}, // '+'
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x0c, 0x0c, 0x06}, // ','
+    {0x00, 0x00, 0x00, 0x3f, 0x00, 0x00, 0x00, 0x00}, // '-'
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x0c, 0x0c, 0x00}, // '.'
+    {0x60, 0x30, 0x18, 0x0c, 0x06, 0x03, 0x01, 0x00}, // '/'
+    {0x3e, 0x63, 0x73, 0x7b, 0x6f, 0x67, 0x3e, 0x00}, // '0'
+    {0x0c, 0x0e, 0x0c, 0x0c, 0x0c, 0x0c, 0x3f, 0x00}, // '1'
+    {0x1e, 0x33, 0x30, 0x1c, 0x06, 0x33, 0x3f, 0x00}, // '2'
+    {0x1e, 0x33, 0x30, 0x1c, 0x30, 0x33, 0x1e, 0x00}, // '3'
+    {0x38, 0x3c, 0x36, 0x33, 0x7f, 0x30, 0x78, 0x00}, // '4'
+    {0x3f, 0x03, 0x1f, 0x30, 0x30, 0x33, 0x1e, 0x00}, // '5'
+    {0x1c, 0x06, 0x03, 0x1f, 0x33, 0x33, 0x1e, 0x00}, // '6'
+    {0x3f, 0x33, 0x30, 0x18, 0x0c, 0x0c, 0x0c, 0x00}, // '7'
+    {0x1e, 0x33, 0x33, 0x1e, 0x33, 0x33, 0x1e, 0x00}, // '8'
+    {0x1e, 0x33, 0x33, 0x3e, 0x30, 0x18, 0x0e, 0x00}, // '9'
+    {0x00, 0x0c, 0x0c, 0x00, 0x00, 0x0c, 0x0c, 0x00}, // ':'
+    {0x00, 0x0c, 0x0c, 0x00, 0x00, 0x0c, 0x0c, 0x06}, // ';'
+    {0x18, 0x0c, 0x06, 0x03, 0x06, 0x0c, 0x18, 0x00}, // '<'
+    {0x00, 0x00, 0x3f, 0x00, 0x00, 0x3f, 0x00, 0x00}, // '='
+    {0x06, 0x0c, 0x18, 0x30, 0x18, 0x0c, 0x06, 0x00}, // '>'
+    {0x1e, 0x33, 0x30, 0x18, 0x0c, 0x00, 0x0c, 0x00}, // '?'
+    {0x3e, 0x63, 0x7b, 0x7b, 0x7b, 0x03, 0x1e, 0x00}, // '@'
+    {0x0c, 0x1e, 0x33, 0x33, 0x3f, 0x33, 0x33, 0x00}, // 'A'
+    {0x3f, 0x66, 0x66, 0x3e, 0x66, 0x66, 0x3f, 0x00}, // 'B'
+    {0x3c, 0x66, 0x03, 0x03, 0x03, 0x66, 0x3c, 0x00}, // 'C'
+    {0x1f, 0x36, 0x66, 0x66, 0x66, 0x36, 0x1f, 0x00}, // 'D'
+    {0x7f, 0x46, 0x16, 0x1e, 0x16, 0x46, 0x7f, 0x00}, // 'E'
+    {0x7f, 0x46, 0x16, 0x1e, 0x16, 0x06, 0x0f, 0x00}, // 'F'
+    {0x3c, 0x66, 0x03, 0x03, 0x73, 0x66, 0x7c, 0x00}, // 'G'
+    {0x33, 0x33, 0x33, 0x3f, 0x33, 0x33, 0x33, 0x00}, // 'H'
+    {0x1e, 0x0c, 0x0c, 0x0c, 0x0c, 0x0c, 0x1e, 0x00}, // 'I'
+    {0x78, 0x30, 0x30, 0x30, 0x33, 0x33, 0x1e, 0x00}, // 'J'
+    {0x67, 0x66, 0x36, 0x1e, 0x36, 0x66, 0x67, 0x00}, // 'K'
+    {0x0f, 0x06, 0x06, 0x06, 0x46, 0x66, 0x7f, 0x00}, // 'L'
+    {0x63, 0x77, 0x7f, 0x7f, 0x6b, 0x63, 0x63, 0x00}, // 'M'
+    {0x63, 0x67, 0x6f, 0x7b, 0x73, 0x63, 0x63, 0x00}, // 'N'
+    {0x1c, 0x36, 0x63, 0x63, 0x63, 0x36, 0x1c, 0x00}, // 'O'
+    {0x3f, 0x66, 0x66, 0x3e, 0x06, 0x06, 0x0f, 0x00}, // 'P'
+    {0x1e, 0x33, 0x33, 0x33, 0x3b, 0x1e, 0x38, 0x00}, // 'Q'
+    {0x3f, 0x66, 0x66, 0x3e, 0x36, 0x66, 0x67, 0x00}, // 'R'
+    {0x1e, 0x33, 0x07, 0x0e, 0x38, 0x33, 0x1e, 0x00}, // 'S'
+    {0x3f, 0x2d, 0x0c, 0x0c, 0x0c, 0x0c, 0x1e, 0x00}, // 'T'
+    {0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x3f, 0x00}, // 'U'
+    {0x33, 0x33, 0x33, 0x33, 0x33, 0x1e, 0x0c, 0x00}, // 'V'
+    {0x63, 0x63, 0x63, 0x6b, 0x7f, 0x77, 0x63, 0x00}, // 'W'
+    {0x63, 0x63, 0x36, 0x1c, 0x1c, 0x36, 0x63, 0x00}, // 'X'
+    {0x33, 0x33, 0x33, 0x1e, 0x0c, 0x0c, 0x1e, 0x00}, // 'Y'
+    {0x7f, 0x63, 0x31, 0x18, 0x4c, 0x66, 0x7f, 0x00}, // 'Z'
+    {0x1e, 0x06, 0x06, 0x06, 0x06, 0x06, 0x1e, 0x00}, // '['
+    {0x03, 0x06, 0x0c, 0x18, 0x30, 0x60, 0x40, 0x00}, // '\\'
+    {0x1e, 0x18, 0x18, 0x18, 0x18, 0x18, 0x1e, 0x00}, // ']'
+    {0x08, 0x1c, 0x36, 0x63, 0x00, 0x00, 0x00, 0x00}, // '^'
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff}, // '_'
+    {0x0c, 0x0c, 0x18, 0x00, 0x00, 0x00, 0x00, 0x00}, // '`'
+    {0x00, 0x00, 0x1e, 0x30, 0x3e, 0x33, 0x6e, 0x00}, // 'a'
+    {0x07, 0x06, 0x06, 0x3e, 0x66, 0x66, 0x3b, 0x00}, // 'b'
+    {0x00, 0x00, 0x1e, 0x33, 0x03, 0x33, 0x1e, 0x00}, // 'c'
+    {0x38, 0x30, 0x30, 0x3e, 0x33, 0x33, 0x6e, 0x00}, // 'd'
+    {0x00, 0x00, 0x1e, 0x33, 0x3f, 0x03, 0x1e, 0x00}, // 'e'
+    {0x1c, 0x36, 0x06, 0x0f, 0x06, 0x06, 0x0f, 0x00}, // 'f'
+    {0x00, 0x00, 0x6e, 0x33, 0x33, 0x3e, 0x30, 0x1f}, // 'g'
+    {0x07, 0x06, 0x36, 0x6e, 0x66, 0x66, 0x67, 0x00}, // 'h'
+    {0x0c, 0x00, 0x0e, 0x0c, 0x0c, 0x0c, 0x1e, 0x00}, // 'i'
+    {0x30, 0x00, 0x30, 0x30, 0x30, 0x33, 0x33, 0x1e}, // 'j'
+    {0x07, 0x06, 0x66, 0x36, 0x1e, 0x36, 0x67, 0x00}, // 'k'
+    {0x0e, 0x0c, 0x0c, 0x0c, 0x0c, 0x0c, 0x1e, 0x00}, // 'l'
+    {0x00, 0x00, 0x33, 0x7f, 0x7f, 0x6b, 0x63, 0x00}, // 'm'
+    {0x00, 0x00, 0x1f, 0x33, 0x33, 0x33, 0x33, 0x00}, // 'n'
+    {0x00, 0x00, 0x1e, 0x33, 0x33, 0x33, 0x1e, 0x00}, // 'o'
+    {0x00, 0x00, 0x3b, 0x66, 0x66, 0x3e, 0x06, 0x0f}, // 'p'
+    {0x00, 0x00, 0x6e, 0x33, 0x33, 0x3e, 0x30, 0x78}, // 'q'
+    {0x00, 0x00, 0x3b, 0x6e, 0x66, 0x06, 0x0f, 0x00}, // 'r'
+    {0x00, 0x00, 0x3e, 0x03, 0x1e, 0x30, 0x1f, 0x00}, // 's'
+    {0x08, 0x0c, 0x3e, 0x0c, 0x0c, 0x2c, 0x18, 0x00}, // 't'
+    {0x00, 0x00, 0x33, 0x33, 0x33, 0x33, 0x6e, 0x00}, // 'u'
+    {0x00, 0x00, 0x33, 0x33, 0x33, 0x1e, 0x0c, 0x00}, // 'v'
+    {0x00, 0x00, 0x63, 0x6b, 0x7f, 0x7f, 0x36, 0x00}, // 'w'
+    {0x00, 0x00, 0x63, 0x36, 0x1c, 0x36, 0x63, 0x00}, // 'x'
+    {0x00, 0x00, 0x33, 0x33, 0x33, 0x3e, 0x30, 0x1f}, // 'y'
+    {0x00, 0x00, 0x3f, 0x19, 0x0c, 0x26, 0x3f, 0x00}, // 'z'
+    {0x38, 0x0c, 0x0c, 0x07, 0x0c, 0x0c, 0x38, 0x00}, // '{'
+    {0x18, 0x18, 0x18, 0x00, 0x18, 0x18, 0x18, 0x00}, // '|'
+    {0x07, 0x0c, 0x0c, 0x38, 0x0c, 0x0c, 0x07, 0x00}, // '}'
+    {0x6e, 0x3b, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // '~'
+};
+
+const uint8_t *glyphFor(char c) {
+  unsigned char code = (unsigned char)c;
+  if (code < 0x20 || code > 0x7e)
+    code = '?';
+  return kFont[code - 0x20];
+}
+
+bool yuvTarget(NDIlib_FourCC_video_type_e fourCC) {
+  return fourCC == NDIlib_FourCC_type_UYVY || fourCC == NDIlib_FourCC_type_UYVA;
+}
+
+// Byte order of the color channels in a 4-byte pixel.
+void pixelBytes(NDIlib_FourCC_video_type_e fourCC, const drawColor &color,
+                uint8_t pixel[4]) {
+  bool bgr = fourCC == NDIlib_FourCC_type_BGRA ||
+             fourCC == NDIlib_FourCC_type_BGRX;
+  pixel[0] = bgr ? color.b : color.r;
+  pixel[1] = color.g;
+  pixel[2] = bgr ? color.r : color.b;
+  pixel[3] = 255;
+}
+
+uint8_t *alphaPlane(const drawTarget &target) {
+  if (target.fourCC != NDIlib_FourCC_type_UYVA)
+    return nullptr;
+  return target.data + (size_t)target.yres * target.lineStride;
+}
+
+int hexDigit(char c) {
+  if (c >= '0' && c <= '9')
+    return c - '0';
+  if (c >= 'a' && c <= 'f')
+    return c - 'a' + 10;
+  if (c >= 'A' && c <= 'F')
+    return c - 'A' + 10;
+  return -1;
+}
+} // namespace
+
+drawColor makeDrawColor(uint8_t r, uint8_t g, uint8_t b) {
+  drawColor color;
+  color.r = r;
+  color.g = g;
+  color.b = b;
+  color.y = lumaFromRgb(r, g, b);
+  color.u = blueDifferenceFromRgb(r, g, b);
+  color.v = redDifferenceFromRgb(r, g, b);
+  return color;
+}
+
+napi_status parseDrawColor(napi_env env, napi_value value, const char *name,
+                           drawColor *color, std::string *error) {
+  error->clear();
+  napi_valuetype type;
+  napi_status status = napi_typeof(env, value, &type);
+  if (status != napi_ok)
+    return status;
+
+  char text[8] = {};
+  size_t length = 0;
+  if (type == napi_string) {
+    status = napi_get_value_string_utf8(env, value, nullptr, 0, &length);
+    if (status == napi_ok && length == 7)
+      status = napi_get_value_string_utf8(env, value, text, sizeof(text),
+                                          &length);
+    if (status != napi_ok)
+      return status;
+  }
+  int digits[6];
+  bool valid = length == 7 && text[0] == '#';
+  for (int i = 0; valid && i < 6; i++) {
+    digits[i] = hexDigit(text[i + 1]);
+    valid = digits[i] >= 0;
+  }
+  if (!valid) {
+    *error = std::string(name) + " must be a color string such as \"#ff0000\".";
+    return napi_ok;
+  }
+  *color = makeDrawColor((uint8_t)(digits[0] * 16 + digits[1]),
+                         (uint8_t)(digits[2] * 16 + digits[3]),
+                         (uint8_t)(digits[4] * 16 + digits[5]));
+  return napi_ok;
+}
+
+bool drawable(NDIlib_FourCC_video_type_e fourCC) {
+  switch (fourCC) {
+  case NDIlib_FourCC_type_UYVY:
+  case NDIlib_FourCC_type_UYVA:
+  case NDIlib_FourCC_type_BGRA:
+  case NDIlib_FourCC_type_BGRX:
+  case NDIlib_FourCC_type_RGBA:
+  case NDIlib_FourCC_type_RGBX:
+    return true;
+  default:
+    return false;
+  }
+}
+
+void fillRect(const drawTarget &target, int x, int y, int width, int height,
+              const drawColor &color) {
+  int left = std::max(x, 0);
+  int top = std::max(y, 0);
+  int right = std::min(x + width, target.xres);
+  int bottom = std::min(y + height, target.yres);
+  if (yuvTarget(target.fourCC)) {
+    left &= ~1;
+    right = std::min((right + 1) & ~1, target.xres & ~1);
+  }
+  if (left >= right || top >= bottom)
+    return;
+
+  uint8_t *alpha = alphaPlane(target);
+  if (yuvTarget(target.fourCC)) {
+    uint8_t pair[4] = {color.u, color.y, color.v, color.y};
+    for (int row = top; row < bottom; row++) {
+      uint8_t *line = target.data + (size_t)row * target.lineStride;
+      for (int column = left; column < right; column += 2)
+        memcpy(line + column * 2, pair, 4);
+      if (alpha != nullptr)
+        memset(alpha + (size_t)row * (target.lineStride / 2) + left, 255,
+               right - left);
+    }
+    return;
+  }
+
+  uint8_t pixel[4];
+  pixelBytes(target.fourCC, color, pixel);
+  for (int row = top; row < bottom; row++) {
+    uint8_t *line = target.data + (size_t)row * target.lineStride;
+    for (int column = left; column < right; column++)
+      memcpy(line + column * 4, pixel, 4);
+  }
+}
+
+void strokeRect(const drawTarget &target, int x, int y, int width, int height,
+                int thickness, const drawColor &color) {
+  if (thickness <= 0 || width <= 0 || height <= 0)
+    return;
+  thickness = std::min(thickness, std::min(width, height) / 2 + 1);
+  fillRect(target, x, y, width, thickness, color);
+  fillRect(target, x, y + height - thickness, width, thickness, color);
+  fillRect(target, x, y + thickness, thickness, height - 2 * thickness, color);
+  fillRect(target, x + width - thickness, y + thickness, thickness,
+           height - 2 * thickness, color);
+}
+
+void drawText(const drawTarget &target, int x, int y, int scale,
+              const char *text, size_t length, const drawColor &color) {
+  if (scale <= 0)
+    return;
+  bool yuv = yuvTarget(target.fourCC);
+  uint8_t *alpha = alphaPlane(target);
+  uint8_t pixel[4];
+  pixelBytes(target.fourCC, color, pixel);
+  int limit = yuv ? target.xres & ~1 : target.xres;
+
+  for (size_t index = 0; index < length; index++) {
+    const uint8_t *glyph = glyphFor(text[index]);
+    int left = x + textWidth(index, scale);
+    if (left >= limit)
+      break;
+    for (int glyphRow = 0; glyphRow < kGlyphSize; glyphRow++) {
+      uint8_t bits = glyph[glyphRow];
+      if (bits == 0)
+        continue;
+      for (int repeat = 0; repeat < scale; repeat++) {
+        int row = y + glyphRow * scale + repeat;
+        if (row < 0 || row >= target.yres)
+          continue;
+        uint8_t *line = target.data + (size_t)row * target.lineStride;
+        for (int column = 0; column < kGlyphSize * scale; column++) {
+          int px = left + column;
+          if (px < 0 || px >= limit || !((bits >> (column / scale)) & 1))
+            continue;
+          if (!yuv) {
+            memcpy(line + px * 4, pixel, 4);
+            continue;
+          }
+          // Chroma is shared by a pixel pair, so a lit pixel colors both.
+          uint8_t *pair = line + (px & ~1) * 2;
+          pair[0] = color.u;
+          pair[2] = color.v;
+          line[px * 2 + 1] = color.y;
+          if (alpha != nullptr)
+            alpha[(size_t)row * (target.lineStride / 2) + px] = 255;
+        }
+      }
+    }
+  }
+}
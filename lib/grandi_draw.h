@@ -0,0 +1,79 @@
+/* Copyright 2025 Sarhan Aissi <github@tux.tn>.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+*/
+
+#ifndef GRANDI_DRAW_H
+#define GRANDI_DRAW_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include <Processing.NDI.Lib.h>
+
+#include "node_api.h"
+
+// An opaque color with its BT.709 limited-range YUV equivalent.
+struct drawColor {
+  uint8_t r = 0, g = 0, b = 0;
+  uint8_t y = 16, u = 128, v = 128;
+};
+
+drawColor makeDrawColor(uint8_t r, uint8_t g, uint8_t b);
+
+// BT.709 limited-range conversion in 8.8 fixed point.
+inline uint8_t lumaFromRgb(int r, int g, int b) {
+  return (uint8_t)(16 + ((47 * r + 157 * g + 16 * b + 128) >> 8));
+}
+inline uint8_t blueDifferenceFromRgb(int r, int g, int b) {
+  return (uint8_t)(128 + ((-26 * r - 87 * g + 112 * b + 128) >> 8));
+}
+inline uint8_t redDifferenceFromRgb(int r, int g, int b) {
+  return (uint8_t)(128 + ((112 * r - 102 * g - 10 * b + 128) >> 8));
+}
+
+// Parses a "#rrggbb" string. Invalid values set error and return napi_ok,
+// like parseUint32Value.
+napi_status parseDrawColor(napi_env env, napi_value value, const char *name,
+                           drawColor *color, std::string *error);
+
+// A writable 8-bit frame: UYVY, UYVA, BGRA, BGRX, RGBA, or RGBX. UYVA alpha
+// is written as opaque wherever a color is drawn.
+struct drawTarget {
+  uint8_t *data = nullptr;
+  NDIlib_FourCC_video_type_e fourCC = NDIlib_FourCC_type_UYVY;
+  int xres = 0;
+  int yres = 0;
+  int lineStride = 0;
+};
+
+bool drawable(NDIlib_FourCC_video_type_e fourCC);
+
+// Rectangles are clipped to the target. In 4:2:2 formats the horizontal
+// edges are widened to whole pixel pairs.
+void fillRect(const drawTarget &target, int x, int y, int width, int height,
+              const drawColor &color);
+void strokeRect(const drawTarget &target, int x, int y, int width, int height,
+                int thickness, const drawColor &color);
+
+// Built-in 8x8 font for printable ASCII, scaled by an integer factor. Other
+// bytes draw as '?'. Only lit pixels are written.
+const int kGlyphSize = 8;
+inline int textWidth(size_t length, int scale) {
+  return (int)length * kGlyphSize * scale;
+}
+void drawText(const drawTarget &target, int x, int y, int scale,
+              const char *text, size_t length, const drawColor &color);
+
+#endif /* GRANDI_DRAW_H */
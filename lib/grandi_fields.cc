@@ -0,0 +1,355 @@
+/* Copyright 2025 Sarhan Aissi <github@tux.tn>.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+*/
+
+#include <cstring>
+#include <string>
+
+#include "grandi_fields.h"
+#include "grandi_util.h"
+
+namespace {
+// Properties that describe the picture rather than its memory layout. They
+// are carried over unchanged between frames and fields.
+const char *const kCarriedProperties[] = {
+    "type",     "frameRateN", "frameRateD", "pictureAspectRatio",
+    "timecode", "timestamp",  "metadata",
+};
+
+struct fieldFrame {
+  int32_t xres = 0;
+  int32_t yres = 0;
+  int32_t fourCC = 0;
+  int32_t lineStride = 0;
+  int32_t formatType = 0;
+  const uint8_t *data = nullptr;
+  size_t length = 0;
+  frameLayout layout;
+};
+
+napi_status readInt32Property(napi_env env, napi_value object,
+                              const char *name, int32_t *result,
+                              std::string *error) {
+  napi_status status;
+  napi_value value;
+  status = napi_get_named_property(env, object, name, &value);
+  PASS_STATUS;
+  napi_valuetype type;
+  status = napi_typeof(env, value, &type);
+  PASS_STATUS;
+  if (type != napi_number) {
+    *error = std::string(name) + " value must be a number";
+    return napi_ok;
+  }
+  return napi_get_value_int32(env, value, result);
+}
+
+// Reads the layout of a video frame object. Invalid frames set error.
+napi_status readFieldFrame(napi_env env, napi_value value, fieldFrame *frame,
+                           std::string *error) {
+  napi_status status;
+  napi_valuetype type;
+  bool isArray;
+  status = napi_typeof(env, value, &type);
+  PASS_STATUS;
+  status = napi_is_array(env, value, &isArray);
+  PASS_STATUS;
+  if (type != napi_object || isArray) {
+    *error = "frame must be an object";
+    return napi_ok;
+  }
+
+  const char *names[] = {"xres", "yres", "fourCC", "lineStrideBytes",
+                         "frameFormatType"};
+  int32_t *targets[] = {&frame->xres, &frame->yres, &frame->fourCC,
+                        &frame->lineStride, &frame->formatType};
+  for (size_t i = 0; i < 5; i++) {
+    status = readInt32Property(env, value, names[i], targets[i], error);
+    PASS_STATUS;
+    if (!error->empty())
+      return napi_ok;
+  }
+  if (frame->xres <= 0 || frame->yres <= 0) {
+    *error = "xres and yres must be positive.";
+    return napi_ok;
+  }
+  if (frame->lineStride < 0) {
+    *error = "lineStrideBytes must be >= 0.";
+    return napi_ok;
+  }
+
+  NDIlib_FourCC_video_type_e fourCC = (NDIlib_FourCC_video_type_e)frame->fourCC;
+  int minStride = defaultLineStride(fourCC, frame->xres);
+  if (frame->lineStride == 0)
+    frame->lineStride = minStride;
+  if (!describeFrame(fourCC, frame->lineStride, (size_t)frame->yres,
+                     &frame->layout)) {
+    *error = "fourCC is not supported for field operations.";
+    return napi_ok;
+  }
+  if (frame->lineStride < minStride) {
+    *error = "lineStrideBytes is too small for the given fourCC/xres.";
+    return napi_ok;
+  }
+
+  napi_value data;
+  bool isBuffer;
+  status = napi_get_named_property(env, value, "data", &data);
+  PASS_STATUS;
+  status = napi_is_buffer(env, data, &isBuffer);
+  PASS_STATUS;
+  if (!isBuffer) {
+    *error = "data must be provided as a Node Buffer";
+    return napi_ok;
+  }
+  void *bytes;
+  status = napi_get_buffer_info(env, data, &bytes, &frame->length);
+  PASS_STATUS;
+  frame->data = (const uint8_t *)bytes;
+  if (frame->length < frame->layout.size)
+    *error = "Video frame data buffer is smaller than required for the given "
+             "frame layout.";
+  return napi_ok;
+}
+
+napi_status setInt32(napi_env env, napi_value object, const char *name,
+                     int32_t value) {
+  napi_status status;
+  napi_value param;
+  status = napi_create_int32(env, value, &param);
+  PASS_STATUS;
+  return napi_set_named_property(env, object, name, param);
+}
+
+// Builds a frame object from `source` with a new layout and pixel data.
+napi_status createFieldObject(napi_env env, napi_value source,
+                              const fieldFrame &frame, int32_t yres,
+                              NDIlib_frame_format_type_e formatType,
+                              ownedBuffer *buffer, napi_value *result) {
+  napi_status status;
+  status = napi_create_object(env, result);
+  PASS_STATUS;
+  for (const char *name : kCarriedProperties) {
+    napi_value value;
+    napi_valuetype type;
+    status = napi_get_named_property(env, source, name, &value);
+    PASS_STATUS;
+    status = napi_typeof(env, value, &type);
+    PASS_STATUS;
+    if (type == napi_undefined)
+      continue;
+    status = napi_set_named_property(env, *result, name, value);
+    PASS_STATUS;
+  }
+  status = setInt32(env, *result, "xres", frame.xres);
+  PASS_STATUS;
+  status = setInt32(env, *result, "yres", yres);
+  PASS_STATUS;
+  status = setInt32(env, *result, "fourCC", frame.fourCC);
+  PASS_STATUS;
+  status = setInt32(env, *result, "frameFormatType", formatType);
+  PASS_STATUS;
+  status = setInt32(env, *result, "lineStrideBytes", frame.lineStride);
+  PASS_STATUS;
+  napi_value data;
+  status = createExternalBuffer(env, buffer, &data);
+  PASS_STATUS;
+  return napi_set_named_property(env, *result, "data", data);
+}
+} // namespace
+
+bool describeFrame(NDIlib_FourCC_video_type_e fourCC, int lineStride,
+                   size_t lines, frameLayout *layout) {
+  if (lineStride <= 0 || lines == 0)
+    return false;
+  size_t stride = (size_t)lineStride;
+  switch (fourCC) {
+  case NDIlib_FourCC_type_UYVY:
+  case NDIlib_FourCC_type_BGRA:
+  case NDIlib_FourCC_type_BGRX:
+  case NDIlib_FourCC_type_RGBA:
+  case NDIlib_FourCC_type_RGBX:
+    layout->planes = 1;
+    layout->stride[0] = stride;
+    break;
+  case NDIlib_FourCC_type_UYVA:
+    layout->planes = 2;
+    layout->stride[0] = stride;
+    layout->stride[1] = stride / 2;
+    break;
+  case NDIlib_FourCC_type_P216:
+    layout->planes = 2;
+    layout->words = true;
+    layout->stride[0] = layout->stride[1] = stride;
+    break;
+  case NDIlib_FourCC_type_PA16:
+    layout->planes = 3;
+    layout->words = true;
+    layout->stride[0] = layout->stride[1] = layout->stride[2] = stride;
+    break;
+  default:
+    return false;
+  }
+  size_t offset = 0;
+  for (int plane = 0; plane < layout->planes; plane++) {
+    layout->offset[plane] = offset;
+    offset += layout->stride[plane] * lines;
+  }
+  layout->size = offset;
+  return true;
+}
+
+int defaultLineStride(NDIlib_FourCC_video_type_e fourCC, int xres) {
+  switch (fourCC) {
+  case NDIlib_FourCC_type_UYVY:
+  case NDIlib_FourCC_type_UYVA:
+  case NDIlib_FourCC_type_P216:
+  case NDIlib_FourCC_type_PA16:
+    return xres * 2;
+  case NDIlib_FourCC_type_BGRA:
+  case NDIlib_FourCC_type_BGRX:
+  case NDIlib_FourCC_type_RGBA:
+  case NDIlib_FourCC_type_RGBX:
+    return xres * 4;
+  default:
+    return 0;
+  }
+}
+
+bool fieldViewable(NDIlib_FourCC_video_type_e fourCC) {
+  // The UYVA alpha plane is half as wide as the stride the SDK derives from
+  // line_stride_in_bytes, so its field lines are not where a doubled stride
+  // puts them.
+  return fourCC != NDIlib_FourCC_type_UYVA &&
+         defaultLineStride(fourCC, 2) != 0;
+}
+
+void splitField(uint8_t *dst, const frameLayout &field, const uint8_t *src,
+                const frameLayout &frame, int parity, size_t fieldLines) {
+  for (int plane = 0; plane < field.planes; plane++) {
+    const uint8_t *in =
+        src + frame.offset[plane] + (size_t)parity * frame.stride[plane];
+    uint8_t *out = dst + field.offset[plane];
+    for (size_t i = 0; i < fieldLines; i++) {
+      memcpy(out, in, field.stride[plane]);
+      in += frame.stride[plane] * 2;
+      out += field.stride[plane];
+    }
+  }
+}
+
+void weaveField(uint8_t *dst, const frameLayout &frame, const uint8_t *src,
+                const frameLayout &field, int parity, size_t fieldLines) {
+  for (int plane = 0; plane < field.planes; plane++) {
+    const uint8_t *in = src + field.offset[plane];
+    uint8_t *out =
+        dst + frame.offset[plane] + (size_t)parity * frame.stride[plane];
+    for (size_t i = 0; i < fieldLines; i++) {
+      memcpy(out, in, field.stride[plane]);
+      in += field.stride[plane];
+      out += frame.stride[plane] * 2;
+    }
+  }
+}
+
+napi_value splitFields(napi_env env, napi_callback_info info) {
+  napi_status status;
+
+  size_t argc = 1;
+  napi_value args[1];
+  status = napi_get_cb_info(env, info, &argc, args, nullptr, nullptr);
+  CHECK_STATUS;
+  if (argc < 1)
+    NAPI_THROW_ERROR("frame not provided");
+
+  fieldFrame frame;
+  std::string error;
+  status = readFieldFrame(env, args[0], &frame, &error);
+  CHECK_STATUS;
+  if (!error.empty())
+    NAPI_THROW_ERROR(error.c_str());
+  if (frame.formatType != NDIlib_frame_format_type_progressive &&
+      frame.formatType != NDIlib_frame_format_type_interleaved)
+    NAPI_THROW_ERROR("Only progressive or interlaced frames can be split.");
+  if (frame.yres % 2 != 0)
+    NAPI_THROW_ERROR("yres must be even to split fields.");
+
+  size_t fieldLines = (size_t)frame.yres / 2;
+  frameLayout field;
+  describeFrame((NDIlib_FourCC_video_type_e)frame.fourCC, frame.lineStride,
+                fieldLines, &field);
+
+  napi_value result;
+  status = napi_create_array_with_length(env, 2, &result);
+  CHECK_STATUS;
+  for (int parity = 0; parity < 2; parity++) {
+    ownedBuffer buffer;
+    if (!buffer.allocate(field.size))
+      NAPI_THROW_ERROR("Failed to allocate field buffer.");
+    splitField((uint8_t *)buffer.data, field, frame.data, frame.layout, parity,
+               fieldLines);
+    napi_value item;
+    status = createFieldObject(env, args[0], frame, (int32_t)fieldLines,
+                               parity == 0 ? NDIlib_frame_format_type_field_0
+                                           : NDIlib_frame_format_type_field_1,
+                               &buffer, &item);
+    CHECK_STATUS;
+    status = napi_set_element(env, result, (uint32_t)parity, item);
+    CHECK_STATUS;
+  }
+  return result;
+}
+
+napi_value weaveFields(napi_env env, napi_callback_info info) {
+  napi_status status;
+
+  size_t argc = 2;
+  napi_value args[2];
+  status = napi_get_cb_info(env, info, &argc, args, nullptr, nullptr);
+  CHECK_STATUS;
+  if (argc < 2)
+    NAPI_THROW_ERROR("Both fields must be provided.");
+
+  fieldFrame fields[2];
+  std::string error;
+  for (int parity = 0; parity < 2; parity++) {
+    status = readFieldFrame(env, args[parity], &fields[parity], &error);
+    CHECK_STATUS;
+    if (!error.empty())
+      NAPI_THROW_ERROR(error.c_str());
+  }
+  if (fields[0].xres != fields[1].xres || fields[0].yres != fields[1].yres ||
+      fields[0].fourCC != fields[1].fourCC ||
+      fields[0].lineStride != fields[1].lineStride)
+    NAPI_THROW_ERROR("Fields must share xres, yres, fourCC, and stride.");
+
+  size_t fieldLines = (size_t)fields[0].yres;
+  frameLayout frame;
+  describeFrame((NDIlib_FourCC_video_type_e)fields[0].fourCC,
+                fields[0].lineStride, fieldLines * 2, &frame);
+  ownedBuffer buffer;
+  if (!buffer.allocate(frame.size))
+    NAPI_THROW_ERROR("Failed to allocate frame buffer.");
+  for (int parity = 0; parity < 2; parity++)
+    weaveField((uint8_t *)buffer.data, frame, fields[parity].data,
+               fields[parity].layout, parity, fieldLines);
+
+  napi_value result;
+  status = createFieldObject(env, args[0], fields[0],
+                             (int32_t)(fieldLines * 2),
+                             NDIlib_frame_format_type_interleaved, &buffer,
+                             &result);
+  CHECK_STATUS;
+  return result;
+}
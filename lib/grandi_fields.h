@@ -0,0 +1,55 @@
+/* Copyright 2025 Sarhan Aissi <github@tux.tn>.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+*/
+
+#ifndef GRANDI_FIELDS_H
+#define GRANDI_FIELDS_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include <Processing.NDI.Lib.h>
+
+#include "node_api.h"
+
+// Byte layout of a frame or of a single field: plane offsets and the stride
+// of one line in each plane. Only formats whose planes all have one line per
+// picture line are described; 4:2:0 chroma lines span both fields.
+struct frameLayout {
+  int planes = 0;
+  size_t offset[3] = {};
+  size_t stride[3] = {};
+  bool words = false;
+  size_t size = 0;
+};
+
+bool describeFrame(NDIlib_FourCC_video_type_e fourCC, int lineStride,
+                   size_t lines, frameLayout *layout);
+// Stride the SDK assumes when lineStrideBytes is 0, or 0 when unknown.
+int defaultLineStride(NDIlib_FourCC_video_type_e fourCC, int xres);
+// True when every line of one field sits at a fixed distance in every plane,
+// so the SDK can read a field in place with a doubled stride.
+bool fieldViewable(NDIlib_FourCC_video_type_e fourCC);
+
+// Copies field `parity` of a frame laid out as `frame` into a buffer laid
+// out as `field`, or back again with weaveField.
+void splitField(uint8_t *dst, const frameLayout &field, const uint8_t *src,
+                const frameLayout &frame, int parity, size_t fieldLines);
+void weaveField(uint8_t *dst, const frameLayout &frame, const uint8_t *src,
+                const frameLayout &field, int parity, size_t fieldLines);
+
+napi_value splitFields(napi_env env, napi_callback_info info);
+napi_value weaveFields(napi_env env, napi_callback_info info);
+
+#endif /* GRANDI_FIELDS_H */
@@ -0,0 +1,209 @@
+/* Copyright 2025 Sarhan Aissi <github@tux.tn>.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+*/
+
+#include <cstring>
+
+#include "grandi_framerate.h"
+#include "grandi_simd.h"
+
+namespace {
+// NDI timestamps are in 100ns ticks.
+const int64_t kTicksPerSecond = 10000000;
+// A timestamp this far from the output clock restarts it, e.g. after the
+// source restarts or the receiver reconnects.
+const int64_t kResyncTicks = kTicksPerSecond;
+
+int64_t steadyTicks(std::chrono::steady_clock::time_point time) {
+  return std::chrono::duration_cast<
+             std::chrono::duration<int64_t, std::ratio<1, kTicksPerSecond>>>(
+             time.time_since_epoch())
+      .count();
+}
+
+bool sameLayout(const NDIlib_video_frame_v2_t &a,
+                const NDIlib_video_frame_v2_t &b) {
+  return a.p_data != nullptr && b.p_data != nullptr && a.xres == b.xres &&
+         a.yres == b.yres && a.FourCC == b.FourCC &&
+         a.line_stride_in_bytes == b.line_stride_in_bytes;
+}
+
+bool wordSamples(NDIlib_FourCC_video_type_e fourCC) {
+  return fourCC == NDIlib_FourCC_type_P216 || fourCC == NDIlib_FourCC_type_PA16;
+}
+
+napi_status setDouble(napi_env env, napi_value object, const char *name,
+                      double value) {
+  napi_status status;
+  napi_value param;
+  status = napi_create_double(env, value, &param);
+  PASS_STATUS;
+  return napi_set_named_property(env, object, name, param);
+}
+} // namespace
+
+frameRateConverter::frameRateConverter(const frameRateOptions &options)
+    : options(options) {}
+
+int64_t frameRateConverter::nextTick() const {
+  return tickBase + tickIndex * kTicksPerSecond * options.frameRateD /
+                        options.frameRateN;
+}
+
+void frameRateConverter::advanceTick() {
+  // Every frameRateN ticks span exactly frameRateD seconds, so rebase there
+  // to keep the products small without accumulating rounding error.
+  if (++tickIndex == options.frameRateN) {
+    tickBase += kTicksPerSecond * options.frameRateD;
+    tickIndex = 0;
+  }
+}
+
+void frameRateConverter::push(const NDIlib_video_frame_v2_t &frame,
+                              std::chrono::steady_clock::time_point arrival) {
+  pending = frame;
+  pendingValid = true;
+  pendingEmitted = false;
+  pendingTime = frame.timestamp != NDIlib_recv_timestamp_undefined
+                    ? frame.timestamp
+                    : steadyTicks(arrival);
+  if (frame.frame_rate_N > 0 && frame.frame_rate_D > 0)
+    pendingPeriod =
+        kTicksPerSecond * frame.frame_rate_D / frame.frame_rate_N;
+  else if (lastInputValid && pendingTime > lastInputTime)
+    pendingPeriod = pendingTime - lastInputTime;
+  else
+    pendingPeriod =
+        kTicksPerSecond * options.frameRateD / options.frameRateN;
+  lastInputValid = true;
+  lastInputTime = pendingTime;
+  inputFrames++;
+}
+
+frameRateStep frameRateConverter::step(NDIlib_recv_instance_t recv,
+                                       ownedBuffer *buffer,
+                                       NDIlib_video_frame_v2_t *output,
+                                       std::string *metadata) {
+  if (!pendingValid)
+    return frameRateStep::needFrame;
+
+  // The pending frame is nearest to every tick in [start, end).
+  int64_t start = pendingTime - pendingPeriod / 2;
+  int64_t end = start + pendingPeriod;
+  if (!started || nextTick() < start - kResyncTicks ||
+      nextTick() > end + kResyncTicks) {
+    started = true;
+    tickBase = pendingTime;
+    tickIndex = 0;
+  }
+
+  int64_t tick = nextTick();
+  if (tick >= end) {
+    if (!pendingEmitted) {
+      droppedFrames++;
+      if (options.blend) {
+        if (blendValid)
+          NDIlib_recv_free_video_v2(recv, &blendFrame);
+        blendFrame = pending;
+        blendValid = true;
+      } else {
+        NDIlib_recv_free_video_v2(recv, &pending);
+      }
+    } else {
+      NDIlib_recv_free_video_v2(recv, &pending);
+    }
+    pendingValid = false;
+    return frameRateStep::needFrame;
+  }
+
+  size_t videoBytes = videoDataSize(pending);
+  if (pending.p_data == nullptr || videoBytes == 0) {
+    NDIlib_recv_free_video_v2(recv, &pending);
+    pendingValid = false;
+    return frameRateStep::emptyFrame;
+  }
+
+  bool blended = false;
+  if (!pendingEmitted && blendValid && sameLayout(blendFrame, pending) &&
+      videoDataSize(blendFrame) == videoBytes) {
+    if (!buffer->allocate(videoBytes))
+      return frameRateStep::allocationFailure;
+    if (wordSamples(pending.FourCC))
+      averageWords((uint16_t *)buffer->data, (const uint16_t *)pending.p_data,
+                   (const uint16_t *)blendFrame.p_data, videoBytes / 2);
+    else
+      averageBytes((uint8_t *)buffer->data, pending.p_data, blendFrame.p_data,
+                   videoBytes);
+    blended = true;
+  } else if (!buffer->copyFrom(pending.p_data, videoBytes)) {
+    return frameRateStep::allocationFailure;
+  }
+  if (blendValid) {
+    NDIlib_recv_free_video_v2(recv, &blendFrame);
+    blendValid = false;
+  }
+
+  if (blended)
+    blendedFrames++;
+  if (pendingEmitted)
+    duplicatedFrames++;
+  outputFrames++;
+
+  *output = pending;
+  output->p_data = nullptr;
+  output->p_metadata = nullptr;
+  output->frame_rate_N = options.frameRateN;
+  output->frame_rate_D = options.frameRateD;
+  if (pending.timestamp != NDIlib_recv_timestamp_undefined)
+    output->timestamp = tick;
+  if (pending.p_metadata != nullptr)
+    metadata->assign(pending.p_metadata);
+  else
+    metadata->clear();
+
+  pendingEmitted = true;
+  advanceTick();
+  if (nextTick() >= end) {
+    NDIlib_recv_free_video_v2(recv, &pending);
+    pendingValid = false;
+  }
+  return frameRateStep::emitted;
+}
+
+void frameRateConverter::release(NDIlib_recv_instance_t recv) {
+  if (pendingValid)
+    NDIlib_recv_free_video_v2(recv, &pending);
+  if (blendValid)
+    NDIlib_recv_free_video_v2(recv, &blendFrame);
+  pendingValid = false;
+  blendValid = false;
+}
+
+napi_status frameRateConverter::report(napi_env env, napi_value *result) {
+  napi_status status;
+  status = napi_create_object(env, result);
+  PASS_STATUS;
+  status = setDouble(env, *result, "inputFrames", (double)inputFrames.load());
+  PASS_STATUS;
+  status = setDouble(env, *result, "outputFrames", (double)outputFrames.load());
+  PASS_STATUS;
+  status =
+      setDouble(env, *result, "droppedFrames", (double)droppedFrames.load());
+  PASS_STATUS;
+  status = setDouble(env, *result, "duplicatedFrames",
+                     (double)duplicatedFrames.load());
+  PASS_STATUS;
+  return setDouble(env, *result, "blendedFrames",
+                   (double)blendedFrames.load());
+}
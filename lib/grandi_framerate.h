@@ -0,0 +1,95 @@
+/* Copyright 2025 Sarhan Aissi <github@tux.tn>.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+*/
+
+#ifndef GRANDI_FRAMERATE_H
+#define GRANDI_FRAMERATE_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+#include <Processing.NDI.Lib.h>
+
+#include "grandi_util.h"
+
+struct frameRateOptions {
+  int32_t frameRateN = 30000;
+  int32_t frameRateD = 1001;
+  bool blend = false;
+};
+
+enum class frameRateStep {
+  needFrame,
+  emitted,
+  emptyFrame,
+  allocationFailure,
+};
+
+// Converts a receiver's video to a fixed output rate. Each output tick takes
+// the input frame whose timestamp is nearest, so frames no tick lands on are
+// released without being copied and frames several ticks land on are
+// repeated. In blend mode the last skipped frame is averaged into the next
+// output. SDK frames are held between calls; callers hold `mutex` around
+// push and step.
+struct frameRateConverter {
+  explicit frameRateConverter(const frameRateOptions &options);
+  std::mutex mutex;
+
+  bool hasPending() const { return pendingValid; }
+  // Takes ownership of a captured SDK frame.
+  void push(const NDIlib_video_frame_v2_t &frame,
+            std::chrono::steady_clock::time_point arrival);
+  // Emits the next output frame into buffer and output, or asks for more
+  // input. output.p_data and output.p_metadata are left null; metadata
+  // receives a copy of the frame metadata.
+  frameRateStep step(NDIlib_recv_instance_t recv, ownedBuffer *buffer,
+                     NDIlib_video_frame_v2_t *output, std::string *metadata);
+  // Frees any SDK frames still held. Must run before the receiver is
+  // destroyed.
+  void release(NDIlib_recv_instance_t recv);
+  napi_status report(napi_env env, napi_value *result);
+
+private:
+  int64_t nextTick() const;
+  void advanceTick();
+
+  frameRateOptions options;
+  bool started = false;
+  int64_t tickBase = 0;
+  int64_t tickIndex = 0;
+
+  bool pendingValid = false;
+  bool pendingEmitted = false;
+  NDIlib_video_frame_v2_t pending{};
+  int64_t pendingTime = 0;
+  int64_t pendingPeriod = 0;
+  bool lastInputValid = false;
+  int64_t lastInputTime = 0;
+
+  bool blendValid = false;
+  NDIlib_video_frame_v2_t blendFrame{};
+
+  // Read by report() without the mutex, which a capture may hold while it
+  // waits for input.
+  std::atomic<uint64_t> inputFrames{0};
+  std::atomic<uint64_t> outputFrames{0};
+  std::atomic<uint64_t> droppedFrames{0};
+  std::atomic<uint64_t> duplicatedFrames{0};
+  std::atomic<uint64_t> blendedFrames{0};
+};
+
+#endif /* GRANDI_FRAMERATE_H */
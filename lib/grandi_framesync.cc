@@ -14,15 +14,20 @@
 */
 
 #include <cstddef>
+#include <memory>
 #include <mutex>
+#include <string>
 
 #include <Processing.NDI.Lib.h>
 #include <Processing.NDI.FrameSync.h>
 
+#include "grandi_budget.h"
+#include "grandi_deinterlace.h"
 #include "grandi_framesync.h"
+#include "grandi_transfer.h"
+#include "grandi_receive.h"
 #include "grandi_util.h"
 
-namespace {
 struct framesyncWrapper {
   napi_env env = nullptr;
   NDIlib_framesync_instance_t fs = nullptr;
@@ -32,12 +37,16 @@ struct framesyncWrapper {
   bool finalized = false;
   uint32_t active = 0;
   std::mutex mutex;
+  std::unique_ptr<deinterlacer> deinterlace;
 };
 
+namespace {
 struct framesyncCarrier : carrier {
   nativeHandle *recvHandle = nullptr;
   NDIlib_recv_instance_t recv = nullptr;
   NDIlib_framesync_instance_t fs = nullptr;
+  bool deinterlace = false;
+  deinterlaceOptions deinterlaceConfig;
   ~framesyncCarrier() {
     if (recvHandle != nullptr)
       releaseNativeCaptureBinding(recvHandle);
@@ -50,6 +59,9 @@ struct framesyncVideoCarrier : carrier {
   ownedBuffer buffer;
   NDIlib_frame_format_type_e fieldType = NDIlib_frame_format_type_progressive;
   bool noVideo = false;
+  // Set when videoFrame describes a deinterlaced copy.
+  bool videoReleased = false;
+  std::string videoMetadata;
   ~framesyncVideoCarrier();
 };
 
@@ -166,14 +178,16 @@ framesyncAudioCarrier::~framesyncAudioCarrier() {
 struct FrameSyncVideoGuard {
   framesyncWrapper *wrapper = nullptr;
   NDIlib_video_frame_v2_t frame{};
+  bool released = false;
 
   explicit FrameSyncVideoGuard(framesyncVideoCarrier *c)
-      : wrapper(c->wrapper), frame(c->videoFrame) {
+      : wrapper(c->wrapper), frame(c->videoFrame), released(c->videoReleased) {
     c->wrapper = nullptr;
   }
 
   ~FrameSyncVideoGuard() {
-    NDIlib_framesync_free_video(wrapper->fs, &frame);
+    if (!released)
+      NDIlib_framesync_free_video(wrapper->fs, &frame);
     releaseFrameSyncWrapper(wrapper);
   }
 };
@@ -260,6 +274,78 @@ done:
   return result;
 }
 
+// Frees a wrapper parked by detach() that no environment adopted.
+void destroyDetachedFrameSync(void *value) {
+  framesyncWrapper *wrapper = (framesyncWrapper *)value;
+  closeFrameSyncWrapper(nullptr, wrapper);
+  delete wrapper;
+}
+
+// Moves the SDK framesync, its receiver binding, and its deinterlacer into a
+// new wrapper for adopt(), leaving this object destroyed. The receiver
+// reference is dropped here, on the thread that owns it; the binding keeps
+// the native receiver alive.
+napi_value detachFrameSync(napi_env env, napi_callback_info info) {
+  napi_status status;
+  size_t argc = 0;
+  napi_value thisValue;
+  status = napi_get_cb_info(env, info, &argc, nullptr, &thisValue, nullptr);
+  CHECK_STATUS;
+
+  napi_value fsValue;
+  status = napi_get_named_property(env, thisValue, "embedded", &fsValue);
+  CHECK_STATUS;
+  napi_valuetype type;
+  status = napi_typeof(env, fsValue, &type);
+  CHECK_STATUS;
+  if (type != napi_external)
+    NAPI_THROW_ERROR("FrameSync has been destroyed.");
+  void *externalData;
+  status = napi_get_value_external(env, fsValue, &externalData);
+  CHECK_STATUS;
+  framesyncWrapper *wrapper = (framesyncWrapper *)externalData;
+
+  framesyncWrapper *detached = new (std::nothrow) framesyncWrapper;
+  if (detached == nullptr)
+    NAPI_THROW_ERROR("Failed to allocate FrameSync state.");
+  const char *error = nullptr;
+  napi_ref receiverRef = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(wrapper->mutex);
+    if (wrapper->closing || wrapper->fs == nullptr) {
+      error = "FrameSync has been destroyed.";
+    } else if (wrapper->active != 0) {
+      error = "FrameSync has operations in flight.";
+    } else {
+      detached->fs = wrapper->fs;
+      detached->recvHandle = wrapper->recvHandle;
+      detached->deinterlace = std::move(wrapper->deinterlace);
+      receiverRef = wrapper->receiverRef;
+      wrapper->fs = nullptr;
+      wrapper->recvHandle = nullptr;
+      wrapper->receiverRef = nullptr;
+      wrapper->closing = true;
+    }
+  }
+  if (error != nullptr) {
+    delete detached;
+    NAPI_THROW_ERROR(error);
+  }
+  if (receiverRef != nullptr)
+    napi_delete_reference(env, receiverRef);
+
+  napi_value zero;
+  status = napi_create_int32(env, 0, &zero);
+  if (status == napi_ok)
+    status = napi_set_named_property(env, thisValue, "embedded", zero);
+  if (status != napi_ok) {
+    destroyDetachedFrameSync(detached);
+    CHECK_STATUS;
+  }
+  return parkDetached(env, detachedKind::framesync, detached,
+                      destroyDetachedFrameSync);
+}
+
 napi_value audioQueueDepth(napi_env env, napi_callback_info info) {
   napi_status status;
 
@@ -342,6 +428,84 @@ void framesyncExecute(napi_env env, void *data) {
 napi_value framesyncVideo(napi_env env, napi_callback_info info);
 napi_value framesyncAudio(napi_env env, napi_callback_info info);
 
+// Sets up the FrameSync object around embedded.
+napi_status fillFrameSyncObject(napi_env env, napi_value embedded,
+                                napi_value *result) {
+  napi_status status;
+  napi_value object;
+  status = napi_create_object(env, &object);
+  PASS_STATUS;
+  status = napi_set_named_property(env, object, "embedded", embedded);
+  PASS_STATUS;
+
+  napi_value destroyFn;
+  status = napi_create_function(env, "destroy", NAPI_AUTO_LENGTH,
+                                destroyFrameSync, nullptr, &destroyFn);
+  PASS_STATUS;
+  status = napi_set_named_property(env, object, "destroy", destroyFn);
+  PASS_STATUS;
+
+  napi_value detachFn;
+  status = napi_create_function(env, "detach", NAPI_AUTO_LENGTH,
+                                detachFrameSync, nullptr, &detachFn);
+  PASS_STATUS;
+  status = napi_set_named_property(env, object, "detach", detachFn);
+  PASS_STATUS;
+
+  napi_value videoFn;
+  status = napi_create_function(env, "video", NAPI_AUTO_LENGTH, framesyncVideo,
+                                nullptr, &videoFn);
+  PASS_STATUS;
+  status = napi_set_named_property(env, object, "video", videoFn);
+  PASS_STATUS;
+
+  napi_value audioFn;
+  status = napi_create_function(env, "audio", NAPI_AUTO_LENGTH, framesyncAudio,
+                                nullptr, &audioFn);
+  PASS_STATUS;
+  status = napi_set_named_property(env, object, "audio", audioFn);
+  PASS_STATUS;
+
+  napi_value audioFormatFn;
+  status = napi_create_function(env, "audioFormat", NAPI_AUTO_LENGTH,
+                                audioFormat, nullptr, &audioFormatFn);
+  PASS_STATUS;
+  status = napi_set_named_property(env, object, "audioFormat", audioFormatFn);
+  PASS_STATUS;
+
+  napi_value audioQueueDepthFn;
+  status = napi_create_function(env, "audioQueueDepth", NAPI_AUTO_LENGTH,
+                                audioQueueDepth, nullptr, &audioQueueDepthFn);
+  PASS_STATUS;
+  status = napi_set_named_property(env, object, "audioQueueDepth",
+                                   audioQueueDepthFn);
+  PASS_STATUS;
+  *result = object;
+  return napi_ok;
+}
+
+} // namespace
+
+napi_status makeFrameSyncObject(napi_env env, framesyncWrapper *wrapper,
+                                napi_value *result) {
+  napi_status status;
+  wrapper->env = env;
+  napi_value embedded;
+  status =
+      napi_create_external(env, wrapper, finalizeFrameSync, nullptr, &embedded);
+  if (status != napi_ok) {
+    closeFrameSyncWrapper(env, wrapper);
+    delete wrapper;
+    return status;
+  }
+  status = fillFrameSyncObject(env, embedded, result);
+  // embedded owns the wrapper now and frees it once collected.
+  if (status != napi_ok)
+    closeFrameSyncWrapper(env, wrapper);
+  return status;
+}
+
+namespace {
 void framesyncComplete(napi_env env, napi_status asyncStatus, void *data) {
   framesyncCarrier *c = (framesyncCarrier *)data;
 
@@ -351,11 +515,15 @@ void framesyncComplete(napi_env env, napi_status asyncStatus, void *data) {
   }
   REJECT_STATUS;
 
-  napi_value result;
-  c->status = napi_create_object(env, &result);
-  REJECT_STATUS;
-
   framesyncWrapper *wrapper = new (std::nothrow) framesyncWrapper;
+  if (wrapper != nullptr && c->deinterlace) {
+    wrapper->deinterlace.reset(new (std::nothrow)
+                                   deinterlacer(c->deinterlaceConfig));
+    if (!wrapper->deinterlace) {
+      delete wrapper;
+      wrapper = nullptr;
+    }
+  }
   if (wrapper == nullptr) {
     NDIlib_framesync_destroy(c->fs);
     c->fs = nullptr;
@@ -363,59 +531,14 @@ void framesyncComplete(napi_env env, napi_status asyncStatus, void *data) {
     c->errorMsg = "Failed to allocate FrameSync state.";
     REJECT_STATUS;
   }
-  wrapper->env = env;
   wrapper->fs = c->fs;
   wrapper->receiverRef = c->passthru;
   wrapper->recvHandle = c->recvHandle;
   c->passthru = nullptr;
   c->recvHandle = nullptr;
 
-  napi_value embedded;
-  c->status =
-      napi_create_external(env, wrapper, finalizeFrameSync, nullptr, &embedded);
-  if (c->status != napi_ok) {
-    closeFrameSyncWrapper(env, wrapper);
-    delete wrapper;
-    REJECT_STATUS;
-  }
-  c->status = napi_set_named_property(env, result, "embedded", embedded);
-  REJECT_STATUS;
-
-  napi_value destroyFn;
-  c->status = napi_create_function(env, "destroy", NAPI_AUTO_LENGTH,
-                                   destroyFrameSync, nullptr, &destroyFn);
-  REJECT_STATUS;
-  c->status = napi_set_named_property(env, result, "destroy", destroyFn);
-  REJECT_STATUS;
-
-  napi_value videoFn;
-  c->status = napi_create_function(env, "video", NAPI_AUTO_LENGTH,
-                                   framesyncVideo, nullptr, &videoFn);
-  REJECT_STATUS;
-  c->status = napi_set_named_property(env, result, "video", videoFn);
-  REJECT_STATUS;
-
-  napi_value audioFn;
-  c->status = napi_create_function(env, "audio", NAPI_AUTO_LENGTH,
-                                   framesyncAudio, nullptr, &audioFn);
-  REJECT_STATUS;
-  c->status = napi_set_named_property(env, result, "audio", audioFn);
-  REJECT_STATUS;
-  napi_value audioFormatFn;
-  c->status = napi_create_function(env, "audioFormat", NAPI_AUTO_LENGTH,
-                                   audioFormat, nullptr, &audioFormatFn);
-  REJECT_STATUS;
-  c->status =
-      napi_set_named_property(env, result, "audioFormat", audioFormatFn);
-  REJECT_STATUS;
-
-  napi_value audioQueueDepthFn;
-  c->status =
-      napi_create_function(env, "audioQueueDepth", NAPI_AUTO_LENGTH,
-                           audioQueueDepth, nullptr, &audioQueueDepthFn);
-  REJECT_STATUS;
-  c->status = napi_set_named_property(env, result, "audioQueueDepth",
-                                      audioQueueDepthFn);
+  napi_value result;
+  c->status = makeFrameSyncObject(env, wrapper, &result);
   REJECT_STATUS;
 
   napi_status status = napi_resolve_deferred(env, c->_deferred, result);
@@ -432,6 +555,39 @@ void framesyncVideoExecute(napi_env env, void *data) {
     c->noVideo = true;
     return;
   }
+  // A frame over the frame budget reads as no video yet. The reservation is
+  // released on return, once the copy is counted by the frame allocator.
+  budgetReservation reservation;
+  if (admitFrameBytes(videoDataSize(c->videoFrame), false, &reservation) ==
+      budgetDecision::drop) {
+    NDIlib_framesync_free_video(c->wrapper->fs, &c->videoFrame);
+    c->videoFrame = NDIlib_video_frame_v2_t{};
+    c->noVideo = true;
+    return;
+  }
+  if (c->wrapper->deinterlace) {
+    deinterlacer *converter = c->wrapper->deinterlace.get();
+    std::lock_guard<std::mutex> lock(converter->mutex);
+    NDIlib_video_frame_v2_t output{};
+    deinterlaceResult result = converter->convertField(
+        c->videoFrame, c->fieldType == NDIlib_frame_format_type_field_1 ? 1 : 0,
+        &c->buffer, &output);
+    if (result != deinterlaceResult::passthrough) {
+      if (c->videoFrame.p_metadata != nullptr)
+        c->videoMetadata = c->videoFrame.p_metadata;
+      NDIlib_framesync_free_video(c->wrapper->fs, &c->videoFrame);
+      c->videoFrame = output;
+      c->videoReleased = true;
+      if (result == deinterlaceResult::allocationFailure) {
+        c->errorMsg = "Failed to allocate FrameSync video buffer.";
+        c->status = GRANDI_ALLOCATION_FAILURE;
+        return;
+      }
+      if (!c->videoMetadata.empty())
+        c->videoFrame.p_metadata = c->videoMetadata.c_str();
+      return;
+    }
+  }
   size_t videoBytes = videoDataSize(c->videoFrame);
   if (videoBytes == 0 ||
       !c->buffer.copyFrom(c->videoFrame.p_data, videoBytes)) {
@@ -786,14 +942,41 @@ napi_value framesync(napi_env env, napi_callback_info info) {
   c->status = napi_create_promise(env, &c->_deferred, &promise);
   REJECT_RETURN;
 
-  size_t argc = 1;
-  napi_value args[1];
+  size_t argc = 2;
+  napi_value args[2];
   c->status = napi_get_cb_info(env, info, &argc, args, nullptr, nullptr);
   REJECT_RETURN;
 
   if (argc < 1)
     REJECT_ERROR_RETURN("Receiver must be provided.", GRANDI_INVALID_ARGS);
 
+  if (argc >= 2) {
+    c->status = napi_typeof(env, args[1], &type);
+    REJECT_RETURN;
+    if (type != napi_undefined) {
+      bool isArray;
+      c->status = napi_is_array(env, args[1], &isArray);
+      REJECT_RETURN;
+      if (type != napi_object || isArray)
+        REJECT_ERROR_RETURN("FrameSync options must be an object.",
+                            GRANDI_INVALID_ARGS);
+      napi_value deinterlace;
+      c->status =
+          napi_get_named_property(env, args[1], "deinterlace", &deinterlace);
+      REJECT_RETURN;
+      c->status = napi_typeof(env, deinterlace, &type);
+      REJECT_RETURN;
+      if (type != napi_undefined) {
+        c->deinterlace = true;
+        c->status = parseDeinterlaceOptions(
+            env, deinterlace, &c->deinterlaceConfig, &c->errorMsg);
+        REJECT_RETURN;
+        if (!c->errorMsg.empty())
+          REJECT_ERROR_RETURN(c->errorMsg, GRANDI_INVALID_ARGS);
+      }
+    }
+  }
+
   napi_value receiver = args[0];
   c->status = napi_typeof(env, receiver, &type);
   REJECT_RETURN;
@@ -824,7 +1007,7 @@ napi_value framesync(napi_env env, napi_callback_info info) {
     REJECT_ERROR_RETURN(message, GRANDI_INVALID_ARGS);
   }
   c->recvHandle = recvHandle;
-  c->recv = (NDIlib_recv_instance_t)recvData;
+  c->recv = ((receiveInstance *)recvData)->recv;
 
   napi_ref receiverRef;
   c->status = napi_create_reference(env, receiver, 1, &receiverRef);
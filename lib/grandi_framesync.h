@@ -20,4 +20,12 @@
 
 napi_value framesync(napi_env env, napi_callback_info info);
 
+// FrameSync state behind the object's "embedded" external.
+struct framesyncWrapper;
+// Builds the FrameSync object around wrapper, for framesync() and adopt().
+// On failure the SDK framesync is destroyed, and wrapper is freed now or when
+// its external is collected.
+napi_status makeFrameSyncObject(napi_env env, framesyncWrapper *wrapper,
+                                napi_value *result);
+
 #endif /* GRANDI_FRAMESYNC_H */
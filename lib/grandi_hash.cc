@@ -0,0 +1,354 @@
+/* Copyright 2025 Sarhan Aissi <github@tux.tn>.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+*/
+
+#include <cstdio>
+#include <string>
+
+#include "grandi_hash.h"
+#include "grandi_util.h"
+
+// xxHash is header-only here; this is the one translation unit that
+// instantiates it, with every symbol kept static.
+#define XXH_INLINE_ALL
+#include "xxhash.h"
+
+namespace {
+// Lines of a sampled hash are this many lines apart in each plane.
+const size_t kSampledLineStep = 16;
+
+// One plane of a frame: `lines` lines of `bytes` visible bytes, `stride`
+// bytes apart from `offset`.
+struct hashPlane {
+  size_t offset = 0;
+  size_t stride = 0;
+  size_t lines = 0;
+  size_t bytes = 0;
+};
+
+// Describes the planes of a frame the way videoDataSize lays them out.
+// Returns the number of planes, or 0 for unknown formats.
+int describeHashPlanes(const NDIlib_video_frame_v2_t &frame,
+                       hashPlane planes[3]) {
+  if (frame.xres <= 0 || frame.yres <= 0)
+    return 0;
+  size_t xres = (size_t)frame.xres, yres = (size_t)frame.yres;
+  size_t stride = frame.line_stride_in_bytes > 0
+                      ? (size_t)frame.line_stride_in_bytes
+                      : 0;
+  auto plane = [](size_t offset, size_t stride, size_t lines, size_t bytes) {
+    hashPlane result;
+    result.offset = offset;
+    result.stride = stride;
+    result.lines = lines;
+    result.bytes = bytes;
+    return result;
+  };
+
+  switch (frame.FourCC) {
+  case NDIlib_FourCC_type_UYVY:
+    stride = stride ? stride : xres * 2;
+    planes[0] = plane(0, stride, yres, xres * 2);
+    return 1;
+  case NDIlib_FourCC_type_UYVA:
+    stride = stride ? stride : xres * 2;
+    planes[0] = plane(0, stride, yres, xres * 2);
+    planes[1] = plane(stride * yres, stride / 2, yres, xres);
+    return 2;
+  case NDIlib_FourCC_type_P216:
+  case NDIlib_FourCC_type_PA16: {
+    stride = stride ? stride : xres * 2;
+    int count = frame.FourCC == NDIlib_FourCC_type_PA16 ? 3 : 2;
+    for (int i = 0; i < count; i++)
+      planes[i] = plane(stride * yres * i, stride, yres, xres * 2);
+    return count;
+  }
+  case NDIlib_FourCC_type_NV12:
+    stride = stride ? stride : xres;
+    planes[0] = plane(0, stride, yres, xres);
+    planes[1] = plane(stride * yres, stride, yres / 2, xres);
+    return 2;
+  case NDIlib_FourCC_type_I420:
+  case NDIlib_FourCC_type_YV12:
+    stride = stride ? stride : xres;
+    planes[0] = plane(0, stride, yres, xres);
+    planes[1] = plane(stride * yres, stride / 2, yres / 2, xres / 2);
+    planes[2] = plane(stride * yres + (stride / 2) * (yres / 2), stride / 2,
+                      yres / 2, xres / 2);
+    return 3;
+  case NDIlib_FourCC_type_BGRA:
+  case NDIlib_FourCC_type_BGRX:
+  case NDIlib_FourCC_type_RGBA:
+  case NDIlib_FourCC_type_RGBX:
+    stride = stride ? stride : xres * 4;
+    planes[0] = plane(0, stride, yres, xres * 4);
+    return 1;
+  default:
+    return 0;
+  }
+}
+
+// Bytes from the start of the frame to the end of its last visible byte.
+size_t hashExtent(const hashPlane *planes, int count) {
+  size_t extent = 0;
+  for (int i = 0; i < count; i++) {
+    if (planes[i].lines == 0)
+      continue;
+    size_t end = planes[i].offset + (planes[i].lines - 1) * planes[i].stride +
+                 planes[i].bytes;
+    if (end > extent)
+      extent = end;
+  }
+  return extent;
+}
+
+// Hashes planes whose lines are packed with one call, and others line by
+// line, so padding never reaches the hash.
+bool hashPlanes(const uint8_t *data, const hashPlane *planes, int count,
+                frameHashAlgorithm algorithm, frameHash *hash) {
+  bool sampled = algorithm == frameHashAlgorithm::sampled;
+  XXH3_state_t state;
+  XXH_errorcode reset =
+      sampled ? XXH3_64bits_reset(&state) : XXH3_128bits_reset(&state);
+  if (reset == XXH_ERROR)
+    return false;
+  auto update = [&](const uint8_t *bytes, size_t length) {
+    if (sampled)
+      XXH3_64bits_update(&state, bytes, length);
+    else
+      XXH3_128bits_update(&state, bytes, length);
+  };
+  size_t step = sampled ? kSampledLineStep : 1;
+  for (int i = 0; i < count; i++) {
+    const hashPlane &plane = planes[i];
+    const uint8_t *start = data + plane.offset;
+    if (!sampled && plane.stride == plane.bytes) {
+      update(start, plane.bytes * plane.lines);
+      continue;
+    }
+    for (size_t line = 0; line < plane.lines; line += step)
+      update(start + line * plane.stride, plane.bytes);
+  }
+  if (sampled) {
+    hash->high = 0;
+    hash->low = XXH3_64bits_digest(&state);
+  } else {
+    XXH128_hash_t digest = XXH3_128bits_digest(&state);
+    hash->high = digest.high64;
+    hash->low = digest.low64;
+  }
+  return true;
+}
+
+napi_status readInt32Property(napi_env env, napi_value object,
+                              const char *name, int32_t *result,
+                              std::string *error) {
+  napi_status status;
+  napi_value value;
+  status = napi_get_named_property(env, object, name, &value);
+  PASS_STATUS;
+  napi_valuetype type;
+  status = napi_typeof(env, value, &type);
+  PASS_STATUS;
+  if (type != napi_number) {
+    *error = std::string(name) + " value must be a number";
+    return napi_ok;
+  }
+  return napi_get_value_int32(env, value, result);
+}
+} // namespace
+
+bool parseFrameHashAlgorithm(const std::string &name,
+                             frameHashAlgorithm *algorithm) {
+  if (name == "xxh3")
+    *algorithm = frameHashAlgorithm::xxh3;
+  else if (name == "sampled")
+    *algorithm = frameHashAlgorithm::sampled;
+  else
+    return false;
+  return true;
+}
+
+napi_status parseFrameHashOptions(napi_env env, napi_value value,
+                                  bool *enabled, frameHashOptions *options,
+                                  std::string *error) {
+  error->clear();
+  *enabled = false;
+  *options = frameHashOptions();
+  napi_valuetype type;
+  napi_status status = napi_typeof(env, value, &type);
+  if (status != napi_ok || type == napi_undefined)
+    return status;
+
+  napi_value algorithm = value;
+  if (type == napi_object) {
+    bool isArray;
+    status = napi_is_array(env, value, &isArray);
+    if (status != napi_ok)
+      return status;
+    if (isArray) {
+      *error = "hash must be an algorithm name or an object.";
+      return napi_ok;
+    }
+    status = napi_get_named_property(env, value, "algorithm", &algorithm);
+    if (status != napi_ok)
+      return status;
+
+    napi_value skip;
+    status = napi_get_named_property(env, value, "skipDuplicates", &skip);
+    if (status != napi_ok)
+      return status;
+    status = napi_typeof(env, skip, &type);
+    if (status != napi_ok)
+      return status;
+    if (type == napi_boolean) {
+      status = napi_get_value_bool(env, skip, &options->skipDuplicates);
+      if (status != napi_ok)
+        return status;
+    } else if (type != napi_undefined) {
+      *error = "hash.skipDuplicates must be a Boolean.";
+      return napi_ok;
+    }
+    status = napi_typeof(env, algorithm, &type);
+    if (status != napi_ok)
+      return status;
+    if (type == napi_undefined) {
+      *enabled = true;
+      return napi_ok;
+    }
+  }
+
+  if (type != napi_string) {
+    *error = "hash must be an algorithm name or an object.";
+    return napi_ok;
+  }
+  char name[16];
+  size_t length = 0;
+  status = napi_get_value_string_utf8(env, algorithm, name, sizeof(name),
+                                      &length);
+  if (status != napi_ok)
+    return status;
+  if (!parseFrameHashAlgorithm(std::string(name, length),
+                               &options->algorithm)) {
+    *error = "hash algorithm must be \"xxh3\" or \"sampled\".";
+    return napi_ok;
+  }
+  *enabled = true;
+  return napi_ok;
+}
+
+bool hashVideoFrame(const NDIlib_video_frame_v2_t &frame,
+                    frameHashAlgorithm algorithm, frameHash *hash) {
+  hashPlane planes[3];
+  int count = describeHashPlanes(frame, planes);
+  if (count == 0 || frame.p_data == nullptr)
+    return false;
+  return hashPlanes(frame.p_data, planes, count, algorithm, hash);
+}
+
+size_t formatFrameHash(const frameHash &hash, frameHashAlgorithm algorithm,
+                       char text[kFrameHashLength + 1]) {
+  if (algorithm == frameHashAlgorithm::sampled)
+    return (size_t)snprintf(text, kFrameHashLength + 1, "%016llx",
+                            (unsigned long long)hash.low);
+  return (size_t)snprintf(text, kFrameHashLength + 1, "%016llx%016llx",
+                          (unsigned long long)hash.high,
+                          (unsigned long long)hash.low);
+}
+
+napi_value hashFrame(napi_env env, napi_callback_info info) {
+  napi_status status;
+  napi_valuetype type;
+
+  size_t argc = 2;
+  napi_value args[2];
+  status = napi_get_cb_info(env, info, &argc, args, nullptr, nullptr);
+  CHECK_STATUS;
+  if (argc < 1)
+    NAPI_THROW_ERROR("frame not provided");
+
+  bool isArray;
+  status = napi_typeof(env, args[0], &type);
+  CHECK_STATUS;
+  status = napi_is_array(env, args[0], &isArray);
+  CHECK_STATUS;
+  if (type != napi_object || isArray)
+    NAPI_THROW_ERROR("frame must be an object");
+
+  NDIlib_video_frame_v2_t frame{};
+  int32_t fourCC = 0;
+  const char *names[] = {"xres", "yres", "fourCC", "lineStrideBytes"};
+  int32_t *targets[] = {&frame.xres, &frame.yres, &fourCC,
+                        &frame.line_stride_in_bytes};
+  std::string error;
+  for (size_t i = 0; i < 4; i++) {
+    status = readInt32Property(env, args[0], names[i], targets[i], &error);
+    CHECK_STATUS;
+    if (!error.empty())
+      NAPI_THROW_ERROR(error.c_str());
+  }
+  frame.FourCC = (NDIlib_FourCC_video_type_e)fourCC;
+  if (frame.xres <= 0 || frame.yres <= 0)
+    NAPI_THROW_ERROR("xres and yres must be positive.");
+  if (frame.line_stride_in_bytes < 0)
+    NAPI_THROW_ERROR("lineStrideBytes must be >= 0.");
+
+  frameHashAlgorithm algorithm = frameHashAlgorithm::xxh3;
+  if (argc >= 2) {
+    status = napi_typeof(env, args[1], &type);
+    CHECK_STATUS;
+    if (type != napi_undefined) {
+      char name[16];
+      size_t length = 0;
+      if (type == napi_string) {
+        status = napi_get_value_string_utf8(env, args[1], name, sizeof(name),
+                                            &length);
+        CHECK_STATUS;
+      }
+      if (type != napi_string ||
+          !parseFrameHashAlgorithm(std::string(name, length), &algorithm))
+        NAPI_THROW_ERROR("algorithm must be \"xxh3\" or \"sampled\".");
+    }
+  }
+
+  hashPlane planes[3];
+  int count = describeHashPlanes(frame, planes);
+  if (count == 0)
+    NAPI_THROW_ERROR("fourCC is not supported for frame hashing.");
+
+  napi_value data;
+  bool isBuffer;
+  status = napi_get_named_property(env, args[0], "data", &data);
+  CHECK_STATUS;
+  status = napi_is_buffer(env, data, &isBuffer);
+  CHECK_STATUS;
+  if (!isBuffer)
+    NAPI_THROW_ERROR("data must be provided as a Node Buffer");
+  void *bytes;
+  size_t length;
+  status = napi_get_buffer_info(env, data, &bytes, &length);
+  CHECK_STATUS;
+  if (length < hashExtent(planes, count))
+    NAPI_THROW_ERROR("Video frame data buffer is smaller than its layout.");
+
+  frameHash hash;
+  if (!hashPlanes((const uint8_t *)bytes, planes, count, algorithm, &hash))
+    NAPI_THROW_ERROR("Failed to hash frame.");
+  char text[kFrameHashLength + 1];
+  size_t textLength = formatFrameHash(hash, algorithm, text);
+  napi_value result;
+  status = napi_create_string_utf8(env, text, textLength, &result);
+  CHECK_STATUS;
+  return result;
+}
@@ -0,0 +1,69 @@
+/* Copyright 2025 Sarhan Aissi <github@tux.tn>.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+*/
+
+#ifndef GRANDI_HASH_H
+#define GRANDI_HASH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include <Processing.NDI.Lib.h>
+
+#include "node_api.h"
+
+napi_value hashFrame(napi_env env, napi_callback_info info);
+
+// xxh3 hashes every visible byte into 128 bits. sampled hashes every 16th
+// line of each plane into 64 bits, so changes between sampled lines are
+// missed.
+enum class frameHashAlgorithm { xxh3, sampled };
+
+struct frameHash {
+  uint64_t high = 0;
+  uint64_t low = 0;
+  bool operator==(const frameHash &other) const {
+    return high == other.high && low == other.low;
+  }
+};
+
+struct frameHashOptions {
+  frameHashAlgorithm algorithm = frameHashAlgorithm::xxh3;
+  // Frees frames whose hash equals the previous frame's instead of returning
+  // them.
+  bool skipDuplicates = false;
+};
+
+// Parses an algorithm name. Returns false for anything else.
+bool parseFrameHashAlgorithm(const std::string &name,
+                             frameHashAlgorithm *algorithm);
+// Parses a hash option: undefined to disable, an algorithm name, or an
+// object. Invalid values set error and return napi_ok, like parseUint32Value.
+napi_status parseFrameHashOptions(napi_env env, napi_value value,
+                                  bool *enabled, frameHashOptions *options,
+                                  std::string *error);
+
+// Hashes the visible bytes of every plane, skipping stride padding, so equal
+// pictures hash equally whatever their strides. Returns false for formats
+// without a known layout.
+bool hashVideoFrame(const NDIlib_video_frame_v2_t &frame,
+                    frameHashAlgorithm algorithm, frameHash *hash);
+
+// Lowercase hex: 32 digits for xxh3 and 16 for sampled. Returns the length.
+const size_t kFrameHashLength = 32;
+size_t formatFrameHash(const frameHash &hash, frameHashAlgorithm algorithm,
+                       char text[kFrameHashLength + 1]);
+
+#endif /* GRANDI_HASH_H */
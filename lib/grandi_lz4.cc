@@ -0,0 +1,188 @@
+/* Copyright 2025 Sarhan Aissi <github@tux.tn>.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+*/
+
+#include <cstring>
+
+#include "grandi_lz4.h"
+
+namespace {
+const size_t kMinMatch = 4;
+// The last match starts at least 12 bytes before the end, and the last 5
+// bytes are always literals.
+const size_t kMatchStartLimit = 12;
+const size_t kLastLiterals = 5;
+const size_t kMaxOffset = 65535;
+const int kHashBits = 12;
+// Searching speeds up by one byte per step after this many misses, as
+// liblz4 does, so incompressible data costs little.
+const int kSkipTrigger = 6;
+
+uint32_t read32(const uint8_t *p) {
+  uint32_t value;
+  memcpy(&value, p, sizeof(value));
+  return value;
+}
+
+uint64_t read64(const uint8_t *p) {
+  uint64_t value;
+  memcpy(&value, p, sizeof(value));
+  return value;
+}
+
+// Hashes the 5 bytes at p, which spreads typical video better than 4 bytes.
+// At least 8 bytes must be readable.
+uint32_t hash(const uint8_t *p) {
+  return (uint32_t)(((read64(p) << 24) * 889523592379ull) >> (64 - kHashBits));
+}
+
+uint8_t *putLength(uint8_t *out, size_t length) {
+  for (; length >= 255; length -= 255)
+    *out++ = 255;
+  *out++ = (uint8_t)length;
+  return out;
+}
+
+uint8_t *putLiterals(uint8_t *out, uint8_t *token, const uint8_t *literals,
+                     size_t length) {
+  if (length >= 15) {
+    *token = 15 << 4;
+    out = putLength(out, length - 15);
+  } else {
+    *token = (uint8_t)(length << 4);
+  }
+  if (length > 0)
+    memcpy(out, literals, length);
+  return out + length;
+}
+} // namespace
+
+size_t lz4Bound(size_t size) { return size + size / 255 + 16; }
+
+size_t lz4Compress(const uint8_t *source, size_t size, uint8_t *destination,
+                   uint32_t *table) {
+  const uint8_t *anchor = source;
+  uint8_t *out = destination;
+  if (size >= kMatchStartLimit + 1) {
+    const uint8_t *in = source + 1;
+    const uint8_t *startLimit = source + size - kMatchStartLimit;
+    const uint8_t *matchLimit = source + size - kLastLiterals;
+    memset(table, 0, kLz4TableEntries * sizeof(uint32_t));
+    while (true) {
+      // Find a match of at least 4 bytes within the window.
+      const uint8_t *match = nullptr;
+      uint32_t misses = 1u << kSkipTrigger;
+      while (in <= startLimit) {
+        uint32_t slot = hash(in);
+        const uint8_t *candidate = source + table[slot];
+        table[slot] = (uint32_t)(in - source);
+        if (candidate < in && (size_t)(in - candidate) <= kMaxOffset &&
+            read32(candidate) == read32(in)) {
+          match = candidate;
+          break;
+        }
+        in += misses++ >> kSkipTrigger;
+      }
+      if (match == nullptr)
+        break;
+
+      while (in > anchor && match > source && in[-1] == match[-1]) {
+        in--;
+        match--;
+      }
+      size_t length = kMinMatch;
+      while (in + length < matchLimit && in[length] == match[length])
+        length++;
+
+      uint8_t *token = out++;
+      out = putLiterals(out, token, anchor, (size_t)(in - anchor));
+      size_t offset = (size_t)(in - match);
+      *out++ = (uint8_t)offset;
+      *out++ = (uint8_t)(offset >> 8);
+      if (length - kMinMatch >= 15) {
+        *token |= 15;
+        out = putLength(out, length - kMinMatch - 15);
+      } else {
+        *token |= (uint8_t)(length - kMinMatch);
+      }
+      in += length;
+      anchor = in;
+      if (in > startLimit)
+        break;
+      table[hash(in - 2)] = (uint32_t)(in - 2 - source);
+    }
+  }
+  uint8_t *token = out++;
+  out = putLiterals(out, token, anchor, (size_t)(source + size - anchor));
+  return (size_t)(out - destination);
+}
+
+bool lz4Decompress(const uint8_t *source, size_t sourceSize,
+                   uint8_t *destination, size_t size) {
+  const uint8_t *in = source;
+  const uint8_t *inEnd = source + sourceSize;
+  uint8_t *out = destination;
+  uint8_t *outEnd = destination + size;
+  while (in < inEnd) {
+    uint8_t token = *in++;
+    size_t literals = token >> 4;
+    if (literals == 15) {
+      uint8_t byte;
+      do {
+        if (in >= inEnd)
+          return false;
+        byte = *in++;
+        literals += byte;
+      } while (byte == 255);
+    }
+    if (literals > (size_t)(inEnd - in) || literals > (size_t)(outEnd - out))
+      return false;
+    memcpy(out, in, literals);
+    in += literals;
+    out += literals;
+    // The last sequence has literals only.
+    if (in == inEnd)
+      return out == outEnd;
+
+    if (inEnd - in < 2)
+      return false;
+    size_t offset = in[0] | (size_t)in[1] << 8;
+    in += 2;
+    if (offset == 0 || offset > (size_t)(out - destination))
+      return false;
+    size_t length = token & 15;
+    if (length == 15) {
+      uint8_t byte;
+      do {
+        if (in >= inEnd)
+          return false;
+        byte = *in++;
+        length += byte;
+      } while (byte == 255);
+    }
+    length += kMinMatch;
+    if (length > (size_t)(outEnd - out))
+      return false;
+    const uint8_t *match = out - offset;
+    if (offset >= length) {
+      memcpy(out, match, length);
+      out += length;
+    } else {
+      // Overlapping copies repeat the last offset bytes.
+      for (size_t i = 0; i < length; i++)
+        *out++ = *match++;
+    }
+  }
+  return false;
+}
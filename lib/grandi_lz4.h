@@ -0,0 +1,41 @@
+/* Copyright 2025 Sarhan Aissi <github@tux.tn>.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+*/
+
+#ifndef GRANDI_LZ4_H
+#define GRANDI_LZ4_H
+
+#include <cstddef>
+#include <cstdint>
+
+// LZ4 block format, as described in lz4_Block_format.md of the LZ4 project.
+// Blocks carry no header, so any LZ4 decoder reads them given the
+// decompressed size, such as LZ4_decompress_safe() of liblz4.
+
+// Entries of the match table lz4Compress() works with.
+const size_t kLz4TableEntries = 4096;
+
+// Largest compressed size of size bytes.
+size_t lz4Bound(size_t size);
+// Compresses size bytes of source into destination, which holds at least
+// lz4Bound(size) bytes, and returns the compressed size. table holds
+// kLz4TableEntries entries and is overwritten, so each thread needs its own.
+size_t lz4Compress(const uint8_t *source, size_t size, uint8_t *destination,
+                   uint32_t *table);
+// Decompresses a block into exactly size bytes. Returns false when source
+// is malformed or does not decode to size bytes.
+bool lz4Decompress(const uint8_t *source, size_t sourceSize,
+                   uint8_t *destination, size_t size);
+
+#endif /* GRANDI_LZ4_H */
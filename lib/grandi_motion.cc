@@ -0,0 +1,371 @@
+/* Copyright 2025 Sarhan Aissi <github@tux.tn>.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+#include "grandi_motion.h"
+#include "grandi_draw.h"
+#include "grandi_fields.h"
+#include "grandi_pool.h"
+#include "grandi_simd.h"
+
+namespace {
+const int kMaxGrid = 64;
+const int kMaxScale = 16;
+const double kMaxSmoothing = 0.99;
+// Source bytes per stripe below which downsampling stays on fewer threads.
+const size_t kMinStripeBytes = 256 * 1024;
+
+napi_status readInteger(napi_env env, napi_value object, const char *name,
+                        int minimum, int maximum, int *result,
+                        std::string *error) {
+  napi_value value;
+  napi_status status = napi_get_named_property(env, object, name, &value);
+  if (status != napi_ok)
+    return status;
+  napi_valuetype type;
+  status = napi_typeof(env, value, &type);
+  if (status != napi_ok || type == napi_undefined)
+    return status;
+  std::string label = std::string("motion.") + name;
+  uint32_t parsed = 0;
+  status = parseUint32Value(env, value, label.c_str(), &parsed, error);
+  if (status != napi_ok)
+    return status;
+  if (!error->empty() || parsed < (uint32_t)minimum ||
+      parsed > (uint32_t)maximum) {
+    *error = label + " must be an integer between " + std::to_string(minimum) +
+             " and " + std::to_string(maximum) + ".";
+    return napi_ok;
+  }
+  *result = (int)parsed;
+  return napi_ok;
+}
+
+napi_status readFraction(napi_env env, napi_value object, const char *name,
+                         double maximum, const char *range, double *result,
+                         std::string *error) {
+  napi_value value;
+  napi_status status = napi_get_named_property(env, object, name, &value);
+  if (status != napi_ok)
+    return status;
+  napi_valuetype type;
+  status = napi_typeof(env, value, &type);
+  if (status != napi_ok || type == napi_undefined)
+    return status;
+  double parsed = NAN;
+  if (type == napi_number) {
+    status = napi_get_value_double(env, value, &parsed);
+    if (status != napi_ok)
+      return status;
+  }
+  if (!(parsed >= 0.0 && parsed <= maximum)) {
+    *error = std::string("motion.") + name + " must be a number between " +
+             range + ".";
+    return napi_ok;
+  }
+  *result = parsed;
+  return napi_ok;
+}
+
+// Luma sits in every other byte of UYVY and UYVA, and P216 and PA16 keep
+// the top 8 bits of each little-endian sample in the odd bytes too.
+enum lumaLayout { oddBytes, bytes, rgb };
+
+struct lumaSource {
+  const uint8_t *data = nullptr;
+  int64_t stride = 0;
+  lumaLayout layout = oddBytes;
+  // Byte offsets of red and blue in 32-bit pixels.
+  int red = 2;
+  int blue = 0;
+};
+
+bool describeLuma(const NDIlib_video_frame_v2_t &frame, lumaSource *source) {
+  int64_t stride = frame.line_stride_in_bytes;
+  if (stride == 0)
+    stride = defaultLineStride(frame.FourCC, frame.xres);
+  if (stride == 0)
+    stride = frame.xres;
+  source->data = frame.p_data;
+  source->stride = stride;
+  switch (frame.FourCC) {
+  case NDIlib_FourCC_type_UYVY:
+  case NDIlib_FourCC_type_UYVA:
+  case NDIlib_FourCC_type_P216:
+  case NDIlib_FourCC_type_PA16:
+    source->layout = oddBytes;
+    return true;
+  case NDIlib_FourCC_type_NV12:
+  case NDIlib_FourCC_type_I420:
+  case NDIlib_FourCC_type_YV12:
+    source->layout = bytes;
+    return true;
+  case NDIlib_FourCC_type_BGRA:
+  case NDIlib_FourCC_type_BGRX:
+  case NDIlib_FourCC_type_RGBA:
+  case NDIlib_FourCC_type_RGBX: {
+    source->layout = rgb;
+    bool bgr = frame.FourCC == NDIlib_FourCC_type_BGRA ||
+               frame.FourCC == NDIlib_FourCC_type_BGRX;
+    source->red = bgr ? 2 : 0;
+    source->blue = bgr ? 0 : 2;
+    return true;
+  }
+  default:
+    return false;
+  }
+}
+
+// Adds the luma of each run of scale pixels on one line to its block sum.
+// Templated on the layout so the per-pixel switch folds away.
+template <lumaLayout layout>
+void sumLine(const lumaSource &source, const uint8_t *row, int width,
+             int scale, uint32_t *sums) {
+  for (int i = 0, x = 0; i < width; i++) {
+    uint32_t sum = 0;
+    for (int k = 0; k < scale; k++, x++) {
+      switch (layout) {
+      case oddBytes:
+        sum += row[x * 2 + 1];
+        break;
+      case bytes:
+        sum += row[x];
+        break;
+      case rgb: {
+        const uint8_t *pixel = row + x * 4;
+        sum += lumaFromRgb(pixel[source.red], pixel[1], pixel[source.blue]);
+        break;
+      }
+      }
+    }
+    sums[i] += sum;
+  }
+}
+
+struct downsampleJob {
+  const lumaSource *source;
+  int width;
+  int scale;
+  uint32_t *sums;
+  uint8_t *plane;
+};
+
+// Averages scale x scale blocks of luma into rows begin to end of a plane
+// width blocks wide. Each stripe sums into its own row of sums.
+template <lumaLayout layout>
+void downsample(void *context, size_t stripe, size_t begin, size_t end) {
+  const downsampleJob &job = *(const downsampleJob *)context;
+  const lumaSource &source = *job.source;
+  int width = job.width;
+  int scale = job.scale;
+  uint32_t *sums = job.sums + stripe * width;
+  uint8_t *plane = job.plane;
+  uint32_t area = (uint32_t)(scale * scale);
+  for (int y = (int)begin; y < (int)end; y++) {
+    memset(sums, 0, (size_t)width * sizeof(uint32_t));
+    for (int k = 0; k < scale; k++)
+      sumLine<layout>(source, source.data + source.stride * (y * scale + k),
+                      width, scale, sums);
+    uint8_t *out = plane + (size_t)y * width;
+    for (int i = 0; i < width; i++)
+      out[i] = (uint8_t)((sums[i] + area / 2) / area);
+  }
+}
+} // namespace
+
+napi_status parseMotionOptions(napi_env env, napi_value value, bool *enabled,
+                               motionOptions *options, std::string *error) {
+  error->clear();
+  *enabled = false;
+  *options = motionOptions();
+  napi_valuetype type;
+  napi_status status = napi_typeof(env, value, &type);
+  if (status != napi_ok || type == napi_undefined)
+    return status;
+  if (type == napi_boolean)
+    return napi_get_value_bool(env, value, enabled);
+  bool isArray = false;
+  if (type == napi_object) {
+    status = napi_is_array(env, value, &isArray);
+    if (status != napi_ok)
+      return status;
+  }
+  if (type != napi_object || isArray) {
+    *error = "motion must be a Boolean or an object.";
+    return napi_ok;
+  }
+  *enabled = true;
+
+  const char *grid[3] = {"columns", "rows", "scale"};
+  int *targets[3] = {&options->columns, &options->rows, &options->scale};
+  int maximums[3] = {kMaxGrid, kMaxGrid, kMaxScale};
+  for (int i = 0; i < 3; i++) {
+    status =
+        readInteger(env, value, grid[i], 1, maximums[i], targets[i], error);
+    if (status != napi_ok || !error->empty())
+      return status;
+  }
+  status = readFraction(env, value, "smoothing", kMaxSmoothing, "0 and 0.99",
+                        &options->smoothing, error);
+  if (status != napi_ok || !error->empty())
+    return status;
+  return readFraction(env, value, "threshold", 1.0, "0 and 1",
+                      &options->threshold, error);
+}
+
+motionDetector::motionDetector(const motionOptions &options)
+    : options(options) {}
+
+bool motionDetector::analyze(const NDIlib_video_frame_v2_t &frame,
+                             motionResult *result) {
+  int cells = options.columns * options.rows;
+  result->columns = options.columns;
+  result->rows = options.rows;
+  result->scores.assign(cells, 0.0f);
+  result->active.clear();
+  result->peak = 0.0f;
+  result->reference = true;
+
+  lumaSource source;
+  int scale = options.scale;
+  int w = frame.xres / scale;
+  int h = frame.yres / scale;
+  if (frame.p_data == nullptr || w <= 0 || h <= 0 ||
+      !describeLuma(frame, &source)) {
+    primed = false;
+    return true;
+  }
+  size_t planeSize = (size_t)w * h;
+  if (w != width || h != height) {
+    primed = false;
+    width = 0;
+    height = 0;
+    if (!planes.allocate(planeSize * 2))
+      return false;
+    width = w;
+    height = h;
+  }
+
+  workerPool &pool = sharedPool();
+  size_t bandBytes = std::max<size_t>((size_t)std::abs(source.stride), 1) *
+                     (size_t)scale;
+  size_t stripes = stripeCount(
+      pool, (size_t)h, std::max<size_t>(kMinStripeBytes / bandBytes, 1));
+  size_t sumBytes = stripes * w * sizeof(uint32_t);
+  if (sums.size < sumBytes && !sums.allocate(sumBytes))
+    return false;
+
+  uint8_t *previous = (uint8_t *)planes.data + planeSize * previousPlane;
+  uint8_t *current = (uint8_t *)planes.data + planeSize * (1 - previousPlane);
+  downsampleJob job = {&source, w, scale, (uint32_t *)sums.data, current};
+  stripeFunction fn = downsample<oddBytes>;
+  if (source.layout == bytes)
+    fn = downsample<bytes>;
+  else if (source.layout == rgb)
+    fn = downsample<rgb>;
+  runStripes(pool, (size_t)h, stripes, fn, &job);
+  previousPlane = 1 - previousPlane;
+  if (!primed) {
+    primed = true;
+    smoothed.assign(cells, 0.0f);
+    return true;
+  }
+
+  float keep = (float)options.smoothing;
+  float threshold = (float)options.threshold;
+  for (int row = 0; row < options.rows; row++) {
+    int top = row * h / options.rows;
+    int bottom = (row + 1) * h / options.rows;
+    for (int column = 0; column < options.columns; column++) {
+      int left = column * w / options.columns;
+      int right = (column + 1) * w / options.columns;
+      uint64_t total = 0;
+      for (int y = top; y < bottom; y++) {
+        size_t offset = (size_t)y * w + left;
+        total += absoluteDifferenceBytes(current + offset, previous + offset,
+                                         right - left);
+      }
+      size_t area = (size_t)(bottom - top) * (right - left);
+      float raw = area > 0 ? (float)((double)total / (255.0 * area)) : 0.0f;
+      int cell = row * options.columns + column;
+      smoothed[cell] = keep * smoothed[cell] + (1.0f - keep) * raw;
+      float score = smoothed[cell];
+      result->scores[cell] = score;
+      if (score > result->peak)
+        result->peak = score;
+      if (score >= threshold && score > 0.0f)
+        result->active.push_back(cell);
+    }
+  }
+  result->reference = false;
+  return true;
+}
+
+napi_status setMotionProperties(napi_env env, const motionResult &result,
+                                napi_value object) {
+  napi_value param;
+  const char *names[2] = {"columns", "rows"};
+  int values[2] = {result.columns, result.rows};
+  for (int i = 0; i < 2; i++) {
+    napi_status status = napi_create_int32(env, values[i], &param);
+    PASS_STATUS;
+    status = napi_set_named_property(env, object, names[i], param);
+    PASS_STATUS;
+  }
+
+  void *data = nullptr;
+  napi_value arrayBuffer;
+  size_t bytes = result.scores.size() * sizeof(float);
+  napi_status status =
+      napi_create_arraybuffer(env, bytes, &data, &arrayBuffer);
+  PASS_STATUS;
+  if (bytes > 0)
+    memcpy(data, result.scores.data(), bytes);
+  status = napi_create_typedarray(env, napi_float32_array,
+                                  result.scores.size(), arrayBuffer, 0,
+                                  &param);
+  PASS_STATUS;
+  status = napi_set_named_property(env, object, "scores", param);
+  PASS_STATUS;
+
+  status = napi_create_double(env, result.peak, &param);
+  PASS_STATUS;
+  status = napi_set_named_property(env, object, "peak", param);
+  PASS_STATUS;
+
+  napi_value active;
+  status = napi_create_array_with_length(env, result.active.size(), &active);
+  PASS_STATUS;
+  for (size_t i = 0; i < result.active.size(); i++) {
+    status = napi_create_int32(env, result.active[i], &param);
+    PASS_STATUS;
+    status = napi_set_element(env, active, (uint32_t)i, param);
+    PASS_STATUS;
+  }
+  status = napi_set_named_property(env, object, "active", active);
+  PASS_STATUS;
+
+  status = napi_get_boolean(env, !result.active.empty(), &param);
+  PASS_STATUS;
+  status = napi_set_named_property(env, object, "motion", param);
+  PASS_STATUS;
+  status = napi_get_boolean(env, result.reference, &param);
+  PASS_STATUS;
+  return napi_set_named_property(env, object, "reference", param);
+}
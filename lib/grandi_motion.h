@@ -0,0 +1,87 @@
+/* Copyright 2025 Sarhan Aissi <github@tux.tn>.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+*/
+
+#ifndef GRANDI_MOTION_H
+#define GRANDI_MOTION_H
+
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <Processing.NDI.Lib.h>
+
+#include "node_api.h"
+#include "grandi_util.h"
+
+struct motionOptions {
+  // Grid of cells scored independently, in row-major order.
+  int columns = 8;
+  int rows = 6;
+  // Luma is averaged over scale x scale pixel blocks before differencing,
+  // which cuts both the cost and the compression noise.
+  int scale = 4;
+  // Weight the previous smoothed score keeps, from 0 for none to 0.99.
+  double smoothing = 0.5;
+  // Smoothed score from which a cell counts as active.
+  double threshold = 0.02;
+};
+
+// Parses the motion receive option: undefined to disable, true for the
+// defaults, or an object. Invalid values set error and return napi_ok, like
+// parseUint32Value.
+napi_status parseMotionOptions(napi_env env, napi_value value, bool *enabled,
+                               motionOptions *options, std::string *error);
+
+// Scores of one frame. Scores are the mean absolute luma difference of each
+// cell against the previous frame, from 0 to 1, after smoothing.
+struct motionResult {
+  int columns = 0;
+  int rows = 0;
+  std::vector<float> scores;
+  float peak = 0.0f;
+  // Cells whose score reached the threshold.
+  std::vector<int> active;
+  // Set when there was no earlier frame of the same size to compare with,
+  // so every score is 0.
+  bool reference = false;
+};
+
+// Keeps the downsampled luma of the last frame and the smoothed scores. Any
+// format the SDK delivers is read in place; a size change restarts from a
+// reference frame.
+struct motionDetector {
+  explicit motionDetector(const motionOptions &options);
+  std::mutex mutex;
+
+  // Returns false when a buffer cannot be allocated.
+  bool analyze(const NDIlib_video_frame_v2_t &frame, motionResult *result);
+
+private:
+  motionOptions options;
+  int width = 0;
+  int height = 0;
+  bool primed = false;
+  // Two downsampled luma planes that take turns holding the previous frame.
+  ownedBuffer planes;
+  int previousPlane = 0;
+  ownedBuffer sums;
+  std::vector<float> smoothed;
+};
+
+// Sets columns, rows, scores, peak, active, motion, and reference on object.
+napi_status setMotionProperties(napi_env env, const motionResult &result,
+                                napi_value object);
+
+#endif /* GRANDI_MOTION_H */
@@ -0,0 +1,1039 @@
+/* Copyright 2025 Sarhan Aissi <github@tux.tn>.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <Processing.NDI.Lib.h>
+#include <Processing.NDI.FrameSync.h>
+
+#include "grandi_multiviewer.h"
+#include "grandi_draw.h"
+#include "grandi_pool.h"
+#include "grandi_receive.h"
+#include "grandi_scale.h"
+#include "grandi_thread.h"
+#include "grandi_util.h"
+
+namespace {
+const uint32_t kMaxTiles = 64;
+const uint32_t kMaxThreads = 64;
+const uint32_t kMaxBorder = 64;
+// Tally outlines are drawn at least this wide so they read on small tiles.
+const int kTallyWidth = 4;
+
+struct multiviewerTileStats {
+  bool signal = false;
+  int xres = 0;
+  int yres = 0;
+};
+
+struct multiviewerTile {
+  nativeHandle *recvHandle = nullptr;
+  NDIlib_recv_instance_t recv = nullptr;
+  napi_ref receiverRef = nullptr;
+  NDIlib_framesync_instance_t fs = nullptr;
+  int x = 0;
+  int y = 0;
+  int width = 0;
+  int height = 0;
+
+  // Guarded by the multiviewer mutex.
+  std::string label;
+  bool program = false;
+  bool preview = false;
+  uint64_t labelVersion = 0;
+  multiviewerTileStats stats;
+
+  // Owned by the compose thread. The label is copied only when it changes.
+  std::string drawnLabel;
+  uint64_t drawnLabelVersion = 0;
+  bool drawnProgram = false;
+  bool drawnPreview = false;
+  videoScaler scaler;
+  multiviewerTileStats composed;
+};
+
+struct multiviewerWrapper {
+  napi_env env = nullptr;
+  NDIlib_send_instance_t send = nullptr;
+  std::vector<std::unique_ptr<multiviewerTile>> tiles;
+  NDIlib_FourCC_video_type_e fourCC = NDIlib_FourCC_type_UYVY;
+  int xres = 1920;
+  int yres = 1080;
+  int frameRateN = 30;
+  int frameRateD = 1;
+  int border = 2;
+  uint32_t threads = 0;
+  drawColor background = makeDrawColor(0, 0, 0);
+  drawColor borderColor = makeDrawColor(0x40, 0x40, 0x40);
+  ownedBuffer canvas[2];
+  drawTarget target;
+  threadRole role;
+  workerPool pool;
+  std::thread thread;
+  bool stopping = false;
+  uint64_t framesSent = 0;
+  uint64_t lateFrames = 0;
+  double composeSumMs = 0.0;
+  double composeMaxMs = 0.0;
+  double composeLastMs = 0.0;
+  std::mutex mutex;
+};
+
+struct multiviewerCarrier : carrier {
+  multiviewerWrapper *viewer = nullptr;
+  std::unique_ptr<char[]> name;
+  std::unique_ptr<char[]> groups;
+  ~multiviewerCarrier();
+};
+
+bool yuvCanvas(const multiviewerWrapper *viewer) {
+  return viewer->fourCC == NDIlib_FourCC_type_UYVY;
+}
+
+int canvasLineStride(const multiviewerWrapper *viewer) {
+  return viewer->xres * (yuvCanvas(viewer) ? 2 : 4);
+}
+
+// Fills the part of a rectangle left uncovered by an inner rectangle.
+void fillAround(const drawTarget &target, int x, int y, int width, int height,
+                int innerX, int innerY, int innerWidth, int innerHeight,
+                const drawColor &color) {
+  fillRect(target, x, y, width, innerY - y, color);
+  fillRect(target, x, innerY + innerHeight, width,
+           y + height - innerY - innerHeight, color);
+  fillRect(target, x, innerY, innerX - x, innerHeight, color);
+  fillRect(target, innerX + innerWidth, innerY, x + width - innerX - innerWidth,
+           innerHeight, color);
+}
+
+void drawCentered(const drawTarget &target, int x, int y, int width,
+                  int height, int scale, const char *text,
+                  const drawColor &color) {
+  size_t length = strlen(text);
+  int textX = x + (width - textWidth(length, scale)) / 2;
+  int textY = y + (height - kGlyphSize * scale) / 2;
+  if (textX >= x && textY >= y)
+    drawText(target, textX, textY, scale, text, length, color);
+}
+
+void drawLabel(const drawTarget &target, int x, int y, int width, int height,
+               const std::string &label) {
+  int scale = height >= 360 ? 2 : 1;
+  int padding = 2 * scale;
+  size_t fits = (size_t)std::max(
+      (width - 2 * padding) / textWidth(1, scale), 0);
+  size_t length = std::min(label.size(), fits);
+  if (length == 0)
+    return;
+  int boxWidth = textWidth(length, scale) + 2 * padding;
+  int boxHeight = kGlyphSize * scale + 2 * padding;
+  if (boxHeight > height)
+    return;
+  int boxX = x + (width - boxWidth) / 2;
+  int boxY = y + height - boxHeight - padding;
+  fillRect(target, boxX, boxY, boxWidth, boxHeight, makeDrawColor(0, 0, 0));
+  drawText(target, boxX + padding, boxY + padding, scale, label.data(), length,
+           makeDrawColor(255, 255, 255));
+}
+
+void composeTile(void *context, size_t index) {
+  multiviewerWrapper *viewer = (multiviewerWrapper *)context;
+  multiviewerTile *tile = viewer->tiles[index].get();
+  const drawTarget &target = viewer->target;
+  bool yuv = yuvCanvas(viewer);
+
+  int innerX = tile->x + viewer->border;
+  int innerY = tile->y + viewer->border;
+  int innerWidth = tile->width - 2 * viewer->border;
+  int innerHeight = tile->height - 2 * viewer->border;
+  if (yuv && (innerX & 1)) {
+    innerX++;
+    innerWidth--;
+  }
+  if (yuv)
+    innerWidth &= ~1;
+
+  NDIlib_video_frame_v2_t frame{};
+  NDIlib_framesync_capture_video(tile->fs, &frame,
+                                 NDIlib_frame_format_type_progressive);
+  bool usable = frame.p_data != nullptr && scalable(frame.FourCC) &&
+                frame.xres >= 2 && frame.yres >= 1 &&
+                frame.line_stride_in_bytes > 0;
+  tile->composed.signal = frame.p_data != nullptr;
+  tile->composed.xres = frame.xres;
+  tile->composed.yres = frame.yres;
+
+  bool drawn = false;
+  if (usable && innerWidth > 0 && innerHeight > 0) {
+    double aspect = frame.picture_aspect_ratio > 0.0f
+                        ? frame.picture_aspect_ratio
+                        : (double)frame.xres / frame.yres;
+    int fitWidth = innerWidth;
+    int fitHeight = (int)std::lround(innerWidth / aspect);
+    if (fitHeight > innerHeight) {
+      fitHeight = innerHeight;
+      fitWidth = (int)std::lround(innerHeight * aspect);
+    }
+    int fitX = innerX + (innerWidth - fitWidth) / 2;
+    int fitY = innerY + (innerHeight - fitHeight) / 2;
+    if (yuv) {
+      fitWidth &= ~1;
+      fitX &= ~1;
+    }
+    videoView source;
+    source.data = frame.p_data;
+    source.fourCC = frame.FourCC;
+    source.xres = frame.xres;
+    source.yres = frame.yres;
+    source.lineStride = frame.line_stride_in_bytes;
+    uint8_t *dst = target.data + (size_t)fitY * target.lineStride +
+                   (size_t)fitX * (yuv ? 2 : 4);
+    if (fitWidth > 0 && fitHeight > 0 &&
+        tile->scaler.scale(source, dst, viewer->fourCC, fitWidth, fitHeight,
+                           target.lineStride)) {
+      fillAround(target, innerX, innerY, innerWidth, innerHeight, fitX, fitY,
+                 fitWidth, fitHeight, viewer->background);
+      drawn = true;
+    }
+  }
+  NDIlib_framesync_free_video(tile->fs, &frame);
+
+  if (!drawn) {
+    fillRect(target, innerX, innerY, innerWidth, innerHeight,
+             viewer->background);
+    drawCentered(target, innerX, innerY, innerWidth, innerHeight,
+                 innerHeight >= 360 ? 2 : 1,
+                 !tile->composed.signal ? "NO SIGNAL" : "UNSUPPORTED FORMAT",
+                 makeDrawColor(0x80, 0x80, 0x80));
+  }
+
+  strokeRect(target, tile->x, tile->y, tile->width, tile->height,
+             viewer->border, viewer->borderColor);
+  if (tile->drawnProgram || tile->drawnPreview)
+    strokeRect(target, tile->x, tile->y, tile->width, tile->height,
+               std::max(viewer->border, kTallyWidth),
+               tile->drawnProgram ? makeDrawColor(0xe0, 0, 0)
+                                  : makeDrawColor(0, 0xc0, 0));
+  if (!tile->drawnLabel.empty())
+    drawLabel(target, innerX, innerY, innerWidth, innerHeight,
+              tile->drawnLabel);
+}
+
+void runMultiviewer(multiviewerWrapper *viewer) {
+  threadRegistration registration(viewer->role);
+  int current = 0;
+  double periodMs = 1000.0 * viewer->frameRateD / viewer->frameRateN;
+  while (true) {
+    {
+      std::lock_guard<std::mutex> lock(viewer->mutex);
+      if (viewer->stopping)
+        break;
+      for (auto &tile : viewer->tiles) {
+        if (tile->drawnLabelVersion != tile->labelVersion) {
+          tile->drawnLabel = tile->label;
+          tile->drawnLabelVersion = tile->labelVersion;
+        }
+        tile->drawnProgram = tile->program;
+        tile->drawnPreview = tile->preview;
+      }
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    viewer->target.data = (uint8_t *)viewer->canvas[current].data;
+    viewer->pool.run(viewer->tiles.size(), composeTile, viewer);
+    double composeMs = std::chrono::duration<double, std::milli>(
+                           std::chrono::steady_clock::now() - start)
+                           .count();
+
+    NDIlib_video_frame_v2_t frame{};
+    frame.xres = viewer->xres;
+    frame.yres = viewer->yres;
+    frame.FourCC = viewer->fourCC;
+    frame.frame_rate_N = viewer->frameRateN;
+    frame.frame_rate_D = viewer->frameRateD;
+    frame.picture_aspect_ratio = (float)viewer->xres / viewer->yres;
+    frame.frame_format_type = NDIlib_frame_format_type_progressive;
+    frame.timecode = NDIlib_send_timecode_synthesize;
+    frame.p_data = viewer->target.data;
+    frame.line_stride_in_bytes = viewer->target.lineStride;
+    // The SDK reads the canvas until the next call, while the other canvas is
+    // composed. The sender is clocked, so this call paces the loop.
+    NDIlib_send_send_video_async_v2(viewer->send, &frame);
+    current ^= 1;
+
+    std::lock_guard<std::mutex> lock(viewer->mutex);
+    viewer->framesSent++;
+    if (composeMs > periodMs)
+      viewer->lateFrames++;
+    viewer->composeSumMs += composeMs;
+    viewer->composeMaxMs = std::max(viewer->composeMaxMs, composeMs);
+    viewer->composeLastMs = composeMs;
+    for (auto &tile : viewer->tiles)
+      tile->stats = tile->composed;
+  }
+  NDIlib_send_send_video_async_v2(viewer->send, nullptr);
+}
+
+// Stops the compose thread and releases the sender, frame synchronizers, and
+// receivers. Returns false when the multiviewer had already been stopped.
+bool stopMultiviewer(napi_env env, multiviewerWrapper *viewer) {
+  {
+    std::lock_guard<std::mutex> lock(viewer->mutex);
+    if (viewer->stopping)
+      return false;
+    viewer->stopping = true;
+  }
+  if (viewer->thread.joinable())
+    viewer->thread.join();
+  viewer->pool.stop();
+  for (auto &tile : viewer->tiles) {
+    if (tile->fs != nullptr)
+      NDIlib_framesync_destroy(tile->fs);
+    tile->fs = nullptr;
+    if (tile->recvHandle != nullptr)
+      releaseNativeCaptureBinding(tile->recvHandle);
+    tile->recvHandle = nullptr;
+    tile->recv = nullptr;
+    if (tile->receiverRef != nullptr)
+      napi_delete_reference(env, tile->receiverRef);
+    tile->receiverRef = nullptr;
+  }
+  if (viewer->send != nullptr)
+    NDIlib_send_destroy(viewer->send);
+  viewer->send = nullptr;
+  return true;
+}
+
+void finalizeMultiviewer(napi_env env, void *data, void *hint) {
+  multiviewerWrapper *viewer = (multiviewerWrapper *)data;
+  stopMultiviewer(env, viewer);
+  delete viewer;
+}
+
+multiviewerCarrier::~multiviewerCarrier() {
+  if (viewer != nullptr)
+    finalizeMultiviewer(viewer->env, viewer, nullptr);
+}
+
+bool acquireMultiviewerFromThis(napi_env env, napi_value thisValue,
+                                multiviewerWrapper **viewer) {
+  napi_value viewerValue;
+  if (napi_get_named_property(env, thisValue, "embedded", &viewerValue) !=
+      napi_ok)
+    return false;
+  napi_valuetype type;
+  if (napi_typeof(env, viewerValue, &type) != napi_ok || type != napi_external)
+    return false;
+  void *externalData;
+  if (napi_get_value_external(env, viewerValue, &externalData) != napi_ok)
+    return false;
+  *viewer = (multiviewerWrapper *)externalData;
+  return true;
+}
+
+napi_value destroyMultiviewer(napi_env env, napi_callback_info info) {
+  bool success = false;
+  napi_value thisValue;
+  size_t argc = 0;
+  multiviewerWrapper *viewer = nullptr;
+  if (napi_get_cb_info(env, info, &argc, nullptr, &thisValue, nullptr) ==
+          napi_ok &&
+      acquireMultiviewerFromThis(env, thisValue, &viewer)) {
+    stopMultiviewer(env, viewer);
+    napi_value value;
+    if (napi_create_int32(env, 0, &value) == napi_ok)
+      napi_set_named_property(env, thisValue, "embedded", value);
+    success = true;
+  }
+
+  napi_value result;
+  if (napi_get_boolean(env, success, &result) != napi_ok)
+    napi_get_boolean(env, false, &result);
+  return result;
+}
+
+// Resolves `this` and a tile index argument for the per-tile setters.
+bool acquireTile(napi_env env, napi_value thisValue, napi_value indexValue,
+                 multiviewerWrapper **viewer, multiviewerTile **tile,
+                 std::string *error) {
+  if (!acquireMultiviewerFromThis(env, thisValue, viewer)) {
+    *error = "Multiviewer has been destroyed.";
+    return false;
+  }
+  uint32_t index = 0;
+  if (parseUint32Value(env, indexValue, "index", &index, error) != napi_ok ||
+      !error->empty() || index >= (*viewer)->tiles.size()) {
+    *error = "index must identify a tile.";
+    return false;
+  }
+  *tile = (*viewer)->tiles[index].get();
+  return true;
+}
+
+napi_value multiviewerSetLabel(napi_env env, napi_callback_info info) {
+  napi_status status;
+  size_t argc = 2;
+  napi_value args[2];
+  napi_value thisValue;
+  status = napi_get_cb_info(env, info, &argc, args, &thisValue, nullptr);
+  CHECK_STATUS;
+  if (argc < 2)
+    NAPI_THROW_ERROR("setLabel requires a tile index and a label.");
+
+  multiviewerWrapper *viewer = nullptr;
+  multiviewerTile *tile = nullptr;
+  std::string error;
+  if (!acquireTile(env, thisValue, args[0], &viewer, &tile, &error))
+    NAPI_THROW_ERROR(error.c_str());
+
+  napi_valuetype type;
+  status = napi_typeof(env, args[1], &type);
+  CHECK_STATUS;
+  if (type != napi_string)
+    NAPI_THROW_ERROR("label must be a string.");
+  carrier c;
+  std::unique_ptr<char[]> label;
+  if (!readUtf8String(env, args[1], &label, &c))
+    NAPI_THROW_ERROR(c.errorMsg.c_str());
+
+  {
+    std::lock_guard<std::mutex> lock(viewer->mutex);
+    tile->label = label.get();
+    tile->labelVersion++;
+  }
+  napi_value result;
+  status = napi_get_undefined(env, &result);
+  CHECK_STATUS;
+  return result;
+}
+
+bool readTallyFlag(napi_env env, napi_value state, const char *name,
+                   bool *value) {
+  napi_value flag;
+  if (napi_get_named_property(env, state, name, &flag) != napi_ok)
+    return false;
+  napi_valuetype type;
+  if (napi_typeof(env, flag, &type) != napi_ok)
+    return false;
+  if (type == napi_undefined) {
+    *value = false;
+    return true;
+  }
+  return type == napi_boolean &&
+         napi_get_value_bool(env, flag, value) == napi_ok;
+}
+
+napi_value multiviewerSetTally(napi_env env, napi_callback_info info) {
+  napi_status status;
+  size_t argc = 2;
+  napi_value args[2];
+  napi_value thisValue;
+  status = napi_get_cb_info(env, info, &argc, args, &thisValue, nullptr);
+  CHECK_STATUS;
+  if (argc < 2)
+    NAPI_THROW_ERROR("setTally requires a tile index and a tally state.");
+
+  multiviewerWrapper *viewer = nullptr;
+  multiviewerTile *tile = nullptr;
+  std::string error;
+  if (!acquireTile(env, thisValue, args[0], &viewer, &tile, &error))
+    NAPI_THROW_ERROR(error.c_str());
+
+  napi_valuetype type;
+  status = napi_typeof(env, args[1], &type);
+  CHECK_STATUS;
+  bool program = false, preview = false;
+  if (type != napi_object ||
+      !readTallyFlag(env, args[1], "onProgram", &program) ||
+      !readTallyFlag(env, args[1], "onPreview", &preview))
+    NAPI_THROW_ERROR("Tally state must be an object with Boolean "
+                     "onProgram and onPreview.");
+
+  {
+    std::lock_guard<std::mutex> lock(viewer->mutex);
+    tile->program = program;
+    tile->preview = preview;
+  }
+  napi_value result;
+  status = napi_get_undefined(env, &result);
+  CHECK_STATUS;
+  return result;
+}
+
+napi_value multiviewerConnections(napi_env env, napi_callback_info info) {
+  napi_status status;
+  size_t argc = 0;
+  napi_value thisValue;
+  status = napi_get_cb_info(env, info, &argc, nullptr, &thisValue, nullptr);
+  CHECK_STATUS;
+
+  multiviewerWrapper *viewer = nullptr;
+  if (!acquireMultiviewerFromThis(env, thisValue, &viewer))
+    NAPI_THROW_ERROR("Multiviewer has been destroyed.");
+  int connections = 0;
+  if (viewer->send != nullptr)
+    connections = NDIlib_send_get_no_connections(viewer->send, 0);
+
+  napi_value result;
+  status = napi_create_int32(env, connections, &result);
+  CHECK_STATUS;
+  return result;
+}
+
+napi_value multiviewerSourceName(napi_env env, napi_callback_info info) {
+  napi_status status;
+  size_t argc = 0;
+  napi_value thisValue;
+  status = napi_get_cb_info(env, info, &argc, nullptr, &thisValue, nullptr);
+  CHECK_STATUS;
+
+  multiviewerWrapper *viewer = nullptr;
+  if (!acquireMultiviewerFromThis(env, thisValue, &viewer) ||
+      viewer->send == nullptr)
+    NAPI_THROW_ERROR("Multiviewer has been destroyed.");
+  const NDIlib_source_t *source = NDIlib_send_get_source_name(viewer->send);
+  const char *name =
+      source != nullptr && source->p_ndi_name != nullptr ? source->p_ndi_name
+                                                         : "";
+
+  napi_value result;
+  status = napi_create_string_utf8(env, name, NAPI_AUTO_LENGTH, &result);
+  CHECK_STATUS;
+  return result;
+}
+
+napi_value multiviewerStats(napi_env env, napi_callback_info info) {
+  napi_status status;
+  size_t argc = 0;
+  napi_value thisValue;
+  status = napi_get_cb_info(env, info, &argc, nullptr, &thisValue, nullptr);
+  CHECK_STATUS;
+
+  multiviewerWrapper *viewer = nullptr;
+  if (!acquireMultiviewerFromThis(env, thisValue, &viewer))
+    NAPI_THROW_ERROR("Multiviewer has been destroyed.");
+
+  std::vector<multiviewerTileStats> tiles;
+  uint64_t framesSent, lateFrames;
+  double sumMs, maxMs, lastMs;
+  {
+    std::lock_guard<std::mutex> lock(viewer->mutex);
+    for (auto &tile : viewer->tiles)
+      tiles.push_back(tile->stats);
+    framesSent = viewer->framesSent;
+    lateFrames = viewer->lateFrames;
+    sumMs = viewer->composeSumMs;
+    maxMs = viewer->composeMaxMs;
+    lastMs = viewer->composeLastMs;
+  }
+
+  napi_value result, compose, tileList, value;
+  status = napi_create_object(env, &result);
+  CHECK_STATUS;
+  status = napi_create_double(env, (double)framesSent, &value);
+  CHECK_STATUS;
+  status = napi_set_named_property(env, result, "framesSent", value);
+  CHECK_STATUS;
+  status = napi_create_double(env, (double)lateFrames, &value);
+  CHECK_STATUS;
+  status = napi_set_named_property(env, result, "lateFrames", value);
+  CHECK_STATUS;
+
+  status = napi_create_object(env, &compose);
+  CHECK_STATUS;
+  status = napi_create_double(
+      env, framesSent > 0 ? sumMs / (double)framesSent : 0.0, &value);
+  CHECK_STATUS;
+  status = napi_set_named_property(env, compose, "mean", value);
+  CHECK_STATUS;
+  status = napi_create_double(env, maxMs, &value);
+  CHECK_STATUS;
+  status = napi_set_named_property(env, compose, "max", value);
+  CHECK_STATUS;
+  status = napi_create_double(env, lastMs, &value);
+  CHECK_STATUS;
+  status = napi_set_named_property(env, compose, "last", value);
+  CHECK_STATUS;
+  status = napi_set_named_property(env, result, "composeMs", compose);
+  CHECK_STATUS;
+
+  status = napi_create_array_with_length(env, tiles.size(), &tileList);
+  CHECK_STATUS;
+  for (size_t i = 0; i < tiles.size(); i++) {
+    napi_value tile;
+    status = napi_create_object(env, &tile);
+    CHECK_STATUS;
+    status = napi_get_boolean(env, tiles[i].signal, &value);
+    CHECK_STATUS;
+    status = napi_set_named_property(env, tile, "signal", value);
+    CHECK_STATUS;
+    status = napi_create_int32(env, tiles[i].xres, &value);
+    CHECK_STATUS;
+    status = napi_set_named_property(env, tile, "xres", value);
+    CHECK_STATUS;
+    status = napi_create_int32(env, tiles[i].yres, &value);
+    CHECK_STATUS;
+    status = napi_set_named_property(env, tile, "yres", value);
+    CHECK_STATUS;
+    status = napi_set_element(env, tileList, (uint32_t)i, tile);
+    CHECK_STATUS;
+  }
+  status = napi_set_named_property(env, result, "tiles", tileList);
+  CHECK_STATUS;
+  return result;
+}
+
+// Reads an optional integer property into *result, which keeps its default
+// when the property is undefined.
+bool parseOptionalInteger(napi_env env, napi_value object, const char *name,
+                          const std::string &label, uint32_t min, uint32_t max,
+                          uint32_t *result, carrier *c) {
+  napi_value value;
+  c->status = napi_get_named_property(env, object, name, &value);
+  if (c->status != napi_ok)
+    return false;
+  napi_valuetype type;
+  c->status = napi_typeof(env, value, &type);
+  if (c->status != napi_ok)
+    return false;
+  if (type == napi_undefined)
+    return true;
+  uint32_t parsed = 0;
+  c->status =
+      parseUint32Value(env, value, label.c_str(), &parsed, &c->errorMsg);
+  if (c->status != napi_ok)
+    return false;
+  if (!c->errorMsg.empty() || parsed < min || parsed > max) {
+    c->status = GRANDI_INVALID_ARGS;
+    c->errorMsg = label + " must be an integer between " +
+                  std::to_string(min) + " and " + std::to_string(max) + ".";
+    return false;
+  }
+  *result = parsed;
+  return true;
+}
+
+bool parseOptionalColor(napi_env env, napi_value object, const char *name,
+                        drawColor *color, carrier *c) {
+  napi_value value;
+  c->status = napi_get_named_property(env, object, name, &value);
+  if (c->status != napi_ok)
+    return false;
+  napi_valuetype type;
+  c->status = napi_typeof(env, value, &type);
+  if (c->status != napi_ok)
+    return false;
+  if (type == napi_undefined)
+    return true;
+  c->status = parseDrawColor(env, value, name, color, &c->errorMsg);
+  if (c->status != napi_ok)
+    return false;
+  if (!c->errorMsg.empty()) {
+    c->status = GRANDI_INVALID_ARGS;
+    return false;
+  }
+  return true;
+}
+
+bool bindMultiviewerTile(napi_env env, napi_value options, uint32_t index,
+                         multiviewerCarrier *c) {
+  multiviewerWrapper *viewer = c->viewer;
+  std::string prefix = "tiles[" + std::to_string(index) + "]";
+  napi_valuetype type;
+  c->status = napi_typeof(env, options, &type);
+  if (c->status != napi_ok)
+    return false;
+  bool isArray = false;
+  if (type == napi_object) {
+    c->status = napi_is_array(env, options, &isArray);
+    if (c->status != napi_ok)
+      return false;
+  }
+  if (type != napi_object || isArray) {
+    c->status = GRANDI_INVALID_ARGS;
+    c->errorMsg = prefix + " must be an object.";
+    return false;
+  }
+
+  std::unique_ptr<multiviewerTile> tile(new (std::nothrow) multiviewerTile);
+  if (tile == nullptr) {
+    c->status = GRANDI_ALLOCATION_FAILURE;
+    c->errorMsg = "Failed to allocate multiviewer tile.";
+    return false;
+  }
+  uint32_t x = 0, y = 0, width = 0, height = 0;
+  if (!parseOptionalInteger(env, options, "x", prefix + ".x", 0,
+                            viewer->xres - 1, &x, c) ||
+      !parseOptionalInteger(env, options, "y", prefix + ".y", 0,
+                            viewer->yres - 1, &y, c) ||
+      !parseOptionalInteger(env, options, "width", prefix + ".width", 1,
+                            viewer->xres - x, &width, c) ||
+      !parseOptionalInteger(env, options, "height", prefix + ".height", 1,
+                            viewer->yres - y, &height, c))
+    return false;
+  if (width == 0 || height == 0) {
+    c->status = GRANDI_INVALID_ARGS;
+    c->errorMsg = prefix + " must have a width and a height.";
+    return false;
+  }
+  if (yuvCanvas(viewer) && ((x | width) & 1)) {
+    c->status = GRANDI_INVALID_ARGS;
+    c->errorMsg = prefix + " must have an even x and width for UYVY output.";
+    return false;
+  }
+  tile->x = (int)x;
+  tile->y = (int)y;
+  tile->width = (int)width;
+  tile->height = (int)height;
+  for (auto &other : viewer->tiles) {
+    if (tile->x < other->x + other->width && other->x < tile->x + tile->width &&
+        tile->y < other->y + other->height &&
+        other->y < tile->y + tile->height) {
+      c->status = GRANDI_INVALID_ARGS;
+      c->errorMsg = prefix + " overlaps another tile.";
+      return false;
+    }
+  }
+
+  napi_value label;
+  c->status = napi_get_named_property(env, options, "label", &label);
+  if (c->status != napi_ok)
+    return false;
+  c->status = napi_typeof(env, label, &type);
+  if (c->status != napi_ok)
+    return false;
+  if (type != napi_undefined) {
+    std::unique_ptr<char[]> text;
+    if (type != napi_string) {
+      c->status = GRANDI_INVALID_ARGS;
+      c->errorMsg = prefix + ".label must be a string.";
+      return false;
+    }
+    if (!readUtf8String(env, label, &text, c))
+      return false;
+    tile->label = text.get();
+    tile->labelVersion = 1;
+  }
+
+  napi_value receiver, recvValue = nullptr;
+  c->status = napi_get_named_property(env, options, "receiver", &receiver);
+  if (c->status != napi_ok)
+    return false;
+  c->status = napi_typeof(env, receiver, &type);
+  if (c->status != napi_ok)
+    return false;
+  if (type == napi_object) {
+    c->status = napi_get_named_property(env, receiver, "embedded", &recvValue);
+    if (c->status != napi_ok)
+      return false;
+    c->status = napi_typeof(env, recvValue, &type);
+    if (c->status != napi_ok)
+      return false;
+  }
+  if (type != napi_external) {
+    c->status = GRANDI_INVALID_ARGS;
+    c->errorMsg = prefix + ".receiver must be an initialized receiver.";
+    return false;
+  }
+
+  void *externalData;
+  c->status = napi_get_value_external(env, recvValue, &externalData);
+  if (c->status != napi_ok)
+    return false;
+  nativeHandle *recvHandle = (nativeHandle *)externalData;
+  void *recvData;
+  nativeCaptureStatus captureStatus =
+      bindNativeCaptureHandle(recvHandle, &recvData);
+  if (captureStatus != nativeCaptureStatus::success) {
+    c->status = GRANDI_INVALID_ARGS;
+    c->errorMsg = "Receiver has been destroyed.";
+    if (captureStatus == nativeCaptureStatus::bound)
+      c->errorMsg = "Receiver is already bound to a FrameSync, sync group, "
+                    "or multiviewer.";
+    else if (captureStatus == nativeCaptureStatus::busy)
+      c->errorMsg = "Receiver has active capture operations.";
+    return false;
+  }
+  tile->recvHandle = recvHandle;
+  tile->recv = ((receiveInstance *)recvData)->recv;
+  viewer->tiles.push_back(std::move(tile));
+  c->status = napi_create_reference(env, receiver, 1,
+                                    &viewer->tiles.back()->receiverRef);
+  return c->status == napi_ok;
+}
+
+void multiviewerExecute(napi_env env, void *data) {
+  multiviewerCarrier *c = (multiviewerCarrier *)data;
+  multiviewerWrapper *viewer = c->viewer;
+
+  size_t canvasBytes = (size_t)canvasLineStride(viewer) * viewer->yres;
+  viewer->target.fourCC = viewer->fourCC;
+  viewer->target.xres = viewer->xres;
+  viewer->target.yres = viewer->yres;
+  viewer->target.lineStride = canvasLineStride(viewer);
+  for (auto &canvas : viewer->canvas) {
+    if (!canvas.allocate(canvasBytes)) {
+      c->status = GRANDI_ALLOCATION_FAILURE;
+      c->errorMsg = "Failed to allocate multiviewer canvas.";
+      return;
+    }
+    // Areas outside the tiles are never redrawn.
+    viewer->target.data = (uint8_t *)canvas.data;
+    fillRect(viewer->target, 0, 0, viewer->xres, viewer->yres,
+             viewer->background);
+  }
+
+  for (auto &tile : viewer->tiles) {
+    tile->fs = NDIlib_framesync_create(tile->recv);
+    if (tile->fs == nullptr) {
+      c->status = GRANDI_RECEIVE_CREATE_FAIL;
+      c->errorMsg = "Failed to create NDI frame synchronizer.";
+      return;
+    }
+  }
+
+  NDIlib_send_create_t sendCreate{};
+  sendCreate.p_ndi_name = c->name.get();
+  sendCreate.p_groups = c->groups.get();
+  sendCreate.clock_video = true;
+  sendCreate.clock_audio = false;
+  viewer->send = NDIlib_send_create(&sendCreate);
+  if (viewer->send == nullptr) {
+    c->status = GRANDI_SEND_CREATE_FAIL;
+    c->errorMsg = "Failed to create NDI sender.";
+    return;
+  }
+}
+
+void multiviewerComplete(napi_env env, napi_status asyncStatus, void *data) {
+  multiviewerCarrier *c = (multiviewerCarrier *)data;
+
+  if (asyncStatus != napi_ok) {
+    c->status = asyncStatus;
+    c->errorMsg = "Async multiviewer creation failed to complete.";
+  }
+  REJECT_STATUS;
+
+  napi_value result;
+  c->status = napi_create_object(env, &result);
+  REJECT_STATUS;
+
+  multiviewerWrapper *viewer = c->viewer;
+  napi_value embedded;
+  c->status = napi_create_external(env, viewer, finalizeMultiviewer, nullptr,
+                                   &embedded);
+  REJECT_STATUS;
+  c->viewer = nullptr;
+  c->status = napi_set_named_property(env, result, "embedded", embedded);
+  REJECT_STATUS;
+
+  struct {
+    const char *name;
+    napi_callback callback;
+  } methods[] = {
+      {"setLabel", multiviewerSetLabel},
+      {"setTally", multiviewerSetTally},
+      {"connections", multiviewerConnections},
+      {"sourceName", multiviewerSourceName},
+      {"stats", multiviewerStats},
+      {"destroy", destroyMultiviewer},
+  };
+  for (auto &method : methods) {
+    napi_value fn;
+    c->status = napi_create_function(env, method.name, NAPI_AUTO_LENGTH,
+                                     method.callback, nullptr, &fn);
+    REJECT_STATUS;
+    c->status = napi_set_named_property(env, result, method.name, fn);
+    REJECT_STATUS;
+  }
+
+  napi_value value;
+  c->status = napi_create_string_utf8(env, c->name.get(), NAPI_AUTO_LENGTH,
+                                      &value);
+  REJECT_STATUS;
+  c->status = napi_set_named_property(env, result, "name", value);
+  REJECT_STATUS;
+  c->status = napi_create_uint32(env, (uint32_t)viewer->tiles.size(), &value);
+  REJECT_STATUS;
+  c->status = napi_set_named_property(env, result, "size", value);
+  REJECT_STATUS;
+  c->status = napi_create_int32(env, viewer->xres, &value);
+  REJECT_STATUS;
+  c->status = napi_set_named_property(env, result, "xres", value);
+  REJECT_STATUS;
+  c->status = napi_create_int32(env, viewer->yres, &value);
+  REJECT_STATUS;
+  c->status = napi_set_named_property(env, result, "yres", value);
+  REJECT_STATUS;
+
+  threadRole workers = viewer->role;
+  workers.role = "multiviewer-worker";
+  viewer->pool.start(viewer->threads, workers);
+  viewer->thread = std::thread(runMultiviewer, viewer);
+
+  napi_status status = napi_resolve_deferred(env, c->_deferred, result);
+  FLOATING_STATUS;
+  tidyCarrier(env, c);
+}
+} // namespace
+
+napi_value multiviewer(napi_env env, napi_callback_info info) {
+  napi_valuetype type;
+  multiviewerCarrier *c = createCarrier<multiviewerCarrier>(env);
+  if (c == nullptr)
+    return nullptr;
+
+  napi_value promise;
+  c->status = napi_create_promise(env, &c->_deferred, &promise);
+  REJECT_RETURN;
+
+  size_t argc = 1;
+  napi_value args[1];
+  c->status = napi_get_cb_info(env, info, &argc, args, nullptr, nullptr);
+  REJECT_RETURN;
+
+  if (argc < 1)
+    REJECT_ERROR_RETURN("Multiviewer options must be provided.",
+                        GRANDI_INVALID_ARGS);
+  napi_value options = args[0];
+  c->status = napi_typeof(env, options, &type);
+  REJECT_RETURN;
+  bool isArray;
+  c->status = napi_is_array(env, options, &isArray);
+  REJECT_RETURN;
+  if (type != napi_object || isArray)
+    REJECT_ERROR_RETURN("Multiviewer options must be an object.",
+                        GRANDI_INVALID_ARGS);
+
+  c->viewer = new (std::nothrow) multiviewerWrapper;
+  if (c->viewer == nullptr)
+    REJECT_ERROR_RETURN("Failed to allocate multiviewer state.",
+                        GRANDI_ALLOCATION_FAILURE);
+  multiviewerWrapper *viewer = c->viewer;
+  viewer->env = env;
+
+  napi_value name, groups;
+  c->status = napi_get_named_property(env, options, "name", &name);
+  REJECT_RETURN;
+  c->status = napi_typeof(env, name, &type);
+  REJECT_RETURN;
+  if (type != napi_string)
+    REJECT_ERROR_RETURN("Name property must be of type string.",
+                        GRANDI_INVALID_ARGS);
+  if (!readUtf8String(env, name, &c->name, c))
+    REJECT_RETURN;
+  c->status = napi_get_named_property(env, options, "groups", &groups);
+  REJECT_RETURN;
+  c->status = napi_typeof(env, groups, &type);
+  REJECT_RETURN;
+  if (type != napi_undefined) {
+    if (type != napi_string)
+      REJECT_ERROR_RETURN("Groups value must be a string when provided.",
+                          GRANDI_INVALID_ARGS);
+    if (!readUtf8String(env, groups, &c->groups, c))
+      REJECT_RETURN;
+  }
+
+  uint32_t xres = 1920, yres = 1080, frameRateN = 30, frameRateD = 1;
+  uint32_t border = 2, fourCC = NDIlib_FourCC_type_UYVY;
+  if (!parseOptionalInteger(env, options, "xres", "xres", 16, 16384, &xres,
+                            c) ||
+      !parseOptionalInteger(env, options, "yres", "yres", 16, 16384, &yres,
+                            c) ||
+      !parseOptionalInteger(env, options, "frameRateN", "frameRateN", 1,
+                            1000000, &frameRateN, c) ||
+      !parseOptionalInteger(env, options, "frameRateD", "frameRateD", 1,
+                            100000, &frameRateD, c) ||
+      !parseOptionalInteger(env, options, "border", "border", 0, kMaxBorder,
+                            &border, c) ||
+      !parseOptionalInteger(env, options, "fourCC", "fourCC", 0, UINT32_MAX,
+                            &fourCC, c))
+    REJECT_RETURN;
+  viewer->fourCC = (NDIlib_FourCC_video_type_e)fourCC;
+  if (viewer->fourCC == NDIlib_FourCC_type_UYVA || !drawable(viewer->fourCC))
+    REJECT_ERROR_RETURN("fourCC must be UYVY, BGRA, BGRX, RGBA, or RGBX.",
+                        GRANDI_INVALID_ARGS);
+  if (yuvCanvas(viewer) && (xres & 1))
+    REJECT_ERROR_RETURN("xres must be even for UYVY output.",
+                        GRANDI_INVALID_ARGS);
+  viewer->xres = (int)xres;
+  viewer->yres = (int)yres;
+  viewer->frameRateN = (int)frameRateN;
+  viewer->frameRateD = (int)frameRateD;
+  viewer->border = (int)border;
+  if (!parseOptionalColor(env, options, "background", &viewer->background,
+                          c) ||
+      !parseOptionalColor(env, options, "borderColor", &viewer->borderColor,
+                          c))
+    REJECT_RETURN;
+
+  napi_value tiles;
+  c->status = napi_get_named_property(env, options, "tiles", &tiles);
+  REJECT_RETURN;
+  c->status = napi_is_array(env, tiles, &isArray);
+  REJECT_RETURN;
+  uint32_t tileCount = 0;
+  if (isArray) {
+    c->status = napi_get_array_length(env, tiles, &tileCount);
+    REJECT_RETURN;
+  }
+  if (tileCount == 0 || tileCount > kMaxTiles)
+    REJECT_ERROR_RETURN("tiles must be an array of 1 to 64 tiles.",
+                        GRANDI_INVALID_ARGS);
+
+  uint32_t hardware = std::max(std::thread::hardware_concurrency(), 1u);
+  viewer->threads = std::min(tileCount, hardware);
+  if (!parseOptionalInteger(env, options, "threads", "threads", 1, kMaxThreads,
+                            &viewer->threads, c))
+    REJECT_RETURN;
+  c->status = parseThreadPlacement(env, options, &viewer->role.placement,
+                                   &c->errorMsg);
+  REJECT_RETURN;
+  if (!c->errorMsg.empty())
+    REJECT_ERROR_RETURN(c->errorMsg, GRANDI_INVALID_ARGS);
+  viewer->role.role = "multiviewer";
+  viewer->role.owner = c->name.get();
+
+  for (uint32_t i = 0; i < tileCount; i++) {
+    napi_value tile;
+    c->status = napi_get_element(env, tiles, i, &tile);
+    REJECT_RETURN;
+    if (!bindMultiviewerTile(env, tile, i, c))
+      REJECT_RETURN;
+  }
+
+  napi_value resource_name;
+  c->status = napi_create_string_utf8(env, "Multiviewer", NAPI_AUTO_LENGTH,
+                                      &resource_name);
+  REJECT_RETURN;
+  c->status =
+      napi_create_async_work(env, NULL, resource_name, multiviewerExecute,
+                             multiviewerComplete, c, &c->_request);
+  REJECT_RETURN;
+  c->status = napi_queue_async_work(env, c->_request);
+  REJECT_RETURN;
+
+  return promise;
+}
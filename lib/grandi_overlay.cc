@@ -0,0 +1,458 @@
+/* Copyright 2025 Sarhan Aissi <github@tux.tn>.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "grandi_overlay.h"
+#include "grandi_fields.h"
+#include "grandi_scale.h"
+#include "grandi_simd.h"
+
+namespace {
+const int kMaxOverlaySize = 16384;
+
+enum keyFamily { yuvFamily = 0, bgrFamily = 1, rgbFamily = 2 };
+
+int familyOf(NDIlib_FourCC_video_type_e fourCC) {
+  switch (fourCC) {
+  case NDIlib_FourCC_type_UYVY:
+  case NDIlib_FourCC_type_UYVA:
+    return yuvFamily;
+  case NDIlib_FourCC_type_BGRA:
+  case NDIlib_FourCC_type_BGRX:
+    return bgrFamily;
+  case NDIlib_FourCC_type_RGBA:
+  case NDIlib_FourCC_type_RGBX:
+    return rgbFamily;
+  default:
+    return -1;
+  }
+}
+
+// Reads an integer property into *result, which keeps its value when the
+// property is undefined and optional.
+napi_status readInteger(napi_env env, napi_value object, const char *name,
+                        const std::string &label, int min, int max,
+                        bool optional, int *result, std::string *error) {
+  napi_value value;
+  napi_status status = napi_get_named_property(env, object, name, &value);
+  if (status != napi_ok)
+    return status;
+  napi_valuetype type;
+  status = napi_typeof(env, value, &type);
+  if (status != napi_ok)
+    return status;
+  if (type == napi_undefined && optional)
+    return napi_ok;
+  double parsed = NAN;
+  if (type == napi_number) {
+    status = napi_get_value_double(env, value, &parsed);
+    if (status != napi_ok)
+      return status;
+  }
+  if (!std::isfinite(parsed) || std::floor(parsed) != parsed || parsed < min ||
+      parsed > max) {
+    *error = label + " must be an integer between " + std::to_string(min) +
+             " and " + std::to_string(max) + ".";
+    return napi_ok;
+  }
+  *result = (int)parsed;
+  return napi_ok;
+}
+
+uint8_t premultiply(uint8_t value, uint32_t alpha, int bias) {
+  int scaled = (value - bias) * (int)alpha;
+  int rounded = scaled >= 0 ? (scaled + 127) / 255 : -((127 - scaled) / 255);
+  return (uint8_t)(bias + rounded);
+}
+
+size_t convertedSize(const overlaySource &source, int family) {
+  size_t pixels = (size_t)source.xres * source.yres;
+  // 4:2:2 planes and a row for premultiplying RGB before conversion.
+  if (family == yuvFamily)
+    return pixels * 3 + (size_t)source.xres * 4;
+  return pixels * 4;
+}
+
+// Writes premultiplied planes for frames of the given family, pointing
+// planes at the source itself when it already has that layout.
+bool prepareOverlay(const overlaySource &source, int family,
+                    ownedBuffer *storage, overlayPlanes *planes) {
+  bool yuvSource = source.fourCC == NDIlib_FourCC_type_UYVA;
+  bool bgrSource = source.fourCC == NDIlib_FourCC_type_BGRA;
+  size_t stride = (size_t)source.lineStride;
+  const uint8_t *sourceAlpha = source.data + stride * source.yres;
+  planes->yres = source.yres;
+  planes->y = source.y;
+  if (family == yuvFamily) {
+    // Chroma is shared by pixel pairs, so the overlay is placed on a pair.
+    planes->xres = source.xres & ~1;
+    planes->x = source.x & ~1;
+  } else {
+    planes->xres = source.xres;
+    planes->x = source.x;
+  }
+
+  bool native = family == yuvFamily
+                    ? yuvSource
+                    : !yuvSource && bgrSource == (family == bgrFamily);
+  if (native && source.premultiplied) {
+    planes->color = source.data;
+    planes->colorStride = stride;
+    planes->alpha = yuvSource ? sourceAlpha : nullptr;
+    planes->alphaStride = stride / 2;
+    return true;
+  }
+
+  size_t size = convertedSize(source, family);
+  if (storage->size < size && !storage->allocate(size))
+    return false;
+  uint8_t *color = (uint8_t *)storage->data;
+  int width = planes->xres;
+  if (family == yuvFamily) {
+    uint8_t *alpha = color + (size_t)width * 2 * source.yres;
+    uint8_t *scratch = alpha + (size_t)width * source.yres;
+    for (int y = 0; y < source.yres; y++) {
+      const uint8_t *in = source.data + stride * y;
+      uint8_t *colorRow = color + (size_t)width * 2 * y;
+      uint8_t *alphaRow = alpha + (size_t)width * y;
+      if (yuvSource) {
+        memcpy(colorRow, in, (size_t)width * 2);
+        memcpy(alphaRow, sourceAlpha + stride / 2 * y, (size_t)width);
+        if (!source.premultiplied) {
+          for (int x = 0; x < width; x += 2) {
+            uint8_t *pair = colorRow + x * 2;
+            uint32_t shared = (alphaRow[x] + alphaRow[x + 1] + 1) >> 1;
+            pair[0] = premultiply(pair[0], shared, 128);
+            pair[1] = premultiply(pair[1], alphaRow[x], 16);
+            pair[2] = premultiply(pair[2], shared, 128);
+            pair[3] = premultiply(pair[3], alphaRow[x + 1], 16);
+          }
+        }
+        continue;
+      }
+      const uint8_t *pixels = in;
+      if (!source.premultiplied) {
+        for (int x = 0; x < source.xres; x++) {
+          const uint8_t *pixel = in + x * 4;
+          uint8_t *out = scratch + x * 4;
+          for (int channel = 0; channel < 3; channel++)
+            out[channel] = premultiply(pixel[channel], pixel[3], 0);
+          out[3] = pixel[3];
+        }
+        pixels = scratch;
+      }
+      // Premultiplied RGB converts straight to premultiplied YUV, since the
+      // conversion is linear apart from its offsets.
+      convertRgbToYuv(colorRow, pixels, width, bgrSource);
+      for (int x = 0; x < width; x++)
+        alphaRow[x] = in[x * 4 + 3];
+    }
+    planes->color = color;
+    planes->colorStride = (size_t)width * 2;
+    planes->alpha = alpha;
+    planes->alphaStride = (size_t)width;
+    return true;
+  }
+
+  bool bgrTarget = family == bgrFamily;
+  for (int y = 0; y < source.yres; y++) {
+    const uint8_t *in = source.data + stride * y;
+    uint8_t *out = color + (size_t)width * 4 * y;
+    if (yuvSource) {
+      const uint8_t *alphaRow = sourceAlpha + stride / 2 * y;
+      convertYuvToRgb(out, in, width, bgrTarget);
+      for (int x = 0; x < width; x++)
+        out[x * 4 + 3] = alphaRow[x];
+    } else if (bgrSource == bgrTarget) {
+      memcpy(out, in, (size_t)width * 4);
+    } else {
+      swapRedBlue(out, in, width);
+    }
+    for (int x = 0; x < width; x++) {
+      uint8_t *pixel = out + x * 4;
+      for (int channel = 0; channel < 3; channel++)
+        pixel[channel] = source.premultiplied
+                             ? std::min(pixel[channel], pixel[3])
+                             : premultiply(pixel[channel], pixel[3], 0);
+    }
+  }
+  planes->color = color;
+  planes->colorStride = (size_t)width * 4;
+  planes->alpha = nullptr;
+  planes->alphaStride = 0;
+  return true;
+}
+
+// Copies columns [0, from) and [to, width) of a line and keys the columns
+// between them.
+template <typename Key>
+void keyLine(uint8_t *dst, const uint8_t *under, size_t bytesPerPixel,
+             int from, int to, int width, Key keyColumns) {
+  memcpy(dst, under, (size_t)from * bytesPerPixel);
+  keyColumns(dst + (size_t)from * bytesPerPixel,
+             under + (size_t)from * bytesPerPixel, (size_t)(to - from));
+  memcpy(dst + (size_t)to * bytesPerPixel, under + (size_t)to * bytesPerPixel,
+         (size_t)(width - to) * bytesPerPixel);
+}
+
+void keyFrame(uint8_t *dst, const NDIlib_video_frame_v2_t &frame,
+              const frameLayout &layout, const overlayPlanes &planes,
+              int family) {
+  int left = std::max(planes.x, 0);
+  int right = std::min(planes.x + planes.xres, frame.xres);
+  int top = std::max(planes.y, 0);
+  int bottom = std::min(planes.y + planes.yres, frame.yres);
+  if (left >= right || top >= bottom) {
+    memcpy(dst, frame.p_data, layout.size);
+    return;
+  }
+
+  const uint8_t *src = frame.p_data;
+  size_t bytesPerPixel = family == yuvFamily ? 2 : 4;
+  for (int plane = 0; plane < layout.planes; plane++) {
+    size_t stride = layout.stride[plane];
+    const uint8_t *in = src + layout.offset[plane];
+    uint8_t *out = dst + layout.offset[plane];
+    // Lines outside the overlay are copied in two blocks.
+    memcpy(out, in, stride * top);
+    memcpy(out + stride * bottom, in + stride * bottom,
+           stride * (frame.yres - bottom));
+    for (int y = top; y < bottom; y++) {
+      const uint8_t *under = in + stride * y;
+      uint8_t *line = out + stride * y;
+      size_t row = (size_t)(y - planes.y);
+      int column = left - planes.x;
+      if (plane == 1) {
+        // UYVA alpha plane.
+        const uint8_t *over =
+            planes.alpha + planes.alphaStride * row + column;
+        keyLine(line, under, 1, left, right, frame.xres,
+                [&](uint8_t *d, const uint8_t *u, size_t count) {
+                  compositeAlpha(d, u, over, count);
+                });
+        continue;
+      }
+      const uint8_t *over =
+          planes.color + planes.colorStride * row + column * bytesPerPixel;
+      if (family == yuvFamily) {
+        const uint8_t *alpha =
+            planes.alpha + planes.alphaStride * row + column;
+        keyLine(line, under, 2, left, right, frame.xres,
+                [&](uint8_t *d, const uint8_t *u, size_t count) {
+                  compositeUyvy(d, u, over, alpha, count);
+                });
+      } else {
+        keyLine(line, under, 4, left, right, frame.xres,
+                [&](uint8_t *d, const uint8_t *u, size_t count) {
+                  compositeRgba(d, u, over, count);
+                });
+      }
+    }
+  }
+}
+} // namespace
+
+bool keyable(NDIlib_FourCC_video_type_e fourCC) {
+  return familyOf(fourCC) >= 0;
+}
+
+napi_status parseOverlay(napi_env env, napi_value frame, napi_value options,
+                         overlaySource *source, napi_value *buffer,
+                         std::string *error) {
+  error->clear();
+  napi_valuetype type;
+  napi_status status = napi_typeof(env, frame, &type);
+  if (status != napi_ok)
+    return status;
+  bool isArray = false;
+  if (type == napi_object) {
+    status = napi_is_array(env, frame, &isArray);
+    if (status != napi_ok)
+      return status;
+  }
+  if (type != napi_object || isArray) {
+    *error = "overlay must be a video frame object.";
+    return napi_ok;
+  }
+
+  int fourCC = 0;
+  status = readInteger(env, frame, "fourCC", "overlay.fourCC", INT32_MIN,
+                       INT32_MAX, false, &fourCC, error);
+  if (status != napi_ok)
+    return status;
+  source->fourCC = (NDIlib_FourCC_video_type_e)fourCC;
+  if (!error->empty() || (source->fourCC != NDIlib_FourCC_type_UYVA &&
+                          source->fourCC != NDIlib_FourCC_type_BGRA &&
+                          source->fourCC != NDIlib_FourCC_type_RGBA)) {
+    *error = "overlay.fourCC must be UYVA, BGRA, or RGBA.";
+    return napi_ok;
+  }
+  status = readInteger(env, frame, "xres", "overlay.xres", 1, kMaxOverlaySize,
+                       false, &source->xres, error);
+  if (status != napi_ok || !error->empty())
+    return status;
+  status = readInteger(env, frame, "yres", "overlay.yres", 1, kMaxOverlaySize,
+                       false, &source->yres, error);
+  if (status != napi_ok || !error->empty())
+    return status;
+  source->lineStride = 0;
+  status = readInteger(env, frame, "lineStrideBytes", "overlay.lineStrideBytes",
+                       0, INT32_MAX, true, &source->lineStride, error);
+  if (status != napi_ok || !error->empty())
+    return status;
+
+  bool yuv = source->fourCC == NDIlib_FourCC_type_UYVA;
+  if (yuv && source->xres % 2 != 0) {
+    *error = "overlay.xres must be even for UYVA.";
+    return napi_ok;
+  }
+  int minStride = defaultLineStride(source->fourCC, source->xres);
+  if (source->lineStride == 0)
+    source->lineStride = minStride;
+  if (source->lineStride < minStride || (yuv && source->lineStride % 2 != 0)) {
+    *error = yuv ? "overlay.lineStrideBytes must be even and at least xres * 2."
+                 : "overlay.lineStrideBytes must be at least xres * 4.";
+    return napi_ok;
+  }
+
+  status = napi_get_named_property(env, frame, "data", buffer);
+  if (status != napi_ok)
+    return status;
+  bool isBuffer;
+  status = napi_is_buffer(env, *buffer, &isBuffer);
+  if (status != napi_ok)
+    return status;
+  void *data = nullptr;
+  size_t length = 0;
+  if (isBuffer) {
+    status = napi_get_buffer_info(env, *buffer, &data, &length);
+    if (status != napi_ok)
+      return status;
+  }
+  frameLayout layout;
+  describeFrame(source->fourCC, source->lineStride, (size_t)source->yres,
+                &layout);
+  if (!isBuffer || length < layout.size) {
+    *error = "overlay.data must be a Buffer holding the whole overlay frame.";
+    return napi_ok;
+  }
+  source->data = (const uint8_t *)data;
+
+  source->x = 0;
+  source->y = 0;
+  source->premultiplied = true;
+  if (options == nullptr)
+    return napi_ok;
+  status = readInteger(env, options, "x", "x", -kMaxOverlaySize,
+                       kMaxOverlaySize, true, &source->x, error);
+  if (status != napi_ok || !error->empty())
+    return status;
+  status = readInteger(env, options, "y", "y", -kMaxOverlaySize,
+                       kMaxOverlaySize, true, &source->y, error);
+  if (status != napi_ok || !error->empty())
+    return status;
+  napi_value value;
+  status = napi_get_named_property(env, options, "premultiplied", &value);
+  if (status != napi_ok)
+    return status;
+  status = napi_typeof(env, value, &type);
+  if (status != napi_ok || type == napi_undefined)
+    return status;
+  if (type != napi_boolean) {
+    *error = "premultiplied must be a Boolean.";
+    return napi_ok;
+  }
+  return napi_get_value_bool(env, value, &source->premultiplied);
+}
+
+overlayKeyer::~overlayKeyer() {
+  delete pending;
+  delete current;
+}
+
+void overlayKeyer::setResident(residentOverlay *overlay) {
+  std::lock_guard<std::mutex> lock(pendingMutex);
+  delete pending;
+  pending = overlay;
+  pendingSet = true;
+  resident.store(overlay != nullptr);
+}
+
+bool overlayKeyer::key(NDIlib_video_frame_v2_t *frame,
+                       const overlaySource *perFrame, carrier *c) {
+  {
+    std::lock_guard<std::mutex> lock(pendingMutex);
+    if (pendingSet) {
+      delete current;
+      current = pending;
+      pending = nullptr;
+      pendingSet = false;
+    }
+  }
+  if (perFrame == nullptr && current == nullptr)
+    return true;
+
+  int family = familyOf(frame->FourCC);
+  if (family < 0) {
+    c->status = GRANDI_INVALID_ARGS;
+    c->errorMsg = "Overlays can only be keyed over UYVY, UYVA, BGRA, BGRX, "
+                  "RGBA, or RGBX frames.";
+    return false;
+  }
+
+  overlayPlanes planes;
+  bool prepared = true;
+  if (perFrame != nullptr) {
+    prepared = prepareOverlay(*perFrame, family, &converted, &planes);
+  } else {
+    if (!current->ready[family])
+      current->ready[family] =
+          prepareOverlay(current->source, family, &current->converted[family],
+                         &current->planes[family]);
+    prepared = current->ready[family];
+    planes = current->planes[family];
+  }
+
+  int lineStride = frame->line_stride_in_bytes != 0
+                       ? frame->line_stride_in_bytes
+                       : defaultLineStride(frame->FourCC, frame->xres);
+  frameLayout layout;
+  describeFrame(frame->FourCC, lineStride, (size_t)frame->yres, &layout);
+  if (!prepared || (keyed.size < layout.size && !keyed.allocate(layout.size))) {
+    c->status = GRANDI_ALLOCATION_FAILURE;
+    c->errorMsg = "Failed to allocate overlay buffer.";
+    return false;
+  }
+  keyFrame((uint8_t *)keyed.data, *frame, layout, planes, family);
+  frame->p_data = (uint8_t *)keyed.data;
+  return true;
+}
+
+bool overlayKeyer::copy(NDIlib_video_frame_v2_t *frame, carrier *c) {
+  if (keyed.data != nullptr && frame->p_data == (uint8_t *)keyed.data)
+    return true;
+  size_t size = videoDataSize(*frame);
+  if (keyed.size < size && !keyed.allocate(size)) {
+    c->status = GRANDI_ALLOCATION_FAILURE;
+    c->errorMsg = "Failed to allocate overlay buffer.";
+    return false;
+  }
+  memcpy(keyed.data, frame->p_data, size);
+  frame->p_data = (uint8_t *)keyed.data;
+  return true;
+}
@@ -0,0 +1,108 @@
+/* Copyright 2025 Sarhan Aissi <github@tux.tn>.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+*/
+
+#ifndef GRANDI_OVERLAY_H
+#define GRANDI_OVERLAY_H
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+#include <Processing.NDI.Lib.h>
+
+#include "node_api.h"
+#include "grandi_util.h"
+
+// A UYVA, BGRA, or RGBA overlay frame and where its top-left corner sits on
+// the frames it is keyed over.
+struct overlaySource {
+  const uint8_t *data = nullptr;
+  NDIlib_FourCC_video_type_e fourCC = NDIlib_FourCC_type_UYVA;
+  int xres = 0;
+  int yres = 0;
+  int lineStride = 0;
+  int x = 0;
+  int y = 0;
+  bool premultiplied = true;
+};
+
+// Reads an overlay frame, and its x, y, and premultiplied placement from
+// options when options is not null. buffer receives the frame's data Buffer.
+// Invalid values set error and return napi_ok, like parseUint32Value.
+napi_status parseOverlay(napi_env env, napi_value frame, napi_value options,
+                         overlaySource *source, napi_value *buffer,
+                         std::string *error);
+
+// Frame formats overlays can be keyed over: UYVY, UYVA, BGRA, BGRX, RGBA,
+// and RGBX.
+bool keyable(NDIlib_FourCC_video_type_e fourCC);
+
+// Premultiplied overlay planes in the layout of the frames they are keyed
+// over: UYVY with a separate alpha plane, or 32-bit pixels in the frame's byte
+// order.
+struct overlayPlanes {
+  const uint8_t *color = nullptr;
+  const uint8_t *alpha = nullptr;
+  size_t colorStride = 0;
+  size_t alphaStride = 0;
+  int xres = 0;
+  int yres = 0;
+  int x = 0;
+  int y = 0;
+};
+
+// An overlay copied out of its Buffer, with its planes converted for each
+// frame layout on first use.
+struct residentOverlay {
+  ownedBuffer frame;
+  overlaySource source;
+  ownedBuffer converted[3];
+  overlayPlanes planes[3];
+  bool ready[3] = {};
+};
+
+// Keys overlays over a sender's video frames. Each keyed send holds mutex
+// while keying and sending, reusing the keyer's buffers, so steady-state
+// keying does not allocate. A resident overlay set from the JavaScript thread
+// is adopted by the next keyed send; its planes are converted once rather
+// than on every frame.
+struct overlayKeyer {
+  std::mutex mutex;
+
+  ~overlayKeyer();
+  // Takes ownership of overlay, or clears the resident overlay when null.
+  void setResident(residentOverlay *overlay);
+  bool hasResident() const { return resident.load(); }
+  // Keys perFrame, or the resident overlay when perFrame is null, into a copy
+  // of frame and points frame at the copy, which stays valid while mutex is
+  // held. Sets the carrier's error and returns false on failure.
+  bool key(NDIlib_video_frame_v2_t *frame, const overlaySource *perFrame,
+           carrier *c);
+  // Points frame at a copy of itself in the keyer's buffer, unless key has
+  // already, so it can be drawn over without touching the caller's Buffer.
+  bool copy(NDIlib_video_frame_v2_t *frame, carrier *c);
+
+private:
+  std::mutex pendingMutex;
+  residentOverlay *pending = nullptr;
+  bool pendingSet = false;
+  residentOverlay *current = nullptr;
+  std::atomic<bool> resident{false};
+  ownedBuffer keyed;
+  ownedBuffer converted;
+};
+
+#endif /* GRANDI_OVERLAY_H */
@@ -0,0 +1,1174 @@
+/* Copyright 2025 Sarhan Aissi <github@tux.tn>.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <Processing.NDI.Lib.h>
+
+#include "grandi_pipe.h"
+#include "grandi_fields.h"
+#include "grandi_receive.h"
+#include "grandi_thread.h"
+#include "grandi_util.h"
+
+#ifdef _WIN32
+
+napi_value pipeFrames(napi_env env, napi_callback_info info) {
+  carrier *c = createCarrier<carrier>(env);
+  if (c == nullptr)
+    return nullptr;
+  napi_value promise;
+  c->status = napi_create_promise(env, &c->_deferred, &promise);
+  REJECT_RETURN;
+  REJECT_ERROR_RETURN("Frame pipes are not supported on Windows.",
+                      GRANDI_INVALID_ARGS);
+}
+
+#else // _WIN32
+
+#include <cerrno>
+#include <climits>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+namespace {
+// Bounds how long destroy() waits for the pipe thread, including while the
+// reader is not reading.
+const int kWaitMs = 100;
+const double kTicksPerSecond = 10000000.0;
+
+enum class pipeContainer { nut, y4m, raw };
+
+// One plane of a frame as the SDK delivers it.
+struct framePlane {
+  const uint8_t *data = nullptr;
+  size_t stride = 0;
+  size_t rowBytes = 0;
+  size_t rows = 0;
+};
+
+// Describes the planes of frame in memory order, with alpha last. Returns
+// the number of planes, or 0 for an unknown format.
+int describePlanes(const NDIlib_video_frame_v2_t &frame,
+                   framePlane planes[3]) {
+  size_t width = (size_t)frame.xres;
+  size_t height = (size_t)frame.yres;
+  size_t stride = (size_t)frame.line_stride_in_bytes;
+  if (stride == 0)
+    stride = (size_t)defaultLineStride(frame.FourCC, frame.xres);
+  if (stride == 0)
+    stride = width;
+  size_t offset = 0;
+  auto add = [&](int index, size_t planeStride, size_t rowBytes,
+                 size_t rows) {
+    planes[index].data = frame.p_data + offset;
+    planes[index].stride = planeStride;
+    planes[index].rowBytes = rowBytes;
+    planes[index].rows = rows;
+    offset += planeStride * rows;
+  };
+  switch (frame.FourCC) {
+  case NDIlib_FourCC_type_UYVY:
+    add(0, stride, width * 2, height);
+    return 1;
+  case NDIlib_FourCC_type_BGRA:
+  case NDIlib_FourCC_type_BGRX:
+  case NDIlib_FourCC_type_RGBA:
+  case NDIlib_FourCC_type_RGBX:
+    add(0, stride, width * 4, height);
+    return 1;
+  case NDIlib_FourCC_type_UYVA:
+    add(0, stride, width * 2, height);
+    add(1, stride / 2, width, height);
+    return 2;
+  case NDIlib_FourCC_type_P216:
+    add(0, stride, width * 2, height);
+    add(1, stride, width * 2, height);
+    return 2;
+  case NDIlib_FourCC_type_PA16:
+    add(0, stride, width * 2, height);
+    add(1, stride, width * 2, height);
+    add(2, stride, width * 2, height);
+    return 3;
+  case NDIlib_FourCC_type_I420:
+  case NDIlib_FourCC_type_YV12:
+    add(0, stride, width, height);
+    add(1, stride / 2, width / 2, height / 2);
+    add(2, stride / 2, width / 2, height / 2);
+    return 3;
+  case NDIlib_FourCC_type_NV12:
+    add(0, stride, width, height);
+    add(1, stride, width, height / 2);
+    return 2;
+  default:
+    return 0;
+  }
+}
+
+// Picture properties that the stream header fixes. Frames that differ are
+// dropped, as encoders reading a pipe cannot follow a change.
+struct videoFormat {
+  NDIlib_FourCC_video_type_e fourCC = NDIlib_FourCC_type_UYVY;
+  int xres = 0;
+  int yres = 0;
+  int frameRateN = 0;
+  int frameRateD = 0;
+  NDIlib_frame_format_type_e formatType = NDIlib_frame_format_type_progressive;
+  float aspect = 0.0f;
+
+  bool operator==(const videoFormat &other) const {
+    return fourCC == other.fourCC && xres == other.xres &&
+           yres == other.yres && frameRateN == other.frameRateN &&
+           frameRateD == other.frameRateD && formatType == other.formatType;
+  }
+};
+
+struct framePipe {
+  napi_env env = nullptr;
+  nativeHandle *recvHandle = nullptr;
+  NDIlib_recv_instance_t recv = nullptr;
+  napi_ref receiverRef = nullptr;
+  int fd = -1;
+  // Status flags of fd before it was made non-blocking, or -1.
+  int fdFlags = -1;
+  pipeContainer container = pipeContainer::nut;
+  bool audio = false;
+  threadRole role;
+  std::thread thread;
+
+  // Owned by the pipe thread.
+  bool started = false;
+  bool hasVideo = false;
+  bool hasAudio = false;
+  videoFormat video;
+  int sampleRate = 0;
+  int channels = 0;
+  // NUT time bases as num/den pairs, and the one of each stream.
+  int timeBases = 0;
+  int64_t timeBase[2][2] = {};
+  int videoTimeBase = 0;
+  int audioTimeBase = 0;
+  int64_t origin = 0;
+  int64_t lastVideoPts = -1;
+  int64_t nextAudioPts = -1;
+  std::vector<uint8_t> prefix;
+  std::vector<iovec> iov;
+  ownedBuffer planar;
+  ownedBuffer interleaved;
+
+  // Guarded by mutex.
+  bool stopping = false;
+  // Set once the reader went away or a write failed.
+  bool closed = false;
+  uint64_t framesWritten = 0;
+  uint64_t audioFramesWritten = 0;
+  uint64_t framesDropped = 0;
+  uint64_t bytesWritten = 0;
+  double stallTotalMs = 0.0;
+  double stallMaxMs = 0.0;
+  std::string lastError;
+  std::mutex mutex;
+};
+
+struct pipeCarrier : carrier {
+  framePipe *pipe = nullptr;
+  ~pipeCarrier();
+};
+
+const char *containerName(pipeContainer container) {
+  switch (container) {
+  case pipeContainer::nut:
+    return "nut";
+  case pipeContainer::y4m:
+    return "y4m";
+  default:
+    return "raw";
+  }
+}
+
+void dropFrame(framePipe *pipe, const std::string &reason) {
+  std::lock_guard<std::mutex> lock(pipe->mutex);
+  pipe->framesDropped++;
+  pipe->lastError = reason;
+}
+
+bool reserve(ownedBuffer *buffer, size_t bytes) {
+  return buffer->size >= bytes || buffer->allocate(bytes);
+}
+
+// Appends the rows of plane, as one entry when they are contiguous.
+void appendPlane(std::vector<iovec> &iov, const framePlane &plane) {
+  if (plane.stride == plane.rowBytes) {
+    iov.push_back({(void *)plane.data, plane.rowBytes * plane.rows});
+    return;
+  }
+  for (size_t row = 0; row < plane.rows; row++)
+    iov.push_back(
+        {(void *)(plane.data + plane.stride * row), plane.rowBytes});
+}
+
+// Writes every byte of iov. When the reader falls behind and fd is full,
+// waits for it and counts the wait as stall time, so the frames a slow
+// encoder holds up are visible in stats(). Returns 0, an errno value, or
+// ECANCELED when the pipe is being destroyed.
+int writeAll(framePipe *pipe, std::vector<iovec> &iov) {
+  size_t index = 0;
+  size_t total = 0;
+  double frameStallMs = 0.0;
+  while (index < iov.size()) {
+    int count = (int)std::min(iov.size() - index, (size_t)IOV_MAX);
+    ssize_t written = writev(pipe->fd, iov.data() + index, count);
+    if (written < 0) {
+      if (errno == EINTR)
+        continue;
+      if (errno != EAGAIN && errno != EWOULDBLOCK)
+        return errno;
+      auto start = std::chrono::steady_clock::now();
+      pollfd ready = {pipe->fd, POLLOUT, 0};
+      // POLLERR and POLLHUP surface as an error from the next writev.
+      if (poll(&ready, 1, kWaitMs) < 0 && errno != EINTR)
+        return errno;
+      double waited = std::chrono::duration<double, std::milli>(
+                          std::chrono::steady_clock::now() - start)
+                          .count();
+      frameStallMs += waited;
+      std::lock_guard<std::mutex> lock(pipe->mutex);
+      pipe->stallTotalMs += waited;
+      pipe->stallMaxMs = std::max(pipe->stallMaxMs, frameStallMs);
+      if (pipe->stopping)
+        return ECANCELED;
+      continue;
+    }
+    total += (size_t)written;
+    size_t left = (size_t)written;
+    while (index < iov.size() && left >= iov[index].iov_len)
+      left -= iov[index++].iov_len;
+    if (left > 0) {
+      iov[index].iov_base = (uint8_t *)iov[index].iov_base + left;
+      iov[index].iov_len -= left;
+    }
+  }
+  std::lock_guard<std::mutex> lock(pipe->mutex);
+  pipe->bytesWritten += total;
+  return 0;
+}
+
+// NUT, as specified in FFmpeg's doc/nut.txt. Every frame is a keyframe
+// preceded by a syncpoint, so a reader can join the stream anywhere and
+// frame headers code full timestamps through the syncpoint.
+const uint64_t kNutMainStartcode = 0x4E4D7A561F5F04ADull;
+const uint64_t kNutStreamStartcode = 0x4E5311405BF2F9DBull;
+const uint64_t kNutSyncpointStartcode = 0x4E4BE4ADEECA4569ull;
+const char kNutFileId[] = "nut/multimedia container";
+const int kNutMsbPtsShift = 7;
+// Frame code 0: a keyframe with stream, timestamp, size, and checksum all
+// coded in the frame header.
+const uint64_t kNutFrameFlags = 1 | 8 | 16 | 32 | 64;
+
+void putFixed(std::vector<uint8_t> &out, uint64_t value, int bytes) {
+  for (int i = bytes - 1; i >= 0; i--)
+    out.push_back((uint8_t)(value >> (8 * i)));
+}
+
+void putV(std::vector<uint8_t> &out, uint64_t value) {
+  uint8_t groups[10];
+  int count = 0;
+  do {
+    groups[count++] = value & 0x7f;
+    value >>= 7;
+  } while (value != 0);
+  while (--count > 0)
+    out.push_back(groups[count] | 0x80);
+  out.push_back(groups[0]);
+}
+
+void putS(std::vector<uint8_t> &out, int64_t value) {
+  putV(out, value > 0 ? 2 * (uint64_t)value - 1 : 2 * (uint64_t)-value);
+}
+
+void putBytes(std::vector<uint8_t> &out, const void *data, size_t length) {
+  putV(out, length);
+  out.insert(out.end(), (const uint8_t *)data,
+             (const uint8_t *)data + length);
+}
+
+// CRC-32 with the 0x04C11DB7 polynomial, most significant bit first, no
+// reflection, and 0 as both initial value and final XOR.
+uint32_t nutChecksum(const uint8_t *data, size_t length) {
+  static const std::vector<uint32_t> table = [] {
+    std::vector<uint32_t> entries(256);
+    for (uint32_t i = 0; i < 256; i++) {
+      uint32_t crc = i << 24;
+      for (int bit = 0; bit < 8; bit++)
+        crc = (crc & 0x80000000u) ? (crc << 1) ^ 0x04C11DB7u : crc << 1;
+      entries[i] = crc;
+    }
+    return entries;
+  }();
+  uint32_t crc = 0;
+  for (size_t i = 0; i < length; i++)
+    crc = (crc << 8) ^ table[(crc >> 24) ^ data[i]];
+  return crc;
+}
+
+void putPacket(std::vector<uint8_t> &out, uint64_t startcode,
+               const std::vector<uint8_t> &payload) {
+  size_t start = out.size();
+  putFixed(out, startcode, 8);
+  uint64_t forward = payload.size() + 4;
+  putV(out, forward);
+  if (forward > 4096)
+    putFixed(out, nutChecksum(out.data() + start, out.size() - start), 4);
+  out.insert(out.end(), payload.begin(), payload.end());
+  putFixed(out, nutChecksum(payload.data(), payload.size()), 4);
+}
+
+// Rawvideo codec tags FFmpeg maps to pixel formats. Alpha planes are left
+// out, as no tag carries NDI's separate alpha plane, and P216 has no tag of
+// its own, so it is written as planar 16-bit 4:2:2.
+const char *nutVideoTag(NDIlib_FourCC_video_type_e fourCC) {
+  switch (fourCC) {
+  case NDIlib_FourCC_type_UYVY:
+  case NDIlib_FourCC_type_UYVA:
+    return "UYVY";
+  case NDIlib_FourCC_type_BGRA:
+    return "BGRA";
+  case NDIlib_FourCC_type_BGRX:
+    return "BGR\0";
+  case NDIlib_FourCC_type_RGBA:
+    return "RGBA";
+  case NDIlib_FourCC_type_RGBX:
+    return "RGB\0";
+  case NDIlib_FourCC_type_I420:
+    return "I420";
+  case NDIlib_FourCC_type_YV12:
+    return "YV12";
+  case NDIlib_FourCC_type_NV12:
+    return "NV12";
+  case NDIlib_FourCC_type_P216:
+  case NDIlib_FourCC_type_PA16:
+    return "Y3\x0a\x10";
+  default:
+    return nullptr;
+  }
+}
+
+int64_t greatestDivisor(int64_t a, int64_t b) {
+  while (b != 0) {
+    int64_t next = a % b;
+    a = b;
+    b = next;
+  }
+  return a;
+}
+
+// Sample aspect ratio from the picture aspect ratio, or 0:0 when unknown.
+void sampleAspect(const videoFormat &format, int64_t *num, int64_t *den) {
+  *num = 0;
+  *den = 0;
+  if (format.aspect <= 0.0f || format.xres <= 0 || format.yres <= 0)
+    return;
+  int64_t n = std::llround((double)format.aspect * format.yres * 1000.0);
+  int64_t d = (int64_t)format.xres * 1000;
+  int64_t divisor = greatestDivisor(n, d);
+  if (n <= 0 || divisor <= 0)
+    return;
+  *num = n / divisor;
+  *den = d / divisor;
+}
+
+int addTimeBase(framePipe *pipe, int64_t num, int64_t den) {
+  int64_t divisor = greatestDivisor(num, den);
+  num /= divisor;
+  den /= divisor;
+  for (int i = 0; i < pipe->timeBases; i++)
+    if (pipe->timeBase[i][0] == num && pipe->timeBase[i][1] == den)
+      return i;
+  pipe->timeBase[pipe->timeBases][0] = num;
+  pipe->timeBase[pipe->timeBases][1] = den;
+  return pipe->timeBases++;
+}
+
+void putNutHeader(framePipe *pipe, std::vector<uint8_t> &out) {
+  const videoFormat &video = pipe->video;
+  bool fixedRate = video.frameRateN > 0 && video.frameRateD > 0;
+  pipe->timeBases = 0;
+  pipe->videoTimeBase =
+      fixedRate ? addTimeBase(pipe, video.frameRateD, video.frameRateN)
+                : addTimeBase(pipe, 1, (int64_t)kTicksPerSecond);
+  if (pipe->audio)
+    pipe->audioTimeBase = addTimeBase(pipe, 1, pipe->sampleRate);
+
+  out.insert(out.end(), kNutFileId, kNutFileId + sizeof(kNutFileId));
+
+  std::vector<uint8_t> payload;
+  putV(payload, 3);
+  putV(payload, pipe->audio ? 2 : 1);
+  putV(payload, 65536);
+  putV(payload, pipe->timeBases);
+  for (int i = 0; i < pipe->timeBases; i++) {
+    putV(payload, pipe->timeBase[i][0]);
+    putV(payload, pipe->timeBase[i][1]);
+  }
+  // One run defines every frame code but 'N' alike: flags, then six fields
+  // for pts delta, size multiplier, stream, size lsb, reserved, and count.
+  putV(payload, kNutFrameFlags);
+  putV(payload, 6);
+  putS(payload, 0);
+  putV(payload, 1);
+  putV(payload, 0);
+  putV(payload, 0);
+  putV(payload, 0);
+  putV(payload, 255);
+  putV(payload, 0);
+  putPacket(out, kNutMainStartcode, payload);
+
+  int64_t sampleNum, sampleDen;
+  sampleAspect(video, &sampleNum, &sampleDen);
+  payload.clear();
+  putV(payload, 0);
+  putV(payload, 0);
+  putBytes(payload, nutVideoTag(video.fourCC), 4);
+  putV(payload, pipe->videoTimeBase);
+  putV(payload, kNutMsbPtsShift);
+  putV(payload, fixedRate ? (video.frameRateN + video.frameRateD - 1) /
+                                video.frameRateD
+                          : (int64_t)kTicksPerSecond);
+  putV(payload, 0);
+  putV(payload, fixedRate ? 1 : 0);
+  putBytes(payload, nullptr, 0);
+  putV(payload, video.xres);
+  putV(payload, video.yres);
+  putV(payload, sampleNum);
+  putV(payload, sampleDen);
+  putV(payload, 0);
+  putPacket(out, kNutStreamStartcode, payload);
+
+  if (!pipe->audio)
+    return;
+  payload.clear();
+  putV(payload, 1);
+  putV(payload, 1);
+  putBytes(payload, "PFD\x20", 4);
+  putV(payload, pipe->audioTimeBase);
+  putV(payload, kNutMsbPtsShift);
+  putV(payload, pipe->sampleRate);
+  putV(payload, 0);
+  putV(payload, 0);
+  putBytes(payload, nullptr, 0);
+  putV(payload, pipe->sampleRate);
+  putV(payload, 1);
+  putV(payload, pipe->channels);
+  putPacket(out, kNutStreamStartcode, payload);
+}
+
+// Appends the syncpoint and frame header that precede size bytes of data.
+void putNutFrame(framePipe *pipe, std::vector<uint8_t> &out, int stream,
+                 int timeBase, int64_t pts, size_t size) {
+  std::vector<uint8_t> payload;
+  putV(payload, (uint64_t)pts * pipe->timeBases + timeBase);
+  putV(payload, 0);
+  putPacket(out, kNutSyncpointStartcode, payload);
+
+  size_t start = out.size();
+  out.push_back(0);
+  putV(out, stream);
+  // The syncpoint set this stream's last pts to pts, so its low bits are
+  // enough.
+  putV(out, (uint64_t)pts & ((1u << kNutMsbPtsShift) - 1));
+  putV(out, size);
+  putFixed(out, nutChecksum(out.data() + start, out.size() - start), 4);
+}
+
+// YUV4MPEG2 colour spaces, or nullptr for formats it cannot carry.
+const char *y4mColour(NDIlib_FourCC_video_type_e fourCC) {
+  switch (fourCC) {
+  case NDIlib_FourCC_type_UYVY:
+  case NDIlib_FourCC_type_UYVA:
+    return "422";
+  case NDIlib_FourCC_type_I420:
+  case NDIlib_FourCC_type_YV12:
+  case NDIlib_FourCC_type_NV12:
+    return "420jpeg";
+  case NDIlib_FourCC_type_P216:
+  case NDIlib_FourCC_type_PA16:
+    return "422p16";
+  default:
+    return nullptr;
+  }
+}
+
+void putY4mHeader(const videoFormat &video, std::vector<uint8_t> &out) {
+  int64_t sampleNum, sampleDen;
+  sampleAspect(video, &sampleNum, &sampleDen);
+  if (sampleNum == 0) {
+    sampleNum = 1;
+    sampleDen = 1;
+  }
+  char header[160];
+  int length = snprintf(
+      header, sizeof(header), "YUV4MPEG2 W%d H%d F%d:%d I%c A%lld:%lld C%s\n",
+      video.xres, video.yres, video.frameRateN, video.frameRateD,
+      video.formatType == NDIlib_frame_format_type_interleaved ? 't' : 'p',
+      (long long)sampleNum, (long long)sampleDen, y4mColour(video.fourCC));
+  out.insert(out.end(), header, header + length);
+}
+
+// Splits the interleaved chroma of a UYVY plane, or of a P216 or NV12 chroma
+// plane, into the planar buffer after any luma written there. sampleBytes is
+// 1 or 2; UYVY also moves luma.
+bool splitPlane(framePipe *pipe, const framePlane &plane, bool uyvy,
+                size_t sampleBytes) {
+  size_t pairs = plane.rowBytes / (uyvy ? 4 : 2 * sampleBytes);
+  size_t chroma = pairs * sampleBytes * plane.rows;
+  size_t luma = uyvy ? chroma * 2 : 0;
+  if (!reserve(&pipe->planar, luma + chroma * 2))
+    return false;
+  uint8_t *y = (uint8_t *)pipe->planar.data;
+  uint8_t *u = y + luma;
+  uint8_t *v = u + chroma;
+  for (size_t row = 0; row < plane.rows; row++) {
+    const uint8_t *in = plane.data + plane.stride * row;
+    if (uyvy) {
+      for (size_t i = 0; i < pairs; i++, in += 4) {
+        *u++ = in[0];
+        *y++ = in[1];
+        *v++ = in[2];
+        *y++ = in[3];
+      }
+      continue;
+    }
+    for (size_t i = 0; i < pairs; i++) {
+      memcpy(u, in, sampleBytes);
+      memcpy(v, in + sampleBytes, sampleBytes);
+      u += sampleBytes;
+      v += sampleBytes;
+      in += 2 * sampleBytes;
+    }
+  }
+  return true;
+}
+
+// Appends the picture of frame as Y, U, and V planes, converting packed and
+// semi-planar formats.
+bool appendPlanarPicture(framePipe *pipe, const NDIlib_video_frame_v2_t &frame,
+                      const framePlane planes[3]) {
+  switch (frame.FourCC) {
+  case NDIlib_FourCC_type_UYVY:
+  case NDIlib_FourCC_type_UYVA:
+    if (!splitPlane(pipe, planes[0], true, 1))
+      return false;
+    pipe->iov.push_back(
+        {pipe->planar.data, planes[0].rowBytes * planes[0].rows});
+    return true;
+  case NDIlib_FourCC_type_I420:
+    for (int i = 0; i < 3; i++)
+      appendPlane(pipe->iov, planes[i]);
+    return true;
+  case NDIlib_FourCC_type_YV12:
+    appendPlane(pipe->iov, planes[0]);
+    appendPlane(pipe->iov, planes[2]);
+    appendPlane(pipe->iov, planes[1]);
+    return true;
+  default: {
+    size_t sampleBytes = frame.FourCC == NDIlib_FourCC_type_NV12 ? 1 : 2;
+    if (!splitPlane(pipe, planes[1], false, sampleBytes))
+      return false;
+    appendPlane(pipe->iov, planes[0]);
+    pipe->iov.push_back(
+        {pipe->planar.data, planes[1].rowBytes * planes[1].rows});
+    return true;
+  }
+  }
+}
+
+int64_t frameTime(int64_t timestamp, int64_t timecode) {
+  return timestamp != NDIlib_recv_timestamp_undefined ? timestamp : timecode;
+}
+
+// Converts a frame time into the units of a NUT time base.
+int64_t toPts(const framePipe *pipe, int timeBase, int64_t time) {
+  double seconds = (double)(time - pipe->origin) / kTicksPerSecond;
+  return std::llround(seconds * (double)pipe->timeBase[timeBase][1] /
+                      (double)pipe->timeBase[timeBase][0]);
+}
+
+// Writes the stream header once the formats it declares are known. Returns
+// 0 without writing while NUT with audio still waits for either stream.
+int startStream(framePipe *pipe, int64_t time) {
+  if (pipe->started || !pipe->hasVideo || (pipe->audio && !pipe->hasAudio))
+    return 0;
+  pipe->prefix.clear();
+  if (pipe->container == pipeContainer::nut)
+    putNutHeader(pipe, pipe->prefix);
+  else if (pipe->container == pipeContainer::y4m)
+    putY4mHeader(pipe->video, pipe->prefix);
+  pipe->started = true;
+  pipe->origin = time;
+  if (pipe->prefix.empty())
+    return 0;
+  pipe->iov.assign(1, {pipe->prefix.data(), pipe->prefix.size()});
+  return writeAll(pipe, pipe->iov);
+}
+
+int writeVideo(framePipe *pipe, const NDIlib_video_frame_v2_t &frame) {
+  framePlane planes[3];
+  int count = frame.p_data != nullptr ? describePlanes(frame, planes) : 0;
+  if (count == 0) {
+    dropFrame(pipe, "Video frame has no data or an unknown fourCC.");
+    return 0;
+  }
+  if ((pipe->container == pipeContainer::nut &&
+       nutVideoTag(frame.FourCC) == nullptr) ||
+      (pipe->container == pipeContainer::y4m &&
+       y4mColour(frame.FourCC) == nullptr)) {
+    dropFrame(pipe, std::string("Video fourCC is not supported by the ") +
+                        containerName(pipe->container) + " container.");
+    return 0;
+  }
+
+  videoFormat format;
+  format.fourCC = frame.FourCC;
+  format.xres = frame.xres;
+  format.yres = frame.yres;
+  format.frameRateN = frame.frame_rate_N;
+  format.frameRateD = frame.frame_rate_D;
+  format.formatType = frame.frame_format_type;
+  format.aspect = frame.picture_aspect_ratio;
+  if (!pipe->hasVideo) {
+    pipe->video = format;
+    pipe->hasVideo = true;
+  } else if (!(format == pipe->video)) {
+    dropFrame(pipe, "Video format changed after the stream header.");
+    return 0;
+  }
+  int64_t time = frameTime(frame.timestamp, frame.timecode);
+  int error = startStream(pipe, time);
+  if (error != 0 || !pipe->started)
+    return error;
+
+  // The first entry is left for what precedes the picture.
+  pipe->iov.assign(1, {nullptr, 0});
+  bool p216 = frame.FourCC == NDIlib_FourCC_type_P216 ||
+              frame.FourCC == NDIlib_FourCC_type_PA16;
+  if (pipe->container == pipeContainer::y4m ||
+      (pipe->container == pipeContainer::nut && p216)) {
+    if (!appendPlanarPicture(pipe, frame, planes)) {
+      dropFrame(pipe, "Failed to allocate a conversion buffer.");
+      return 0;
+    }
+  } else {
+    // NUT leaves alpha planes out.
+    if (pipe->container == pipeContainer::nut &&
+        frame.FourCC == NDIlib_FourCC_type_UYVA)
+      count--;
+    for (int i = 0; i < count; i++)
+      appendPlane(pipe->iov, planes[i]);
+  }
+
+  if (pipe->container == pipeContainer::y4m) {
+    static const char marker[] = "FRAME\n";
+    pipe->iov[0] = {(void *)marker, sizeof(marker) - 1};
+  } else if (pipe->container == pipeContainer::nut) {
+    size_t size = 0;
+    for (const iovec &entry : pipe->iov)
+      size += entry.iov_len;
+    int64_t pts = toPts(pipe, pipe->videoTimeBase, time);
+    pts = std::max(pts, pipe->lastVideoPts + 1);
+    pipe->lastVideoPts = pts;
+    pipe->prefix.clear();
+    putNutFrame(pipe, pipe->prefix, 0, pipe->videoTimeBase, pts, size);
+    pipe->iov[0] = {pipe->prefix.data(), pipe->prefix.size()};
+  } else {
+    pipe->iov.erase(pipe->iov.begin());
+  }
+
+  error = writeAll(pipe, pipe->iov);
+  if (error == 0) {
+    std::lock_guard<std::mutex> lock(pipe->mutex);
+    pipe->framesWritten++;
+  }
+  return error;
+}
+
+// Interleaves planar float audio into NUT packets of PCM_F32LE.
+int writeAudio(framePipe *pipe, const NDIlib_audio_frame_v3_t &frame) {
+  if (frame.p_data == nullptr || frame.no_samples <= 0 ||
+      frame.no_channels <= 0 || frame.sample_rate <= 0 ||
+      frame.FourCC != NDIlib_FourCC_audio_type_FLTP) {
+    dropFrame(pipe, "Audio frame has no data or is not planar float.");
+    return 0;
+  }
+  if (!pipe->hasAudio) {
+    pipe->sampleRate = frame.sample_rate;
+    pipe->channels = frame.no_channels;
+    pipe->hasAudio = true;
+  } else if (frame.sample_rate != pipe->sampleRate ||
+             frame.no_channels != pipe->channels) {
+    dropFrame(pipe, "Audio format changed after the stream header.");
+    return 0;
+  }
+  int64_t time = frameTime(frame.timestamp, frame.timecode);
+  int error = startStream(pipe, time);
+  if (error != 0 || !pipe->started)
+    return error;
+
+  size_t samples = (size_t)frame.no_samples;
+  size_t channels = (size_t)frame.no_channels;
+  size_t size = samples * channels * sizeof(float);
+  if (!reserve(&pipe->interleaved, size)) {
+    dropFrame(pipe, "Failed to allocate a conversion buffer.");
+    return 0;
+  }
+  float *out = (float *)pipe->interleaved.data;
+  for (size_t channel = 0; channel < channels; channel++) {
+    const float *in = (const float *)(frame.p_data +
+                                      frame.channel_stride_in_bytes * channel);
+    for (size_t i = 0; i < samples; i++)
+      out[i * channels + channel] = in[i];
+  }
+
+  // Audio stays contiguous while its timestamps drift by less than 50 ms,
+  // so encoders see no gaps from network jitter.
+  int64_t pts = toPts(pipe, pipe->audioTimeBase, time);
+  if (pipe->nextAudioPts >= 0 &&
+      pts <= pipe->nextAudioPts + pipe->sampleRate / 20)
+    pts = pipe->nextAudioPts;
+  pts = std::max<int64_t>(pts, 0);
+  pipe->nextAudioPts = pts + (int64_t)samples;
+
+  pipe->prefix.clear();
+  putNutFrame(pipe, pipe->prefix, 1, pipe->audioTimeBase, pts, size);
+  pipe->iov.assign(1, {pipe->prefix.data(), pipe->prefix.size()});
+  pipe->iov.push_back({pipe->interleaved.data, size});
+  error = writeAll(pipe, pipe->iov);
+  if (error == 0) {
+    std::lock_guard<std::mutex> lock(pipe->mutex);
+    pipe->audioFramesWritten++;
+  }
+  return error;
+}
+
+void runPipe(framePipe *pipe) {
+  threadRegistration registration(pipe->role);
+  int error = 0;
+  while (error == 0) {
+    {
+      std::lock_guard<std::mutex> lock(pipe->mutex);
+      if (pipe->stopping)
+        break;
+    }
+
+    NDIlib_video_frame_v2_t video{};
+    NDIlib_audio_frame_v3_t audio{};
+    NDIlib_frame_type_e type = NDIlib_recv_capture_v3(
+        pipe->recv, &video, pipe->audio ? &audio : nullptr, nullptr, kWaitMs);
+    if (type == NDIlib_frame_type_error) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(kWaitMs));
+    } else if (type == NDIlib_frame_type_video) {
+      error = writeVideo(pipe, video);
+      NDIlib_recv_free_video_v2(pipe->recv, &video);
+    } else if (type == NDIlib_frame_type_audio) {
+      error = writeAudio(pipe, audio);
+      NDIlib_recv_free_audio_v3(pipe->recv, &audio);
+    }
+  }
+  if (error == 0 || error == ECANCELED)
+    return;
+
+  std::lock_guard<std::mutex> lock(pipe->mutex);
+  pipe->closed = true;
+  if (error == EPIPE)
+    pipe->lastError = "The pipe reader closed its end.";
+  else
+    pipe->lastError = "Failed to write to fd: " + std::string(strerror(error));
+}
+
+// Stops the pipe thread, restores the blocking mode of fd, and releases the
+// receiver. fd stays open; its owner closes it. Returns false when the pipe
+// had already been stopped.
+bool stopPipe(napi_env env, framePipe *pipe) {
+  {
+    std::lock_guard<std::mutex> lock(pipe->mutex);
+    if (pipe->stopping)
+      return false;
+    pipe->stopping = true;
+  }
+  if (pipe->thread.joinable())
+    pipe->thread.join();
+  if (pipe->fdFlags >= 0)
+    fcntl(pipe->fd, F_SETFL, pipe->fdFlags);
+  pipe->fdFlags = -1;
+  if (pipe->recvHandle != nullptr)
+    releaseNativeCaptureBinding(pipe->recvHandle);
+  pipe->recvHandle = nullptr;
+  pipe->recv = nullptr;
+  if (pipe->receiverRef != nullptr)
+    napi_delete_reference(env, pipe->receiverRef);
+  pipe->receiverRef = nullptr;
+  return true;
+}
+
+void finalizePipe(napi_env env, void *data, void *hint) {
+  framePipe *pipe = (framePipe *)data;
+  stopPipe(env, pipe);
+  delete pipe;
+}
+
+pipeCarrier::~pipeCarrier() {
+  if (pipe != nullptr)
+    finalizePipe(pipe->env, pipe, nullptr);
+}
+
+bool acquirePipeFromThis(napi_env env, napi_value thisValue,
+                         framePipe **pipe) {
+  napi_value pipeValue;
+  if (napi_get_named_property(env, thisValue, "embedded", &pipeValue) !=
+      napi_ok)
+    return false;
+  napi_valuetype type;
+  if (napi_typeof(env, pipeValue, &type) != napi_ok || type != napi_external)
+    return false;
+  void *externalData;
+  if (napi_get_value_external(env, pipeValue, &externalData) != napi_ok)
+    return false;
+  *pipe = (framePipe *)externalData;
+  return true;
+}
+
+napi_value destroyPipe(napi_env env, napi_callback_info info) {
+  bool success = false;
+  napi_value thisValue;
+  size_t argc = 0;
+  framePipe *pipe = nullptr;
+  if (napi_get_cb_info(env, info, &argc, nullptr, &thisValue, nullptr) ==
+          napi_ok &&
+      acquirePipeFromThis(env, thisValue, &pipe)) {
+    success = stopPipe(env, pipe);
+    napi_value value;
+    if (napi_create_int32(env, 0, &value) == napi_ok)
+      napi_set_named_property(env, thisValue, "embedded", value);
+  }
+
+  napi_value result;
+  if (napi_get_boolean(env, success, &result) != napi_ok)
+    napi_get_boolean(env, false, &result);
+  return result;
+}
+
+napi_value pipeStats(napi_env env, napi_callback_info info) {
+  napi_status status;
+  size_t argc = 0;
+  napi_value thisValue;
+  status = napi_get_cb_info(env, info, &argc, nullptr, &thisValue, nullptr);
+  CHECK_STATUS;
+
+  framePipe *pipe = nullptr;
+  if (!acquirePipeFromThis(env, thisValue, &pipe))
+    NAPI_THROW_ERROR("Frame pipe has been destroyed.");
+
+  uint64_t counts[4];
+  double totalMs, maxMs;
+  bool closed;
+  std::string lastError;
+  {
+    std::lock_guard<std::mutex> lock(pipe->mutex);
+    counts[0] = pipe->framesWritten;
+    counts[1] = pipe->audioFramesWritten;
+    counts[2] = pipe->framesDropped;
+    counts[3] = pipe->bytesWritten;
+    totalMs = pipe->stallTotalMs;
+    maxMs = pipe->stallMaxMs;
+    closed = pipe->closed;
+    lastError = pipe->lastError;
+  }
+
+  napi_value result, stall, value;
+  status = napi_create_object(env, &result);
+  CHECK_STATUS;
+  const char *names[4] = {"framesWritten", "audioFramesWritten",
+                          "framesDropped", "bytesWritten"};
+  for (int i = 0; i < 4; i++) {
+    status = napi_create_double(env, (double)counts[i], &value);
+    CHECK_STATUS;
+    status = napi_set_named_property(env, result, names[i], value);
+    CHECK_STATUS;
+  }
+
+  status = napi_create_object(env, &stall);
+  CHECK_STATUS;
+  status = napi_create_double(env, totalMs, &value);
+  CHECK_STATUS;
+  status = napi_set_named_property(env, stall, "total", value);
+  CHECK_STATUS;
+  status = napi_create_double(env, maxMs, &value);
+  CHECK_STATUS;
+  status = napi_set_named_property(env, stall, "max", value);
+  CHECK_STATUS;
+  status = napi_set_named_property(env, result, "stallMs", stall);
+  CHECK_STATUS;
+
+  status = napi_get_boolean(env, closed, &value);
+  CHECK_STATUS;
+  status = napi_set_named_property(env, result, "closed", value);
+  CHECK_STATUS;
+  if (!lastError.empty()) {
+    status = napi_create_string_utf8(env, lastError.c_str(), NAPI_AUTO_LENGTH,
+                                     &value);
+    CHECK_STATUS;
+    status = napi_set_named_property(env, result, "lastError", value);
+    CHECK_STATUS;
+  }
+  return result;
+}
+
+// Reads the options of pipe(). The receiver is bound last, once nothing
+// else can fail.
+bool parsePipeOptions(napi_env env, napi_callback_info info, framePipe *pipe,
+                      napi_value *receiver, carrier *c) {
+  size_t argc = 1;
+  napi_value options;
+  c->status = napi_get_cb_info(env, info, &argc, &options, nullptr, nullptr);
+  if (c->status != napi_ok)
+    return false;
+  napi_valuetype type = napi_undefined;
+  bool isArray = false;
+  if (argc >= 1) {
+    c->status = napi_typeof(env, options, &type);
+    if (c->status != napi_ok)
+      return false;
+    c->status = napi_is_array(env, options, &isArray);
+    if (c->status != napi_ok)
+      return false;
+  }
+  if (type != napi_object || isArray) {
+    c->status = GRANDI_INVALID_ARGS;
+    c->errorMsg = "Pipe options must be an object.";
+    return false;
+  }
+
+  napi_value value;
+  c->status = napi_get_named_property(env, options, "fd", &value);
+  if (c->status != napi_ok)
+    return false;
+  uint32_t fd = 0;
+  c->status = parseUint32Value(env, value, "fd", &fd, &c->errorMsg);
+  if (c->status != napi_ok)
+    return false;
+  if (!c->errorMsg.empty() || fd > INT_MAX) {
+    c->status = GRANDI_INVALID_ARGS;
+    c->errorMsg = "fd must be a file descriptor number.";
+    return false;
+  }
+  pipe->fd = (int)fd;
+
+  c->status = napi_get_named_property(env, options, "container", &value);
+  if (c->status != napi_ok)
+    return false;
+  c->status = napi_typeof(env, value, &type);
+  if (c->status != napi_ok)
+    return false;
+  if (type != napi_undefined) {
+    std::unique_ptr<char[]> name;
+    if (type == napi_string && !readUtf8String(env, value, &name, c))
+      return false;
+    if (type == napi_string && strcmp(name.get(), "nut") == 0) {
+      pipe->container = pipeContainer::nut;
+    } else if (type == napi_string && strcmp(name.get(), "y4m") == 0) {
+      pipe->container = pipeContainer::y4m;
+    } else if (type == napi_string && strcmp(name.get(), "raw") == 0) {
+      pipe->container = pipeContainer::raw;
+    } else {
+      c->status = GRANDI_INVALID_ARGS;
+      c->errorMsg = "container must be \"nut\", \"y4m\", or \"raw\".";
+      return false;
+    }
+  }
+
+  c->status = napi_get_named_property(env, options, "audio", &value);
+  if (c->status != napi_ok)
+    return false;
+  c->status = napi_typeof(env, value, &type);
+  if (c->status != napi_ok)
+    return false;
+  if (type == napi_boolean) {
+    c->status = napi_get_value_bool(env, value, &pipe->audio);
+    if (c->status != napi_ok)
+      return false;
+  } else if (type != napi_undefined) {
+    c->status = GRANDI_INVALID_ARGS;
+    c->errorMsg = "audio must be a Boolean.";
+    return false;
+  }
+  if (pipe->audio && pipe->container != pipeContainer::nut) {
+    c->status = GRANDI_INVALID_ARGS;
+    c->errorMsg = "audio requires the nut container.";
+    return false;
+  }
+
+  c->status = parseThreadPlacement(env, options, &pipe->role.placement,
+                                   &c->errorMsg);
+  if (c->status != napi_ok)
+    return false;
+  if (!c->errorMsg.empty()) {
+    c->status = GRANDI_INVALID_ARGS;
+    return false;
+  }
+  pipe->role.role = "pipe";
+  pipe->role.owner = "fd " + std::to_string(pipe->fd);
+
+  c->status = napi_get_named_property(env, options, "receiver", receiver);
+  return c->status == napi_ok;
+}
+
+// Checks fd and makes it non-blocking, so a reader that stops reading
+// cannot hold up destroy(). Writes still wait for the reader, in poll().
+void pipeExecute(napi_env env, void *data) {
+  pipeCarrier *c = (pipeCarrier *)data;
+  framePipe *pipe = c->pipe;
+
+  int flags = fcntl(pipe->fd, F_GETFL);
+  if (flags < 0) {
+    c->status = GRANDI_INVALID_ARGS;
+    c->errorMsg = "fd " + std::to_string(pipe->fd) + " is not open.";
+    return;
+  }
+  if ((flags & O_ACCMODE) == O_RDONLY) {
+    c->status = GRANDI_INVALID_ARGS;
+    c->errorMsg = "fd " + std::to_string(pipe->fd) + " is not writable.";
+    return;
+  }
+  if ((flags & O_NONBLOCK) == 0 &&
+      fcntl(pipe->fd, F_SETFL, flags | O_NONBLOCK) < 0) {
+    c->status = GRANDI_INVALID_ARGS;
+    c->errorMsg = "Failed to make fd non-blocking: " +
+                  std::string(strerror(errno));
+    return;
+  }
+  pipe->fdFlags = flags;
+}
+
+void pipeComplete(napi_env env, napi_status asyncStatus, void *data) {
+  pipeCarrier *c = (pipeCarrier *)data;
+
+  if (asyncStatus != napi_ok) {
+    c->status = asyncStatus;
+    c->errorMsg = "Async frame pipe creation failed to complete.";
+  }
+  REJECT_STATUS;
+
+  framePipe *pipe = c->pipe;
+  napi_value embedded, result, value;
+  c->status =
+      napi_create_external(env, pipe, finalizePipe, nullptr, &embedded);
+  REJECT_STATUS;
+  c->pipe = nullptr;
+  c->status = napi_create_object(env, &result);
+  REJECT_STATUS;
+  c->status = napi_set_named_property(env, result, "embedded", embedded);
+  REJECT_STATUS;
+
+  struct {
+    const char *name;
+    napi_callback callback;
+  } methods[] = {
+      {"stats", pipeStats},
+      {"destroy", destroyPipe},
+  };
+  for (auto &method : methods) {
+    c->status = napi_create_function(env, method.name, NAPI_AUTO_LENGTH,
+                                     method.callback, nullptr, &value);
+    REJECT_STATUS;
+    c->status = napi_set_named_property(env, result, method.name, value);
+    REJECT_STATUS;
+  }
+
+  c->status = napi_create_int32(env, pipe->fd, &value);
+  REJECT_STATUS;
+  c->status = napi_set_named_property(env, result, "fd", value);
+  REJECT_STATUS;
+  c->status = napi_create_string_utf8(env, containerName(pipe->container),
+                                      NAPI_AUTO_LENGTH, &value);
+  REJECT_STATUS;
+  c->status = napi_set_named_property(env, result, "container", value);
+  REJECT_STATUS;
+  c->status = napi_get_boolean(env, pipe->audio, &value);
+  REJECT_STATUS;
+  c->status = napi_set_named_property(env, result, "audio", value);
+  REJECT_STATUS;
+  pipe->thread = std::thread(runPipe, pipe);
+
+  napi_status status = napi_resolve_deferred(env, c->_deferred, result);
+  FLOATING_STATUS;
+  tidyCarrier(env, c);
+}
+} // namespace
+
+napi_value pipeFrames(napi_env env, napi_callback_info info) {
+  pipeCarrier *c = createCarrier<pipeCarrier>(env);
+  if (c == nullptr)
+    return nullptr;
+
+  napi_value promise;
+  c->status = napi_create_promise(env, &c->_deferred, &promise);
+  REJECT_RETURN;
+
+  c->pipe = new (std::nothrow) framePipe;
+  if (c->pipe == nullptr)
+    REJECT_ERROR_RETURN("Failed to allocate frame pipe.",
+                        GRANDI_ALLOCATION_FAILURE);
+  framePipe *pipe = c->pipe;
+  pipe->env = env;
+
+  napi_value receiver;
+  if (!parsePipeOptions(env, info, pipe, &receiver, c))
+    REJECT_RETURN;
+  receiveInstance *instance = nullptr;
+  if (!bindReceiverCapture(env, receiver, "receiver", &pipe->recvHandle,
+                           &instance, c))
+    REJECT_RETURN;
+  pipe->recv = instance->recv;
+  c->status = napi_create_reference(env, receiver, 1, &pipe->receiverRef);
+  REJECT_RETURN;
+
+  napi_value resource_name;
+  c->status = napi_create_string_utf8(env, "Pipe", NAPI_AUTO_LENGTH,
+                                      &resource_name);
+  REJECT_RETURN;
+  c->status = napi_create_async_work(env, NULL, resource_name, pipeExecute,
+                                     pipeComplete, c, &c->_request);
+  REJECT_RETURN;
+  // Execute can fail before napi_queue_async_work returns, so its result
+  // must not overwrite c->status.
+  napi_status status = napi_queue_async_work(env, c->_request);
+  if (status != napi_ok) {
+    c->status = status;
+    REJECT_RETURN;
+  }
+  return promise;
+}
+
+#endif // _WIN32
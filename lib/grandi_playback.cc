@@ -0,0 +1,935 @@
+/* Copyright 2025 Sarhan Aissi <github@tux.tn>.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+*/
+
+#include <Processing.NDI.Lib.h>
+
+#include "grandi_playback.h"
+#include "grandi_util.h"
+
+#ifdef _WIN32
+
+napi_value openRecording(napi_env env, napi_callback_info info) {
+  carrier *c = createCarrier<carrier>(env);
+  if (c == nullptr)
+    return nullptr;
+  napi_value promise;
+  c->status = napi_create_promise(env, &c->_deferred, &promise);
+  REJECT_RETURN;
+  REJECT_ERROR_RETURN("Recording playback is not supported on Windows.",
+                      GRANDI_INVALID_ARGS);
+}
+
+#else // _WIN32
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <memory>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+#include "grandi_lz4.h"
+#include "grandi_record.h"
+#include "grandi_timecode.h"
+
+namespace {
+const uint32_t kMaxStripes = 64;
+// Largest record read, well above a 16-bit 8K picture with alpha.
+const uint64_t kMaxRecordBytes = 1ull << 30;
+// Video records probed for the frame rate that timecode text is read at.
+const size_t kFrameRateProbes = 16;
+// One seek view per key for each of type 0 (any), recordVideo, and
+// recordAudio, at type * 2 plus 1 for timecodes.
+const size_t kSeekViews = 6;
+
+struct recordingPlayer {
+  std::string path;
+  int fd = -1;
+  // Mapping that holds the index: the whole sidecar, or the pages at the
+  // end of a closed recording whose sidecar is missing.
+  void *map = nullptr;
+  size_t mapSize = 0;
+  const recordIndexEntry *entries = nullptr;
+  size_t count = 0;
+  bool sidecar = false;
+  // Entry positions sorted by key, stable so equal keys stay in file order,
+  // for seek() to binary search. Undefined timestamps are left out of the
+  // timestamp views. They cover the first indexedCount entries.
+  std::vector<size_t> seekViews[kSeekViews];
+  size_t indexedCount = 0;
+  // Frame rate of the first video record.
+  int frameRateN = 0;
+  int frameRateD = 0;
+  // Entry that read() returns next.
+  size_t cursor = 0;
+};
+
+void unmapIndex(recordingPlayer *player) {
+  if (player->map != nullptr)
+    munmap(player->map, player->mapSize);
+  player->map = nullptr;
+  player->mapSize = 0;
+  player->entries = nullptr;
+  player->count = 0;
+}
+
+void destroyPlayer(void *value) {
+  recordingPlayer *player = (recordingPlayer *)value;
+  unmapIndex(player);
+  if (player->fd >= 0)
+    close(player->fd);
+  delete player;
+}
+
+bool readAt(int fd, void *data, size_t size, uint64_t offset) {
+  uint8_t *bytes = (uint8_t *)data;
+  while (size > 0) {
+    ssize_t n = pread(fd, bytes, size, (off_t)offset);
+    if (n < 0 && errno == EINTR)
+      continue;
+    if (n <= 0)
+      return false;
+    bytes += n;
+    size -= (size_t)n;
+    offset += (uint64_t)n;
+  }
+  return true;
+}
+
+int64_t seekKey(const recordIndexEntry &entry, bool byTimecode) {
+  return byTimecode ? entry.timecode : entry.timestamp;
+}
+
+// Adds the entries mapped since the last call to the seek views. Capture
+// order is not key order: audio lands behind video, timecodes wrap or are
+// synthesized, and undefined timestamps are stored as INT64_MAX. New entries
+// are sorted on their own and merged in, which is linear when a growing
+// recording keeps its order.
+void indexSeekKeys(recordingPlayer *player) {
+  if (player->count < player->indexedCount) {
+    for (std::vector<size_t> &view : player->seekViews)
+      view.clear();
+    player->indexedCount = 0;
+  }
+  for (size_t v = 0; v < kSeekViews; v++) {
+    uint32_t type = (uint32_t)(v / 2);
+    bool byTimecode = v % 2 == 1;
+    std::vector<size_t> &view = player->seekViews[v];
+    size_t merged = view.size();
+    for (size_t i = player->indexedCount; i < player->count; i++) {
+      const recordIndexEntry &entry = player->entries[i];
+      if ((type == 0 || entry.type == type) &&
+          (byTimecode || entry.timestamp != NDIlib_recv_timestamp_undefined))
+        view.push_back(i);
+    }
+    const recordIndexEntry *entries = player->entries;
+    auto less = [entries, byTimecode](size_t a, size_t b) {
+      return seekKey(entries[a], byTimecode) < seekKey(entries[b], byTimecode);
+    };
+    auto middle = view.begin() + (ptrdiff_t)merged;
+    if (!std::is_sorted(middle, view.end(), less))
+      std::stable_sort(middle, view.end(), less);
+    std::inplace_merge(view.begin(), middle, view.end(), less);
+  }
+  player->indexedCount = player->count;
+}
+
+// Maps the sidecar index, or the index at the end of the recording when the
+// sidecar is missing. Entries whose records do not fit in the recording, as
+// when it was cut short, are left out.
+bool mapIndex(recordingPlayer *player, std::string *error) {
+  struct stat info;
+  if (fstat(player->fd, &info) != 0) {
+    *error = "Failed to read " + player->path + ": " + strerror(errno);
+    return false;
+  }
+  uint64_t dataSize = (uint64_t)info.st_size;
+
+  std::string indexPath = player->path + kRecordIndexSuffix;
+  int indexFd = open(indexPath.c_str(), O_RDONLY | O_CLOEXEC);
+  int mapFd = indexFd;
+  uint64_t mapOffset = 0;
+  uint64_t entriesOffset = 0;
+  uint64_t count = 0;
+  size_t mapSize = 0;
+  if (indexFd >= 0) {
+    if (fstat(indexFd, &info) != 0 ||
+        (uint64_t)info.st_size < sizeof(recordIndexHeader)) {
+      close(indexFd);
+      *error = indexPath + " is not a recording index.";
+      return false;
+    }
+    mapSize = (size_t)info.st_size;
+    entriesOffset = sizeof(recordIndexHeader);
+    count = (mapSize - entriesOffset) / sizeof(recordIndexEntry);
+  } else if (errno == ENOENT) {
+    recordFileHeader header;
+    if (!readAt(player->fd, &header, sizeof(header), 0)) {
+      *error = "Failed to read " + player->path + ".";
+      return false;
+    }
+    if (header.indexEntries == 0 || header.indexOffset < sizeof(header) ||
+        header.indexEntries > (dataSize - header.indexOffset) /
+                                   sizeof(recordIndexEntry)) {
+      *error = player->path + " has no index: it was not closed and " +
+               indexPath + " is missing.";
+      return false;
+    }
+    // mmap offsets must be page-aligned.
+    uint64_t page = (uint64_t)sysconf(_SC_PAGESIZE);
+    mapFd = player->fd;
+    mapOffset = header.indexOffset - header.indexOffset % page;
+    entriesOffset = header.indexOffset - mapOffset;
+    count = header.indexEntries;
+    mapSize = (size_t)(entriesOffset + count * sizeof(recordIndexEntry));
+  } else {
+    *error = "Failed to open " + indexPath + ": " + strerror(errno);
+    return false;
+  }
+
+  void *map =
+      mmap(nullptr, mapSize, PROT_READ, MAP_SHARED, mapFd, (off_t)mapOffset);
+  int mapErrno = errno;
+  if (indexFd >= 0)
+    close(indexFd);
+  if (map == MAP_FAILED) {
+    *error = "Failed to map the index of " + player->path + ": " +
+             strerror(mapErrno);
+    return false;
+  }
+  if (indexFd >= 0) {
+    const recordIndexHeader *header = (const recordIndexHeader *)map;
+    if (memcmp(header->magic, kRecordIndexMagic, sizeof(header->magic)) != 0 ||
+        header->version != kRecordVersion ||
+        header->headerBytes != sizeof(recordIndexHeader) ||
+        header->entryBytes != sizeof(recordIndexEntry)) {
+      munmap(map, mapSize);
+      *error = indexPath + " is not a recording index.";
+      return false;
+    }
+  }
+
+  const recordIndexEntry *entries =
+      (const recordIndexEntry *)((const uint8_t *)map + entriesOffset);
+  while (count > 0) {
+    const recordIndexEntry &last = entries[count - 1];
+    recordHeader header;
+    if (last.offset + sizeof(header) <= dataSize &&
+        readAt(player->fd, &header, sizeof(header), last.offset) &&
+        header.storedBytes <= dataSize - last.offset - sizeof(header))
+      break;
+    count--;
+  }
+  unmapIndex(player);
+  player->map = map;
+  player->mapSize = mapSize;
+  player->entries = entries;
+  player->count = (size_t)count;
+  player->sidecar = indexFd >= 0;
+  indexSeekKeys(player);
+  return true;
+}
+
+// Reads the frame rate of the first video record, which timecode text is
+// counted at.
+void probeFrameRate(recordingPlayer *player) {
+  size_t probes = 0;
+  for (size_t i = 0; i < player->count && probes < kFrameRateProbes; i++) {
+    if (player->entries[i].type != recordVideo)
+      continue;
+    probes++;
+    recordHeader header;
+    if (readAt(player->fd, &header, sizeof(header),
+               player->entries[i].offset) &&
+        header.type == recordVideo && header.frameRateN > 0 &&
+        header.frameRateD > 0) {
+      player->frameRateN = header.frameRateN;
+      player->frameRateD = header.frameRateD;
+      return;
+    }
+  }
+}
+
+// Position of the entry with the greatest key at or before target whose
+// type matches, where type 0 matches both, or -1. Of entries with equal
+// keys the last in the recording wins.
+int64_t findEntry(const recordingPlayer &player, bool byTimecode,
+                  int64_t target, uint32_t type) {
+  const std::vector<size_t> &view =
+      player.seekViews[type * 2 + (byTimecode ? 1 : 0)];
+  const recordIndexEntry *entries = player.entries;
+  auto upper = std::upper_bound(
+      view.begin(), view.end(), target,
+      [entries, byTimecode](int64_t value, size_t position) {
+        return value < seekKey(entries[position], byTimecode);
+      });
+  if (upper == view.begin())
+    return -1;
+  return (int64_t)upper[-1];
+}
+
+bool acquirePlayerFromThis(napi_env env, napi_value thisValue,
+                           nativeHandle **handle, recordingPlayer **player) {
+  napi_value embedded;
+  if (napi_get_named_property(env, thisValue, "embedded", &embedded) !=
+      napi_ok)
+    return false;
+  napi_valuetype type;
+  if (napi_typeof(env, embedded, &type) != napi_ok || type != napi_external)
+    return false;
+  void *externalData;
+  if (napi_get_value_external(env, embedded, &externalData) != napi_ok)
+    return false;
+  void *value;
+  if (!acquireNativeHandle((nativeHandle *)externalData, &value))
+    return false;
+  *handle = (nativeHandle *)externalData;
+  *player = (recordingPlayer *)value;
+  return true;
+}
+
+napi_status setLength(napi_env env, napi_value object, size_t count) {
+  napi_value value;
+  napi_status status = napi_create_double(env, (double)count, &value);
+  PASS_STATUS;
+  return napi_set_named_property(env, object, "length", value);
+}
+
+// Reads position from value, which must index an entry.
+bool readPosition(napi_env env, napi_value value, size_t count,
+                  size_t *position, std::string *error) {
+  napi_valuetype type;
+  double number = -1.0;
+  if (napi_typeof(env, value, &type) == napi_ok && type == napi_number)
+    napi_get_value_double(env, value, &number);
+  if (!(number >= 0.0 && number < (double)count) ||
+      number != (double)(size_t)number) {
+    *error = count > 0 ? "position must be an integer from 0 to " +
+                             std::to_string(count - 1) + "."
+                       : std::string("The recording has no frames.");
+    return false;
+  }
+  *position = (size_t)number;
+  return true;
+}
+
+napi_value playerEntry(napi_env env, napi_callback_info info) {
+  napi_status status;
+  size_t argc = 1;
+  napi_value args[1], thisValue;
+  status = napi_get_cb_info(env, info, &argc, args, &thisValue, nullptr);
+  CHECK_STATUS;
+
+  nativeHandle *handle = nullptr;
+  recordingPlayer *player = nullptr;
+  if (!acquirePlayerFromThis(env, thisValue, &handle, &player))
+    NAPI_THROW_ERROR("Recording has been destroyed.");
+  nativeHandleGuard guard(handle);
+
+  napi_value undefined;
+  status = napi_get_undefined(env, &undefined);
+  CHECK_STATUS;
+  size_t position = 0;
+  std::string error;
+  if (!readPosition(env, argc >= 1 ? args[0] : undefined, player->count,
+                    &position, &error))
+    NAPI_THROW_ERROR(error.c_str());
+  const recordIndexEntry &entry = player->entries[position];
+
+  napi_value result, value;
+  status = napi_create_object(env, &result);
+  CHECK_STATUS;
+  status = napi_create_double(env, (double)position, &value);
+  CHECK_STATUS;
+  status = napi_set_named_property(env, result, "position", value);
+  CHECK_STATUS;
+  status = napi_create_string_utf8(
+      env, entry.type == recordVideo ? "video" : "audio", NAPI_AUTO_LENGTH,
+      &value);
+  CHECK_STATUS;
+  status = napi_set_named_property(env, result, "type", value);
+  CHECK_STATUS;
+  status = napi_create_bigint_int64(env, entry.timestamp, &value);
+  CHECK_STATUS;
+  status = napi_set_named_property(env, result, "timestamp", value);
+  CHECK_STATUS;
+  status = napi_create_bigint_int64(env, entry.timecode, &value);
+  CHECK_STATUS;
+  status = napi_set_named_property(env, result, "timecode", value);
+  CHECK_STATUS;
+  status = napi_create_double(env, (double)entry.offset, &value);
+  CHECK_STATUS;
+  status = napi_set_named_property(env, result, "offset", value);
+  CHECK_STATUS;
+  return result;
+}
+
+// Reads the target of seek(): a timestamp, or a timecode as a bigint or as
+// SMPTE text at the recording's frame rate.
+bool readSeekTarget(napi_env env, napi_value target,
+                    const recordingPlayer &player, bool *byTimecode,
+                    int64_t *value, uint32_t *type, std::string *error) {
+  napi_valuetype valueType;
+  bool isArray = false;
+  if (napi_typeof(env, target, &valueType) != napi_ok ||
+      (valueType == napi_object &&
+       napi_is_array(env, target, &isArray) != napi_ok) ||
+      valueType != napi_object || isArray) {
+    *error = "Seek target must be an object.";
+    return false;
+  }
+
+  napi_value timestamp, timecode, frameType;
+  napi_valuetype timestampType, timecodeType, frameTypeType;
+  if (napi_get_named_property(env, target, "timestamp", &timestamp) !=
+          napi_ok ||
+      napi_get_named_property(env, target, "timecode", &timecode) !=
+          napi_ok ||
+      napi_get_named_property(env, target, "type", &frameType) != napi_ok ||
+      napi_typeof(env, timestamp, &timestampType) != napi_ok ||
+      napi_typeof(env, timecode, &timecodeType) != napi_ok ||
+      napi_typeof(env, frameType, &frameTypeType) != napi_ok) {
+    *error = "Failed to read the seek target.";
+    return false;
+  }
+  if ((timestampType == napi_undefined) == (timecodeType == napi_undefined)) {
+    *error = "Seek target must have either timestamp or timecode.";
+    return false;
+  }
+
+  *type = recordVideo;
+  if (frameTypeType != napi_undefined) {
+    char text[8] = {0};
+    size_t length = 0;
+    if (frameTypeType == napi_string)
+      napi_get_value_string_utf8(env, frameType, text, sizeof(text), &length);
+    if (strcmp(text, "video") == 0) {
+      *type = recordVideo;
+    } else if (strcmp(text, "audio") == 0) {
+      *type = recordAudio;
+    } else if (strcmp(text, "any") == 0) {
+      *type = 0;
+    } else {
+      *error = "type must be \"video\", \"audio\", or \"any\".";
+      return false;
+    }
+  }
+
+  *byTimecode = timestampType == napi_undefined;
+  napi_value key = *byTimecode ? timecode : timestamp;
+  napi_valuetype keyType = *byTimecode ? timecodeType : timestampType;
+  if (keyType == napi_bigint) {
+    bool lossless = false;
+    napi_get_value_bigint_int64(env, key, value, &lossless);
+    if (lossless)
+      return true;
+  } else if (*byTimecode && keyType == napi_string) {
+    char text[kTimecodeLength + 1] = {0};
+    size_t length = 0;
+    napi_get_value_string_utf8(env, key, text, sizeof(text), &length);
+    int64_t frames = 0;
+    if (player.frameRateN <= 0) {
+      *error = "The recording has no video frame rate to read timecode at.";
+      return false;
+    }
+    if (parseTimecodeText(text, player.frameRateN, player.frameRateD,
+                          &frames) &&
+        timecodeFromFrames(frames, player.frameRateN, player.frameRateD,
+                           value))
+      return true;
+    *error = "timecode must be \"HH:MM:SS:FF\" at the recording's rate.";
+    return false;
+  }
+  *error = *byTimecode ? "timecode must be a bigint or \"HH:MM:SS:FF\"."
+                       : "timestamp must be a bigint.";
+  return false;
+}
+
+napi_value playerSeek(napi_env env, napi_callback_info info) {
+  napi_status status;
+  size_t argc = 1;
+  napi_value args[1], thisValue;
+  status = napi_get_cb_info(env, info, &argc, args, &thisValue, nullptr);
+  CHECK_STATUS;
+
+  nativeHandle *handle = nullptr;
+  recordingPlayer *player = nullptr;
+  if (!acquirePlayerFromThis(env, thisValue, &handle, &player))
+    NAPI_THROW_ERROR("Recording has been destroyed.");
+  nativeHandleGuard guard(handle);
+
+  napi_value undefined;
+  status = napi_get_undefined(env, &undefined);
+  CHECK_STATUS;
+  bool byTimecode = false;
+  int64_t target = 0;
+  uint32_t type = recordVideo;
+  std::string error;
+  if (!readSeekTarget(env, argc >= 1 ? args[0] : undefined, *player,
+                      &byTimecode, &target, &type, &error))
+    NAPI_THROW_ERROR(error.c_str());
+
+  int64_t position = findEntry(*player, byTimecode, target, type);
+  if (position >= 0)
+    player->cursor = (size_t)position;
+  napi_value result;
+  status = napi_create_double(env, (double)position, &result);
+  CHECK_STATUS;
+  return result;
+}
+
+napi_value playerRefresh(napi_env env, napi_callback_info info) {
+  napi_status status;
+  size_t argc = 0;
+  napi_value thisValue;
+  status = napi_get_cb_info(env, info, &argc, nullptr, &thisValue, nullptr);
+  CHECK_STATUS;
+
+  nativeHandle *handle = nullptr;
+  recordingPlayer *player = nullptr;
+  if (!acquirePlayerFromThis(env, thisValue, &handle, &player))
+    NAPI_THROW_ERROR("Recording has been destroyed.");
+  nativeHandleGuard guard(handle);
+
+  // A closed recording's own index does not grow.
+  std::string error;
+  if (player->sidecar && !mapIndex(player, &error))
+    NAPI_THROW_ERROR(error.c_str());
+  if (player->frameRateN <= 0)
+    probeFrameRate(player);
+  status = setLength(env, thisValue, player->count);
+  CHECK_STATUS;
+
+  napi_value result;
+  status = napi_create_double(env, (double)player->count, &result);
+  CHECK_STATUS;
+  return result;
+}
+
+napi_value destroyPlayerValue(napi_env env, napi_callback_info info) {
+  bool success = false;
+  napi_value thisValue;
+  size_t argc = 0;
+  napi_value embedded;
+  napi_valuetype type;
+  void *externalData;
+  if (napi_get_cb_info(env, info, &argc, nullptr, &thisValue, nullptr) ==
+          napi_ok &&
+      napi_get_named_property(env, thisValue, "embedded", &embedded) ==
+          napi_ok &&
+      napi_typeof(env, embedded, &type) == napi_ok && type == napi_external &&
+      napi_get_value_external(env, embedded, &externalData) == napi_ok) {
+    success = closeNativeHandle((nativeHandle *)externalData);
+    napi_value value;
+    if (napi_create_int32(env, 0, &value) == napi_ok)
+      napi_set_named_property(env, thisValue, "embedded", value);
+  }
+
+  napi_value result;
+  if (napi_get_boolean(env, success, &result) != napi_ok)
+    napi_get_boolean(env, false, &result);
+  return result;
+}
+
+struct readCarrier : carrier {
+  nativeHandle *handle = nullptr;
+  int fd = -1;
+  std::string path;
+  recordIndexEntry entry = {};
+  recordHeader header = {};
+  ownedBuffer stored;
+  ownedBuffer data;
+  ~readCarrier() {
+    if (handle != nullptr)
+      releaseNativeHandle(handle);
+  }
+};
+
+// Splits LZ4 data into its stripes and decompresses each into c->data.
+bool decompressStripes(readCarrier *c) {
+  const recordHeader &header = c->header;
+  size_t tableBytes = (size_t)header.stripes * sizeof(uint32_t);
+  if (header.stripes == 0 || header.stripes > kMaxStripes ||
+      header.storedBytes < tableBytes)
+    return false;
+  const uint8_t *table = (const uint8_t *)c->stored.data;
+  const uint8_t *source = table + tableBytes;
+  const uint8_t *end = table + header.storedBytes;
+  uint8_t *output = (uint8_t *)c->data.data;
+  for (uint32_t i = 0; i < header.stripes; i++) {
+    uint32_t stored;
+    memcpy(&stored, table + i * sizeof(uint32_t), sizeof(stored));
+    size_t begin = header.rawBytes * i / header.stripes;
+    size_t size = header.rawBytes * (i + 1) / header.stripes - begin;
+    size_t storedSize = stored & ~kRecordStripeRaw;
+    bool raw = (stored & kRecordStripeRaw) != 0;
+    if (storedSize > (size_t)(end - source) || (raw && storedSize != size))
+      return false;
+    if (raw)
+      memcpy(output + begin, source, size);
+    else if (!lz4Decompress(source, storedSize, output + begin, size))
+      return false;
+    source += storedSize;
+  }
+  return source == end;
+}
+
+void readExecute(napi_env env, void *data) {
+  readCarrier *c = (readCarrier *)data;
+  std::string corrupt = "Record at offset " + std::to_string(c->entry.offset) +
+                        " of " + c->path + " is corrupt.";
+
+  recordHeader &header = c->header;
+  if (!readAt(c->fd, &header, sizeof(header), c->entry.offset) ||
+      header.type != c->entry.type || header.rawBytes > kMaxRecordBytes ||
+      header.storedBytes > kMaxRecordBytes + kMaxStripes * sizeof(uint32_t)) {
+    c->status = GRANDI_INVALID_ARGS;
+    c->errorMsg = corrupt;
+    return;
+  }
+  // The record must describe a frame whose data is exactly rawBytes long.
+  uint64_t expected = 0;
+  if (header.type == recordVideo) {
+    NDIlib_video_frame_v2_t frame{};
+    frame.FourCC = (NDIlib_FourCC_video_type_e)header.fourCC;
+    frame.xres = header.xres;
+    frame.yres = header.yres;
+    frame.line_stride_in_bytes = header.lineStride;
+    expected = header.xres > 0 && header.yres > 0 ? videoDataSize(frame) : 0;
+  } else if (header.channels > 0 && header.channelStride > 0 &&
+             header.samples > 0 &&
+             (uint64_t)header.samples * sizeof(float) <=
+                 (uint64_t)header.channelStride) {
+    expected = (uint64_t)header.channelStride * header.channels;
+  }
+  if (expected == 0 || expected != header.rawBytes) {
+    c->status = GRANDI_INVALID_ARGS;
+    c->errorMsg = corrupt;
+    return;
+  }
+
+  if (!c->data.allocate(header.rawBytes)) {
+    c->status = GRANDI_ALLOCATION_FAILURE;
+    c->errorMsg = "Failed to allocate a frame buffer.";
+    return;
+  }
+  uint64_t dataOffset = c->entry.offset + sizeof(header);
+  bool valid = false;
+  if (header.codec == recordUncompressed) {
+    valid = header.stripes == 0 && header.storedBytes == header.rawBytes &&
+            readAt(c->fd, c->data.data, header.rawBytes, dataOffset);
+  } else if (header.codec == recordLz4) {
+    if (!c->stored.allocate(header.storedBytes)) {
+      c->status = GRANDI_ALLOCATION_FAILURE;
+      c->errorMsg = "Failed to allocate a frame buffer.";
+      return;
+    }
+    valid = readAt(c->fd, c->stored.data, header.storedBytes, dataOffset) &&
+            decompressStripes(c);
+  }
+  if (!valid) {
+    c->status = GRANDI_INVALID_ARGS;
+    c->errorMsg = corrupt;
+  }
+}
+
+void readComplete(napi_env env, napi_status asyncStatus, void *data) {
+  readCarrier *c = (readCarrier *)data;
+
+  if (asyncStatus != napi_ok) {
+    c->status = asyncStatus;
+    c->errorMsg = "Async recording read failed to complete.";
+  }
+  REJECT_STATUS;
+
+  const recordHeader &header = c->header;
+  napi_value result, param;
+  if (header.type == recordVideo) {
+    NDIlib_video_frame_v2_t frame{};
+    frame.xres = header.xres;
+    frame.yres = header.yres;
+    frame.FourCC = (NDIlib_FourCC_video_type_e)header.fourCC;
+    frame.frame_rate_N = header.frameRateN;
+    frame.frame_rate_D = header.frameRateD;
+    frame.picture_aspect_ratio = header.pictureAspectRatio;
+    frame.frame_format_type =
+        (NDIlib_frame_format_type_e)header.frameFormatType;
+    frame.timecode = header.timecode;
+    frame.timestamp = header.timestamp;
+    frame.line_stride_in_bytes = header.lineStride;
+    c->status = createVideoFrameObject(env, frame, nullptr, &c->data, &result);
+    REJECT_STATUS;
+  } else {
+    c->status = napi_create_object(env, &result);
+    REJECT_STATUS;
+    c->status =
+        napi_create_string_utf8(env, "audio", NAPI_AUTO_LENGTH, &param);
+    REJECT_STATUS;
+    c->status = napi_set_named_property(env, result, "type", param);
+    REJECT_STATUS;
+    c->status =
+        napi_create_int32(env, Grandi_audio_format_float_32_separate, &param);
+    REJECT_STATUS;
+    c->status = napi_set_named_property(env, result, "audioFormat", param);
+    REJECT_STATUS;
+
+    const char *names[4] = {"sampleRate", "channels", "samples",
+                            "channelStrideInBytes"};
+    int32_t values[4] = {header.sampleRate, header.channels, header.samples,
+                         header.channelStride};
+    for (int i = 0; i < 4; i++) {
+      c->status = napi_create_int32(env, values[i], &param);
+      REJECT_STATUS;
+      c->status = napi_set_named_property(env, result, names[i], param);
+      REJECT_STATUS;
+    }
+
+    if (header.timestamp != NDIlib_recv_timestamp_undefined) {
+      c->status = napi_create_bigint_int64(env, header.timestamp, &param);
+      REJECT_STATUS;
+      c->status = napi_set_named_property(env, result, "timestamp", param);
+      REJECT_STATUS;
+    }
+    c->status = napi_create_bigint_int64(env, header.timecode, &param);
+    REJECT_STATUS;
+    c->status = napi_set_named_property(env, result, "timecode", param);
+    REJECT_STATUS;
+
+    c->status = createExternalBuffer(env, &c->data, &param);
+    REJECT_STATUS;
+    c->status = napi_set_named_property(env, result, "data", param);
+    REJECT_STATUS;
+  }
+
+  napi_status status = napi_resolve_deferred(env, c->_deferred, result);
+  FLOATING_STATUS;
+  tidyCarrier(env, c);
+}
+
+napi_value playerRead(napi_env env, napi_callback_info info) {
+  readCarrier *c = createCarrier<readCarrier>(env);
+  if (c == nullptr)
+    return nullptr;
+
+  napi_value promise;
+  c->status = napi_create_promise(env, &c->_deferred, &promise);
+  REJECT_RETURN;
+
+  size_t argc = 1;
+  napi_value args[1], thisValue;
+  c->status = napi_get_cb_info(env, info, &argc, args, &thisValue, nullptr);
+  REJECT_RETURN;
+  recordingPlayer *player = nullptr;
+  if (!acquirePlayerFromThis(env, thisValue, &c->handle, &player))
+    REJECT_ERROR_RETURN("Recording has been destroyed.", GRANDI_INVALID_ARGS);
+
+  size_t position = player->cursor;
+  napi_valuetype type = napi_undefined;
+  if (argc >= 1) {
+    c->status = napi_typeof(env, args[0], &type);
+    REJECT_RETURN;
+  }
+  if (type != napi_undefined) {
+    if (!readPosition(env, args[0], player->count, &position, &c->errorMsg))
+      REJECT_ERROR_RETURN(c->errorMsg, GRANDI_INVALID_ARGS);
+  } else if (position >= player->count) {
+    REJECT_ERROR_RETURN("End of recording.", GRANDI_OUT_OF_RANGE);
+  }
+  c->entry = player->entries[position];
+  c->fd = player->fd;
+  c->path = player->path;
+  player->cursor = position + 1;
+
+  napi_value resource_name;
+  c->status = napi_create_string_utf8(env, "RecordingRead", NAPI_AUTO_LENGTH,
+                                      &resource_name);
+  REJECT_RETURN;
+  c->status = napi_create_async_work(env, NULL, resource_name, readExecute,
+                                     readComplete, c, &c->_request);
+  REJECT_RETURN;
+  napi_status status = napi_queue_async_work(env, c->_request);
+  if (status != napi_ok) {
+    c->status = status;
+    REJECT_RETURN;
+  }
+  return promise;
+}
+
+struct openCarrier : carrier {
+  recordingPlayer *player = nullptr;
+  ~openCarrier() {
+    if (player != nullptr)
+      destroyPlayer(player);
+  }
+};
+
+void openExecute(napi_env env, void *data) {
+  openCarrier *c = (openCarrier *)data;
+  recordingPlayer *player = c->player;
+
+  player->fd = open(player->path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (player->fd < 0) {
+    c->status = GRANDI_INVALID_ARGS;
+    c->errorMsg = "Failed to open " + player->path + ": " + strerror(errno);
+    return;
+  }
+  recordFileHeader header;
+  if (!readAt(player->fd, &header, sizeof(header), 0) ||
+      memcmp(header.magic, kRecordMagic, sizeof(header.magic)) != 0) {
+    c->status = GRANDI_INVALID_ARGS;
+    c->errorMsg = player->path + " is not a recording.";
+    return;
+  }
+  if (header.version != kRecordVersion ||
+      header.headerBytes != sizeof(header)) {
+    c->status = GRANDI_INVALID_ARGS;
+    c->errorMsg = player->path + " is a recording of an unsupported version.";
+    return;
+  }
+  if (!mapIndex(player, &c->errorMsg)) {
+    c->status = GRANDI_INVALID_ARGS;
+    return;
+  }
+  probeFrameRate(player);
+}
+
+void openComplete(napi_env env, napi_status asyncStatus, void *data) {
+  openCarrier *c = (openCarrier *)data;
+
+  if (asyncStatus != napi_ok) {
+    c->status = asyncStatus;
+    c->errorMsg = "Async recording open failed to complete.";
+  }
+  REJECT_STATUS;
+
+  recordingPlayer *player = c->player;
+  napi_value result, embedded, value;
+  c->status = napi_create_object(env, &result);
+  REJECT_STATUS;
+  nativeHandle *handle = createNativeHandle(player, destroyPlayer);
+  if (handle == nullptr) {
+    c->status = GRANDI_ALLOCATION_FAILURE;
+    c->errorMsg = "Failed to allocate recording handle.";
+    REJECT_STATUS;
+  }
+  c->player = nullptr;
+  c->status = napi_create_external(env, handle, finalizeNativeHandle, nullptr,
+                                   &embedded);
+  if (c->status != napi_ok) {
+    closeNativeHandle(handle);
+    delete handle;
+    REJECT_STATUS;
+  }
+  c->status = napi_set_named_property(env, result, "embedded", embedded);
+  REJECT_STATUS;
+
+  c->status = napi_create_string_utf8(env, player->path.c_str(),
+                                      NAPI_AUTO_LENGTH, &value);
+  REJECT_STATUS;
+  c->status = napi_set_named_property(env, result, "path", value);
+  REJECT_STATUS;
+  c->status = setLength(env, result, player->count);
+  REJECT_STATUS;
+  c->status = napi_get_boolean(env, player->sidecar, &value);
+  REJECT_STATUS;
+  c->status = napi_set_named_property(env, result, "sidecar", value);
+  REJECT_STATUS;
+
+  struct {
+    const char *name;
+    napi_callback callback;
+  } methods[] = {
+      {"entry", playerEntry},     {"seek", playerSeek},
+      {"read", playerRead},       {"refresh", playerRefresh},
+      {"destroy", destroyPlayerValue},
+  };
+  for (auto &method : methods) {
+    c->status = napi_create_function(env, method.name, NAPI_AUTO_LENGTH,
+                                     method.callback, nullptr, &value);
+    REJECT_STATUS;
+    c->status = napi_set_named_property(env, result, method.name, value);
+    REJECT_STATUS;
+  }
+
+  napi_status status = napi_resolve_deferred(env, c->_deferred, result);
+  FLOATING_STATUS;
+  tidyCarrier(env, c);
+}
+} // namespace
+
+napi_value openRecording(napi_env env, napi_callback_info info) {
+  openCarrier *c = createCarrier<openCarrier>(env);
+  if (c == nullptr)
+    return nullptr;
+
+  napi_value promise;
+  c->status = napi_create_promise(env, &c->_deferred, &promise);
+  REJECT_RETURN;
+
+  size_t argc = 1;
+  napi_value options;
+  c->status = napi_get_cb_info(env, info, &argc, &options, nullptr, nullptr);
+  REJECT_RETURN;
+  napi_valuetype type = napi_undefined;
+  bool isArray = false;
+  if (argc >= 1) {
+    c->status = napi_typeof(env, options, &type);
+    REJECT_RETURN;
+    c->status = napi_is_array(env, options, &isArray);
+    REJECT_RETURN;
+  }
+  if (type != napi_object || isArray)
+    REJECT_ERROR_RETURN("Recording options must be an object.",
+                        GRANDI_INVALID_ARGS);
+  napi_value pathValue;
+  c->status = napi_get_named_property(env, options, "path", &pathValue);
+  REJECT_RETURN;
+  c->status = napi_typeof(env, pathValue, &type);
+  REJECT_RETURN;
+  std::unique_ptr<char[]> path;
+  if (type == napi_string && !readUtf8String(env, pathValue, &path, c))
+    REJECT_RETURN;
+  if (type != napi_string || path[0] == '\0')
+    REJECT_ERROR_RETURN("path must be a non-empty string.",
+                        GRANDI_INVALID_ARGS);
+
+  c->player = new (std::nothrow) recordingPlayer;
+  if (c->player == nullptr)
+    REJECT_ERROR_RETURN("Failed to allocate recording.",
+                        GRANDI_ALLOCATION_FAILURE);
+  c->player->path = path.get();
+
+  napi_value resource_name;
+  c->status = napi_create_string_utf8(env, "OpenRecording", NAPI_AUTO_LENGTH,
+                                      &resource_name);
+  REJECT_RETURN;
+  c->status = napi_create_async_work(env, NULL, resource_name, openExecute,
+                                     openComplete, c, &c->_request);
+  REJECT_RETURN;
+  // Execute can fail before napi_queue_async_work returns, so its result
+  // must not overwrite c->status.
+  napi_status status = napi_queue_async_work(env, c->_request);
+  if (status != napi_ok) {
+    c->status = status;
+    REJECT_RETURN;
+  }
+  return promise;
+}
+
+#endif // _WIN32
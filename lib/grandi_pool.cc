@@ -0,0 +1,225 @@
+/* Copyright 2025 Sarhan Aissi <github@tux.tn>.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+*/
+
+#include <algorithm>
+
+#include "grandi_pool.h"
+#include "grandi_util.h"
+
+namespace {
+// Stripes per thread, so threads that finish early can take over the rest
+// of a slow one's share.
+const size_t kStripesPerThread = 4;
+
+threadRole sharedRole() {
+  threadRole role;
+  role.role = "pool";
+  role.owner = "shared";
+  return role;
+}
+
+struct stripeBatch {
+  stripeFunction fn;
+  void *context;
+  size_t rows;
+  size_t stripes;
+};
+
+void runStripe(void *context, size_t index) {
+  stripeBatch *batch = (stripeBatch *)context;
+  batch->fn(batch->context, index, batch->rows * index / batch->stripes,
+            batch->rows * (index + 1) / batch->stripes);
+}
+
+} // namespace
+
+workerPool::~workerPool() { stop(); }
+
+void workerPool::start(size_t threads, const threadRole &role) {
+  std::lock_guard<std::mutex> guard(control);
+  stopWorkers();
+  this->role = role;
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopping = false;
+  }
+  for (size_t i = 1; i < threads; i++)
+    workers.emplace_back(&workerPool::work, this);
+  workerCount.store(workers.size());
+}
+
+void workerPool::stop() {
+  std::lock_guard<std::mutex> guard(control);
+  stopWorkers();
+}
+
+void workerPool::stopWorkers() {
+  workerCount.store(0);
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopping = true;
+  }
+  wake.notify_all();
+  for (auto &worker : workers) {
+    if (worker.joinable())
+      worker.join();
+  }
+  workers.clear();
+}
+
+void workerPool::drain(batch &current) {
+  while (true) {
+    size_t index = current.next.fetch_add(1, std::memory_order_relaxed);
+    if (index >= current.count)
+      return;
+    current.fn(current.context, index);
+  }
+}
+
+// Takes a batch whose tasks have all been claimed off the open list, so no
+// more workers join it. Called with mutex held.
+void workerPool::close(batch *closing) {
+  if (!closing->open)
+    return;
+  closing->open = false;
+  for (batch **link = &head; *link != nullptr; link = &(*link)->link) {
+    if (*link == closing) {
+      *link = closing->link;
+      break;
+    }
+  }
+}
+
+void workerPool::work() {
+  threadRegistration registration(role);
+  std::unique_lock<std::mutex> lock(mutex);
+  while (true) {
+    wake.wait(lock, [&] { return stopping || head != nullptr; });
+    if (stopping)
+      return;
+    batch *current = head;
+    current->visitors++;
+    lock.unlock();
+    drain(*current);
+    lock.lock();
+    close(current);
+    if (--current->visitors == 0)
+      done.notify_all();
+  }
+}
+
+void workerPool::run(size_t count, task fn, void *context) {
+  if (count == 0)
+    return;
+  if (workerCount.load() == 0 || count == 1) {
+    for (size_t i = 0; i < count; i++)
+      fn(context, i);
+    return;
+  }
+  batch current;
+  current.fn = fn;
+  current.context = context;
+  current.count = count;
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    current.open = true;
+    batch **link = &head;
+    while (*link != nullptr)
+      link = &(*link)->link;
+    *link = &current;
+  }
+  if (count - 1 < workerCount.load())
+    for (size_t i = 0; i < count - 1; i++)
+      wake.notify_one();
+  else
+    wake.notify_all();
+  drain(current);
+  // Workers that joined may still be finishing their last task, and the
+  // batch lives on this stack until they have.
+  std::unique_lock<std::mutex> lock(mutex);
+  close(&current);
+  done.wait(lock, [&] { return current.visitors == 0; });
+}
+
+workerPool &sharedPool() {
+  // Never destroyed: workers may still be parked when the process exits.
+  static workerPool *pool = [] {
+    workerPool *created = new workerPool;
+    created->start(std::max<size_t>(
+                       1, std::min<size_t>(std::thread::hardware_concurrency(),
+                                           kDefaultSharedThreads)),
+                   sharedRole());
+    return created;
+  }();
+  return *pool;
+}
+
+size_t stripeCount(const workerPool &pool, size_t rows, size_t minRows) {
+  return std::max<size_t>(
+      1, std::min({rows / std::max<size_t>(minRows, 1),
+                   pool.size() * kStripesPerThread, kMaxPoolStripes}));
+}
+
+void runStripes(workerPool &pool, size_t rows, size_t stripes,
+                stripeFunction fn, void *context) {
+  if (rows == 0)
+    return;
+  stripes = std::max<size_t>(1, std::min(stripes, rows));
+  if (stripes == 1) {
+    fn(context, 0, 0, rows);
+    return;
+  }
+  stripeBatch batch = {fn, context, rows, stripes};
+  pool.run(stripes, runStripe, &batch);
+}
+
+napi_value workerThreads(napi_env env, napi_callback_info info) {
+  napi_value result;
+  napi_status status =
+      napi_create_uint32(env, (uint32_t)sharedPool().size(), &result);
+  CHECK_STATUS;
+  return result;
+}
+
+napi_value setWorkerThreads(napi_env env, napi_callback_info info) {
+  napi_status status;
+  size_t argc = 2;
+  napi_value args[2];
+  status = napi_get_cb_info(env, info, &argc, args, nullptr, nullptr);
+  CHECK_STATUS;
+  if (argc < 1)
+    NAPI_THROW_ERROR("threads must be provided.");
+
+  uint32_t threads = 0;
+  std::string error;
+  status = parseUint32Value(env, args[0], "threads", &threads, &error);
+  CHECK_STATUS;
+  if (!error.empty() || threads < 1 || threads > kMaxSharedThreads)
+    NAPI_THROW_ERROR("threads must be an integer between 1 and 256.");
+
+  threadRole role = sharedRole();
+  if (argc >= 2) {
+    status = parseThreadPlacementValue(env, args[1], &role.placement, &error);
+    CHECK_STATUS;
+    if (!error.empty())
+      NAPI_THROW_ERROR(error.c_str());
+  }
+  sharedPool().start(threads, role);
+
+  napi_value result;
+  status = napi_get_undefined(env, &result);
+  CHECK_STATUS;
+  return result;
+}
@@ -0,0 +1,108 @@
+/* Copyright 2025 Sarhan Aissi <github@tux.tn>.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+*/
+
+#ifndef GRANDI_POOL_H
+#define GRANDI_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "node_api.h"
+#include "grandi_thread.h"
+
+// Fixed set of worker threads that run batches of independent tasks. Any
+// number of threads may run batches at once: each caller works through its
+// own batch, and idle workers take tasks from the oldest batch that still
+// has some, so a caller with a large batch borrows whatever capacity the
+// others leave unused. A pool of one thread runs tasks inline. Batches do
+// not allocate.
+class workerPool {
+public:
+  typedef void (*task)(void *context, size_t index);
+
+  workerPool() = default;
+  ~workerPool();
+  workerPool(const workerPool &) = delete;
+  workerPool &operator=(const workerPool &) = delete;
+
+  // Starts threads - 1 workers, replacing any running ones. Batches running
+  // meanwhile still finish, on their callers' threads. Workers register
+  // under role and apply its placement.
+  void start(size_t threads, const threadRole &role = threadRole());
+  void stop();
+  size_t size() const { return workerCount.load() + 1; }
+
+  // Calls fn(context, i) for every i below count and returns once all calls
+  // have finished.
+  void run(size_t count, task fn, void *context);
+
+private:
+  struct batch {
+    task fn = nullptr;
+    void *context = nullptr;
+    size_t count = 0;
+    std::atomic<size_t> next{0};
+    // Guarded by mutex.
+    size_t visitors = 0;
+    bool open = false;
+    batch *link = nullptr;
+  };
+
+  void work();
+  void stopWorkers();
+  void close(batch *closing);
+  static void drain(batch &current);
+
+  std::mutex control;
+  // Set under control while no workers run.
+  threadRole role;
+  std::vector<std::thread> workers;
+  std::atomic<size_t> workerCount{0};
+  std::mutex mutex;
+  std::condition_variable wake;
+  std::condition_variable done;
+  bool stopping = false;
+  // Open batches, oldest first.
+  batch *head = nullptr;
+};
+
+// Process-wide pool the frame processing stages split their rows over. It
+// starts on first use with one thread per CPU, up to kDefaultSharedThreads.
+const size_t kDefaultSharedThreads = 16;
+const size_t kMaxSharedThreads = 256;
+workerPool &sharedPool();
+
+typedef void (*stripeFunction)(void *context, size_t stripe, size_t begin,
+                               size_t end);
+const size_t kMaxPoolStripes = 64;
+// Stripes of at least minRows rows that keep every thread of pool busy, up
+// to kMaxPoolStripes. Callers with per-stripe scratch space size it from
+// this before calling runStripes().
+size_t stripeCount(const workerPool &pool, size_t rows, size_t minRows);
+// Calls fn(context, stripe, begin, end) for each of stripes even slices of
+// rows on pool. A single stripe runs inline.
+void runStripes(workerPool &pool, size_t rows, size_t stripes,
+                stripeFunction fn, void *context);
+
+// Exposed as workerThreads() and setWorkerThreads(threads, scheduling).
+napi_value workerThreads(napi_env env, napi_callback_info info);
+napi_value setWorkerThreads(napi_env env, napi_callback_info info);
+
+#endif /* GRANDI_POOL_H */
@@ -0,0 +1,515 @@
+/* Copyright 2025 Sarhan Aissi <github@tux.tn>.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+*/
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <string>
+
+#include <Processing.NDI.Lib.h>
+
+#include "grandi_quality.h"
+#include "grandi_fields.h"
+#include "grandi_simd.h"
+#include "grandi_util.h"
+
+namespace {
+// One compared channel: samples at offset + step * x along each line of a
+// plane, one per `divisor` pixels. Offsets and steps count samples, so bytes
+// for 8-bit formats and words for 16-bit ones.
+struct qualityChannel {
+  const char *name;
+  int plane;
+  size_t offset;
+  size_t step;
+  int divisor;
+};
+
+const qualityChannel kUyvyChannels[3] = {
+    {"y", 0, 1, 2, 1}, {"cb", 0, 0, 4, 2}, {"cr", 0, 2, 4, 2}};
+const qualityChannel kP216Channels[3] = {
+    {"y", 0, 0, 1, 1}, {"cb", 1, 0, 2, 2}, {"cr", 1, 1, 2, 2}};
+const qualityChannel kBgraChannels[3] = {
+    {"r", 0, 2, 4, 1}, {"g", 0, 1, 4, 1}, {"b", 0, 0, 4, 1}};
+const qualityChannel kRgbaChannels[3] = {
+    {"r", 0, 0, 4, 1}, {"g", 0, 1, 4, 1}, {"b", 0, 2, 4, 1}};
+
+// Frames compare when they share a color model; alpha is ignored, so UYVY
+// compares with UYVA and BGRA with RGBX.
+enum class colorModel { none, yuv8, yuv16, rgb };
+
+colorModel describeChannels(NDIlib_FourCC_video_type_e fourCC,
+                            const qualityChannel **channels) {
+  switch (fourCC) {
+  case NDIlib_FourCC_type_UYVY:
+  case NDIlib_FourCC_type_UYVA:
+    *channels = kUyvyChannels;
+    return colorModel::yuv8;
+  case NDIlib_FourCC_type_P216:
+  case NDIlib_FourCC_type_PA16:
+    *channels = kP216Channels;
+    return colorModel::yuv16;
+  case NDIlib_FourCC_type_BGRA:
+  case NDIlib_FourCC_type_BGRX:
+    *channels = kBgraChannels;
+    return colorModel::rgb;
+  case NDIlib_FourCC_type_RGBA:
+  case NDIlib_FourCC_type_RGBX:
+    *channels = kRgbaChannels;
+    return colorModel::rgb;
+  default:
+    return colorModel::none;
+  }
+}
+
+struct qualityFrame {
+  int32_t xres = 0;
+  int32_t yres = 0;
+  int32_t fourCC = 0;
+  int32_t lineStride = 0;
+  const uint8_t *data = nullptr;
+  size_t length = 0;
+  frameLayout layout;
+  colorModel model = colorModel::none;
+  const qualityChannel *channels = nullptr;
+};
+
+napi_status readInt32Property(napi_env env, napi_value object,
+                              const char *name, int32_t *result,
+                              std::string *error) {
+  napi_status status;
+  napi_value value;
+  status = napi_get_named_property(env, object, name, &value);
+  PASS_STATUS;
+  napi_valuetype type;
+  status = napi_typeof(env, value, &type);
+  PASS_STATUS;
+  if (type != napi_number) {
+    *error = std::string(name) + " value must be a number";
+    return napi_ok;
+  }
+  return napi_get_value_int32(env, value, result);
+}
+
+// Reads a video frame object and its data buffer. Invalid frames set error.
+napi_status readQualityFrame(napi_env env, napi_value value,
+                             qualityFrame *frame, napi_value *data,
+                             std::string *error) {
+  napi_status status;
+  napi_valuetype type;
+  bool isArray;
+  status = napi_typeof(env, value, &type);
+  PASS_STATUS;
+  status = napi_is_array(env, value, &isArray);
+  PASS_STATUS;
+  if (type != napi_object || isArray) {
+    *error = "frame must be an object";
+    return napi_ok;
+  }
+
+  const char *names[] = {"xres", "yres", "fourCC", "lineStrideBytes"};
+  int32_t *targets[] = {&frame->xres, &frame->yres, &frame->fourCC,
+                        &frame->lineStride};
+  for (size_t i = 0; i < 4; i++) {
+    status = readInt32Property(env, value, names[i], targets[i], error);
+    PASS_STATUS;
+    if (!error->empty())
+      return napi_ok;
+  }
+  if (frame->xres <= 0 || frame->yres <= 0) {
+    *error = "xres and yres must be positive.";
+    return napi_ok;
+  }
+  if (frame->lineStride < 0) {
+    *error = "lineStrideBytes must be >= 0.";
+    return napi_ok;
+  }
+
+  NDIlib_FourCC_video_type_e fourCC = (NDIlib_FourCC_video_type_e)frame->fourCC;
+  frame->model = describeChannels(fourCC, &frame->channels);
+  int minStride = defaultLineStride(fourCC, frame->xres);
+  if (frame->lineStride == 0)
+    frame->lineStride = minStride;
+  if (frame->model == colorModel::none ||
+      !describeFrame(fourCC, frame->lineStride, (size_t)frame->yres,
+                     &frame->layout)) {
+    *error = "fourCC is not supported for frame comparison.";
+    return napi_ok;
+  }
+  if (frame->lineStride < minStride) {
+    *error = "lineStrideBytes is too small for the given fourCC/xres.";
+    return napi_ok;
+  }
+
+  bool isBuffer;
+  status = napi_get_named_property(env, value, "data", data);
+  PASS_STATUS;
+  status = napi_is_buffer(env, *data, &isBuffer);
+  PASS_STATUS;
+  if (!isBuffer) {
+    *error = "data must be provided as a Node Buffer";
+    return napi_ok;
+  }
+  void *bytes;
+  status = napi_get_buffer_info(env, *data, &bytes, &frame->length);
+  PASS_STATUS;
+  frame->data = (const uint8_t *)bytes;
+  if (frame->length < frame->layout.size)
+    *error = "Video frame data buffer is smaller than required for the given "
+             "frame layout.";
+  return napi_ok;
+}
+
+// Copies one channel into a packed plane of width samples per line.
+template <typename T>
+void extractChannel(const qualityFrame &frame, const qualityChannel &channel,
+                    size_t width, T *dst) {
+  const uint8_t *plane = frame.data + frame.layout.offset[channel.plane];
+  size_t stride = frame.layout.stride[channel.plane];
+  for (size_t y = 0; y < (size_t)frame.yres; y++) {
+    const T *line = (const T *)(plane + y * stride) + channel.offset;
+    T *out = dst + y * width;
+    if (channel.step == 1) {
+      memcpy(out, line, width * sizeof(T));
+      continue;
+    }
+    for (size_t x = 0; x < width; x++)
+      out[x] = line[x * channel.step];
+  }
+}
+
+uint64_t squaredError(const uint8_t *a, const uint8_t *b, size_t count) {
+  return squaredErrorBytes(a, b, count);
+}
+uint64_t squaredError(const uint16_t *a, const uint16_t *b, size_t count) {
+  return squaredErrorWords(a, b, count);
+}
+
+// Sums of a, b, a^2 + b^2, and a * b over each 4x4 block of one block row.
+// Doubles hold the sums of 16-bit samples exactly.
+void blockSums(const uint8_t *a, const uint8_t *b, size_t stride,
+               size_t blocks, double (*sums)[4]) {
+  const size_t kChunk = 64;
+  uint32_t chunk[kChunk][4];
+  for (size_t first = 0; first < blocks; first += kChunk) {
+    size_t count = blocks - first < kChunk ? blocks - first : kChunk;
+    ssimBlockSums(a + first * 4, b + first * 4, stride, count, chunk);
+    for (size_t i = 0; i < count; i++)
+      for (int k = 0; k < 4; k++)
+        sums[first + i][k] = chunk[i][k];
+  }
+}
+
+void blockSums(const uint16_t *a, const uint16_t *b, size_t stride,
+               size_t blocks, double (*sums)[4]) {
+  for (size_t block = 0; block < blocks; block++) {
+    uint64_t s1 = 0, s2 = 0, ss = 0, s12 = 0;
+    for (size_t line = 0; line < 4; line++)
+      for (size_t x = block * 4; x < block * 4 + 4; x++) {
+        uint64_t left = a[line * stride + x], right = b[line * stride + x];
+        s1 += left;
+        s2 += right;
+        ss += left * left + right * right;
+        s12 += left * right;
+      }
+    sums[block][0] = (double)s1;
+    sums[block][1] = (double)s2;
+    sums[block][2] = (double)ss;
+    sums[block][3] = (double)s12;
+  }
+}
+
+// SSIM of one window of n samples from its sums, with the usual constants
+// (0.01 and 0.03 of the peak) scaled to sums and sample variances.
+double windowSsim(double s1, double s2, double ss, double s12, double n,
+                  double peak) {
+  double c1 = 0.0001 * peak * peak * n * n;
+  double c2 = 0.0009 * peak * peak * n * (n - 1);
+  double vars = ss * n - s1 * s1 - s2 * s2;
+  double covar = s12 * n - s1 * s2;
+  return (2 * s1 * s2 + c1) * (2 * covar + c2) /
+         ((s1 * s1 + s2 * s2 + c1) * (vars + c2));
+}
+
+// Mean SSIM over 8x8 windows at a 4-sample step, built from 4x4 block sums
+// like x264 does, or over the whole plane when it is smaller than a window.
+// Returns false when the block rows cannot be allocated.
+template <typename T>
+bool planeSsim(const T *a, const T *b, size_t width, size_t height,
+               double peak, double *result) {
+  size_t blocksX = width / 4, blocksY = height / 4;
+  if (blocksX < 2 || blocksY < 2) {
+    double s1 = 0, s2 = 0, ss = 0, s12 = 0;
+    for (size_t i = 0; i < width * height; i++) {
+      double left = a[i], right = b[i];
+      s1 += left;
+      s2 += right;
+      ss += left * left + right * right;
+      s12 += left * right;
+    }
+    double n = (double)(width * height);
+    *result = n > 1 ? windowSsim(s1, s2, ss, s12, n, peak) : 1.0;
+    return true;
+  }
+
+  ownedBuffer rows;
+  if (!rows.allocate(blocksX * 2 * sizeof(double[4])))
+    return false;
+  double(*top)[4] = (double(*)[4])rows.data;
+  double(*bottom)[4] = top + blocksX;
+  blockSums(a, b, width, blocksX, top);
+  double total = 0;
+  for (size_t y = 1; y < blocksY; y++) {
+    blockSums(a + y * 4 * width, b + y * 4 * width, width, blocksX, bottom);
+    for (size_t x = 0; x + 1 < blocksX; x++) {
+      double s[4];
+      for (int k = 0; k < 4; k++)
+        s[k] = top[x][k] + top[x + 1][k] + bottom[x][k] + bottom[x + 1][k];
+      total += windowSsim(s[0], s[1], s[2], s[3], 64, peak);
+    }
+    double(*swap)[4] = top;
+    top = bottom;
+    bottom = swap;
+  }
+  *result = total / (double)((blocksX - 1) * (blocksY - 1));
+  return true;
+}
+
+struct channelQuality {
+  const char *name = nullptr;
+  uint64_t samples = 0;
+  uint64_t squaredError = 0;
+  double ssim = 1.0;
+};
+
+struct compareCarrier : carrier {
+  qualityFrame reference;
+  qualityFrame test;
+  bool ssim = true;
+  double peak = 255.0;
+  channelQuality channels[3];
+};
+
+template <typename T> bool compareChannels(compareCarrier *c) {
+  size_t xres = (size_t)c->reference.xres, yres = (size_t)c->reference.yres;
+  ownedBuffer left, right;
+  for (int i = 0; i < 3; i++) {
+    const qualityChannel &reference = c->reference.channels[i];
+    const qualityChannel &test = c->test.channels[i];
+    channelQuality &result = c->channels[i];
+    size_t width = xres / (size_t)reference.divisor;
+    result.name = reference.name;
+    result.samples = width * yres;
+    if (result.samples == 0)
+      continue;
+    if (left.size < result.samples * sizeof(T)) {
+      if (!left.allocate(result.samples * sizeof(T)) ||
+          !right.allocate(result.samples * sizeof(T)))
+        return false;
+    }
+    T *a = (T *)left.data, *b = (T *)right.data;
+    extractChannel(c->reference, reference, width, a);
+    extractChannel(c->test, test, width, b);
+    result.squaredError = squaredError(a, b, result.samples);
+    if (c->ssim && !planeSsim(a, b, width, yres, c->peak, &result.ssim))
+      return false;
+  }
+  return true;
+}
+
+void compareExecute(napi_env env, void *data) {
+  compareCarrier *c = (compareCarrier *)data;
+  bool done = c->reference.model == colorModel::yuv16
+                  ? compareChannels<uint16_t>(c)
+                  : compareChannels<uint8_t>(c);
+  if (!done) {
+    c->status = GRANDI_ALLOCATION_FAILURE;
+    c->errorMsg = "Failed to allocate frame comparison buffers.";
+  }
+}
+
+// PSNR in dB of a mean squared error, or Infinity for identical samples.
+double psnr(double mse, double peak) {
+  if (mse <= 0)
+    return std::numeric_limits<double>::infinity();
+  return 10.0 * std::log10(peak * peak / mse);
+}
+
+napi_status setQuality(napi_env env, napi_value object, double mse,
+                       double peak, bool ssim, double ssimValue) {
+  napi_status status;
+  napi_value value;
+  status = napi_create_double(env, mse, &value);
+  PASS_STATUS;
+  status = napi_set_named_property(env, object, "mse", value);
+  PASS_STATUS;
+  status = napi_create_double(env, psnr(mse, peak), &value);
+  PASS_STATUS;
+  status = napi_set_named_property(env, object, "psnr", value);
+  PASS_STATUS;
+  if (!ssim)
+    return napi_ok;
+  status = napi_create_double(env, ssimValue, &value);
+  PASS_STATUS;
+  return napi_set_named_property(env, object, "ssim", value);
+}
+
+void compareComplete(napi_env env, napi_status asyncStatus, void *data) {
+  compareCarrier *c = (compareCarrier *)data;
+
+  if (asyncStatus != napi_ok) {
+    c->status = asyncStatus;
+    c->errorMsg = "Async frame comparison failed to complete.";
+  }
+  REJECT_STATUS;
+
+  napi_value result, channels, value;
+  c->status = napi_create_object(env, &result);
+  REJECT_STATUS;
+  c->status = napi_create_array(env, &channels);
+  REJECT_STATUS;
+
+  // Whole-frame figures weight each channel by its sample count.
+  uint64_t samples = 0, squaredError = 0;
+  double ssim = 0;
+  uint32_t index = 0;
+  for (channelQuality &channel : c->channels) {
+    if (channel.samples == 0)
+      continue;
+    samples += channel.samples;
+    squaredError += channel.squaredError;
+    ssim += channel.ssim * (double)channel.samples;
+
+    napi_value entry;
+    c->status = napi_create_object(env, &entry);
+    REJECT_STATUS;
+    c->status =
+        napi_create_string_utf8(env, channel.name, NAPI_AUTO_LENGTH, &value);
+    REJECT_STATUS;
+    c->status = napi_set_named_property(env, entry, "name", value);
+    REJECT_STATUS;
+    c->status = setQuality(env, entry,
+                           (double)channel.squaredError /
+                               (double)channel.samples,
+                           c->peak, c->ssim, channel.ssim);
+    REJECT_STATUS;
+    c->status = napi_set_element(env, channels, index++, entry);
+    REJECT_STATUS;
+  }
+
+  c->status = setQuality(env, result,
+                         (double)squaredError / (double)samples, c->peak,
+                         c->ssim, ssim / (double)samples);
+  REJECT_STATUS;
+  c->status = napi_set_named_property(env, result, "channels", channels);
+  REJECT_STATUS;
+  c->status = napi_create_double(env, c->peak, &value);
+  REJECT_STATUS;
+  c->status = napi_set_named_property(env, result, "peak", value);
+  REJECT_STATUS;
+
+  napi_status status = napi_resolve_deferred(env, c->_deferred, result);
+  FLOATING_STATUS;
+  tidyCarrier(env, c);
+}
+} // namespace
+
+napi_value compareFrames(napi_env env, napi_callback_info info) {
+  napi_valuetype type;
+  compareCarrier *c = createCarrier<compareCarrier>(env);
+  if (c == nullptr)
+    return nullptr;
+
+  napi_value promise;
+  c->status = napi_create_promise(env, &c->_deferred, &promise);
+  REJECT_RETURN;
+
+  size_t argc = 3;
+  napi_value args[3];
+  c->status = napi_get_cb_info(env, info, &argc, args, nullptr, nullptr);
+  REJECT_RETURN;
+
+  if (argc < 2)
+    REJECT_ERROR_RETURN("Reference and test frames must be provided.",
+                        GRANDI_INVALID_ARGS);
+
+  napi_value buffers[2];
+  qualityFrame *frames[2] = {&c->reference, &c->test};
+  const char *names[2] = {"reference", "test"};
+  for (int i = 0; i < 2; i++) {
+    std::string error;
+    c->status = readQualityFrame(env, args[i], frames[i], &buffers[i], &error);
+    REJECT_RETURN;
+    if (!error.empty())
+      REJECT_ERROR_RETURN(std::string(names[i]) + " " + error,
+                          GRANDI_INVALID_ARGS);
+  }
+  if (c->reference.xres != c->test.xres ||
+      c->reference.yres != c->test.yres ||
+      c->reference.model != c->test.model)
+    REJECT_ERROR_RETURN(
+        "Frames must have the same size and color model to be compared.",
+        GRANDI_INVALID_ARGS);
+  if (c->reference.model == colorModel::yuv16)
+    c->peak = 65535.0;
+
+  if (argc >= 3) {
+    c->status = napi_typeof(env, args[2], &type);
+    REJECT_RETURN;
+    bool isArray;
+    c->status = napi_is_array(env, args[2], &isArray);
+    REJECT_RETURN;
+    if (type != napi_undefined) {
+      if (type != napi_object || isArray)
+        REJECT_ERROR_RETURN("Comparison options must be an object.",
+                            GRANDI_INVALID_ARGS);
+      napi_value ssim;
+      c->status = napi_get_named_property(env, args[2], "ssim", &ssim);
+      REJECT_RETURN;
+      c->status = napi_typeof(env, ssim, &type);
+      REJECT_RETURN;
+      if (type != napi_undefined) {
+        if (type != napi_boolean)
+          REJECT_ERROR_RETURN("ssim option must be a Boolean.",
+                              GRANDI_INVALID_ARGS);
+        c->status = napi_get_value_bool(env, ssim, &c->ssim);
+        REJECT_RETURN;
+      }
+    }
+  }
+
+  // Both data buffers stay referenced while the comparison reads them.
+  napi_value held;
+  c->status = napi_create_array_with_length(env, 2, &held);
+  REJECT_RETURN;
+  for (uint32_t i = 0; i < 2; i++) {
+    c->status = napi_set_element(env, held, i, buffers[i]);
+    REJECT_RETURN;
+  }
+  c->status = napi_create_reference(env, held, 1, &c->passthru);
+  REJECT_RETURN;
+
+  napi_value resource_name;
+  c->status = napi_create_string_utf8(env, "CompareFrames", NAPI_AUTO_LENGTH,
+                                      &resource_name);
+  REJECT_RETURN;
+  c->status = napi_create_async_work(env, NULL, resource_name, compareExecute,
+                                     compareComplete, c, &c->_request);
+  REJECT_RETURN;
+  c->status = napi_queue_async_work(env, c->_request);
+  REJECT_RETURN;
+
+  return promise;
+}
@@ -0,0 +1,26 @@
+/* Copyright 2025 Sarhan Aissi <github@tux.tn>.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+*/
+
+#ifndef GRANDI_QUALITY_H
+#define GRANDI_QUALITY_H
+
+#include "node_api.h"
+
+// compareFrames(reference, test, options?) resolves the per-channel mean
+// squared error, PSNR, and SSIM of two video frames of the same size and
+// color model.
+napi_value compareFrames(napi_env env, napi_callback_info info);
+
+#endif /* GRANDI_QUALITY_H */
@@ -13,6 +13,7 @@
   limitations under the License.
 */
 
+#include <algorithm>
 #include <chrono>
 #include <cmath>
 #include <cstddef>
@@ -29,18 +30,24 @@
 #endif // _WIN32
 
 #include "grandi_receive.h"
+#include "grandi_budget.h"
+#include "grandi_transfer.h"
 #include "grandi_util.h"
 #include "grandi_find.h"
+#include "grandi_clock.h"
 
 namespace {
 
 void destroyRecvInstance(void *value) {
-  NDIlib_recv_destroy((NDIlib_recv_instance_t)value);
+  receiveInstance *instance = (receiveInstance *)value;
+  if (instance->frameRate)
+    instance->frameRate->release(instance->recv);
+  NDIlib_recv_destroy(instance->recv);
+  delete instance;
 }
 
-bool acquireRecvFromThis(napi_env env, napi_value thisValue,
-                         nativeHandle **handle, NDIlib_recv_instance_t *recv,
-                         carrier *c, bool allowFrameSyncBinding = false) {
+bool acquireRecvFromThis(napi_env env, napi_value thisValue, dataCarrier *c,
+                         bool allowFrameSyncBinding = false) {
   napi_value recvValue;
   c->status = napi_get_named_property(env, thisValue, "embedded", &recvValue);
   if (c->status != napi_ok)
@@ -75,8 +82,9 @@ bool acquireRecvFromThis(napi_env env, napi_value thisValue,
             : "Receiver has been destroyed.";
     return false;
   }
-  *handle = native;
-  *recv = (NDIlib_recv_instance_t)value;
+  c->handle = native;
+  c->instance = (receiveInstance *)value;
+  c->recv = c->instance->recv;
   return true;
 }
 
@@ -134,7 +142,10 @@ struct ReceiveFrameGuard {
   NDIlib_metadata_frame_t metadataFrame{};
 
   ReceiveFrameGuard(dataCarrier *c, NDIlib_frame_type_e type)
-      : handle(c->handle), recv(c->recv), frameType(type),
+      : handle(c->handle), recv(c->recv),
+        frameType(type == NDIlib_frame_type_video && c->videoReleased
+                      ? NDIlib_frame_type_none
+                      : type),
         videoFrame(c->videoFrame), audioFrame(c->audioFrame),
         metadataFrame(c->metadataFrame) {
     c->handle = nullptr;
@@ -180,6 +191,110 @@ float planarFloatAudioSample(const NDIlib_audio_frame_v3_t &frame, int channel,
   return ((float *)channelData)[sample];
 }
 
+// Called straight after a capture returns so arrival times stay close to
+// when the frame left the SDK queue.
+void trackCapturedVideo(dataCarrier *c) {
+  if (c->videoFrame.timestamp != NDIlib_recv_timestamp_undefined)
+    observeClockSample(c->instance->sourceName, c->videoFrame.timestamp,
+                       clockMonotonicNs());
+  if (c->instance->avSync)
+    c->instance->avSync->trackVideo(c->videoFrame,
+                                    std::chrono::steady_clock::now());
+}
+
+void trackCapturedAudio(dataCarrier *c) {
+  if (c->audioFrame.timestamp != NDIlib_recv_timestamp_undefined)
+    observeClockSample(c->instance->sourceName, c->audioFrame.timestamp,
+                       clockMonotonicNs());
+  if (c->instance->avSync)
+    c->instance->avSync->trackAudio(c->audioFrame,
+                                    std::chrono::steady_clock::now());
+}
+
+// Progressive frames in a format the scaler writes can be admitted at half
+// size by a frame budget with the reduce policy.
+bool reducibleVideo(const NDIlib_video_frame_v2_t &frame) {
+  return frame.frame_format_type == NDIlib_frame_format_type_progressive &&
+         frame.FourCC != NDIlib_FourCC_type_UYVA && scalable(frame.FourCC) &&
+         frame.xres >= 4 && frame.yres >= 2;
+}
+
+// Asks the frame budget for room to copy c->videoFrame. A refused frame is
+// freed so the capture loop moves on to the next one, as it does with
+// skipped duplicates. reducible is set by the paths that copy through
+// copyCapturedVideo().
+bool admitCapturedVideo(dataCarrier *c, bool reducible) {
+  reducible = reducible && reducibleVideo(c->videoFrame);
+  switch (admitFrameBytes(videoDataSize(c->videoFrame), reducible,
+                          &c->reservation)) {
+  case budgetDecision::admit:
+    return true;
+  case budgetDecision::reduce:
+    c->reduceVideo = true;
+    return true;
+  case budgetDecision::drop:
+    break;
+  }
+  NDIlib_recv_free_video_v2(c->recv, &c->videoFrame);
+  c->videoFrame = NDIlib_video_frame_v2_t{};
+  c->budgetDrops++;
+  return false;
+}
+
+// Ends a video capture whose wait ran out while it freed frames, refused or
+// skipped as duplicates. The SDK still returns queued frames when asked
+// with no wait, so the capture would otherwise never time out.
+bool videoWaitSpent(dataCarrier *c,
+                    const std::chrono::steady_clock::time_point &start) {
+  if (remainingWaitMs(c->wait, start) > 0)
+    return false;
+  c->status = GRANDI_NOT_FOUND;
+  c->errorMsg = "No video data received in the requested time interval.";
+  return true;
+}
+
+// Copies c->videoFrame at half its width and height and frees the SDK
+// frame, leaving a detached copy.
+bool reduceCapturedVideo(dataCarrier *c) {
+  NDIlib_video_frame_v2_t &frame = c->videoFrame;
+  int xres = std::max(frame.xres / 2 & ~1, 2);
+  int yres = frame.yres / 2;
+  int lineStride = xres * (frame.FourCC == NDIlib_FourCC_type_UYVY ? 2 : 4);
+  if (!c->buffer.allocate((size_t)lineStride * yres))
+    return false;
+
+  videoView source;
+  source.data = frame.p_data;
+  source.fourCC = frame.FourCC;
+  source.xres = frame.xres;
+  source.yres = frame.yres;
+  source.lineStride = frame.line_stride_in_bytes;
+  {
+    receiveInstance *instance = c->instance;
+    std::lock_guard<std::mutex> lock(instance->reducerMutex);
+    if (!instance->reducer.scale(source, (uint8_t *)c->buffer.data,
+                                 frame.FourCC, xres, yres, lineStride))
+      return false;
+  }
+
+  NDIlib_video_frame_v2_t reduced = frame;
+  if (reduced.picture_aspect_ratio == 0.0f)
+    reduced.picture_aspect_ratio = (float)frame.xres / (float)frame.yres;
+  reduced.xres = xres;
+  reduced.yres = yres;
+  reduced.line_stride_in_bytes = lineStride;
+  reduced.p_data = nullptr;
+  reduced.p_metadata = nullptr;
+  if (frame.p_metadata != nullptr)
+    c->videoMetadata = frame.p_metadata;
+  NDIlib_recv_free_video_v2(c->recv, &frame);
+  frame = reduced;
+  if (!c->videoMetadata.empty())
+    frame.p_metadata = c->videoMetadata.c_str();
+  c->videoReleased = true;
+  return true;
+}
+
 bool copyCapturedVideo(dataCarrier *c) {
   size_t videoBytes = videoDataSize(c->videoFrame);
   if (c->videoFrame.p_data == nullptr || videoBytes == 0) {
@@ -188,7 +303,8 @@ bool copyCapturedVideo(dataCarrier *c) {
     NDIlib_recv_free_video_v2(c->recv, &c->videoFrame);
     return false;
   }
-  if (!c->buffer.copyFrom(c->videoFrame.p_data, videoBytes)) {
+  if (c->reduceVideo ? !reduceCapturedVideo(c)
+                     : !c->buffer.copyFrom(c->videoFrame.p_data, videoBytes)) {
     c->errorMsg = "Failed to allocate received video buffer.";
     c->status = GRANDI_ALLOCATION_FAILURE;
     NDIlib_recv_free_video_v2(c->recv, &c->videoFrame);
@@ -197,6 +313,54 @@ bool copyCapturedVideo(dataCarrier *c) {
   return true;
 }
 
+// Burns the receiver's timecode into the copied frame, once a capture path
+// has left it in c->buffer.
+void stampCapturedVideo(dataCarrier *c) {
+  if (!c->instance->burnIn || c->status != napi_ok ||
+      c->buffer.data == nullptr)
+    return;
+  NDIlib_video_frame_v2_t frame = c->videoFrame;
+  frame.p_data = (uint8_t *)c->buffer.data;
+  burnIn(*c->instance->burnIn, frame, c->instance->sourceName,
+         c->instance->framesStamped++);
+}
+
+// Hashes frame, the captured SDK frame or a capture path's copy, when the
+// receiver hashes video. Returns true when the frame repeats the previous
+// one and duplicates are skipped; the caller then frees it and captures
+// again.
+bool hashCapturedVideo(dataCarrier *c, const NDIlib_video_frame_v2_t &frame) {
+  frameHashOptions *options = c->instance->hash.get();
+  frameHash hash;
+  if (options == nullptr || !hashVideoFrame(frame, options->algorithm, &hash))
+    return false;
+  bool duplicate;
+  {
+    std::lock_guard<std::mutex> lock(c->instance->hashMutex);
+    duplicate = c->instance->hasLastHash && c->instance->lastHash == hash;
+    c->instance->lastHash = hash;
+    c->instance->hasLastHash = true;
+  }
+  if (duplicate && options->skipDuplicates) {
+    c->duplicatesSkipped++;
+    return true;
+  }
+  c->hashed = true;
+  c->duplicate = duplicate;
+  c->hash = hash;
+  return false;
+}
+
+// Hashes the frame a converting capture path left in c->buffer.
+void hashConvertedVideo(dataCarrier *c) {
+  if (!c->instance->hash || c->status != napi_ok ||
+      c->buffer.data == nullptr)
+    return;
+  NDIlib_video_frame_v2_t frame = c->videoFrame;
+  frame.p_data = (uint8_t *)c->buffer.data;
+  hashCapturedVideo(c, frame);
+}
+
 bool convertCapturedAudio(dataCarrier *c) {
   switch (c->audioFormat) {
   case Grandi_audio_format_int_16_interleaved: {
@@ -323,8 +487,187 @@ bool captureUntilFrame(dataCarrier *c, NDIlib_frame_type_e desired,
     }
   }
 }
+
+// Feeds captured frames through the receiver's frame rate converter until it
+// decides the next output frame. The converter keeps SDK frames between
+// calls, so the result is always a detached copy.
+void convertCapturedVideo(dataCarrier *c) {
+  frameRateConverter *converter = c->instance->frameRate.get();
+  std::lock_guard<std::mutex> lock(converter->mutex);
+  auto start = std::chrono::steady_clock::now();
+  while (true) {
+    if (!converter->hasPending()) {
+      if (!captureUntilFrame(
+              c, NDIlib_frame_type_video, remainingWaitMs(c->wait, start),
+              GRANDI_NOT_FOUND,
+              "No video data received in the requested time interval.",
+              "Received error response from NDI video request. Connection "
+              "lost."))
+        return;
+      trackCapturedVideo(c);
+      if (!admitCapturedVideo(c, false)) {
+        if (videoWaitSpent(c, start))
+          return;
+        continue;
+      }
+      converter->push(c->videoFrame, std::chrono::steady_clock::now());
+      c->videoFrame = NDIlib_video_frame_v2_t{};
+    }
+
+    switch (converter->step(c->recv, &c->buffer, &c->videoFrame,
+                            &c->videoMetadata)) {
+    case frameRateStep::needFrame:
+      break;
+    case frameRateStep::emitted:
+      c->videoReleased = true;
+      if (!c->videoMetadata.empty())
+        c->videoFrame.p_metadata = c->videoMetadata.c_str();
+      return;
+    case frameRateStep::emptyFrame:
+      c->errorMsg = "Received empty NDI video frame buffer.";
+      c->status = GRANDI_NOT_VIDEO;
+      return;
+    case frameRateStep::allocationFailure:
+      c->errorMsg = "Failed to allocate received video buffer.";
+      c->status = GRANDI_ALLOCATION_FAILURE;
+      return;
+    }
+  }
+}
+
+// convertCapturedVideo() for data(): video goes through the converter, and
+// the first other frame the SDK delivers is returned as captured.
+void convertCapturedData(dataCarrier *c) {
+  frameRateConverter *converter = c->instance->frameRate.get();
+  std::lock_guard<std::mutex> lock(converter->mutex);
+  auto start = std::chrono::steady_clock::now();
+  while (true) {
+    if (converter->hasPending()) {
+      frameRateStep step = converter->step(c->recv, &c->buffer, &c->videoFrame,
+                                           &c->videoMetadata);
+      if (step != frameRateStep::needFrame) {
+        c->frameType = NDIlib_frame_type_video;
+        c->videoReleased = true;
+      }
+      switch (step) {
+      case frameRateStep::needFrame:
+        break;
+      case frameRateStep::emitted:
+        if (!c->videoMetadata.empty())
+          c->videoFrame.p_metadata = c->videoMetadata.c_str();
+        return;
+      case frameRateStep::emptyFrame:
+        c->errorMsg = "Received empty NDI video frame buffer.";
+        c->status = GRANDI_NOT_VIDEO;
+        return;
+      case frameRateStep::allocationFailure:
+        c->errorMsg = "Failed to allocate received video buffer.";
+        c->status = GRANDI_ALLOCATION_FAILURE;
+        return;
+      }
+    }
+
+    c->frameType = NDIlib_recv_capture_v3(c->recv, &c->videoFrame,
+                                          &c->audioFrame, &c->metadataFrame,
+                                          remainingWaitMs(c->wait, start));
+    if (c->frameType != NDIlib_frame_type_video)
+      return;
+    trackCapturedVideo(c);
+    if (!admitCapturedVideo(c, false)) {
+      // Like a capture that times out.
+      if (remainingWaitMs(c->wait, start) == 0) {
+        c->frameType = NDIlib_frame_type_none;
+        return;
+      }
+      continue;
+    }
+    converter->push(c->videoFrame, std::chrono::steady_clock::now());
+    c->videoFrame = NDIlib_video_frame_v2_t{};
+  }
+}
+
+// Returns progressive video from the receiver's deinterlacer. A field held
+// back from the previous interleaved frame is returned without capturing.
+void deinterlaceCapturedVideo(dataCarrier *c) {
+  deinterlacer *converter = c->instance->deinterlace.get();
+  std::lock_guard<std::mutex> lock(converter->mutex);
+  NDIlib_video_frame_v2_t output{};
+  if (converter->takePending(&c->buffer, &output, &c->videoMetadata)) {
+    c->videoFrame = output;
+  } else {
+    auto start = std::chrono::steady_clock::now();
+    while (true) {
+      if (!captureUntilFrame(
+              c, NDIlib_frame_type_video, remainingWaitMs(c->wait, start),
+              GRANDI_NOT_FOUND,
+              "No video data received in the requested time interval.",
+              "Received error response from NDI video request. Connection "
+              "lost."))
+        return;
+      trackCapturedVideo(c);
+      if (!admitCapturedVideo(c, false)) {
+        if (videoWaitSpent(c, start))
+          return;
+        continue;
+      }
+
+      deinterlaceResult result = converter->convert(c->videoFrame, &c->buffer,
+                                                    &output, &c->videoMetadata);
+      if (result == deinterlaceResult::passthrough) {
+        copyCapturedVideo(c);
+        return;
+      }
+      NDIlib_recv_free_video_v2(c->recv, &c->videoFrame);
+      c->videoFrame = NDIlib_video_frame_v2_t{};
+      if (result == deinterlaceResult::allocationFailure) {
+        c->errorMsg = "Failed to allocate received video buffer.";
+        c->status = GRANDI_ALLOCATION_FAILURE;
+        return;
+      }
+      if (result == deinterlaceResult::converted)
+        break;
+    }
+    c->videoFrame = output;
+  }
+  c->videoReleased = true;
+  if (!c->videoMetadata.empty())
+    c->videoFrame.p_metadata = c->videoMetadata.c_str();
+}
+
+// Duplicates are hashed in the SDK's buffer and freed without a copy, and
+// so are frames the frame budget refuses.
+void captureVideo(dataCarrier *c) {
+  auto start = std::chrono::steady_clock::now();
+  while (true) {
+    if (!captureUntilFrame(
+            c, NDIlib_frame_type_video, remainingWaitMs(c->wait, start),
+            GRANDI_NOT_FOUND,
+            "No video data received in the requested time interval.",
+            "Received error response from NDI video request. Connection "
+            "lost."))
+      return;
+    trackCapturedVideo(c);
+    if (!hashCapturedVideo(c, c->videoFrame)) {
+      if (admitCapturedVideo(c, true))
+        break;
+    } else {
+      NDIlib_recv_free_video_v2(c->recv, &c->videoFrame);
+      c->videoFrame = NDIlib_video_frame_v2_t{};
+    }
+    if (videoWaitSpent(c, start))
+      return;
+  }
+
+  if (copyCapturedVideo(c))
+    stampCapturedVideo(c);
+}
 } // namespace
 
+receiveCarrier::~receiveCarrier() {
+  if (instance != nullptr)
+    destroyRecvInstance(instance);
+}
+
 void finalizeReceive(napi_env env, void *data, void *hint) {
   finalizeNativeHandle(env, data, hint);
 }
@@ -363,6 +706,50 @@ done:
   return result;
 }
 
+bool bindReceiverCapture(napi_env env, napi_value receiver,
+                         const std::string &label, nativeHandle **handle,
+                         receiveInstance **instance, carrier *c) {
+  napi_valuetype type;
+  napi_value recvValue = nullptr;
+  c->status = napi_typeof(env, receiver, &type);
+  if (c->status != napi_ok)
+    return false;
+  if (type == napi_object) {
+    c->status = napi_get_named_property(env, receiver, "embedded", &recvValue);
+    if (c->status != napi_ok)
+      return false;
+    c->status = napi_typeof(env, recvValue, &type);
+    if (c->status != napi_ok)
+      return false;
+  }
+  if (type != napi_external) {
+    c->status = GRANDI_INVALID_ARGS;
+    c->errorMsg = label + " must be an initialized receiver.";
+    return false;
+  }
+
+  void *externalData;
+  c->status = napi_get_value_external(env, recvValue, &externalData);
+  if (c->status != napi_ok)
+    return false;
+  nativeHandle *recvHandle = (nativeHandle *)externalData;
+  void *recvData;
+  nativeCaptureStatus captureStatus =
+      bindNativeCaptureHandle(recvHandle, &recvData);
+  if (captureStatus != nativeCaptureStatus::success) {
+    c->status = GRANDI_INVALID_ARGS;
+    c->errorMsg = "Receiver has been destroyed.";
+    if (captureStatus == nativeCaptureStatus::bound)
+      c->errorMsg = "Receiver is already bound to a native consumer.";
+    else if (captureStatus == nativeCaptureStatus::busy)
+      c->errorMsg = "Receiver has active capture operations.";
+    return false;
+  }
+  *handle = recvHandle;
+  *instance = (receiveInstance *)recvData;
+  return true;
+}
+
 void receiveExecute(napi_env env, void *data) {
   receiveCarrier *c = (receiveCarrier *)data;
 
@@ -373,158 +760,294 @@ void receiveExecute(napi_env env, void *data) {
   receiveConfig.allow_video_fields = c->allowVideoFields;
   receiveConfig.p_ndi_recv_name = c->name.get();
 
-  c->recv = NDIlib_recv_create_v3(&receiveConfig);
-  if (!c->recv) {
+  NDIlib_recv_instance_t recv = NDIlib_recv_create_v3(&receiveConfig);
+  if (!recv) {
     c->status = GRANDI_RECEIVE_CREATE_FAIL;
     c->errorMsg = "Failed to create NDI receiver.";
     return;
   }
-}
-
-void receiveComplete(napi_env env, napi_status asyncStatus, void *data) {
-  receiveCarrier *c = (receiveCarrier *)data;
-
-  if (asyncStatus != napi_ok) {
-    c->status = asyncStatus;
-    c->errorMsg = "Async receiver creation failed to complete.";
-  }
-  REJECT_STATUS;
 
-  napi_value result;
-  c->status = napi_create_object(env, &result);
-  REJECT_STATUS;
-
-  napi_value embedded;
-  nativeHandle *handle = createNativeHandle(c->recv, destroyRecvInstance);
-  if (handle == nullptr) {
-    destroyRecvInstance(c->recv);
-    c->recv = nullptr;
+  c->instance = new (std::nothrow) receiveInstance;
+  if (c->instance == nullptr) {
+    NDIlib_recv_destroy(recv);
     c->status = GRANDI_ALLOCATION_FAILURE;
     c->errorMsg = "Failed to allocate Receiver handle.";
-    REJECT_STATUS;
+    return;
   }
-  c->status =
-      napi_create_external(env, handle, finalizeReceive, nullptr, &embedded);
-  if (c->status != napi_ok) {
-    closeNativeHandle(handle);
-    delete handle;
-    REJECT_STATUS;
+  c->instance->recv = recv;
+  c->instance->sourceName = c->source.value.p_ndi_name;
+  if (c->source.value.p_url_address != nullptr) {
+    c->instance->sourceUrl = c->source.value.p_url_address;
+    c->instance->hasSourceUrl = true;
   }
-  c->status = napi_set_named_property(env, result, "embedded", embedded);
-  REJECT_STATUS;
+  c->instance->colorFormat = c->colorFormat;
+  c->instance->bandwidth = c->bandwidth;
+  c->instance->allowVideoFields = c->allowVideoFields;
+  if (c->name != nullptr) {
+    c->instance->name = c->name.get();
+    c->instance->hasName = true;
+  }
+  if (c->avSync) {
+    c->instance->avSync.reset(new (std::nothrow)
+                                  avSyncTracker(c->avSyncConfig));
+    if (!c->instance->avSync) {
+      c->status = GRANDI_ALLOCATION_FAILURE;
+      c->errorMsg = "Failed to allocate A/V sync tracker.";
+      return;
+    }
+  }
+  if (c->deinterlace) {
+    c->instance->deinterlace.reset(new (std::nothrow)
+                                       deinterlacer(c->deinterlaceConfig));
+    if (!c->instance->deinterlace) {
+      c->status = GRANDI_ALLOCATION_FAILURE;
+      c->errorMsg = "Failed to allocate deinterlacer.";
+      return;
+    }
+  }
+  if (c->convertFrameRate) {
+    c->instance->frameRate.reset(new (std::nothrow)
+                                     frameRateConverter(c->frameRateConfig));
+    if (!c->instance->frameRate) {
+      c->status = GRANDI_ALLOCATION_FAILURE;
+      c->errorMsg = "Failed to allocate frame rate converter.";
+      return;
+    }
+  }
+  if (c->burnIn) {
+    c->instance->burnIn.reset(new (std::nothrow)
+                                  burnInOptions(c->burnInConfig));
+    if (!c->instance->burnIn) {
+      c->status = GRANDI_ALLOCATION_FAILURE;
+      c->errorMsg = "Failed to allocate burn-in options.";
+      return;
+    }
+  }
+  if (c->hash) {
+    c->instance->hash.reset(new (std::nothrow)
+                                frameHashOptions(c->hashConfig));
+    if (!c->instance->hash) {
+      c->status = GRANDI_ALLOCATION_FAILURE;
+      c->errorMsg = "Failed to allocate frame hash options.";
+      return;
+    }
+  }
+  if (c->motion) {
+    c->instance->motion.reset(new (std::nothrow)
+                                  motionDetector(c->motionConfig));
+    if (!c->instance->motion) {
+      c->status = GRANDI_ALLOCATION_FAILURE;
+      c->errorMsg = "Failed to allocate motion detector.";
+      return;
+    }
+  }
+}
+
+namespace {
+
+// Sets up the receiver object around embedded.
+napi_status fillReceiverObject(napi_env env, napi_value embedded,
+                               receiveInstance *instance, napi_value *result) {
+  napi_status status;
+  napi_value object;
+  status = napi_create_object(env, &object);
+  PASS_STATUS;
+  status = napi_set_named_property(env, object, "embedded", embedded);
+  PASS_STATUS;
 
   napi_value destroyFn;
-  c->status = napi_create_function(env, "destroy", NAPI_AUTO_LENGTH,
-                                   destroyReceive, nullptr, &destroyFn);
-  REJECT_STATUS;
-  c->status = napi_set_named_property(env, result, "destroy", destroyFn);
-  REJECT_STATUS;
+  status = napi_create_function(env, "destroy", NAPI_AUTO_LENGTH,
+                                destroyReceive, nullptr, &destroyFn);
+  PASS_STATUS;
+  status = napi_set_named_property(env, object, "destroy", destroyFn);
+  PASS_STATUS;
+
+  napi_value detachFn;
+  status = napi_create_function(env, "detach", NAPI_AUTO_LENGTH, detachReceive,
+                                nullptr, &detachFn);
+  PASS_STATUS;
+  status = napi_set_named_property(env, object, "detach", detachFn);
+  PASS_STATUS;
 
   napi_value videoFn;
-  c->status = napi_create_function(env, "video", NAPI_AUTO_LENGTH, videoReceive,
-                                   nullptr, &videoFn);
-  REJECT_STATUS;
-  c->status = napi_set_named_property(env, result, "video", videoFn);
-  REJECT_STATUS;
+  status = napi_create_function(env, "video", NAPI_AUTO_LENGTH, videoReceive,
+                                nullptr, &videoFn);
+  PASS_STATUS;
+  status = napi_set_named_property(env, object, "video", videoFn);
+  PASS_STATUS;
+
+  napi_value scopesFn;
+  status = napi_create_function(env, "scopes", NAPI_AUTO_LENGTH, scopesReceive,
+                                nullptr, &scopesFn);
+  PASS_STATUS;
+  status = napi_set_named_property(env, object, "scopes", scopesFn);
+  PASS_STATUS;
+
+  napi_value motionFn;
+  status = napi_create_function(env, "motion", NAPI_AUTO_LENGTH, motionReceive,
+                                nullptr, &motionFn);
+  PASS_STATUS;
+  status = napi_set_named_property(env, object, "motion", motionFn);
+  PASS_STATUS;
 
   napi_value audioFn;
-  c->status = napi_create_function(env, "audio", NAPI_AUTO_LENGTH, audioReceive,
-                                   nullptr, &audioFn);
-  REJECT_STATUS;
-  c->status = napi_set_named_property(env, result, "audio", audioFn);
-  REJECT_STATUS;
+  status = napi_create_function(env, "audio", NAPI_AUTO_LENGTH, audioReceive,
+                                nullptr, &audioFn);
+  PASS_STATUS;
+  status = napi_set_named_property(env, object, "audio", audioFn);
+  PASS_STATUS;
 
   napi_value metadataFn;
-  c->status = napi_create_function(env, "metadata", NAPI_AUTO_LENGTH,
-                                   metadataReceive, nullptr, &metadataFn);
-  REJECT_STATUS;
-  c->status = napi_set_named_property(env, result, "metadata", metadataFn);
-  REJECT_STATUS;
+  status = napi_create_function(env, "metadata", NAPI_AUTO_LENGTH,
+                                metadataReceive, nullptr, &metadataFn);
+  PASS_STATUS;
+  status = napi_set_named_property(env, object, "metadata", metadataFn);
+  PASS_STATUS;
 
   napi_value dataFn;
-  c->status = napi_create_function(env, "data", NAPI_AUTO_LENGTH, dataReceive,
-                                   nullptr, &dataFn);
-  REJECT_STATUS;
-  c->status = napi_set_named_property(env, result, "data", dataFn);
-  REJECT_STATUS;
+  status = napi_create_function(env, "data", NAPI_AUTO_LENGTH, dataReceive,
+                                nullptr, &dataFn);
+  PASS_STATUS;
+  status = napi_set_named_property(env, object, "data", dataFn);
+  PASS_STATUS;
 
   napi_value tallyFn;
-  c->status = napi_create_function(env, "tally", NAPI_AUTO_LENGTH,
-                                   setReceiveTally, nullptr, &tallyFn);
-  REJECT_STATUS;
-  c->status = napi_set_named_property(env, result, "tally", tallyFn);
-  REJECT_STATUS;
+  status = napi_create_function(env, "tally", NAPI_AUTO_LENGTH, setReceiveTally,
+                                nullptr, &tallyFn);
+  PASS_STATUS;
+  status = napi_set_named_property(env, object, "tally", tallyFn);
+  PASS_STATUS;
 
   napi_value performanceFn;
-  c->status = napi_create_function(env, "performance", NAPI_AUTO_LENGTH,
-                                   recvPerformance, nullptr, &performanceFn);
-  REJECT_STATUS;
-  c->status =
-      napi_set_named_property(env, result, "performance", performanceFn);
-  REJECT_STATUS;
+  status = napi_create_function(env, "performance", NAPI_AUTO_LENGTH,
+                                recvPerformance, nullptr, &performanceFn);
+  PASS_STATUS;
+  status = napi_set_named_property(env, object, "performance", performanceFn);
+  PASS_STATUS;
 
   napi_value queueFn;
-  c->status = napi_create_function(env, "queue", NAPI_AUTO_LENGTH, recvQueue,
-                                   nullptr, &queueFn);
-  REJECT_STATUS;
-  c->status = napi_set_named_property(env, result, "queue", queueFn);
-  REJECT_STATUS;
+  status = napi_create_function(env, "queue", NAPI_AUTO_LENGTH, recvQueue,
+                                nullptr, &queueFn);
+  PASS_STATUS;
+  status = napi_set_named_property(env, object, "queue", queueFn);
+  PASS_STATUS;
 
   napi_value connectionsFn;
-  c->status = napi_create_function(env, "connections", NAPI_AUTO_LENGTH,
-                                   recvConnections, nullptr, &connectionsFn);
-  REJECT_STATUS;
-  c->status =
-      napi_set_named_property(env, result, "connections", connectionsFn);
-  REJECT_STATUS;
+  status = napi_create_function(env, "connections", NAPI_AUTO_LENGTH,
+                                recvConnections, nullptr, &connectionsFn);
+  PASS_STATUS;
+  status = napi_set_named_property(env, object, "connections", connectionsFn);
+  PASS_STATUS;
+
+  napi_value avSyncFn;
+  status = napi_create_function(env, "avSync", NAPI_AUTO_LENGTH, recvAvSync,
+                                nullptr, &avSyncFn);
+  PASS_STATUS;
+  status = napi_set_named_property(env, object, "avSync", avSyncFn);
+  PASS_STATUS;
+
+  napi_value frameRateStatsFn;
+  status = napi_create_function(env, "frameRateStats", NAPI_AUTO_LENGTH,
+                                recvFrameRateStats, nullptr, &frameRateStatsFn);
+  PASS_STATUS;
+  status =
+      napi_set_named_property(env, object, "frameRateStats", frameRateStatsFn);
+  PASS_STATUS;
 
   napi_value source, name;
-  c->status = napi_create_string_utf8(env, c->source.value.p_ndi_name,
-                                      NAPI_AUTO_LENGTH, &name);
-  REJECT_STATUS;
-  napi_value uri;
-  if (c->source.value.p_url_address != nullptr) {
-    c->status = napi_create_string_utf8(env, c->source.value.p_url_address,
-                                        NAPI_AUTO_LENGTH, &uri);
-    REJECT_STATUS;
-  }
-  c->status = napi_create_object(env, &source);
-  REJECT_STATUS;
-  c->status = napi_set_named_property(env, source, "name", name);
-  REJECT_STATUS;
-  if (c->source.value.p_url_address != nullptr) {
-    c->status = napi_set_named_property(env, source, "urlAddress", uri);
-    REJECT_STATUS;
+  status = napi_create_string_utf8(env, instance->sourceName.c_str(),
+                                   NAPI_AUTO_LENGTH, &name);
+  PASS_STATUS;
+  status = napi_create_object(env, &source);
+  PASS_STATUS;
+  status = napi_set_named_property(env, source, "name", name);
+  PASS_STATUS;
+  if (instance->hasSourceUrl) {
+    napi_value uri;
+    status = napi_create_string_utf8(env, instance->sourceUrl.c_str(),
+                                     NAPI_AUTO_LENGTH, &uri);
+    PASS_STATUS;
+    status = napi_set_named_property(env, source, "urlAddress", uri);
+    PASS_STATUS;
   }
-  c->status = napi_set_named_property(env, result, "source", source);
-  REJECT_STATUS;
+  status = napi_set_named_property(env, object, "source", source);
+  PASS_STATUS;
 
   napi_value colorFormat;
-  c->status = napi_create_int32(env, (int32_t)c->colorFormat, &colorFormat);
-  REJECT_STATUS;
-  c->status = napi_set_named_property(env, result, "colorFormat", colorFormat);
-  REJECT_STATUS;
+  status = napi_create_int32(env, (int32_t)instance->colorFormat, &colorFormat);
+  PASS_STATUS;
+  status = napi_set_named_property(env, object, "colorFormat", colorFormat);
+  PASS_STATUS;
 
   napi_value bandwidth;
-  c->status = napi_create_int32(env, (int32_t)c->bandwidth, &bandwidth);
-  REJECT_STATUS;
-  c->status = napi_set_named_property(env, result, "bandwidth", bandwidth);
-  REJECT_STATUS;
+  status = napi_create_int32(env, (int32_t)instance->bandwidth, &bandwidth);
+  PASS_STATUS;
+  status = napi_set_named_property(env, object, "bandwidth", bandwidth);
+  PASS_STATUS;
 
   napi_value allowVideoFields;
-  c->status = napi_get_boolean(env, c->allowVideoFields, &allowVideoFields);
-  REJECT_STATUS;
-  c->status = napi_set_named_property(env, result, "allowVideoFields",
-                                      allowVideoFields);
+  status = napi_get_boolean(env, instance->allowVideoFields, &allowVideoFields);
+  PASS_STATUS;
+  status = napi_set_named_property(env, object, "allowVideoFields",
+                                   allowVideoFields);
+  PASS_STATUS;
+
+  if (instance->hasName) {
+    status = napi_create_string_utf8(env, instance->name.c_str(),
+                                     NAPI_AUTO_LENGTH, &name);
+    PASS_STATUS;
+    status = napi_set_named_property(env, object, "name", name);
+    PASS_STATUS;
+  }
+  *result = object;
+  return napi_ok;
+}
+
+} // namespace
+
+napi_status makeReceiverObject(napi_env env, nativeHandle *handle,
+                               napi_value *result) {
+  napi_status status;
+  napi_value embedded;
+  status =
+      napi_create_external(env, handle, finalizeReceive, nullptr, &embedded);
+  if (status != napi_ok) {
+    closeNativeHandle(handle);
+    delete handle;
+    return status;
+  }
+  status = fillReceiverObject(env, embedded, (receiveInstance *)handle->value,
+                              result);
+  // embedded owns the handle now and frees it once collected.
+  if (status != napi_ok)
+    closeNativeHandle(handle);
+  return status;
+}
+
+napi_value detachReceive(napi_env env, napi_callback_info info) {
+  return detachHandleObject(env, info, detachedKind::receiver,
+                            destroyRecvInstance, "Receiver");
+}
+
+void receiveComplete(napi_env env, napi_status asyncStatus, void *data) {
+  receiveCarrier *c = (receiveCarrier *)data;
+
+  if (asyncStatus != napi_ok) {
+    c->status = asyncStatus;
+    c->errorMsg = "Async receiver creation failed to complete.";
+  }
   REJECT_STATUS;
 
-  if (c->name != nullptr) {
-    c->status =
-        napi_create_string_utf8(env, c->name.get(), NAPI_AUTO_LENGTH, &name);
-    REJECT_STATUS;
-    c->status = napi_set_named_property(env, result, "name", name);
+  nativeHandle *handle = createNativeHandle(c->instance, destroyRecvInstance);
+  if (handle == nullptr) {
+    c->status = GRANDI_ALLOCATION_FAILURE;
+    c->errorMsg = "Failed to allocate Receiver handle.";
     REJECT_STATUS;
   }
+  c->instance = nullptr;
+  napi_value result;
+  c->status = makeReceiverObject(env, handle, &result);
+  REJECT_STATUS;
 
   napi_status status;
   status = napi_resolve_deferred(env, c->_deferred, result);
@@ -671,6 +1194,157 @@ napi_value receive(napi_env env, napi_callback_info info) {
       REJECT_RETURN;
   }
 
+  napi_value avSync;
+  c->status = napi_get_named_property(env, config, "avSync", &avSync);
+  REJECT_RETURN;
+  c->status = napi_typeof(env, avSync, &type);
+  REJECT_RETURN;
+  c->status = napi_is_array(env, avSync, &isArray);
+  REJECT_RETURN;
+  if (type == napi_boolean) {
+    c->status = napi_get_value_bool(env, avSync, &c->avSync);
+    REJECT_RETURN;
+  } else if (type == napi_object && !isArray) {
+    c->avSync = true;
+    napi_value window, testPattern;
+    c->status = napi_get_named_property(env, avSync, "window", &window);
+    REJECT_RETURN;
+    c->status = napi_typeof(env, window, &type);
+    REJECT_RETURN;
+    if (type != napi_undefined) {
+      c->status = parseUint32Value(env, window, "avSync.window",
+                                   &c->avSyncConfig.window, &c->errorMsg);
+      REJECT_RETURN;
+      if (!c->errorMsg.empty())
+        REJECT_ERROR_RETURN(c->errorMsg, GRANDI_INVALID_ARGS);
+      if (c->avSyncConfig.window < 2 || c->avSyncConfig.window > 10000)
+        REJECT_ERROR_RETURN("avSync.window must be between 2 and 10000.",
+                            GRANDI_INVALID_ARGS);
+    }
+    c->status =
+        napi_get_named_property(env, avSync, "testPattern", &testPattern);
+    REJECT_RETURN;
+    c->status = napi_typeof(env, testPattern, &type);
+    REJECT_RETURN;
+    if (type != napi_undefined) {
+      if (type != napi_boolean)
+        REJECT_ERROR_RETURN("avSync.testPattern must be a Boolean.",
+                            GRANDI_INVALID_ARGS);
+      c->status = napi_get_value_bool(env, testPattern,
+                                      &c->avSyncConfig.testPattern);
+      REJECT_RETURN;
+    }
+  } else if (type != napi_undefined) {
+    REJECT_ERROR_RETURN("avSync property must be a Boolean or an object.",
+                        GRANDI_INVALID_ARGS);
+  }
+
+  napi_value outputFrameRate;
+  c->status =
+      napi_get_named_property(env, config, "outputFrameRate", &outputFrameRate);
+  REJECT_RETURN;
+  c->status = napi_typeof(env, outputFrameRate, &type);
+  REJECT_RETURN;
+  c->status = napi_is_array(env, outputFrameRate, &isArray);
+  REJECT_RETURN;
+  if (type == napi_object && !isArray) {
+    c->convertFrameRate = true;
+    napi_value frameRateN, frameRateD, blend;
+    uint32_t rateN, rateD;
+    c->status = napi_get_named_property(env, outputFrameRate, "frameRateN",
+                                        &frameRateN);
+    REJECT_RETURN;
+    c->status = parseUint32Value(env, frameRateN, "outputFrameRate.frameRateN",
+                                 &rateN, &c->errorMsg);
+    REJECT_RETURN;
+    if (!c->errorMsg.empty())
+      REJECT_ERROR_RETURN(c->errorMsg, GRANDI_INVALID_ARGS);
+    if (rateN < 1 || rateN > 1000000)
+      REJECT_ERROR_RETURN(
+          "outputFrameRate.frameRateN must be between 1 and 1000000.",
+          GRANDI_INVALID_ARGS);
+    c->status = napi_get_named_property(env, outputFrameRate, "frameRateD",
+                                        &frameRateD);
+    REJECT_RETURN;
+    c->status = parseUint32Value(env, frameRateD, "outputFrameRate.frameRateD",
+                                 &rateD, &c->errorMsg);
+    REJECT_RETURN;
+    if (!c->errorMsg.empty())
+      REJECT_ERROR_RETURN(c->errorMsg, GRANDI_INVALID_ARGS);
+    if (rateD < 1 || rateD > 100000)
+      REJECT_ERROR_RETURN(
+          "outputFrameRate.frameRateD must be between 1 and 100000.",
+          GRANDI_INVALID_ARGS);
+    c->frameRateConfig.frameRateN = (int32_t)rateN;
+    c->frameRateConfig.frameRateD = (int32_t)rateD;
+
+    c->status = napi_get_named_property(env, outputFrameRate, "blend", &blend);
+    REJECT_RETURN;
+    c->status = napi_typeof(env, blend, &type);
+    REJECT_RETURN;
+    if (type != napi_undefined) {
+      if (type != napi_boolean)
+        REJECT_ERROR_RETURN("outputFrameRate.blend must be a Boolean.",
+                            GRANDI_INVALID_ARGS);
+      c->status = napi_get_value_bool(env, blend, &c->frameRateConfig.blend);
+      REJECT_RETURN;
+    }
+  } else if (type != napi_undefined) {
+    REJECT_ERROR_RETURN("outputFrameRate property must be an object.",
+                        GRANDI_INVALID_ARGS);
+  }
+
+  napi_value deinterlace;
+  c->status = napi_get_named_property(env, config, "deinterlace", &deinterlace);
+  REJECT_RETURN;
+  c->status = napi_typeof(env, deinterlace, &type);
+  REJECT_RETURN;
+  if (type != napi_undefined) {
+    c->deinterlace = true;
+    c->status = parseDeinterlaceOptions(env, deinterlace, &c->deinterlaceConfig,
+                                        &c->errorMsg);
+    REJECT_RETURN;
+    if (!c->errorMsg.empty())
+      REJECT_ERROR_RETURN(c->errorMsg, GRANDI_INVALID_ARGS);
+    if (c->convertFrameRate)
+      REJECT_ERROR_RETURN(
+          "deinterlace cannot be combined with outputFrameRate.",
+          GRANDI_INVALID_ARGS);
+  }
+
+  napi_value burnIn;
+  c->status = napi_get_named_property(env, config, "burnIn", &burnIn);
+  REJECT_RETURN;
+  c->status = parseBurnInOptions(env, burnIn, &c->burnIn, &c->burnInConfig,
+                                 &c->errorMsg);
+  REJECT_RETURN;
+  if (!c->errorMsg.empty())
+    REJECT_ERROR_RETURN(c->errorMsg, GRANDI_INVALID_ARGS);
+
+  napi_value hash;
+  c->status = napi_get_named_property(env, config, "hash", &hash);
+  REJECT_RETURN;
+  c->status = parseFrameHashOptions(env, hash, &c->hash, &c->hashConfig,
+                                    &c->errorMsg);
+  REJECT_RETURN;
+  if (!c->errorMsg.empty())
+    REJECT_ERROR_RETURN(c->errorMsg, GRANDI_INVALID_ARGS);
+  // Converted frames are paced by the converter, which drops and repeats
+  // frames on purpose.
+  if (c->hashConfig.skipDuplicates && (c->convertFrameRate || c->deinterlace))
+    REJECT_ERROR_RETURN("hash.skipDuplicates cannot be combined with "
+                        "outputFrameRate or deinterlace.",
+                        GRANDI_INVALID_ARGS);
+
+  napi_value motion;
+  c->status = napi_get_named_property(env, config, "motion", &motion);
+  REJECT_RETURN;
+  c->status = parseMotionOptions(env, motion, &c->motion, &c->motionConfig,
+                                 &c->errorMsg);
+  REJECT_RETURN;
+  if (!c->errorMsg.empty())
+    REJECT_ERROR_RETURN(c->errorMsg, GRANDI_INVALID_ARGS);
+
   napi_value resource_name;
   c->status =
       napi_create_string_utf8(env, "Receive", NAPI_AUTO_LENGTH, &resource_name);
@@ -687,100 +1361,69 @@ napi_value receive(napi_env env, napi_callback_info info) {
 void videoReceiveExecute(napi_env env, void *data) {
   dataCarrier *c = (dataCarrier *)data;
 
-  if (captureUntilFrame(
-          c, NDIlib_frame_type_video, c->wait, GRANDI_NOT_FOUND,
-          "No video data received in the requested time interval.",
-          "Received error response from NDI video request. Connection lost."))
-    copyCapturedVideo(c);
+  if (c->instance->frameRate) {
+    convertCapturedVideo(c);
+    hashConvertedVideo(c);
+    stampCapturedVideo(c);
+  } else if (c->instance->deinterlace) {
+    deinterlaceCapturedVideo(c);
+    hashConvertedVideo(c);
+    stampCapturedVideo(c);
+  } else {
+    captureVideo(c);
+  }
+  // The copy, if any, is now counted by the frame allocator.
+  c->reservation.release();
+  // Raising the budget or releasing frames is the fix for such a timeout.
+  if (c->budgetDrops > 0 && c->status == GRANDI_NOT_FOUND)
+    c->errorMsg = "No video frame fit the frame memory budget in the "
+                  "requested time interval.";
 }
 
 void videoReceiveComplete(napi_env env, napi_status asyncStatus, void *data) {
   dataCarrier *c = (dataCarrier *)data;
 
-  if (asyncStatus != napi_ok) {
-    c->status = asyncStatus;
-    c->errorMsg = "Async video frame receive failed to complete.";
-  }
-  REJECT_STATUS;
-
-  ReceiveFrameGuard guard(c, NDIlib_frame_type_video);
-
-  napi_value result;
-  c->status = napi_create_object(env, &result);
-  REJECT_STATUS;
-
-  napi_value param;
-  c->status = napi_create_string_utf8(env, "video", NAPI_AUTO_LENGTH, &param);
-  REJECT_STATUS;
-  c->status = napi_set_named_property(env, result, "type", param);
-  REJECT_STATUS;
-
-  c->status = napi_create_int32(env, c->videoFrame.xres, &param);
-  REJECT_STATUS;
-  c->status = napi_set_named_property(env, result, "xres", param);
-  REJECT_STATUS;
-
-  c->status = napi_create_int32(env, c->videoFrame.yres, &param);
-  REJECT_STATUS;
-  c->status = napi_set_named_property(env, result, "yres", param);
-  REJECT_STATUS;
-
-  c->status = napi_create_int32(env, c->videoFrame.frame_rate_N, &param);
-  REJECT_STATUS;
-  c->status = napi_set_named_property(env, result, "frameRateN", param);
-  REJECT_STATUS;
-
-  c->status = napi_create_int32(env, c->videoFrame.frame_rate_D, &param);
-  REJECT_STATUS;
-  c->status = napi_set_named_property(env, result, "frameRateD", param);
-  REJECT_STATUS;
-
-  c->status = napi_create_double(
-      env, (double)c->videoFrame.picture_aspect_ratio, &param);
-  REJECT_STATUS;
-  c->status = napi_set_named_property(env, result, "pictureAspectRatio", param);
-  REJECT_STATUS;
-
-  if (c->videoFrame.timestamp != NDIlib_recv_timestamp_undefined) {
-    c->status = napi_create_bigint_int64(env, c->videoFrame.timestamp, &param);
-    REJECT_STATUS;
-    c->status = napi_set_named_property(env, result, "timestamp", param);
-    REJECT_STATUS;
-  }
-
-  c->status = napi_create_int32(env, c->videoFrame.FourCC, &param);
-  REJECT_STATUS;
-  c->status = napi_set_named_property(env, result, "fourCC", param);
-  REJECT_STATUS;
-
-  c->status = napi_create_int32(env, c->videoFrame.frame_format_type, &param);
-  REJECT_STATUS;
-  c->status = napi_set_named_property(env, result, "frameFormatType", param);
+  if (asyncStatus != napi_ok) {
+    c->status = asyncStatus;
+    c->errorMsg = "Async video frame receive failed to complete.";
+  }
   REJECT_STATUS;
 
-  c->status = napi_create_bigint_int64(env, c->videoFrame.timecode, &param);
-  REJECT_STATUS;
-  c->status = napi_set_named_property(env, result, "timecode", param);
-  REJECT_STATUS;
+  ReceiveFrameGuard guard(c, NDIlib_frame_type_video);
 
-  c->status =
-      napi_create_int32(env, c->videoFrame.line_stride_in_bytes, &param);
-  REJECT_STATUS;
-  c->status = napi_set_named_property(env, result, "lineStrideBytes", param);
+  napi_value result;
+  c->status = createVideoFrameObject(env, c->videoFrame,
+                                     c->videoFrame.p_metadata, &c->buffer,
+                                     &result);
   REJECT_STATUS;
 
-  if (c->videoFrame.p_metadata != nullptr) {
-    c->status = napi_create_string_utf8(env, c->videoFrame.p_metadata,
-                                        NAPI_AUTO_LENGTH, &param);
+  napi_value param;
+  if (c->hashed) {
+    char text[kFrameHashLength + 1];
+    size_t length =
+        formatFrameHash(c->hash, c->instance->hash->algorithm, text);
+    c->status = napi_create_string_utf8(env, text, length, &param);
     REJECT_STATUS;
-    c->status = napi_set_named_property(env, result, "metadata", param);
+    c->status = napi_set_named_property(env, result, "hash", param);
+    REJECT_STATUS;
+    c->status = napi_get_boolean(env, c->duplicate, &param);
+    REJECT_STATUS;
+    c->status = napi_set_named_property(env, result, "duplicate", param);
+    REJECT_STATUS;
+  }
+  if (c->instance->hash && c->instance->hash->skipDuplicates) {
+    c->status = napi_create_uint32(env, c->duplicatesSkipped, &param);
+    REJECT_STATUS;
+    c->status =
+        napi_set_named_property(env, result, "duplicatesSkipped", param);
+    REJECT_STATUS;
+  }
+  if (c->budgetDrops > 0) {
+    c->status = napi_create_uint32(env, c->budgetDrops, &param);
+    REJECT_STATUS;
+    c->status = napi_set_named_property(env, result, "budgetDrops", param);
     REJECT_STATUS;
   }
-
-  c->status = createExternalBuffer(env, &c->buffer, &param);
-  REJECT_STATUS;
-  c->status = napi_set_named_property(env, result, "data", param);
-  REJECT_STATUS;
 
   napi_status status;
   status = napi_resolve_deferred(env, c->_deferred, result);
@@ -806,7 +1449,7 @@ napi_value recvPerformance(napi_env env, napi_callback_info info) {
   void *recvInstance;
   if (!acquireNativeHandle(handle, &recvInstance))
     NAPI_THROW_ERROR("Receiver has been destroyed.");
-  NDIlib_recv_instance_t recv = (NDIlib_recv_instance_t)recvInstance;
+  NDIlib_recv_instance_t recv = ((receiveInstance *)recvInstance)->recv;
 
   NDIlib_recv_performance_t total{};
   NDIlib_recv_performance_t dropped{};
@@ -871,7 +1514,7 @@ napi_value recvQueue(napi_env env, napi_callback_info info) {
   void *recvInstance;
   if (!acquireNativeHandle(handle, &recvInstance))
     NAPI_THROW_ERROR("Receiver has been destroyed.");
-  NDIlib_recv_instance_t recv = (NDIlib_recv_instance_t)recvInstance;
+  NDIlib_recv_instance_t recv = ((receiveInstance *)recvInstance)->recv;
 
   NDIlib_recv_queue_t total{};
   NDIlib_recv_get_queue(recv, &total);
@@ -914,7 +1557,7 @@ napi_value recvConnections(napi_env env, napi_callback_info info) {
   void *recvInstance;
   if (!acquireNativeHandle(handle, &recvInstance))
     NAPI_THROW_ERROR("Receiver has been destroyed.");
-  NDIlib_recv_instance_t recv = (NDIlib_recv_instance_t)recvInstance;
+  NDIlib_recv_instance_t recv = ((receiveInstance *)recvInstance)->recv;
 
   int count = NDIlib_recv_get_no_connections(recv);
   releaseNativeHandle(handle);
@@ -925,6 +1568,68 @@ napi_value recvConnections(napi_env env, napi_callback_info info) {
   return result;
 }
 
+napi_value recvAvSync(napi_env env, napi_callback_info info) {
+  napi_status status;
+
+  napi_value thisValue;
+  status = napi_get_cb_info(env, info, nullptr, nullptr, &thisValue, nullptr);
+  CHECK_STATUS;
+
+  napi_value embedded;
+  status = napi_get_named_property(env, thisValue, "embedded", &embedded);
+  CHECK_STATUS;
+  void *recvData;
+  status = napi_get_value_external(env, embedded, &recvData);
+  CHECK_STATUS;
+  nativeHandle *handle = (nativeHandle *)recvData;
+  void *recvInstance;
+  if (!acquireNativeHandle(handle, &recvInstance))
+    NAPI_THROW_ERROR("Receiver has been destroyed.");
+  nativeHandleGuard guard(handle);
+  receiveInstance *instance = (receiveInstance *)recvInstance;
+
+  napi_value result;
+  if (!instance->avSync) {
+    status = napi_get_undefined(env, &result);
+    CHECK_STATUS;
+    return result;
+  }
+  status = instance->avSync->report(env, &result);
+  CHECK_STATUS;
+  return result;
+}
+
+napi_value recvFrameRateStats(napi_env env, napi_callback_info info) {
+  napi_status status;
+
+  napi_value thisValue;
+  status = napi_get_cb_info(env, info, nullptr, nullptr, &thisValue, nullptr);
+  CHECK_STATUS;
+
+  napi_value embedded;
+  status = napi_get_named_property(env, thisValue, "embedded", &embedded);
+  CHECK_STATUS;
+  void *recvData;
+  status = napi_get_value_external(env, embedded, &recvData);
+  CHECK_STATUS;
+  nativeHandle *handle = (nativeHandle *)recvData;
+  void *recvInstance;
+  if (!acquireNativeHandle(handle, &recvInstance))
+    NAPI_THROW_ERROR("Receiver has been destroyed.");
+  nativeHandleGuard guard(handle);
+  receiveInstance *instance = (receiveInstance *)recvInstance;
+
+  napi_value result;
+  if (!instance->frameRate) {
+    status = napi_get_undefined(env, &result);
+    CHECK_STATUS;
+    return result;
+  }
+  status = instance->frameRate->report(env, &result);
+  CHECK_STATUS;
+  return result;
+}
+
 napi_value setReceiveTally(napi_env env, napi_callback_info info) {
   napi_status status;
 
@@ -987,7 +1692,7 @@ napi_value setReceiveTally(napi_env env, napi_callback_info info) {
   void *recvInstance;
   if (!acquireNativeHandle(handle, &recvInstance))
     NAPI_THROW_ERROR("Receiver has been destroyed.");
-  NDIlib_recv_instance_t recv = (NDIlib_recv_instance_t)recvInstance;
+  NDIlib_recv_instance_t recv = ((receiveInstance *)recvInstance)->recv;
 
   NDIlib_recv_set_tally(recv, &tally);
   releaseNativeHandle(handle);
@@ -1013,7 +1718,7 @@ napi_value videoReceive(napi_env env, napi_callback_info info) {
   c->status = napi_get_cb_info(env, info, &argc, args, &thisValue, nullptr);
   REJECT_RETURN;
 
-  if (!acquireRecvFromThis(env, thisValue, &c->handle, &c->recv, c))
+  if (!acquireRecvFromThis(env, thisValue, c))
     REJECT_RETURN;
 
   if (argc >= 1 && !parseOptionalTimeout(env, args[0], c))
@@ -1033,6 +1738,288 @@ napi_value videoReceive(napi_env env, napi_callback_info info) {
   return promise;
 }
 
+// Sets the size, rate, format, and timing of the captured video frame, for
+// results that describe a frame without carrying it.
+napi_status setAnalyzedFrameProperties(napi_env env, dataCarrier *c,
+                                       napi_value result) {
+  napi_value param;
+  napi_status status;
+  const char *names[5] = {"xres", "yres", "frameRateN", "frameRateD",
+                          "fourCC"};
+  int32_t values[5] = {c->videoFrame.xres, c->videoFrame.yres,
+                       c->videoFrame.frame_rate_N, c->videoFrame.frame_rate_D,
+                       (int32_t)c->videoFrame.FourCC};
+  for (int i = 0; i < 5; i++) {
+    status = napi_create_int32(env, values[i], &param);
+    PASS_STATUS;
+    status = napi_set_named_property(env, result, names[i], param);
+    PASS_STATUS;
+  }
+
+  if (c->videoFrame.timestamp != NDIlib_recv_timestamp_undefined) {
+    status = napi_create_bigint_int64(env, c->videoFrame.timestamp, &param);
+    PASS_STATUS;
+    status = napi_set_named_property(env, result, "timestamp", param);
+    PASS_STATUS;
+  }
+
+  status = napi_create_bigint_int64(env, c->videoFrame.timecode, &param);
+  PASS_STATUS;
+  return napi_set_named_property(env, result, "timecode", param);
+}
+
+// Frees the captured video frame but keeps its header for the result.
+void releaseAnalyzedFrame(dataCarrier *c) {
+  NDIlib_recv_free_video_v2(c->recv, &c->videoFrame);
+  c->videoReleased = true;
+  c->videoFrame.p_data = nullptr;
+  c->videoFrame.p_metadata = nullptr;
+}
+
+// Bins the next video frame in the SDK's buffer and frees it, so the frame
+// is never copied.
+void scopesReceiveExecute(napi_env env, void *data) {
+  scopesCarrier *c = (scopesCarrier *)data;
+
+  if (!captureUntilFrame(
+          c, NDIlib_frame_type_video, c->wait, GRANDI_NOT_FOUND,
+          "No video data received in the requested time interval.",
+          "Received error response from NDI video request. Connection lost."))
+    return;
+
+  trackCapturedVideo(c);
+  bool computed = computeScopes(c->videoFrame, c->options, &c->result);
+  releaseAnalyzedFrame(c);
+  if (!computed) {
+    c->errorMsg = "Failed to allocate scope bins.";
+    c->status = GRANDI_ALLOCATION_FAILURE;
+  }
+}
+
+void scopesReceiveComplete(napi_env env, napi_status asyncStatus,
+                           void *data) {
+  scopesCarrier *c = (scopesCarrier *)data;
+
+  if (asyncStatus != napi_ok) {
+    c->status = asyncStatus;
+    c->errorMsg = "Async video scopes receive failed to complete.";
+  }
+  REJECT_STATUS;
+
+  ReceiveFrameGuard guard(c, NDIlib_frame_type_video);
+
+  napi_value result;
+  c->status = napi_create_object(env, &result);
+  REJECT_STATUS;
+  c->status = setAnalyzedFrameProperties(env, c, result);
+  REJECT_STATUS;
+  c->status = setScopeProperties(env, &c->result, result);
+  REJECT_STATUS;
+
+  napi_status status;
+  status = napi_resolve_deferred(env, c->_deferred, result);
+  FLOATING_STATUS;
+
+  tidyCarrier(env, c);
+}
+
+napi_value scopesReceive(napi_env env, napi_callback_info info) {
+  napi_valuetype type;
+  scopesCarrier *c = createCarrier<scopesCarrier>(env);
+  if (c == nullptr)
+    return nullptr;
+
+  napi_value promise;
+  c->status = napi_create_promise(env, &c->_deferred, &promise);
+  REJECT_RETURN;
+
+  size_t argc = 2;
+  napi_value args[2];
+  napi_value thisValue;
+  c->status = napi_get_cb_info(env, info, &argc, args, &thisValue, nullptr);
+  REJECT_RETURN;
+
+  if (!acquireRecvFromThis(env, thisValue, c))
+    REJECT_RETURN;
+
+  napi_value waitValue = nullptr;
+  if (argc >= 1) {
+    c->status = napi_typeof(env, args[0], &type);
+    REJECT_RETURN;
+    if (type == napi_number) {
+      waitValue = args[0];
+    } else {
+      c->status =
+          parseScopeOptions(env, args[0], &c->options, &c->errorMsg);
+      REJECT_RETURN;
+      if (!c->errorMsg.empty())
+        REJECT_ERROR_RETURN(c->errorMsg, GRANDI_INVALID_ARGS);
+      if (argc >= 2)
+        waitValue = args[1];
+    }
+  }
+  if (waitValue != nullptr && !parseOptionalTimeout(env, waitValue, c))
+    REJECT_RETURN;
+
+  napi_value resource_name;
+  c->status = napi_create_string_utf8(env, "ScopesReceive", NAPI_AUTO_LENGTH,
+                                      &resource_name);
+  REJECT_RETURN;
+  c->status =
+      napi_create_async_work(env, NULL, resource_name, scopesReceiveExecute,
+                             scopesReceiveComplete, c, &c->_request);
+  REJECT_RETURN;
+  c->status = napi_queue_async_work(env, c->_request);
+  REJECT_RETURN;
+
+  return promise;
+}
+
+// Scores video frames in the SDK's buffer against the previous one and
+// frees them uncopied. With waitForMotion, quiet frames only update the
+// detector until a cell is active or the wait runs out.
+void motionReceiveExecute(napi_env env, void *data) {
+  motionCarrier *c = (motionCarrier *)data;
+  motionDetector *detector = c->instance->motion.get();
+
+  auto start = std::chrono::steady_clock::now();
+  while (true) {
+    if (!captureUntilFrame(
+            c, NDIlib_frame_type_video, remainingWaitMs(c->wait, start),
+            GRANDI_NOT_FOUND,
+            c->framesAnalyzed == 0
+                ? "No video data received in the requested time interval."
+                : "No motion detected in the requested time interval.",
+            "Received error response from NDI video request. Connection "
+            "lost."))
+      return;
+
+    trackCapturedVideo(c);
+    bool analyzed;
+    {
+      std::lock_guard<std::mutex> lock(detector->mutex);
+      analyzed = detector->analyze(c->videoFrame, &c->result);
+    }
+    c->framesAnalyzed++;
+    if (!analyzed) {
+      releaseAnalyzedFrame(c);
+      c->errorMsg = "Failed to allocate motion detection planes.";
+      c->status = GRANDI_ALLOCATION_FAILURE;
+      return;
+    }
+    if (!c->waitForMotion || !c->result.active.empty())
+      break;
+    NDIlib_recv_free_video_v2(c->recv, &c->videoFrame);
+    c->videoFrame = NDIlib_video_frame_v2_t{};
+    if (c->wait != 0 && remainingWaitMs(c->wait, start) == 0) {
+      c->errorMsg = "No motion detected in the requested time interval.";
+      c->status = GRANDI_NOT_FOUND;
+      return;
+    }
+  }
+  releaseAnalyzedFrame(c);
+}
+
+void motionReceiveComplete(napi_env env, napi_status asyncStatus,
+                           void *data) {
+  motionCarrier *c = (motionCarrier *)data;
+
+  if (asyncStatus != napi_ok) {
+    c->status = asyncStatus;
+    c->errorMsg = "Async motion receive failed to complete.";
+  }
+  REJECT_STATUS;
+
+  ReceiveFrameGuard guard(c, NDIlib_frame_type_video);
+
+  napi_value result, param;
+  c->status = napi_create_object(env, &result);
+  REJECT_STATUS;
+  c->status = setAnalyzedFrameProperties(env, c, result);
+  REJECT_STATUS;
+  c->status = setMotionProperties(env, c->result, result);
+  REJECT_STATUS;
+  c->status = napi_create_uint32(env, c->framesAnalyzed, &param);
+  REJECT_STATUS;
+  c->status = napi_set_named_property(env, result, "framesAnalyzed", param);
+  REJECT_STATUS;
+
+  napi_status status;
+  status = napi_resolve_deferred(env, c->_deferred, result);
+  FLOATING_STATUS;
+
+  tidyCarrier(env, c);
+}
+
+napi_value motionReceive(napi_env env, napi_callback_info info) {
+  napi_valuetype type;
+  motionCarrier *c = createCarrier<motionCarrier>(env);
+  if (c == nullptr)
+    return nullptr;
+
+  napi_value promise;
+  c->status = napi_create_promise(env, &c->_deferred, &promise);
+  REJECT_RETURN;
+
+  size_t argc = 2;
+  napi_value args[2];
+  napi_value thisValue;
+  c->status = napi_get_cb_info(env, info, &argc, args, &thisValue, nullptr);
+  REJECT_RETURN;
+
+  if (!acquireRecvFromThis(env, thisValue, c))
+    REJECT_RETURN;
+  if (!c->instance->motion)
+    REJECT_ERROR_RETURN("Receiver was not created with the motion option.",
+                        GRANDI_INVALID_ARGS);
+
+  napi_value waitValue = nullptr;
+  if (argc >= 1) {
+    c->status = napi_typeof(env, args[0], &type);
+    REJECT_RETURN;
+    if (type == napi_number) {
+      waitValue = args[0];
+    } else if (type != napi_undefined) {
+      bool isArray = false;
+      c->status = napi_is_array(env, args[0], &isArray);
+      REJECT_RETURN;
+      if (type != napi_object || isArray)
+        REJECT_ERROR_RETURN("Motion options must be an object.",
+                            GRANDI_INVALID_ARGS);
+      napi_value param;
+      c->status =
+          napi_get_named_property(env, args[0], "waitForMotion", &param);
+      REJECT_RETURN;
+      c->status = napi_typeof(env, param, &type);
+      REJECT_RETURN;
+      if (type == napi_boolean) {
+        c->status = napi_get_value_bool(env, param, &c->waitForMotion);
+        REJECT_RETURN;
+      } else if (type != napi_undefined) {
+        REJECT_ERROR_RETURN("waitForMotion must be a Boolean.",
+                            GRANDI_INVALID_ARGS);
+      }
+      if (argc >= 2)
+        waitValue = args[1];
+    }
+  }
+  if (waitValue != nullptr && !parseOptionalTimeout(env, waitValue, c))
+    REJECT_RETURN;
+
+  napi_value resource_name;
+  c->status = napi_create_string_utf8(env, "MotionReceive", NAPI_AUTO_LENGTH,
+                                      &resource_name);
+  REJECT_RETURN;
+  c->status =
+      napi_create_async_work(env, NULL, resource_name, motionReceiveExecute,
+                             motionReceiveComplete, c, &c->_request);
+  REJECT_RETURN;
+  c->status = napi_queue_async_work(env, c->_request);
+  REJECT_RETURN;
+
+  return promise;
+}
+
 void audioReceiveExecute(napi_env env, void *data) {
   dataCarrier *c = (dataCarrier *)data;
 
@@ -1042,6 +2029,7 @@ void audioReceiveExecute(napi_env env, void *data) {
           "Received error response from NDI audio request. Connection lost."))
     return;
 
+  trackCapturedAudio(c);
   if (!convertCapturedAudio(c))
     return;
 }
@@ -1164,7 +2152,7 @@ napi_value dataAndAudioReceive(napi_env env, napi_callback_info info,
   c->status = napi_get_cb_info(env, info, &argc, args, &thisValue, nullptr);
   REJECT_RETURN;
 
-  if (!acquireRecvFromThis(env, thisValue, &c->handle, &c->recv, c))
+  if (!acquireRecvFromThis(env, thisValue, c))
     REJECT_RETURN;
 
   if (argc >= 1) {
@@ -1320,7 +2308,7 @@ napi_value metadataReceive(napi_env env, napi_callback_info info) {
   c->status = napi_get_cb_info(env, info, &argc, args, &thisValue, nullptr);
   REJECT_RETURN;
 
-  if (!acquireRecvFromThis(env, thisValue, &c->handle, &c->recv, c, true))
+  if (!acquireRecvFromThis(env, thisValue, c, true))
     REJECT_RETURN;
 
   if (argc >= 1 && !parseOptionalTimeout(env, args[0], c))
@@ -1343,18 +2331,62 @@ napi_value metadataReceive(napi_env env, napi_callback_info info) {
 void dataReceiveExecute(napi_env env, void *data) {
   dataCarrier *c = (dataCarrier *)data;
 
+  if (c->instance->frameRate) {
+    convertCapturedData(c);
+    switch (c->frameType) {
+    case NDIlib_frame_type_video:
+      hashConvertedVideo(c);
+      stampCapturedVideo(c);
+      break;
+    case NDIlib_frame_type_audio:
+      trackCapturedAudio(c);
+      convertCapturedAudio(c);
+      break;
+    default:
+      break;
+    }
+    c->reservation.release();
+    return;
+  }
+
+  auto start = std::chrono::steady_clock::now();
   c->frameType = NDIlib_recv_capture_v3(c->recv, &c->videoFrame, &c->audioFrame,
                                         &c->metadataFrame, c->wait);
+  // Skipped duplicates and frames over the frame budget spend the same
+  // timeout as the first capture.
+  while (c->frameType == NDIlib_frame_type_video) {
+    trackCapturedVideo(c);
+    if (!hashCapturedVideo(c, c->videoFrame)) {
+      if (admitCapturedVideo(c, true))
+        break;
+    } else {
+      NDIlib_recv_free_video_v2(c->recv, &c->videoFrame);
+      c->videoFrame = NDIlib_video_frame_v2_t{};
+    }
+    // Like a capture that times out.
+    if (remainingWaitMs(c->wait, start) == 0) {
+      c->frameType = NDIlib_frame_type_none;
+      break;
+    }
+    c->frameType =
+        NDIlib_recv_capture_v3(c->recv, &c->videoFrame, &c->audioFrame,
+                               &c->metadataFrame,
+                               remainingWaitMs(c->wait, start));
+  }
   switch (c->frameType) {
   case NDIlib_frame_type_video:
-    copyCapturedVideo(c);
+    if (copyCapturedVideo(c))
+      stampCapturedVideo(c);
     break;
   case NDIlib_frame_type_audio:
+    trackCapturedAudio(c);
     convertCapturedAudio(c);
     break;
   default:
     break;
   }
+  // The copy, if any, is now counted by the frame allocator.
+  c->reservation.release();
 }
 
 void dataReceiveComplete(napi_env env, napi_status asyncStatus, void *data) {
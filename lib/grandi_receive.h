@@ -16,13 +16,30 @@
 #ifndef GRANDI_RECEIVE_H
 #define GRANDI_RECEIVE_H
 
+#include <atomic>
+#include <cstdint>
 #include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <string>
 #include "node_api.h"
+#include "grandi_avsync.h"
+#include "grandi_budget.h"
+#include "grandi_deinterlace.h"
+#include "grandi_framerate.h"
+#include "grandi_hash.h"
+#include "grandi_motion.h"
+#include "grandi_scale.h"
+#include "grandi_scopes.h"
+#include "grandi_timecode.h"
 #include "grandi_util.h"
 
 napi_value receive(napi_env env, napi_callback_info info);
 napi_value destroyReceive(napi_env env, napi_callback_info info);
+napi_value detachReceive(napi_env env, napi_callback_info info);
 napi_value videoReceive(napi_env env, napi_callback_info info);
+napi_value scopesReceive(napi_env env, napi_callback_info info);
+napi_value motionReceive(napi_env env, napi_callback_info info);
 napi_value audioReceive(napi_env env, napi_callback_info info);
 napi_value metadataReceive(napi_env env, napi_callback_info info);
 napi_value dataReceive(napi_env env, napi_callback_info info);
@@ -30,6 +47,38 @@ napi_value recvPerformance(napi_env env, napi_callback_info info);
 napi_value recvQueue(napi_env env, napi_callback_info info);
 napi_value recvConnections(napi_env env, napi_callback_info info);
 napi_value setReceiveTally(napi_env env, napi_callback_info info);
+napi_value recvAvSync(napi_env env, napi_callback_info info);
+napi_value recvFrameRateStats(napi_env env, napi_callback_info info);
+
+// Value held by a receiver's nativeHandle: the SDK instance plus any
+// per-receiver state updated on capture threads.
+struct receiveInstance {
+  NDIlib_recv_instance_t recv = nullptr;
+  std::string sourceName;
+  // Creation settings, reported on the receiver object.
+  std::string sourceUrl;
+  bool hasSourceUrl = false;
+  NDIlib_recv_color_format_e colorFormat = NDIlib_recv_color_format_fastest;
+  NDIlib_recv_bandwidth_e bandwidth = NDIlib_recv_bandwidth_highest;
+  bool allowVideoFields = true;
+  std::string name;
+  bool hasName = false;
+  std::unique_ptr<avSyncTracker> avSync;
+  std::unique_ptr<frameRateConverter> frameRate;
+  std::unique_ptr<deinterlacer> deinterlace;
+  std::unique_ptr<burnInOptions> burnIn;
+  // Video frames stamped so far, for the burn-in frame counter.
+  std::atomic<int64_t> framesStamped{0};
+  std::unique_ptr<frameHashOptions> hash;
+  // Hash of the last video frame captured, to spot duplicates.
+  std::mutex hashMutex;
+  frameHash lastHash;
+  bool hasLastHash = false;
+  std::unique_ptr<motionDetector> motion;
+  // Halves frames the frame budget admits only at a reduced size.
+  std::mutex reducerMutex;
+  videoScaler reducer;
+};
 
 struct receiveCarrier : carrier {
   nativeSource source;
@@ -37,12 +86,40 @@ struct receiveCarrier : carrier {
   NDIlib_recv_bandwidth_e bandwidth = NDIlib_recv_bandwidth_highest;
   bool allowVideoFields = true;
   std::unique_ptr<char[]> name;
-  NDIlib_recv_instance_t recv;
+  bool avSync = false;
+  avSyncOptions avSyncConfig;
+  bool convertFrameRate = false;
+  frameRateOptions frameRateConfig;
+  bool deinterlace = false;
+  deinterlaceOptions deinterlaceConfig;
+  bool burnIn = false;
+  burnInOptions burnInConfig;
+  bool hash = false;
+  frameHashOptions hashConfig;
+  bool motion = false;
+  motionOptions motionConfig;
+  receiveInstance *instance = nullptr;
+  ~receiveCarrier();
 };
 
+// Builds the receiver object around handle, whose value is a
+// receiveInstance, for receive() and adopt(). On failure the receiveInstance
+// is destroyed, and handle is freed now or when its external is collected.
+napi_status makeReceiverObject(napi_env env, nativeHandle *handle,
+                               napi_value *result);
+
+// Binds the receiver object `receiver` for exclusive native capture, as
+// FrameSync, sync groups, and multiviewers do, so its capture methods are
+// unavailable until releaseNativeCaptureBinding(*handle). label names the
+// option in errors. On failure sets c->status and c->errorMsg.
+bool bindReceiverCapture(napi_env env, napi_value receiver,
+                         const std::string &label, nativeHandle **handle,
+                         receiveInstance **instance, carrier *c);
+
 struct dataCarrier : carrier {
   nativeHandle *handle = nullptr;
   uint32_t wait = 10000;
+  receiveInstance *instance = nullptr;
   NDIlib_recv_instance_t recv;
   NDIlib_frame_type_e frameType = NDIlib_frame_type_none;
   NDIlib_video_frame_v2_t videoFrame{};
@@ -53,10 +130,37 @@ struct dataCarrier : carrier {
   int32_t referenceLevel = 20;
   Grandi_audio_format_e audioFormat = Grandi_audio_format_float_32_separate;
   NDIlib_metadata_frame_t metadataFrame{};
+  // Set when videoFrame describes a copy and no SDK frame must be freed.
+  bool videoReleased = false;
+  std::string videoMetadata;
+  // Set when the receiver hashes video and videoFrame was hashed.
+  bool hashed = false;
+  bool duplicate = false;
+  frameHash hash;
+  // Duplicate frames freed unseen before this one.
+  uint32_t duplicatesSkipped = 0;
+  // Video frames the frame budget refused during this capture.
+  uint32_t budgetDrops = 0;
+  // Set when the frame budget admitted the frame at half size.
+  bool reduceVideo = false;
+  // Bytes the frame budget admitted for the frame being copied.
+  budgetReservation reservation;
   ~dataCarrier() {
     if (handle != nullptr)
       releaseNativeHandle(handle);
   }
 };
 
+struct scopesCarrier : dataCarrier {
+  scopeOptions options;
+  scopeResult result;
+};
+
+struct motionCarrier : dataCarrier {
+  // Keeps scoring frames until a cell is active.
+  bool waitForMotion = false;
+  motionResult result;
+  uint32_t framesAnalyzed = 0;
+};
+
 #endif /* GRANDI_RECEIVE_H */
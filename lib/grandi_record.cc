@@ -0,0 +1,861 @@
+/* Copyright 2025 Sarhan Aissi <github@tux.tn>.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+*/
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <Processing.NDI.Lib.h>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+#include "grandi_record.h"
+#include "grandi_lz4.h"
+#include "grandi_pool.h"
+#include "grandi_receive.h"
+#include "grandi_thread.h"
+#include "grandi_util.h"
+
+namespace {
+const int kWaitMs = 100;
+const uint32_t kMaxThreads = 64;
+const uint32_t kMaxStripes = 64;
+const uint32_t kDefaultStripes = 8;
+const uint32_t kDefaultSyncIntervalMs = 1000;
+const uint32_t kMaxSyncIntervalMs = 60000;
+// Smaller stripes cost more in bookkeeping than they gain in parallelism,
+// so small frames, audio in particular, use fewer stripes.
+const size_t kMinStripeBytes = 64 * 1024;
+
+enum class recordCompression { none, lz4 };
+
+struct stripeTask {
+  const uint8_t *source = nullptr;
+  size_t size = 0;
+  uint8_t *output = nullptr;
+  uint32_t *table = nullptr;
+  // Size as stored in the stripe table.
+  uint32_t stored = 0;
+};
+
+struct frameRecorder {
+  napi_env env = nullptr;
+  nativeHandle *recvHandle = nullptr;
+  NDIlib_recv_instance_t recv = nullptr;
+  napi_ref receiverRef = nullptr;
+  std::string path;
+  bool replace = false;
+  bool audio = false;
+  recordCompression compression = recordCompression::lz4;
+  uint32_t threads = 1;
+  uint32_t stripes = kDefaultStripes;
+  uint32_t syncIntervalMs = kDefaultSyncIntervalMs;
+  FILE *file = nullptr;
+  std::string indexPath;
+  FILE *indexFile = nullptr;
+  threadRole role;
+  workerPool pool;
+  std::thread thread;
+
+  // Owned by the recording thread.
+  uint64_t offset = 0;
+  std::vector<stripeTask> tasks;
+  std::vector<uint32_t> stripeSizes;
+  ownedBuffer compressed;
+  ownedBuffer tables;
+  std::vector<recordIndexEntry> index;
+  // Entries of index already appended to the sidecar.
+  size_t indexSynced = 0;
+  std::chrono::steady_clock::time_point lastSync;
+
+  // Guarded by mutex.
+  bool stopping = false;
+  // Set once a write failed; nothing is recorded after it.
+  bool failed = false;
+  uint64_t framesRecorded = 0;
+  uint64_t audioFramesRecorded = 0;
+  uint64_t framesDropped = 0;
+  uint64_t bytesIn = 0;
+  uint64_t bytesOut = 0;
+  double compressSumMs = 0.0;
+  double compressMaxMs = 0.0;
+  double writeSumMs = 0.0;
+  double writeMaxMs = 0.0;
+  uint64_t syncs = 0;
+  double syncSumMs = 0.0;
+  double syncMaxMs = 0.0;
+  std::string lastError;
+  std::mutex mutex;
+};
+
+struct recordCarrier : carrier {
+  frameRecorder *recorder = nullptr;
+  ~recordCarrier();
+};
+
+double elapsedMs(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(
+             std::chrono::steady_clock::now() - start)
+      .count();
+}
+
+void compressStripe(void *context, size_t index) {
+  stripeTask &task = ((stripeTask *)context)[index];
+  size_t size = lz4Compress(task.source, task.size, task.output, task.table);
+  task.stored = size < task.size ? (uint32_t)size
+                                 : (uint32_t)task.size | kRecordStripeRaw;
+}
+
+bool writeBytes(frameRecorder *recorder, const void *data, size_t size) {
+  if (size > 0 && fwrite(data, 1, size, recorder->file) != size)
+    return false;
+  recorder->offset += size;
+  return true;
+}
+
+// Compresses and appends one record. Returns false when writing failed.
+bool writeRecord(frameRecorder *recorder, recordHeader &header,
+                 const uint8_t *data, size_t size) {
+  header.rawBytes = size;
+  header.storedBytes = size;
+  header.codec = recordUncompressed;
+  header.stripes = 0;
+  size_t stripes = 0;
+  double compressMs = 0.0;
+  if (recorder->compression == recordCompression::lz4) {
+    stripes = std::max<size_t>(
+        1, std::min<size_t>(recorder->stripes, size / kMinStripeBytes));
+    // Stripe sizes carry a flag in their top bit.
+    if (size / stripes >= kRecordStripeRaw)
+      stripes = 0;
+  }
+  if (stripes > 0) {
+    size_t capacity = lz4Bound(size) + 16 * stripes;
+    if (!(recorder->compressed.size >= capacity ||
+          recorder->compressed.allocate(capacity))) {
+      std::lock_guard<std::mutex> lock(recorder->mutex);
+      recorder->framesDropped++;
+      recorder->lastError = "Failed to allocate a compression buffer.";
+      return true;
+    }
+    auto start = std::chrono::steady_clock::now();
+    recorder->tasks.resize(stripes);
+    uint8_t *output = (uint8_t *)recorder->compressed.data;
+    for (size_t i = 0; i < stripes; i++) {
+      stripeTask &task = recorder->tasks[i];
+      size_t begin = size * i / stripes;
+      task.source = data + begin;
+      task.size = size * (i + 1) / stripes - begin;
+      task.output = output;
+      task.table = (uint32_t *)recorder->tables.data + kLz4TableEntries * i;
+      output += lz4Bound(task.size);
+    }
+    recorder->pool.run(stripes, compressStripe, recorder->tasks.data());
+    compressMs = elapsedMs(start);
+
+    recorder->stripeSizes.resize(stripes);
+    header.codec = recordLz4;
+    header.stripes = (uint32_t)stripes;
+    header.storedBytes = stripes * sizeof(uint32_t);
+    for (size_t i = 0; i < stripes; i++) {
+      recorder->stripeSizes[i] = recorder->tasks[i].stored;
+      header.storedBytes += recorder->tasks[i].stored & ~kRecordStripeRaw;
+    }
+  }
+
+  recordIndexEntry entry = {};
+  entry.offset = recorder->offset;
+  entry.timestamp = header.timestamp;
+  entry.timecode = header.timecode;
+  entry.type = header.type;
+
+  auto start = std::chrono::steady_clock::now();
+  bool written = writeBytes(recorder, &header, sizeof(header));
+  if (stripes == 0) {
+    written = written && writeBytes(recorder, data, size);
+  } else {
+    written = written &&
+              writeBytes(recorder, recorder->stripeSizes.data(),
+                         stripes * sizeof(uint32_t));
+    for (size_t i = 0; i < stripes && written; i++) {
+      const stripeTask &task = recorder->tasks[i];
+      if (task.stored & kRecordStripeRaw)
+        written = writeBytes(recorder, task.source, task.size);
+      else
+        written = writeBytes(recorder, task.output, task.stored);
+    }
+  }
+  double writeMs = elapsedMs(start);
+  if (written)
+    recorder->index.push_back(entry);
+
+  std::lock_guard<std::mutex> lock(recorder->mutex);
+  if (!written) {
+    recorder->failed = true;
+    recorder->lastError =
+        "Failed to write " + recorder->path + ": " + strerror(errno);
+    return false;
+  }
+  if (header.type == recordVideo)
+    recorder->framesRecorded++;
+  else
+    recorder->audioFramesRecorded++;
+  recorder->bytesIn += size;
+  recorder->bytesOut += header.storedBytes;
+  recorder->compressSumMs += compressMs;
+  recorder->compressMaxMs = std::max(recorder->compressMaxMs, compressMs);
+  recorder->writeSumMs += writeMs;
+  recorder->writeMaxMs = std::max(recorder->writeMaxMs, writeMs);
+  return true;
+}
+
+void dropFrame(frameRecorder *recorder, const char *reason) {
+  std::lock_guard<std::mutex> lock(recorder->mutex);
+  recorder->framesDropped++;
+  recorder->lastError = reason;
+}
+
+bool recordVideoFrame(frameRecorder *recorder,
+                      const NDIlib_video_frame_v2_t &frame) {
+  size_t size = frame.p_data != nullptr ? videoDataSize(frame) : 0;
+  if (size == 0) {
+    dropFrame(recorder, "Video frame has no data.");
+    return true;
+  }
+  recordHeader header = {};
+  header.type = recordVideo;
+  header.timestamp = frame.timestamp;
+  header.timecode = frame.timecode;
+  header.fourCC = (int32_t)frame.FourCC;
+  header.xres = frame.xres;
+  header.yres = frame.yres;
+  header.lineStride = frame.line_stride_in_bytes;
+  header.frameRateN = frame.frame_rate_N;
+  header.frameRateD = frame.frame_rate_D;
+  header.pictureAspectRatio = frame.picture_aspect_ratio;
+  header.frameFormatType = (int32_t)frame.frame_format_type;
+  return writeRecord(recorder, header, frame.p_data, size);
+}
+
+bool recordAudioFrame(frameRecorder *recorder,
+                      const NDIlib_audio_frame_v3_t &frame) {
+  if (frame.p_data == nullptr || frame.no_samples <= 0 ||
+      frame.no_channels <= 0 ||
+      frame.FourCC != NDIlib_FourCC_audio_type_FLTP) {
+    dropFrame(recorder, "Audio frame has no data or is not planar float.");
+    return true;
+  }
+  recordHeader header = {};
+  header.type = recordAudio;
+  header.timestamp = frame.timestamp;
+  header.timecode = frame.timecode;
+  header.sampleRate = frame.sample_rate;
+  header.channels = frame.no_channels;
+  header.samples = frame.no_samples;
+  header.channelStride = frame.channel_stride_in_bytes;
+  size_t size = (size_t)frame.channel_stride_in_bytes * frame.no_channels;
+  return writeRecord(recorder, header, frame.p_data, size);
+}
+
+int syncFile(FILE *file) {
+#ifdef _WIN32
+  return _commit(_fileno(file));
+#else
+  return fsync(fileno(file));
+#endif
+}
+
+// Forces the recording to disk, then appends the entries recorded since the
+// last sync to the sidecar and forces that to disk too. In this order, the
+// sidecar never lists a record that could be lost in a crash.
+bool syncFiles(frameRecorder *recorder) {
+  auto start = std::chrono::steady_clock::now();
+  recorder->lastSync = start;
+  size_t pending = recorder->index.size() - recorder->indexSynced;
+  if (fflush(recorder->file) != 0 || syncFile(recorder->file) != 0)
+    return false;
+  if (pending > 0 &&
+      fwrite(recorder->index.data() + recorder->indexSynced,
+             sizeof(recordIndexEntry), pending,
+             recorder->indexFile) != pending)
+    return false;
+  if (fflush(recorder->indexFile) != 0 || syncFile(recorder->indexFile) != 0)
+    return false;
+  recorder->indexSynced += pending;
+
+  double syncMs = elapsedMs(start);
+  std::lock_guard<std::mutex> lock(recorder->mutex);
+  recorder->syncs++;
+  recorder->syncSumMs += syncMs;
+  recorder->syncMaxMs = std::max(recorder->syncMaxMs, syncMs);
+  return true;
+}
+
+void failSync(frameRecorder *recorder) {
+  std::lock_guard<std::mutex> lock(recorder->mutex);
+  recorder->failed = true;
+  recorder->lastError =
+      "Failed to sync " + recorder->path + ": " + strerror(errno);
+}
+
+// Appends the index and fills in the file header, which makes the
+// recording seekable without its sidecar.
+bool writeIndex(frameRecorder *recorder) {
+  uint64_t indexOffset = recorder->offset;
+  if (!writeBytes(recorder, recorder->index.data(),
+                  recorder->index.size() * sizeof(recordIndexEntry)))
+    return false;
+  uint64_t fields[2] = {indexOffset, recorder->index.size()};
+  return fseek(recorder->file, offsetof(recordFileHeader, indexOffset),
+               SEEK_SET) == 0 &&
+         fwrite(fields, sizeof(fields), 1, recorder->file) == 1 &&
+         fflush(recorder->file) == 0 && syncFile(recorder->file) == 0;
+}
+
+void runRecorder(frameRecorder *recorder) {
+  threadRegistration registration(recorder->role);
+  bool writing = true;
+  recorder->lastSync = std::chrono::steady_clock::now();
+  while (writing) {
+    {
+      std::lock_guard<std::mutex> lock(recorder->mutex);
+      if (recorder->stopping)
+        break;
+    }
+
+    NDIlib_video_frame_v2_t video{};
+    NDIlib_audio_frame_v3_t audio{};
+    NDIlib_frame_type_e type = NDIlib_recv_capture_v3(
+        recorder->recv, &video, recorder->audio ? &audio : nullptr, nullptr,
+        kWaitMs);
+    if (type == NDIlib_frame_type_error) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(kWaitMs));
+    } else if (type == NDIlib_frame_type_video) {
+      writing = recordVideoFrame(recorder, video);
+      NDIlib_recv_free_video_v2(recorder->recv, &video);
+    } else if (type == NDIlib_frame_type_audio) {
+      writing = recordAudioFrame(recorder, audio);
+      NDIlib_recv_free_audio_v3(recorder->recv, &audio);
+    }
+    if (writing && recorder->index.size() > recorder->indexSynced &&
+        elapsedMs(recorder->lastSync) >= recorder->syncIntervalMs &&
+        !syncFiles(recorder)) {
+      failSync(recorder);
+      writing = false;
+    }
+  }
+  if (writing && !syncFiles(recorder)) {
+    failSync(recorder);
+  } else if (writing && !writeIndex(recorder)) {
+    std::lock_guard<std::mutex> lock(recorder->mutex);
+    recorder->failed = true;
+    recorder->lastError = "Failed to write the index of " + recorder->path +
+                          ": " + strerror(errno);
+  }
+}
+
+// Stops the recording thread, which writes the index, closes the files, and
+// releases the receiver. Returns false when the recorder had already been
+// stopped.
+bool stopRecorder(napi_env env, frameRecorder *recorder) {
+  {
+    std::lock_guard<std::mutex> lock(recorder->mutex);
+    if (recorder->stopping)
+      return false;
+    recorder->stopping = true;
+  }
+  if (recorder->thread.joinable())
+    recorder->thread.join();
+  recorder->pool.stop();
+  if (recorder->file != nullptr)
+    fclose(recorder->file);
+  recorder->file = nullptr;
+  if (recorder->indexFile != nullptr)
+    fclose(recorder->indexFile);
+  recorder->indexFile = nullptr;
+  if (recorder->recvHandle != nullptr)
+    releaseNativeCaptureBinding(recorder->recvHandle);
+  recorder->recvHandle = nullptr;
+  recorder->recv = nullptr;
+  if (recorder->receiverRef != nullptr)
+    napi_delete_reference(env, recorder->receiverRef);
+  recorder->receiverRef = nullptr;
+  return true;
+}
+
+void finalizeRecorder(napi_env env, void *data, void *hint) {
+  frameRecorder *recorder = (frameRecorder *)data;
+  stopRecorder(env, recorder);
+  delete recorder;
+}
+
+recordCarrier::~recordCarrier() {
+  if (recorder != nullptr)
+    finalizeRecorder(recorder->env, recorder, nullptr);
+}
+
+bool acquireRecorderFromThis(napi_env env, napi_value thisValue,
+                             frameRecorder **recorder) {
+  napi_value recorderValue;
+  if (napi_get_named_property(env, thisValue, "embedded", &recorderValue) !=
+      napi_ok)
+    return false;
+  napi_valuetype type;
+  if (napi_typeof(env, recorderValue, &type) != napi_ok ||
+      type != napi_external)
+    return false;
+  void *externalData;
+  if (napi_get_value_external(env, recorderValue, &externalData) != napi_ok)
+    return false;
+  *recorder = (frameRecorder *)externalData;
+  return true;
+}
+
+napi_value destroyRecorder(napi_env env, napi_callback_info info) {
+  bool success = false;
+  napi_value thisValue;
+  size_t argc = 0;
+  frameRecorder *recorder = nullptr;
+  if (napi_get_cb_info(env, info, &argc, nullptr, &thisValue, nullptr) ==
+          napi_ok &&
+      acquireRecorderFromThis(env, thisValue, &recorder)) {
+    success = stopRecorder(env, recorder);
+    napi_value value;
+    if (napi_create_int32(env, 0, &value) == napi_ok)
+      napi_set_named_property(env, thisValue, "embedded", value);
+  }
+
+  napi_value result;
+  if (napi_get_boolean(env, success, &result) != napi_ok)
+    napi_get_boolean(env, false, &result);
+  return result;
+}
+
+napi_status setTimings(napi_env env, napi_value object, const char *name,
+                       double sumMs, double maxMs, uint64_t count) {
+  napi_value timings, value;
+  napi_status status = napi_create_object(env, &timings);
+  PASS_STATUS;
+  status = napi_create_double(env, count > 0 ? sumMs / (double)count : 0.0,
+                              &value);
+  PASS_STATUS;
+  status = napi_set_named_property(env, timings, "mean", value);
+  PASS_STATUS;
+  status = napi_create_double(env, maxMs, &value);
+  PASS_STATUS;
+  status = napi_set_named_property(env, timings, "max", value);
+  PASS_STATUS;
+  return napi_set_named_property(env, object, name, timings);
+}
+
+napi_value recorderStats(napi_env env, napi_callback_info info) {
+  napi_status status;
+  size_t argc = 0;
+  napi_value thisValue;
+  status = napi_get_cb_info(env, info, &argc, nullptr, &thisValue, nullptr);
+  CHECK_STATUS;
+
+  frameRecorder *recorder = nullptr;
+  if (!acquireRecorderFromThis(env, thisValue, &recorder))
+    NAPI_THROW_ERROR("Recorder has been destroyed.");
+
+  uint64_t counts[6];
+  double compressSumMs, compressMaxMs, writeSumMs, writeMaxMs, syncSumMs,
+      syncMaxMs;
+  bool failed;
+  std::string lastError;
+  {
+    std::lock_guard<std::mutex> lock(recorder->mutex);
+    counts[0] = recorder->framesRecorded;
+    counts[1] = recorder->audioFramesRecorded;
+    counts[2] = recorder->framesDropped;
+    counts[3] = recorder->bytesIn;
+    counts[4] = recorder->bytesOut;
+    counts[5] = recorder->syncs;
+    compressSumMs = recorder->compressSumMs;
+    compressMaxMs = recorder->compressMaxMs;
+    writeSumMs = recorder->writeSumMs;
+    writeMaxMs = recorder->writeMaxMs;
+    syncSumMs = recorder->syncSumMs;
+    syncMaxMs = recorder->syncMaxMs;
+    failed = recorder->failed;
+    lastError = recorder->lastError;
+  }
+
+  napi_value result, value;
+  status = napi_create_object(env, &result);
+  CHECK_STATUS;
+  const char *names[6] = {"framesRecorded", "audioFramesRecorded",
+                          "framesDropped", "bytesIn", "bytesOut", "syncs"};
+  for (int i = 0; i < 6; i++) {
+    status = napi_create_double(env, (double)counts[i], &value);
+    CHECK_STATUS;
+    status = napi_set_named_property(env, result, names[i], value);
+    CHECK_STATUS;
+  }
+  status = napi_create_double(
+      env, counts[4] > 0 ? (double)counts[3] / (double)counts[4] : 1.0,
+      &value);
+  CHECK_STATUS;
+  status = napi_set_named_property(env, result, "ratio", value);
+  CHECK_STATUS;
+
+  uint64_t records = counts[0] + counts[1];
+  status = setTimings(env, result, "compressMs", compressSumMs, compressMaxMs,
+                      records);
+  CHECK_STATUS;
+  status =
+      setTimings(env, result, "writeMs", writeSumMs, writeMaxMs, records);
+  CHECK_STATUS;
+  status =
+      setTimings(env, result, "syncMs", syncSumMs, syncMaxMs, counts[5]);
+  CHECK_STATUS;
+
+  status = napi_get_boolean(env, failed, &value);
+  CHECK_STATUS;
+  status = napi_set_named_property(env, result, "failed", value);
+  CHECK_STATUS;
+  if (!lastError.empty()) {
+    status = napi_create_string_utf8(env, lastError.c_str(), NAPI_AUTO_LENGTH,
+                                     &value);
+    CHECK_STATUS;
+    status = napi_set_named_property(env, result, "lastError", value);
+    CHECK_STATUS;
+  }
+  return result;
+}
+
+// Reads an optional integer property into *result, which keeps its default
+// when the property is undefined.
+bool parseOptionalInteger(napi_env env, napi_value object, const char *name,
+                          uint32_t min, uint32_t max, uint32_t *result,
+                          carrier *c) {
+  napi_value value;
+  c->status = napi_get_named_property(env, object, name, &value);
+  if (c->status != napi_ok)
+    return false;
+  napi_valuetype type;
+  c->status = napi_typeof(env, value, &type);
+  if (c->status != napi_ok)
+    return false;
+  if (type == napi_undefined)
+    return true;
+  uint32_t parsed = 0;
+  c->status = parseUint32Value(env, value, name, &parsed, &c->errorMsg);
+  if (c->status != napi_ok)
+    return false;
+  if (!c->errorMsg.empty() || parsed < min || parsed > max) {
+    c->status = GRANDI_INVALID_ARGS;
+    c->errorMsg = std::string(name) + " must be an integer between " +
+                  std::to_string(min) + " and " + std::to_string(max) + ".";
+    return false;
+  }
+  *result = parsed;
+  return true;
+}
+
+// Reads an optional Boolean property into *result.
+bool parseOptionalBoolean(napi_env env, napi_value object, const char *name,
+                          bool *result, carrier *c) {
+  napi_value value;
+  c->status = napi_get_named_property(env, object, name, &value);
+  if (c->status != napi_ok)
+    return false;
+  napi_valuetype type;
+  c->status = napi_typeof(env, value, &type);
+  if (c->status != napi_ok)
+    return false;
+  if (type == napi_boolean) {
+    c->status = napi_get_value_bool(env, value, result);
+    return c->status == napi_ok;
+  }
+  if (type != napi_undefined) {
+    c->status = GRANDI_INVALID_ARGS;
+    c->errorMsg = std::string(name) + " must be a Boolean.";
+    return false;
+  }
+  return true;
+}
+
+bool parseRecordOptions(napi_env env, napi_callback_info info,
+                        frameRecorder *recorder, napi_value *receiver,
+                        carrier *c) {
+  size_t argc = 1;
+  napi_value options;
+  c->status = napi_get_cb_info(env, info, &argc, &options, nullptr, nullptr);
+  if (c->status != napi_ok)
+    return false;
+  napi_valuetype type = napi_undefined;
+  bool isArray = false;
+  if (argc >= 1) {
+    c->status = napi_typeof(env, options, &type);
+    if (c->status != napi_ok)
+      return false;
+    c->status = napi_is_array(env, options, &isArray);
+    if (c->status != napi_ok)
+      return false;
+  }
+  if (type != napi_object || isArray) {
+    c->status = GRANDI_INVALID_ARGS;
+    c->errorMsg = "Record options must be an object.";
+    return false;
+  }
+
+  napi_value value;
+  c->status = napi_get_named_property(env, options, "path", &value);
+  if (c->status != napi_ok)
+    return false;
+  c->status = napi_typeof(env, value, &type);
+  if (c->status != napi_ok)
+    return false;
+  std::unique_ptr<char[]> text;
+  if (type == napi_string && !readUtf8String(env, value, &text, c))
+    return false;
+  if (type != napi_string || text[0] == '\0') {
+    c->status = GRANDI_INVALID_ARGS;
+    c->errorMsg = "path must be a non-empty string.";
+    return false;
+  }
+  recorder->path = text.get();
+
+  c->status = napi_get_named_property(env, options, "compression", &value);
+  if (c->status != napi_ok)
+    return false;
+  c->status = napi_typeof(env, value, &type);
+  if (c->status != napi_ok)
+    return false;
+  if (type != napi_undefined) {
+    if (type == napi_string && !readUtf8String(env, value, &text, c))
+      return false;
+    if (type == napi_string && strcmp(text.get(), "lz4") == 0) {
+      recorder->compression = recordCompression::lz4;
+    } else if (type == napi_string && strcmp(text.get(), "none") == 0) {
+      recorder->compression = recordCompression::none;
+    } else {
+      c->status = GRANDI_INVALID_ARGS;
+      c->errorMsg = "compression must be \"lz4\" or \"none\".";
+      return false;
+    }
+  }
+
+  recorder->threads =
+      std::max(1u, std::min(4u, std::thread::hardware_concurrency()));
+  if (!parseOptionalInteger(env, options, "threads", 1, kMaxThreads,
+                            &recorder->threads, c) ||
+      !parseOptionalInteger(env, options, "stripes", 1, kMaxStripes,
+                            &recorder->stripes, c) ||
+      !parseOptionalInteger(env, options, "syncIntervalMs", 0,
+                            kMaxSyncIntervalMs, &recorder->syncIntervalMs,
+                            c) ||
+      !parseOptionalBoolean(env, options, "audio", &recorder->audio, c) ||
+      !parseOptionalBoolean(env, options, "replace", &recorder->replace, c))
+    return false;
+
+  c->status = parseThreadPlacement(env, options, &recorder->role.placement,
+                                   &c->errorMsg);
+  if (c->status != napi_ok)
+    return false;
+  if (!c->errorMsg.empty()) {
+    c->status = GRANDI_INVALID_ARGS;
+    return false;
+  }
+  recorder->role.role = "recorder";
+  recorder->role.owner = recorder->path;
+
+  c->status = napi_get_named_property(env, options, "receiver", receiver);
+  return c->status == napi_ok;
+}
+
+// Creates a file for writing, refusing to replace one unless asked to.
+FILE *createFile(const std::string &path, bool replace, carrier *c) {
+  FILE *file = fopen(path.c_str(), replace ? "wb" : "wbx");
+  if (file == nullptr) {
+    c->status = GRANDI_INVALID_ARGS;
+    if (errno == EEXIST)
+      c->errorMsg = "File " + path + " already exists.";
+    else
+      c->errorMsg =
+          "Failed to create " + path + ": " + std::string(strerror(errno));
+  }
+  return file;
+}
+
+// Creates the recording and its sidecar index and writes their headers.
+void recordExecute(napi_env env, void *data) {
+  recordCarrier *c = (recordCarrier *)data;
+  frameRecorder *recorder = c->recorder;
+
+  if (recorder->compression == recordCompression::lz4 &&
+      !recorder->tables.allocate((size_t)recorder->stripes *
+                                 kLz4TableEntries * sizeof(uint32_t))) {
+    c->status = GRANDI_ALLOCATION_FAILURE;
+    c->errorMsg = "Failed to allocate compression tables.";
+    return;
+  }
+  recorder->indexPath = recorder->path + kRecordIndexSuffix;
+  recorder->file = createFile(recorder->path, recorder->replace, c);
+  if (recorder->file == nullptr)
+    return;
+  recorder->indexFile = createFile(recorder->indexPath, recorder->replace, c);
+  if (recorder->indexFile == nullptr) {
+    // Leave no recording behind that has no sidecar.
+    fclose(recorder->file);
+    recorder->file = nullptr;
+    remove(recorder->path.c_str());
+    return;
+  }
+  setvbuf(recorder->file, nullptr, _IOFBF, 1 << 20);
+
+  recordFileHeader header = {};
+  memcpy(header.magic, kRecordMagic, sizeof(header.magic));
+  header.version = kRecordVersion;
+  header.headerBytes = sizeof(header);
+  recordIndexHeader indexHeader = {};
+  memcpy(indexHeader.magic, kRecordIndexMagic, sizeof(indexHeader.magic));
+  indexHeader.version = kRecordVersion;
+  indexHeader.headerBytes = sizeof(indexHeader);
+  indexHeader.entryBytes = sizeof(recordIndexEntry);
+  if (!writeBytes(recorder, &header, sizeof(header)) ||
+      fwrite(&indexHeader, sizeof(indexHeader), 1, recorder->indexFile) != 1) {
+    c->status = GRANDI_INVALID_ARGS;
+    c->errorMsg = "Failed to write " + recorder->path + ": " +
+                  std::string(strerror(errno));
+  }
+}
+
+void recordComplete(napi_env env, napi_status asyncStatus, void *data) {
+  recordCarrier *c = (recordCarrier *)data;
+
+  if (asyncStatus != napi_ok) {
+    c->status = asyncStatus;
+    c->errorMsg = "Async recorder creation failed to complete.";
+  }
+  REJECT_STATUS;
+
+  frameRecorder *recorder = c->recorder;
+  napi_value embedded, result, value;
+  c->status = napi_create_external(env, recorder, finalizeRecorder, nullptr,
+                                   &embedded);
+  REJECT_STATUS;
+  c->recorder = nullptr;
+  c->status = napi_create_object(env, &result);
+  REJECT_STATUS;
+  c->status = napi_set_named_property(env, result, "embedded", embedded);
+  REJECT_STATUS;
+
+  struct {
+    const char *name;
+    napi_callback callback;
+  } methods[] = {
+      {"stats", recorderStats},
+      {"destroy", destroyRecorder},
+  };
+  for (auto &method : methods) {
+    c->status = napi_create_function(env, method.name, NAPI_AUTO_LENGTH,
+                                     method.callback, nullptr, &value);
+    REJECT_STATUS;
+    c->status = napi_set_named_property(env, result, method.name, value);
+    REJECT_STATUS;
+  }
+
+  c->status = napi_create_string_utf8(env, recorder->path.c_str(),
+                                      NAPI_AUTO_LENGTH, &value);
+  REJECT_STATUS;
+  c->status = napi_set_named_property(env, result, "path", value);
+  REJECT_STATUS;
+  bool lz4 = recorder->compression == recordCompression::lz4;
+  c->status = napi_create_string_utf8(env, lz4 ? "lz4" : "none",
+                                      NAPI_AUTO_LENGTH, &value);
+  REJECT_STATUS;
+  c->status = napi_set_named_property(env, result, "compression", value);
+  REJECT_STATUS;
+  c->status = napi_create_uint32(env, recorder->threads, &value);
+  REJECT_STATUS;
+  c->status = napi_set_named_property(env, result, "threads", value);
+  REJECT_STATUS;
+  c->status = napi_create_uint32(env, recorder->stripes, &value);
+  REJECT_STATUS;
+  c->status = napi_set_named_property(env, result, "stripes", value);
+  REJECT_STATUS;
+  c->status = napi_create_uint32(env, recorder->syncIntervalMs, &value);
+  REJECT_STATUS;
+  c->status = napi_set_named_property(env, result, "syncIntervalMs", value);
+  REJECT_STATUS;
+
+  threadRole workers = recorder->role;
+  workers.role = "recorder-worker";
+  recorder->pool.start(recorder->threads, workers);
+  recorder->thread = std::thread(runRecorder, recorder);
+
+  napi_status status = napi_resolve_deferred(env, c->_deferred, result);
+  FLOATING_STATUS;
+  tidyCarrier(env, c);
+}
+} // namespace
+
+napi_value record(napi_env env, napi_callback_info info) {
+  recordCarrier *c = createCarrier<recordCarrier>(env);
+  if (c == nullptr)
+    return nullptr;
+
+  napi_value promise;
+  c->status = napi_create_promise(env, &c->_deferred, &promise);
+  REJECT_RETURN;
+
+  c->recorder = new (std::nothrow) frameRecorder;
+  if (c->recorder == nullptr)
+    REJECT_ERROR_RETURN("Failed to allocate recorder.",
+                        GRANDI_ALLOCATION_FAILURE);
+  frameRecorder *recorder = c->recorder;
+  recorder->env = env;
+
+  napi_value receiver;
+  if (!parseRecordOptions(env, info, recorder, &receiver, c))
+    REJECT_RETURN;
+  receiveInstance *instance = nullptr;
+  if (!bindReceiverCapture(env, receiver, "receiver", &recorder->recvHandle,
+                           &instance, c))
+    REJECT_RETURN;
+  recorder->recv = instance->recv;
+  c->status = napi_create_reference(env, receiver, 1, &recorder->receiverRef);
+  REJECT_RETURN;
+
+  napi_value resource_name;
+  c->status = napi_create_string_utf8(env, "Record", NAPI_AUTO_LENGTH,
+                                      &resource_name);
+  REJECT_RETURN;
+  c->status = napi_create_async_work(env, NULL, resource_name, recordExecute,
+                                     recordComplete, c, &c->_request);
+  REJECT_RETURN;
+  // Execute can fail before napi_queue_async_work returns, so its result
+  // must not overwrite c->status.
+  napi_status status = napi_queue_async_work(env, c->_request);
+  if (status != napi_ok) {
+    c->status = status;
+    REJECT_RETURN;
+  }
+  return promise;
+}
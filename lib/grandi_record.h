@@ -0,0 +1,112 @@
+/* Copyright 2025 Sarhan Aissi <github@tux.tn>.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+*/
+
+#ifndef GRANDI_RECORD_H
+#define GRANDI_RECORD_H
+
+#include <cstdint>
+
+#include "node_api.h"
+
+// Recording files hold a file header, then one record per captured frame,
+// then, once the recording is closed, an index of every record. The same
+// index grows in a sidecar file next to the recording while it is written,
+// so a recording that was never closed can be played too. Fields are
+// little-endian, as on every platform the addon builds for.
+
+const char kRecordMagic[8] = {'G', 'R', 'A', 'N', 'D', 'R', 'E', 'C'};
+const uint32_t kRecordVersion = 1;
+
+struct recordFileHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t headerBytes;
+  // Both stay 0 until the recording is closed.
+  uint64_t indexOffset;
+  uint64_t indexEntries;
+};
+static_assert(sizeof(recordFileHeader) == 32, "recordFileHeader layout");
+
+enum recordType : uint32_t { recordVideo = 1, recordAudio = 2 };
+enum recordCodec : uint32_t { recordUncompressed = 0, recordLz4 = 1 };
+
+// Set in a stripe size when the stripe is stored uncompressed, because LZ4
+// would have made it larger.
+const uint32_t kRecordStripeRaw = 0x80000000u;
+
+// Precedes the data of every frame. Uncompressed data follows directly, and
+// stripes is 0. LZ4 frames split the data into stripes compressed
+// independently: stripe i holds bytes rawBytes * i / stripes up to
+// rawBytes * (i + 1) / stripes. A table of one uint32_t size per stripe
+// comes first, then the stripes back to back.
+struct recordHeader {
+  uint32_t type;
+  uint32_t codec;
+  // Bytes after this header: the stripe table and the stripes.
+  uint64_t storedBytes;
+  // Bytes of frame data once decompressed, laid out as the SDK delivered
+  // them.
+  uint64_t rawBytes;
+  int64_t timestamp;
+  int64_t timecode;
+  uint32_t stripes;
+  uint32_t reserved;
+  // Video records.
+  int32_t fourCC;
+  int32_t xres;
+  int32_t yres;
+  int32_t lineStride;
+  int32_t frameRateN;
+  int32_t frameRateD;
+  float pictureAspectRatio;
+  int32_t frameFormatType;
+  // Audio records, holding planar 32-bit float samples.
+  int32_t sampleRate;
+  int32_t channels;
+  int32_t samples;
+  int32_t channelStride;
+};
+static_assert(sizeof(recordHeader) == 96, "recordHeader layout");
+
+struct recordIndexEntry {
+  // File offset of the record header.
+  uint64_t offset;
+  int64_t timestamp;
+  int64_t timecode;
+  uint32_t type;
+  uint32_t reserved;
+};
+static_assert(sizeof(recordIndexEntry) == 32, "recordIndexEntry layout");
+
+// The sidecar index, at the recording's path plus kRecordIndexSuffix, holds
+// this header and then one entry per record in file order. Entries are only
+// appended, so the entry count follows from the file size.
+const char kRecordIndexMagic[8] = {'G', 'R', 'A', 'N', 'D', 'I', 'D', 'X'};
+const char kRecordIndexSuffix[] = ".idx";
+
+struct recordIndexHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t headerBytes;
+  uint32_t entryBytes;
+  uint32_t reserved[3];
+};
+static_assert(sizeof(recordIndexHeader) == 32, "recordIndexHeader layout");
+
+// Records a receiver's frames into a file, optionally LZ4-compressed on a
+// worker pool.
+napi_value record(napi_env env, napi_callback_info info);
+
+#endif /* GRANDI_RECORD_H */
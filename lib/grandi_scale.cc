@@ -0,0 +1,253 @@
+/* Copyright 2025 Sarhan Aissi <github@tux.tn>.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+*/
+
+#include <algorithm>
+#include <cstring>
+
+#include "grandi_scale.h"
+#include "grandi_draw.h"
+#include "grandi_pool.h"
+#include "grandi_simd.h"
+
+namespace {
+// Output bytes per stripe below which scaling stays on fewer threads.
+const size_t kMinStripeBytes = 64 * 1024;
+
+bool yuvFormat(NDIlib_FourCC_video_type_e fourCC) {
+  return fourCC == NDIlib_FourCC_type_UYVY || fourCC == NDIlib_FourCC_type_UYVA;
+}
+
+bool bgrOrder(NDIlib_FourCC_video_type_e fourCC) {
+  return fourCC == NDIlib_FourCC_type_BGRA || fourCC == NDIlib_FourCC_type_BGRX;
+}
+
+uint8_t clampByte(int value) {
+  return (uint8_t)std::min(std::max(value, 0), 255);
+}
+
+uint8_t mix(const uint8_t *a, const uint8_t *b, uint32_t weight) {
+  return (uint8_t)((*a * (256 - weight) + *b * weight + 128) >> 8);
+}
+
+// Sample centers of `to` positions mapped onto `from` positions, in 1/256
+// steps.
+template <typename Tap>
+void buildTaps(int from, int to, std::vector<Tap> *taps) {
+  taps->resize(to);
+  for (int i = 0; i < to; i++) {
+    int64_t position =
+        ((int64_t)(2 * i + 1) * from * 256) / (2 * (int64_t)to) - 128;
+    position = std::max<int64_t>(position, 0);
+    Tap &entry = (*taps)[i];
+    entry.first = (uint32_t)(position >> 8);
+    entry.weight = (uint32_t)(position & 255);
+    if (entry.first >= (uint32_t)from - 1) {
+      entry.first = (uint32_t)from - 1;
+      entry.weight = 0;
+    }
+    entry.second = std::min(entry.first + 1, (uint32_t)from - 1);
+  }
+}
+} // namespace
+
+void convertYuvToRgb(uint8_t *dst, const uint8_t *src, int xres, bool bgr) {
+  for (int x = 0; x < xres; x++) {
+    const uint8_t *pair = src + (x & ~1) * 2;
+    int luma = 298 * (src[x * 2 + 1] - 16);
+    int cb = pair[0] - 128;
+    int cr = pair[2] - 128;
+    uint8_t r = clampByte((luma + 459 * cr + 128) >> 8);
+    uint8_t g = clampByte((luma - 55 * cb - 136 * cr + 128) >> 8);
+    uint8_t b = clampByte((luma + 541 * cb + 128) >> 8);
+    uint8_t *pixel = dst + x * 4;
+    pixel[0] = bgr ? b : r;
+    pixel[1] = g;
+    pixel[2] = bgr ? r : b;
+    pixel[3] = 255;
+  }
+}
+
+void convertRgbToYuv(uint8_t *dst, const uint8_t *src, int xres, bool bgr) {
+  int red = bgr ? 2 : 0;
+  int blue = bgr ? 0 : 2;
+  for (int x = 0; x + 1 < xres; x += 2) {
+    const uint8_t *left = src + x * 4;
+    const uint8_t *right = left + 4;
+    int r = (left[red] + right[red] + 1) >> 1;
+    int g = (left[1] + right[1] + 1) >> 1;
+    int b = (left[blue] + right[blue] + 1) >> 1;
+    uint8_t *pair = dst + x * 2;
+    pair[0] = blueDifferenceFromRgb(r, g, b);
+    pair[1] = lumaFromRgb(left[red], left[1], left[blue]);
+    pair[2] = redDifferenceFromRgb(r, g, b);
+    pair[3] = lumaFromRgb(right[red], right[1], right[blue]);
+  }
+}
+
+void swapRedBlue(uint8_t *dst, const uint8_t *src, int xres) {
+  for (int x = 0; x < xres; x++) {
+    const uint8_t *in = src + x * 4;
+    uint8_t *out = dst + x * 4;
+    uint8_t first = in[0];
+    out[0] = in[2];
+    out[1] = in[1];
+    out[2] = first;
+    out[3] = in[3];
+  }
+}
+
+bool scalable(NDIlib_FourCC_video_type_e fourCC) {
+  switch (fourCC) {
+  case NDIlib_FourCC_type_UYVY:
+  case NDIlib_FourCC_type_UYVA:
+  case NDIlib_FourCC_type_BGRA:
+  case NDIlib_FourCC_type_BGRX:
+  case NDIlib_FourCC_type_RGBA:
+  case NDIlib_FourCC_type_RGBX:
+    return true;
+  default:
+    return false;
+  }
+}
+
+bool videoScaler::prepare(const videoView &source, int dstXres, int dstYres) {
+  bool yuv = yuvFormat(source.fourCC);
+  // 4:2:2 intermediates are resampled in whole pixel pairs.
+  int width = yuv ? (dstXres + 1) & ~1 : dstXres;
+  if (source.xres == sourceXres && source.yres == sourceYres &&
+      yuv == sourceYuv && width == targetXres && dstYres == targetYres)
+    return true;
+
+  buildTaps(source.yres, dstYres, &rows);
+  buildTaps(source.xres, width, &columns);
+  if (yuv)
+    buildTaps(std::max(source.xres / 2, 1), width / 2, &chromaColumns);
+  sourceXres = source.xres;
+  sourceYres = source.yres;
+  sourceYuv = yuv;
+  targetXres = width;
+  targetYres = dstYres;
+  return true;
+}
+
+struct videoScaler::job {
+  const videoScaler *scaler;
+  const videoView *source;
+  uint8_t *dst;
+  NDIlib_FourCC_video_type_e dstFourCC;
+  int dstXres;
+  int dstLineStride;
+  size_t rowBytes;
+  size_t outBytes;
+};
+
+void videoScaler::scaleRows(void *context, size_t stripe, size_t begin,
+                            size_t end) {
+  const job &work = *(const job *)context;
+  const videoScaler &scaler = *work.scaler;
+  const videoView &source = *work.source;
+  NDIlib_FourCC_video_type_e dstFourCC = work.dstFourCC;
+  bool yuvIn = scaler.sourceYuv;
+  bool yuvOut = yuvFormat(dstFourCC);
+  bool direct = yuvIn == yuvOut &&
+                (yuvIn || bgrOrder(source.fourCC) == bgrOrder(dstFourCC));
+  uint8_t *blended = (uint8_t *)scaler.blended.data + stripe * work.rowBytes;
+  uint8_t *scratch = (uint8_t *)scaler.resampled.data + stripe * work.outBytes;
+
+  for (size_t y = begin; y < end; y++) {
+    const tap &row = scaler.rows[y];
+    const uint8_t *line = source.data + (size_t)row.first * source.lineStride;
+    if (row.weight != 0) {
+      blendBytes(blended, line,
+                 source.data + (size_t)row.second * source.lineStride,
+                 row.weight, work.rowBytes);
+      line = blended;
+    }
+
+    uint8_t *out = work.dst + y * work.dstLineStride;
+    uint8_t *target = direct ? out : scratch;
+    if (yuvIn) {
+      for (int pair = 0; pair < scaler.targetXres / 2; pair++) {
+        const tap &chroma = scaler.chromaColumns[pair];
+        const tap &left = scaler.columns[pair * 2];
+        const tap &right = scaler.columns[pair * 2 + 1];
+        uint8_t *pixels = target + pair * 4;
+        pixels[0] = mix(line + chroma.first * 4, line + chroma.second * 4,
+                        chroma.weight);
+        pixels[1] = mix(line + left.first * 2 + 1, line + left.second * 2 + 1,
+                        left.weight);
+        pixels[2] = mix(line + chroma.first * 4 + 2,
+                        line + chroma.second * 4 + 2, chroma.weight);
+        pixels[3] = mix(line + right.first * 2 + 1,
+                        line + right.second * 2 + 1, right.weight);
+      }
+    } else {
+      for (int x = 0; x < work.dstXres; x++) {
+        const tap &column = scaler.columns[x];
+        const uint8_t *a = line + column.first * 4;
+        const uint8_t *b = line + column.second * 4;
+        uint8_t *pixel = target + x * 4;
+        for (int channel = 0; channel < 4; channel++)
+          pixel[channel] = mix(a + channel, b + channel, column.weight);
+      }
+    }
+
+    if (direct)
+      continue;
+    if (yuvIn)
+      convertYuvToRgb(out, scratch, work.dstXres, bgrOrder(dstFourCC));
+    else if (yuvOut)
+      convertRgbToYuv(out, scratch, work.dstXres, bgrOrder(source.fourCC));
+    else
+      swapRedBlue(out, scratch, work.dstXres);
+  }
+}
+
+bool videoScaler::scale(const videoView &source, uint8_t *dst,
+                        NDIlib_FourCC_video_type_e dstFourCC, int dstXres,
+                        int dstYres, int dstLineStride) {
+  if (dstXres <= 0 || dstYres <= 0 || source.xres <= 0 || source.yres <= 0)
+    return true;
+  if (!prepare(source, dstXres, dstYres))
+    return false;
+
+  job work;
+  work.scaler = this;
+  work.source = &source;
+  work.dst = dst;
+  work.dstFourCC = dstFourCC;
+  work.dstXres = dstXres;
+  work.dstLineStride = dstLineStride;
+  work.rowBytes = (size_t)source.xres * (sourceYuv ? 2 : 4);
+  work.outBytes = (size_t)targetXres * 4;
+
+  // Each stripe blends and resamples into its own scratch rows, which only
+  // grow, so steady-state scaling does not allocate.
+  workerPool &pool = sharedPool();
+  size_t minRows = kMinStripeBytes / std::max<size_t>(work.outBytes, 1);
+  size_t stripes =
+      stripeCount(pool, (size_t)dstYres, std::max<size_t>(minRows, 1));
+  size_t blendedBytes = stripes * work.rowBytes;
+  size_t resampledBytes = stripes * work.outBytes;
+  if ((blended.size < blendedBytes && !blended.allocate(blendedBytes)) ||
+      (resampled.size < resampledBytes &&
+       !resampled.allocate(resampledBytes))) {
+    blended.allocate(0);
+    resampled.allocate(0);
+    return false;
+  }
+  runStripes(pool, (size_t)dstYres, stripes, scaleRows, &work);
+  return true;
+}
@@ -0,0 +1,81 @@
+/* Copyright 2025 Sarhan Aissi <github@tux.tn>.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+*/
+
+#ifndef GRANDI_SCALE_H
+#define GRANDI_SCALE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <Processing.NDI.Lib.h>
+
+#include "grandi_util.h"
+
+// A frame or a rectangle within one. UYVA alpha planes are not read.
+struct videoView {
+  const uint8_t *data = nullptr;
+  NDIlib_FourCC_video_type_e fourCC = NDIlib_FourCC_type_UYVY;
+  int xres = 0;
+  int yres = 0;
+  int lineStride = 0;
+};
+
+// Formats the scaler reads and writes: UYVY, UYVA, BGRA, BGRX, RGBA, RGBX.
+bool scalable(NDIlib_FourCC_video_type_e fourCC);
+
+// Row conversions between UYVY and 32-bit RGB in BGRA (bgr) or RGBA byte
+// order. convertYuvToRgb writes opaque alpha; convertRgbToYuv averages each
+// pixel pair's color for its chroma and ignores a trailing odd pixel.
+void convertYuvToRgb(uint8_t *dst, const uint8_t *src, int xres, bool bgr);
+void convertRgbToYuv(uint8_t *dst, const uint8_t *src, int xres, bool bgr);
+void swapRedBlue(uint8_t *dst, const uint8_t *src, int xres);
+
+// Bilinear scaler with format conversion between 4:2:2 YUV and 32-bit RGB
+// (BT.709 limited range). Rows are blended vertically with SIMD and then
+// resampled through per-column tables, which are rebuilt only when the
+// geometry changes, so steady-state scaling does not allocate. Large
+// pictures are split into row stripes on the shared worker pool.
+struct videoScaler {
+  // Writes source scaled to fill dst; dst.xres must be even for 4:2:2
+  // output. Returns false on allocation failure.
+  bool scale(const videoView &source, uint8_t *dst,
+             NDIlib_FourCC_video_type_e dstFourCC, int dstXres, int dstYres,
+             int dstLineStride);
+
+private:
+  struct tap {
+    uint32_t first = 0;
+    uint32_t second = 0;
+    uint32_t weight = 0;
+  };
+  struct job;
+  bool prepare(const videoView &source, int dstXres, int dstYres);
+  static void scaleRows(void *context, size_t stripe, size_t begin,
+                        size_t end);
+
+  int sourceXres = 0;
+  int sourceYres = 0;
+  bool sourceYuv = false;
+  int targetXres = 0;
+  int targetYres = 0;
+  std::vector<tap> rows;
+  std::vector<tap> columns;
+  std::vector<tap> chromaColumns;
+  ownedBuffer blended;
+  ownedBuffer resampled;
+};
+
+#endif /* GRANDI_SCALE_H */
@@ -0,0 +1,575 @@
+/* Copyright 2025 Sarhan Aissi <github@tux.tn>.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "grandi_scopes.h"
+#include "grandi_draw.h"
+#include "grandi_fields.h"
+#include "grandi_simd.h"
+
+namespace {
+const int kMinColumns = 16;
+const int kMaxColumns = 2048;
+const int kMinVectorscopeSize = 16;
+const int kMaxVectorscopeSize = 512;
+const int kMaxStep = 64;
+// Consecutive samples often land in the same bin, so each scope counts into
+// several banks in turn; the increments then do not wait on each other.
+// Banks are summed once per frame.
+const int kHistogramBanks = 4;
+const int kTraceBanks = 2;
+
+napi_status readBoolean(napi_env env, napi_value object, const char *name,
+                        bool *result, std::string *error) {
+  napi_value value;
+  napi_status status = napi_get_named_property(env, object, name, &value);
+  if (status != napi_ok)
+    return status;
+  napi_valuetype type;
+  status = napi_typeof(env, value, &type);
+  if (status != napi_ok || type == napi_undefined)
+    return status;
+  if (type != napi_boolean) {
+    *error = std::string("scopes.") + name + " must be a Boolean.";
+    return napi_ok;
+  }
+  return napi_get_value_bool(env, value, result);
+}
+
+napi_status readInteger(napi_env env, napi_value object, const char *name,
+                        int minimum, int maximum, int *result,
+                        std::string *error) {
+  napi_value value;
+  napi_status status = napi_get_named_property(env, object, name, &value);
+  if (status != napi_ok)
+    return status;
+  napi_valuetype type;
+  status = napi_typeof(env, value, &type);
+  if (status != napi_ok || type == napi_undefined)
+    return status;
+  std::string label = std::string("scopes.") + name;
+  uint32_t parsed = 0;
+  status = parseUint32Value(env, value, label.c_str(), &parsed, error);
+  if (status != napi_ok)
+    return status;
+  if (!error->empty() || parsed < (uint32_t)minimum ||
+      parsed > (uint32_t)maximum) {
+    *error = label + " must be an integer between " + std::to_string(minimum) +
+             " and " + std::to_string(maximum) + ".";
+    return napi_ok;
+  }
+  *result = (int)parsed;
+  return napi_ok;
+}
+
+inline uint8_t clampSample(int value) {
+  return (uint8_t)(value < 0 ? 0 : value > 255 ? 255 : value);
+}
+
+// BT.709 limited range, the inverse of the grandi_draw conversion.
+inline void rgbFromYuv(int y, int cb, int cr, uint8_t *r, uint8_t *g,
+                       uint8_t *b) {
+  int luma = 298 * (y - 16);
+  cb -= 128;
+  cr -= 128;
+  *r = clampSample((luma + 459 * cr + 128) >> 8);
+  *g = clampSample((luma - 55 * cb - 136 * cr + 128) >> 8);
+  *b = clampSample((luma + 541 * cb + 128) >> 8);
+}
+
+enum scopeLayout { packed422, planar16, nv12, planar420, rgb };
+
+// Plane pointers and strides of a frame, so each sample is one lookup.
+struct scopeSource {
+  const uint8_t *luma = nullptr;
+  const uint8_t *cb = nullptr;
+  const uint8_t *cr = nullptr;
+  int64_t lumaStride = 0;
+  int64_t chromaStride = 0;
+  bool verticalSubsampling = false;
+  scopeLayout layout = packed422;
+  // Byte offsets of red and blue in 32-bit pixels.
+  int red = 2;
+  int blue = 0;
+};
+
+bool describeSource(const NDIlib_video_frame_v2_t &frame,
+                    scopeSource *source) {
+  int64_t stride = frame.line_stride_in_bytes;
+  if (stride == 0)
+    stride = defaultLineStride(frame.FourCC, frame.xres);
+  if (stride == 0)
+    stride = frame.xres;
+  const uint8_t *data = frame.p_data;
+  int64_t lines = frame.yres;
+  source->lumaStride = stride;
+  source->chromaStride = stride;
+  switch (frame.FourCC) {
+  case NDIlib_FourCC_type_UYVY:
+  case NDIlib_FourCC_type_UYVA:
+    source->layout = packed422;
+    source->luma = data;
+    return true;
+  case NDIlib_FourCC_type_P216:
+  case NDIlib_FourCC_type_PA16:
+    source->layout = planar16;
+    source->luma = data;
+    source->cb = data + stride * lines;
+    return true;
+  case NDIlib_FourCC_type_NV12:
+    source->layout = nv12;
+    source->luma = data;
+    source->cb = data + stride * lines;
+    source->verticalSubsampling = true;
+    return true;
+  case NDIlib_FourCC_type_I420:
+  case NDIlib_FourCC_type_YV12: {
+    source->layout = planar420;
+    source->luma = data;
+    source->chromaStride = stride / 2;
+    source->verticalSubsampling = true;
+    const uint8_t *first = data + stride * lines;
+    const uint8_t *second = first + (stride / 2) * (lines / 2);
+    bool i420 = frame.FourCC == NDIlib_FourCC_type_I420;
+    source->cb = i420 ? first : second;
+    source->cr = i420 ? second : first;
+    return true;
+  }
+  case NDIlib_FourCC_type_BGRA:
+  case NDIlib_FourCC_type_BGRX:
+  case NDIlib_FourCC_type_RGBA:
+  case NDIlib_FourCC_type_RGBX: {
+    source->layout = rgb;
+    source->luma = data;
+    bool bgr = frame.FourCC == NDIlib_FourCC_type_BGRA ||
+               frame.FourCC == NDIlib_FourCC_type_BGRX;
+    source->red = bgr ? 2 : 0;
+    source->blue = bgr ? 0 : 2;
+    return true;
+  }
+  default:
+    return false;
+  }
+}
+
+struct scopeSample {
+  uint8_t y, cb, cr, r, g, b;
+};
+
+// Templated on the layout so the per-sample switch folds away.
+template <scopeLayout layout>
+inline void readSample(const scopeSource &source, int x, int line,
+                       bool needRgb, scopeSample *sample) {
+  const uint8_t *row = source.luma + source.lumaStride * line;
+  int pair = x & ~1;
+  int chromaLine = source.verticalSubsampling ? line / 2 : line;
+  switch (layout) {
+  case packed422:
+    sample->cb = row[pair * 2];
+    sample->y = row[x * 2 + 1];
+    sample->cr = row[pair * 2 + 2];
+    break;
+  case planar16: {
+    // Little-endian 16-bit samples; the high byte is the 8-bit level.
+    const uint8_t *chroma = source.cb + source.chromaStride * chromaLine;
+    sample->y = row[x * 2 + 1];
+    sample->cb = chroma[pair * 2 + 1];
+    sample->cr = chroma[pair * 2 + 3];
+    break;
+  }
+  case nv12: {
+    const uint8_t *chroma = source.cb + source.chromaStride * chromaLine;
+    sample->y = row[x];
+    sample->cb = chroma[pair];
+    sample->cr = chroma[pair + 1];
+    break;
+  }
+  case planar420:
+    sample->y = row[x];
+    sample->cb = source.cb[source.chromaStride * chromaLine + x / 2];
+    sample->cr = source.cr[source.chromaStride * chromaLine + x / 2];
+    break;
+  case rgb: {
+    const uint8_t *pixel = row + x * 4;
+    sample->r = pixel[source.red];
+    sample->g = pixel[1];
+    sample->b = pixel[source.blue];
+    sample->y = lumaFromRgb(sample->r, sample->g, sample->b);
+    sample->cb = blueDifferenceFromRgb(sample->r, sample->g, sample->b);
+    sample->cr = redDifferenceFromRgb(sample->r, sample->g, sample->b);
+    return;
+  }
+  }
+  if (needRgb)
+    rgbFromYuv(sample->y, sample->cb, sample->cr, &sample->r, &sample->g,
+               &sample->b);
+}
+
+struct scopeBins {
+  uint32_t *wave;
+  uint32_t *vector;
+  uint32_t *histogram;
+  const int *columnOf;
+  size_t waveCount;
+  size_t vectorCount;
+  int vectorscopeSize;
+};
+
+// Counts every sampled pixel into the bins; returns the samples taken.
+template <scopeLayout layout>
+uint64_t accumulateFrame(const scopeSource &source,
+                         const NDIlib_video_frame_v2_t &frame,
+                         const scopeOptions &options, const scopeBins &bins) {
+  // Counts are uint32_t, which may alias the int and bool options, so
+  // everything the loop reads is copied to locals first.
+  const size_t histogramCount = 4 * kScopeLevels;
+  const int size = bins.vectorscopeSize;
+  const int step = options.step;
+  const int columns = options.columns;
+  const int xres = frame.xres;
+  const int yres = frame.yres;
+  const bool waveform = options.waveform;
+  const bool vectorscope = options.vectorscope;
+  const bool histogram = options.histogram;
+  const scopeSource local = source;
+  uint32_t *const wave = bins.wave;
+  uint32_t *const vector = bins.vector;
+  const int *const columnOf = bins.columnOf;
+  const size_t waveCount = bins.waveCount;
+  const size_t vectorCount = bins.vectorCount;
+  uint64_t index = 0;
+  scopeSample sample{};
+  for (int line = 0; line < yres; line += step) {
+    for (int i = 0, x = 0; x < xres; i++, x += step) {
+      readSample<layout>(local, x, line, histogram, &sample);
+      if (waveform)
+        wave[(index & (kTraceBanks - 1)) * waveCount +
+             (size_t)sample.y * columns + columnOf[i]]++;
+      if (vectorscope)
+        vector[(index & (kTraceBanks - 1)) * vectorCount +
+               (size_t)(sample.cr * size >> 8) * size +
+               (sample.cb * size >> 8)]++;
+      if (histogram) {
+        uint32_t *bank =
+            bins.histogram + (index & (kHistogramBanks - 1)) * histogramCount;
+        bank[sample.y]++;
+        bank[kScopeLevels + sample.r]++;
+        bank[2 * kScopeLevels + sample.g]++;
+        bank[3 * kScopeLevels + sample.b]++;
+      }
+      index++;
+    }
+  }
+  return index;
+}
+
+bool allocateZeroed(ownedBuffer *buffer, size_t bytes) {
+  if (!buffer->allocate(bytes))
+    return false;
+  memset(buffer->data, 0, buffer->size);
+  return true;
+}
+
+bool allocateCounts(ownedBuffer *buffer, size_t count) {
+  return allocateZeroed(buffer, count * sizeof(uint32_t));
+}
+
+// Sums the banks that follow the first one into it.
+void mergeBanks(ownedBuffer *banks, size_t count, int bankCount) {
+  uint32_t *first = (uint32_t *)banks->data;
+  for (int bank = 1; bank < bankCount; bank++)
+    accumulateCounts(first, first + count * bank, count);
+}
+
+// Copies the merged first bank into result.
+bool takeFirstBank(ownedBuffer *banks, size_t count, ownedBuffer *result) {
+  return result->copyFrom(banks->data, count * sizeof(uint32_t));
+}
+
+// Renders counts as a BGRA trace, brightness following the square root of
+// each count against the largest, with a dim graticule where guide is set.
+bool renderCounts(const uint32_t *counts, int width, int height,
+                  bool flipRows, const uint8_t *guide, ownedBuffer *image) {
+  size_t pixels = (size_t)width * height;
+  if (!image->allocate(pixels * 4))
+    return false;
+  uint8_t *out = (uint8_t *)image->data;
+  uint32_t peak = maxCount(counts, pixels);
+  float scale = peak > 0 ? 255.0f / std::sqrt((float)peak) : 0.0f;
+  for (int row = 0; row < height; row++) {
+    const uint32_t *source = counts + (size_t)(flipRows ? height - 1 - row
+                                                        : row) *
+                                          width;
+    uint8_t *line = out + (size_t)row * width * 4;
+    for (int x = 0; x < width; x++) {
+      int level = source[x] == 0
+                      ? 0
+                      : std::max(48, (int)(std::sqrt((float)source[x]) *
+                                               scale +
+                                           0.5f));
+      int base = guide[(size_t)row * width + x] ? 40 : 0;
+      line[x * 4] = clampSample(base + level / 2);
+      line[x * 4 + 1] = clampSample(base + level);
+      line[x * 4 + 2] = clampSample(base + level / 2);
+      line[x * 4 + 3] = 255;
+    }
+  }
+  return true;
+}
+} // namespace
+
+napi_status parseScopeOptions(napi_env env, napi_value value,
+                              scopeOptions *options, std::string *error) {
+  error->clear();
+  *options = scopeOptions();
+  napi_valuetype type;
+  napi_status status = napi_typeof(env, value, &type);
+  if (status != napi_ok || type == napi_undefined)
+    return status;
+  bool isArray = false;
+  status = napi_is_array(env, value, &isArray);
+  if (status != napi_ok)
+    return status;
+  if (type != napi_object || isArray) {
+    *error = "Scope options must be an object.";
+    return napi_ok;
+  }
+
+  const char *flags[4] = {"waveform", "vectorscope", "histogram", "render"};
+  bool *targets[4] = {&options->waveform, &options->vectorscope,
+                      &options->histogram, &options->render};
+  for (int i = 0; i < 4; i++) {
+    status = readBoolean(env, value, flags[i], targets[i], error);
+    if (status != napi_ok || !error->empty())
+      return status;
+  }
+  status = readInteger(env, value, "columns", kMinColumns, kMaxColumns,
+                       &options->columns, error);
+  if (status != napi_ok || !error->empty())
+    return status;
+  status =
+      readInteger(env, value, "vectorscopeSize", kMinVectorscopeSize,
+                  kMaxVectorscopeSize, &options->vectorscopeSize, error);
+  if (status != napi_ok || !error->empty())
+    return status;
+  status = readInteger(env, value, "step", 1, kMaxStep, &options->step, error);
+  if (status != napi_ok || !error->empty())
+    return status;
+  if (!options->waveform && !options->vectorscope && !options->histogram)
+    *error = "At least one of scopes.waveform, scopes.vectorscope, and "
+             "scopes.histogram must be enabled.";
+  return napi_ok;
+}
+
+bool scopeable(NDIlib_FourCC_video_type_e fourCC) {
+  scopeSource source;
+  NDIlib_video_frame_v2_t frame{};
+  frame.FourCC = fourCC;
+  return describeSource(frame, &source);
+}
+
+bool computeScopes(const NDIlib_video_frame_v2_t &frame,
+                   const scopeOptions &options, scopeResult *result) {
+  result->columns = options.columns;
+  result->vectorscopeSize = options.vectorscopeSize;
+  result->samples = 0;
+
+  size_t waveCount = (size_t)options.columns * kScopeLevels;
+  size_t vectorCount = (size_t)options.vectorscopeSize *
+                       options.vectorscopeSize;
+  size_t histogramCount = 4 * kScopeLevels;
+  ownedBuffer waveBanks, vectorBanks, histogramBanks;
+  if ((options.waveform &&
+       !allocateCounts(&waveBanks, waveCount * kTraceBanks)) ||
+      (options.vectorscope &&
+       !allocateCounts(&vectorBanks, vectorCount * kTraceBanks)) ||
+      (options.histogram &&
+       !allocateCounts(&histogramBanks, histogramCount * kHistogramBanks)))
+    return false;
+
+  scopeSource source;
+  if (frame.p_data != nullptr && frame.xres > 0 && frame.yres > 0 &&
+      describeSource(frame, &source)) {
+    uint32_t *wave = (uint32_t *)waveBanks.data;
+    uint32_t *vector = (uint32_t *)vectorBanks.data;
+    uint32_t *histogram = (uint32_t *)histogramBanks.data;
+    int size = options.vectorscopeSize;
+    // Column of every sampled x, computed once per frame.
+    int sampledColumns = (frame.xres + options.step - 1) / options.step;
+    ownedBuffer columnMap;
+    if (options.waveform &&
+        !columnMap.allocate((size_t)sampledColumns * sizeof(int)))
+      return false;
+    int *columnOf = (int *)columnMap.data;
+    if (options.waveform)
+      for (int i = 0; i < sampledColumns; i++)
+        columnOf[i] = (int)((int64_t)i * options.step * options.columns /
+                            frame.xres);
+
+    scopeBins bins{wave,     vector,    histogram,
+                   columnOf, waveCount, vectorCount, size};
+    switch (source.layout) {
+    case packed422:
+      result->samples =
+          accumulateFrame<packed422>(source, frame, options, bins);
+      break;
+    case planar16:
+      result->samples =
+          accumulateFrame<planar16>(source, frame, options, bins);
+      break;
+    case nv12:
+      result->samples =
+          accumulateFrame<nv12>(source, frame, options, bins);
+      break;
+    case planar420:
+      result->samples =
+          accumulateFrame<planar420>(source, frame, options, bins);
+      break;
+    case rgb:
+      result->samples =
+          accumulateFrame<rgb>(source, frame, options, bins);
+      break;
+    }
+  }
+
+  if (options.waveform) {
+    mergeBanks(&waveBanks, waveCount, kTraceBanks);
+    if (!takeFirstBank(&waveBanks, waveCount, &result->waveform))
+      return false;
+  }
+  if (options.vectorscope) {
+    mergeBanks(&vectorBanks, vectorCount, kTraceBanks);
+    if (!takeFirstBank(&vectorBanks, vectorCount, &result->vectorscope))
+      return false;
+  }
+  if (options.histogram) {
+    mergeBanks(&histogramBanks, histogramCount, kHistogramBanks);
+    if (!takeFirstBank(&histogramBanks, histogramCount, &result->histogram))
+      return false;
+  }
+  if (!options.render)
+    return true;
+
+  if (options.waveform) {
+    // Lines at the limited-range black and white levels, 16 and 235.
+    ownedBuffer guide;
+    if (!allocateZeroed(&guide, waveCount))
+      return false;
+    uint8_t *marks = (uint8_t *)guide.data;
+    for (int level : {16, 235})
+      memset(marks + (size_t)(kScopeLevels - 1 - level) * options.columns, 1,
+             options.columns);
+    if (!renderCounts((const uint32_t *)result->waveform.data, options.columns,
+                      kScopeLevels, true, marks, &result->waveformImage))
+      return false;
+  }
+  if (options.vectorscope) {
+    // Crosshair through neutral chroma.
+    int size = options.vectorscopeSize;
+    ownedBuffer guide;
+    if (!allocateZeroed(&guide, vectorCount))
+      return false;
+    uint8_t *marks = (uint8_t *)guide.data;
+    int center = size / 2;
+    memset(marks + (size_t)(size - 1 - center) * size, 1, size);
+    for (int row = 0; row < size; row++)
+      marks[(size_t)row * size + center] = 1;
+    if (!renderCounts((const uint32_t *)result->vectorscope.data, size, size,
+                      true, marks, &result->vectorscopeImage))
+      return false;
+  }
+  return true;
+}
+
+namespace {
+napi_status setCounts(napi_env env, napi_value object, const char *name,
+                      const ownedBuffer &counts) {
+  if (counts.data == nullptr)
+    return napi_ok;
+  void *data = nullptr;
+  napi_value arrayBuffer, array;
+  napi_status status =
+      napi_create_arraybuffer(env, counts.size, &data, &arrayBuffer);
+  PASS_STATUS;
+  memcpy(data, counts.data, counts.size);
+  status = napi_create_typedarray(env, napi_uint32_array,
+                                  counts.size / sizeof(uint32_t), arrayBuffer,
+                                  0, &array);
+  PASS_STATUS;
+  return napi_set_named_property(env, object, name, array);
+}
+
+napi_status setImage(napi_env env, napi_value object, const char *name,
+                     int width, int height, ownedBuffer *pixels) {
+  if (pixels->data == nullptr)
+    return napi_ok;
+  napi_value image, param;
+  napi_status status = napi_create_object(env, &image);
+  PASS_STATUS;
+  const char *names[3] = {"xres", "yres", "lineStrideBytes"};
+  int values[3] = {width, height, width * 4};
+  for (int i = 0; i < 3; i++) {
+    status = napi_create_int32(env, values[i], &param);
+    PASS_STATUS;
+    status = napi_set_named_property(env, image, names[i], param);
+    PASS_STATUS;
+  }
+  status = napi_create_int32(env, NDIlib_FourCC_type_BGRA, &param);
+  PASS_STATUS;
+  status = napi_set_named_property(env, image, "fourCC", param);
+  PASS_STATUS;
+  status = createExternalBuffer(env, pixels, &param);
+  PASS_STATUS;
+  status = napi_set_named_property(env, image, "data", param);
+  PASS_STATUS;
+  return napi_set_named_property(env, object, name, image);
+}
+} // namespace
+
+napi_status setScopeProperties(napi_env env, scopeResult *result,
+                               napi_value object) {
+  napi_value param;
+  napi_status status = napi_create_double(env, (double)result->samples, &param);
+  PASS_STATUS;
+  status = napi_set_named_property(env, object, "samples", param);
+  PASS_STATUS;
+
+  if (result->waveform.data != nullptr) {
+    status = napi_create_int32(env, result->columns, &param);
+    PASS_STATUS;
+    status = napi_set_named_property(env, object, "columns", param);
+    PASS_STATUS;
+  }
+  if (result->vectorscope.data != nullptr) {
+    status = napi_create_int32(env, result->vectorscopeSize, &param);
+    PASS_STATUS;
+    status = napi_set_named_property(env, object, "vectorscopeSize", param);
+    PASS_STATUS;
+  }
+  status = setCounts(env, object, "waveform", result->waveform);
+  PASS_STATUS;
+  status = setCounts(env, object, "vectorscope", result->vectorscope);
+  PASS_STATUS;
+  status = setCounts(env, object, "histogram", result->histogram);
+  PASS_STATUS;
+  status = setImage(env, object, "waveformImage", result->columns,
+                    kScopeLevels, &result->waveformImage);
+  PASS_STATUS;
+  return setImage(env, object, "vectorscopeImage", result->vectorscopeSize,
+                  result->vectorscopeSize, &result->vectorscopeImage);
+}
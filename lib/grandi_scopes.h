@@ -0,0 +1,77 @@
+/* Copyright 2025 Sarhan Aissi <github@tux.tn>.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+*/
+
+#ifndef GRANDI_SCOPES_H
+#define GRANDI_SCOPES_H
+
+#include <cstdint>
+#include <string>
+
+#include <Processing.NDI.Lib.h>
+
+#include "node_api.h"
+#include "grandi_util.h"
+
+// Levels per scope axis: scopes bin 8-bit samples, or the top 8 bits of
+// 16-bit samples.
+const int kScopeLevels = 256;
+
+struct scopeOptions {
+  bool waveform = true;
+  bool vectorscope = true;
+  bool histogram = true;
+  // Waveform columns across the frame width.
+  int columns = 256;
+  // Vectorscope bins along each of the Cb and Cr axes.
+  int vectorscopeSize = 256;
+  // Samples every step-th pixel of every step-th line.
+  int step = 2;
+  // Also renders the waveform and vectorscope as BGRA images.
+  bool render = false;
+};
+
+// Parses a scopes option object; undefined keeps the defaults. Invalid values
+// set error and return napi_ok, like parseUint32Value.
+napi_status parseScopeOptions(napi_env env, napi_value value,
+                              scopeOptions *options, std::string *error);
+
+// Every frame format the SDK delivers: UYVY, UYVA, P216, PA16, NV12, I420,
+// YV12, BGRA, BGRX, RGBA, and RGBX.
+bool scopeable(NDIlib_FourCC_video_type_e fourCC);
+
+// Bins computed from one frame. Bin arrays are uint32 counts:
+// waveform[level * columns + column], vectorscope[cr * size + cb], and
+// histogram[channel * 256 + level] for luma, red, green, then blue.
+struct scopeResult {
+  ownedBuffer waveform;
+  ownedBuffer vectorscope;
+  ownedBuffer histogram;
+  ownedBuffer waveformImage;
+  ownedBuffer vectorscopeImage;
+  int columns = 0;
+  int vectorscopeSize = 0;
+  uint64_t samples = 0;
+};
+
+// Reads the frame in place, so it can run on an SDK frame before it is
+// freed. Returns false when a bin array cannot be allocated.
+bool computeScopes(const NDIlib_video_frame_v2_t &frame,
+                   const scopeOptions &options, scopeResult *result);
+
+// Sets waveform, vectorscope, histogram, their images, and samples on object.
+napi_status setScopeProperties(napi_env env, scopeResult *result,
+                               napi_value object);
+
+#endif /* GRANDI_SCOPES_H */
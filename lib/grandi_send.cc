@@ -26,7 +26,10 @@
 #endif // _WIN64
 #endif // _WIN32
 
+#include "grandi_draw.h"
+#include "grandi_fields.h"
 #include "grandi_send.h"
+#include "grandi_transfer.h"
 #include "grandi_util.h"
 
 napi_value videoSend(napi_env env, napi_callback_info info);
@@ -35,15 +38,21 @@ napi_value connections(napi_env env, napi_callback_info info);
 napi_value metadataSend(napi_env env, napi_callback_info info);
 napi_value tally(napi_env env, napi_callback_info info);
 napi_value sourcename(napi_env env, napi_callback_info info);
+napi_value setOverlay(napi_env env, napi_callback_info info);
+napi_value detachSend(napi_env env, napi_callback_info info);
 
 namespace {
 void destroySendInstance(void *value) {
-  NDIlib_send_destroy((NDIlib_send_instance_t)value);
+  sendInstance *instance = (sendInstance *)value;
+  NDIlib_send_destroy(instance->send);
+  delete instance;
 }
 
+// exclusive acquires for video(), which a bound native producer owns.
 bool acquireSendFromThis(napi_env env, napi_value thisValue,
                          nativeHandle **handle, NDIlib_send_instance_t *send,
-                         carrier *c) {
+                         carrier *c, sendInstance **instance = nullptr,
+                         bool exclusive = false) {
   napi_value sendValue;
   c->status = napi_get_named_property(env, thisValue, "embedded", &sendValue);
   if (c->status != napi_ok)
@@ -63,13 +72,22 @@ bool acquireSendFromThis(napi_env env, napi_value thisValue,
     return false;
   nativeHandle *native = (nativeHandle *)externalData;
   void *value;
-  if (!acquireNativeHandle(native, &value)) {
+  nativeCaptureStatus acquired = nativeCaptureStatus::success;
+  if (exclusive)
+    acquired = acquireNativeCaptureHandle(native, &value);
+  else if (!acquireNativeHandle(native, &value))
+    acquired = nativeCaptureStatus::destroyed;
+  if (acquired != nativeCaptureStatus::success) {
     c->status = GRANDI_INVALID_ARGS;
-    c->errorMsg = "Sender has been destroyed.";
+    c->errorMsg = acquired == nativeCaptureStatus::bound
+                      ? "Sender video is fed by a native producer."
+                      : "Sender has been destroyed.";
     return false;
   }
   *handle = native;
-  *send = (NDIlib_send_instance_t)value;
+  *send = ((sendInstance *)value)->send;
+  if (instance != nullptr)
+    *instance = (sendInstance *)value;
   return true;
 }
 
@@ -112,6 +130,7 @@ bool parseTimeProperty(napi_env env, napi_value object, const char *propName,
 
   return getInt64FromValue(env, property, target, c, propName);
 }
+} // namespace
 
 bool validateVideoFrameBuffer(const NDIlib_video_frame_v2_t &frame,
                               size_t bufferLen, carrier *c) {
@@ -230,6 +249,7 @@ bool validateVideoFrameBuffer(const NDIlib_video_frame_v2_t &frame,
   return true;
 }
 
+namespace {
 bool validateAudioFrameBuffer(const NDIlib_audio_frame_v3_t &frame,
                               size_t bufferLen, carrier *c) {
   if (frame.sample_rate <= 0 || frame.no_channels <= 0 ||
@@ -276,6 +296,50 @@ bool validateAudioFrameBuffer(const NDIlib_audio_frame_v3_t &frame,
 }
 } // namespace
 
+bool bindSenderVideo(napi_env env, napi_value sender, const std::string &label,
+                     nativeHandle **handle, sendInstance **instance,
+                     carrier *c) {
+  napi_valuetype type;
+  napi_value sendValue = nullptr;
+  c->status = napi_typeof(env, sender, &type);
+  if (c->status != napi_ok)
+    return false;
+  if (type == napi_object) {
+    c->status = napi_get_named_property(env, sender, "embedded", &sendValue);
+    if (c->status != napi_ok)
+      return false;
+    c->status = napi_typeof(env, sendValue, &type);
+    if (c->status != napi_ok)
+      return false;
+  }
+  if (type != napi_external) {
+    c->status = GRANDI_INVALID_ARGS;
+    c->errorMsg = label + " must be an initialized sender.";
+    return false;
+  }
+
+  void *externalData;
+  c->status = napi_get_value_external(env, sendValue, &externalData);
+  if (c->status != napi_ok)
+    return false;
+  nativeHandle *sendHandle = (nativeHandle *)externalData;
+  void *sendData;
+  nativeCaptureStatus bindStatus =
+      bindNativeCaptureHandle(sendHandle, &sendData);
+  if (bindStatus != nativeCaptureStatus::success) {
+    c->status = GRANDI_INVALID_ARGS;
+    c->errorMsg = "Sender has been destroyed.";
+    if (bindStatus == nativeCaptureStatus::bound)
+      c->errorMsg = "Sender is already bound to a native producer.";
+    else if (bindStatus == nativeCaptureStatus::busy)
+      c->errorMsg = "Sender has active send operations.";
+    return false;
+  }
+  *handle = sendHandle;
+  *instance = (sendInstance *)sendData;
+  return true;
+}
+
 void sendExecute(napi_env env, void *data) {
   sendCarrier *c = (sendCarrier *)data;
 
@@ -330,111 +394,175 @@ create_result:
   return result;
 }
 
-void sendComplete(napi_env env, napi_status asyncStatus, void *data) {
-  sendCarrier *c = (sendCarrier *)data;
-
-  if (asyncStatus != napi_ok) {
-    c->status = asyncStatus;
-    c->errorMsg = "Async sender creation failed to complete.";
-  }
-  REJECT_STATUS;
-
-  napi_value result;
-  c->status = napi_create_object(env, &result);
-  REJECT_STATUS;
+namespace {
 
-  napi_value embedded;
-  nativeHandle *handle = createNativeHandle(c->send, destroySendInstance);
-  if (handle == nullptr) {
-    destroySendInstance(c->send);
-    c->send = nullptr;
-    c->status = GRANDI_ALLOCATION_FAILURE;
-    c->errorMsg = "Failed to allocate Sender handle.";
-    REJECT_STATUS;
-  }
-  c->status = napi_create_external(env, handle, finalizeNativeHandle, nullptr,
-                                   &embedded);
-  if (c->status != napi_ok) {
-    closeNativeHandle(handle);
-    delete handle;
-    REJECT_STATUS;
-  }
-  c->status = napi_set_named_property(env, result, "embedded", embedded);
-  REJECT_STATUS;
+// Sets up the sender object around embedded.
+napi_status fillSenderObject(napi_env env, napi_value embedded,
+                             sendInstance *instance, napi_value *result) {
+  napi_status status;
+  napi_value object;
+  status = napi_create_object(env, &object);
+  PASS_STATUS;
+  status = napi_set_named_property(env, object, "embedded", embedded);
+  PASS_STATUS;
 
   napi_value destroyFn;
-  c->status = napi_create_function(env, "destroy", NAPI_AUTO_LENGTH,
-                                   destroySend, nullptr, &destroyFn);
-  REJECT_STATUS;
-  c->status = napi_set_named_property(env, result, "destroy", destroyFn);
-  REJECT_STATUS;
+  status = napi_create_function(env, "destroy", NAPI_AUTO_LENGTH, destroySend,
+                                nullptr, &destroyFn);
+  PASS_STATUS;
+  status = napi_set_named_property(env, object, "destroy", destroyFn);
+  PASS_STATUS;
+
+  napi_value detachFn;
+  status = napi_create_function(env, "detach", NAPI_AUTO_LENGTH, detachSend,
+                                nullptr, &detachFn);
+  PASS_STATUS;
+  status = napi_set_named_property(env, object, "detach", detachFn);
+  PASS_STATUS;
 
   napi_value videoFn;
-  c->status = napi_create_function(env, "video", NAPI_AUTO_LENGTH, videoSend,
-                                   nullptr, &videoFn);
-  REJECT_STATUS;
-  c->status = napi_set_named_property(env, result, "video", videoFn);
-  REJECT_STATUS;
+  status = napi_create_function(env, "video", NAPI_AUTO_LENGTH, videoSend,
+                                nullptr, &videoFn);
+  PASS_STATUS;
+  status = napi_set_named_property(env, object, "video", videoFn);
+  PASS_STATUS;
+
+  napi_value setOverlayFn;
+  status = napi_create_function(env, "setOverlay", NAPI_AUTO_LENGTH, setOverlay,
+                                nullptr, &setOverlayFn);
+  PASS_STATUS;
+  status = napi_set_named_property(env, object, "setOverlay", setOverlayFn);
+  PASS_STATUS;
 
   napi_value audioFn;
-  c->status = napi_create_function(env, "audio", NAPI_AUTO_LENGTH, audioSend,
-                                   nullptr, &audioFn);
-  REJECT_STATUS;
-  c->status = napi_set_named_property(env, result, "audio", audioFn);
-  REJECT_STATUS;
+  status = napi_create_function(env, "audio", NAPI_AUTO_LENGTH, audioSend,
+                                nullptr, &audioFn);
+  PASS_STATUS;
+  status = napi_set_named_property(env, object, "audio", audioFn);
+  PASS_STATUS;
 
   napi_value metadataFn;
-  c->status = napi_create_function(env, "metadata", NAPI_AUTO_LENGTH,
-                                   metadataSend, nullptr, &metadataFn);
-  REJECT_STATUS;
-  c->status = napi_set_named_property(env, result, "metadata", metadataFn);
-  REJECT_STATUS;
+  status = napi_create_function(env, "metadata", NAPI_AUTO_LENGTH, metadataSend,
+                                nullptr, &metadataFn);
+  PASS_STATUS;
+  status = napi_set_named_property(env, object, "metadata", metadataFn);
+  PASS_STATUS;
 
   napi_value connectionsFn;
-  c->status = napi_create_function(env, "connections", NAPI_AUTO_LENGTH,
-                                   connections, nullptr, &connectionsFn);
-  REJECT_STATUS;
-  c->status =
-      napi_set_named_property(env, result, "connections", connectionsFn);
-  REJECT_STATUS;
+  status = napi_create_function(env, "connections", NAPI_AUTO_LENGTH,
+                                connections, nullptr, &connectionsFn);
+  PASS_STATUS;
+  status = napi_set_named_property(env, object, "connections", connectionsFn);
+  PASS_STATUS;
 
   napi_value tallyFn;
-  c->status = napi_create_function(env, "tally", NAPI_AUTO_LENGTH, tally,
-                                   nullptr, &tallyFn);
-  REJECT_STATUS;
-  c->status = napi_set_named_property(env, result, "tally", tallyFn);
-  REJECT_STATUS;
+  status = napi_create_function(env, "tally", NAPI_AUTO_LENGTH, tally, nullptr,
+                                &tallyFn);
+  PASS_STATUS;
+  status = napi_set_named_property(env, object, "tally", tallyFn);
+  PASS_STATUS;
 
   napi_value sourcenameFn;
-  c->status = napi_create_function(env, "sourcename", NAPI_AUTO_LENGTH,
-                                   sourcename, nullptr, &sourcenameFn);
-  REJECT_STATUS;
-  c->status = napi_set_named_property(env, result, "sourcename", sourcenameFn);
-  REJECT_STATUS;
+  status = napi_create_function(env, "sourcename", NAPI_AUTO_LENGTH, sourcename,
+                                nullptr, &sourcenameFn);
+  PASS_STATUS;
+  status = napi_set_named_property(env, object, "sourcename", sourcenameFn);
+  PASS_STATUS;
 
   napi_value name, groups, clockVideo, clockAudio;
-  c->status =
-      napi_create_string_utf8(env, c->name.get(), NAPI_AUTO_LENGTH, &name);
-  REJECT_STATUS;
-  c->status = napi_set_named_property(env, result, "name", name);
-  REJECT_STATUS;
+  status = napi_create_string_utf8(env, instance->name.c_str(),
+                                   NAPI_AUTO_LENGTH, &name);
+  PASS_STATUS;
+  status = napi_set_named_property(env, object, "name", name);
+  PASS_STATUS;
+
+  if (instance->hasGroups) {
+    status = napi_create_string_utf8(env, instance->groups.c_str(),
+                                     NAPI_AUTO_LENGTH, &groups);
+    PASS_STATUS;
+    status = napi_set_named_property(env, object, "groups", groups);
+    PASS_STATUS;
+  }
 
-  if (c->groups != nullptr) {
-    c->status = napi_create_string_utf8(env, c->groups.get(), NAPI_AUTO_LENGTH,
-                                        &groups);
-    REJECT_STATUS;
-    c->status = napi_set_named_property(env, result, "groups", groups);
-    REJECT_STATUS;
+  status = napi_get_boolean(env, instance->clockVideo, &clockVideo);
+  PASS_STATUS;
+  status = napi_set_named_property(env, object, "clockVideo", clockVideo);
+  PASS_STATUS;
+
+  status = napi_get_boolean(env, instance->clockAudio, &clockAudio);
+  PASS_STATUS;
+  status = napi_set_named_property(env, object, "clockAudio", clockAudio);
+  PASS_STATUS;
+
+  napi_value splitFields;
+  status = napi_get_boolean(env, instance->splitFields, &splitFields);
+  PASS_STATUS;
+  status = napi_set_named_property(env, object, "splitFields", splitFields);
+  PASS_STATUS;
+  *result = object;
+  return napi_ok;
+}
+
+} // namespace
+
+napi_status makeSenderObject(napi_env env, nativeHandle *handle,
+                             napi_value *result) {
+  napi_status status;
+  napi_value embedded;
+  status = napi_create_external(env, handle, finalizeNativeHandle, nullptr,
+                                &embedded);
+  if (status != napi_ok) {
+    closeNativeHandle(handle);
+    delete handle;
+    return status;
   }
+  status =
+      fillSenderObject(env, embedded, (sendInstance *)handle->value, result);
+  // embedded owns the handle now and frees it once collected.
+  if (status != napi_ok)
+    closeNativeHandle(handle);
+  return status;
+}
 
-  c->status = napi_get_boolean(env, c->clockVideo, &clockVideo);
-  REJECT_STATUS;
-  c->status = napi_set_named_property(env, result, "clockVideo", clockVideo);
-  REJECT_STATUS;
+napi_value detachSend(napi_env env, napi_callback_info info) {
+  return detachHandleObject(env, info, detachedKind::sender,
+                            destroySendInstance, "Sender");
+}
+
+void sendComplete(napi_env env, napi_status asyncStatus, void *data) {
+  sendCarrier *c = (sendCarrier *)data;
 
-  c->status = napi_get_boolean(env, c->clockAudio, &clockAudio);
+  if (asyncStatus != napi_ok) {
+    c->status = asyncStatus;
+    c->errorMsg = "Async sender creation failed to complete.";
+  }
   REJECT_STATUS;
-  c->status = napi_set_named_property(env, result, "clockAudio", clockAudio);
+
+  sendInstance *instance = new (std::nothrow) sendInstance;
+  nativeHandle *handle =
+      instance == nullptr ? nullptr
+                          : createNativeHandle(instance, destroySendInstance);
+  if (handle == nullptr) {
+    delete instance;
+    NDIlib_send_destroy(c->send);
+    c->send = nullptr;
+    c->status = GRANDI_ALLOCATION_FAILURE;
+    c->errorMsg = "Failed to allocate Sender handle.";
+    REJECT_STATUS;
+  }
+  instance->send = c->send;
+  instance->splitFields = c->splitFields;
+  instance->burnIn = c->burnIn;
+  instance->burnInConfig = c->burnInConfig;
+  instance->name = c->name.get();
+  if (c->groups != nullptr) {
+    instance->groups = c->groups.get();
+    instance->hasGroups = true;
+  }
+  instance->clockVideo = c->clockVideo;
+  instance->clockAudio = c->clockAudio;
+  napi_value result;
+  c->status = makeSenderObject(env, handle, &result);
   REJECT_STATUS;
 
   napi_status status;
@@ -523,6 +651,28 @@ napi_value send(napi_env env, napi_callback_info info) {
     REJECT_RETURN;
   }
 
+  napi_value splitFields;
+  c->status = napi_get_named_property(env, config, "splitFields", &splitFields);
+  REJECT_RETURN;
+  c->status = napi_typeof(env, splitFields, &type);
+  REJECT_RETURN;
+  if (type != napi_undefined) {
+    if (type != napi_boolean)
+      REJECT_ERROR_RETURN("splitFields property must be of type boolean.",
+                          GRANDI_INVALID_ARGS);
+    c->status = napi_get_value_bool(env, splitFields, &c->splitFields);
+    REJECT_RETURN;
+  }
+
+  napi_value burnIn;
+  c->status = napi_get_named_property(env, config, "burnIn", &burnIn);
+  REJECT_RETURN;
+  c->status = parseBurnInOptions(env, burnIn, &c->burnIn, &c->burnInConfig,
+                                 &c->errorMsg);
+  REJECT_RETURN;
+  if (!c->errorMsg.empty())
+    REJECT_ERROR_RETURN(c->errorMsg, GRANDI_INVALID_ARGS);
+
   napi_value resource_name;
   c->status =
       napi_create_string_utf8(env, "Send", NAPI_AUTO_LENGTH, &resource_name);
@@ -536,10 +686,73 @@ napi_value send(napi_env env, napi_callback_info info) {
   return promise;
 }
 
+// Sends a progressive or interleaved frame as field_0 then field_1. Most
+// formats are sent in place with a doubled stride; the rest are split into a
+// scratch buffer one field at a time, as sending is synchronous.
+void sendVideoFields(sendDataCarrier *c) {
+  NDIlib_video_frame_v2_t &frame = c->videoFrame;
+  size_t fieldLines = (size_t)frame.yres / 2;
+  frameLayout source, field;
+  describeFrame(frame.FourCC, frame.line_stride_in_bytes, (size_t)frame.yres,
+                &source);
+  describeFrame(frame.FourCC, frame.line_stride_in_bytes, fieldLines, &field);
+  bool inPlace = fieldViewable(frame.FourCC);
+  ownedBuffer scratch;
+  if (!inPlace && !scratch.allocate(field.size)) {
+    c->status = GRANDI_ALLOCATION_FAILURE;
+    c->errorMsg = "Failed to allocate field buffer.";
+    return;
+  }
+  for (int parity = 0; parity < 2; parity++) {
+    NDIlib_video_frame_v2_t fieldFrame = frame;
+    fieldFrame.yres = (int)fieldLines;
+    fieldFrame.frame_format_type = parity == 0
+                                       ? NDIlib_frame_format_type_field_0
+                                       : NDIlib_frame_format_type_field_1;
+    if (parity == 1)
+      fieldFrame.p_metadata = nullptr;
+    if (inPlace) {
+      fieldFrame.p_data = frame.p_data + parity * frame.line_stride_in_bytes;
+      fieldFrame.line_stride_in_bytes = frame.line_stride_in_bytes * 2;
+    } else {
+      splitField((uint8_t *)scratch.data, field, frame.p_data, source, parity,
+                 fieldLines);
+      fieldFrame.p_data = (uint8_t *)scratch.data;
+    }
+    NDIlib_send_send_video_v2(c->send, &fieldFrame);
+  }
+}
+
+void sendVideo(sendDataCarrier *c) {
+  if (c->splitFields) {
+    sendVideoFields(c);
+    return;
+  }
+  NDIlib_send_send_video_v2(c->send, &c->videoFrame);
+}
+
 void videoSendExecute(napi_env env, void *data) {
   sendDataCarrier *c = (sendDataCarrier *)data;
 
-  NDIlib_send_send_video_v2(c->send, &c->videoFrame);
+  if (!c->keyed && !c->burnIn) {
+    sendVideo(c);
+    return;
+  }
+  // The keyed copy is shared by the sender's keyed sends, so it is held
+  // until the frame has been sent. Burn-in draws over the same copy.
+  overlayKeyer &keyer = c->instance->keyer;
+  std::lock_guard<std::mutex> lock(keyer.mutex);
+  if (c->keyed &&
+      !keyer.key(&c->videoFrame, c->perFrameOverlay ? &c->overlay : nullptr,
+                 c))
+    return;
+  if (c->burnIn) {
+    if (!keyer.copy(&c->videoFrame, c))
+      return;
+    burnIn(c->instance->burnInConfig, c->videoFrame, c->instance->name,
+           c->frameNumber);
+  }
+  sendVideo(c);
 }
 
 void videoSendComplete(napi_env env, napi_status asyncStatus, void *data) {
@@ -577,13 +790,14 @@ napi_value videoSend(napi_env env, napi_callback_info info) {
   c->status = napi_create_promise(env, &c->_deferred, &promise);
   REJECT_RETURN;
 
-  size_t argc = 1;
-  napi_value args[1];
+  size_t argc = 2;
+  napi_value args[2];
   napi_value thisValue;
   c->status = napi_get_cb_info(env, info, &argc, args, &thisValue, nullptr);
   REJECT_RETURN;
 
-  if (!acquireSendFromThis(env, thisValue, &c->handle, &c->send, c))
+  if (!acquireSendFromThis(env, thisValue, &c->handle, &c->send, c,
+                           &c->instance, true))
     REJECT_RETURN;
 
   if (argc >= 1) {
@@ -736,8 +950,74 @@ napi_value videoSend(napi_env env, napi_callback_info info) {
     if (!validateVideoFrameBuffer(c->videoFrame, length, c))
       REJECT_RETURN;
 
+    // Field frames are sent as they are.
+    NDIlib_frame_format_type_e format = c->videoFrame.frame_format_type;
+    c->splitFields =
+        c->instance->splitFields &&
+        (format == NDIlib_frame_format_type_progressive ||
+         format == NDIlib_frame_format_type_interleaved);
+    if (c->splitFields) {
+      if (c->videoFrame.line_stride_in_bytes == 0)
+        c->videoFrame.line_stride_in_bytes =
+            defaultLineStride(c->videoFrame.FourCC, c->videoFrame.xres);
+      frameLayout layout;
+      if (!describeFrame(c->videoFrame.FourCC,
+                         c->videoFrame.line_stride_in_bytes,
+                         (size_t)c->videoFrame.yres, &layout))
+        REJECT_ERROR_RETURN("splitFields does not support 4:2:0 formats.",
+                            GRANDI_INVALID_ARGS);
+      if (c->videoFrame.yres % 2 != 0)
+        REJECT_ERROR_RETURN("yres must be even to split fields.",
+                            GRANDI_INVALID_ARGS);
+    }
+
+    napi_value overlayBuffer = nullptr;
+    if (argc >= 2) {
+      napi_value options = args[1];
+      c->status = napi_typeof(env, options, &type);
+      REJECT_RETURN;
+      if (type != napi_undefined) {
+        c->status = napi_is_array(env, options, &isArray);
+        REJECT_RETURN;
+        if (type != napi_object || isArray)
+          REJECT_ERROR_RETURN("Video send options must be an object.",
+                              GRANDI_INVALID_ARGS);
+        napi_value overlay;
+        c->status = napi_get_named_property(env, options, "overlay", &overlay);
+        REJECT_RETURN;
+        c->status = napi_typeof(env, overlay, &type);
+        REJECT_RETURN;
+        if (type != napi_undefined && type != napi_null) {
+          c->status = parseOverlay(env, overlay, options, &c->overlay,
+                                   &overlayBuffer, &c->errorMsg);
+          REJECT_RETURN;
+          if (!c->errorMsg.empty())
+            c->status = GRANDI_INVALID_ARGS;
+          REJECT_RETURN;
+          c->perFrameOverlay = true;
+        }
+      }
+    }
+    c->keyed = c->perFrameOverlay || c->instance->keyer.hasResident();
+    if (c->keyed && !keyable(c->videoFrame.FourCC))
+      REJECT_ERROR_RETURN("Overlays can only be keyed over UYVY, UYVA, BGRA, "
+                          "BGRX, RGBA, or RGBX frames.",
+                          GRANDI_INVALID_ARGS);
+    c->burnIn = c->instance->burnIn && drawable(c->videoFrame.FourCC);
+    c->frameNumber = c->instance->framesSent++;
+
+    // A per-frame overlay's Buffer is held alongside the frame's.
+    napi_value held = videoBuffer;
+    if (overlayBuffer != nullptr) {
+      c->status = napi_create_array_with_length(env, 2, &held);
+      REJECT_RETURN;
+      c->status = napi_set_element(env, held, 0, videoBuffer);
+      REJECT_RETURN;
+      c->status = napi_set_element(env, held, 1, overlayBuffer);
+      REJECT_RETURN;
+    }
     napi_ref bufferRef;
-    c->status = napi_create_reference(env, videoBuffer, 1, &bufferRef);
+    c->status = napi_create_reference(env, held, 1, &bufferRef);
     REJECT_RETURN;
     c->passthru = bufferRef;
   } else
@@ -968,10 +1248,10 @@ napi_value connections(napi_env env, napi_callback_info info) {
   status = napi_get_value_external(env, sendValue, &sendData);
   CHECK_STATUS;
   nativeHandle *handle = (nativeHandle *)sendData;
-  void *sendInstance;
-  if (!acquireNativeHandle(handle, &sendInstance))
+  void *instanceData;
+  if (!acquireNativeHandle(handle, &instanceData))
     NAPI_THROW_ERROR("Sender has been destroyed.");
-  NDIlib_send_instance_t sender = (NDIlib_send_instance_t)sendInstance;
+  NDIlib_send_instance_t sender = ((sendInstance *)instanceData)->send;
 
   int conns = NDIlib_send_get_no_connections(sender, 0);
   releaseNativeHandle(handle);
@@ -998,10 +1278,10 @@ napi_value tally(napi_env env, napi_callback_info info) {
   status = napi_get_value_external(env, sendValue, &sendData);
   CHECK_STATUS;
   nativeHandle *handle = (nativeHandle *)sendData;
-  void *sendInstance;
-  if (!acquireNativeHandle(handle, &sendInstance))
+  void *instanceData;
+  if (!acquireNativeHandle(handle, &instanceData))
     NAPI_THROW_ERROR("Sender has been destroyed.");
-  NDIlib_send_instance_t sender = (NDIlib_send_instance_t)sendInstance;
+  NDIlib_send_instance_t sender = ((sendInstance *)instanceData)->send;
 
   NDIlib_tally_t tally;
   bool changed = NDIlib_send_get_tally(sender, &tally, 0);
@@ -1066,10 +1346,10 @@ napi_value metadataSend(napi_env env, napi_callback_info info) {
   status = napi_get_value_external(env, sendValue, &sendData);
   CHECK_STATUS;
   nativeHandle *handle = (nativeHandle *)sendData;
-  void *sendInstance;
-  if (!acquireNativeHandle(handle, &sendInstance))
+  void *instanceData;
+  if (!acquireNativeHandle(handle, &instanceData))
     NAPI_THROW_ERROR("Sender has been destroyed.");
-  NDIlib_send_instance_t sender = (NDIlib_send_instance_t)sendInstance;
+  NDIlib_send_instance_t sender = ((sendInstance *)instanceData)->send;
 
   NDIlib_send_send_metadata(sender, &frame);
   releaseNativeHandle(handle);
@@ -1096,10 +1376,10 @@ napi_value sourcename(napi_env env, napi_callback_info info) {
   status = napi_get_value_external(env, sendValue, &sendData);
   CHECK_STATUS;
   nativeHandle *handle = (nativeHandle *)sendData;
-  void *sendInstance;
-  if (!acquireNativeHandle(handle, &sendInstance))
+  void *instanceData;
+  if (!acquireNativeHandle(handle, &instanceData))
     NAPI_THROW_ERROR("Sender has been destroyed.");
-  NDIlib_send_instance_t sender = (NDIlib_send_instance_t)sendInstance;
+  NDIlib_send_instance_t sender = ((sendInstance *)instanceData)->send;
 
   const NDIlib_source_t *source = NDIlib_send_get_source_name(sender);
   std::string sourceName = source->p_ndi_name;
@@ -1111,3 +1391,79 @@ napi_value sourcename(napi_env env, napi_callback_info info) {
 
   return result;
 }
+
+napi_value setOverlay(napi_env env, napi_callback_info info) {
+  napi_status status;
+
+  size_t argc = 2;
+  napi_value args[2];
+  napi_value thisValue;
+  status = napi_get_cb_info(env, info, &argc, args, &thisValue, nullptr);
+  CHECK_STATUS;
+
+  napi_valuetype type = napi_undefined;
+  if (argc >= 1) {
+    status = napi_typeof(env, args[0], &type);
+    CHECK_STATUS;
+  }
+  // The overlay is copied now and converted on the first keyed send, so it
+  // costs nothing further until it is replaced.
+  residentOverlay *overlay = nullptr;
+  if (type != napi_undefined && type != napi_null) {
+    napi_value options = nullptr;
+    if (argc >= 2) {
+      status = napi_typeof(env, args[1], &type);
+      CHECK_STATUS;
+      bool isArray = false;
+      if (type == napi_object) {
+        status = napi_is_array(env, args[1], &isArray);
+        CHECK_STATUS;
+      }
+      if (type != napi_undefined && (type != napi_object || isArray))
+        NAPI_THROW_ERROR("Overlay options must be an object.");
+      if (type != napi_undefined)
+        options = args[1];
+    }
+    overlaySource source;
+    napi_value buffer;
+    std::string error;
+    status = parseOverlay(env, args[0], options, &source, &buffer, &error);
+    CHECK_STATUS;
+    if (!error.empty())
+      NAPI_THROW_ERROR(error.c_str());
+    frameLayout layout;
+    describeFrame(source.fourCC, source.lineStride, (size_t)source.yres,
+                  &layout);
+    overlay = new (std::nothrow) residentOverlay;
+    if (overlay == nullptr ||
+        !overlay->frame.copyFrom(source.data, layout.size)) {
+      delete overlay;
+      NAPI_THROW_ERROR("Failed to allocate overlay buffer.");
+    }
+    source.data = (const uint8_t *)overlay->frame.data;
+    overlay->source = source;
+  }
+
+  napi_value sendValue;
+  status = napi_get_named_property(env, thisValue, "embedded", &sendValue);
+  if (status == napi_ok)
+    status = napi_typeof(env, sendValue, &type);
+  void *sendData = nullptr;
+  if (status == napi_ok && type == napi_external)
+    status = napi_get_value_external(env, sendValue, &sendData);
+  nativeHandle *handle = (nativeHandle *)sendData;
+  void *instanceData;
+  if (status != napi_ok || handle == nullptr ||
+      !acquireNativeHandle(handle, &instanceData)) {
+    delete overlay;
+    CHECK_STATUS;
+    NAPI_THROW_ERROR("Sender has been destroyed.");
+  }
+  ((sendInstance *)instanceData)->keyer.setResident(overlay);
+  releaseNativeHandle(handle);
+
+  napi_value result;
+  status = napi_get_undefined(env, &result);
+  CHECK_STATUS;
+  return result;
+}
@@ -16,23 +16,72 @@
 #ifndef GRANDI_SEND_H
 #define GRANDI_SEND_H
 
+#include <cstdint>
 #include <string>
 #include "node_api.h"
+#include "grandi_overlay.h"
+#include "grandi_timecode.h"
 #include "grandi_util.h"
 
 napi_value send(napi_env env, napi_callback_info info);
 
+// Value held by a sender's nativeHandle.
+struct sendInstance {
+  NDIlib_send_instance_t send = nullptr;
+  bool splitFields = false;
+  overlayKeyer keyer;
+  bool burnIn = false;
+  burnInOptions burnInConfig;
+  std::string name;
+  // Creation settings, reported on the sender object.
+  std::string groups;
+  bool hasGroups = false;
+  bool clockVideo = false;
+  bool clockAudio = false;
+  // Video frames passed to video(), counted on the JavaScript thread.
+  int64_t framesSent = 0;
+};
+
+// Builds the sender object around handle, whose value is a sendInstance, for
+// send() and adopt(). On failure the sendInstance is destroyed, and handle is
+// freed now or when its external is collected.
+napi_status makeSenderObject(napi_env env, nativeHandle *handle,
+                             napi_value *result);
+
+// Checks that a data buffer of bufferLen bytes holds frame's layout. On
+// failure sets c->status and c->errorMsg.
+bool validateVideoFrameBuffer(const NDIlib_video_frame_v2_t &frame,
+                              size_t bufferLen, carrier *c);
+
+// Binds the video of the sender object `sender` to a native producer, so
+// video() is unavailable until releaseNativeCaptureBinding(*handle). Audio
+// and metadata still pass through JavaScript. label names the option in
+// errors. On failure sets c->status and c->errorMsg.
+bool bindSenderVideo(napi_env env, napi_value sender, const std::string &label,
+                     nativeHandle **handle, sendInstance **instance,
+                     carrier *c);
+
 struct sendCarrier : carrier {
   std::unique_ptr<char[]> name;
   std::unique_ptr<char[]> groups;
   bool clockVideo = false;
   bool clockAudio = false;
+  bool splitFields = false;
+  bool burnIn = false;
+  burnInOptions burnInConfig;
   NDIlib_send_instance_t send;
 };
 
 struct sendDataCarrier : carrier {
   nativeHandle *handle = nullptr;
+  sendInstance *instance = nullptr;
   NDIlib_send_instance_t send;
+  bool splitFields = false;
+  bool keyed = false;
+  bool perFrameOverlay = false;
+  overlaySource overlay;
+  bool burnIn = false;
+  int64_t frameNumber = 0;
   NDIlib_video_frame_v2_t videoFrame;
   NDIlib_audio_frame_v3_t audioFrame;
   NDIlib_metadata_frame_t metadataFrame;
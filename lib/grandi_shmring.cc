@@ -0,0 +1,840 @@
+/* Copyright 2025 Sarhan Aissi <github@tux.tn>.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include <Processing.NDI.Lib.h>
+
+#include "grandi_shmring.h"
+#include "grandi_receive.h"
+#include "grandi_send.h"
+#include "grandi_thread.h"
+#include "grandi_util.h"
+
+#ifdef _WIN32
+
+namespace {
+napi_value rejectUnsupported(napi_env env) {
+  carrier *c = createCarrier<carrier>(env);
+  if (c == nullptr)
+    return nullptr;
+  napi_value promise;
+  c->status = napi_create_promise(env, &c->_deferred, &promise);
+  REJECT_RETURN;
+  REJECT_ERROR_RETURN("Shared-memory rings are not supported on Windows.",
+                      GRANDI_INVALID_ARGS);
+}
+} // namespace
+
+napi_value publishShm(napi_env env, napi_callback_info info) {
+  return rejectUnsupported(env);
+}
+
+napi_value sendShm(napi_env env, napi_callback_info info) {
+  return rejectUnsupported(env);
+}
+
+#else // _WIN32
+
+#include <cerrno>
+#include <sys/mman.h>
+
+#include "grandi_shm.h"
+
+namespace {
+const uint32_t kMaxSlots = 64;
+// One 1080p frame of BGRA, or of UYVY with alpha.
+const uint32_t kDefaultSlotBytes = 1920 * 1080 * 4;
+const uint32_t kMaxSlotBytes = 1u << 30;
+// Bounds how long destroy() waits for a ring thread.
+const uint32_t kWaitMs = 100;
+const size_t kMaxNameLength = 200;
+
+struct shmPublisher {
+  napi_env env = nullptr;
+  nativeHandle *recvHandle = nullptr;
+  NDIlib_recv_instance_t recv = nullptr;
+  napi_ref receiverRef = nullptr;
+  std::string name;
+  uint32_t slots = 4;
+  uint64_t slotBytes = kDefaultSlotBytes;
+  bool replace = false;
+  grandi_shm_header *ring = nullptr;
+  size_t mappingBytes = 0;
+  threadRole role;
+  std::thread thread;
+
+  // Guarded by mutex.
+  bool stopping = false;
+  uint64_t framesPublished = 0;
+  uint64_t framesDropped = 0;
+  double copySumMs = 0.0;
+  double copyMaxMs = 0.0;
+  std::mutex mutex;
+};
+
+// Feeds a sender from a ring that another process creates and writes.
+struct shmSender {
+  napi_env env = nullptr;
+  nativeHandle *sendHandle = nullptr;
+  NDIlib_send_instance_t send = nullptr;
+  napi_ref senderRef = nullptr;
+  std::string name;
+  grandi_shm_header *ring = nullptr;
+  size_t mappingBytes = 0;
+  threadRole role;
+  std::thread thread;
+
+  // Guarded by mutex.
+  bool stopping = false;
+  // Set once the writer closed the ring and every frame was sent.
+  bool closed = false;
+  uint64_t framesSent = 0;
+  uint64_t framesDropped = 0;
+  std::string lastError;
+  std::mutex mutex;
+};
+
+struct publishShmCarrier : carrier {
+  shmPublisher *publisher = nullptr;
+  ~publishShmCarrier();
+};
+
+struct sendShmCarrier : carrier {
+  shmSender *sender = nullptr;
+  ~sendShmCarrier();
+};
+
+void runPublisher(shmPublisher *publisher) {
+  threadRegistration registration(publisher->role);
+  grandi_shm_header *ring = publisher->ring;
+  uint64_t next = 0;
+  while (true) {
+    {
+      std::lock_guard<std::mutex> lock(publisher->mutex);
+      if (publisher->stopping)
+        break;
+    }
+
+    NDIlib_video_frame_v2_t frame{};
+    NDIlib_frame_type_e type = NDIlib_recv_capture_v3(
+        publisher->recv, &frame, nullptr, nullptr, kWaitMs);
+    if (type == NDIlib_frame_type_error) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(kWaitMs));
+      continue;
+    }
+    if (type != NDIlib_frame_type_video)
+      continue;
+
+    size_t bytes = frame.p_data != nullptr ? videoDataSize(frame) : 0;
+    if (bytes == 0 || bytes > ring->slot_bytes) {
+      NDIlib_recv_free_video_v2(publisher->recv, &frame);
+      std::lock_guard<std::mutex> lock(publisher->mutex);
+      publisher->framesDropped++;
+      continue;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    grandi_shm_slot *slot = grandi_shm_begin_write(ring, next);
+    slot->timecode = frame.timecode;
+    slot->timestamp = frame.timestamp;
+    slot->fourcc = (uint32_t)frame.FourCC;
+    slot->frame_format_type = (int32_t)frame.frame_format_type;
+    slot->xres = frame.xres;
+    slot->yres = frame.yres;
+    slot->line_stride = frame.line_stride_in_bytes;
+    slot->frame_rate_n = frame.frame_rate_N;
+    slot->frame_rate_d = frame.frame_rate_D;
+    slot->picture_aspect_ratio = frame.picture_aspect_ratio;
+    slot->data_size = bytes;
+    memcpy(grandi_shm_slot_data(ring, next), frame.p_data, bytes);
+    grandi_shm_end_write(ring, slot, next);
+    next++;
+    double copyMs = std::chrono::duration<double, std::milli>(
+                        std::chrono::steady_clock::now() - start)
+                        .count();
+    NDIlib_recv_free_video_v2(publisher->recv, &frame);
+
+    std::lock_guard<std::mutex> lock(publisher->mutex);
+    publisher->framesPublished++;
+    publisher->copySumMs += copyMs;
+    publisher->copyMaxMs = std::max(publisher->copyMaxMs, copyMs);
+  }
+}
+
+// Sends each frame from its slot without copying. The SDK keeps reading an
+// asynchronously sent frame until the next one is submitted, so a frame is
+// released to the writer only once its successor has been sent.
+void runSender(shmSender *sender) {
+  threadRegistration registration(sender->role);
+  grandi_shm_header *ring = sender->ring;
+  uint64_t next = grandi_shm_load(&ring->read_count);
+  bool holding = false;
+  // Collects the errors of validateVideoFrameBuffer.
+  carrier check;
+  while (true) {
+    {
+      std::lock_guard<std::mutex> lock(sender->mutex);
+      if (sender->stopping)
+        break;
+    }
+
+    uint32_t seen = grandi_shm_load32(&ring->write_futex);
+    if (grandi_shm_load(&ring->write_count) == next) {
+      if (grandi_shm_load32(&ring->state) != GRANDI_SHM_OPEN) {
+        std::lock_guard<std::mutex> lock(sender->mutex);
+        sender->closed = true;
+        break;
+      }
+      grandi_shm_wait(&ring->write_futex, seen, kWaitMs);
+      continue;
+    }
+
+    const grandi_shm_slot *slot = grandi_shm_begin_read(ring, next);
+    bool valid = false;
+    check.errorMsg = "Frame was overwritten before it was sent.";
+    if (slot != nullptr && slot->data_size > ring->slot_bytes) {
+      check.errorMsg = "Frame data_size is larger than slot_bytes.";
+    } else if (slot != nullptr) {
+      NDIlib_video_frame_v2_t frame{};
+      frame.xres = slot->xres;
+      frame.yres = slot->yres;
+      frame.FourCC = (NDIlib_FourCC_video_type_e)slot->fourcc;
+      frame.frame_rate_N = slot->frame_rate_n;
+      frame.frame_rate_D = slot->frame_rate_d;
+      frame.picture_aspect_ratio = slot->picture_aspect_ratio;
+      frame.frame_format_type =
+          (NDIlib_frame_format_type_e)slot->frame_format_type;
+      frame.timecode = slot->timecode;
+      frame.line_stride_in_bytes = slot->line_stride;
+      frame.p_data = grandi_shm_slot_data(ring, next);
+      valid = validateVideoFrameBuffer(frame, slot->data_size, &check);
+      if (valid)
+        NDIlib_send_send_video_async_v2(sender->send, &frame);
+    }
+    if (valid) {
+      // Submitting this frame released the previous one.
+      grandi_shm_release(ring, next);
+      holding = true;
+    } else if (!holding) {
+      grandi_shm_release(ring, next + 1);
+    }
+    next++;
+
+    std::lock_guard<std::mutex> lock(sender->mutex);
+    if (valid) {
+      sender->framesSent++;
+    } else {
+      sender->framesDropped++;
+      sender->lastError = check.errorMsg;
+    }
+  }
+  // Flush so the SDK stops reading the ring, then release every frame.
+  if (holding)
+    NDIlib_send_send_video_async_v2(sender->send, nullptr);
+  grandi_shm_release(ring, next);
+}
+
+// Stops the capture thread, marks the ring closed, unlinks it, and releases
+// the receiver. Returns false when the publisher had already been stopped.
+bool stopRing(napi_env env, shmPublisher *publisher) {
+  {
+    std::lock_guard<std::mutex> lock(publisher->mutex);
+    if (publisher->stopping)
+      return false;
+    publisher->stopping = true;
+  }
+  if (publisher->thread.joinable())
+    publisher->thread.join();
+  if (publisher->ring != nullptr) {
+    grandi_shm_close(publisher->ring);
+    grandi_shm_unmap(publisher->ring, publisher->mappingBytes);
+    // Readers keep their mappings; the name is free for a new ring.
+    shm_unlink(publisher->name.c_str());
+    publisher->ring = nullptr;
+  }
+  if (publisher->recvHandle != nullptr)
+    releaseNativeCaptureBinding(publisher->recvHandle);
+  publisher->recvHandle = nullptr;
+  publisher->recv = nullptr;
+  if (publisher->receiverRef != nullptr)
+    napi_delete_reference(env, publisher->receiverRef);
+  publisher->receiverRef = nullptr;
+  return true;
+}
+
+// Stops the send thread, unmaps the ring, and releases the sender. The ring
+// belongs to its writer, which unlinks it. Returns false when the sender had
+// already been stopped.
+bool stopRing(napi_env env, shmSender *sender) {
+  {
+    std::lock_guard<std::mutex> lock(sender->mutex);
+    if (sender->stopping)
+      return false;
+    sender->stopping = true;
+  }
+  if (sender->thread.joinable())
+    sender->thread.join();
+  if (sender->ring != nullptr)
+    grandi_shm_unmap(sender->ring, sender->mappingBytes);
+  sender->ring = nullptr;
+  if (sender->sendHandle != nullptr)
+    releaseNativeCaptureBinding(sender->sendHandle);
+  sender->sendHandle = nullptr;
+  sender->send = nullptr;
+  if (sender->senderRef != nullptr)
+    napi_delete_reference(env, sender->senderRef);
+  sender->senderRef = nullptr;
+  return true;
+}
+
+template <typename T> void finalizeRing(napi_env env, void *data, void *hint) {
+  T *ring = (T *)data;
+  stopRing(env, ring);
+  delete ring;
+}
+
+publishShmCarrier::~publishShmCarrier() {
+  if (publisher != nullptr)
+    finalizeRing<shmPublisher>(publisher->env, publisher, nullptr);
+}
+
+sendShmCarrier::~sendShmCarrier() {
+  if (sender != nullptr)
+    finalizeRing<shmSender>(sender->env, sender, nullptr);
+}
+
+template <typename T>
+bool acquireRingFromThis(napi_env env, napi_value thisValue, T **ring) {
+  napi_value ringValue;
+  if (napi_get_named_property(env, thisValue, "embedded", &ringValue) !=
+      napi_ok)
+    return false;
+  napi_valuetype type;
+  if (napi_typeof(env, ringValue, &type) != napi_ok || type != napi_external)
+    return false;
+  void *externalData;
+  if (napi_get_value_external(env, ringValue, &externalData) != napi_ok)
+    return false;
+  *ring = (T *)externalData;
+  return true;
+}
+
+template <typename T>
+napi_value destroyRing(napi_env env, napi_callback_info info) {
+  bool success = false;
+  napi_value thisValue;
+  size_t argc = 0;
+  T *ring = nullptr;
+  if (napi_get_cb_info(env, info, &argc, nullptr, &thisValue, nullptr) ==
+          napi_ok &&
+      acquireRingFromThis(env, thisValue, &ring)) {
+    success = stopRing(env, ring);
+    napi_value value;
+    if (napi_create_int32(env, 0, &value) == napi_ok)
+      napi_set_named_property(env, thisValue, "embedded", value);
+  }
+
+  napi_value result;
+  if (napi_get_boolean(env, success, &result) != napi_ok)
+    napi_get_boolean(env, false, &result);
+  return result;
+}
+
+napi_value publisherStats(napi_env env, napi_callback_info info) {
+  napi_status status;
+  size_t argc = 0;
+  napi_value thisValue;
+  status = napi_get_cb_info(env, info, &argc, nullptr, &thisValue, nullptr);
+  CHECK_STATUS;
+
+  shmPublisher *publisher = nullptr;
+  if (!acquireRingFromThis(env, thisValue, &publisher))
+    NAPI_THROW_ERROR("Shared-memory publisher has been destroyed.");
+
+  uint64_t published, dropped;
+  double sumMs, maxMs;
+  {
+    std::lock_guard<std::mutex> lock(publisher->mutex);
+    published = publisher->framesPublished;
+    dropped = publisher->framesDropped;
+    sumMs = publisher->copySumMs;
+    maxMs = publisher->copyMaxMs;
+  }
+
+  napi_value result, copy, value;
+  status = napi_create_object(env, &result);
+  CHECK_STATUS;
+  status = napi_create_double(env, (double)published, &value);
+  CHECK_STATUS;
+  status = napi_set_named_property(env, result, "framesPublished", value);
+  CHECK_STATUS;
+  status = napi_create_double(env, (double)dropped, &value);
+  CHECK_STATUS;
+  status = napi_set_named_property(env, result, "framesDropped", value);
+  CHECK_STATUS;
+
+  status = napi_create_object(env, &copy);
+  CHECK_STATUS;
+  status = napi_create_double(
+      env, published > 0 ? sumMs / (double)published : 0.0, &value);
+  CHECK_STATUS;
+  status = napi_set_named_property(env, copy, "mean", value);
+  CHECK_STATUS;
+  status = napi_create_double(env, maxMs, &value);
+  CHECK_STATUS;
+  status = napi_set_named_property(env, copy, "max", value);
+  CHECK_STATUS;
+  status = napi_set_named_property(env, result, "copyMs", copy);
+  CHECK_STATUS;
+  return result;
+}
+
+napi_value senderStats(napi_env env, napi_callback_info info) {
+  napi_status status;
+  size_t argc = 0;
+  napi_value thisValue;
+  status = napi_get_cb_info(env, info, &argc, nullptr, &thisValue, nullptr);
+  CHECK_STATUS;
+
+  shmSender *sender = nullptr;
+  if (!acquireRingFromThis(env, thisValue, &sender))
+    NAPI_THROW_ERROR("Shared-memory sender has been destroyed.");
+
+  uint64_t sent, dropped;
+  bool closed;
+  std::string lastError;
+  {
+    std::lock_guard<std::mutex> lock(sender->mutex);
+    sent = sender->framesSent;
+    dropped = sender->framesDropped;
+    closed = sender->closed;
+    lastError = sender->lastError;
+  }
+
+  napi_value result, value;
+  status = napi_create_object(env, &result);
+  CHECK_STATUS;
+  status = napi_create_double(env, (double)sent, &value);
+  CHECK_STATUS;
+  status = napi_set_named_property(env, result, "framesSent", value);
+  CHECK_STATUS;
+  status = napi_create_double(env, (double)dropped, &value);
+  CHECK_STATUS;
+  status = napi_set_named_property(env, result, "framesDropped", value);
+  CHECK_STATUS;
+  status = napi_get_boolean(env, closed, &value);
+  CHECK_STATUS;
+  status = napi_set_named_property(env, result, "closed", value);
+  CHECK_STATUS;
+  if (!lastError.empty()) {
+    status = napi_create_string_utf8(env, lastError.c_str(), NAPI_AUTO_LENGTH,
+                                     &value);
+    CHECK_STATUS;
+    status = napi_set_named_property(env, result, "lastError", value);
+    CHECK_STATUS;
+  }
+  return result;
+}
+
+// Reads the options object of publishShm() or sendShm().
+bool readRingOptions(napi_env env, napi_callback_info info,
+                     napi_value *options, carrier *c) {
+  size_t argc = 1;
+  napi_value args[1];
+  c->status = napi_get_cb_info(env, info, &argc, args, nullptr, nullptr);
+  if (c->status != napi_ok)
+    return false;
+  napi_valuetype type = napi_undefined;
+  bool isArray = false;
+  if (argc >= 1) {
+    c->status = napi_typeof(env, args[0], &type);
+    if (c->status != napi_ok)
+      return false;
+    c->status = napi_is_array(env, args[0], &isArray);
+    if (c->status != napi_ok)
+      return false;
+  }
+  if (type != napi_object || isArray) {
+    c->status = GRANDI_INVALID_ARGS;
+    c->errorMsg = "Shared-memory options must be an object.";
+    return false;
+  }
+  *options = args[0];
+  return true;
+}
+
+// Reads the name option. POSIX names are one path component with a leading
+// slash, which is added when missing.
+// Reads the scheduling option of the ring thread, which is listed by
+// threadTopology() under role with the ring name as its owner.
+bool parseRingRole(napi_env env, napi_value options, const char *role,
+                   const std::string &name, threadRole *thread, carrier *c) {
+  c->status =
+      parseThreadPlacement(env, options, &thread->placement, &c->errorMsg);
+  if (c->status != napi_ok)
+    return false;
+  if (!c->errorMsg.empty()) {
+    c->status = GRANDI_INVALID_ARGS;
+    return false;
+  }
+  thread->role = role;
+  thread->owner = name;
+  return true;
+}
+
+bool parseRingName(napi_env env, napi_value options, std::string *name,
+                   carrier *c) {
+  napi_value value;
+  c->status = napi_get_named_property(env, options, "name", &value);
+  if (c->status != napi_ok)
+    return false;
+  napi_valuetype type;
+  c->status = napi_typeof(env, value, &type);
+  if (c->status != napi_ok)
+    return false;
+  if (type != napi_string) {
+    c->status = GRANDI_INVALID_ARGS;
+    c->errorMsg = "Name property must be of type string.";
+    return false;
+  }
+  std::unique_ptr<char[]> text;
+  if (!readUtf8String(env, value, &text, c))
+    return false;
+  std::string parsed = text.get();
+  if (!parsed.empty() && parsed[0] == '/')
+    parsed.erase(0, 1);
+  if (parsed.empty() || parsed.size() > kMaxNameLength ||
+      parsed.find('/') != std::string::npos) {
+    c->status = GRANDI_INVALID_ARGS;
+    c->errorMsg = "name must be 1 to 200 characters without '/' after an "
+                  "optional leading one.";
+    return false;
+  }
+  *name = "/" + parsed;
+  return true;
+}
+
+// Reads an optional integer property into *result, which keeps its default
+// when the property is undefined.
+bool parseOptionalInteger(napi_env env, napi_value object, const char *name,
+                          uint32_t min, uint32_t max, uint32_t *result,
+                          carrier *c) {
+  napi_value value;
+  c->status = napi_get_named_property(env, object, name, &value);
+  if (c->status != napi_ok)
+    return false;
+  napi_valuetype type;
+  c->status = napi_typeof(env, value, &type);
+  if (c->status != napi_ok)
+    return false;
+  if (type == napi_undefined)
+    return true;
+  uint32_t parsed = 0;
+  c->status = parseUint32Value(env, value, name, &parsed, &c->errorMsg);
+  if (c->status != napi_ok)
+    return false;
+  if (!c->errorMsg.empty() || parsed < min || parsed > max) {
+    c->status = GRANDI_INVALID_ARGS;
+    c->errorMsg = std::string(name) + " must be an integer between " +
+                  std::to_string(min) + " and " + std::to_string(max) + ".";
+    return false;
+  }
+  *result = parsed;
+  return true;
+}
+
+// Queues the work that maps a ring. Execute can fail fast and set c->status
+// before napi_queue_async_work returns, so the queue result must not
+// overwrite it.
+bool queueRingWork(napi_env env, const char *resource,
+                   napi_async_execute_callback execute,
+                   napi_async_complete_callback complete, carrier *c) {
+  napi_value resource_name;
+  c->status = napi_create_string_utf8(env, resource, NAPI_AUTO_LENGTH,
+                                      &resource_name);
+  if (c->status != napi_ok)
+    return false;
+  c->status = napi_create_async_work(env, NULL, resource_name, execute,
+                                     complete, c, &c->_request);
+  if (c->status != napi_ok)
+    return false;
+  napi_status status = napi_queue_async_work(env, c->_request);
+  if (status != napi_ok) {
+    c->status = status;
+    return false;
+  }
+  return true;
+}
+
+// Creates the JavaScript object of a ring around its external, with name,
+// slots, slotBytes, stats(), and destroy().
+template <typename T>
+napi_status makeRingObject(napi_env env, napi_value embedded, const T *ring,
+                           napi_callback stats, uint32_t slots,
+                           uint64_t slotBytes, napi_value *result) {
+  napi_status status = napi_create_object(env, result);
+  PASS_STATUS;
+  status = napi_set_named_property(env, *result, "embedded", embedded);
+  PASS_STATUS;
+
+  napi_value value;
+
+  struct {
+    const char *name;
+    napi_callback callback;
+  } methods[] = {
+      {"stats", stats},
+      {"destroy", destroyRing<T>},
+  };
+  for (auto &method : methods) {
+    status = napi_create_function(env, method.name, NAPI_AUTO_LENGTH,
+                                  method.callback, nullptr, &value);
+    PASS_STATUS;
+    status = napi_set_named_property(env, *result, method.name, value);
+    PASS_STATUS;
+  }
+
+  status = napi_create_string_utf8(env, ring->name.c_str(), NAPI_AUTO_LENGTH,
+                                   &value);
+  PASS_STATUS;
+  status = napi_set_named_property(env, *result, "name", value);
+  PASS_STATUS;
+  status = napi_create_uint32(env, slots, &value);
+  PASS_STATUS;
+  status = napi_set_named_property(env, *result, "slots", value);
+  PASS_STATUS;
+  status = napi_create_double(env, (double)slotBytes, &value);
+  PASS_STATUS;
+  return napi_set_named_property(env, *result, "slotBytes", value);
+}
+
+void publishShmExecute(napi_env env, void *data) {
+  publishShmCarrier *c = (publishShmCarrier *)data;
+  shmPublisher *publisher = c->publisher;
+  const char *name = publisher->name.c_str();
+
+  if (publisher->replace)
+    shm_unlink(name);
+  publisher->ring = grandi_shm_create(name, publisher->slots,
+                                      publisher->slotBytes,
+                                      &publisher->mappingBytes);
+  if (publisher->ring == nullptr && errno == EEXIST) {
+    c->status = GRANDI_INVALID_ARGS;
+    c->errorMsg = "Shared memory " + publisher->name + " already exists.";
+  } else if (publisher->ring == nullptr) {
+    c->status = GRANDI_ALLOCATION_FAILURE;
+    c->errorMsg =
+        "Failed to create shared memory: " + std::string(strerror(errno));
+  }
+}
+
+void publishShmComplete(napi_env env, napi_status asyncStatus, void *data) {
+  publishShmCarrier *c = (publishShmCarrier *)data;
+
+  if (asyncStatus != napi_ok) {
+    c->status = asyncStatus;
+    c->errorMsg = "Async shared-memory publisher creation failed to complete.";
+  }
+  REJECT_STATUS;
+
+  shmPublisher *publisher = c->publisher;
+  napi_value embedded, result;
+  c->status = napi_create_external(env, publisher, finalizeRing<shmPublisher>,
+                                   nullptr, &embedded);
+  REJECT_STATUS;
+  c->publisher = nullptr;
+  c->status =
+      makeRingObject(env, embedded, publisher, publisherStats, publisher->slots,
+                     publisher->ring->slot_bytes, &result);
+  REJECT_STATUS;
+  publisher->thread = std::thread(runPublisher, publisher);
+
+  napi_status status = napi_resolve_deferred(env, c->_deferred, result);
+  FLOATING_STATUS;
+  tidyCarrier(env, c);
+}
+
+void sendShmExecute(napi_env env, void *data) {
+  sendShmCarrier *c = (sendShmCarrier *)data;
+  shmSender *sender = c->sender;
+
+  sender->ring =
+      grandi_shm_map(sender->name.c_str(), 1, &sender->mappingBytes);
+  if (sender->ring == nullptr) {
+    c->status = GRANDI_INVALID_ARGS;
+    if (errno == ENOENT)
+      c->errorMsg = "Shared memory " + sender->name + " does not exist.";
+    else if (errno == EINVAL)
+      c->errorMsg = "Shared memory " + sender->name + " is not a frame ring.";
+    else
+      c->errorMsg =
+          "Failed to map shared memory: " + std::string(strerror(errno));
+    return;
+  }
+
+  // The ring comes from another process, so its layout is checked before
+  // any slot is read.
+  grandi_shm_header *ring = sender->ring;
+  uint32_t slots = ring->slot_count;
+  if (slots < 2 || slots > kMaxSlots ||
+      ring->data_offset < grandi_shm_data_offset(slots) ||
+      ring->slot_bytes > (ring->total_bytes - ring->data_offset) / slots) {
+    c->status = GRANDI_INVALID_ARGS;
+    c->errorMsg = "Shared memory " + sender->name +
+                  " must hold 2 to 64 slots within its size.";
+    return;
+  }
+  if (grandi_shm_load32(&ring->state) != GRANDI_SHM_OPEN) {
+    c->status = GRANDI_INVALID_ARGS;
+    c->errorMsg = "Shared memory " + sender->name + " is closed.";
+  }
+}
+
+void sendShmComplete(napi_env env, napi_status asyncStatus, void *data) {
+  sendShmCarrier *c = (sendShmCarrier *)data;
+
+  if (asyncStatus != napi_ok) {
+    c->status = asyncStatus;
+    c->errorMsg = "Async shared-memory sender creation failed to complete.";
+  }
+  REJECT_STATUS;
+
+  shmSender *sender = c->sender;
+  napi_value embedded, result;
+  c->status = napi_create_external(env, sender, finalizeRing<shmSender>,
+                                   nullptr, &embedded);
+  REJECT_STATUS;
+  c->sender = nullptr;
+  c->status = makeRingObject(env, embedded, sender, senderStats,
+                             sender->ring->slot_count,
+                             sender->ring->slot_bytes, &result);
+  REJECT_STATUS;
+  sender->thread = std::thread(runSender, sender);
+
+  napi_status status = napi_resolve_deferred(env, c->_deferred, result);
+  FLOATING_STATUS;
+  tidyCarrier(env, c);
+}
+} // namespace
+
+napi_value publishShm(napi_env env, napi_callback_info info) {
+  napi_valuetype type;
+  publishShmCarrier *c = createCarrier<publishShmCarrier>(env);
+  if (c == nullptr)
+    return nullptr;
+
+  napi_value promise;
+  c->status = napi_create_promise(env, &c->_deferred, &promise);
+  REJECT_RETURN;
+
+  napi_value options;
+  if (!readRingOptions(env, info, &options, c))
+    REJECT_RETURN;
+
+  c->publisher = new (std::nothrow) shmPublisher;
+  if (c->publisher == nullptr)
+    REJECT_ERROR_RETURN("Failed to allocate shared-memory publisher.",
+                        GRANDI_ALLOCATION_FAILURE);
+  shmPublisher *publisher = c->publisher;
+  publisher->env = env;
+
+  uint32_t slotBytes = kDefaultSlotBytes;
+  if (!parseRingName(env, options, &publisher->name, c) ||
+      !parseOptionalInteger(env, options, "slots", 2, kMaxSlots,
+                            &publisher->slots, c) ||
+      !parseOptionalInteger(env, options, "slotBytes", 1, kMaxSlotBytes,
+                            &slotBytes, c) ||
+      !parseRingRole(env, options, "shm-publisher", publisher->name,
+                     &publisher->role, c))
+    REJECT_RETURN;
+  publisher->slotBytes = slotBytes;
+
+  napi_value replace;
+  c->status = napi_get_named_property(env, options, "replace", &replace);
+  REJECT_RETURN;
+  c->status = napi_typeof(env, replace, &type);
+  REJECT_RETURN;
+  if (type == napi_boolean) {
+    c->status = napi_get_value_bool(env, replace, &publisher->replace);
+    REJECT_RETURN;
+  } else if (type != napi_undefined) {
+    REJECT_ERROR_RETURN("replace must be a Boolean.", GRANDI_INVALID_ARGS);
+  }
+
+  napi_value receiver;
+  c->status = napi_get_named_property(env, options, "receiver", &receiver);
+  REJECT_RETURN;
+  receiveInstance *instance = nullptr;
+  if (!bindReceiverCapture(env, receiver, "receiver", &publisher->recvHandle,
+                           &instance, c))
+    REJECT_RETURN;
+  publisher->recv = instance->recv;
+  c->status = napi_create_reference(env, receiver, 1, &publisher->receiverRef);
+  REJECT_RETURN;
+
+  if (!queueRingWork(env, "PublishShm", publishShmExecute, publishShmComplete,
+                     c))
+    REJECT_RETURN;
+  return promise;
+}
+
+napi_value sendShm(napi_env env, napi_callback_info info) {
+  sendShmCarrier *c = createCarrier<sendShmCarrier>(env);
+  if (c == nullptr)
+    return nullptr;
+
+  napi_value promise;
+  c->status = napi_create_promise(env, &c->_deferred, &promise);
+  REJECT_RETURN;
+
+  napi_value options;
+  if (!readRingOptions(env, info, &options, c))
+    REJECT_RETURN;
+
+  c->sender = new (std::nothrow) shmSender;
+  if (c->sender == nullptr)
+    REJECT_ERROR_RETURN("Failed to allocate shared-memory sender.",
+                        GRANDI_ALLOCATION_FAILURE);
+  shmSender *sender = c->sender;
+  sender->env = env;
+  if (!parseRingName(env, options, &sender->name, c) ||
+      !parseRingRole(env, options, "shm-sender", sender->name, &sender->role,
+                     c))
+    REJECT_RETURN;
+
+  napi_value sendValue;
+  c->status = napi_get_named_property(env, options, "sender", &sendValue);
+  REJECT_RETURN;
+  sendInstance *instance = nullptr;
+  if (!bindSenderVideo(env, sendValue, "sender", &sender->sendHandle,
+                       &instance, c))
+    REJECT_RETURN;
+  sender->send = instance->send;
+  c->status = napi_create_reference(env, sendValue, 1, &sender->senderRef);
+  REJECT_RETURN;
+
+  if (!queueRingWork(env, "SendShm", sendShmExecute, sendShmComplete, c))
+    REJECT_RETURN;
+  return promise;
+}
+
+#endif // _WIN32
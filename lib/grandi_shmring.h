@@ -0,0 +1,27 @@
+/* Copyright 2025 Sarhan Aissi <github@tux.tn>.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+*/
+
+#ifndef GRANDI_SHMRING_H
+#define GRANDI_SHMRING_H
+
+#include "node_api.h"
+
+// Copies a receiver's video into a POSIX shared-memory ring laid out as in
+// include/grandi_shm.h.
+napi_value publishShm(napi_env env, napi_callback_info info);
+// Sends video from a ring that another process writes, without copying.
+napi_value sendShm(napi_env env, napi_callback_info info);
+
+#endif /* GRANDI_SHMRING_H */
@@ -0,0 +1,678 @@
+/* Copyright 2025 Sarhan Aissi <github@tux.tn>.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+*/
+
+#include <cstring>
+
+#include "grandi_simd.h"
+
+#if defined(__SSE2__) || defined(_M_X64) ||                                    \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define GRANDI_SIMD_SSE2 1
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#define GRANDI_SIMD_NEON 1
+#include <arm_neon.h>
+#if defined(__aarch64__) && defined(__GNUC__)
+#define GRANDI_SIMD_STNP 1
+#endif
+#endif
+
+void streamBytes(uint8_t *dst, const uint8_t *src, size_t count) {
+#if defined(GRANDI_SIMD_SSE2)
+  // Streaming stores need 16-byte aligned destinations.
+  size_t head = (16 - ((uintptr_t)dst & 15)) & 15;
+  if (head > count)
+    head = count;
+  memcpy(dst, src, head);
+  size_t i = head;
+  for (; i + 64 <= count; i += 64) {
+    __m128i a = _mm_loadu_si128((const __m128i *)(src + i));
+    __m128i b = _mm_loadu_si128((const __m128i *)(src + i + 16));
+    __m128i c = _mm_loadu_si128((const __m128i *)(src + i + 32));
+    __m128i d = _mm_loadu_si128((const __m128i *)(src + i + 48));
+    _mm_stream_si128((__m128i *)(dst + i), a);
+    _mm_stream_si128((__m128i *)(dst + i + 16), b);
+    _mm_stream_si128((__m128i *)(dst + i + 32), c);
+    _mm_stream_si128((__m128i *)(dst + i + 48), d);
+  }
+  _mm_sfence();
+  memcpy(dst + i, src + i, count - i);
+#elif defined(GRANDI_SIMD_STNP)
+  size_t i = 0;
+  for (; i + 64 <= count; i += 64) {
+    uint8x16_t a = vld1q_u8(src + i);
+    uint8x16_t b = vld1q_u8(src + i + 16);
+    uint8x16_t c = vld1q_u8(src + i + 32);
+    uint8x16_t d = vld1q_u8(src + i + 48);
+    __asm__ volatile("stnp %q0, %q1, [%2]\n\t"
+                     "stnp %q3, %q4, [%2, #32]"
+                     :
+                     : "w"(a), "w"(b), "r"(dst + i), "w"(c), "w"(d)
+                     : "memory");
+  }
+  __asm__ volatile("dmb ishst" ::: "memory");
+  memcpy(dst + i, src + i, count - i);
+#else
+  memcpy(dst, src, count);
+#endif
+}
+
+bool streamingStores() {
+#if defined(GRANDI_SIMD_SSE2) || defined(GRANDI_SIMD_STNP)
+  return true;
+#else
+  return false;
+#endif
+}
+
+void averageBytes(uint8_t *dst, const uint8_t *a, const uint8_t *b,
+                  size_t count) {
+  size_t i = 0;
+#if defined(GRANDI_SIMD_SSE2)
+  for (; i + 16 <= count; i += 16) {
+    __m128i left = _mm_loadu_si128((const __m128i *)(a + i));
+    __m128i right = _mm_loadu_si128((const __m128i *)(b + i));
+    _mm_storeu_si128((__m128i *)(dst + i), _mm_avg_epu8(left, right));
+  }
+#elif defined(GRANDI_SIMD_NEON)
+  for (; i + 16 <= count; i += 16)
+    vst1q_u8(dst + i, vrhaddq_u8(vld1q_u8(a + i), vld1q_u8(b + i)));
+#endif
+  for (; i < count; i++)
+    dst[i] = (uint8_t)((a[i] + b[i] + 1) >> 1);
+}
+
+void averageWords(uint16_t *dst, const uint16_t *a, const uint16_t *b,
+                  size_t count) {
+  size_t i = 0;
+#if defined(GRANDI_SIMD_SSE2)
+  for (; i + 8 <= count; i += 8) {
+    __m128i left = _mm_loadu_si128((const __m128i *)(a + i));
+    __m128i right = _mm_loadu_si128((const __m128i *)(b + i));
+    _mm_storeu_si128((__m128i *)(dst + i), _mm_avg_epu16(left, right));
+  }
+#elif defined(GRANDI_SIMD_NEON)
+  for (; i + 8 <= count; i += 8)
+    vst1q_u16(dst + i, vrhaddq_u16(vld1q_u16(a + i), vld1q_u16(b + i)));
+#endif
+  for (; i < count; i++)
+    dst[i] = (uint16_t)(((uint32_t)a[i] + b[i] + 1) >> 1);
+}
+
+void blendBytes(uint8_t *dst, const uint8_t *a, const uint8_t *b,
+                uint32_t weight, size_t count) {
+  if (weight == 0 || weight >= 256) {
+    const uint8_t *source = weight == 0 ? a : b;
+    if (dst != source)
+      memmove(dst, source, count);
+    return;
+  }
+  size_t i = 0;
+#if defined(GRANDI_SIMD_SSE2)
+  // Both products fit in 16 bits because the weights sum to 256.
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i left = _mm_set1_epi16((short)(256 - weight));
+  const __m128i right = _mm_set1_epi16((short)weight);
+  const __m128i round = _mm_set1_epi16(128);
+  for (; i + 16 <= count; i += 16) {
+    __m128i x = _mm_loadu_si128((const __m128i *)(a + i));
+    __m128i y = _mm_loadu_si128((const __m128i *)(b + i));
+    __m128i low = _mm_add_epi16(
+        _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(x, zero), left),
+                      _mm_mullo_epi16(_mm_unpacklo_epi8(y, zero), right)),
+        round);
+    __m128i high = _mm_add_epi16(
+        _mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(x, zero), left),
+                      _mm_mullo_epi16(_mm_unpackhi_epi8(y, zero), right)),
+        round);
+    _mm_storeu_si128((__m128i *)(dst + i),
+                     _mm_packus_epi16(_mm_srli_epi16(low, 8),
+                                      _mm_srli_epi16(high, 8)));
+  }
+#elif defined(GRANDI_SIMD_NEON)
+  const uint8x8_t left = vdup_n_u8((uint8_t)(256 - weight));
+  const uint8x8_t right = vdup_n_u8((uint8_t)weight);
+  for (; i + 16 <= count; i += 16) {
+    uint8x16_t x = vld1q_u8(a + i);
+    uint8x16_t y = vld1q_u8(b + i);
+    uint16x8_t low =
+        vmlal_u8(vmull_u8(vget_low_u8(x), left), vget_low_u8(y), right);
+    uint16x8_t high =
+        vmlal_u8(vmull_u8(vget_high_u8(x), left), vget_high_u8(y), right);
+    vst1q_u8(dst + i, vcombine_u8(vrshrn_n_u16(low, 8), vrshrn_n_u16(high, 8)));
+  }
+#endif
+  for (; i < count; i++)
+    dst[i] = (uint8_t)((a[i] * (256 - weight) + b[i] * weight + 128) >> 8);
+}
+
+namespace {
+template <typename T>
+T selectStatic(T woven, T above, T below, T previousAbove, T previousBelow,
+               T threshold) {
+  T aboveMotion =
+      above > previousAbove ? above - previousAbove : previousAbove - above;
+  T belowMotion =
+      below > previousBelow ? below - previousBelow : previousBelow - below;
+  if (aboveMotion <= threshold && belowMotion <= threshold)
+    return woven;
+  return (T)(((uint32_t)above + below + 1) >> 1);
+}
+} // namespace
+
+void selectStaticBytes(uint8_t *dst, const uint8_t *woven, const uint8_t *above,
+                       const uint8_t *below, const uint8_t *previousAbove,
+                       const uint8_t *previousBelow, uint8_t threshold,
+                       size_t count) {
+  size_t i = 0;
+#if defined(GRANDI_SIMD_SSE2)
+  const __m128i limit = _mm_set1_epi8((char)threshold);
+  const __m128i zero = _mm_setzero_si128();
+  for (; i + 16 <= count; i += 16) {
+    __m128i up = _mm_loadu_si128((const __m128i *)(above + i));
+    __m128i down = _mm_loadu_si128((const __m128i *)(below + i));
+    __m128i lastUp = _mm_loadu_si128((const __m128i *)(previousAbove + i));
+    __m128i lastDown = _mm_loadu_si128((const __m128i *)(previousBelow + i));
+    __m128i upMotion =
+        _mm_or_si128(_mm_subs_epu8(up, lastUp), _mm_subs_epu8(lastUp, up));
+    __m128i downMotion = _mm_or_si128(_mm_subs_epu8(down, lastDown),
+                                      _mm_subs_epu8(lastDown, down));
+    __m128i still =
+        _mm_and_si128(_mm_cmpeq_epi8(_mm_subs_epu8(upMotion, limit), zero),
+                      _mm_cmpeq_epi8(_mm_subs_epu8(downMotion, limit), zero));
+    __m128i weave = _mm_loadu_si128((const __m128i *)(woven + i));
+    __m128i bob = _mm_avg_epu8(up, down);
+    _mm_storeu_si128((__m128i *)(dst + i),
+                     _mm_or_si128(_mm_and_si128(still, weave),
+                                  _mm_andnot_si128(still, bob)));
+  }
+#elif defined(GRANDI_SIMD_NEON)
+  const uint8x16_t limit = vdupq_n_u8(threshold);
+  for (; i + 16 <= count; i += 16) {
+    uint8x16_t up = vld1q_u8(above + i);
+    uint8x16_t down = vld1q_u8(below + i);
+    uint8x16_t still =
+        vandq_u8(vcleq_u8(vabdq_u8(up, vld1q_u8(previousAbove + i)), limit),
+                 vcleq_u8(vabdq_u8(down, vld1q_u8(previousBelow + i)), limit));
+    vst1q_u8(dst + i,
+             vbslq_u8(still, vld1q_u8(woven + i), vrhaddq_u8(up, down)));
+  }
+#endif
+  for (; i < count; i++)
+    dst[i] = selectStatic<uint8_t>(woven[i], above[i], below[i],
+                                   previousAbove[i], previousBelow[i],
+                                   threshold);
+}
+
+void selectStaticWords(uint16_t *dst, const uint16_t *woven,
+                       const uint16_t *above, const uint16_t *below,
+                       const uint16_t *previousAbove,
+                       const uint16_t *previousBelow, uint16_t threshold,
+                       size_t count) {
+  size_t i = 0;
+#if defined(GRANDI_SIMD_SSE2)
+  const __m128i limit = _mm_set1_epi16((short)threshold);
+  const __m128i zero = _mm_setzero_si128();
+  for (; i + 8 <= count; i += 8) {
+    __m128i up = _mm_loadu_si128((const __m128i *)(above + i));
+    __m128i down = _mm_loadu_si128((const __m128i *)(below + i));
+    __m128i lastUp = _mm_loadu_si128((const __m128i *)(previousAbove + i));
+    __m128i lastDown = _mm_loadu_si128((const __m128i *)(previousBelow + i));
+    __m128i upMotion =
+        _mm_or_si128(_mm_subs_epu16(up, lastUp), _mm_subs_epu16(lastUp, up));
+    __m128i downMotion = _mm_or_si128(_mm_subs_epu16(down, lastDown),
+                                      _mm_subs_epu16(lastDown, down));
+    __m128i still =
+        _mm_and_si128(_mm_cmpeq_epi16(_mm_subs_epu16(upMotion, limit), zero),
+                      _mm_cmpeq_epi16(_mm_subs_epu16(downMotion, limit), zero));
+    __m128i weave = _mm_loadu_si128((const __m128i *)(woven + i));
+    __m128i bob = _mm_avg_epu16(up, down);
+    _mm_storeu_si128((__m128i *)(dst + i),
+                     _mm_or_si128(_mm_and_si128(still, weave),
+                                  _mm_andnot_si128(still, bob)));
+  }
+#elif defined(GRANDI_SIMD_NEON)
+  const uint16x8_t limit = vdupq_n_u16(threshold);
+  for (; i + 8 <= count; i += 8) {
+    uint16x8_t up = vld1q_u16(above + i);
+    uint16x8_t down = vld1q_u16(below + i);
+    uint16x8_t still = vandq_u16(
+        vcleq_u16(vabdq_u16(up, vld1q_u16(previousAbove + i)), limit),
+        vcleq_u16(vabdq_u16(down, vld1q_u16(previousBelow + i)), limit));
+    vst1q_u16(dst + i,
+              vbslq_u16(still, vld1q_u16(woven + i), vrhaddq_u16(up, down)));
+  }
+#endif
+  for (; i < count; i++)
+    dst[i] = selectStatic<uint16_t>(woven[i], above[i], below[i],
+                                    previousAbove[i], previousBelow[i],
+                                    threshold);
+}
+
+namespace {
+// x / 255 rounded to nearest, for x up to 255 * 255.
+inline uint32_t divide255(uint32_t x) { return ((x + 128) * 257) >> 16; }
+
+inline uint8_t keySample(uint8_t under, uint8_t over, uint32_t alpha,
+                         uint32_t bias) {
+  uint32_t inverse = 255 - alpha;
+  int value = over + (int)divide255(under * inverse) -
+              (int)divide255(bias * inverse);
+  return (uint8_t)(value < 0 ? 0 : value > 255 ? 255 : value);
+}
+
+#if defined(GRANDI_SIMD_SSE2)
+inline __m128i divide255(__m128i x) {
+  return _mm_mulhi_epu16(_mm_add_epi16(x, _mm_set1_epi16(128)),
+                         _mm_set1_epi16(257));
+}
+
+// Eight samples widened to 16 bits; the result is packed with saturation.
+inline __m128i keyWords(__m128i under, __m128i over, __m128i alpha,
+                        __m128i bias) {
+  __m128i inverse = _mm_sub_epi16(_mm_set1_epi16(255), alpha);
+  return _mm_sub_epi16(
+      _mm_add_epi16(over, divide255(_mm_mullo_epi16(under, inverse))),
+      divide255(_mm_mullo_epi16(bias, inverse)));
+}
+#elif defined(GRANDI_SIMD_NEON)
+inline uint16x8_t divide255(uint16x8_t x) {
+  uint16x8_t rounded = vaddq_u16(x, vdupq_n_u16(128));
+  return vshrq_n_u16(vsraq_n_u16(rounded, rounded, 8), 8);
+}
+
+inline uint8x8_t keyWords(uint8x8_t under, uint8x8_t over, uint8x8_t alpha,
+                          uint16x8_t bias) {
+  uint16x8_t inverse = vsubl_u8(vdup_n_u8(255), alpha);
+  uint16x8_t keyed = vaddq_u16(
+      vmovl_u8(over), divide255(vmulq_u16(vmovl_u8(under), inverse)));
+  return vqmovun_s16(
+      vsubq_s16(vreinterpretq_s16_u16(keyed),
+                vreinterpretq_s16_u16(divide255(vmulq_u16(bias, inverse)))));
+}
+#endif
+} // namespace
+
+void compositeUyvy(uint8_t *dst, const uint8_t *under, const uint8_t *over,
+                   const uint8_t *alpha, size_t pixels) {
+  size_t p = 0;
+#if defined(GRANDI_SIMD_SSE2)
+  const __m128i zero = _mm_setzero_si128();
+  // Chroma then luma bias in each 32-bit lane of UYVY bytes.
+  const __m128i bias = _mm_set1_epi32(0x00100080);
+  for (; p + 8 <= pixels; p += 8) {
+    __m128i a = _mm_unpacklo_epi8(
+        _mm_loadl_epi64((const __m128i *)(alpha + p)), zero);
+    // Pair averages in the even lanes, then repeated for U and V.
+    __m128i pair = _mm_avg_epu16(a, _mm_srli_epi32(a, 16));
+    pair = _mm_shufflehi_epi16(_mm_shufflelo_epi16(pair, 0xA0), 0xA0);
+    __m128i u = _mm_loadu_si128((const __m128i *)(under + p * 2));
+    __m128i o = _mm_loadu_si128((const __m128i *)(over + p * 2));
+    __m128i low = keyWords(_mm_unpacklo_epi8(u, zero),
+                           _mm_unpacklo_epi8(o, zero),
+                           _mm_unpacklo_epi16(pair, a), bias);
+    __m128i high = keyWords(_mm_unpackhi_epi8(u, zero),
+                            _mm_unpackhi_epi8(o, zero),
+                            _mm_unpackhi_epi16(pair, a), bias);
+    _mm_storeu_si128((__m128i *)(dst + p * 2), _mm_packus_epi16(low, high));
+  }
+#elif defined(GRANDI_SIMD_NEON)
+  const uint16x8_t chromaBias = vdupq_n_u16(128);
+  const uint16x8_t lumaBias = vdupq_n_u16(16);
+  for (; p + 16 <= pixels; p += 16) {
+    uint8x8x2_t a = vld2_u8(alpha + p);
+    uint8x8_t pair = vrhadd_u8(a.val[0], a.val[1]);
+    uint8x8x4_t u = vld4_u8(under + p * 2);
+    uint8x8x4_t o = vld4_u8(over + p * 2);
+    uint8x8x4_t keyed;
+    keyed.val[0] = keyWords(u.val[0], o.val[0], pair, chromaBias);
+    keyed.val[1] = keyWords(u.val[1], o.val[1], a.val[0], lumaBias);
+    keyed.val[2] = keyWords(u.val[2], o.val[2], pair, chromaBias);
+    keyed.val[3] = keyWords(u.val[3], o.val[3], a.val[1], lumaBias);
+    vst4_u8(dst + p * 2, keyed);
+  }
+#endif
+  for (; p + 2 <= pixels; p += 2) {
+    uint32_t pair = (alpha[p] + alpha[p + 1] + 1) >> 1;
+    const uint8_t *u = under + p * 2;
+    const uint8_t *o = over + p * 2;
+    uint8_t *out = dst + p * 2;
+    out[0] = keySample(u[0], o[0], pair, 128);
+    out[1] = keySample(u[1], o[1], alpha[p], 16);
+    out[2] = keySample(u[2], o[2], pair, 128);
+    out[3] = keySample(u[3], o[3], alpha[p + 1], 16);
+  }
+}
+
+void compositeRgba(uint8_t *dst, const uint8_t *under, const uint8_t *over,
+                   size_t pixels) {
+  size_t p = 0;
+#if defined(GRANDI_SIMD_SSE2)
+  const __m128i zero = _mm_setzero_si128();
+  for (; p + 4 <= pixels; p += 4) {
+    __m128i u = _mm_loadu_si128((const __m128i *)(under + p * 4));
+    __m128i o = _mm_loadu_si128((const __m128i *)(over + p * 4));
+    __m128i overLow = _mm_unpacklo_epi8(o, zero);
+    __m128i overHigh = _mm_unpackhi_epi8(o, zero);
+    // Each pixel's alpha repeated across its four lanes.
+    __m128i alphaLow =
+        _mm_shufflehi_epi16(_mm_shufflelo_epi16(overLow, 0xFF), 0xFF);
+    __m128i alphaHigh =
+        _mm_shufflehi_epi16(_mm_shufflelo_epi16(overHigh, 0xFF), 0xFF);
+    __m128i low =
+        keyWords(_mm_unpacklo_epi8(u, zero), overLow, alphaLow, zero);
+    __m128i high =
+        keyWords(_mm_unpackhi_epi8(u, zero), overHigh, alphaHigh, zero);
+    _mm_storeu_si128((__m128i *)(dst + p * 4), _mm_packus_epi16(low, high));
+  }
+#elif defined(GRANDI_SIMD_NEON)
+  const uint16x8_t zero = vdupq_n_u16(0);
+  for (; p + 8 <= pixels; p += 8) {
+    uint8x8x4_t u = vld4_u8(under + p * 4);
+    uint8x8x4_t o = vld4_u8(over + p * 4);
+    uint8x8x4_t keyed;
+    for (int channel = 0; channel < 4; channel++)
+      keyed.val[channel] =
+          keyWords(u.val[channel], o.val[channel], o.val[3], zero);
+    vst4_u8(dst + p * 4, keyed);
+  }
+#endif
+  for (; p < pixels; p++) {
+    const uint8_t *u = under + p * 4;
+    const uint8_t *o = over + p * 4;
+    uint8_t *out = dst + p * 4;
+    uint32_t a = o[3];
+    for (int channel = 0; channel < 4; channel++)
+      out[channel] = keySample(u[channel], o[channel], a, 0);
+  }
+}
+
+void compositeAlpha(uint8_t *dst, const uint8_t *under, const uint8_t *over,
+                    size_t count) {
+  size_t i = 0;
+#if defined(GRANDI_SIMD_SSE2)
+  const __m128i zero = _mm_setzero_si128();
+  for (; i + 16 <= count; i += 16) {
+    __m128i u = _mm_loadu_si128((const __m128i *)(under + i));
+    __m128i o = _mm_loadu_si128((const __m128i *)(over + i));
+    __m128i overLow = _mm_unpacklo_epi8(o, zero);
+    __m128i overHigh = _mm_unpackhi_epi8(o, zero);
+    __m128i low =
+        keyWords(_mm_unpacklo_epi8(u, zero), overLow, overLow, zero);
+    __m128i high =
+        keyWords(_mm_unpackhi_epi8(u, zero), overHigh, overHigh, zero);
+    _mm_storeu_si128((__m128i *)(dst + i), _mm_packus_epi16(low, high));
+  }
+#elif defined(GRANDI_SIMD_NEON)
+  const uint16x8_t zero = vdupq_n_u16(0);
+  for (; i + 8 <= count; i += 8) {
+    uint8x8_t o = vld1_u8(over + i);
+    vst1_u8(dst + i, keyWords(vld1_u8(under + i), o, o, zero));
+  }
+#endif
+  for (; i < count; i++)
+    dst[i] = keySample(under[i], over[i], over[i], 0);
+}
+
+void accumulateCounts(uint32_t *dst, const uint32_t *src, size_t count) {
+  size_t i = 0;
+#if defined(GRANDI_SIMD_SSE2)
+  for (; i + 4 <= count; i += 4) {
+    __m128i sum = _mm_add_epi32(_mm_loadu_si128((const __m128i *)(dst + i)),
+                                _mm_loadu_si128((const __m128i *)(src + i)));
+    _mm_storeu_si128((__m128i *)(dst + i), sum);
+  }
+#elif defined(GRANDI_SIMD_NEON)
+  for (; i + 4 <= count; i += 4)
+    vst1q_u32(dst + i, vaddq_u32(vld1q_u32(dst + i), vld1q_u32(src + i)));
+#endif
+  for (; i < count; i++)
+    dst[i] += src[i];
+}
+
+uint32_t maxCount(const uint32_t *counts, size_t count) {
+  size_t i = 0;
+  uint32_t result = 0;
+#if defined(GRANDI_SIMD_SSE2)
+  // SSE2 only compares signed lanes, so counts are biased into signed range.
+  const __m128i bias = _mm_set1_epi32((int)0x80000000u);
+  __m128i best = bias;
+  for (; i + 4 <= count; i += 4) {
+    __m128i value = _mm_xor_si128(
+        _mm_loadu_si128((const __m128i *)(counts + i)), bias);
+    __m128i greater = _mm_cmpgt_epi32(value, best);
+    best = _mm_or_si128(_mm_and_si128(greater, value),
+                        _mm_andnot_si128(greater, best));
+  }
+  uint32_t lanes[4];
+  _mm_storeu_si128((__m128i *)lanes, _mm_xor_si128(best, bias));
+  for (int lane = 0; lane < 4; lane++)
+    if (lanes[lane] > result)
+      result = lanes[lane];
+#elif defined(GRANDI_SIMD_NEON)
+  uint32x4_t best = vdupq_n_u32(0);
+  for (; i + 4 <= count; i += 4)
+    best = vmaxq_u32(best, vld1q_u32(counts + i));
+  uint32_t lanes[4];
+  vst1q_u32(lanes, best);
+  for (int lane = 0; lane < 4; lane++)
+    if (lanes[lane] > result)
+      result = lanes[lane];
+#endif
+  for (; i < count; i++)
+    if (counts[i] > result)
+      result = counts[i];
+  return result;
+}
+
+uint64_t squaredErrorBytes(const uint8_t *a, const uint8_t *b, size_t count) {
+  size_t i = 0;
+  uint64_t result = 0;
+#if defined(GRANDI_SIMD_SSE2) || defined(GRANDI_SIMD_NEON)
+  // Each 32-bit lane gains at most 4 * 255^2 per 16 bytes, so lanes are
+  // flushed to the 64-bit total before they could wrap.
+  const size_t kFlush = 4096 * 16;
+#endif
+#if defined(GRANDI_SIMD_SSE2)
+  const __m128i zero = _mm_setzero_si128();
+  while (i + 16 <= count) {
+    size_t end = count - i > kFlush ? i + kFlush : count;
+    __m128i sum = zero;
+    for (; i + 16 <= end; i += 16) {
+      __m128i left = _mm_loadu_si128((const __m128i *)(a + i));
+      __m128i right = _mm_loadu_si128((const __m128i *)(b + i));
+      __m128i low = _mm_sub_epi16(_mm_unpacklo_epi8(left, zero),
+                                  _mm_unpacklo_epi8(right, zero));
+      __m128i high = _mm_sub_epi16(_mm_unpackhi_epi8(left, zero),
+                                   _mm_unpackhi_epi8(right, zero));
+      sum = _mm_add_epi32(sum, _mm_madd_epi16(low, low));
+      sum = _mm_add_epi32(sum, _mm_madd_epi16(high, high));
+    }
+    uint32_t lanes[4];
+    _mm_storeu_si128((__m128i *)lanes, sum);
+    result += (uint64_t)lanes[0] + lanes[1] + lanes[2] + lanes[3];
+  }
+#elif defined(GRANDI_SIMD_NEON)
+  while (i + 16 <= count) {
+    size_t end = count - i > kFlush ? i + kFlush : count;
+    uint32x4_t sum = vdupq_n_u32(0);
+    for (; i + 16 <= end; i += 16) {
+      uint8x16_t diff = vabdq_u8(vld1q_u8(a + i), vld1q_u8(b + i));
+      uint8x8_t low = vget_low_u8(diff), high = vget_high_u8(diff);
+      sum = vpadalq_u16(sum, vmull_u8(low, low));
+      sum = vpadalq_u16(sum, vmull_u8(high, high));
+    }
+    uint32_t lanes[4];
+    vst1q_u32(lanes, sum);
+    result += (uint64_t)lanes[0] + lanes[1] + lanes[2] + lanes[3];
+  }
+#endif
+  for (; i < count; i++) {
+    int diff = (int)a[i] - b[i];
+    result += (uint64_t)(diff * diff);
+  }
+  return result;
+}
+
+uint64_t squaredErrorWords(const uint16_t *a, const uint16_t *b,
+                           size_t count) {
+  size_t i = 0;
+  uint64_t result = 0;
+#if defined(GRANDI_SIMD_SSE2)
+  // Squares of 16-bit differences fill 32 bits, so they are summed in 64-bit
+  // lanes.
+  const __m128i zero = _mm_setzero_si128();
+  __m128i sum = zero;
+  for (; i + 8 <= count; i += 8) {
+    __m128i left = _mm_loadu_si128((const __m128i *)(a + i));
+    __m128i right = _mm_loadu_si128((const __m128i *)(b + i));
+    __m128i diff = _mm_or_si128(_mm_subs_epu16(left, right),
+                                _mm_subs_epu16(right, left));
+    __m128i productLow = _mm_mullo_epi16(diff, diff);
+    __m128i productHigh = _mm_mulhi_epu16(diff, diff);
+    __m128i first = _mm_unpacklo_epi16(productLow, productHigh);
+    __m128i second = _mm_unpackhi_epi16(productLow, productHigh);
+    sum = _mm_add_epi64(sum, _mm_unpacklo_epi32(first, zero));
+    sum = _mm_add_epi64(sum, _mm_unpackhi_epi32(first, zero));
+    sum = _mm_add_epi64(sum, _mm_unpacklo_epi32(second, zero));
+    sum = _mm_add_epi64(sum, _mm_unpackhi_epi32(second, zero));
+  }
+  uint64_t lanes[2];
+  _mm_storeu_si128((__m128i *)lanes, sum);
+  result = lanes[0] + lanes[1];
+#elif defined(GRANDI_SIMD_NEON)
+  uint64x2_t sum = vdupq_n_u64(0);
+  for (; i + 8 <= count; i += 8) {
+    uint16x8_t diff = vabdq_u16(vld1q_u16(a + i), vld1q_u16(b + i));
+    uint16x4_t low = vget_low_u16(diff), high = vget_high_u16(diff);
+    sum = vpadalq_u32(sum, vmull_u16(low, low));
+    sum = vpadalq_u32(sum, vmull_u16(high, high));
+  }
+  uint64_t lanes[2];
+  vst1q_u64(lanes, sum);
+  result = lanes[0] + lanes[1];
+#endif
+  for (; i < count; i++) {
+    int64_t diff = (int64_t)a[i] - b[i];
+    result += (uint64_t)(diff * diff);
+  }
+  return result;
+}
+
+uint64_t absoluteDifferenceBytes(const uint8_t *a, const uint8_t *b,
+                                 size_t count) {
+  size_t i = 0;
+  uint64_t result = 0;
+#if defined(GRANDI_SIMD_SSE2)
+  // psadbw sums each half of the 16 differences into a 64-bit lane.
+  __m128i sum = _mm_setzero_si128();
+  for (; i + 16 <= count; i += 16) {
+    __m128i left = _mm_loadu_si128((const __m128i *)(a + i));
+    __m128i right = _mm_loadu_si128((const __m128i *)(b + i));
+    sum = _mm_add_epi64(sum, _mm_sad_epu8(left, right));
+  }
+  uint64_t lanes[2];
+  _mm_storeu_si128((__m128i *)lanes, sum);
+  result = lanes[0] + lanes[1];
+#elif defined(GRANDI_SIMD_NEON)
+  // Each 32-bit lane gains at most 4 * 255 per 16 bytes, so lanes are
+  // flushed to the 64-bit total long before they could wrap.
+  const size_t kFlush = 65536 * 16;
+  while (i + 16 <= count) {
+    size_t end = count - i > kFlush ? i + kFlush : count;
+    uint32x4_t sum = vdupq_n_u32(0);
+    for (; i + 16 <= end; i += 16)
+      sum = vpadalq_u16(sum,
+                        vpaddlq_u8(vabdq_u8(vld1q_u8(a + i), vld1q_u8(b + i))));
+    uint32_t lanes[4];
+    vst1q_u32(lanes, sum);
+    result += (uint64_t)lanes[0] + lanes[1] + lanes[2] + lanes[3];
+  }
+#endif
+  for (; i < count; i++)
+    result += (uint64_t)(a[i] > b[i] ? a[i] - b[i] : b[i] - a[i]);
+  return result;
+}
+
+void ssimBlockSums(const uint8_t *a, const uint8_t *b, size_t stride,
+                   size_t blocks, uint32_t (*sums)[4]) {
+  size_t block = 0;
+#if defined(GRANDI_SIMD_SSE2) || defined(GRANDI_SIMD_NEON)
+  // Two blocks per pass: eight samples of each of four lines. The 32-bit
+  // lanes hold pixel pairs, so lanes 0-1 belong to the first block and lanes
+  // 2-3 to the second.
+  for (; block + 2 <= blocks; block += 2) {
+    uint32_t s1[4], s2[4], ss[4], s12[4];
+#if defined(GRANDI_SIMD_SSE2)
+    const __m128i zero = _mm_setzero_si128();
+    __m128i sumA = zero, sumB = zero, squares = zero, products = zero;
+    for (int line = 0; line < 4; line++) {
+      const uint8_t *lineA = a + line * stride + block * 4;
+      const uint8_t *lineB = b + line * stride + block * 4;
+      __m128i left =
+          _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)lineA), zero);
+      __m128i right =
+          _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)lineB), zero);
+      sumA = _mm_add_epi16(sumA, left);
+      sumB = _mm_add_epi16(sumB, right);
+      squares = _mm_add_epi32(squares, _mm_madd_epi16(left, left));
+      squares = _mm_add_epi32(squares, _mm_madd_epi16(right, right));
+      products = _mm_add_epi32(products, _mm_madd_epi16(left, right));
+    }
+    const __m128i ones = _mm_set1_epi16(1);
+    _mm_storeu_si128((__m128i *)s1, _mm_madd_epi16(sumA, ones));
+    _mm_storeu_si128((__m128i *)s2, _mm_madd_epi16(sumB, ones));
+    _mm_storeu_si128((__m128i *)ss, squares);
+    _mm_storeu_si128((__m128i *)s12, products);
+#else
+    uint16x8_t sumA = vdupq_n_u16(0), sumB = vdupq_n_u16(0);
+    uint32x4_t squares = vdupq_n_u32(0), products = vdupq_n_u32(0);
+    for (int line = 0; line < 4; line++) {
+      uint8x8_t left = vld1_u8(a + line * stride + block * 4);
+      uint8x8_t right = vld1_u8(b + line * stride + block * 4);
+      sumA = vaddw_u8(sumA, left);
+      sumB = vaddw_u8(sumB, right);
+      squares = vpadalq_u16(squares, vmull_u8(left, left));
+      squares = vpadalq_u16(squares, vmull_u8(right, right));
+      products = vpadalq_u16(products, vmull_u8(left, right));
+    }
+    vst1q_u32(s1, vpaddlq_u16(sumA));
+    vst1q_u32(s2, vpaddlq_u16(sumB));
+    vst1q_u32(ss, squares);
+    vst1q_u32(s12, products);
+#endif
+    for (int half = 0; half < 2; half++) {
+      uint32_t *out = sums[block + half];
+      out[0] = s1[half * 2] + s1[half * 2 + 1];
+      out[1] = s2[half * 2] + s2[half * 2 + 1];
+      out[2] = ss[half * 2] + ss[half * 2 + 1];
+      out[3] = s12[half * 2] + s12[half * 2 + 1];
+    }
+  }
+#endif
+  for (; block < blocks; block++) {
+    uint32_t *out = sums[block];
+    out[0] = out[1] = out[2] = out[3] = 0;
+    for (int line = 0; line < 4; line++)
+      for (int x = 0; x < 4; x++) {
+        uint32_t left = a[line * stride + block * 4 + x];
+        uint32_t right = b[line * stride + block * 4 + x];
+        out[0] += left;
+        out[1] += right;
+        out[2] += left * left + right * right;
+        out[3] += left * right;
+      }
+  }
+}
@@ -0,0 +1,90 @@
+/* Copyright 2025 Sarhan Aissi <github@tux.tn>.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+*/
+
+#ifndef GRANDI_SIMD_H
+#define GRANDI_SIMD_H
+
+#include <cstddef>
+#include <cstdint>
+
+// memcpy through non-temporal stores, which write around the caches so a
+// large copy does not evict the data other stages are working on. Uses
+// SSE2 streaming stores on x86 and STNP on 64-bit ARM with GCC or Clang,
+// and memcpy elsewhere. Ends with a store fence, so the copy is visible to
+// other threads once they synchronize with the caller.
+void streamBytes(uint8_t *dst, const uint8_t *src, size_t count);
+// Whether streamBytes uses non-temporal stores on this build.
+bool streamingStores();
+
+// Rounded averages, (a + b + 1) / 2 per element. Uses SSE2 on x86 and NEON
+// on ARM, with a scalar fallback elsewhere. dst may alias a or b.
+void averageBytes(uint8_t *dst, const uint8_t *a, const uint8_t *b,
+                  size_t count);
+void averageWords(uint16_t *dst, const uint16_t *a, const uint16_t *b,
+                  size_t count);
+
+// Weighted blend, (a * (256 - weight) + b * weight + 128) / 256 per element,
+// with weight in [0, 256]. dst may alias a or b.
+void blendBytes(uint8_t *dst, const uint8_t *a, const uint8_t *b,
+                uint32_t weight, size_t count);
+
+// Motion-adaptive line reconstruction. Each element takes `woven` when both
+// `above` and `below` changed by at most `threshold` since the previous field
+// of the same parity, and the rounded average of `above` and `below`
+// otherwise.
+void selectStaticBytes(uint8_t *dst, const uint8_t *woven, const uint8_t *above,
+                       const uint8_t *below, const uint8_t *previousAbove,
+                       const uint8_t *previousBelow, uint8_t threshold,
+                       size_t count);
+void selectStaticWords(uint16_t *dst, const uint16_t *woven,
+                       const uint16_t *above, const uint16_t *below,
+                       const uint16_t *previousAbove,
+                       const uint16_t *previousBelow, uint16_t threshold,
+                       size_t count);
+
+// Premultiplied-alpha "over" compositing, rounded per 8-bit sample:
+// dst = over + (under - bias) * (255 - alpha) / 255, where bias is the value
+// a fully transparent overlay sample holds. dst may alias under.
+//
+// compositeUyvy keys UYVY samples with one alpha byte per pixel. Each pixel
+// pair's shared chroma uses the pair's average alpha; bias is 128 for chroma
+// and 16 for luma. pixels must be even.
+void compositeUyvy(uint8_t *dst, const uint8_t *under, const uint8_t *over,
+                   const uint8_t *alpha, size_t pixels);
+// 32-bit pixels with alpha in the last byte (BGRA or RGBA), bias 0. The alpha
+// channel composites like the others.
+void compositeRgba(uint8_t *dst, const uint8_t *under, const uint8_t *over,
+                   size_t pixels);
+// Alpha planes, where each overlay sample is its own alpha, bias 0.
+void compositeAlpha(uint8_t *dst, const uint8_t *under, const uint8_t *over,
+                    size_t count);
+
+// Scope bins: dst[i] += src[i] with wrapping, and the largest count.
+void accumulateCounts(uint32_t *dst, const uint32_t *src, size_t count);
+uint32_t maxCount(const uint32_t *counts, size_t count);
+
+// Frame comparison: the sum of (a[i] - b[i])^2.
+uint64_t squaredErrorBytes(const uint8_t *a, const uint8_t *b, size_t count);
+uint64_t squaredErrorWords(const uint16_t *a, const uint16_t *b, size_t count);
+// Motion detection: the sum of |a[i] - b[i]|.
+uint64_t absoluteDifferenceBytes(const uint8_t *a, const uint8_t *b,
+                                 size_t count);
+// SSIM statistics of `blocks` adjacent 4x4 blocks of 8-bit planes whose lines
+// are stride bytes apart: per block, the sums of a, of b, of a^2 + b^2, and
+// of a * b.
+void ssimBlockSums(const uint8_t *a, const uint8_t *b, size_t stride,
+                   size_t blocks, uint32_t (*sums)[4]);
+
+#endif /* GRANDI_SIMD_H */
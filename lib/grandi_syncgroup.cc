@@ -0,0 +1,736 @@
+/* Copyright 2025 Sarhan Aissi <github@tux.tn>.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <Processing.NDI.Lib.h>
+
+#include "grandi_syncgroup.h"
+#include "grandi_budget.h"
+#include "grandi_clock.h"
+#include "grandi_receive.h"
+#include "grandi_thread.h"
+#include "grandi_util.h"
+
+namespace {
+// Frames held per member while waiting for the rest of the group.
+const size_t kMaxMemberFrames = 32;
+// Sets queued for the JavaScript callback before new sets are dropped.
+const size_t kMaxPendingSets = 8;
+// Upper bound on a single capture wait so stop requests are seen promptly.
+const uint32_t kMaxCaptureWaitMs = 50;
+
+struct syncGroupFrame {
+  NDIlib_video_frame_v2_t frame{};
+  ownedBuffer buffer;
+  std::string metadata;
+  bool hasMetadata = false;
+  int64_t key = 0;
+  std::chrono::steady_clock::time_point arrival;
+};
+
+struct syncGroupSet {
+  std::vector<std::unique_ptr<syncGroupFrame>> frames;
+  double alignmentErrorMs = 0.0;
+};
+
+struct syncGroupMember {
+  nativeHandle *recvHandle = nullptr;
+  NDIlib_recv_instance_t recv = nullptr;
+  std::string sourceName;
+  napi_ref receiverRef = nullptr;
+  threadRole role;
+  std::thread thread;
+  std::deque<std::unique_ptr<syncGroupFrame>> frames;
+  uint64_t capturedFrames = 0;
+  uint64_t droppedFrames = 0;
+  size_t peakBufferedFrames = 0;
+};
+
+struct syncGroupWrapper {
+  napi_env env = nullptr;
+  napi_threadsafe_function callback = nullptr;
+  std::vector<std::unique_ptr<syncGroupMember>> members;
+  int64_t tolerance = 0; // NDI 100 ns units
+  std::chrono::milliseconds bufferTime{100};
+  uint32_t captureWaitMs = kMaxCaptureWaitMs;
+  bool stopping = false;
+  bool externalFinalized = false;
+  bool callbackFinalized = false;
+  uint64_t completeSets = 0;
+  uint64_t partialSets = 0;
+  uint64_t droppedSets = 0;
+  uint64_t alignedSets = 0;
+  double alignmentErrorSumMs = 0.0;
+  double alignmentErrorMaxMs = 0.0;
+  double alignmentErrorLastMs = 0.0;
+  std::mutex mutex;
+};
+
+struct syncGroupCarrier : carrier {
+  syncGroupWrapper *group = nullptr;
+  ~syncGroupCarrier();
+};
+
+int64_t syncGroupFrameKey(const NDIlib_video_frame_v2_t &frame) {
+  return frame.timestamp != NDIlib_recv_timestamp_undefined ? frame.timestamp
+                                                            : frame.timecode;
+}
+
+std::unique_ptr<syncGroupFrame>
+copySyncGroupFrame(const NDIlib_video_frame_v2_t &videoFrame) {
+  size_t videoBytes = videoDataSize(videoFrame);
+  // A frame over the frame budget counts as dropped, like a failed copy. The
+  // reservation is released on return, once the copy is allocated.
+  budgetReservation reservation;
+  if (admitFrameBytes(videoBytes, false, &reservation) == budgetDecision::drop)
+    return nullptr;
+  std::unique_ptr<syncGroupFrame> pending(new (std::nothrow) syncGroupFrame);
+  if (pending == nullptr)
+    return nullptr;
+  if (videoFrame.p_data == nullptr || videoBytes == 0 ||
+      !pending->buffer.copyFrom(videoFrame.p_data, videoBytes))
+    return nullptr;
+  pending->frame = videoFrame;
+  pending->frame.p_data = nullptr;
+  pending->frame.p_metadata = nullptr;
+  if (videoFrame.p_metadata != nullptr) {
+    pending->metadata = videoFrame.p_metadata;
+    pending->hasMetadata = true;
+  }
+  pending->key = syncGroupFrameKey(videoFrame);
+  return pending;
+}
+
+// Called with the group mutex held.
+void emitSyncGroupSet(syncGroupWrapper *group,
+                      std::unique_ptr<syncGroupSet> set, size_t present) {
+  double alignmentErrorMs = set->alignmentErrorMs;
+  napi_status status = napi_call_threadsafe_function(
+      group->callback, set.get(), napi_tsfn_nonblocking);
+  if (status != napi_ok) {
+    group->droppedSets++;
+    return;
+  }
+  set.release();
+  if (present == group->members.size())
+    group->completeSets++;
+  else
+    group->partialSets++;
+  if (present > 1) {
+    group->alignedSets++;
+    group->alignmentErrorSumMs += alignmentErrorMs;
+    group->alignmentErrorMaxMs =
+        std::max(group->alignmentErrorMaxMs, alignmentErrorMs);
+    group->alignmentErrorLastMs = alignmentErrorMs;
+  }
+}
+
+// Called with the group mutex held. Each pass takes the oldest buffered frame
+// and gathers every member whose oldest frame lies within tolerance of it.
+// A member whose oldest frame is later has nothing for that instant, while an
+// empty member may still deliver one, so the set waits for up to the buffer
+// time before it is emitted as a partial set.
+void matchSyncGroup(syncGroupWrapper *group,
+                    std::chrono::steady_clock::time_point now) {
+  size_t count = group->members.size();
+  while (true) {
+    syncGroupFrame *oldest = nullptr;
+    for (auto &member : group->members) {
+      if (member->frames.empty())
+        continue;
+      syncGroupFrame *head = member->frames.front().get();
+      if (oldest == nullptr || head->key < oldest->key)
+        oldest = head;
+    }
+    if (oldest == nullptr)
+      return;
+
+    int64_t base = oldest->key;
+    size_t present = 0;
+    bool waiting = false;
+    for (auto &member : group->members) {
+      if (member->frames.empty())
+        waiting = true;
+      else if (member->frames.front()->key - base <= group->tolerance)
+        present++;
+    }
+    if (present < count && waiting && now - oldest->arrival < group->bufferTime)
+      return;
+
+    std::unique_ptr<syncGroupSet> set(new (std::nothrow) syncGroupSet);
+    int64_t latest = base;
+    if (set != nullptr)
+      set->frames.resize(count);
+    for (size_t i = 0; i < count; i++) {
+      auto &frames = group->members[i]->frames;
+      if (frames.empty() || frames.front()->key - base > group->tolerance)
+        continue;
+      latest = std::max(latest, frames.front()->key);
+      if (set != nullptr)
+        set->frames[i] = std::move(frames.front());
+      frames.pop_front();
+    }
+    if (set == nullptr) {
+      group->droppedSets++;
+      continue;
+    }
+    set->alignmentErrorMs = (double)(latest - base) / 10000.0;
+    emitSyncGroupSet(group, std::move(set), present);
+  }
+}
+
+void captureSyncGroupMember(syncGroupWrapper *group, syncGroupMember *member) {
+  threadRegistration registration(member->role);
+  while (true) {
+    NDIlib_video_frame_v2_t videoFrame{};
+    NDIlib_frame_type_e frameType = NDIlib_recv_capture_v3(
+        member->recv, &videoFrame, nullptr, nullptr, group->captureWaitMs);
+    std::unique_ptr<syncGroupFrame> pending;
+    if (frameType == NDIlib_frame_type_video) {
+      if (videoFrame.timestamp != NDIlib_recv_timestamp_undefined)
+        observeClockSample(member->sourceName, videoFrame.timestamp,
+                           clockMonotonicNs());
+      pending = copySyncGroupFrame(videoFrame);
+      NDIlib_recv_free_video_v2(member->recv, &videoFrame);
+    }
+    auto now = std::chrono::steady_clock::now();
+
+    std::lock_guard<std::mutex> lock(group->mutex);
+    if (group->stopping)
+      return;
+    if (frameType == NDIlib_frame_type_video) {
+      member->capturedFrames++;
+      if (pending == nullptr) {
+        member->droppedFrames++;
+      } else {
+        pending->arrival = now;
+        member->frames.push_back(std::move(pending));
+        if (member->frames.size() > kMaxMemberFrames) {
+          member->frames.pop_front();
+          member->droppedFrames++;
+        }
+        member->peakBufferedFrames =
+            std::max(member->peakBufferedFrames, member->frames.size());
+      }
+    }
+    matchSyncGroup(group, now);
+  }
+}
+
+napi_status createSyncGroupSetObject(napi_env env, syncGroupSet *set,
+                                     napi_value *result) {
+  napi_status status = napi_create_object(env, result);
+  PASS_STATUS;
+
+  napi_value frames, missing, value;
+  status = napi_create_array_with_length(env, set->frames.size(), &frames);
+  PASS_STATUS;
+  status = napi_create_array(env, &missing);
+  PASS_STATUS;
+  uint32_t missingCount = 0;
+  for (size_t i = 0; i < set->frames.size(); i++) {
+    syncGroupFrame *frame = set->frames[i].get();
+    if (frame == nullptr) {
+      status = napi_get_null(env, &value);
+      PASS_STATUS;
+      napi_value index;
+      status = napi_create_uint32(env, (uint32_t)i, &index);
+      PASS_STATUS;
+      status = napi_set_element(env, missing, missingCount++, index);
+      PASS_STATUS;
+    } else {
+      status = createVideoFrameObject(
+          env, frame->frame,
+          frame->hasMetadata ? frame->metadata.c_str() : nullptr,
+          &frame->buffer, &value);
+      PASS_STATUS;
+    }
+    status = napi_set_element(env, frames, (uint32_t)i, value);
+    PASS_STATUS;
+  }
+  status = napi_set_named_property(env, *result, "frames", frames);
+  PASS_STATUS;
+  status = napi_set_named_property(env, *result, "missing", missing);
+  PASS_STATUS;
+
+  status = napi_get_boolean(env, missingCount == 0, &value);
+  PASS_STATUS;
+  status = napi_set_named_property(env, *result, "complete", value);
+  PASS_STATUS;
+
+  status = napi_create_double(env, set->alignmentErrorMs, &value);
+  PASS_STATUS;
+  return napi_set_named_property(env, *result, "alignmentErrorMs", value);
+}
+
+void deliverSyncGroupSet(napi_env env, napi_value callback, void *context,
+                         void *data) {
+  std::unique_ptr<syncGroupSet> set((syncGroupSet *)data);
+  // Sets still queued when the callback is torn down arrive without an env.
+  if (env == nullptr || callback == nullptr)
+    return;
+
+  napi_value result, recv;
+  napi_status status = createSyncGroupSetObject(env, set.get(), &result);
+  FLOATING_STATUS;
+  if (status != napi_ok)
+    return;
+  status = napi_get_undefined(env, &recv);
+  FLOATING_STATUS;
+  if (status != napi_ok)
+    return;
+  napi_call_function(env, recv, callback, 1, &result, nullptr);
+}
+
+// Stops the capture threads and releases receivers. Returns false when the
+// group had already been stopped.
+bool stopSyncGroup(napi_env env, syncGroupWrapper *group) {
+  napi_threadsafe_function callback = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(group->mutex);
+    if (group->stopping)
+      return false;
+    group->stopping = true;
+    callback = group->callback;
+  }
+  for (auto &member : group->members) {
+    if (member->thread.joinable())
+      member->thread.join();
+  }
+  for (auto &member : group->members) {
+    member->frames.clear();
+    if (member->recvHandle != nullptr)
+      releaseNativeCaptureBinding(member->recvHandle);
+    member->recvHandle = nullptr;
+    member->recv = nullptr;
+    if (member->receiverRef != nullptr)
+      napi_delete_reference(env, member->receiverRef);
+    member->receiverRef = nullptr;
+  }
+  if (callback != nullptr)
+    napi_release_threadsafe_function(callback, napi_tsfn_abort);
+  return true;
+}
+
+// The wrapper is shared by the JavaScript object and the thread-safe
+// callback, either of which may be finalized first during env teardown.
+void finalizeSyncGroup(napi_env env, void *data, void *hint) {
+  syncGroupWrapper *group = (syncGroupWrapper *)data;
+  stopSyncGroup(env, group);
+  bool deleteGroup = false;
+  {
+    std::lock_guard<std::mutex> lock(group->mutex);
+    group->externalFinalized = true;
+    deleteGroup = group->callback == nullptr || group->callbackFinalized;
+  }
+  if (deleteGroup)
+    delete group;
+}
+
+void finalizeSyncGroupCallback(napi_env env, void *data, void *hint) {
+  syncGroupWrapper *group = (syncGroupWrapper *)data;
+  {
+    std::lock_guard<std::mutex> lock(group->mutex);
+    group->callback = nullptr;
+    group->callbackFinalized = true;
+  }
+  stopSyncGroup(env, group);
+  bool deleteGroup = false;
+  {
+    std::lock_guard<std::mutex> lock(group->mutex);
+    deleteGroup = group->externalFinalized;
+  }
+  if (deleteGroup)
+    delete group;
+}
+
+syncGroupCarrier::~syncGroupCarrier() {
+  if (group != nullptr)
+    finalizeSyncGroup(group->env, group, nullptr);
+}
+
+bool acquireSyncGroupFromThis(napi_env env, napi_value thisValue,
+                              syncGroupWrapper **group) {
+  napi_value groupValue;
+  if (napi_get_named_property(env, thisValue, "embedded", &groupValue) !=
+      napi_ok)
+    return false;
+  napi_valuetype type;
+  if (napi_typeof(env, groupValue, &type) != napi_ok || type != napi_external)
+    return false;
+  void *externalData;
+  if (napi_get_value_external(env, groupValue, &externalData) != napi_ok)
+    return false;
+  *group = (syncGroupWrapper *)externalData;
+  return true;
+}
+
+napi_value destroySyncGroup(napi_env env, napi_callback_info info) {
+  bool success = false;
+  napi_value thisValue;
+  size_t argc = 0;
+  syncGroupWrapper *group = nullptr;
+  if (napi_get_cb_info(env, info, &argc, nullptr, &thisValue, nullptr) ==
+          napi_ok &&
+      acquireSyncGroupFromThis(env, thisValue, &group)) {
+    stopSyncGroup(env, group);
+    napi_value value;
+    if (napi_create_int32(env, 0, &value) == napi_ok)
+      napi_set_named_property(env, thisValue, "embedded", value);
+    success = true;
+  }
+
+  napi_value result;
+  if (napi_get_boolean(env, success, &result) != napi_ok)
+    napi_get_boolean(env, false, &result);
+  return result;
+}
+
+struct syncGroupMemberStats {
+  size_t bufferedFrames = 0;
+  size_t peakBufferedFrames = 0;
+  uint64_t capturedFrames = 0;
+  uint64_t droppedFrames = 0;
+};
+
+napi_value syncGroupStats(napi_env env, napi_callback_info info) {
+  napi_status status;
+
+  size_t argc = 0;
+  napi_value thisValue;
+  status = napi_get_cb_info(env, info, &argc, nullptr, &thisValue, nullptr);
+  CHECK_STATUS;
+
+  syncGroupWrapper *group = nullptr;
+  if (!acquireSyncGroupFromThis(env, thisValue, &group))
+    NAPI_THROW_ERROR("Sync group has been destroyed.");
+
+  std::vector<syncGroupMemberStats> members;
+  uint64_t completeSets, partialSets, droppedSets, alignedSets;
+  double errorSumMs, errorMaxMs, errorLastMs;
+  {
+    std::lock_guard<std::mutex> lock(group->mutex);
+    for (auto &member : group->members) {
+      syncGroupMemberStats stats;
+      stats.bufferedFrames = member->frames.size();
+      stats.peakBufferedFrames = member->peakBufferedFrames;
+      stats.capturedFrames = member->capturedFrames;
+      stats.droppedFrames = member->droppedFrames;
+      members.push_back(stats);
+    }
+    completeSets = group->completeSets;
+    partialSets = group->partialSets;
+    droppedSets = group->droppedSets;
+    alignedSets = group->alignedSets;
+    errorSumMs = group->alignmentErrorSumMs;
+    errorMaxMs = group->alignmentErrorMaxMs;
+    errorLastMs = group->alignmentErrorLastMs;
+  }
+
+  napi_value result, alignment, memberList, value;
+  status = napi_create_object(env, &result);
+  CHECK_STATUS;
+  status = napi_create_double(env, (double)completeSets, &value);
+  CHECK_STATUS;
+  status = napi_set_named_property(env, result, "completeSets", value);
+  CHECK_STATUS;
+  status = napi_create_double(env, (double)partialSets, &value);
+  CHECK_STATUS;
+  status = napi_set_named_property(env, result, "partialSets", value);
+  CHECK_STATUS;
+  status = napi_create_double(env, (double)droppedSets, &value);
+  CHECK_STATUS;
+  status = napi_set_named_property(env, result, "droppedSets", value);
+  CHECK_STATUS;
+
+  status = napi_create_object(env, &alignment);
+  CHECK_STATUS;
+  status = napi_create_double(
+      env, alignedSets > 0 ? errorSumMs / (double)alignedSets : 0.0, &value);
+  CHECK_STATUS;
+  status = napi_set_named_property(env, alignment, "mean", value);
+  CHECK_STATUS;
+  status = napi_create_double(env, errorMaxMs, &value);
+  CHECK_STATUS;
+  status = napi_set_named_property(env, alignment, "max", value);
+  CHECK_STATUS;
+  status = napi_create_double(env, errorLastMs, &value);
+  CHECK_STATUS;
+  status = napi_set_named_property(env, alignment, "last", value);
+  CHECK_STATUS;
+  status = napi_set_named_property(env, result, "alignmentErrorMs", alignment);
+  CHECK_STATUS;
+
+  status = napi_create_array_with_length(env, members.size(), &memberList);
+  CHECK_STATUS;
+  for (size_t i = 0; i < members.size(); i++) {
+    napi_value member;
+    status = napi_create_object(env, &member);
+    CHECK_STATUS;
+    status =
+        napi_create_uint32(env, (uint32_t)members[i].bufferedFrames, &value);
+    CHECK_STATUS;
+    status = napi_set_named_property(env, member, "bufferedFrames", value);
+    CHECK_STATUS;
+    status = napi_create_uint32(env, (uint32_t)members[i].peakBufferedFrames,
+                                &value);
+    CHECK_STATUS;
+    status = napi_set_named_property(env, member, "peakBufferedFrames", value);
+    CHECK_STATUS;
+    status = napi_create_double(env, (double)members[i].capturedFrames, &value);
+    CHECK_STATUS;
+    status = napi_set_named_property(env, member, "capturedFrames", value);
+    CHECK_STATUS;
+    status = napi_create_double(env, (double)members[i].droppedFrames, &value);
+    CHECK_STATUS;
+    status = napi_set_named_property(env, member, "droppedFrames", value);
+    CHECK_STATUS;
+    status = napi_set_element(env, memberList, (uint32_t)i, member);
+    CHECK_STATUS;
+  }
+  status = napi_set_named_property(env, result, "members", memberList);
+  CHECK_STATUS;
+
+  return result;
+}
+
+bool parseOptionalMilliseconds(napi_env env, napi_value options,
+                               const char *name, double *result, carrier *c) {
+  napi_value value;
+  c->status = napi_get_named_property(env, options, name, &value);
+  if (c->status != napi_ok)
+    return false;
+  napi_valuetype type;
+  c->status = napi_typeof(env, value, &type);
+  if (c->status != napi_ok)
+    return false;
+  if (type == napi_undefined)
+    return true;
+  double parsed = -1.0;
+  if (type == napi_number) {
+    c->status = napi_get_value_double(env, value, &parsed);
+    if (c->status != napi_ok)
+      return false;
+  }
+  if (!std::isfinite(parsed) || parsed < 0.0) {
+    c->status = GRANDI_INVALID_ARGS;
+    c->errorMsg = std::string(name) + " must be a non-negative number.";
+    return false;
+  }
+  *result = parsed;
+  return true;
+}
+
+bool bindSyncGroupMember(napi_env env, napi_value receiver,
+                         syncGroupCarrier *c) {
+  napi_valuetype type;
+  c->status = napi_typeof(env, receiver, &type);
+  if (c->status != napi_ok)
+    return false;
+  napi_value recvValue = nullptr;
+  if (type == napi_object) {
+    c->status = napi_get_named_property(env, receiver, "embedded", &recvValue);
+    if (c->status != napi_ok)
+      return false;
+    c->status = napi_typeof(env, recvValue, &type);
+    if (c->status != napi_ok)
+      return false;
+  }
+  if (type != napi_external) {
+    c->status = GRANDI_INVALID_ARGS;
+    c->errorMsg = "receivers must only contain initialized receivers.";
+    return false;
+  }
+
+  void *externalData;
+  c->status = napi_get_value_external(env, recvValue, &externalData);
+  if (c->status != napi_ok)
+    return false;
+  nativeHandle *recvHandle = (nativeHandle *)externalData;
+  void *recvData;
+  nativeCaptureStatus captureStatus =
+      bindNativeCaptureHandle(recvHandle, &recvData);
+  if (captureStatus != nativeCaptureStatus::success) {
+    c->status = GRANDI_INVALID_ARGS;
+    c->errorMsg = "Receiver has been destroyed.";
+    if (captureStatus == nativeCaptureStatus::bound)
+      c->errorMsg = "Receiver is already bound to a FrameSync or sync group.";
+    else if (captureStatus == nativeCaptureStatus::busy)
+      c->errorMsg = "Receiver has active capture operations.";
+    return false;
+  }
+
+  std::unique_ptr<syncGroupMember> member(new (std::nothrow) syncGroupMember);
+  if (member == nullptr) {
+    releaseNativeCaptureBinding(recvHandle);
+    c->status = GRANDI_ALLOCATION_FAILURE;
+    c->errorMsg = "Failed to allocate sync group member.";
+    return false;
+  }
+  member->recvHandle = recvHandle;
+  member->recv = ((receiveInstance *)recvData)->recv;
+  member->sourceName = ((receiveInstance *)recvData)->sourceName;
+  c->group->members.push_back(std::move(member));
+  c->status = napi_create_reference(env, receiver, 1,
+                                    &c->group->members.back()->receiverRef);
+  return c->status == napi_ok;
+}
+} // namespace
+
+napi_value syncGroup(napi_env env, napi_callback_info info) {
+  napi_valuetype type;
+  syncGroupCarrier *c = createCarrier<syncGroupCarrier>(env);
+  if (c == nullptr)
+    return nullptr;
+
+  napi_value promise;
+  c->status = napi_create_promise(env, &c->_deferred, &promise);
+  REJECT_RETURN;
+
+  size_t argc = 1;
+  napi_value args[1];
+  c->status = napi_get_cb_info(env, info, &argc, args, nullptr, nullptr);
+  REJECT_RETURN;
+
+  if (argc < 1)
+    REJECT_ERROR_RETURN("Sync group options must be provided.",
+                        GRANDI_INVALID_ARGS);
+  napi_value options = args[0];
+  c->status = napi_typeof(env, options, &type);
+  REJECT_RETURN;
+  bool isArray;
+  c->status = napi_is_array(env, options, &isArray);
+  REJECT_RETURN;
+  if (type != napi_object || isArray)
+    REJECT_ERROR_RETURN("Sync group options must be an object.",
+                        GRANDI_INVALID_ARGS);
+
+  c->group = new (std::nothrow) syncGroupWrapper;
+  if (c->group == nullptr)
+    REJECT_ERROR_RETURN("Failed to allocate sync group state.",
+                        GRANDI_ALLOCATION_FAILURE);
+  c->group->env = env;
+
+  double toleranceMs = 10.0;
+  if (!parseOptionalMilliseconds(env, options, "toleranceMs", &toleranceMs, c))
+    REJECT_RETURN;
+  double bufferMs = 100.0;
+  if (!parseOptionalMilliseconds(env, options, "bufferMs", &bufferMs, c))
+    REJECT_RETURN;
+  c->group->tolerance = (int64_t)std::llround(toleranceMs * 10000.0);
+  c->group->bufferTime = std::chrono::milliseconds(std::llround(bufferMs));
+  c->group->captureWaitMs = (uint32_t)std::min<double>(
+      std::max<double>(std::round(bufferMs), 1.0), kMaxCaptureWaitMs);
+  threadPlacement placement;
+  c->status = parseThreadPlacement(env, options, &placement, &c->errorMsg);
+  REJECT_RETURN;
+  if (!c->errorMsg.empty())
+    REJECT_ERROR_RETURN(c->errorMsg, GRANDI_INVALID_ARGS);
+
+  napi_value callback;
+  c->status = napi_get_named_property(env, options, "callback", &callback);
+  REJECT_RETURN;
+  c->status = napi_typeof(env, callback, &type);
+  REJECT_RETURN;
+  if (type != napi_function)
+    REJECT_ERROR_RETURN("callback must be a function.", GRANDI_INVALID_ARGS);
+
+  napi_value receivers;
+  c->status = napi_get_named_property(env, options, "receivers", &receivers);
+  REJECT_RETURN;
+  c->status = napi_is_array(env, receivers, &isArray);
+  REJECT_RETURN;
+  uint32_t receiverCount = 0;
+  if (isArray) {
+    c->status = napi_get_array_length(env, receivers, &receiverCount);
+    REJECT_RETURN;
+  }
+  if (receiverCount == 0)
+    REJECT_ERROR_RETURN("receivers must be a non-empty array of receivers.",
+                        GRANDI_INVALID_ARGS);
+  for (uint32_t i = 0; i < receiverCount; i++) {
+    napi_value receiver;
+    c->status = napi_get_element(env, receivers, i, &receiver);
+    REJECT_RETURN;
+    if (!bindSyncGroupMember(env, receiver, c))
+      REJECT_RETURN;
+  }
+
+  napi_value resource_name;
+  c->status = napi_create_string_utf8(env, "SyncGroup", NAPI_AUTO_LENGTH,
+                                      &resource_name);
+  REJECT_RETURN;
+  c->status = napi_create_threadsafe_function(
+      env, callback, nullptr, resource_name, kMaxPendingSets, 1, c->group,
+      finalizeSyncGroupCallback, nullptr, deliverSyncGroupSet,
+      &c->group->callback);
+  REJECT_RETURN;
+
+  napi_value result;
+  c->status = napi_create_object(env, &result);
+  REJECT_RETURN;
+
+  syncGroupWrapper *group = c->group;
+  napi_value embedded;
+  c->status =
+      napi_create_external(env, group, finalizeSyncGroup, nullptr, &embedded);
+  REJECT_RETURN;
+  c->group = nullptr;
+  c->status = napi_set_named_property(env, result, "embedded", embedded);
+  REJECT_RETURN;
+
+  napi_value destroyFn;
+  c->status = napi_create_function(env, "destroy", NAPI_AUTO_LENGTH,
+                                   destroySyncGroup, nullptr, &destroyFn);
+  REJECT_RETURN;
+  c->status = napi_set_named_property(env, result, "destroy", destroyFn);
+  REJECT_RETURN;
+
+  napi_value statsFn;
+  c->status = napi_create_function(env, "stats", NAPI_AUTO_LENGTH,
+                                   syncGroupStats, nullptr, &statsFn);
+  REJECT_RETURN;
+  c->status = napi_set_named_property(env, result, "stats", statsFn);
+  REJECT_RETURN;
+
+  napi_value size;
+  c->status = napi_create_uint32(env, receiverCount, &size);
+  REJECT_RETURN;
+  c->status = napi_set_named_property(env, result, "size", size);
+  REJECT_RETURN;
+
+  // Each capture thread is listed under the source it reads from.
+  for (auto &member : group->members) {
+    member->role.role = "syncgroup";
+    member->role.owner = member->sourceName;
+    member->role.placement = placement;
+    member->thread = std::thread(captureSyncGroupMember, group, member.get());
+  }
+
+  napi_status status = napi_resolve_deferred(env, c->_deferred, result);
+  FLOATING_STATUS;
+  tidyCarrier(env, c);
+  return promise;
+}
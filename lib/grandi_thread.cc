@@ -0,0 +1,450 @@
+/* Copyright 2025 Sarhan Aissi <github@tux.tn>.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+*/
+
+#include <cerrno>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <sched.h>
+#ifdef __linux__
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+#endif
+
+#include "grandi_thread.h"
+#include "grandi_util.h"
+
+namespace {
+#if defined(__linux__)
+const uint32_t kMaxCpus = CPU_SETSIZE;
+#elif defined(_WIN32)
+// SetThreadAffinityMask covers the calling thread's processor group.
+const uint32_t kMaxCpus = 64;
+#else
+const uint32_t kMaxCpus = 0;
+#endif
+
+struct threadEntry {
+  uint64_t id;
+  std::string role;
+  std::string owner;
+  threadPlacement placement;
+  int64_t osId;
+  std::string error;
+};
+
+struct threadRegistry {
+  std::mutex mutex;
+  std::vector<threadEntry> threads;
+  uint64_t nextId = 1;
+};
+
+threadRegistry &registry() {
+  // Never destroyed: threads may still unregister while the process exits.
+  static threadRegistry *created = new threadRegistry;
+  return *created;
+}
+
+int64_t currentThreadId() {
+#if defined(_WIN32)
+  return (int64_t)GetCurrentThreadId();
+#elif defined(__linux__)
+  return (int64_t)syscall(SYS_gettid);
+#elif defined(__APPLE__)
+  uint64_t id = 0;
+  pthread_threadid_np(nullptr, &id);
+  return (int64_t)id;
+#else
+  return 0;
+#endif
+}
+
+void appendError(std::string *errors, const std::string &error) {
+  if (!errors->empty())
+    *errors += " ";
+  *errors += error;
+}
+
+#ifndef _WIN32
+std::string errorText(const char *what, int code) {
+  return std::string(what) + ": " + strerror(code) + ".";
+}
+#endif
+
+// Returns why the OS refused any part of placement, or an empty string.
+std::string applyPlacement(const threadPlacement &placement,
+                           int64_t osId) {
+  std::string errors;
+#if defined(__linux__)
+  if (!placement.cpus.empty()) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (uint32_t cpu : placement.cpus)
+      CPU_SET(cpu, &set);
+    int code = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+    if (code != 0)
+      appendError(&errors, errorText("Failed to set CPU affinity", code));
+  }
+  if (placement.setNice &&
+      setpriority(PRIO_PROCESS, (id_t)osId, placement.nice) != 0)
+    appendError(&errors, errorText("Failed to set nice value", errno));
+#elif defined(_WIN32)
+  if (!placement.cpus.empty()) {
+    DWORD_PTR mask = 0;
+    for (uint32_t cpu : placement.cpus)
+      mask |= (DWORD_PTR)1 << cpu;
+    if (SetThreadAffinityMask(GetCurrentThread(), mask) == 0)
+      appendError(&errors, "Failed to set CPU affinity: error " +
+                               std::to_string(GetLastError()) + ".");
+  }
+  if (placement.realtimePriority > 0 &&
+      !SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_TIME_CRITICAL))
+    appendError(&errors, "Failed to raise thread priority: error " +
+                             std::to_string(GetLastError()) + ".");
+#endif
+#ifndef _WIN32
+  if (placement.realtimePriority > 0) {
+    sched_param param;
+    memset(&param, 0, sizeof(param));
+    param.sched_priority = placement.realtimePriority;
+    int code = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+    if (code != 0)
+      appendError(&errors, errorText("Failed to set SCHED_FIFO", code));
+  }
+#endif
+  (void)osId;
+  return errors;
+}
+
+napi_status readInteger(napi_env env, napi_value object, const char *name,
+                        int minimum, int maximum, bool *present, int *result,
+                        std::string *error) {
+  napi_value value;
+  napi_status status = napi_get_named_property(env, object, name, &value);
+  PASS_STATUS;
+  napi_valuetype type;
+  status = napi_typeof(env, value, &type);
+  PASS_STATUS;
+  *present = type != napi_undefined;
+  if (!*present)
+    return napi_ok;
+  double parsed = NAN;
+  if (type == napi_number) {
+    status = napi_get_value_double(env, value, &parsed);
+    PASS_STATUS;
+  }
+  if (!(parsed >= minimum && parsed <= maximum) ||
+      parsed != std::floor(parsed)) {
+    *error = std::string("scheduling.") + name +
+             " must be an integer between " + std::to_string(minimum) +
+             " and " + std::to_string(maximum) + ".";
+    return napi_ok;
+  }
+  *result = (int)parsed;
+  return napi_ok;
+}
+
+napi_status readCpus(napi_env env, napi_value object,
+                     std::vector<uint32_t> *cpus, std::string *error) {
+  napi_value value;
+  napi_status status = napi_get_named_property(env, object, "cpus", &value);
+  PASS_STATUS;
+  napi_valuetype type;
+  status = napi_typeof(env, value, &type);
+  PASS_STATUS;
+  if (type == napi_undefined)
+    return napi_ok;
+  if (kMaxCpus == 0) {
+    *error = "scheduling.cpus is not supported on this platform.";
+    return napi_ok;
+  }
+  std::string message = "scheduling.cpus must be a non-empty array of CPU "
+                        "numbers from 0 to " +
+                        std::to_string(kMaxCpus - 1) + ".";
+  bool isArray = false;
+  status = napi_is_array(env, value, &isArray);
+  PASS_STATUS;
+  uint32_t length = 0;
+  if (isArray) {
+    status = napi_get_array_length(env, value, &length);
+    PASS_STATUS;
+  }
+  if (length == 0 || length > kMaxCpus) {
+    *error = message;
+    return napi_ok;
+  }
+  for (uint32_t i = 0; i < length; i++) {
+    napi_value element;
+    status = napi_get_element(env, value, i, &element);
+    PASS_STATUS;
+    uint32_t cpu = 0;
+    status = parseUint32Value(env, element, "cpu", &cpu, error);
+    PASS_STATUS;
+    if (!error->empty() || cpu >= kMaxCpus) {
+      *error = message;
+      return napi_ok;
+    }
+    cpus->push_back(cpu);
+  }
+  return napi_ok;
+}
+
+#ifdef __linux__
+// Reads the CPU the thread last ran on from /proc, or -1.
+int lastCpu(int64_t osId) {
+  char path[64];
+  snprintf(path, sizeof(path), "/proc/self/task/%lld/stat", (long long)osId);
+  FILE *file = fopen(path, "r");
+  if (file == nullptr)
+    return -1;
+  char line[1024];
+  size_t length = fread(line, 1, sizeof(line) - 1, file);
+  fclose(file);
+  line[length] = '\0';
+  // The command name may hold spaces, so count fields after its ')'. The
+  // processor is field 39, and the state after the name is field 3.
+  char *cursor = strrchr(line, ')');
+  if (cursor == nullptr)
+    return -1;
+  int field = 2;
+  int cpu = -1;
+  char *state = nullptr;
+  for (char *token = strtok_r(cursor + 1, " ", &state); token != nullptr;
+       token = strtok_r(nullptr, " ", &state)) {
+    if (++field == 39) {
+      cpu = atoi(token);
+      break;
+    }
+  }
+  return cpu;
+}
+#endif
+
+struct threadReport {
+  std::vector<uint32_t> cpus;
+  int lastCpu = -1;
+  const char *policy = "other";
+  int priority = 0;
+  int nice = 0;
+};
+
+// Reads where a thread may run and its scheduling from the OS where it
+// can, and otherwise reports the placement it asked for.
+void describeThread(int64_t osId, const threadPlacement &placement,
+                    threadReport *report) {
+  report->cpus = placement.cpus;
+  report->policy = placement.realtimePriority > 0 ? "fifo" : "other";
+  report->priority = placement.realtimePriority;
+  report->nice = placement.nice;
+#ifdef __linux__
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  if (sched_getaffinity((pid_t)osId, sizeof(set), &set) == 0) {
+    report->cpus.clear();
+    for (uint32_t cpu = 0; cpu < kMaxCpus; cpu++) {
+      if (CPU_ISSET(cpu, &set))
+        report->cpus.push_back(cpu);
+    }
+  }
+  report->lastCpu = lastCpu(osId);
+  int policy = sched_getscheduler((pid_t)osId);
+  report->policy = policy == SCHED_FIFO    ? "fifo"
+                   : policy == SCHED_RR    ? "rr"
+                   : policy == SCHED_BATCH ? "batch"
+                   : policy == SCHED_IDLE  ? "idle"
+                                           : "other";
+  sched_param param;
+  if (sched_getparam((pid_t)osId, &param) == 0)
+    report->priority = param.sched_priority;
+  errno = 0;
+  int nice = getpriority(PRIO_PROCESS, (id_t)osId);
+  if (errno == 0)
+    report->nice = nice;
+#endif
+}
+
+napi_status setThreadProperties(napi_env env, napi_value object,
+                                const char *role, const std::string &owner,
+                                int64_t osId,
+                                const threadPlacement &placement,
+                                const std::string &error) {
+  threadReport report;
+  describeThread(osId, placement, &report);
+
+  napi_value param;
+  napi_status status =
+      napi_create_string_utf8(env, role, NAPI_AUTO_LENGTH, &param);
+  PASS_STATUS;
+  status = napi_set_named_property(env, object, "role", param);
+  PASS_STATUS;
+  status = napi_create_string_utf8(env, owner.c_str(), owner.size(), &param);
+  PASS_STATUS;
+  status = napi_set_named_property(env, object, "owner", param);
+  PASS_STATUS;
+  status = napi_create_double(env, (double)osId, &param);
+  PASS_STATUS;
+  status = napi_set_named_property(env, object, "threadId", param);
+  PASS_STATUS;
+
+  napi_value cpus;
+  status = napi_create_array_with_length(env, report.cpus.size(), &cpus);
+  PASS_STATUS;
+  for (size_t i = 0; i < report.cpus.size(); i++) {
+    status = napi_create_uint32(env, report.cpus[i], &param);
+    PASS_STATUS;
+    status = napi_set_element(env, cpus, (uint32_t)i, param);
+    PASS_STATUS;
+  }
+  status = napi_set_named_property(env, object, "cpus", cpus);
+  PASS_STATUS;
+
+  const char *names[3] = {"lastCpu", "priority", "nice"};
+  int values[3] = {report.lastCpu, report.priority, report.nice};
+  for (int i = 0; i < 3; i++) {
+    status = napi_create_int32(env, values[i], &param);
+    PASS_STATUS;
+    status = napi_set_named_property(env, object, names[i], param);
+    PASS_STATUS;
+  }
+  status = napi_create_string_utf8(env, report.policy, NAPI_AUTO_LENGTH,
+                                   &param);
+  PASS_STATUS;
+  status = napi_set_named_property(env, object, "policy", param);
+  PASS_STATUS;
+  if (error.empty())
+    return napi_ok;
+  status = napi_create_string_utf8(env, error.c_str(), error.size(), &param);
+  PASS_STATUS;
+  return napi_set_named_property(env, object, "error", param);
+}
+} // namespace
+
+napi_status parseThreadPlacementValue(napi_env env, napi_value value,
+                                      threadPlacement *placement,
+                                      std::string *error) {
+  error->clear();
+  *placement = threadPlacement();
+  napi_valuetype type;
+  napi_status status = napi_typeof(env, value, &type);
+  if (status != napi_ok || type == napi_undefined)
+    return status;
+  bool isArray = false;
+  if (type == napi_object) {
+    status = napi_is_array(env, value, &isArray);
+    PASS_STATUS;
+  }
+  if (type != napi_object || isArray) {
+    *error = "scheduling must be an object.";
+    return napi_ok;
+  }
+
+  status = readCpus(env, value, &placement->cpus, error);
+  if (status != napi_ok || !error->empty())
+    return status;
+  status = readInteger(env, value, "nice", -20, 19, &placement->setNice,
+                       &placement->nice, error);
+  if (status != napi_ok || !error->empty())
+    return status;
+#ifndef __linux__
+  if (placement->setNice) {
+    *error = "scheduling.nice is not supported on this platform.";
+    return napi_ok;
+  }
+#endif
+  bool realtime = false;
+  status = readInteger(env, value, "realtimePriority", 1, 99, &realtime,
+                       &placement->realtimePriority, error);
+  if (status != napi_ok || !error->empty())
+    return status;
+  if (realtime && placement->setNice)
+    *error = "scheduling.nice and scheduling.realtimePriority cannot be "
+             "combined.";
+  return napi_ok;
+}
+
+napi_status parseThreadPlacement(napi_env env, napi_value options,
+                                 threadPlacement *placement,
+                                 std::string *error) {
+  napi_value value;
+  napi_status status =
+      napi_get_named_property(env, options, "scheduling", &value);
+  PASS_STATUS;
+  return parseThreadPlacementValue(env, value, placement, error);
+}
+
+threadRegistration::threadRegistration(const threadRole &role) {
+  threadEntry entry;
+  entry.role = role.role;
+  entry.owner = role.owner;
+  entry.placement = role.placement;
+  entry.osId = currentThreadId();
+  entry.error = applyPlacement(role.placement, entry.osId);
+  threadRegistry &threads = registry();
+  std::lock_guard<std::mutex> lock(threads.mutex);
+  id = entry.id = threads.nextId++;
+  threads.threads.push_back(std::move(entry));
+}
+
+threadRegistration::~threadRegistration() {
+  threadRegistry &threads = registry();
+  std::lock_guard<std::mutex> lock(threads.mutex);
+  for (size_t i = 0; i < threads.threads.size(); i++) {
+    if (threads.threads[i].id == id) {
+      threads.threads.erase(threads.threads.begin() + i);
+      return;
+    }
+  }
+}
+
+napi_value threadTopology(napi_env env, napi_callback_info info) {
+  napi_status status;
+  std::vector<threadEntry> threads;
+  {
+    threadRegistry &entries = registry();
+    std::lock_guard<std::mutex> lock(entries.mutex);
+    threads = entries.threads;
+  }
+
+  napi_value result, object;
+  status = napi_create_array_with_length(env, threads.size() + 1, &result);
+  CHECK_STATUS;
+  // The JavaScript thread asking comes first.
+  status = napi_create_object(env, &object);
+  CHECK_STATUS;
+  status = setThreadProperties(env, object, "javascript", "",
+                               currentThreadId(), threadPlacement(), "");
+  CHECK_STATUS;
+  status = napi_set_element(env, result, 0, object);
+  CHECK_STATUS;
+  for (size_t i = 0; i < threads.size(); i++) {
+    const threadEntry &entry = threads[i];
+    status = napi_create_object(env, &object);
+    CHECK_STATUS;
+    status = setThreadProperties(env, object, entry.role.c_str(), entry.owner,
+                                 entry.osId, entry.placement, entry.error);
+    CHECK_STATUS;
+    status = napi_set_element(env, result, (uint32_t)(i + 1), object);
+    CHECK_STATUS;
+  }
+  return result;
+}
@@ -0,0 +1,73 @@
+/* Copyright 2025 Sarhan Aissi <github@tux.tn>.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+*/
+
+#ifndef GRANDI_THREAD_H
+#define GRANDI_THREAD_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "node_api.h"
+
+// Where and at what priority a grandi-owned thread runs. Linux supports
+// every field; Windows supports cpus (below 64) and realtimePriority, and
+// macOS realtimePriority only.
+struct threadPlacement {
+  // CPUs the thread may run on; empty keeps the process mask.
+  std::vector<uint32_t> cpus;
+  bool setNice = false;
+  int nice = 0;
+  // SCHED_FIFO priority from 1 to 99, or 0 to keep the normal policy.
+  int realtimePriority = 0;
+};
+
+// Parses a scheduling object, { cpus, nice, realtimePriority }, where
+// undefined keeps the defaults. Invalid values set error and return napi_ok,
+// like parseUint32Value.
+napi_status parseThreadPlacementValue(napi_env env, napi_value value,
+                                      threadPlacement *placement,
+                                      std::string *error);
+// Parses the optional `scheduling` property of options.
+napi_status parseThreadPlacement(napi_env env, napi_value options,
+                                 threadPlacement *placement,
+                                 std::string *error);
+
+// Role and owner a thread is listed under by threadTopology(), and the
+// placement it applies to itself.
+struct threadRole {
+  const char *role = "worker";
+  std::string owner;
+  threadPlacement placement;
+};
+
+// Lists the calling thread under role and applies its placement for as long
+// as it lives. A placement the OS refuses, such as SCHED_FIFO without the
+// permission, is reported by threadTopology() and does not stop the thread.
+class threadRegistration {
+public:
+  explicit threadRegistration(const threadRole &role);
+  ~threadRegistration();
+  threadRegistration(const threadRegistration &) = delete;
+  threadRegistration &operator=(const threadRegistration &) = delete;
+
+private:
+  uint64_t id;
+};
+
+// Exposed as threadTopology().
+napi_value threadTopology(napi_env env, napi_callback_info info);
+
+#endif /* GRANDI_THREAD_H */
@@ -0,0 +1,450 @@
+/* Copyright 2025 Sarhan Aissi <github@tux.tn>.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+#include "grandi_timecode.h"
+#include "grandi_draw.h"
+#include "grandi_fields.h"
+#include "grandi_util.h"
+
+namespace {
+const int64_t kUnitsPerSecond = 10000000;
+const int64_t kUnitsPerDay = kUnitsPerSecond * 86400;
+const int kMaxBurnInScale = 16;
+
+napi_status readBoolean(napi_env env, napi_value object, const char *name,
+                        const char *label, bool *result, std::string *error) {
+  napi_value value;
+  napi_status status = napi_get_named_property(env, object, name, &value);
+  if (status != napi_ok)
+    return status;
+  napi_valuetype type;
+  status = napi_typeof(env, value, &type);
+  if (status != napi_ok || type == napi_undefined)
+    return status;
+  if (type != napi_boolean) {
+    *error = std::string(label) + " must be a Boolean.";
+    return napi_ok;
+  }
+  return napi_get_value_bool(env, value, result);
+}
+
+// Reads frameRateN, frameRateD, and dropFrame from a rate object.
+napi_status readTimecodeRate(napi_env env, napi_value options, int *frameRateN,
+                             int *frameRateD, timecodeRate *rate,
+                             std::string *error) {
+  napi_valuetype type;
+  napi_status status = napi_typeof(env, options, &type);
+  if (status != napi_ok)
+    return status;
+  if (type != napi_object) {
+    *error = "Timecode options must be an object with frameRateN and "
+             "frameRateD.";
+    return napi_ok;
+  }
+  const char *names[2] = {"frameRateN", "frameRateD"};
+  int *values[2] = {frameRateN, frameRateD};
+  for (int i = 0; i < 2; i++) {
+    napi_value value;
+    status = napi_get_named_property(env, options, names[i], &value);
+    if (status != napi_ok)
+      return status;
+    uint32_t parsed = 0;
+    status = parseUint32Value(env, value, names[i], &parsed, error);
+    if (status != napi_ok || !error->empty())
+      return status;
+    if (parsed == 0 || parsed > INT32_MAX) {
+      *error = "frameRateN and frameRateD must be positive.";
+      return napi_ok;
+    }
+    *values[i] = (int)parsed;
+  }
+  bool dropFrame = true;
+  status =
+      readBoolean(env, options, "dropFrame", "dropFrame", &dropFrame, error);
+  if (status != napi_ok || !error->empty())
+    return status;
+  makeTimecodeRate(*frameRateN, *frameRateD, dropFrame, rate);
+  return napi_ok;
+}
+
+int glyphScale(const burnInOptions &options, int yres) {
+  if (options.scale > 0)
+    return options.scale;
+  return std::max(1, yres / 270);
+}
+} // namespace
+
+bool makeTimecodeRate(int frameRateN, int frameRateD, bool dropFrame,
+                      timecodeRate *rate) {
+  if (frameRateN <= 0 || frameRateD <= 0)
+    return false;
+  rate->nominal = std::max<int64_t>(
+      1, ((int64_t)frameRateN + frameRateD / 2) / frameRateD);
+  rate->drop = 0;
+  if (dropFrame && frameRateD == 1001 && frameRateN % 30000 == 0)
+    rate->drop = rate->nominal / 15;
+  return true;
+}
+
+int64_t framesFromTimecode(int64_t timecode, int frameRateN, int frameRateD) {
+  if (frameRateN <= 0 || frameRateD <= 0)
+    return 0;
+  timecode %= kUnitsPerDay;
+  if (timecode < 0)
+    timecode += kUnitsPerDay;
+  // Split at whole seconds so no product overflows for any 32-bit rate.
+  int64_t seconds = timecode / kUnitsPerSecond;
+  int64_t units = timecode % kUnitsPerSecond;
+  int64_t scaled = seconds * frameRateN;
+  int64_t whole = scaled / frameRateD;
+  int64_t remainder = scaled % frameRateD;
+  int64_t divisor = (int64_t)frameRateD * kUnitsPerSecond;
+  return whole + (remainder * kUnitsPerSecond + units * frameRateN +
+                  divisor / 2) /
+                     divisor;
+}
+
+size_t formatFrames(int64_t frames, const timecodeRate &rate,
+                    char text[kTimecodeLength + 1]) {
+  int64_t nominal = rate.nominal;
+  int64_t drop = rate.drop;
+  int64_t perTenMinutes = nominal * 600 - drop * 9;
+  int64_t perDay = perTenMinutes * 144;
+  frames %= perDay;
+  if (frames < 0)
+    frames += perDay;
+  if (drop > 0) {
+    // Restore the frame numbers skipped at the start of each minute, except
+    // every tenth, so the count reads as nominal-rate timecode.
+    int64_t perMinute = nominal * 60 - drop;
+    int64_t tens = frames / perTenMinutes;
+    int64_t rest = frames % perTenMinutes;
+    frames += drop * 9 * tens;
+    if (rest > drop)
+      frames += drop * ((rest - drop) / perMinute);
+  }
+  int64_t seconds = frames / nominal;
+  int written = snprintf(
+      text, kTimecodeLength + 1, "%02d:%02d:%02d%c%02d",
+      (int)(seconds / 3600 % 24), (int)(seconds / 60 % 60),
+      (int)(seconds % 60), drop > 0 ? ';' : ':', (int)(frames % nominal));
+  return std::min<size_t>(written < 0 ? 0 : (size_t)written, kTimecodeLength);
+}
+
+bool parseTimecodeText(const char *text, int frameRateN, int frameRateD,
+                       int64_t *frames) {
+  int hours, minutes, seconds, count, length = 0;
+  char separator;
+  if (sscanf(text, "%2d:%2d:%2d%c%3d%n", &hours, &minutes, &seconds,
+             &separator, &count, &length) != 5 ||
+      text[length] != '\0' || strchr(":;.,", separator) == nullptr)
+    return false;
+  timecodeRate rate;
+  bool dropFrame = separator == ';' || separator == ',';
+  if (!makeTimecodeRate(frameRateN, frameRateD, dropFrame, &rate))
+    return false;
+  if (hours < 0 || hours > 23 || minutes < 0 || minutes > 59 ||
+      seconds < 0 || seconds > 59 || count < 0 || count >= rate.nominal)
+    return false;
+  int64_t totalMinutes = hours * 60 + minutes;
+  bool skipped = seconds == 0 && minutes % 10 != 0;
+  if (rate.drop > 0 && skipped && count < rate.drop)
+    return false;
+  *frames = (totalMinutes * 60 + seconds) * rate.nominal + count -
+            rate.drop * (totalMinutes - totalMinutes / 10);
+  return true;
+}
+
+bool timecodeFromFrames(int64_t frames, int frameRateN, int frameRateD,
+                        int64_t *timecode) {
+  if (frames < 0 || frameRateN <= 0 || frameRateD <= 0)
+    return false;
+  // frames * frameRateD / frameRateN seconds, split so that every product
+  // fits in 64 bits.
+  int64_t whole = frames / frameRateN;
+  int64_t scaled = (frames % frameRateN) * frameRateD;
+  if (whole > (INT64_MAX / 2) / ((int64_t)frameRateD * kUnitsPerSecond))
+    return false;
+  *timecode = whole * frameRateD * kUnitsPerSecond +
+              scaled / frameRateN * kUnitsPerSecond +
+              ((scaled % frameRateN) * kUnitsPerSecond + frameRateN / 2) /
+                  frameRateN;
+  return true;
+}
+
+napi_status parseBurnInOptions(napi_env env, napi_value value, bool *enabled,
+                               burnInOptions *options, std::string *error) {
+  error->clear();
+  *enabled = false;
+  *options = burnInOptions();
+  napi_valuetype type;
+  napi_status status = napi_typeof(env, value, &type);
+  if (status != napi_ok || type == napi_undefined)
+    return status;
+  if (type == napi_boolean)
+    return napi_get_value_bool(env, value, enabled);
+  bool isArray = false;
+  if (type == napi_object) {
+    status = napi_is_array(env, value, &isArray);
+    if (status != napi_ok)
+      return status;
+  }
+  if (type != napi_object || isArray) {
+    *error = "burnIn must be a Boolean or an object.";
+    return napi_ok;
+  }
+  *enabled = true;
+
+  status = readBoolean(env, value, "timecode", "burnIn.timecode",
+                       &options->timecode, error);
+  if (status != napi_ok || !error->empty())
+    return status;
+  status = readBoolean(env, value, "frameCounter", "burnIn.frameCounter",
+                       &options->frameCounter, error);
+  if (status != napi_ok || !error->empty())
+    return status;
+  status = readBoolean(env, value, "dropFrame", "burnIn.dropFrame",
+                       &options->dropFrame, error);
+  if (status != napi_ok || !error->empty())
+    return status;
+
+  napi_value param;
+  status = napi_get_named_property(env, value, "label", &param);
+  if (status != napi_ok)
+    return status;
+  status = napi_typeof(env, param, &type);
+  if (status != napi_ok)
+    return status;
+  if (type == napi_boolean) {
+    status = napi_get_value_bool(env, param, &options->label);
+    if (status != napi_ok)
+      return status;
+  } else if (type == napi_string) {
+    size_t length = 0;
+    status = napi_get_value_string_utf8(env, param, nullptr, 0, &length);
+    if (status != napi_ok)
+      return status;
+    options->labelText.resize(length + 1);
+    status = napi_get_value_string_utf8(env, param, &options->labelText[0],
+                                        length + 1, &length);
+    if (status != napi_ok)
+      return status;
+    options->labelText.resize(length);
+    options->customLabel = true;
+  } else if (type != napi_undefined) {
+    *error = "burnIn.label must be a Boolean or a string.";
+    return napi_ok;
+  }
+
+  status = napi_get_named_property(env, value, "position", &param);
+  if (status != napi_ok)
+    return status;
+  status = napi_typeof(env, param, &type);
+  if (status != napi_ok)
+    return status;
+  if (type != napi_undefined) {
+    char text[16] = {};
+    size_t length = 0;
+    if (type == napi_string) {
+      status =
+          napi_get_value_string_utf8(env, param, text, sizeof(text), &length);
+      if (status != napi_ok)
+        return status;
+    }
+    if (strcmp(text, "top-left") == 0)
+      options->position = burnInPosition::topLeft;
+    else if (strcmp(text, "top-right") == 0)
+      options->position = burnInPosition::topRight;
+    else if (strcmp(text, "bottom-left") == 0)
+      options->position = burnInPosition::bottomLeft;
+    else if (strcmp(text, "bottom-right") == 0)
+      options->position = burnInPosition::bottomRight;
+    else {
+      *error = "burnIn.position must be \"top-left\", \"top-right\", "
+               "\"bottom-left\", or \"bottom-right\".";
+      return napi_ok;
+    }
+  }
+
+  status = napi_get_named_property(env, value, "scale", &param);
+  if (status != napi_ok)
+    return status;
+  status = napi_typeof(env, param, &type);
+  if (status != napi_ok || type == napi_undefined)
+    return status;
+  uint32_t scale = 0;
+  status = parseUint32Value(env, param, "burnIn.scale", &scale, error);
+  if (status != napi_ok)
+    return status;
+  if (!error->empty() || scale < 1 || scale > (uint32_t)kMaxBurnInScale) {
+    *error = "burnIn.scale must be an integer between 1 and " +
+             std::to_string(kMaxBurnInScale) + ".";
+    return napi_ok;
+  }
+  options->scale = (int)scale;
+  return napi_ok;
+}
+
+void burnIn(const burnInOptions &options, const NDIlib_video_frame_v2_t &frame,
+            const std::string &label, int64_t frameNumber) {
+  if (frame.p_data == nullptr || !drawable(frame.FourCC) || frame.xres <= 0 ||
+      frame.yres <= 0)
+    return;
+
+  std::string lines[3];
+  int count = 0;
+  if (options.label) {
+    lines[count] = options.customLabel ? options.labelText : label;
+    if (!lines[count].empty())
+      count++;
+  }
+  timecodeRate rate;
+  if (options.timecode &&
+      makeTimecodeRate(frame.frame_rate_N, frame.frame_rate_D,
+                       options.dropFrame, &rate)) {
+    int64_t frames = frame.timecode == NDIlib_send_timecode_synthesize
+                         ? frameNumber
+                         : framesFromTimecode(frame.timecode,
+                                              frame.frame_rate_N,
+                                              frame.frame_rate_D);
+    char text[kTimecodeLength + 1];
+    lines[count++].assign(text, formatFrames(frames, rate, text));
+  }
+  if (options.frameCounter)
+    lines[count++] = "#" + std::to_string(frameNumber);
+  if (count == 0)
+    return;
+
+  drawTarget target;
+  target.data = frame.p_data;
+  target.fourCC = frame.FourCC;
+  target.xres = frame.xres;
+  target.yres = frame.yres;
+  target.lineStride = frame.line_stride_in_bytes != 0
+                          ? frame.line_stride_in_bytes
+                          : defaultLineStride(frame.FourCC, frame.xres);
+
+  int scale = glyphScale(options, frame.yres);
+  int glyph = kGlyphSize * scale;
+  int padding = 2 * scale;
+  int margin = 4 * scale;
+  // Lines longer than the frame is wide are cut short.
+  size_t fits = (size_t)std::max(
+      0, (frame.xres - 2 * margin - 2 * padding) / std::max(glyph, 1));
+  size_t widest = 0;
+  for (int i = 0; i < count; i++) {
+    if (lines[i].size() > fits)
+      lines[i].resize(fits);
+    widest = std::max(widest, lines[i].size());
+  }
+  int width = textWidth(widest, scale) + 2 * padding;
+  int height = count * glyph + (count - 1) * padding + 2 * padding;
+  bool right = options.position == burnInPosition::topRight ||
+               options.position == burnInPosition::bottomRight;
+  bool bottom = options.position == burnInPosition::bottomLeft ||
+                options.position == burnInPosition::bottomRight;
+  int x = right ? frame.xres - margin - width : margin;
+  int y = bottom ? frame.yres - margin - height : margin;
+
+  fillRect(target, x, y, width, height, makeDrawColor(0, 0, 0));
+  drawColor white = makeDrawColor(255, 255, 255);
+  for (int i = 0; i < count; i++)
+    drawText(target, x + padding, y + padding + i * (glyph + padding), scale,
+             lines[i].data(), lines[i].size(), white);
+}
+
+napi_value formatTimecode(napi_env env, napi_callback_info info) {
+  napi_status status;
+  size_t argc = 2;
+  napi_value args[2];
+  status = napi_get_cb_info(env, info, &argc, args, nullptr, nullptr);
+  CHECK_STATUS;
+  if (argc < 2)
+    NAPI_THROW_ERROR("Timecode and frame rate options must be provided.");
+
+  napi_valuetype type;
+  status = napi_typeof(env, args[0], &type);
+  CHECK_STATUS;
+  int64_t timecode = 0;
+  bool lossless = type == napi_bigint;
+  if (lossless) {
+    status = napi_get_value_bigint_int64(env, args[0], &timecode, &lossless);
+    CHECK_STATUS;
+  }
+  if (!lossless)
+    NAPI_THROW_ERROR("timecode must be a bigint that fits in 64 bits.");
+
+  int frameRateN = 0, frameRateD = 0;
+  timecodeRate rate;
+  std::string error;
+  status = readTimecodeRate(env, args[1], &frameRateN, &frameRateD, &rate,
+                            &error);
+  CHECK_STATUS;
+  if (!error.empty())
+    NAPI_THROW_ERROR(error.c_str());
+
+  char text[kTimecodeLength + 1];
+  size_t length = formatFrames(
+      framesFromTimecode(timecode, frameRateN, frameRateD), rate, text);
+  napi_value result;
+  status = napi_create_string_utf8(env, text, length, &result);
+  CHECK_STATUS;
+  return result;
+}
+
+napi_value frameTimecode(napi_env env, napi_callback_info info) {
+  napi_status status;
+  size_t argc = 2;
+  napi_value args[2];
+  status = napi_get_cb_info(env, info, &argc, args, nullptr, nullptr);
+  CHECK_STATUS;
+  if (argc < 2)
+    NAPI_THROW_ERROR("Frame number and frame rate options must be provided.");
+
+  napi_valuetype type;
+  status = napi_typeof(env, args[0], &type);
+  CHECK_STATUS;
+  double frame = NAN;
+  if (type == napi_number) {
+    status = napi_get_value_double(env, args[0], &frame);
+    CHECK_STATUS;
+  }
+  if (!std::isfinite(frame) || std::floor(frame) != frame || frame < 0 ||
+      frame > 9007199254740991.0)
+    NAPI_THROW_ERROR("frame must be a non-negative safe integer.");
+
+  int frameRateN = 0, frameRateD = 0;
+  timecodeRate rate;
+  std::string error;
+  status = readTimecodeRate(env, args[1], &frameRateN, &frameRateD, &rate,
+                            &error);
+  CHECK_STATUS;
+  if (!error.empty())
+    NAPI_THROW_ERROR(error.c_str());
+
+  int64_t timecode = 0;
+  if (!timecodeFromFrames((int64_t)frame, frameRateN, frameRateD, &timecode))
+    NAPI_THROW_ERROR("frame is too large for an NDI timecode.");
+
+  napi_value result;
+  status = napi_create_bigint_int64(env, timecode, &result);
+  CHECK_STATUS;
+  return result;
+}
@@ -0,0 +1,88 @@
+/* Copyright 2025 Sarhan Aissi <github@tux.tn>.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+*/
+
+#ifndef GRANDI_TIMECODE_H
+#define GRANDI_TIMECODE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include <Processing.NDI.Lib.h>
+
+#include "node_api.h"
+
+napi_value formatTimecode(napi_env env, napi_callback_info info);
+napi_value frameTimecode(napi_env env, napi_callback_info info);
+
+// SMPTE counting for a frame rate: frames per nominal second, and frames
+// dropped from the count at each minute not divisible by ten. Drop-frame
+// counting applies to 1001 rates that are multiples of 30000/1001.
+struct timecodeRate {
+  int64_t nominal = 30;
+  int64_t drop = 0;
+};
+
+// Returns false when frameRateN or frameRateD is not positive. dropFrame
+// false counts every frame at 1001 rates too.
+bool makeTimecodeRate(int frameRateN, int frameRateD, bool dropFrame,
+                      timecodeRate *rate);
+// Frames since midnight of an NDI timecode, in 100ns units.
+int64_t framesFromTimecode(int64_t timecode, int frameRateN, int frameRateD);
+// Writes "HH:MM:SS:FF", or "HH:MM:SS;FF" when dropping frames, for a frame
+// count; hours wrap at 24. Returns the length written.
+const size_t kTimecodeLength = 15;
+size_t formatFrames(int64_t frames, const timecodeRate &rate,
+                    char text[kTimecodeLength + 1]);
+// Reads "HH:MM:SS:FF" into a frame count, the inverse of formatFrames. A
+// ';' or ',' before the frames counts drop-frame when the rate allows it.
+// Returns false when the text is malformed or names a frame the count skips.
+bool parseTimecodeText(const char *text, int frameRateN, int frameRateD,
+                       int64_t *frames);
+// Start time of a frame count in 100ns units. Returns false when it does not
+// fit in an NDI timecode.
+bool timecodeFromFrames(int64_t frames, int frameRateN, int frameRateD,
+                        int64_t *timecode);
+
+enum class burnInPosition { topLeft, topRight, bottomLeft, bottomRight };
+
+// What a burn-in stamps, in a box at one corner of the frame.
+struct burnInOptions {
+  bool timecode = true;
+  bool frameCounter = false;
+  bool label = true;
+  // Replaces the source or sender name when set.
+  bool customLabel = false;
+  std::string labelText;
+  burnInPosition position = burnInPosition::bottomLeft;
+  // Glyph scale, or 0 to scale with the frame height.
+  int scale = 0;
+  bool dropFrame = true;
+};
+
+// Parses a burnIn option: undefined or false to disable, true for the
+// defaults, or an object. Invalid values set error and return napi_ok, like
+// parseUint32Value.
+napi_status parseBurnInOptions(napi_env env, napi_value value, bool *enabled,
+                               burnInOptions *options, std::string *error);
+
+// Stamps the label, timecode, and frame counter into frame's data, which must
+// be writable. The timecode is the frame's own, or frameNumber counted from
+// 00:00:00:00 when the frame's timecode is synthesized. Formats the drawing
+// helpers do not support are left unchanged.
+void burnIn(const burnInOptions &options, const NDIlib_video_frame_v2_t &frame,
+            const std::string &label, int64_t frameNumber);
+
+#endif /* GRANDI_TIMECODE_H */
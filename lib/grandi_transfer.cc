@@ -0,0 +1,222 @@
+/* Copyright 2025 Sarhan Aissi <github@tux.tn>.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+*/
+
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "grandi_transfer.h"
+#include "grandi_framesync.h"
+#include "grandi_receive.h"
+#include "grandi_send.h"
+#include "grandi_util.h"
+
+namespace {
+const char *kindNames[3] = {"receiver", "sender", "frameSync"};
+
+struct parkedValue {
+  detachedKind kind;
+  void *value;
+  void (*destroy)(void *);
+};
+
+struct detachedRegistry {
+  std::mutex mutex;
+  uint32_t nextId = 1;
+  std::unordered_map<uint32_t, parkedValue> parked;
+};
+
+detachedRegistry &registry() {
+  // Never destroyed: worker environments may still park or adopt while the
+  // process exits.
+  static detachedRegistry *instance = new detachedRegistry;
+  return *instance;
+}
+
+bool claimDetached(uint32_t id, detachedKind kind, parkedValue *result) {
+  detachedRegistry &state = registry();
+  std::lock_guard<std::mutex> lock(state.mutex);
+  auto entry = state.parked.find(id);
+  if (entry == state.parked.end() || entry->second.kind != kind)
+    return false;
+  *result = entry->second;
+  state.parked.erase(entry);
+  return true;
+}
+
+napi_status makeToken(napi_env env, detachedKind kind, uint32_t id,
+                      napi_value *result) {
+  napi_status status = napi_create_object(env, result);
+  PASS_STATUS;
+  napi_value value;
+  status = napi_create_string_utf8(env, kindNames[(int)kind], NAPI_AUTO_LENGTH,
+                                   &value);
+  PASS_STATUS;
+  status = napi_set_named_property(env, *result, "kind", value);
+  PASS_STATUS;
+  status = napi_create_uint32(env, id, &value);
+  PASS_STATUS;
+  return napi_set_named_property(env, *result, "id", value);
+}
+
+bool readToken(napi_env env, napi_value token, detachedKind *kind,
+               uint32_t *id) {
+  napi_valuetype type;
+  if (napi_typeof(env, token, &type) != napi_ok || type != napi_object)
+    return false;
+  napi_value value;
+  char name[16];
+  size_t length = 0;
+  if (napi_get_named_property(env, token, "kind", &value) != napi_ok ||
+      napi_typeof(env, value, &type) != napi_ok || type != napi_string ||
+      napi_get_value_string_utf8(env, value, name, sizeof(name), &length) !=
+          napi_ok)
+    return false;
+  bool known = false;
+  for (int i = 0; i < 3; i++) {
+    if (strcmp(name, kindNames[i]) == 0) {
+      *kind = (detachedKind)i;
+      known = true;
+    }
+  }
+  if (!known)
+    return false;
+  double number;
+  if (napi_get_named_property(env, token, "id", &value) != napi_ok ||
+      napi_typeof(env, value, &type) != napi_ok || type != napi_number ||
+      napi_get_value_double(env, value, &number) != napi_ok)
+    return false;
+  if (!(number >= 1 && number <= UINT32_MAX) || number != (uint32_t)number)
+    return false;
+  *id = (uint32_t)number;
+  return true;
+}
+} // namespace
+
+napi_value parkDetached(napi_env env, detachedKind kind, void *value,
+                        void (*destroy)(void *)) {
+  detachedRegistry &state = registry();
+  uint32_t id = 0;
+  {
+    std::lock_guard<std::mutex> lock(state.mutex);
+    // Skips 0 and ids still parked once the counter wraps.
+    while (id == 0 || state.parked.count(id) != 0)
+      id = state.nextId++;
+    state.parked.emplace(id, parkedValue{kind, value, destroy});
+  }
+  napi_value result;
+  if (makeToken(env, kind, id, &result) != napi_ok) {
+    parkedValue parked;
+    if (claimDetached(id, kind, &parked))
+      destroy(value);
+    NAPI_THROW_ERROR("Failed to create detached handle token.");
+  }
+  return result;
+}
+
+napi_value detachHandleObject(napi_env env, napi_callback_info info,
+                              detachedKind kind, void (*destroy)(void *),
+                              const char *label) {
+  napi_status status;
+  size_t argc = 0;
+  napi_value thisValue;
+  status = napi_get_cb_info(env, info, &argc, nullptr, &thisValue, nullptr);
+  CHECK_STATUS;
+
+  std::string error = std::string(label) + " has been destroyed.";
+  napi_value embedded;
+  status = napi_get_named_property(env, thisValue, "embedded", &embedded);
+  CHECK_STATUS;
+  napi_valuetype type;
+  status = napi_typeof(env, embedded, &type);
+  CHECK_STATUS;
+  if (type != napi_external)
+    NAPI_THROW_ERROR(error.c_str());
+  void *externalData;
+  status = napi_get_value_external(env, embedded, &externalData);
+  CHECK_STATUS;
+
+  void *value = nullptr;
+  nativeCaptureStatus detachStatus =
+      detachNativeHandle((nativeHandle *)externalData, &value);
+  if (detachStatus == nativeCaptureStatus::bound)
+    error = std::string(label) + " is bound to a native consumer.";
+  else if (detachStatus == nativeCaptureStatus::busy)
+    error = std::string(label) + " has operations in flight.";
+  if (detachStatus != nativeCaptureStatus::success)
+    NAPI_THROW_ERROR(error.c_str());
+
+  // The object now reads as destroyed; its finalizer frees the empty handle.
+  napi_value zero;
+  status = napi_create_int32(env, 0, &zero);
+  if (status == napi_ok)
+    status = napi_set_named_property(env, thisValue, "embedded", zero);
+  if (status != napi_ok) {
+    destroy(value);
+    CHECK_STATUS;
+  }
+  return parkDetached(env, kind, value, destroy);
+}
+
+void destroyDetached() {
+  std::vector<parkedValue> values;
+  {
+    detachedRegistry &state = registry();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    for (auto &entry : state.parked)
+      values.push_back(entry.second);
+    state.parked.clear();
+  }
+  for (parkedValue &parked : values)
+    parked.destroy(parked.value);
+}
+
+napi_value adopt(napi_env env, napi_callback_info info) {
+  napi_status status;
+  size_t argc = 1;
+  napi_value args[1];
+  status = napi_get_cb_info(env, info, &argc, args, nullptr, nullptr);
+  CHECK_STATUS;
+
+  detachedKind kind;
+  uint32_t id;
+  if (argc < 1 || !readToken(env, args[0], &kind, &id))
+    NAPI_THROW_ERROR("Token must be an object returned by detach().");
+  parkedValue parked;
+  if (!claimDetached(id, kind, &parked))
+    NAPI_THROW_ERROR("Token has already been adopted or was released.");
+
+  napi_value result;
+  if (kind == detachedKind::framesync) {
+    status = makeFrameSyncObject(env, (framesyncWrapper *)parked.value,
+                                 &result);
+    CHECK_STATUS;
+    return result;
+  }
+  nativeHandle *handle = createNativeHandle(parked.value, parked.destroy);
+  if (handle == nullptr) {
+    parked.destroy(parked.value);
+    NAPI_THROW_ERROR("Failed to allocate adopted handle.");
+  }
+  if (kind == detachedKind::receiver)
+    status = makeReceiverObject(env, handle, &result);
+  else
+    status = makeSenderObject(env, handle, &result);
+  CHECK_STATUS;
+  return result;
+}
@@ -0,0 +1,47 @@
+/* Copyright 2025 Sarhan Aissi <github@tux.tn>.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+*/
+
+#ifndef GRANDI_TRANSFER_H
+#define GRANDI_TRANSFER_H
+
+#include <cstdint>
+
+#include "node_api.h"
+
+// Native instances detached from the environment that created them and
+// parked until another environment adopts them. Receivers, senders, and
+// framesyncs are tied to a napi_env only by the JavaScript object holding
+// them, so the instance, and the connection it keeps open, can move between
+// worker threads.
+enum class detachedKind { receiver, sender, framesync };
+
+// Parks value and returns the token object {kind, id} for it. destroy frees
+// value if it is never adopted. On failure destroys value, throws, and
+// returns nullptr.
+napi_value parkDetached(napi_env env, detachedKind kind, void *value,
+                        void (*destroy)(void *));
+// Shared detach() of objects whose "embedded" external is a nativeHandle.
+// label names the object in errors.
+napi_value detachHandleObject(napi_env env, napi_callback_info info,
+                              detachedKind kind, void (*destroy)(void *),
+                              const char *label);
+// Destroys every value still parked; called before the NDI runtime is torn
+// down.
+void destroyDetached();
+
+// Exposed as adopt(token).
+napi_value adopt(napi_env env, napi_callback_info info);
+
+#endif /* GRANDI_TRANSFER_H */
@@ -26,6 +26,8 @@
 #include <mutex>
 #include <Processing.NDI.Lib.h>
 #include "grandi_util.h"
+#include "grandi_alloc.h"
+#include "grandi_copy.h"
 #include "node_api.h"
 using namespace std;
 
@@ -236,15 +238,22 @@ bool readUtf8String(napi_env env, napi_value value,
   return c->status == napi_ok;
 }
 
-ownedBuffer::~ownedBuffer() { free(data); }
+ownedBuffer::~ownedBuffer() { releaseFrameMemory(data, token); }
 
 bool ownedBuffer::allocate(size_t length) {
-  free(data);
+  size_t capacity = frameMemoryCapacity(token);
+  if (data != nullptr && length > 0 && length <= capacity &&
+      length >= capacity / 2) {
+    size = length;
+    return true;
+  }
+  releaseFrameMemory(data, token);
   data = nullptr;
   size = 0;
+  token = 0;
   if (length == 0)
     return true;
-  data = malloc(length);
+  data = allocateFrameMemory(length, &token);
   if (data == nullptr)
     return false;
   size = length;
@@ -257,21 +266,32 @@ bool ownedBuffer::copyFrom(const void *source, size_t length) {
   if (!allocate(length))
     return false;
   if (length > 0)
-    memcpy(data, source, length);
+    copyFrameBytes(data, source, length);
   return true;
 }
 
-void finalizeOwnedBuffer(napi_env env, void *data, void *hint) { free(data); }
+void ownedBuffer::swap(ownedBuffer &other) {
+  std::swap(data, other.data);
+  std::swap(size, other.size);
+  std::swap(token, other.token);
+}
+
+// The hint carries the block's allocator token.
+void finalizeOwnedBuffer(napi_env env, void *data, void *hint) {
+  releaseFrameMemory(data, (uintptr_t)hint);
+}
 
 napi_status createExternalBuffer(napi_env env, ownedBuffer *buffer,
                                  napi_value *result) {
   if (buffer->size == 0)
     return napi_create_buffer(env, 0, nullptr, result);
   napi_status status = napi_create_external_buffer(
-      env, buffer->size, buffer->data, finalizeOwnedBuffer, nullptr, result);
+      env, buffer->size, buffer->data, finalizeOwnedBuffer,
+      (void *)buffer->token, result);
   if (status == napi_ok) {
     buffer->data = nullptr;
     buffer->size = 0;
+    buffer->token = 0;
   }
   return status;
 }
@@ -386,6 +406,22 @@ bool closeNativeHandle(nativeHandle *handle) {
   return hadValue;
 }
 
+nativeCaptureStatus detachNativeHandle(nativeHandle *handle, void **value) {
+  if (handle == nullptr)
+    return nativeCaptureStatus::destroyed;
+  std::lock_guard<std::mutex> lock(handle->mutex);
+  if (handle->closing || handle->value == nullptr)
+    return nativeCaptureStatus::destroyed;
+  if (handle->captureBound)
+    return nativeCaptureStatus::bound;
+  if (handle->active != 0)
+    return nativeCaptureStatus::busy;
+  *value = handle->value;
+  handle->value = nullptr;
+  handle->closing = true;
+  return nativeCaptureStatus::success;
+}
+
 void finalizeNativeHandle(napi_env env, void *data, void *hint) {
   nativeHandle *handle = (nativeHandle *)data;
   void *valueToDestroy = nullptr;
@@ -535,6 +571,83 @@ size_t videoDataSize(const NDIlib_video_frame_v2_t &frame) {
   }
 }
 
+napi_status createVideoFrameObject(napi_env env,
+                                   const NDIlib_video_frame_v2_t &frame,
+                                   const char *metadata, ownedBuffer *buffer,
+                                   napi_value *result) {
+  napi_value param;
+  napi_status status = napi_create_object(env, result);
+  PASS_STATUS;
+
+  status = napi_create_string_utf8(env, "video", NAPI_AUTO_LENGTH, &param);
+  PASS_STATUS;
+  status = napi_set_named_property(env, *result, "type", param);
+  PASS_STATUS;
+
+  status = napi_create_int32(env, frame.xres, &param);
+  PASS_STATUS;
+  status = napi_set_named_property(env, *result, "xres", param);
+  PASS_STATUS;
+
+  status = napi_create_int32(env, frame.yres, &param);
+  PASS_STATUS;
+  status = napi_set_named_property(env, *result, "yres", param);
+  PASS_STATUS;
+
+  status = napi_create_int32(env, frame.frame_rate_N, &param);
+  PASS_STATUS;
+  status = napi_set_named_property(env, *result, "frameRateN", param);
+  PASS_STATUS;
+
+  status = napi_create_int32(env, frame.frame_rate_D, &param);
+  PASS_STATUS;
+  status = napi_set_named_property(env, *result, "frameRateD", param);
+  PASS_STATUS;
+
+  status = napi_create_double(env, (double)frame.picture_aspect_ratio, &param);
+  PASS_STATUS;
+  status = napi_set_named_property(env, *result, "pictureAspectRatio", param);
+  PASS_STATUS;
+
+  if (frame.timestamp != NDIlib_recv_timestamp_undefined) {
+    status = napi_create_bigint_int64(env, frame.timestamp, &param);
+    PASS_STATUS;
+    status = napi_set_named_property(env, *result, "timestamp", param);
+    PASS_STATUS;
+  }
+
+  status = napi_create_int32(env, frame.FourCC, &param);
+  PASS_STATUS;
+  status = napi_set_named_property(env, *result, "fourCC", param);
+  PASS_STATUS;
+
+  status = napi_create_int32(env, frame.frame_format_type, &param);
+  PASS_STATUS;
+  status = napi_set_named_property(env, *result, "frameFormatType", param);
+  PASS_STATUS;
+
+  status = napi_create_bigint_int64(env, frame.timecode, &param);
+  PASS_STATUS;
+  status = napi_set_named_property(env, *result, "timecode", param);
+  PASS_STATUS;
+
+  status = napi_create_int32(env, frame.line_stride_in_bytes, &param);
+  PASS_STATUS;
+  status = napi_set_named_property(env, *result, "lineStrideBytes", param);
+  PASS_STATUS;
+
+  if (metadata != nullptr) {
+    status = napi_create_string_utf8(env, metadata, NAPI_AUTO_LENGTH, &param);
+    PASS_STATUS;
+    status = napi_set_named_property(env, *result, "metadata", param);
+    PASS_STATUS;
+  }
+
+  status = createExternalBuffer(env, buffer, &param);
+  PASS_STATUS;
+  return napi_set_named_property(env, *result, "data", param);
+}
+
 // Make a native source object from components of a source object
 napi_status makeNativeSource(napi_env env, napi_value source,
                              nativeSource *result) {
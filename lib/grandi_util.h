@@ -17,6 +17,7 @@
 #define GRANDI_UTIL_H
 
 #include <chrono>
+#include <cstdint>
 #include <memory>
 #include <mutex>
 #include <new>
@@ -102,13 +103,18 @@ template <typename T> T *createCarrier(napi_env env) {
 bool readUtf8String(napi_env env, napi_value value,
                     std::unique_ptr<char[]> *result, carrier *c);
 
+// Frame-sized buffer from allocateFrameMemory(). allocate() keeps the
+// current block when it is large enough and at most twice the length.
 struct ownedBuffer {
   void *data = nullptr;
   size_t size = 0;
+  // Passed to releaseFrameMemory() with data.
+  uintptr_t token = 0;
   ownedBuffer() = default;
   ~ownedBuffer();
   bool allocate(size_t length);
   bool copyFrom(const void *source, size_t length);
+  void swap(ownedBuffer &other);
   ownedBuffer(const ownedBuffer &) = delete;
   ownedBuffer &operator=(const ownedBuffer &) = delete;
 };
@@ -141,6 +147,10 @@ nativeCaptureStatus bindNativeCaptureHandle(nativeHandle *handle, void **value);
 void releaseNativeCaptureBinding(nativeHandle *handle);
 void releaseNativeHandle(nativeHandle *handle);
 bool closeNativeHandle(nativeHandle *handle);
+// Takes the value out of handle for another owner, leaving the handle
+// closed as if destroyed. Fails with bound or busy while a native consumer
+// or an operation holds the value.
+nativeCaptureStatus detachNativeHandle(nativeHandle *handle, void **value);
 void finalizeNativeHandle(napi_env env, void *data, void *hint);
 struct nativeHandleGuard {
   nativeHandle *handle;
@@ -196,6 +206,12 @@ napi_status parseUint32Value(napi_env env, napi_value value,
                              std::string *error);
 
 size_t videoDataSize(const NDIlib_video_frame_v2_t &frame);
+// Builds a received video frame object. Pixel data is taken from buffer and
+// metadata may be null; frame.p_data and frame.p_metadata are not read.
+napi_status createVideoFrameObject(napi_env env,
+                                   const NDIlib_video_frame_v2_t &frame,
+                                   const char *metadata, ownedBuffer *buffer,
+                                   napi_value *result);
 
 struct nativeSource {
   NDIlib_source_t value{};
@@ -0,0 +1,184 @@
+import process from "node:process";
+import grandi from "../dist/index.mjs";
+
+// Matches the receive-side detectors: a white picture after dark ones is a
+// flash, and an onset on the first audio channel is a beep.
+const BLACK = [0x80, 0x10];
+const WHITE = [0x80, 0xeb];
+const SAMPLE_RATE = 48_000;
+const BEEP_HZ = 1000;
+const BEEP_LEVEL = 0.5;
+const BEEP_STEP = (2 * Math.PI * BEEP_HZ) / SAMPLE_RATE;
+
+function parseArgs(argv) {
+	const args = {
+		name: "grandi-avsync-pattern",
+		durationSec: 0,
+		width: 1280,
+		height: 720,
+		fps: 30,
+		intervalMs: 2000,
+		flashMs: 100,
+		beepMs: 100,
+		videoDelayMs: 0,
+	};
+	const numbers = {
+		"--duration": "durationSec",
+		"--width": "width",
+		"--height": "height",
+		"--fps": "fps",
+		"--interval": "intervalMs",
+		"--flash": "flashMs",
+		"--beep": "beepMs",
+		"--video-delay": "videoDelayMs",
+	};
+
+	for (let i = 0; i < argv.length; i += 1) {
+		const token = argv[i];
+		if (token === "--") continue;
+		if (token === "--help" || token === "-h") {
+			args.help = true;
+			continue;
+		}
+		if (token === "--name") {
+			args.name = String(argv[i + 1]);
+			i += 1;
+			continue;
+		}
+		if (token in numbers) {
+			args[numbers[token]] = Number(argv[i + 1]);
+			i += 1;
+			continue;
+		}
+		throw new Error(`Unknown argument: ${token}`);
+	}
+	return args;
+}
+
+function printHelp() {
+	console.log(`grandi A/V sync test pattern
+
+Usage:
+  node scripts/avsync-pattern.mjs [--name grandi-avsync-pattern] [--duration 0]
+  node scripts/avsync-pattern.mjs ... [--width 1280] [--height 720] [--fps 30]
+  node scripts/avsync-pattern.mjs ... [--interval 2000]
+  node scripts/avsync-pattern.mjs ... [--flash 100] [--beep 100]
+  node scripts/avsync-pattern.mjs ... [--video-delay 0]
+
+Sends a dark picture and silence, with a white flash and a ${BEEP_HZ} Hz beep
+every --interval ms. Receive it with avSync: { testPattern: true } and read
+avSync().testPattern.
+
+Options:
+  --duration     Seconds to run. 0 runs until interrupted.
+  --flash        Milliseconds each flash stays white.
+  --beep         Milliseconds each beep lasts.
+  --video-delay  Shows each flash this many milliseconds after its beep, so
+                 testPattern.offsetMs should read about this value. Negative
+                 values show the flash first.
+`);
+}
+
+function fillPicture(buffer, [chroma, luma]) {
+	for (let i = 0; i < buffer.length; i += 2) {
+		buffer[i] = chroma;
+		buffer[i + 1] = luma;
+	}
+	return buffer;
+}
+
+function phaseMs(timeMs, intervalMs) {
+	return ((timeMs % intervalMs) + intervalMs) % intervalMs;
+}
+
+async function main() {
+	const args = parseArgs(process.argv.slice(2));
+	if (args.help) {
+		printHelp();
+		return;
+	}
+	if (!(args.intervalMs > Math.max(args.flashMs, args.beepMs))) {
+		throw new Error("--interval must be longer than --flash and --beep.");
+	}
+	if (!grandi.initialize()) {
+		throw new Error("Failed to initialize NDI.");
+	}
+
+	const sender = await grandi.send({
+		name: args.name,
+		clockVideo: true,
+		clockAudio: false,
+	});
+	const strideBytes = args.width * 2;
+	const dark = fillPicture(Buffer.alloc(strideBytes * args.height), BLACK);
+	const white = fillPicture(Buffer.alloc(strideBytes * args.height), WHITE);
+	const samplesPerFrame = Math.round(SAMPLE_RATE / args.fps);
+	const audioBuffer = Buffer.alloc(samplesPerFrame * 2 * 4);
+	const channels = [0, 1].map(
+		(channel) =>
+			new Float32Array(
+				audioBuffer.buffer,
+				audioBuffer.byteOffset + channel * samplesPerFrame * 4,
+				samplesPerFrame,
+			),
+	);
+	const videoFrame = {
+		type: "video",
+		xres: args.width,
+		yres: args.height,
+		frameRateN: args.fps,
+		frameRateD: 1,
+		pictureAspectRatio: args.width / args.height,
+		fourCC: grandi.FOURCC_UYVY,
+		frameFormatType: grandi.FrameType.Progressive,
+		lineStrideBytes: strideBytes,
+		data: dark,
+	};
+	const audioFrame = {
+		type: "audio",
+		sampleRate: SAMPLE_RATE,
+		channels: 2,
+		samples: samplesPerFrame,
+		channelStrideBytes: samplesPerFrame * 4,
+		data: audioBuffer,
+		fourCC: grandi.FOURCC_FLTp,
+	};
+
+	let running = true;
+	process.once("SIGINT", () => {
+		running = false;
+	});
+	const frames =
+		args.durationSec > 0 ? Math.ceil(args.durationSec * args.fps) : Infinity;
+	console.log(`Sending "${args.name}". Press Ctrl+C to stop.`);
+
+	try {
+		let sample = 0;
+		for (let frame = 0; running && frame < frames; frame += 1) {
+			// The audio for each frame covers the same span of time, so the
+			// flash and beep share one timeline shifted by --video-delay.
+			const frameMs = (frame * 1000) / args.fps;
+			const flashPhase = phaseMs(frameMs - args.videoDelayMs, args.intervalMs);
+			videoFrame.data = flashPhase < args.flashMs ? white : dark;
+			for (let i = 0; i < samplesPerFrame; i += 1, sample += 1) {
+				const sampleMs = (sample * 1000) / SAMPLE_RATE;
+				const level =
+					phaseMs(sampleMs, args.intervalMs) < args.beepMs
+						? BEEP_LEVEL * Math.sin(BEEP_STEP * sample)
+						: 0;
+				channels[0][i] = level;
+				channels[1][i] = level;
+			}
+			await sender.audio(audioFrame);
+			await sender.video(videoFrame);
+		}
+	} finally {
+		sender.destroy();
+		grandi.destroy();
+	}
+}
+
+main().catch((error) => {
+	console.error(error);
+	process.exitCode = 1;
+});
@@ -24,6 +24,9 @@ function parseArgs(argv) {
 		color: true,
 		framesync: false,
 		gcEveryMs: 500,
+		quality: false,
+		match: "id", // id | timecode
+		copy: false,
 	};
 
 	for (let i = 0; i < argv.length; i += 1) {
@@ -70,6 +73,19 @@ function parseArgs(argv) {
 			args.framesync = true;
 			continue;
 		}
+		if (token === "--quality") {
+			args.quality = true;
+			continue;
+		}
+		if (token === "--copy") {
+			args.copy = true;
+			continue;
+		}
+		if (token === "--match") {
+			args.match = String(argv[i + 1]);
+			i += 1;
+			continue;
+		}
 		if (token === "--gc-every") {
 			args.gcEveryMs = Number(argv[i + 1]);
 			i += 1;
@@ -128,12 +144,134 @@ function summarizeLatencies(latenciesMs, count) {
 	};
 }
 
+function summarizeQuality(values, count) {
+	if (count === 0) return { count: 0 };
+	let sum = 0;
+	let min = Number.POSITIVE_INFINITY;
+	for (let i = 0; i < count; i++) {
+		sum += values[i];
+		if (values[i] < min) min = values[i];
+	}
+	return { count, avg: sum / count, min };
+}
+
+// Deterministic UYVY test patterns, so a received frame can be scored
+// against the exact frame that was sent: a moving luma ramp, color bars, and
+// a block of pseudo-random noise per pattern.
+function createPatterns(width, height, count) {
+	const stride = width * 2;
+	const patterns = [];
+	const bars = [
+		[128, 128],
+		[44, 136],
+		[156, 44],
+		[72, 58],
+		[184, 198],
+		[100, 212],
+		[212, 114],
+	];
+	for (let k = 0; k < count; k++) {
+		const data = Buffer.allocUnsafe(stride * height);
+		let seed = 0x9e3779b9 ^ (k * 0x85ebca6b);
+		for (let y = 0; y < height; y++) {
+			const line = y * stride;
+			const band = Math.floor((y * 3) / height);
+			for (let x = 0; x < width; x += 2) {
+				let u;
+				let v;
+				let y0;
+				let y1;
+				if (band === 0) {
+					[u, v] = bars[Math.floor((x * bars.length) / width)];
+					y0 = y1 = 180;
+				} else if (band === 1) {
+					u = v = 128;
+					y0 = 16 + (((x + k * 32) * 219) / width) % 219;
+					y1 = 16 + (((x + 1 + k * 32) * 219) / width) % 219;
+				} else {
+					seed = (Math.imul(seed, 1664525) + 1013904223) >>> 0;
+					u = 16 + (seed >>> 24) % 225;
+					v = 16 + ((seed >>> 16) & 0xff) % 225;
+					y0 = 16 + ((seed >>> 8) & 0xff) % 220;
+					y1 = 16 + (seed & 0xff) % 220;
+				}
+				const offset = line + x * 2;
+				data[offset] = u;
+				data[offset + 1] = y0;
+				data[offset + 2] = v;
+				data[offset + 3] = y1;
+			}
+		}
+		patterns.push(data);
+	}
+	return patterns;
+}
+
 function formatBandwidth(bytesPerSecond) {
 	const megaBytesPerSecond = bytesPerSecond / 1e6;
 	const megaBitsPerSecond = (bytesPerSecond * 8) / 1e6;
 	return `${megaBytesPerSecond.toFixed(1)} MB/s (${megaBitsPerSecond.toFixed(1)} Mb/s)`;
 }
 
+// Times copyBuffer() with cached and streaming stores from 64 KiB to 256 MiB.
+// Each size copies about 128 MiB per mode in five alternating rounds and keeps
+// the best round, then the crossover is the smallest size from which
+// streaming is at least as fast and never falls more than 5% behind.
+function runCopyBenchmark(c) {
+	const strategy = grandi.copyStrategy();
+	console.log(c.bold("Copy strategies"));
+	if (!strategy.streamingStores) {
+		console.log(c.yellow("  Streaming stores are not available on this build."));
+	}
+	console.log(c.dim("  size        cached     streaming"));
+	const rows = [];
+	try {
+		for (let size = 64 << 10; size <= 256 << 20; size *= 2) {
+			const source = Buffer.alloc(size, 0x5a);
+			const target = Buffer.alloc(size);
+			const iterations = Math.max(2, Math.floor((128 << 20) / size));
+			const rates = { cached: 0, streaming: 0 };
+			for (let round = 0; round < 5; round++) {
+				for (const mode of ["cached", "streaming"]) {
+					grandi.setCopyStrategy({ mode });
+					grandi.copyBuffer(target, source);
+					const started = hrtimeNs();
+					for (let i = 0; i < iterations; i++) {
+						grandi.copyBuffer(target, source);
+					}
+					const rate =
+						(size * iterations) / (toMs(hrtimeNs() - started) / 1e3);
+					rates[mode] = Math.max(rates[mode], rate);
+				}
+			}
+			rows.push({ size, ...rates });
+			const label = size >= 1 << 20 ? `${size >> 20} MiB` : `${size >> 10} KiB`;
+			const faster = rates.streaming > rates.cached ? c.green : c.gray;
+			console.log(
+				`  ${label.padEnd(10)}  ${(rates.cached / 1e9).toFixed(2).padStart(6)} GB/s  ${faster(`${(rates.streaming / 1e9).toFixed(2).padStart(6)} GB/s`)}`,
+			);
+		}
+	} finally {
+		grandi.setCopyStrategy(strategy);
+	}
+
+	let crossover;
+	for (let i = rows.length - 1; i >= 0; i--) {
+		if (rows[i].streaming < rows[i].cached * 0.95) break;
+		if (rows[i].streaming >= rows[i].cached) crossover = rows[i].size;
+	}
+	if (crossover === undefined) {
+		console.log("  Streaming did not stay faster at any measured size.");
+	} else {
+		console.log(
+			`  Streaming stays faster from ${crossover} bytes. Apply it with setCopyStrategy({ threshold: ${crossover} }).`,
+		);
+	}
+	console.log(
+		c.dim(`  Current strategy: ${strategy.mode}, threshold ${strategy.threshold} bytes.`),
+	);
+}
+
 async function waitForSourceByName(grandi, name, timeoutMs = 15_000) {
 	const finder = await grandi.find({ showLocalSources: true });
 	const deadline = Date.now() + timeoutMs;
@@ -159,11 +297,25 @@ Usage:
   node scripts/benchmark.mjs [--duration 5] [--fps 30] [--width 1920] [--height 1080] [--mode realtime|throughput] [--no-audio] [--no-color]
   node scripts/benchmark.mjs ... [--framesync]
   node scripts/benchmark.mjs ... [--gc-every 500]
+  node scripts/benchmark.mjs ... [--quality] [--match id|timecode]
+  node scripts/benchmark.mjs --copy
 
 Modes:
   realtime   Attempts to run at the requested FPS (sender clocking enabled).
   throughput Sends as fast as possible (sender clocking disabled).
 
+Quality:
+  --quality  Sends rotating test patterns and scores received frames against
+             the pattern that was sent (PSNR and SSIM, at most one comparison
+             in flight).
+  --match    Identifies sent frames by an id in the frame metadata (id) or by
+             a frame-numbered timecode (timecode). Defaults to id.
+
+Copy:
+  --copy     Times frame copies with cached and streaming (non-temporal)
+             stores from 64 KiB to 256 MiB and reports the crossover. Does
+             not use the network.
+
 Notes:
   - Requires a working local NDI environment.
   - Creates a sender + receiver on the same machine.
@@ -181,6 +333,15 @@ async function main() {
 		return;
 	}
 
+	if (args.copy) {
+		runCopyBenchmark(c);
+		return;
+	}
+
+	if (args.match !== "id" && args.match !== "timecode") {
+		throw new Error("--match must be id or timecode.");
+	}
+
 	if (!grandi.isSupportedCPU()) {
 		throw new Error("NDI not supported on this CPU/platform.");
 	}
@@ -207,7 +368,10 @@ async function main() {
 		receiver = await grandi.receive({
 			source,
 			name: `${senderName}-receiver`,
-			colorFormat: grandi.ColorFormat.Fastest,
+			// Quality mode compares UYVY with UYVY, so the color format is fixed.
+			colorFormat: args.quality
+				? grandi.ColorFormat.UYVY_BGRA
+				: grandi.ColorFormat.Fastest,
 		});
 		if (args.framesync) {
 			fs = await grandi.framesync(receiver);
@@ -218,6 +382,11 @@ async function main() {
 		const videoPayloadBytes = videoStrideBytes * args.height;
 		const videoBuffer = Buffer.allocUnsafe(videoPayloadBytes);
 		videoBuffer.fill(0xaa);
+		const patternCount = 8;
+		const patterns = args.quality
+			? createPatterns(args.width, args.height, patternCount)
+			: [];
+		const timecodeRate = { frameRateN: args.fps, frameRateD: 1 };
 		const samplesPerFrame = Math.floor(48_000 / args.fps);
 		const audioBuffer = Buffer.allocUnsafe(samplesPerFrame * 2 * 4);
 		audioBuffer.fill(0);
@@ -269,10 +438,58 @@ async function main() {
 		let recvAudioBytes = 0;
 		const maxLatencySamples = 50_000;
 		const videoLatenciesMs = new Float64Array(maxLatencySamples);
-		const monotonicToUnixNs = BigInt(Date.now()) * 1_000_000n - hrtimeNs();
 		let videoLatencyCount = 0;
 		const gcState = { lastGcMs: 0, gcEveryMs: args.gcEveryMs };
 
+		const maxQualitySamples = 50_000;
+		const psnrValues = new Float64Array(maxQualitySamples);
+		const ssimValues = new Float64Array(maxQualitySamples);
+		let qualityCount = 0;
+		let psnrCount = 0;
+		let qualitySkipped = 0;
+		let qualityUnmatched = 0;
+		let framesIdentified = 0;
+		let comparing = null;
+
+		// Returns the id of the sent frame a received frame carries, or -1.
+		const frameId = (frame) => {
+			if (args.match === "timecode") {
+				if (frame.timecode === undefined) return -1;
+				return Math.round((Number(frame.timecode) * args.fps) / 1e7);
+			}
+			const match = /<grandi_bench frame="(\d+)"/.exec(frame.metadata ?? "");
+			return match ? Number(match[1]) : -1;
+		};
+
+		const scoreFrame = (frame) => {
+			const id = frameId(frame);
+			if (id < 0 || id >= framesIdentified) {
+				qualityUnmatched += 1;
+				return;
+			}
+			if (comparing || qualityCount >= maxQualitySamples) {
+				qualitySkipped += 1;
+				return;
+			}
+			const reference = { ...videoFrame, data: patterns[id % patternCount] };
+			comparing = grandi
+				.compareFrames(reference, frame)
+				.then((quality) => {
+					// Identical frames have infinite PSNR and are counted apart.
+					if (quality.psnr !== Number.POSITIVE_INFINITY) {
+						psnrValues[psnrCount++] = quality.psnr;
+					}
+					ssimValues[qualityCount] = quality.ssim ?? 1;
+					qualityCount += 1;
+				})
+				.catch(() => {
+					qualityUnmatched += 1;
+				})
+				.finally(() => {
+					comparing = null;
+				});
+		};
+
 		const controller = { running: true };
 
 		const senderTask = (async () => {
@@ -292,7 +509,16 @@ async function main() {
 					}
 				}
 
-				const frameTimecode = firstFrame ? 0n : grandi.TIMECODE_SYNTHESIZE;
+				let frameTimecode = firstFrame ? 0n : grandi.TIMECODE_SYNTHESIZE;
+				if (args.quality) {
+					const id = framesIdentified++;
+					videoFrame.data = patterns[id % patternCount];
+					if (args.match === "timecode") {
+						frameTimecode = grandi.frameTimecode(id, timecodeRate);
+					} else {
+						videoFrame.metadata = `<grandi_bench frame="${id}"/>`;
+					}
+				}
 				videoFrame.timecode = frameTimecode;
 				audioFrame.timecode = frameTimecode;
 
@@ -352,13 +578,13 @@ async function main() {
 						frame.timestamp !== undefined &&
 						videoLatencyCount < maxLatencySamples
 					) {
-						const receivedAtUnixNs = hrtimeNs() + monotonicToUnixNs;
-						const submittedAtUnixNs = frame.timestamp * 100n;
-						const latencyNs = receivedAtUnixNs - submittedAtUnixNs;
+						const submittedAtNs = grandi.clock.toMonotonic(frame.timestamp);
+						const latencyNs = hrtimeNs() - submittedAtNs;
 						if (latencyNs >= 0n) {
 							videoLatenciesMs[videoLatencyCount++] = Number(latencyNs) / 1e6;
 						}
 					}
+					if (args.quality) scoreFrame(frame);
 				} else if (!args.framesync && args.audio && frame.type === "audio") {
 					recvAudioCount += 1;
 					recvAudioBytes += frame.data.length;
@@ -379,6 +605,7 @@ async function main() {
 		await Promise.race([senderTask, receiverTask, sleep(durationMs)]);
 		controller.running = false;
 		await Promise.allSettled([senderTask, receiverTask]);
+		await comparing;
 
 		const elapsedMs = Date.now() - startedAtMs;
 		const sendVideoAvgMs = sendVideoCount
@@ -446,6 +673,29 @@ async function main() {
 				`${c.bold("- video latency:")} ${c.dim("no samples (no video frames received)")}`,
 			);
 		}
+		if (args.quality) {
+			const psnr = summarizeQuality(psnrValues, psnrCount);
+			const ssim = summarizeQuality(ssimValues, qualityCount);
+			const psnrText = psnr.count
+				? `psnr avg=${c.yellow(`${psnr.avg.toFixed(2)}dB`)} ` +
+					`min=${c.yellow(`${psnr.min.toFixed(2)}dB`)} `
+				: `psnr=${c.yellow("lossless")} `;
+			const ssimText = ssim.count
+				? `ssim avg=${c.yellow(ssim.avg.toFixed(4))} ` +
+					`min=${c.yellow(ssim.min.toFixed(4))} `
+				: "";
+			console.log(
+				`${c.bold("- video quality:")} ` +
+					psnrText +
+					ssimText +
+					`compared=${c.green(qualityCount)} ` +
+					`${c.gray(
+						`(identical=${qualityCount - psnrCount}, ` +
+							`skipped=${qualitySkipped}, ` +
+							`unmatched=${qualityUnmatched}, match=${args.match})`,
+					)}`,
+			);
+		}
 	} finally {
 		try {
 			fs?.destroy();
@@ -1,17 +1,57 @@
 import path from "node:path";
 import nodeGypBuild from "node-gyp-build";
 import platformTargets from "./platforms.json" with { type: "json" };
+import { createReceiverPool, openFrameChannel } from "./receiverPool.js";
 
 import type {
+	Clock,
+	ClockSourceEstimate,
+	CompareFramesOptions,
+	CopyStrategy,
+	CopyStrategyOptions,
+	DetachedFrameSync,
+	DetachedHandle,
+	DetachedReceiver,
+	DetachedSender,
 	Finder,
 	FindOptions,
+	FrameAllocator,
+	FrameAllocatorOptions,
+	FrameAllocatorStats,
+	FrameBudget,
+	FrameBudgetOptions,
+	FrameBudgetStats,
 	FrameSync,
+	FrameHashAlgorithm,
+	FramePipe,
+	FrameQuality,
+	FrameSyncOptions,
 	Grandi,
+	Multiviewer,
+	MultiviewerOptions,
+	OpenRecordingOptions,
+	PipeOptions,
+	PublishShmOptions,
 	ReceiveOptions,
 	Receiver,
+	ReceiverPool,
+	ReceiverPoolOptions,
+	Recorder,
+	Recording,
+	RecordOptions,
 	Routing,
 	Sender,
 	SendOptions,
+	SendShmOptions,
+	ShmPublisher,
+	ShmSender,
+	SyncGroup,
+	SyncGroupOptions,
+	ThreadInfo,
+	ThreadScheduling,
+	Timecode,
+	TimecodeOptions,
+	VideoFrame,
 } from "./types.js";
 import {
 	AudioFormat,
@@ -58,6 +98,25 @@ function tryRequireArchPackage(): GrandiAddon | null {
 	}
 }
 
+/**
+ * Path of the addon file a worker thread should load: the local build, or
+ * else the prebuilt package for this platform.
+ */
+function resolveAddonPath(): string {
+	try {
+		const local = nodeGypBuild.path?.(path.join(__dirname, ".."));
+		if (local) return local;
+	} catch {
+		// No local build; fall back to the prebuilt package.
+	}
+	const target = currentPlatformTarget();
+	if (!target)
+		throw new Error(
+			`Unsupported platform or architecture: ${process.platform}-${process.arch}`,
+		);
+	return require.resolve(target.packageName);
+}
+
 function loadAddon(): GrandiAddon {
 	const loadErrors: Error[] = [];
 	if (!isSupportedPlatform()) {
@@ -116,9 +175,42 @@ export interface GrandiAddon {
 	destroy(): boolean;
 	find(params?: FindOptions): Promise<Finder>;
 	receive(params: ReceiveOptions): Promise<Receiver>;
-	framesync(receiver: Receiver): Promise<FrameSync>;
+	framesync(receiver: Receiver, options?: FrameSyncOptions): Promise<FrameSync>;
 	send(params: SendOptions): Promise<Sender>;
 	routing(params: { name?: string; groups?: string }): Promise<Routing>;
+	syncGroup(params: SyncGroupOptions): Promise<SyncGroup>;
+	multiviewer(params: MultiviewerOptions): Promise<Multiviewer>;
+	publishShm(params: PublishShmOptions): Promise<ShmPublisher>;
+	sendShm(params: SendShmOptions): Promise<ShmSender>;
+	pipe(params: PipeOptions): Promise<FramePipe>;
+	record(params: RecordOptions): Promise<Recorder>;
+	openRecording(params: OpenRecordingOptions): Promise<Recording>;
+	clockNow(): bigint;
+	clockToMonotonic(timestamp: bigint, source?: string): bigint;
+	clockSources(): ClockSourceEstimate[];
+	splitFields(frame: VideoFrame): [VideoFrame, VideoFrame];
+	weaveFields(field0: VideoFrame, field1: VideoFrame): VideoFrame;
+	formatTimecode(timecode: Timecode, options: TimecodeOptions): string;
+	frameTimecode(frame: number, options: TimecodeOptions): Timecode;
+	compareFrames(
+		reference: VideoFrame,
+		test: VideoFrame,
+		options?: CompareFramesOptions,
+	): Promise<FrameQuality>;
+	hashFrame(frame: VideoFrame, algorithm?: FrameHashAlgorithm): string;
+	workerThreads(): number;
+	setWorkerThreads(threads: number, scheduling?: ThreadScheduling): void;
+	copyStrategy(): CopyStrategy;
+	setCopyStrategy(options: CopyStrategyOptions): void;
+	copyBuffer(target: Buffer, source: Buffer): void;
+	frameAllocator(): FrameAllocator;
+	setFrameAllocator(options: FrameAllocatorOptions): void;
+	frameAllocatorStats(): FrameAllocatorStats;
+	frameBudget(): FrameBudget;
+	setFrameBudget(options: FrameBudgetOptions): void;
+	frameBudgetStats(): FrameBudgetStats;
+	threadTopology(): ThreadInfo[];
+	adopt(token: DetachedHandle): Receiver | Sender | FrameSync;
 }
 
 const noopAddon: GrandiAddon = {
@@ -146,9 +238,99 @@ const noopAddon: GrandiAddon = {
 	routing() {
 		return Promise.reject(new Error("Unsupported platform or CPU"));
 	},
+	syncGroup(_params) {
+		return Promise.reject(new Error("Unsupported platform or CPU"));
+	},
+	multiviewer(_params) {
+		return Promise.reject(new Error("Unsupported platform or CPU"));
+	},
+	publishShm(_params) {
+		return Promise.reject(new Error("Unsupported platform or CPU"));
+	},
+	sendShm(_params) {
+		return Promise.reject(new Error("Unsupported platform or CPU"));
+	},
+	pipe(_params) {
+		return Promise.reject(new Error("Unsupported platform or CPU"));
+	},
+	record(_params) {
+		return Promise.reject(new Error("Unsupported platform or CPU"));
+	},
+	openRecording(_params) {
+		return Promise.reject(new Error("Unsupported platform or CPU"));
+	},
 	find(_params) {
 		return Promise.reject(new Error("Unsupported platform or CPU"));
 	},
+	// Without the addon the clock falls back to the wall clock alone.
+	clockNow() {
+		return BigInt(Date.now()) * 10_000n;
+	},
+	clockToMonotonic(timestamp) {
+		const wallToMonotonicNs =
+			process.hrtime.bigint() - BigInt(Date.now()) * 1_000_000n;
+		return timestamp * 100n + wallToMonotonicNs;
+	},
+	clockSources() {
+		return [];
+	},
+	splitFields(_frame) {
+		throw new Error("Unsupported platform or CPU");
+	},
+	weaveFields(_field0, _field1) {
+		throw new Error("Unsupported platform or CPU");
+	},
+	formatTimecode(_timecode, _options) {
+		throw new Error("Unsupported platform or CPU");
+	},
+	frameTimecode(_frame, _options) {
+		throw new Error("Unsupported platform or CPU");
+	},
+	compareFrames(_reference, _test, _options) {
+		return Promise.reject(new Error("Unsupported platform or CPU"));
+	},
+	hashFrame(_frame, _algorithm) {
+		throw new Error("Unsupported platform or CPU");
+	},
+	workerThreads() {
+		throw new Error("Unsupported platform or CPU");
+	},
+	setWorkerThreads(_threads, _scheduling) {
+		throw new Error("Unsupported platform or CPU");
+	},
+	copyStrategy() {
+		throw new Error("Unsupported platform or CPU");
+	},
+	setCopyStrategy(_options) {
+		throw new Error("Unsupported platform or CPU");
+	},
+	copyBuffer(_target, _source) {
+		throw new Error("Unsupported platform or CPU");
+	},
+	frameAllocator() {
+		throw new Error("Unsupported platform or CPU");
+	},
+	setFrameAllocator(_options) {
+		throw new Error("Unsupported platform or CPU");
+	},
+	frameAllocatorStats() {
+		throw new Error("Unsupported platform or CPU");
+	},
+	frameBudget() {
+		throw new Error("Unsupported platform or CPU");
+	},
+	setFrameBudget(_options) {
+		throw new Error("Unsupported platform or CPU");
+	},
+	frameBudgetStats() {
+		throw new Error("Unsupported platform or CPU");
+	},
+	threadTopology() {
+		throw new Error("Unsupported platform or CPU");
+	},
+	adopt(_token) {
+		throw new Error("Unsupported platform or CPU");
+	},
 };
 
 const addon: GrandiAddon = loadAddon();
@@ -235,7 +417,9 @@ export const destroy = addon.destroy;
  * ```
  */
 export async function send(params: SendOptions): Promise<Sender> {
-	const native = await addon.send(params);
+	return wrapSender(await addon.send(params));
+}
+function wrapSender(native: Sender): Sender {
 	Object.defineProperty(native, "sourceName", {
 		configurable: true,
 		value: native.sourcename,
@@ -289,6 +473,229 @@ export const receive = addon.receive;
 export const frameSync = addon.framesync;
 /** @deprecated Use `frameSync` instead. */
 export const framesync = addon.framesync;
+/**
+ * Creates a sync group that delivers time-aligned video frames from several receivers.
+ * @param {SyncGroupOptions} params - Options for the sync group.
+ * @param {Receiver[]} params.receivers - Receivers to align; each is bound until the group is destroyed.
+ * @param {number} [params.toleranceMs] - Largest timestamp difference within a set.
+ * @param {number} [params.bufferMs] - How long a frame waits for the other members.
+ * @param {SyncGroupOptions["callback"]} params.callback - Receives each aligned set.
+ * @returns {Promise<SyncGroup>} A promise that resolves to a running SyncGroup.
+ * @throws {Error} Promise rejects on unsupported platform/CPU, invalid options, or an already bound receiver.
+ */
+export const syncGroup = addon.syncGroup;
+/**
+ * Creates a multiviewer that tiles several receivers into one NDI source.
+ * @param {MultiviewerOptions} params - Canvas, output, and tile options.
+ * @param {MultiviewerTile[]} params.tiles - Receivers and their tile rectangles; each receiver is bound until the multiviewer is destroyed.
+ * @returns {Promise<Multiviewer>} A promise that resolves to a running Multiviewer.
+ * @throws {Error} Promise rejects on unsupported platform/CPU, invalid options, or an already bound receiver.
+ */
+export const multiviewer = addon.multiviewer;
+/**
+ * Publishes the video of a receiver into a POSIX shared-memory frame ring.
+ * @param {PublishShmOptions} params - Receiver, ring name, and ring size.
+ * @param {Receiver} params.receiver - Receiver to publish; bound until the publisher is destroyed.
+ * @returns {Promise<ShmPublisher>} A promise that resolves to a running ShmPublisher.
+ * @throws {Error} Promise rejects on Windows, unsupported platform/CPU, invalid options, an existing ring, or an already bound receiver.
+ */
+export const publishShm = addon.publishShm;
+/**
+ * Sends the video frames another process writes into a POSIX shared-memory ring.
+ * @param {SendShmOptions} params - Sender and ring name.
+ * @param {Sender} params.sender - Sender to feed; its video() is unavailable until the input is destroyed.
+ * @returns {Promise<ShmSender>} A promise that resolves to a running ShmSender.
+ * @throws {Error} Promise rejects on Windows, unsupported platform/CPU, a missing, closed, or malformed ring, or an already bound sender.
+ */
+export const sendShm = addon.sendShm;
+/**
+ * Streams the frames of a receiver into a file descriptor as NUT, YUV4MPEG2, or raw video.
+ * @param {PipeOptions} params - Receiver, file descriptor, and container.
+ * @param {Receiver} params.receiver - Receiver to stream; bound until the pipe is destroyed.
+ * @returns {Promise<FramePipe>} A promise that resolves to a running FramePipe.
+ * @throws {Error} Promise rejects on Windows, unsupported platform/CPU, invalid options, a descriptor that is not open for writing, or an already bound receiver.
+ */
+export const pipe = addon.pipe;
+/**
+ * Records the frames of a receiver into an LZ4-compressed file with an index.
+ * @param {RecordOptions} params - Receiver, path, compression, and thread count.
+ * @param {Receiver} params.receiver - Receiver to record; bound until the recorder is destroyed.
+ * @returns {Promise<Recorder>} A promise that resolves to a running Recorder.
+ * @throws {Error} Promise rejects on unsupported platform/CPU, invalid options, a path that exists or cannot be created, or an already bound receiver.
+ */
+export const record = addon.record;
+/**
+ * Opens a recording to seek by timestamp or timecode and read its frames.
+ * @param {OpenRecordingOptions} params - Path of the recording.
+ * @returns {Promise<Recording>} A promise that resolves to an open Recording.
+ * @throws {Error} Promise rejects on Windows, unsupported platform/CPU, or a missing or malformed recording or index.
+ */
+export const openRecording = addon.openRecording;
+/**
+ * Correlates NDI timestamps with the local monotonic clock.
+ * `now()` returns the current NDI timestamp, `toMonotonic(ts, source?)` maps a
+ * timestamp to `process.hrtime.bigint()` nanoseconds, and `sources()` lists
+ * per-source offset and skew estimates.
+ */
+export const clock: Clock = {
+	now: addon.clockNow,
+	toMonotonic: addon.clockToMonotonic,
+	sources: addon.clockSources,
+};
+/**
+ * Splits a progressive or interlaced frame into field 0 and field 1 frames.
+ * @param {VideoFrame} frame - Frame with an even `yres`.
+ * @returns {[VideoFrame, VideoFrame]} The field 0 and field 1 frames.
+ * @throws {Error} If the format is 4:2:0 or the frame is invalid.
+ */
+export const splitFields = addon.splitFields;
+/**
+ * Weaves a field 0 and a field 1 frame into one interlaced frame.
+ * @param {VideoFrame} field0 - Field carrying the even lines.
+ * @param {VideoFrame} field1 - Field carrying the odd lines.
+ * @returns {VideoFrame} The interlaced frame.
+ * @throws {Error} If the fields do not share size, format, and stride.
+ */
+export const weaveFields = addon.weaveFields;
+/**
+ * Formats an NDI timecode as SMPTE timecode at a frame rate.
+ * @param {Timecode} timecode - NDI timecode in 100 ns units since midnight.
+ * @param {TimecodeOptions} options - Frame rate, and whether to drop frames.
+ * @returns {string} `"HH:MM:SS:FF"`, or `"HH:MM:SS;FF"` when dropping frames.
+ */
+export const formatTimecode = addon.formatTimecode;
+/**
+ * Gets the NDI timecode of a frame number counted from midnight.
+ * @param {number} frame - Non-negative frame number.
+ * @param {TimecodeOptions} options - Frame rate frames are numbered at.
+ * @returns {Timecode} The start time of the frame in 100 ns units.
+ */
+export const frameTimecode = addon.frameTimecode;
+/**
+ * Compares a test frame with a reference frame: MSE, PSNR, and SSIM.
+ * @param {VideoFrame} reference - Frame as sent.
+ * @param {VideoFrame} test - Frame to score against the reference.
+ * @param {CompareFramesOptions} [options] - Whether to compute SSIM.
+ * @returns {Promise<FrameQuality>} Per-channel and whole-frame quality.
+ */
+export const compareFrames = addon.compareFrames;
+/**
+ * Hashes the picture of a video frame, skipping line padding.
+ * @param {VideoFrame} frame - Frame to hash.
+ * @param {FrameHashAlgorithm} [algorithm] - `"xxh3"` (default) or `"sampled"`.
+ * @returns {string} Hex digest: 32 digits for xxh3, 16 for sampled.
+ */
+export const hashFrame = addon.hashFrame;
+/**
+ * Returns how many threads, the caller included, split large frames into
+ * row stripes for scaling, analysis, deinterlacing, and copies.
+ * @returns {number} Thread count of the shared pool.
+ */
+export const workerThreads = addon.workerThreads;
+/**
+ * Resizes the shared pool that splits large frames into row stripes.
+ * @param {number} threads - Threads to use, the caller included, from 1 to 256.
+ * @param {ThreadScheduling} [scheduling] - CPUs, nice value, or SCHED_FIFO
+ * priority of the pool threads.
+ * @throws {Error} If threads or scheduling is invalid.
+ */
+export const setWorkerThreads = addon.setWorkerThreads;
+/**
+ * Returns how frame copies in receivers and framesyncs write their
+ * destination.
+ * @returns {CopyStrategy} Mode, streaming threshold, and whether streaming
+ * stores are available.
+ */
+export const copyStrategy = addon.copyStrategy;
+/**
+ * Changes how frame copies write their destination.
+ * @param {CopyStrategyOptions} options - `mode` (`"auto"`, `"cached"`, or
+ * `"streaming"`) and the `threshold` in bytes from which `"auto"` streams.
+ * @throws {Error} If an option is invalid.
+ */
+export const setCopyStrategy = addon.setCopyStrategy;
+/**
+ * Copies a Buffer into the start of another with the frame copy strategy.
+ * @param {Buffer} target - Destination, at least as long as source.
+ * @param {Buffer} source - Bytes to copy.
+ * @throws {Error} If target is smaller than source.
+ */
+export const copyBuffer = addon.copyBuffer;
+/**
+ * Returns the settings of the allocator behind received frame buffers.
+ * @returns {FrameAllocator} Huge page mode, reuse cache size, and whether
+ * huge pages are available.
+ */
+export const frameAllocator = addon.frameAllocator;
+/**
+ * Changes the frame allocator.
+ * @param {FrameAllocatorOptions} options - `hugePages` (`"off"`,
+ * `"transparent"`, or `"hugetlb"`) and `cacheBytes`.
+ * @throws {Error} If an option is invalid or huge pages are unavailable.
+ */
+export const setFrameAllocator = addon.setFrameAllocator;
+/**
+ * Returns frame allocator counters.
+ * @returns {FrameAllocatorStats} Allocations, cache reuse, huge page use,
+ * and bytes in use.
+ */
+export const frameAllocatorStats = addon.frameAllocatorStats;
+/**
+ * Returns the process-wide budget on frame memory in use.
+ * @returns {FrameBudget} Budget in bytes, policy, and wait time.
+ */
+export const frameBudget = addon.frameBudget;
+/**
+ * Changes the frame memory budget and what captures do when it is exceeded.
+ * @param {FrameBudgetOptions} options - `bytes` (0 for no budget), `policy`
+ * (`"drop"`, `"wait"`, or `"reduce"`), and `waitMs`.
+ * @throws {Error} If an option is invalid.
+ */
+export const setFrameBudget = addon.setFrameBudget;
+/**
+ * Returns frame memory use and budget counters.
+ * @returns {FrameBudgetStats} Bytes in use, peak, and frames dropped, waited
+ * for, or reduced.
+ */
+export const frameBudgetStats = addon.frameBudgetStats;
+/**
+ * Lists the calling thread and the threads grandi runs.
+ * @returns {ThreadInfo[]} Role, owner, allowed CPUs, last CPU, and scheduling
+ * of each thread.
+ */
+export const threadTopology = addon.threadTopology;
+/**
+ * Starts worker threads that each load the addon and run receivers, so
+ * capture of many sources spreads over cores.
+ * @param {ReceiverPoolOptions} [options] - `workers`, and the `slots` and
+ * `slotBytes` of each receiver's frame channel.
+ * @returns {ReceiverPool} Pool to add receivers to.
+ * @throws {Error} On unsupported platform/CPU or if an option is invalid.
+ */
+export function receiverPool(options: ReceiverPoolOptions = {}): ReceiverPool {
+	if (addon === noopAddon) throw new Error("Unsupported platform or CPU");
+	return createReceiverPool(resolveAddonPath(), options);
+}
+/**
+ * Reads the frames a pooled receiver writes into its channel, on any thread
+ * the channel was posted to.
+ */
+export { openFrameChannel };
+/**
+ * Recreates a detached receiver, sender, or framesync in the calling thread,
+ * with its connection intact.
+ * @param {DetachedHandle} token - Value `detach()` returned, posted from the
+ * thread that detached it.
+ * @returns {Receiver | Sender | FrameSync} The adopted object.
+ * @throws {Error} If the token is malformed or was already adopted.
+ */
+export function adopt(token: DetachedReceiver): Receiver;
+export function adopt(token: DetachedSender): Sender;
+export function adopt(token: DetachedFrameSync): FrameSync;
+export function adopt(token: DetachedHandle): Receiver | Sender | FrameSync {
+	const native = addon.adopt(token);
+	return token.kind === "sender" ? wrapSender(native as Sender) : native;
+}
 export async function routing(params: {
 	name?: string;
 	groups?: string;
@@ -314,33 +721,109 @@ export type {
 	AudioFourCC,
 	AudioFrame,
 	AudioReceiveOptions,
+	BurnInOptions,
+	Clock,
+	ClockSourceEstimate,
+	CompareFramesOptions,
+	CopyMode,
+	CopyStrategy,
+	CopyStrategyOptions,
+	DeinterlaceOptions,
+	DetachedFrameSync,
+	DetachedHandle,
+	DetachedReceiver,
+	DetachedSender,
 	Finder,
 	FindOptions,
+	FrameAllocator,
+	FrameAllocatorOptions,
+	FrameAllocatorStats,
+	FrameBudget,
+	FrameBudgetOptions,
+	FrameBudgetPolicy,
+	FrameBudgetStats,
+	FrameChannel,
+	FrameChannelReader,
+	FrameChannelStats,
+	FrameHashAlgorithm,
+	FrameHashOptions,
+	FramePipe,
+	FrameQuality,
+	FrameQualityChannel,
 	FrameSync,
 	FrameSyncAudioFormat,
 	FrameSyncAudioOptions,
 	FrameSyncAudioOptionsBase,
+	FrameSyncOptions,
 	Grandi,
+	HugePageMode,
+	MotionOptions,
+	MotionReceiveOptions,
+	Multiviewer,
+	MultiviewerOptions,
+	MultiviewerStats,
+	MultiviewerTile,
+	MultiviewerTileStats,
+	OpenRecordingOptions,
+	OverlayFrame,
+	OverlayPlacement,
+	PipeContainer,
+	PipeOptions,
+	PipeStats,
+	PooledReceiver,
+	PublishShmOptions,
 	ReceivedAudioFrame,
 	ReceivedMetadataFrame,
 	ReceivedVideoFrame,
 	ReceiveOptions,
 	ReceiverDataFrame,
 	Receiver,
+	ReceiverAvSync,
+	ReceiverAvSyncOffset,
+	ReceiverAvSyncOptions,
+	ReceiverFrameRateOptions,
+	ReceiverFrameRateStats,
 	ReceiverPerformance,
+	ReceiverPool,
+	ReceiverPoolOptions,
 	ReceiverQueue,
 	ReceiverTallyState,
+	RecordCompression,
+	Recorder,
+	RecorderStats,
+	Recording,
+	RecordingEntry,
+	RecordingSeekTarget,
+	RecordOptions,
 	Routing,
+	ScopeImage,
+	ScopeOptions,
 	Sender,
 	SendOptions,
+	SendShmOptions,
 	SenderTally,
+	ShmPublisher,
+	ShmPublisherStats,
+	ShmSender,
+	ShmSenderStats,
 	Source,
 	SourceChangeEvent,
 	StatusChangeEvent,
+	SyncGroup,
+	SyncGroupMemberStats,
+	SyncGroupOptions,
+	SyncGroupSet,
+	SyncGroupStats,
+	ThreadInfo,
+	ThreadScheduling,
 	Timecode,
+	TimecodeOptions,
 	TimeoutEvent,
 	VideoFourCC,
 	VideoFrame,
+	VideoMotion,
+	VideoScopes,
+	VideoSendOptions,
 } from "./types.js";
 
 const grandi: Grandi = {
@@ -352,7 +835,36 @@ const grandi: Grandi = {
 	receive,
 	frameSync,
 	routing,
+	syncGroup,
+	multiviewer,
+	publishShm,
+	sendShm,
+	pipe,
+	record,
+	openRecording,
 	find,
+	clock,
+	splitFields,
+	weaveFields,
+	formatTimecode,
+	frameTimecode,
+	compareFrames,
+	hashFrame,
+	workerThreads,
+	setWorkerThreads,
+	copyStrategy,
+	setCopyStrategy,
+	copyBuffer,
+	frameAllocator,
+	setFrameAllocator,
+	frameAllocatorStats,
+	frameBudget,
+	setFrameBudget,
+	frameBudgetStats,
+	threadTopology,
+	receiverPool,
+	openFrameChannel,
+	adopt,
 	ColorFormat,
 	AudioFormat,
 	Bandwidth,
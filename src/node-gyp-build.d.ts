@@ -1,5 +1,8 @@
 declare module "node-gyp-build" {
-	type Loader = (path?: string) => unknown;
+	type Loader = ((path?: string) => unknown) & {
+		/** Resolves the addon file the loader would load from a directory. */
+		path?: (path?: string) => string;
+	};
 	const load: Loader;
 	export default load;
 }
@@ -0,0 +1,432 @@
+import { availableParallelism } from "node:os";
+import { Worker } from "node:worker_threads";
+
+import type {
+	ChannelVideoFrame,
+	FrameChannel,
+	FrameChannelReader,
+	FrameChannelStats,
+	FrameType,
+	PooledReceiver,
+	ReceiveOptions,
+	ReceiverPool,
+	ReceiverPoolOptions,
+	VideoFourCC,
+} from "./types.js";
+
+/*
+ * Channel layout, shared by the writing worker and every reader, after the
+ * rings of include/grandi_shm.h:
+ *
+ *   0    header: BigInt64 frames written, then Int32 oversized, errors,
+ *        and closed at bytes 8, 12, and 16
+ *   64   one 64-byte record per slot, see below
+ *   ...  slot data, slotBytes each, starting on a 64-byte boundary
+ *
+ * Frame n lives in slot n % slots. A slot record starts with a BigInt64
+ * sequence, odd while the worker fills the slot and 2n + 2 once frame n is
+ * complete, so readers use the data in place and check the sequence
+ * afterwards. Int32 bytes, xres, yres, fourCC, lineStride, frameRateN,
+ * frameRateD, frameFormatType, and hasTimestamp follow from byte 8, then
+ * Float32 pictureAspectRatio at byte 44 and BigInt64 timecode and timestamp
+ * at bytes 48 and 56.
+ */
+const HEADER_BYTES = 64;
+const RECORD_BYTES = 64;
+// Indexes into the header as BigInt64 and as Int32.
+const WRITTEN = 0;
+const OVERSIZED = 2;
+const ERRORS = 3;
+const CLOSED = 4;
+
+const DEFAULT_SLOTS = 3;
+const MAX_SLOTS = 16;
+const MAX_WORKERS = 64;
+const DEFAULT_SLOT_BYTES = 8294400;
+const MAX_SLOT_BYTES = 0x7fffffc0;
+// Attempts at reading the newest frame before a read gives up for now.
+const READ_ATTEMPTS = 4;
+
+type WaitAsync = (
+	typedArray: BigInt64Array,
+	index: number,
+	value: bigint,
+	timeout?: number,
+) => { async: boolean; value: Promise<string> | string };
+
+// Runs in each worker as CommonJS. Receivers capture on the worker's own
+// event loop and copy each frame once, from the Buffer video() resolves
+// with into its slot.
+const WORKER_SOURCE = `
+const { parentPort, workerData } = require("node:worker_threads");
+const addon = require(workerData.addonPath);
+addon.initialize();
+
+const receivers = new Map();
+const sleep = (ms) => new Promise((resolve) => setTimeout(resolve, ms));
+
+function writeFrame(entry, frame) {
+	const { counts, written, records, times, aspects, channel } = entry;
+	const bytes = frame.data.length;
+	if (bytes > channel.slotBytes) {
+		Atomics.add(counts, ${OVERSIZED}, 1);
+		return;
+	}
+	const sequence = Atomics.load(written, ${WRITTEN});
+	const slot = Number(sequence % BigInt(channel.slots));
+	const record = (${HEADER_BYTES} + slot * ${RECORD_BYTES}) >> 2;
+	const start = entry.dataOffset + slot * channel.slotBytes;
+	Atomics.store(times, record >> 1, 2n * sequence + 1n);
+	addon.copyBuffer(Buffer.from(channel.buffer, start, bytes), frame.data);
+	records[record + 2] = bytes;
+	records[record + 3] = frame.xres;
+	records[record + 4] = frame.yres;
+	records[record + 5] = frame.fourCC;
+	records[record + 6] = frame.lineStrideBytes;
+	records[record + 7] = frame.frameRateN;
+	records[record + 8] = frame.frameRateD;
+	records[record + 9] = frame.frameFormatType;
+	records[record + 10] = frame.timestamp === undefined ? 0 : 1;
+	aspects[record + 11] = frame.pictureAspectRatio;
+	times[(record >> 1) + 6] = frame.timecode;
+	times[(record >> 1) + 7] = frame.timestamp ?? 0n;
+	Atomics.store(times, record >> 1, 2n * sequence + 2n);
+	Atomics.add(written, ${WRITTEN}, 1n);
+	Atomics.notify(written, ${WRITTEN});
+}
+
+async function pump(entry) {
+	while (!entry.stopped) {
+		let frame;
+		try {
+			frame = await entry.receiver.video(250);
+		} catch (error) {
+			// Timeouts are expected between frames; anything else is
+			// counted and retried while the SDK reconnects.
+			if (!entry.stopped && error.code !== "4040") {
+				Atomics.add(entry.counts, ${ERRORS}, 1);
+				await sleep(100);
+			}
+			continue;
+		}
+		if (!entry.stopped) writeFrame(entry, frame);
+	}
+}
+
+async function remove(id) {
+	const entry = receivers.get(id);
+	if (!entry) return;
+	receivers.delete(id);
+	entry.stopped = true;
+	await entry.done;
+	entry.receiver.destroy();
+	Atomics.store(entry.counts, ${CLOSED}, 1);
+	Atomics.notify(entry.written, ${WRITTEN});
+}
+
+parentPort.on("message", async (message) => {
+	if (message.op === "add") {
+		const { id, channel } = message;
+		try {
+			const receiver = await addon.receive(message.options);
+			const buffer = channel.buffer;
+			const entry = {
+				receiver,
+				channel,
+				written: new BigInt64Array(buffer, 0, 1),
+				counts: new Int32Array(buffer, 0, ${HEADER_BYTES} >> 2),
+				records: new Int32Array(buffer),
+				aspects: new Float32Array(buffer),
+				times: new BigInt64Array(buffer, 0, buffer.byteLength >> 3),
+				dataOffset: ${HEADER_BYTES} + channel.slots * ${RECORD_BYTES},
+				stopped: false,
+			};
+			receivers.set(id, entry);
+			entry.done = pump(entry);
+			parentPort.postMessage({ op: "added", id, source: receiver.source });
+		} catch (error) {
+			parentPort.postMessage({
+				op: "added",
+				id,
+				error: { message: error.message, code: error.code },
+			});
+		}
+	} else if (message.op === "remove") {
+		await remove(message.id);
+		parentPort.postMessage({ op: "removed", id: message.id });
+	} else if (message.op === "close") {
+		// No addon.destroy(): the SDK is shared with the rest of the process,
+		// and the environment's cleanup hook drops this worker's hold on exit.
+		await Promise.all([...receivers.keys()].map(remove));
+		parentPort.postMessage({ op: "closed" });
+	}
+});
+`;
+
+interface PendingReply {
+	resolve(message: WorkerReply): void;
+	reject(error: Error): void;
+}
+
+interface WorkerReply {
+	op: "added" | "removed" | "closed";
+	id?: number;
+	source?: ReceiveOptions["source"];
+	error?: { message: string; code?: string };
+}
+
+interface PoolWorker {
+	worker: Worker;
+	receivers: number;
+	pending: Map<number, PendingReply>;
+	failure?: Error;
+}
+
+function readInteger(
+	value: number | undefined,
+	name: string,
+	min: number,
+	max: number,
+	fallback: number,
+): number {
+	if (value === undefined) return fallback;
+	if (!Number.isInteger(value) || value < min || value > max)
+		throw new Error(`${name} must be an integer between ${min} and ${max}.`);
+	return value;
+}
+
+function createChannel(slots: number, slotBytes: number): FrameChannel {
+	const bytes = HEADER_BYTES + slots * RECORD_BYTES + slots * slotBytes;
+	return { buffer: new SharedArrayBuffer(bytes), slots, slotBytes };
+}
+
+/**
+ * Starts the workers of a receiver pool. `addonPath` is the native addon
+ * each worker loads into its own environment.
+ */
+export function createReceiverPool(
+	addonPath: string,
+	options: ReceiverPoolOptions = {},
+): ReceiverPool {
+	const workerCount = readInteger(
+		options.workers,
+		"workers",
+		1,
+		MAX_WORKERS,
+		Math.max(1, Math.min(availableParallelism() - 1, 8)),
+	);
+	const slots = readInteger(
+		options.slots,
+		"slots",
+		2,
+		MAX_SLOTS,
+		DEFAULT_SLOTS,
+	);
+	// Slots start on cache lines so copies into them stay aligned.
+	const slotBytes =
+		Math.ceil(
+			readInteger(
+				options.slotBytes,
+				"slotBytes",
+				1,
+				MAX_SLOT_BYTES,
+				DEFAULT_SLOT_BYTES,
+			) / 64,
+		) * 64;
+
+	let nextId = 1;
+	let closed = false;
+	// Replies are keyed by receiver id; 0 is the close request.
+	const send = (
+		entry: PoolWorker,
+		id: number,
+		message: object,
+	): Promise<WorkerReply> =>
+		new Promise((resolve, reject) => {
+			if (entry.failure) {
+				reject(entry.failure);
+				return;
+			}
+			entry.pending.set(id, { resolve, reject });
+			entry.worker.postMessage(message);
+		});
+
+	const workers: PoolWorker[] = Array.from({ length: workerCount }, () => {
+		const entry: PoolWorker = {
+			worker: new Worker(WORKER_SOURCE, {
+				eval: true,
+				workerData: { addonPath },
+			}),
+			receivers: 0,
+			pending: new Map(),
+		};
+		entry.worker.on("message", (reply: WorkerReply) => {
+			const id = reply.op === "closed" ? 0 : (reply.id ?? 0);
+			const pending = entry.pending.get(id);
+			entry.pending.delete(id);
+			pending?.resolve(reply);
+		});
+		const fail = (error: Error) => {
+			entry.failure = error;
+			for (const pending of entry.pending.values()) pending.reject(error);
+			entry.pending.clear();
+		};
+		entry.worker.on("error", fail);
+		entry.worker.on("exit", (code) => {
+			if (!closed)
+				fail(new Error(`Receiver pool worker exited with code ${code}.`));
+		});
+		return entry;
+	});
+
+	return {
+		workers: workerCount,
+		async add(receiveOptions: ReceiveOptions): Promise<PooledReceiver> {
+			if (closed) throw new Error("Receiver pool has been destroyed.");
+			// The least loaded live worker takes the new source.
+			const live = workers.filter((entry) => !entry.failure);
+			if (live.length === 0)
+				throw new Error("Receiver pool has no running workers.");
+			const entry = live.reduce((best, candidate) =>
+				candidate.receivers < best.receivers ? candidate : best,
+			);
+			const id = nextId++;
+			const channel = createChannel(slots, slotBytes);
+			entry.receivers++;
+			const reply = await send(entry, id, {
+				op: "add",
+				id,
+				options: receiveOptions,
+				channel,
+			}).catch((error: Error) => {
+				entry.receivers--;
+				throw error;
+			});
+			if (reply.error) {
+				entry.receivers--;
+				throw Object.assign(new Error(reply.error.message), {
+					code: reply.error.code,
+				});
+			}
+			let removed: Promise<void> | undefined;
+			return {
+				id,
+				worker: workers.indexOf(entry),
+				source: reply.source ?? receiveOptions.source,
+				channel,
+				frames: openFrameChannel(channel),
+				remove() {
+					removed ??= send(entry, id, { op: "remove", id }).then(() => {
+						entry.receivers--;
+					});
+					return removed;
+				},
+			};
+		},
+		load() {
+			return workers.map((entry) => entry.receivers);
+		},
+		async destroy() {
+			if (closed) return;
+			closed = true;
+			await Promise.all(
+				workers.map(async (entry) => {
+					await send(entry, 0, { op: "close" }).catch(() => undefined);
+					await entry.worker.terminate();
+				}),
+			);
+		},
+	};
+}
+
+/**
+ * Reads the frames a pooled receiver writes into a channel. Works on any
+ * thread the channel was posted to; each reader keeps its own position.
+ */
+export function openFrameChannel(channel: FrameChannel): FrameChannelReader {
+	const { buffer, slots, slotBytes } = channel;
+	const written = new BigInt64Array(buffer, 0, 1);
+	const counts = new Int32Array(buffer, 0, HEADER_BYTES >> 2);
+	const records = new Int32Array(buffer);
+	const aspects = new Float32Array(buffer);
+	const times = new BigInt64Array(buffer, 0, buffer.byteLength >> 3);
+	const dataOffset = HEADER_BYTES + slots * RECORD_BYTES;
+	const waitAsync = (Atomics as unknown as { waitAsync: WaitAsync })
+		.waitAsync;
+	// Sequence number of the last frame returned, or -1.
+	let last = -1n;
+	let read = 0;
+	let skipped = 0;
+
+	const view = (sequence: bigint): ChannelVideoFrame | undefined => {
+		const slot = Number(sequence % BigInt(slots));
+		const record = (HEADER_BYTES + slot * RECORD_BYTES) >> 2;
+		const complete = 2n * sequence + 2n;
+		if (Atomics.load(times, record >> 1) !== complete) return undefined;
+		const bytes = records[record + 2];
+		const start = dataOffset + slot * slotBytes;
+		const valid = () => Atomics.load(times, record >> 1) === complete;
+		const frame: ChannelVideoFrame = {
+			type: "video",
+			xres: records[record + 3],
+			yres: records[record + 4],
+			fourCC: (records[record + 5] >>> 0) as VideoFourCC,
+			lineStrideBytes: records[record + 6],
+			frameRateN: records[record + 7],
+			frameRateD: records[record + 8],
+			frameFormatType: records[record + 9] as FrameType,
+			pictureAspectRatio: aspects[record + 11],
+			timecode: times[(record >> 1) + 6],
+			data: Buffer.from(buffer, start, bytes),
+			valid,
+		};
+		if (records[record + 10] === 1)
+			frame.timestamp = times[(record >> 1) + 7];
+		// The worker may have started on frame sequence + slots meanwhile.
+		return valid() ? frame : undefined;
+	};
+
+	const latest = (): ChannelVideoFrame | undefined => {
+		for (let attempt = 0; attempt < READ_ATTEMPTS; attempt++) {
+			const count = Atomics.load(written, WRITTEN);
+			if (count === 0n || count - 1n === last) return undefined;
+			const frame = view(count - 1n);
+			if (frame) {
+				if (last >= 0n) skipped += Number(count - 2n - last);
+				last = count - 1n;
+				read++;
+				return frame;
+			}
+		}
+		return undefined;
+	};
+
+	return {
+		latest,
+		async next(timeoutMs = 1000) {
+			const deadline = Date.now() + timeoutMs;
+			while (true) {
+				const count = Atomics.load(written, WRITTEN);
+				if (count - 1n !== last && count > 0n) {
+					const frame = latest();
+					if (frame) return frame;
+				}
+				const remaining = deadline - Date.now();
+				if (Atomics.load(counts, CLOSED) === 1 || remaining <= 0)
+					return undefined;
+				const result = waitAsync(written, WRITTEN, count, remaining);
+				if (result.async) await result.value;
+			}
+		},
+		stats(): FrameChannelStats {
+			return {
+				written: Number(Atomics.load(written, WRITTEN)),
+				read,
+				skipped,
+				oversized: Atomics.load(counts, OVERSIZED),
+				errors: Atomics.load(counts, ERRORS),
+				closed: Atomics.load(counts, CLOSED) === 1,
+			};
+		},
+	};
+}
@@ -93,6 +93,14 @@ export interface ReceivedVideoFrame extends VideoFrame {
 	/** Omitted when the NDI SDK reports that the receive timestamp is unavailable. */
 	timestamp?: bigint;
 	metadata?: string;
+	/** Hex digest of the picture, when the receiver was created with `hash`. */
+	hash?: string;
+	/** Whether `hash` matches the previous frame's, when hashing. */
+	duplicate?: boolean;
+	/** Duplicates dropped before this frame, with `hash.skipDuplicates`. */
+	duplicatesSkipped?: number;
+	/** Frames the frame budget refused before this one, when it refused any. */
+	budgetDrops?: number;
 }
 
 export type AudioFrame = {
@@ -185,6 +193,537 @@ export interface ReceiverQueue {
 	audioFrames: number;
 }
 
+export interface ReceiverAvSyncOptions {
+	/** Number of recent offset samples kept for the rolling statistics. Defaults to 100. */
+	window?: number;
+	/** Detect white flashes and audio beeps and pair them. Defaults to `false`. */
+	testPattern?: boolean;
+}
+
+export interface ReceiverAvSyncOffset {
+	mean: number;
+	min: number;
+	max: number;
+	last: number;
+}
+
+export interface ReceiverAvSync {
+	videoFrames: number;
+	audioFrames: number;
+	/** Captured frames without a sender timestamp; these are not measured. */
+	untimedFrames: number;
+	/** Offset samples currently in the rolling window. */
+	samples: number;
+	/**
+	 * Video transit time minus audio transit time, in milliseconds. Positive
+	 * values mean picture is late relative to sound. Absent until both video
+	 * and audio with timestamps have been captured.
+	 */
+	offsetMs?: ReceiverAvSyncOffset & { stddev: number };
+	/** Present when `testPattern` is enabled. */
+	testPattern?: {
+		flashes: number;
+		beeps: number;
+		matches: number;
+		/** Flash arrival minus beep onset arrival for each matched pair, in milliseconds. */
+		offsetMs?: ReceiverAvSyncOffset;
+	};
+}
+
+export interface ReceiverFrameRateOptions {
+	frameRateN: number;
+	frameRateD: number;
+	/** Average each skipped frame into the next output frame. Defaults to `false`. */
+	blend?: boolean;
+}
+
+export interface ReceiverFrameRateStats {
+	inputFrames: number;
+	outputFrames: number;
+	/** Input frames released without reaching the output. */
+	droppedFrames: number;
+	/** Output frames that repeat the previous input frame. */
+	duplicatedFrames: number;
+	/** Output frames averaged with a skipped input frame. */
+	blendedFrames: number;
+}
+
+export interface DeinterlaceOptions {
+	/**
+	 * `"bob"` interpolates the missing lines of each field, `"blend"` averages
+	 * neighbouring lines of the woven frame, and `"adaptive"` weaves where the
+	 * picture is static and interpolates where it moves. Defaults to `"bob"`.
+	 */
+	mode?: "bob" | "blend" | "adaptive";
+	/**
+	 * Receivers only: return every field as a frame at twice the frame rate.
+	 * Not available in blend mode. Defaults to `false`.
+	 */
+	fieldRate?: boolean;
+	/** Largest 8-bit sample change treated as static in adaptive mode. Defaults to 10. */
+	threshold?: number;
+}
+
+/**
+ * Text stamped into UYVY, UYVA, BGRA, BGRX, RGBA, and RGBX frames, white on
+ * a black box. Frames in other formats are left unchanged.
+ */
+export interface BurnInOptions {
+	/**
+	 * SMPTE timecode at the frame's rate. Frames with a synthesized timecode
+	 * count from `00:00:00:00`. Defaults to `true`.
+	 */
+	timecode?: boolean;
+	/** Frames stamped so far, as `#N`. Defaults to `false`. */
+	frameCounter?: boolean;
+	/**
+	 * `true` for the source or sender name, or the text to show. Defaults to
+	 * `true`.
+	 */
+	label?: boolean | string;
+	/** Corner the box sits in. Defaults to `"bottom-left"`. */
+	position?: "top-left" | "top-right" | "bottom-left" | "bottom-right";
+	/**
+	 * Glyph scale from 1 to 16, in multiples of 8 pixels. Defaults to one
+	 * step per 270 lines.
+	 */
+	scale?: number;
+	/**
+	 * Count drop-frame timecode at multiples of 30000/1001. Defaults to
+	 * `true`.
+	 */
+	dropFrame?: boolean;
+}
+
+export interface TimecodeOptions {
+	frameRateN: number;
+	frameRateD: number;
+	/**
+	 * Count drop-frame timecode at multiples of 30000/1001. Defaults to
+	 * `true`.
+	 */
+	dropFrame?: boolean;
+}
+
+export interface ScopeOptions {
+	/** Luma level by column. Defaults to `true`. */
+	waveform?: boolean;
+	/** Cb against Cr. Defaults to `true`. */
+	vectorscope?: boolean;
+	/** Luma, red, green, and blue levels. Defaults to `true`. */
+	histogram?: boolean;
+	/** Waveform columns across the frame width, 16 to 2048. Defaults to 256. */
+	columns?: number;
+	/** Vectorscope bins along each axis, 16 to 512. Defaults to 256. */
+	vectorscopeSize?: number;
+	/**
+	 * Sample every `step`-th pixel of every `step`-th line, 1 to 64. Defaults
+	 * to 2.
+	 */
+	step?: number;
+	/** Also render the waveform and vectorscope as BGRA images. */
+	render?: boolean;
+}
+
+/**
+ * Motion detection on a grid of cells. Each cell scores the mean absolute
+ * change of downsampled luma since the previous frame, from 0 to 1.
+ */
+export interface MotionOptions {
+	/** Grid columns, 1 to 64. Defaults to 8. */
+	columns?: number;
+	/** Grid rows, 1 to 64. Defaults to 6. */
+	rows?: number;
+	/**
+	 * Average luma over `scale` x `scale` pixel blocks before differencing,
+	 * 1 to 16. Defaults to 4.
+	 */
+	scale?: number;
+	/**
+	 * Weight each cell's previous score keeps, 0 to 0.99. Defaults to 0.5;
+	 * 0 scores every frame on its own.
+	 */
+	smoothing?: number;
+	/** Score from which a cell is active, 0 to 1. Defaults to 0.02. */
+	threshold?: number;
+}
+
+export interface MotionReceiveOptions {
+	/**
+	 * Keep scoring frames until a cell is active instead of returning the
+	 * next frame's scores. Defaults to `false`.
+	 */
+	waitForMotion?: boolean;
+}
+
+/** Motion scores of one received frame. */
+export interface VideoMotion {
+	xres: number;
+	yres: number;
+	frameRateN: number;
+	frameRateD: number;
+	fourCC: VideoFourCC;
+	timestamp?: Timecode;
+	timecode: Timecode;
+	columns: number;
+	rows: number;
+	/** Smoothed cell scores, indexed `row * columns + column`. */
+	scores: Float32Array;
+	/** Largest score. */
+	peak: number;
+	/** Indices of cells whose score reached the threshold. */
+	active: number[];
+	/** Whether any cell is active. */
+	motion: boolean;
+	/**
+	 * `true` when there was no earlier frame of the same size to compare
+	 * with, so every score is 0.
+	 */
+	reference: boolean;
+	/** Frames scored for this call, more than 1 with `waitForMotion`. */
+	framesAnalyzed: number;
+}
+
+/** A rendered scope: a trace on black with a dim graticule. */
+export interface ScopeImage {
+	xres: number;
+	yres: number;
+	fourCC: FourCC.BGRA;
+	lineStrideBytes: number;
+	data: Buffer;
+}
+
+/**
+ * Scopes of one received frame. Bins count sampled pixels at 8-bit levels;
+ * 16-bit formats use their top 8 bits.
+ */
+export interface VideoScopes {
+	xres: number;
+	yres: number;
+	frameRateN: number;
+	frameRateD: number;
+	fourCC: VideoFourCC;
+	timestamp?: Timecode;
+	timecode: Timecode;
+	/** Pixels sampled. */
+	samples: number;
+	columns?: number;
+	/** `columns` x 256 bins, indexed `level * columns + column`. */
+	waveform?: Uint32Array;
+	vectorscopeSize?: number;
+	/**
+	 * `vectorscopeSize` squared bins, indexed `cr * vectorscopeSize + cb` with
+	 * both scaled from 0-255 to the size.
+	 */
+	vectorscope?: Uint32Array;
+	/** 4 x 256 bins: luma, red, green, then blue, indexed by level. */
+	histogram?: Uint32Array;
+	/** `columns` wide and 256 high, white level at the top. */
+	waveformImage?: ScopeImage;
+	/** `vectorscopeSize` square, Cb to the right and Cr up. */
+	vectorscopeImage?: ScopeImage;
+}
+
+export interface CompareFramesOptions {
+	/** Also compute SSIM. Defaults to `true`. */
+	ssim?: boolean;
+}
+
+export interface FrameQualityChannel {
+	/** `"y"`, `"cb"`, and `"cr"`, or `"r"`, `"g"`, and `"b"`. */
+	name: string;
+	/** Mean squared error in sample units. */
+	mse: number;
+	/** Peak signal-to-noise ratio in dB, `Infinity` for identical samples. */
+	psnr: number;
+	/** Mean SSIM of 8x8 windows, 1 for identical samples. */
+	ssim?: number;
+}
+
+export interface FrameQuality {
+	/** Mean squared error over every sample of every channel. */
+	mse: number;
+	/** PSNR of `mse` in dB, `Infinity` for identical frames. */
+	psnr: number;
+	/** Channel SSIM averaged by sample count. */
+	ssim?: number;
+	/** Largest sample value: 255, or 65535 for P216 and PA16. */
+	peak: number;
+	channels: FrameQualityChannel[];
+}
+
+/**
+ * `"xxh3"` hashes every byte of the picture with 128-bit XXH3. `"sampled"`
+ * hashes every 16th line with 64-bit XXH3, for a cheaper change check.
+ */
+export type FrameHashAlgorithm = "xxh3" | "sampled";
+
+export interface FrameHashOptions {
+	/** Defaults to `"xxh3"`. */
+	algorithm?: FrameHashAlgorithm;
+	/**
+	 * Drop frames whose hash matches the previous frame's and keep waiting
+	 * for a changed one. Defaults to `false`.
+	 */
+	skipDuplicates?: boolean;
+}
+
+/**
+ * How copies of received frames write their destination. `"cached"` uses
+ * plain stores. `"streaming"` uses non-temporal stores that bypass the CPU
+ * caches, leaving them to the code that processes frames. `"auto"` streams
+ * copies from the threshold up.
+ */
+export type CopyMode = "auto" | "cached" | "streaming";
+
+export interface CopyStrategy {
+	mode: CopyMode;
+	/** Bytes from which `"auto"` streams. Defaults to 8 MiB. */
+	threshold: number;
+	/**
+	 * Whether this build has streaming stores (SSE2 on x86, STNP on 64-bit
+	 * ARM). Without them every mode copies with plain stores.
+	 */
+	streamingStores: boolean;
+}
+
+export interface CopyStrategyOptions {
+	mode?: CopyMode;
+	/** Bytes from which `"auto"` streams, from 0 to 4294967295. */
+	threshold?: number;
+}
+
+/**
+ * Huge pages for frame buffers of 2 MiB and up, on Linux. `"transparent"`
+ * asks the kernel for transparent huge pages with `MADV_HUGEPAGE`.
+ * `"hugetlb"` takes pages from the preallocated hugetlbfs pool
+ * (`vm.nr_hugepages`) and falls back to `"transparent"` when it runs out.
+ */
+export type HugePageMode = "off" | "transparent" | "hugetlb";
+
+export interface FrameAllocator {
+	/** Defaults to `"transparent"` on Linux and `"off"` elsewhere. */
+	hugePages: HugePageMode;
+	/**
+	 * Bytes of released frame buffers of 64 KiB and up kept for reuse, so
+	 * the next frame of the same size skips the page faults. Defaults to
+	 * 64 MiB.
+	 */
+	cacheBytes: number;
+	/** Whether huge pages can be requested on this platform. */
+	hugePagesAvailable: boolean;
+}
+
+export interface FrameAllocatorOptions {
+	hugePages?: HugePageMode;
+	/** From 0, which disables the cache, to `Number.MAX_SAFE_INTEGER`. */
+	cacheBytes?: number;
+}
+
+export interface FrameAllocatorStats {
+	/** Buffers handed out since the process started. */
+	allocations: number;
+	/** Of those, buffers taken from the cache. */
+	recycled: number;
+	failures: number;
+	/** Buffers advised to use transparent huge pages. */
+	transparentBlocks: number;
+	/** Buffers mapped from the hugetlbfs pool. */
+	hugetlbBlocks: number;
+	/** hugetlbfs mappings that failed and used transparent huge pages. */
+	hugetlbFallbacks: number;
+	/** Bytes held by live buffers, rounded up to whole pages. */
+	bytesInUse: number;
+	peakBytesInUse: number;
+	cachedBytes: number;
+	cachedBlocks: number;
+}
+
+/**
+ * What a capture does with a video frame that would take frame memory past
+ * the budget. `"drop"` frees the frame and moves on to the next one.
+ * `"wait"` blocks the capture for up to `waitMs` for JavaScript to release
+ * buffers, then drops. `"reduce"` copies the frame at half its width and
+ * height when that fits, for progressive UYVY, BGRA, BGRX, RGBA, and RGBX
+ * frames from `video()` and `data()`, and drops otherwise.
+ */
+export type FrameBudgetPolicy = "drop" | "wait" | "reduce";
+
+export interface FrameBudget {
+	/** Most frame memory in use before captures push back; 0 for no limit. */
+	bytes: number;
+	policy: FrameBudgetPolicy;
+	/** How long the `"wait"` policy blocks a capture, in milliseconds. */
+	waitMs: number;
+}
+
+export interface FrameBudgetOptions {
+	/** From 0, the default, which disables the budget. */
+	bytes?: number;
+	/** Defaults to `"drop"`. */
+	policy?: FrameBudgetPolicy;
+	/** From 0 to 10000. Defaults to 100. */
+	waitMs?: number;
+}
+
+export interface FrameBudgetStats {
+	bytes: number;
+	/**
+	 * Frame memory in use: buffers held by JavaScript and not yet collected,
+	 * plus frames queued natively.
+	 */
+	bytesInUse: number;
+	/** Highest `bytesInUse` since the process started. */
+	peakBytesInUse: number;
+	/** Captures that found the budget exceeded. */
+	overBudget: number;
+	/** Of those, frames dropped, including waits that ran out. */
+	dropped: number;
+	/** Captures the `"wait"` policy blocked. */
+	waited: number;
+	/** Frames copied at half size by the `"reduce"` policy. */
+	reduced: number;
+}
+
+/**
+ * Where and at what priority a thread grandi starts runs. Linux supports
+ * every field; Windows supports `cpus` below 64 and `realtimePriority`, and
+ * macOS `realtimePriority` only. A setting the OS refuses, such as
+ * `realtimePriority` without `CAP_SYS_NICE`, leaves the thread running as
+ * before and is reported in the `error` of its `threadTopology()` entry.
+ */
+export interface ThreadScheduling {
+	/** CPUs the thread may run on. Defaults to those of the process. */
+	cpus?: number[];
+	/** Linux nice value, from -20 to 19. Negative values need privileges. */
+	nice?: number;
+	/**
+	 * Runs the thread under `SCHED_FIFO` at this priority, from 1 to 99.
+	 * Cannot be combined with `nice`.
+	 */
+	realtimePriority?: number;
+}
+
+export interface ThreadInfo {
+	/**
+	 * `"javascript"` for the calling thread, or `"pool"`, `"pipe"`,
+	 * `"recorder"`, `"recorder-worker"`, `"multiviewer"`,
+	 * `"multiviewer-worker"`, `"shm-publisher"`, `"shm-sender"`, or
+	 * `"syncgroup"`.
+	 */
+	role: string;
+	/**
+	 * What the thread works for: a recording path, ring or multiviewer name,
+	 * source name, or pipe descriptor.
+	 */
+	owner: string;
+	/** OS thread id, as shown by `top -H` on Linux. */
+	threadId: number;
+	/** CPUs the thread may run on. */
+	cpus: number[];
+	/** CPU the thread last ran on, or -1 where the OS does not say. */
+	lastCpu: number;
+	/** `"other"`, `"fifo"`, `"rr"`, `"batch"`, or `"idle"`. */
+	policy: string;
+	/** Real-time priority, or 0 under a normal policy. */
+	priority: number;
+	nice: number;
+	/** Why the requested scheduling could not be applied in full. */
+	error?: string;
+}
+
+export interface ReceiverPoolOptions {
+	/**
+	 * Worker threads, from 1 to 64. Defaults to one less than the available
+	 * parallelism, at most 8.
+	 */
+	workers?: number;
+	/** Frames each channel holds, from 2 to 16. Defaults to 3. */
+	slots?: number;
+	/**
+	 * Bytes per channel slot, rounded up to 64. Larger frames are counted as
+	 * `oversized` and skipped. Defaults to one 1080p UYVY frame (8294400).
+	 */
+	slotBytes?: number;
+}
+
+/**
+ * Shared memory a pooled receiver writes its video frames into. Post it to
+ * another thread and pass it to `openFrameChannel()` to read frames there.
+ */
+export interface FrameChannel {
+	buffer: SharedArrayBuffer;
+	slots: number;
+	slotBytes: number;
+}
+
+export interface FrameChannelStats {
+	/** Frames the worker wrote into the channel. */
+	written: number;
+	/** Frames this reader returned. */
+	read: number;
+	/** Frames overwritten before this reader got to them. */
+	skipped: number;
+	/** Frames larger than a slot, not written. */
+	oversized: number;
+	/** Capture errors other than timeouts. */
+	errors: number;
+	/** Set once the receiver was removed or its pool destroyed. */
+	closed: boolean;
+}
+
+/**
+ * A frame read from a channel. `data` is a view of the channel slot, not a
+ * copy: the worker overwrites the slot `slots` frames later.
+ */
+export interface ChannelVideoFrame extends ReceivedVideoFrame {
+	/**
+	 * Whether the slot still holds this frame. Check it after reading `data`
+	 * and drop what was read when it returns `false`; copy `data` with
+	 * `Buffer.from()` to keep the frame for longer.
+	 */
+	valid(): boolean;
+}
+
+export interface FrameChannelReader {
+	/**
+	 * Returns the newest frame this reader has not returned yet, or
+	 * `undefined` when there is none.
+	 */
+	latest(): ChannelVideoFrame | undefined;
+	/**
+	 * Waits for a frame newer than the last one returned. Resolves to
+	 * `undefined` on timeout or once the channel is closed.
+	 */
+	next(timeoutMs?: number): Promise<ChannelVideoFrame | undefined>;
+	stats(): FrameChannelStats;
+}
+
+export interface PooledReceiver {
+	id: number;
+	/** Index of the worker running the receiver. */
+	worker: number;
+	source: Source;
+	channel: FrameChannel;
+	/** Reader of `channel` on the calling thread. */
+	frames: FrameChannelReader;
+	/** Destroys the receiver in its worker and closes the channel. */
+	remove(): Promise<void>;
+}
+
+export interface ReceiverPool {
+	workers: number;
+	/**
+	 * Creates a receiver on the worker running the fewest.
+	 * @throws Rejects like `receive()` when the receiver cannot be created.
+	 */
+	add(options: ReceiveOptions): Promise<PooledReceiver>;
+	/** Receivers per worker. */
+	load(): number[];
+	/** Destroys every receiver and stops the workers. */
+	destroy(): Promise<void>;
+}
+
 export interface Receiver {
 	source: Source;
 	colorFormat: ColorFormat;
@@ -203,11 +742,38 @@ export interface Receiver {
 		options: AudioReceiveOptions,
 		timeoutMs?: number,
 	): Promise<ReceiverDataFrame>;
+	/**
+	 * Captures the next video frame and returns its scopes, computed in the
+	 * SDK's buffer on a worker thread. The frame itself is not returned.
+	 */
+	scopes(timeoutMs?: number): Promise<VideoScopes>;
+	scopes(options: ScopeOptions, timeoutMs?: number): Promise<VideoScopes>;
+	/**
+	 * Captures the next video frame and returns its motion scores, computed
+	 * in the SDK's buffer on a worker thread. Requires the `motion` receive
+	 * option. The frame itself is not returned.
+	 */
+	motion(timeoutMs?: number): Promise<VideoMotion>;
+	motion(
+		options: MotionReceiveOptions,
+		timeoutMs?: number,
+	): Promise<VideoMotion>;
 	tally(state: ReceiverTallyState): boolean;
 	destroy(): boolean;
+	/**
+	 * Hands the connection to `grandi.adopt()` in another thread, without
+	 * reconnecting, and leaves this object destroyed. Throws while a capture
+	 * is in flight or a framesync, sync group, or multiviewer holds the
+	 * receiver.
+	 */
+	detach(): DetachedReceiver;
 	performance(): ReceiverPerformance;
 	queue(): ReceiverQueue;
 	connections(): number;
+	/** A/V offset statistics, or `undefined` when `avSync` was not enabled. */
+	avSync(): ReceiverAvSync | undefined;
+	/** Conversion counters, or `undefined` when `outputFrameRate` was not set. */
+	frameRateStats(): ReceiverFrameRateStats | undefined;
 }
 
 export interface ReceiverTallyState {
@@ -225,12 +791,55 @@ export interface SenderTally {
 	on_preview: boolean;
 }
 
+/**
+ * A graphics frame keyed over sent video. Color is premultiplied by alpha
+ * unless `premultiplied` is `false` in its placement.
+ */
+export interface OverlayFrame {
+	xres: number;
+	yres: number;
+	fourCC: FourCC.UYVA | FourCC.BGRA | FourCC.RGBA;
+	/** Defaults to the packed stride of `fourCC`. */
+	lineStrideBytes?: number;
+	data: Buffer;
+}
+
+export interface OverlayPlacement {
+	/**
+	 * Column of the overlay's left edge; rounded down to an even column over
+	 * UYVY and UYVA video. Defaults to 0.
+	 */
+	x?: number;
+	/** Row of the overlay's top edge. Defaults to 0. */
+	y?: number;
+	/** Whether color is premultiplied by alpha. Defaults to `true`. */
+	premultiplied?: boolean;
+}
+
+export interface VideoSendOptions extends OverlayPlacement {
+	/** Overlay keyed over this frame only, in place of any resident one. */
+	overlay?: OverlayFrame;
+}
+
 export interface Sender {
 	name: string;
 	groups?: string;
 	clockVideo: boolean;
 	clockAudio: boolean;
-	video(frame: VideoFrame): Promise<void>;
+	splitFields: boolean;
+	/**
+	 * Sends a video frame. With an overlay, or after `setOverlay`, the overlay
+	 * is keyed over a copy of UYVY, UYVA, BGRA, BGRX, RGBA, or RGBX frames in
+	 * native code, leaving `frame.data` unchanged.
+	 */
+	video(frame: VideoFrame, options?: VideoSendOptions): Promise<void>;
+	/**
+	 * Keeps an overlay resident, keying it over every frame sent until it is
+	 * replaced or cleared with `null`. The overlay is copied once and
+	 * converted to each video format once, so call this only when the
+	 * graphics change.
+	 */
+	setOverlay(overlay: OverlayFrame | null, placement?: OverlayPlacement): void;
 	audio(frame: AudioFrame): Promise<void>;
 	connections(): number;
 	metadata(data: string): boolean;
@@ -239,7 +848,34 @@ export interface Sender {
 	/** @deprecated Use `sourceName` instead. */
 	sourcename(): string;
 	destroy(): boolean;
+	/**
+	 * Hands the sender to `grandi.adopt()` in another thread and leaves this
+	 * object destroyed. Throws while a send is in flight or a pipe or ring
+	 * feeds the sender.
+	 */
+	detach(): DetachedSender;
+}
+
+/**
+ * Token for a detached receiver, sender, or framesync. Post it to another
+ * thread and pass it to `grandi.adopt()` there, once.
+ */
+export interface DetachedReceiver {
+	kind: "receiver";
+	id: number;
+}
+export interface DetachedSender {
+	kind: "sender";
+	id: number;
+}
+export interface DetachedFrameSync {
+	kind: "frameSync";
+	id: number;
 }
+export type DetachedHandle =
+	| DetachedReceiver
+	| DetachedSender
+	| DetachedFrameSync;
 
 export interface Routing {
 	name?: string;
@@ -277,6 +913,14 @@ export interface FrameSyncAudioFormat {
 	channels: number;
 }
 
+export interface FrameSyncOptions {
+	/**
+	 * Deinterlace captured video. The field requested from `video()` selects
+	 * the field to rebuild; `fieldRate` is ignored.
+	 */
+	deinterlace?: DeinterlaceOptions;
+}
+
 export interface FrameSync {
 	/**
 	 * Captures a video frame using NDI frame-synchronization (time base correction).
@@ -301,6 +945,451 @@ export interface FrameSync {
 	 */
 	audioQueueDepth(): number;
 	destroy(): boolean;
+	/**
+	 * Hands the framesync, and its hold on the receiver, to
+	 * `grandi.adopt()` in another thread and leaves this object destroyed.
+	 */
+	detach(): DetachedFrameSync;
+}
+
+export interface SyncGroupOptions {
+	/**
+	 * Receivers to align. Each receiver is bound to the group the same way a
+	 * FrameSync binds it, so direct video, audio, and data capture is unavailable
+	 * until the group is destroyed.
+	 */
+	receivers: Receiver[];
+	/**
+	 * Largest timestamp difference between two frames of the same set, in
+	 * milliseconds. Defaults to `10`.
+	 */
+	toleranceMs?: number;
+	/**
+	 * How long a frame waits for the other members before its set is delivered
+	 * without them, in milliseconds. Defaults to `100`.
+	 */
+	bufferMs?: number;
+	/** Called on the JavaScript thread with each aligned set. */
+	callback(set: SyncGroupSet): void;
+	/** Placement of the capture thread of every member. */
+	scheduling?: ThreadScheduling;
+}
+
+export interface SyncGroupSet {
+	/** One entry per receiver, in `receivers` order; `null` when a member has no frame for this instant. */
+	frames: (ReceivedVideoFrame | null)[];
+	/** Indices of the members missing from this set. */
+	missing: number[];
+	complete: boolean;
+	/** Spread between the earliest and latest frame in the set, in milliseconds. */
+	alignmentErrorMs: number;
+}
+
+export interface SyncGroupMemberStats {
+	bufferedFrames: number;
+	peakBufferedFrames: number;
+	capturedFrames: number;
+	/** Frames discarded because they could not be copied or the member buffer was full. */
+	droppedFrames: number;
+}
+
+export interface SyncGroupStats {
+	completeSets: number;
+	partialSets: number;
+	/** Sets discarded because the callback fell too far behind. */
+	droppedSets: number;
+	/** Alignment error over delivered sets with at least two frames. */
+	alignmentErrorMs: { mean: number; max: number; last: number };
+	members: SyncGroupMemberStats[];
+}
+
+export interface SyncGroup {
+	/** Number of receivers in the group. */
+	size: number;
+	stats(): SyncGroupStats;
+	/**
+	 * Stops capture, releases the receivers, and drops sets that have not yet
+	 * been delivered.
+	 */
+	destroy(): boolean;
+}
+
+export interface MultiviewerTile {
+	/**
+	 * Receiver shown in the tile. It is bound through a native FrameSync, so
+	 * direct video, audio, and data capture is unavailable until the
+	 * multiviewer is destroyed.
+	 */
+	receiver: Receiver;
+	/** Left edge of the tile on the canvas, in pixels. Defaults to `0`. */
+	x?: number;
+	/** Top edge of the tile on the canvas, in pixels. Defaults to `0`. */
+	y?: number;
+	width: number;
+	height: number;
+	/** Text drawn at the bottom of the tile (printable ASCII). */
+	label?: string;
+}
+
+export interface MultiviewerOptions {
+	/** NDI source name of the composited output. */
+	name: string;
+	groups?: string;
+	/** Canvas width in pixels. Defaults to `1920`. */
+	xres?: number;
+	/** Canvas height in pixels. Defaults to `1080`. */
+	yres?: number;
+	/** Output frame rate numerator. Defaults to `30`. */
+	frameRateN?: number;
+	/** Output frame rate denominator. Defaults to `1`. */
+	frameRateD?: number;
+	/**
+	 * Canvas format: `UYVY` (default), `BGRA`, `BGRX`, `RGBA`, or `RGBX`. With
+	 * `UYVY`, `xres` and every tile `x` and `width` must be even.
+	 */
+	fourCC?: VideoFourCC;
+	/** Canvas color behind and between tiles, as `"#rrggbb"`. Defaults to black. */
+	background?: string;
+	/** Outline width of every tile, in pixels. Defaults to `2`. */
+	border?: number;
+	/** Outline color, as `"#rrggbb"`. Defaults to `"#404040"`. */
+	borderColor?: string;
+	/**
+	 * Threads that compose tiles in parallel, including the output thread.
+	 * Defaults to the smaller of the tile count and the CPU count.
+	 */
+	threads?: number;
+	/** Up to 64 tiles. Tiles must lie within the canvas and must not overlap. */
+	tiles: MultiviewerTile[];
+	/** Placement of the output thread and the threads that compose tiles. */
+	scheduling?: ThreadScheduling;
+}
+
+export interface MultiviewerTileStats {
+	/** Whether the tile's source has delivered video. */
+	signal: boolean;
+	/** Size of the latest source frame, or `0` without a signal. */
+	xres: number;
+	yres: number;
+}
+
+export interface MultiviewerStats {
+	framesSent: number;
+	/** Frames whose composition took longer than one frame interval. */
+	lateFrames: number;
+	/** Time spent composing each output frame, in milliseconds. */
+	composeMs: { mean: number; max: number; last: number };
+	tiles: MultiviewerTileStats[];
+}
+
+export interface Multiviewer {
+	name: string;
+	/** Number of tiles. */
+	size: number;
+	xres: number;
+	yres: number;
+	/** Replaces the label of a tile; an empty string removes it. */
+	setLabel(index: number, label: string): void;
+	/** Draws a red (program) or green (preview) outline around a tile. */
+	setTally(index: number, state: ReceiverTallyState): void;
+	connections(): number;
+	sourceName(): string;
+	stats(): MultiviewerStats;
+	/**
+	 * Stops the output, destroys the sender, and releases the receivers.
+	 */
+	destroy(): boolean;
+}
+
+export interface PublishShmOptions {
+	/** Receiver whose video is published; bound until `destroy()`. */
+	receiver: Receiver;
+	/**
+	 * POSIX shared-memory name, with or without the leading `/`. On Linux the
+	 * ring appears as `/dev/shm/<name>`.
+	 */
+	name: string;
+	/** Frames the ring holds, from 2 to 64. Defaults to 4. */
+	slots?: number;
+	/**
+	 * Largest frame in bytes, rounded up to 4096. Larger frames are dropped.
+	 * Defaults to 8294400, one 1920x1080 frame at 4 bytes per pixel.
+	 */
+	slotBytes?: number;
+	/** Unlink an existing ring of the same name first. Defaults to `false`. */
+	replace?: boolean;
+	/** Placement of the thread that copies frames into the ring. */
+	scheduling?: ThreadScheduling;
+}
+export interface ShmPublisherStats {
+	framesPublished: number;
+	/** Frames without data or larger than `slotBytes`. */
+	framesDropped: number;
+	/** Time spent copying each frame into the ring, in milliseconds. */
+	copyMs: { mean: number; max: number };
+}
+export interface ShmPublisher {
+	/** Normalized name, with the leading `/`. */
+	name: string;
+	slots: number;
+	slotBytes: number;
+	stats(): ShmPublisherStats;
+	/**
+	 * Marks the ring closed, unlinks its name, and releases the receiver.
+	 * Readers keep their mappings until they unmap them.
+	 */
+	destroy(): boolean;
+}
+export interface SendShmOptions {
+	/** Sender whose video the ring feeds; bound until `destroy()`. */
+	sender: Sender;
+	/** Name of a ring another process created, with or without the `/`. */
+	name: string;
+	/** Placement of the thread that sends frames from the ring. */
+	scheduling?: ThreadScheduling;
+}
+export interface ShmSenderStats {
+	framesSent: number;
+	/** Frames whose slot did not describe a valid frame. */
+	framesDropped: number;
+	/** Set once the writer closed the ring and every frame was sent. */
+	closed: boolean;
+	/** Why the last frame was dropped. */
+	lastError?: string;
+}
+export interface ShmSender {
+	/** Normalized name, with the leading `/`. */
+	name: string;
+	slots: number;
+	slotBytes: number;
+	stats(): ShmSenderStats;
+	/**
+	 * Stops sending, releases every frame to the writer, and releases the
+	 * sender. The ring is left for the writer to unlink.
+	 */
+	destroy(): boolean;
+}
+
+export type PipeContainer = "nut" | "y4m" | "raw";
+export interface PipeOptions {
+	/** Receiver whose frames are written; bound until `destroy()`. */
+	receiver: Receiver;
+	/**
+	 * Open, writable file descriptor, such as the standard input of a child
+	 * process or a FIFO. It is made non-blocking while the pipe runs and is
+	 * never closed by it.
+	 */
+	fd: number;
+	/**
+	 * `"nut"` carries every format as rawvideo, plus audio; `"y4m"` carries
+	 * 4:2:0 and 4:2:2 YUV as planar YUV4MPEG2; `"raw"` writes the pictures
+	 * back to back without padding. Defaults to `"nut"`.
+	 */
+	container?: PipeContainer;
+	/**
+	 * Also write audio as 32-bit float PCM, with the `"nut"` container only.
+	 * The stream then starts once both a video and an audio frame arrived.
+	 * Defaults to `false`.
+	 */
+	audio?: boolean;
+	/** Placement of the thread that writes to the descriptor. */
+	scheduling?: ThreadScheduling;
+}
+export interface PipeStats {
+	framesWritten: number;
+	audioFramesWritten: number;
+	/**
+	 * Frames the container cannot carry, or whose format differs from the
+	 * first frame.
+	 */
+	framesDropped: number;
+	bytesWritten: number;
+	/**
+	 * Time spent waiting for the reader to make room, in milliseconds, in
+	 * total and for the slowest frame. A total that grows as fast as the
+	 * clock means the reader, such as an encoder, is the bottleneck.
+	 */
+	stallMs: { total: number; max: number };
+	/** Set once the reader closed its end or a write failed. */
+	closed: boolean;
+	/** Why the last frame was dropped or writing stopped. */
+	lastError?: string;
+}
+export interface FramePipe {
+	fd: number;
+	container: PipeContainer;
+	audio: boolean;
+	stats(): PipeStats;
+	/**
+	 * Stops writing and releases the receiver. The descriptor stays open;
+	 * close it, or end the child's standard input, to finish the stream.
+	 */
+	destroy(): boolean;
+}
+
+export type RecordCompression = "lz4" | "none";
+export interface RecordOptions {
+	/** Receiver whose frames are recorded; bound until `destroy()`. */
+	receiver: Receiver;
+	/** File to create. */
+	path: string;
+	/** Overwrite `path` if it exists. Defaults to `false`. */
+	replace?: boolean;
+	/**
+	 * `"lz4"` compresses each frame losslessly; `"none"` stores it as
+	 * received. Defaults to `"lz4"`.
+	 */
+	compression?: RecordCompression;
+	/**
+	 * Threads that compress the stripes of a frame in parallel, from 1 to
+	 * 64. Defaults to the number of CPUs, up to 4.
+	 */
+	threads?: number;
+	/**
+	 * Independent slices each frame is split into for compression, from 1
+	 * to 64. Small frames use fewer so each slice stays at least 64 KiB.
+	 * Defaults to 8.
+	 */
+	stripes?: number;
+	/** Also record planar float audio. Defaults to `false`. */
+	audio?: boolean;
+	/**
+	 * How often the recording and its sidecar index are forced to disk, in
+	 * milliseconds, from 0 for after every frame to 60000. A crash loses at
+	 * most this much. Defaults to 1000.
+	 */
+	syncIntervalMs?: number;
+	/** Placement of the writer thread and the compression threads. */
+	scheduling?: ThreadScheduling;
+}
+export interface RecorderStats {
+	framesRecorded: number;
+	audioFramesRecorded: number;
+	/** Frames without data, or that could not be compressed. */
+	framesDropped: number;
+	/** Frame bytes as received. */
+	bytesIn: number;
+	/** Frame bytes as written, without record headers. */
+	bytesOut: number;
+	/** `bytesIn` divided by `bytesOut`. */
+	ratio: number;
+	/** Time spent compressing a frame, in milliseconds. */
+	compressMs: { mean: number; max: number };
+	/** Time spent handing a frame to the file, in milliseconds. */
+	writeMs: { mean: number; max: number };
+	/** Times the files were forced to disk. */
+	syncs: number;
+	/** Time spent forcing the files to disk, in milliseconds. */
+	syncMs: { mean: number; max: number };
+	/** Set once a write failed; nothing is recorded after it. */
+	failed: boolean;
+	/** Why the last frame was dropped or recording stopped. */
+	lastError?: string;
+}
+export interface Recorder {
+	path: string;
+	compression: RecordCompression;
+	threads: number;
+	stripes: number;
+	syncIntervalMs: number;
+	stats(): RecorderStats;
+	/**
+	 * Stops recording, writes the index, closes the file, and releases the
+	 * receiver.
+	 */
+	destroy(): boolean;
+}
+
+export interface OpenRecordingOptions {
+	/** Recording made by `record()`. */
+	path: string;
+}
+export interface RecordingEntry {
+	position: number;
+	type: "video" | "audio";
+	timestamp: bigint;
+	timecode: Timecode;
+	/** Byte offset of the record in the recording. */
+	offset: number;
+}
+export type RecordingSeekTarget = {
+	/** Frames to consider. Defaults to `"video"`. */
+	type?: "video" | "audio" | "any";
+} & (
+	| { timestamp: bigint; timecode?: undefined }
+	| {
+			timestamp?: undefined;
+			/**
+			 * NDI timecode, or SMPTE text such as `"01:23:45:12"` at the
+			 * frame rate of the first video frame. A `;` before the frames
+			 * counts drop-frame.
+			 */
+			timecode: Timecode | string;
+	  }
+);
+export interface Recording {
+	path: string;
+	/** Frames in the index. `refresh()` updates it. */
+	length: number;
+	/**
+	 * Whether the index is read from the sidecar file, rather than from the
+	 * end of a closed recording.
+	 */
+	sidecar: boolean;
+	/** Index entry of a frame, without reading the frame. */
+	entry(position: number): RecordingEntry;
+	/**
+	 * Finds the last frame at or before a timestamp or timecode with a
+	 * binary search of the index, and moves `read()` to it.
+	 * @returns Its position, or -1 when every frame is later.
+	 */
+	seek(target: RecordingSeekTarget): number;
+	/**
+	 * Reads and decompresses a frame, by default the one after the last
+	 * read or the one found by `seek()`. Rejects at the end of the
+	 * recording.
+	 */
+	read(position?: number): Promise<ReceivedVideoFrame | ReceivedAudioFrame>;
+	/**
+	 * Maps the sidecar again to pick up frames recorded since the recording
+	 * was opened.
+	 * @returns The new length.
+	 */
+	refresh(): number;
+	destroy(): boolean;
+}
+
+export interface ClockSourceEstimate {
+	/** NDI source name as passed to `receive()`. */
+	name: string;
+	/** Points in the regression window. */
+	samples: number;
+	/** Frames with timestamps observed from this source. */
+	observations: number;
+	/**
+	 * How much later frames arrive than their timestamps read on the local
+	 * wall clock, in milliseconds. Combines transport latency and the sender
+	 * clock offset.
+	 */
+	offsetMs: number;
+	/** Sender clock rate error against the local monotonic clock, in ppm. */
+	skewPpm: number;
+	/** Residual standard deviation of the fit, in milliseconds. */
+	jitterMs: number;
+}
+
+export interface Clock {
+	/** Current time as an NDI timestamp (100 ns units since the UNIX epoch). */
+	now(): bigint;
+	/**
+	 * Converts an NDI timestamp to `process.hrtime.bigint()` nanoseconds.
+	 * With `source`, uses that source's fit, which maps a timestamp to its
+	 * expected arrival. Otherwise, or for unknown sources, uses the local wall
+	 * clock.
+	 */
+	toMonotonic(timestamp: bigint, source?: string): bigint;
+	/** Offset and skew estimates for every source that has delivered frames. */
+	sources(): ClockSourceEstimate[];
 }
 
 export interface Finder {
@@ -327,6 +1416,36 @@ export interface ReceiveOptions {
 	 */
 	allowVideoFields?: boolean;
 	name?: string;
+	/**
+	 * Track the offset between video and audio as they are captured. `true`
+	 * uses the default window; see `Receiver.avSync()`.
+	 */
+	avSync?: boolean | ReceiverAvSyncOptions;
+	/**
+	 * Convert received video to a fixed frame rate by dropping or repeating
+	 * frames by timestamp. Applies to video from `video()` and `data()`.
+	 */
+	outputFrameRate?: ReceiverFrameRateOptions;
+	/**
+	 * Rebuild progressive frames from interlaced video in native code.
+	 * Applies to `video()`; cannot be combined with `outputFrameRate`.
+	 */
+	deinterlace?: DeinterlaceOptions;
+	/**
+	 * Stamp timecode, the source name, or a frame counter into received video
+	 * on the capture thread. `true` uses the defaults.
+	 */
+	burnIn?: boolean | BurnInOptions;
+	/**
+	 * Hash received video on the capture thread and set `hash` and
+	 * `duplicate` on each frame. Line padding is not hashed. Suppressing
+	 * duplicates cannot be combined with `outputFrameRate` or `deinterlace`.
+	 */
+	hash?: FrameHashAlgorithm | FrameHashOptions;
+	/**
+	 * Score motion for `Receiver.motion()`. `true` uses the defaults.
+	 */
+	motion?: boolean | MotionOptions;
 }
 
 export interface SendOptions {
@@ -334,6 +1453,16 @@ export interface SendOptions {
 	groups?: string;
 	clockVideo?: boolean;
 	clockAudio?: boolean;
+	/**
+	 * Send progressive and interlaced frames as a field 0 frame followed by a
+	 * field 1 frame. Field frames are sent unchanged.
+	 */
+	splitFields?: boolean;
+	/**
+	 * Stamp timecode, the sender name, or a frame counter into a copy of each
+	 * sent frame. `true` uses the defaults.
+	 */
+	burnIn?: boolean | BurnInOptions;
 }
 
 export interface Grandi {
@@ -425,7 +1554,142 @@ export interface Grandi {
 	 * Destroy the frame-sync before the receiver. Direct capture becomes available
 	 * again after the frame-sync is destroyed.
 	 */
-	frameSync(receiver: Receiver): Promise<FrameSync>;
+	frameSync(receiver: Receiver, options?: FrameSyncOptions): Promise<FrameSync>;
+	/**
+	 * Captures video from several receivers on native threads and delivers
+	 * frames taken at the same instant together. Frames are matched on their
+	 * receive timestamp, or on timecode when the SDK reports no timestamp.
+	 * The group keeps the process alive until it is destroyed.
+	 *
+	 * @example
+	 * ```js
+	 * import grandi from "grandi";
+	 * const group = await grandi.syncGroup({
+	 * 	receivers: [left, right],
+	 * 	toleranceMs: 5,
+	 * 	callback(set) {
+	 * 		if (set.complete) analyse(set.frames);
+	 * 	},
+	 * });
+	 * console.log(group.stats().alignmentErrorMs);
+	 * group.destroy();
+	 * ```
+	 */
+	syncGroup(params: SyncGroupOptions): Promise<SyncGroup>;
+	/**
+	 * Composites several receivers into tiles of one canvas and sends it as a
+	 * clocked NDI source. Sources are scaled natively to fit their tiles,
+	 * keeping their aspect ratio, and tiles are composed in parallel on native
+	 * threads. The multiviewer keeps the process alive until it is destroyed.
+	 *
+	 * @example
+	 * ```js
+	 * import grandi from "grandi";
+	 * const wall = await grandi.multiviewer({
+	 * 	name: "Monitoring Wall",
+	 * 	tiles: receivers.map((receiver, i) => ({
+	 * 		receiver,
+	 * 		x: (i % 4) * 480,
+	 * 		y: Math.floor(i / 4) * 270,
+	 * 		width: 480,
+	 * 		height: 270,
+	 * 		label: `CAM ${i + 1}`,
+	 * 	})),
+	 * });
+	 * wall.setTally(0, { onProgram: true });
+	 * ```
+	 */
+	multiviewer(params: MultiviewerOptions): Promise<Multiviewer>;
+	/**
+	 * Publishes the video of a receiver into a POSIX shared-memory ring that
+	 * other processes map without copying, such as encoders or GPU uploaders.
+	 * A native thread captures each frame and writes it into the next slot;
+	 * readers follow with the seqlock and futex helpers of the
+	 * `include/grandi_shm.h` C header. Not supported on Windows.
+	 *
+	 * @example
+	 * ```js
+	 * import grandi from "grandi";
+	 * const ring = await grandi.publishShm({
+	 * 	receiver,
+	 * 	name: "studio-cam-1",
+	 * 	slots: 8,
+	 * });
+	 * // ./encoder /studio-cam-1
+	 * ```
+	 */
+	publishShm(params: PublishShmOptions): Promise<ShmPublisher>;
+	/**
+	 * Sends the frames another process writes into a POSIX shared-memory
+	 * ring, so Node.js only orchestrates. Each frame is passed to the SDK in
+	 * place and released to the writer once the next frame was submitted;
+	 * the writer uses `grandi_shm_wait_writable()` from
+	 * `include/grandi_shm.h` to avoid overwriting it. `sender.video()` is
+	 * unavailable until the returned object is destroyed. Not supported on
+	 * Windows.
+	 *
+	 * @example
+	 * ```js
+	 * import grandi from "grandi";
+	 * const sender = await grandi.send({ name: "Renderer", clockVideo: true });
+	 * const input = await grandi.sendShm({ sender, name: "renderer" });
+	 * ```
+	 */
+	sendShm(params: SendShmOptions): Promise<ShmSender>;
+	/**
+	 * Streams the frames of a receiver into a file descriptor, typically the
+	 * standard input of an encoder such as FFmpeg. A native thread captures
+	 * each frame and writes it with `writev()`, without copying planar data;
+	 * when the reader falls behind, writing waits for it and the wait shows
+	 * up in `stats().stallMs`. Not supported on Windows.
+	 *
+	 * @example
+	 * ```js
+	 * import { spawn } from "node:child_process";
+	 * import grandi from "grandi";
+	 * const ffmpeg = spawn("ffmpeg", ["-f", "nut", "-i", "-", "out.mkv"], {
+	 * 	stdio: ["pipe", "inherit", "inherit"],
+	 * });
+	 * const pipe = await grandi.pipe({
+	 * 	receiver,
+	 * 	fd: ffmpeg.stdin._handle.fd,
+	 * 	audio: true,
+	 * });
+	 * ```
+	 */
+	pipe(params: PipeOptions): Promise<FramePipe>;
+	/**
+	 * Records the frames of a receiver into a file. A native thread captures
+	 * each frame, splits it into stripes that a pool of threads compresses
+	 * with LZ4, and appends it to the file with its timestamp and timecode.
+	 * An index of every frame is written when the recorder is destroyed.
+	 *
+	 * @example
+	 * ```js
+	 * const recorder = await grandi.record({
+	 * 	receiver,
+	 * 	path: "camera.grec",
+	 * 	audio: true,
+	 * });
+	 * setInterval(() => console.log(recorder.stats().ratio), 1000);
+	 * ```
+	 */
+	record(params: RecordOptions): Promise<Recorder>;
+	/**
+	 * Opens a recording made by `record()` to seek and read in it. The
+	 * index is memory-mapped, so seeking by timestamp or timecode is a
+	 * binary search that reads no frames; a recording that is still being
+	 * written can be opened too. Not supported on Windows.
+	 *
+	 * @example
+	 * ```js
+	 * import grandi from "grandi";
+	 * const recording = await grandi.openRecording({ path: "camera.grec" });
+	 * recording.seek({ timecode: "01:23:45:12" });
+	 * const frame = await recording.read();
+	 * ```
+	 */
+	openRecording(params: OpenRecordingOptions): Promise<Recording>;
 	/**
 	 * Creates an NDI router for switching between different NDI sources.
 	 * @param params Router options.
@@ -459,6 +1723,246 @@ export interface Grandi {
 	 * ```
 	 */
 	find(params?: FindOptions): Promise<Finder>;
+	/**
+	 * Correlates NDI timestamps with the local monotonic clock. Estimates are
+	 * fitted from frames captured by every receiver in the process.
+	 *
+	 * @example
+	 * ```js
+	 * import grandi from "grandi";
+	 * const frame = await receiver.video(1000);
+	 * const arrival = grandi.clock.toMonotonic(frame.timestamp, "Studio (Cam 1)");
+	 * const lateMs = Number(process.hrtime.bigint() - arrival) / 1e6;
+	 * ```
+	 */
+	clock: Clock;
+	/**
+	 * Splits a progressive or interlaced frame into its field 0 (even lines)
+	 * and field 1 (odd lines) frames. 4:2:0 formats are not supported.
+	 * @param frame Frame with an even `yres`.
+	 * @returns The two field frames, each `yres / 2` lines high.
+	 * @throws {Error} If the frame format or buffer is invalid.
+	 *
+	 * @example
+	 * ```js
+	 * import grandi from "grandi";
+	 * const [field0, field1] = grandi.splitFields(frame);
+	 * await sender.video(field0);
+	 * await sender.video(field1);
+	 * ```
+	 */
+	splitFields(frame: VideoFrame): [VideoFrame, VideoFrame];
+	/**
+	 * Weaves a field 0 and a field 1 frame into one interlaced frame.
+	 * @param field0 Field carrying the even lines.
+	 * @param field1 Field carrying the odd lines.
+	 * @returns An interlaced frame with the metadata of `field0`.
+	 * @throws {Error} If the fields differ in size, format, or stride.
+	 */
+	weaveFields(field0: VideoFrame, field1: VideoFrame): VideoFrame;
+	/**
+	 * Formats an NDI timecode as SMPTE timecode at a frame rate, with a `;`
+	 * before the frames when counting drop-frame. Hours wrap at 24.
+	 * @param timecode NDI timecode in 100 ns units since midnight.
+	 * @param options Frame rate to count frames at.
+	 * @returns `"HH:MM:SS:FF"` or `"HH:MM:SS;FF"`.
+	 *
+	 * @example
+	 * ```js
+	 * import grandi from "grandi";
+	 * const rate = { frameRateN: 30000, frameRateD: 1001 };
+	 * grandi.formatTimecode(frame.timecode, rate); // "01:00:00;00"
+	 * ```
+	 */
+	formatTimecode(timecode: Timecode, options: TimecodeOptions): string;
+	/**
+	 * Gets the NDI timecode of a frame number at a frame rate, for frames
+	 * numbered from midnight.
+	 * @param frame Non-negative frame number.
+	 * @param options Frame rate frames are numbered at.
+	 * @returns The start time of the frame in 100 ns units.
+	 */
+	frameTimecode(frame: number, options: TimecodeOptions): Timecode;
+	/**
+	 * Compares a test frame with a reference frame off the main thread: mean
+	 * squared error, PSNR, and SSIM per channel and for the whole frame.
+	 * Frames must have the same size and color model; alpha is ignored, so
+	 * UYVY compares with UYVA, and BGRA with RGBX. 4:2:0 formats are not
+	 * supported.
+	 * @param reference Frame as sent.
+	 * @param test Frame to score, such as the frame as received.
+	 * @param options Whether to compute SSIM.
+	 * @returns Quality of `test` against `reference`.
+	 *
+	 * @example
+	 * ```js
+	 * import grandi from "grandi";
+	 * const quality = await grandi.compareFrames(sent, received);
+	 * console.log(`${quality.psnr.toFixed(1)} dB, SSIM ${quality.ssim}`);
+	 * ```
+	 */
+	compareFrames(
+		reference: VideoFrame,
+		test: VideoFrame,
+		options?: CompareFramesOptions,
+	): Promise<FrameQuality>;
+	/**
+	 * Hashes the picture of a video frame, skipping line padding, so the
+	 * same picture gives the same hash at any line stride.
+	 * @param frame Frame to hash, in any format the SDK delivers.
+	 * @param algorithm Defaults to `"xxh3"`.
+	 * @returns 32 hex digits for `"xxh3"`, or 16 for `"sampled"`.
+	 *
+	 * @example
+	 * ```js
+	 * import grandi from "grandi";
+	 * if (grandi.hashFrame(received) !== grandi.hashFrame(sent)) {
+	 *   console.warn("picture changed in transit");
+	 * }
+	 * ```
+	 */
+	hashFrame(frame: VideoFrame, algorithm?: FrameHashAlgorithm): string;
+	/**
+	 * Threads, the calling one included, that split large frames into row
+	 * stripes. Scaling, motion analysis, deinterlacing, and copies of
+	 * received frames share them. Defaults to one per CPU, up to 16.
+	 */
+	workerThreads(): number;
+	/**
+	 * Resizes the shared stripe pool. `1` keeps all frame work on the thread
+	 * that asked for it; work already running finishes first.
+	 * @param threads From 1 to 256.
+	 * @param scheduling Placement of the pool threads. Omitting it restores
+	 * the default.
+	 *
+	 * @example
+	 * ```js
+	 * import grandi from "grandi";
+	 * // Leave cores free for the encoder running in this process.
+	 * grandi.setWorkerThreads(Math.max(1, grandi.workerThreads() - 4));
+	 * ```
+	 */
+	setWorkerThreads(threads: number, scheduling?: ThreadScheduling): void;
+	/**
+	 * Returns how frame copies in receivers and framesyncs write their
+	 * destination. Run `npm run bench -- --copy` to find the threshold at
+	 * which streaming pays off on a host.
+	 */
+	copyStrategy(): CopyStrategy;
+	/**
+	 * Changes how frame copies write their destination. Omitted fields keep
+	 * their current values.
+	 *
+	 * @example
+	 * ```js
+	 * import grandi from "grandi";
+	 * // Keep 1080p frames out of the cache as well as 4K ones.
+	 * grandi.setCopyStrategy({ mode: "auto", threshold: 4 << 20 });
+	 * ```
+	 */
+	setCopyStrategy(options: CopyStrategyOptions): void;
+	/**
+	 * Copies `source` into the start of `target` the way frame copies are
+	 * made: split over the stripe pool from 4 MiB and following the copy
+	 * strategy.
+	 * @throws If `target` is smaller than `source`.
+	 */
+	copyBuffer(target: Buffer, source: Buffer): void;
+	/**
+	 * Returns the settings of the allocator behind received frame buffers.
+	 * Buffers start on a 64-byte boundary, and those of 64 KiB and up on a
+	 * page.
+	 */
+	frameAllocator(): FrameAllocator;
+	/**
+	 * Changes the frame allocator. Omitted fields keep their current values.
+	 * A new `hugePages` mode empties the cache.
+	 * @throws If huge pages are requested outside Linux.
+	 *
+	 * @example
+	 * ```js
+	 * import grandi from "grandi";
+	 * // After `sysctl vm.nr_hugepages=512`:
+	 * grandi.setFrameAllocator({ hugePages: "hugetlb", cacheBytes: 256 << 20 });
+	 * ```
+	 */
+	setFrameAllocator(options: FrameAllocatorOptions): void;
+	/** Counts allocations, cache reuse, and huge page use. */
+	frameAllocatorStats(): FrameAllocatorStats;
+	/**
+	 * Returns the budget on frame memory in use across every receiver,
+	 * framesync, and sync group in the process.
+	 */
+	frameBudget(): FrameBudget;
+	/**
+	 * Changes the frame memory budget. Omitted fields keep their current
+	 * values. Applies to captures from then on; memory already in use is not
+	 * reclaimed.
+	 *
+	 * @example
+	 * ```js
+	 * import grandi from "grandi";
+	 * // Stall captures rather than grow past 1 GiB when JavaScript lags.
+	 * grandi.setFrameBudget({ bytes: 1 << 30, policy: "wait", waitMs: 200 });
+	 * ```
+	 */
+	setFrameBudget(options: FrameBudgetOptions): void;
+	/** Reports frame memory in use, its peak, and how captures pushed back. */
+	frameBudgetStats(): FrameBudgetStats;
+	/**
+	 * Lists the calling thread and every thread grandi runs, with where the
+	 * OS lets each run and its scheduling. Receivers and framesyncs work on
+	 * the libuv pool, which grandi does not own, so they are not listed.
+	 *
+	 * @example
+	 * ```js
+	 * import grandi from "grandi";
+	 * grandi.setWorkerThreads(4, { cpus: [4, 5, 6, 7] });
+	 * for (const thread of grandi.threadTopology()) {
+	 *   console.log(thread.role, thread.owner, thread.cpus, thread.lastCpu);
+	 * }
+	 * ```
+	 */
+	threadTopology(): ThreadInfo[];
+	/**
+	 * Runs receivers in worker threads, each with its own addon environment,
+	 * so capture and copies of many sources spread over cores. Each receiver
+	 * writes its video frames into a shared memory channel that any thread
+	 * can read.
+	 *
+	 * @example
+	 * ```js
+	 * import grandi from "grandi";
+	 * const pool = grandi.receiverPool({ workers: 4 });
+	 * const camera = await pool.add({ source });
+	 * const frame = await camera.frames.next(1000);
+	 * // Elsewhere: new Worker(file, { workerData: camera.channel }), then
+	 * // grandi.openFrameChannel(workerData).latest() in the worker.
+	 * await pool.destroy();
+	 * ```
+	 */
+	receiverPool(options?: ReceiverPoolOptions): ReceiverPool;
+	/** Reads the frames of a pooled receiver on the calling thread. */
+	openFrameChannel(channel: FrameChannel): FrameChannelReader;
+	/**
+	 * Recreates a detached receiver, sender, or framesync in the calling
+	 * thread. Its connection and native state carry over. Each token can be
+	 * adopted once; the last `destroy()` frees tokens never adopted.
+	 *
+	 * @example
+	 * ```js
+	 * // Main thread
+	 * worker.postMessage(receiver.detach());
+	 * // Worker
+	 * parentPort.on("message", async (token) => {
+	 *   const receiver = grandi.adopt(token);
+	 *   const frame = await receiver.video(1000);
+	 * });
+	 * ```
+	 */
+	adopt(token: DetachedReceiver): Receiver;
+	adopt(token: DetachedSender): Sender;
+	adopt(token: DetachedFrameSync): FrameSync;
 
 	/**
 	 * Enum: receiver video color formats.
@@ -1,16 +1,35 @@
+import {
+	closeSync,
+	ftruncateSync,
+	openSync,
+	readFileSync,
+	unlinkSync,
+	writeFileSync,
+	writeSync,
+} from "node:fs";
+import { tmpdir } from "node:os";
+import { join } from "node:path";
 import { setTimeout as sleep } from "node:timers/promises";
 
 import { afterAll, beforeAll, describe, expect, it, test } from "vitest";
 
 import grandi from "../../src/index.js";
 import type {
+	FramePipe,
 	FrameSync,
+	Multiviewer,
 	ReceivedAudioFrame,
+	Recorder,
+	Recording,
 	ReceivedVideoFrame,
 	Receiver,
 	Sender,
 	SenderTally,
+	ShmPublisher,
+	ShmSender,
 	Source,
+	SyncGroup,
+	SyncGroupSet,
 } from "../../src/types.js";
 
 async function waitForSourceByName(
@@ -243,6 +262,124 @@ describe("grandi native addon (integration)", () => {
 		expect(typeof grandi.isSupportedCPU()).toBe("boolean");
 	});
 
+	it("resizes the shared stripe pool", () => {
+		const threads = grandi.workerThreads();
+		expect(threads).toBeGreaterThanOrEqual(1);
+		expect(threads).toBeLessThanOrEqual(16);
+		grandi.setWorkerThreads(3);
+		expect(grandi.workerThreads()).toBe(3);
+		expect(() => grandi.setWorkerThreads(0)).toThrow(
+			"threads must be an integer between 1 and 256.",
+		);
+		expect(() => grandi.setWorkerThreads(1.5)).toThrow(
+			"threads must be an integer between 1 and 256.",
+		);
+		grandi.setWorkerThreads(threads);
+		expect(grandi.workerThreads()).toBe(threads);
+	});
+
+	it("copies buffers with each copy strategy", () => {
+		const strategy = grandi.copyStrategy();
+		expect(strategy).toMatchObject({ mode: "auto", threshold: 8 << 20 });
+		expect(typeof strategy.streamingStores).toBe("boolean");
+		const source = Buffer.alloc((9 << 20) + 13);
+		for (let i = 0; i < source.length; i += 997) source[i] = i & 0xff;
+		try {
+			for (const mode of ["auto", "cached", "streaming"] as const) {
+				grandi.setCopyStrategy({ mode, threshold: 1 << 20 });
+				expect(grandi.copyStrategy().mode).toBe(mode);
+				// An odd offset leaves the destination unaligned.
+				const target = Buffer.alloc(source.length + 1);
+				grandi.copyBuffer(target.subarray(1), source);
+				expect(target.subarray(1).equals(source)).toBe(true);
+			}
+		} finally {
+			grandi.setCopyStrategy(strategy);
+		}
+		expect(() => grandi.setCopyStrategy({ mode: "fast" as never })).toThrow(
+			'mode must be "auto", "cached", or "streaming".',
+		);
+		expect(() => grandi.copyBuffer(Buffer.alloc(1), source)).toThrow(
+			"target is smaller than source.",
+		);
+	});
+
+	it("configures the frame allocator", () => {
+		const settings = grandi.frameAllocator();
+		expect(settings.cacheBytes).toBe(64 << 20);
+		expect(settings.hugePages).toBe(
+			settings.hugePagesAvailable ? "transparent" : "off",
+		);
+		try {
+			grandi.setFrameAllocator({ cacheBytes: 2 ** 33 });
+			expect(grandi.frameAllocator().cacheBytes).toBe(2 ** 33);
+			grandi.setFrameAllocator({ hugePages: "off", cacheBytes: 0 });
+			expect(grandi.frameAllocator()).toMatchObject({
+				hugePages: "off",
+				cacheBytes: 0,
+			});
+			const stats = grandi.frameAllocatorStats();
+			expect(stats.cachedBytes).toBe(0);
+			expect(stats.bytesInUse).toBeLessThanOrEqual(stats.peakBytesInUse);
+		} finally {
+			grandi.setFrameAllocator(settings);
+		}
+		expect(() =>
+			grandi.setFrameAllocator({ hugePages: "always" as never }),
+		).toThrow('hugePages must be "off", "transparent", or "hugetlb".');
+		expect(() => grandi.setFrameAllocator({ cacheBytes: -1 })).toThrow(
+			"cacheBytes must be a byte count of 0 or more.",
+		);
+	});
+
+	it("configures the frame memory budget", () => {
+		expect(grandi.frameBudget()).toEqual({
+			bytes: 0,
+			policy: "drop",
+			waitMs: 100,
+		});
+		try {
+			grandi.setFrameBudget({ bytes: 256 << 20, policy: "reduce" });
+			expect(grandi.frameBudget()).toMatchObject({
+				bytes: 256 << 20,
+				policy: "reduce",
+			});
+			const stats = grandi.frameBudgetStats();
+			expect(stats.bytes).toBe(256 << 20);
+			expect(stats.bytesInUse).toBeLessThanOrEqual(stats.peakBytesInUse);
+		} finally {
+			grandi.setFrameBudget({ bytes: 0, policy: "drop", waitMs: 100 });
+		}
+		expect(() => grandi.setFrameBudget({ bytes: -1 })).toThrow(
+			"bytes must be a byte count of 0 or more.",
+		);
+		expect(() =>
+			grandi.setFrameBudget({ policy: "block" as never }),
+		).toThrow('policy must be "drop", "wait", or "reduce".');
+		expect(() => grandi.setFrameBudget({ waitMs: 60000 })).toThrow(
+			"waitMs must be an integer between 0 and 10000.",
+		);
+	});
+
+	it("reports thread topology and validates scheduling", () => {
+		const [main] = grandi.threadTopology();
+		expect(main).toMatchObject({ role: "javascript", owner: "" });
+		expect(main.cpus.length).toBeGreaterThan(0);
+		const threads = grandi.workerThreads();
+		try {
+			grandi.setWorkerThreads(2, { cpus: [main.cpus[0]] });
+			expect(grandi.workerThreads()).toBe(2);
+		} finally {
+			grandi.setWorkerThreads(threads);
+		}
+		expect(() => grandi.setWorkerThreads(2, { cpus: [] })).toThrow(
+			"scheduling.cpus must be a non-empty array of CPU numbers",
+		);
+		expect(() =>
+			grandi.setWorkerThreads(2, { realtimePriority: 100 }),
+		).toThrow("scheduling.realtimePriority must be an integer between 1");
+	});
+
 	it("creates and disposes finders", async () => {
 		const finder = await grandi.find({ showLocalSources: true });
 		expect(Array.isArray(finder.sources())).toBe(true);
@@ -347,12 +484,16 @@ describe("grandi native addon (integration)", () => {
 			await expect(receiver.data({}, Number.POSITIVE_INFINITY)).rejects.toThrow(
 				timeoutError,
 			);
+			const allocations = grandi.frameAllocatorStats().allocations;
 			const frame = await waitForVideoFrameSize(
 				receiver,
 				{ xres: 64, yres: 36 },
 				5000,
 			);
 			assertReceivedVideoFrame(frame);
+			expect(grandi.frameAllocatorStats().allocations).toBeGreaterThan(
+				allocations,
+			);
 			const connections = sender.connections();
 			expect(connections).toBeGreaterThanOrEqual(1);
 
@@ -813,4 +954,1405 @@ describe("grandi native addon (integration)", () => {
 			sender.destroy();
 		}
 	}, 120_000);
+
+	test("delivers aligned video sets from a sync group", async () => {
+		const senderName = `grandi-syncgroup-${Date.now()}`;
+		const sender = await grandi.send({
+			name: senderName,
+			clockVideo: true,
+			clockAudio: true,
+		});
+		const controller = { running: true };
+		const pumpTask = pumpFrames(sender, controller);
+		const receivers: Receiver[] = [];
+		let group: SyncGroup | undefined;
+
+		try {
+			const source = await waitForSourceByName(senderName);
+			for (let i = 0; i < 2; i++) {
+				receivers.push(
+					await grandi.receive({
+						source,
+						name: `${senderName}-receiver-${i}`,
+						colorFormat: grandi.ColorFormat.BGRX_BGRA,
+					}),
+				);
+			}
+			const [first, second] = receivers;
+			if (!first || !second) throw new Error("Receivers were not created.");
+
+			const sets: SyncGroupSet[] = [];
+			group = await grandi.syncGroup({
+				receivers,
+				toleranceMs: 20,
+				callback: (set) => sets.push(set),
+			});
+			expect(group.size).toBe(2);
+			await expect(first.video(0)).rejects.toThrow(
+				"Receiver capture is unavailable while a FrameSync is active.",
+			);
+			await expect(grandi.frameSync(second)).rejects.toThrow(
+				"Receiver is already bound to a FrameSync.",
+			);
+
+			const deadline = Date.now() + 10_000;
+			let complete: SyncGroupSet | undefined;
+			while (!complete && Date.now() < deadline) {
+				await sleep(50);
+				complete = sets.find(
+					(set) =>
+						set.complete &&
+						set.frames.every(
+							(frame) => frame?.xres === 64 && frame.yres === 36,
+						),
+				);
+			}
+			if (!complete) throw new Error("Timed out waiting for an aligned set");
+			expect(complete.missing).toEqual([]);
+			expect(complete.alignmentErrorMs).toBeLessThanOrEqual(20);
+			for (const frame of complete.frames) {
+				if (!frame) throw new Error("Complete set is missing a frame.");
+				assertReceivedVideoFrame(frame);
+			}
+
+			const stats = group.stats();
+			expect(stats.completeSets).toBeGreaterThanOrEqual(1);
+			expect(stats.members).toHaveLength(2);
+			expect(stats.alignmentErrorMs.max).toBeGreaterThanOrEqual(
+				stats.alignmentErrorMs.mean,
+			);
+
+			expect(group.destroy()).toBe(true);
+			const destroyedGroup = group;
+			expect(() => destroyedGroup.stats()).toThrow(
+				"Sync group has been destroyed.",
+			);
+			const resumedFrame = await waitForVideoFrameSize(
+				first,
+				{ xres: 64, yres: 36 },
+				5_000,
+			);
+			assertReceivedVideoFrame(resumedFrame);
+		} finally {
+			controller.running = false;
+			await pumpTask;
+			group?.destroy();
+			for (const receiver of receivers) receiver.destroy();
+			sender.destroy();
+		}
+	}, 120_000);
+
+	test("composites receivers into a multiviewer output", async () => {
+		const senderName = `grandi-multiviewer-${Date.now()}`;
+		const sender = await grandi.send({ name: senderName, clockVideo: true });
+		const controller = { running: true };
+		const pumpTask = pumpFrames(sender, controller);
+		const receivers: Receiver[] = [];
+		let wall: Multiviewer | undefined;
+
+		try {
+			const source = await waitForSourceByName(senderName);
+			for (let i = 0; i < 2; i++) {
+				receivers.push(
+					await grandi.receive({
+						source,
+						name: `${senderName}-tile-${i}`,
+						colorFormat: grandi.ColorFormat.UYVY_BGRA,
+					}),
+				);
+			}
+			const [left, right] = receivers;
+			if (!left || !right) throw new Error("Receivers were not created.");
+
+			const wallName = `${senderName}-wall`;
+			wall = await grandi.multiviewer({
+				name: wallName,
+				xres: 320,
+				yres: 90,
+				frameRateN: 30,
+				tiles: [
+					{ receiver: left, width: 160, height: 90, label: "LEFT" },
+					{ receiver: right, x: 160, width: 160, height: 90 },
+				],
+			});
+			expect(wall.size).toBe(2);
+			wall.setLabel(1, "RIGHT");
+			wall.setTally(0, { onProgram: true, onPreview: false });
+			expect(() => wall?.setLabel(2, "missing")).toThrow(
+				"index must identify a tile.",
+			);
+			await expect(left.video(0)).rejects.toThrow(
+				"Receiver capture is unavailable while a FrameSync is active.",
+			);
+
+			const monitor = await grandi.receive({
+				source: await waitForSourceByName(wallName),
+				colorFormat: grandi.ColorFormat.UYVY_BGRA,
+			});
+			try {
+				const frame = await waitForVideoFrameSize(
+					monitor,
+					{ xres: 320, yres: 90 },
+					10_000,
+				);
+				expect(frame.fourCC).toBe(grandi.FourCC.UYVY);
+			} finally {
+				monitor.destroy();
+			}
+
+			const stats = wall.stats();
+			expect(stats.framesSent).toBeGreaterThan(0);
+			expect(stats.tiles).toHaveLength(2);
+			expect(stats.composeMs.max).toBeGreaterThanOrEqual(stats.composeMs.mean);
+
+			expect(wall.destroy()).toBe(true);
+			expect(() => wall?.stats()).toThrow("Multiviewer has been destroyed.");
+			assertReceivedVideoFrame(
+				await waitForVideoFrameSize(left, { xres: 64, yres: 36 }, 5_000),
+			);
+		} finally {
+			controller.running = false;
+			await pumpTask;
+			wall?.destroy();
+			for (const receiver of receivers) receiver.destroy();
+			sender.destroy();
+		}
+	}, 120_000);
+
+	test("receives through a worker-thread receiver pool", async () => {
+		const senderName = `grandi-pool-${Date.now()}`;
+		const sender = await grandi.send({ name: senderName, clockVideo: true });
+		const controller = { running: true };
+		const pumpTask = pumpFrames(sender, controller);
+		const pool = grandi.receiverPool({ workers: 2, slotBytes: 1 << 20 });
+
+		try {
+			const source = await waitForSourceByName(senderName);
+			const first = await pool.add({
+				source,
+				colorFormat: grandi.ColorFormat.UYVY_BGRA,
+			});
+			const second = await pool.add({
+				source,
+				colorFormat: grandi.ColorFormat.UYVY_BGRA,
+			});
+			expect([first.worker, second.worker].sort()).toEqual([0, 1]);
+			expect(pool.load()).toEqual([1, 1]);
+
+			const frame = await first.frames.next(10_000);
+			expect(frame).toMatchObject({ type: "video", xres: 64, yres: 36 });
+			expect(frame?.fourCC).toBe(grandi.FourCC.UYVY);
+			expect(frame?.data.buffer).toBe(first.channel.buffer);
+			expect(frame?.valid()).toBe(true);
+			const reader = grandi.openFrameChannel(second.channel);
+			expect((await reader.next(10_000))?.xres).toBe(64);
+
+			await first.remove();
+			expect(first.frames.stats().closed).toBe(true);
+			expect(pool.load()[first.worker]).toBe(0);
+			expect(pool.load()[second.worker]).toBe(1);
+
+			// Closing the workers must leave the runtime to the main thread.
+			await pool.destroy();
+			const receiver = await grandi.receive({
+				source,
+				colorFormat: grandi.ColorFormat.UYVY_BGRA,
+			});
+			try {
+				assertReceivedVideoFrame(await receiver.video(10_000));
+			} finally {
+				receiver.destroy();
+			}
+		} finally {
+			controller.running = false;
+			await pumpTask;
+			await pool.destroy();
+			sender.destroy();
+		}
+		await expect(pool.add({ source: { name: senderName } })).rejects.toThrow(
+			"Receiver pool has been destroyed.",
+		);
+	}, 60_000);
+
+	test("detaches and adopts receivers, senders, and framesyncs", async () => {
+		const senderName = `grandi-adopt-${Date.now()}`;
+		const original = await grandi.send({ name: senderName, clockVideo: true });
+		const sender = grandi.adopt(original.detach());
+		expect(sender.name).toBe(senderName);
+		expect(sender.clockVideo).toBe(true);
+		expect(original.destroy()).toBe(false);
+		const controller = { running: true };
+		const pumpTask = pumpFrames(sender, controller);
+		const receivers: Receiver[] = [];
+		let frameSync: FrameSync | undefined;
+
+		try {
+			const source = await waitForSourceByName(senderName);
+			const first = await grandi.receive({
+				source,
+				name: `${senderName}-rx`,
+				colorFormat: grandi.ColorFormat.UYVY_BGRA,
+			});
+			receivers.push(first);
+			assertReceivedVideoFrame(
+				await waitForVideoFrameSize(first, { xres: 64, yres: 36 }, 10_000),
+			);
+			const token = first.detach();
+			expect(token).toMatchObject({ kind: "receiver" });
+			expect(() => first.detach()).toThrow("Receiver has been destroyed.");
+
+			const adopted = grandi.adopt(token);
+			receivers.push(adopted);
+			expect(adopted.name).toBe(`${senderName}-rx`);
+			expect(adopted.source.name).toBe(source.name);
+			expect(adopted.colorFormat).toBe(grandi.ColorFormat.UYVY_BGRA);
+			assertReceivedVideoFrame(
+				await waitForVideoFrameSize(adopted, { xres: 64, yres: 36 }, 10_000),
+			);
+			expect(() => grandi.adopt(token)).toThrow(
+				"Token has already been adopted or was released.",
+			);
+
+			frameSync = await grandi.frameSync(adopted);
+			expect(() => adopted.detach()).toThrow(
+				"Receiver is bound to a native consumer.",
+			);
+			frameSync = grandi.adopt(frameSync.detach());
+			assertReceivedVideoFrame(
+				await waitForFrameSyncVideoFrame(
+					frameSync,
+					{ xres: 64, yres: 36 },
+					10_000,
+				),
+			);
+		} finally {
+			controller.running = false;
+			await pumpTask;
+			frameSync?.destroy();
+			for (const receiver of receivers) receiver.destroy();
+			sender.destroy();
+		}
+	}, 60_000);
+
+	test("tracks the A/V offset of captured frames", async () => {
+		const senderName = `grandi-avsync-${Date.now()}`;
+		const sender = await grandi.send({
+			name: senderName,
+			clockVideo: true,
+			clockAudio: true,
+		});
+		const controller = { running: true };
+		const pumpTask = pumpFrames(sender, controller);
+		let receiver: Receiver | undefined;
+
+		try {
+			const source = await waitForSourceByName(senderName);
+			receiver = await grandi.receive({
+				source,
+				name: `${senderName}-receiver`,
+				colorFormat: grandi.ColorFormat.BGRX_BGRA,
+				avSync: { window: 20 },
+			});
+			await expect(
+				grandi.receive({ source, avSync: { window: 1 } }),
+			).rejects.toThrow("avSync.window must be between 2 and 10000.");
+
+			const deadline = Date.now() + 10_000;
+			while ((receiver.avSync()?.samples ?? 0) < 5) {
+				if (Date.now() > deadline)
+					throw new Error("Timed out waiting for A/V offset samples");
+				await receiver.data(1_000);
+			}
+
+			const stats = receiver.avSync();
+			if (!stats?.offsetMs) throw new Error("A/V offset was not reported.");
+			expect(stats.samples).toBeLessThanOrEqual(20);
+			expect(stats.videoFrames).toBeGreaterThan(0);
+			expect(stats.audioFrames).toBeGreaterThan(0);
+			expect(stats.offsetMs.stddev).toBeGreaterThanOrEqual(0);
+			expect(stats.offsetMs.min).toBeLessThanOrEqual(stats.offsetMs.mean);
+			expect(stats.offsetMs.max).toBeGreaterThanOrEqual(stats.offsetMs.mean);
+			expect(stats.testPattern).toBeUndefined();
+		} finally {
+			controller.running = false;
+			await pumpTask;
+			receiver?.destroy();
+			sender.destroy();
+		}
+	}, 120_000);
+
+	test("deinterlaces interleaved video", async () => {
+		const senderName = `grandi-deinterlace-${Date.now()}`;
+		const sender = await grandi.send({ name: senderName, clockVideo: true });
+		const width = 64;
+		const height = 36;
+		const stride = width * 4;
+		// Field 0 (even lines) is dark, field 1 (odd lines) is bright.
+		const data = Buffer.alloc(stride * height);
+		for (let y = 0; y < height; y++)
+			data.fill(y % 2 === 0 ? 0x20 : 0xc0, y * stride, (y + 1) * stride);
+		const controller = { running: true };
+		const pumpTask = (async () => {
+			while (controller.running) {
+				await sender.video({
+					type: "video",
+					xres: width,
+					yres: height,
+					frameRateN: 30,
+					frameRateD: 1,
+					pictureAspectRatio: width / height,
+					fourCC: grandi.FourCC.BGRA,
+					frameFormatType: grandi.FrameType.Interlaced,
+					lineStrideBytes: stride,
+					data,
+				});
+				await sleep(1000 / 30);
+			}
+		})();
+		let receiver: Receiver | undefined;
+
+		try {
+			const source = await waitForSourceByName(senderName);
+			receiver = await grandi.receive({
+				source,
+				name: `${senderName}-receiver`,
+				colorFormat: grandi.ColorFormat.BGRX_BGRA,
+				deinterlace: { mode: "bob", fieldRate: true },
+			});
+			await expect(
+				grandi.receive({ source, deinterlace: { mode: "weave" as never } }),
+			).rejects.toThrow(
+				'deinterlace.mode must be "bob", "blend", or "adaptive".',
+			);
+
+			const first = await receiver.video(5_000);
+			const second = await receiver.video(5_000);
+			for (const frame of [first, second]) {
+				expect(frame.frameFormatType).toBe(grandi.FrameType.Progressive);
+				expect(frame.yres).toBe(height);
+				expect(frame.frameRateN / frame.frameRateD).toBe(60);
+				expect(frame.data[stride]).toBe(frame.data[0]);
+			}
+			expect(first.data[0]).toBe(0x20);
+			expect(second.data[0]).toBe(0xc0);
+			if (first.timestamp !== undefined && second.timestamp !== undefined)
+				expect(second.timestamp - first.timestamp).toBe(166_666n);
+		} finally {
+			controller.running = false;
+			await pumpTask;
+			receiver?.destroy();
+			sender.destroy();
+		}
+	}, 120_000);
+
+	test("splits and weaves interlaced fields", async () => {
+		const width = 64;
+		const height = 36;
+		const stride = width * 4;
+		const data = Buffer.alloc(stride * height);
+		for (let y = 0; y < height; y++)
+			data.fill(y % 2 === 0 ? 0x20 : 0xc0, y * stride, (y + 1) * stride);
+		const frame = {
+			type: "video" as const,
+			xres: width,
+			yres: height,
+			frameRateN: 30,
+			frameRateD: 1,
+			pictureAspectRatio: width / height,
+			fourCC: grandi.FourCC.BGRA,
+			frameFormatType: grandi.FrameType.Interlaced,
+			lineStrideBytes: stride,
+			data,
+		};
+
+		const [field0, field1] = grandi.splitFields(frame);
+		expect(field0.frameFormatType).toBe(grandi.FrameType.Field0);
+		expect(field1.frameFormatType).toBe(grandi.FrameType.Field1);
+		expect(field0.yres).toBe(height / 2);
+		expect(field0.data.every((value) => value === 0x20)).toBe(true);
+		expect(field1.data.every((value) => value === 0xc0)).toBe(true);
+		const woven = grandi.weaveFields(field0, field1);
+		expect(woven.frameFormatType).toBe(grandi.FrameType.Interlaced);
+		expect(Buffer.compare(woven.data, data)).toBe(0);
+		expect(() => grandi.splitFields({ ...frame, yres: height - 1 })).toThrow(
+			"yres must be even to split fields.",
+		);
+
+		const senderName = `grandi-fields-${Date.now()}`;
+		const sender = await grandi.send({
+			name: senderName,
+			clockVideo: true,
+			splitFields: true,
+		});
+		expect(sender.splitFields).toBe(true);
+		const controller = { running: true };
+		const pumpTask = (async () => {
+			while (controller.running) {
+				await sender.video(frame);
+				await sleep(1000 / 30);
+			}
+		})();
+		let receiver: Receiver | undefined;
+
+		try {
+			const source = await waitForSourceByName(senderName);
+			receiver = await grandi.receive({
+				source,
+				colorFormat: grandi.ColorFormat.BGRX_BGRA,
+				allowVideoFields: true,
+			});
+			const received = await receiver.video(5_000);
+			expect([grandi.FrameType.Field0, grandi.FrameType.Field1]).toContain(
+				received.frameFormatType,
+			);
+			expect(received.yres).toBe(height / 2);
+		} finally {
+			controller.running = false;
+			await pumpTask;
+			receiver?.destroy();
+			sender.destroy();
+		}
+	}, 120_000);
+
+	test("keys overlays over sent video", async () => {
+		const width = 64;
+		const height = 36;
+		const stride = width * 4;
+		const frame = {
+			type: "video" as const,
+			xres: width,
+			yres: height,
+			frameRateN: 30,
+			frameRateD: 1,
+			pictureAspectRatio: width / height,
+			fourCC: grandi.FourCC.BGRA,
+			frameFormatType: grandi.FrameType.Progressive,
+			lineStrideBytes: stride,
+			data: Buffer.alloc(stride * height, 0x20),
+		};
+		// Opaque white on the left half, transparent on the right.
+		const overlay = {
+			xres: width,
+			yres: height,
+			fourCC: grandi.FourCC.BGRA as const,
+			data: Buffer.alloc(stride * height),
+		};
+		for (let y = 0; y < height; y++)
+			overlay.data.fill(0xff, y * stride, y * stride + stride / 2);
+
+		const senderName = `grandi-overlay-${Date.now()}`;
+		const sender = await grandi.send({ name: senderName, clockVideo: true });
+		expect(() =>
+			sender.setOverlay({ ...overlay, fourCC: grandi.FourCC.UYVY as never }),
+		).toThrow("overlay.fourCC must be UYVA, BGRA, or RGBA.");
+		await expect(
+			sender.video(frame, { overlay: { ...overlay, yres: height * 2 } }),
+		).rejects.toThrow(
+			"overlay.data must be a Buffer holding the whole overlay frame.",
+		);
+		await sender.video(frame, { overlay, x: 8, y: 4 });
+		expect(frame.data.every((value) => value === 0x20)).toBe(true);
+
+		sender.setOverlay(overlay);
+		const controller = { running: true };
+		const pumpTask = (async () => {
+			while (controller.running) {
+				await sender.video(frame);
+				await sleep(1000 / 30);
+			}
+		})();
+		let receiver: Receiver | undefined;
+
+		try {
+			const source = await waitForSourceByName(senderName);
+			receiver = await grandi.receive({
+				source,
+				colorFormat: grandi.ColorFormat.BGRX_BGRA,
+			});
+			const received = await waitForVideoFrameSize(receiver, {
+				xres: width,
+				yres: height,
+			});
+			const row = received.lineStrideBytes * (height / 2);
+			expect(received.data[row + 4 * 4]).toBeGreaterThan(0xe0);
+			expect(received.data[row + (width - 4) * 4]).toBeLessThan(0x40);
+		} finally {
+			controller.running = false;
+			await pumpTask;
+			sender.setOverlay(null);
+			receiver?.destroy();
+			sender.destroy();
+		}
+		expect(() => sender.setOverlay(null)).toThrow(
+			"Sender has been destroyed.",
+		);
+	}, 120_000);
+
+	test("formats timecode and burns it into sent video", async () => {
+		const rate = { frameRateN: 30000, frameRateD: 1001 };
+		expect(grandi.formatTimecode(grandi.frameTimecode(1799, rate), rate)).toBe(
+			"00:00:59;29",
+		);
+		expect(grandi.formatTimecode(grandi.frameTimecode(1800, rate), rate)).toBe(
+			"00:01:00;02",
+		);
+		const pal = { frameRateN: 25, frameRateD: 1 };
+		expect(grandi.frameTimecode(90_000, pal)).toBe(36_000_000_000n);
+		expect(grandi.formatTimecode(36_000_000_000n, pal)).toBe("01:00:00:00");
+		expect(() => grandi.frameTimecode(-1, pal)).toThrow(
+			"frame must be a non-negative safe integer.",
+		);
+		await expect(
+			grandi.send({ name: "burn-in", burnIn: { scale: 0 } }),
+		).rejects.toThrow("burnIn.scale must be an integer between 1 and 16.");
+
+		const width = 64;
+		const height = 36;
+		const stride = width * 4;
+		const frame = {
+			type: "video" as const,
+			xres: width,
+			yres: height,
+			frameRateN: 30,
+			frameRateD: 1,
+			pictureAspectRatio: width / height,
+			fourCC: grandi.FourCC.BGRA,
+			frameFormatType: grandi.FrameType.Progressive,
+			lineStrideBytes: stride,
+			data: Buffer.alloc(stride * height, 0x80),
+		};
+		const senderName = `grandi-burn-in-${Date.now()}`;
+		const sender = await grandi.send({
+			name: senderName,
+			clockVideo: true,
+			burnIn: { label: "CAM", position: "top-left" },
+		});
+		const controller = { running: true };
+		const pumpTask = (async () => {
+			while (controller.running) {
+				await sender.video(frame);
+				await sleep(1000 / 30);
+			}
+		})();
+		let receiver: Receiver | undefined;
+
+		try {
+			const source = await waitForSourceByName(senderName);
+			receiver = await grandi.receive({
+				source,
+				colorFormat: grandi.ColorFormat.BGRX_BGRA,
+			});
+			const received = await waitForVideoFrameSize(receiver, {
+				xres: width,
+				yres: height,
+			});
+			const pixel = (x: number, y: number) =>
+				received.data[y * received.lineStrideBytes + x * 4];
+			// The box starts 4 pixels in, with 2 pixels of padding.
+			expect(pixel(5, 5)).toBeLessThan(0x20);
+			let lit = 0;
+			for (let y = 6; y < 14; y++)
+				for (let x = 6; x < 30; x++) if (pixel(x, y) > 0xe0) lit++;
+			expect(lit).toBeGreaterThan(0);
+			expect(pixel(width - 2, height - 2)).toBe(0x80);
+			expect(frame.data.every((value) => value === 0x80)).toBe(true);
+		} finally {
+			controller.running = false;
+			await pumpTask;
+			receiver?.destroy();
+			sender.destroy();
+		}
+	}, 120_000);
+
+	test("computes scopes of received video", async () => {
+		const width = 64;
+		const height = 36;
+		const stride = width * 2;
+		// UYVY at luma 16 on the left half and 235 on the right, neutral chroma.
+		const data = Buffer.alloc(stride * height);
+		for (let y = 0; y < height; y++)
+			for (let x = 0; x < width; x++) {
+				data[y * stride + x * 2] = 128;
+				data[y * stride + x * 2 + 1] = x < width / 2 ? 16 : 235;
+			}
+		const frame = {
+			type: "video" as const,
+			xres: width,
+			yres: height,
+			frameRateN: 30,
+			frameRateD: 1,
+			pictureAspectRatio: width / height,
+			fourCC: grandi.FourCC.UYVY,
+			frameFormatType: grandi.FrameType.Progressive,
+			lineStrideBytes: stride,
+			data,
+		};
+		const senderName = `grandi-scopes-${Date.now()}`;
+		const sender = await grandi.send({ name: senderName, clockVideo: true });
+		const controller = { running: true };
+		const pumpTask = (async () => {
+			while (controller.running) {
+				await sender.video(frame);
+				await sleep(1000 / 30);
+			}
+		})();
+		let receiver: Receiver | undefined;
+
+		try {
+			const source = await waitForSourceByName(senderName);
+			receiver = await grandi.receive({
+				source,
+				colorFormat: grandi.ColorFormat.UYVY_BGRA,
+			});
+			await expect(receiver.scopes({ step: 0 })).rejects.toThrow(
+				"scopes.step must be an integer between 1 and 64.",
+			);
+			await waitForVideoFrameSize(receiver, { xres: width, yres: height });
+			const scopes = await receiver.scopes(
+				{ columns: 16, vectorscopeSize: 16, step: 1, render: true },
+				5_000,
+			);
+			const samples = width * height;
+			expect(scopes.xres).toBe(width);
+			expect(scopes.samples).toBe(samples);
+			// NDI compression is lossy, so levels are compared in ranges.
+			const sum = (bins: Uint32Array | undefined, from: number, to: number) =>
+				(bins ?? new Uint32Array()).slice(from, to).reduce((a, b) => a + b, 0);
+			expect(sum(scopes.histogram, 0, 64)).toBeGreaterThan(samples * 0.4);
+			expect(sum(scopes.histogram, 192, 256)).toBeGreaterThan(samples * 0.4);
+			let leftDark = 0;
+			let rightBright = 0;
+			for (let level = 0; level < 256; level++) {
+				const bins = scopes.waveform ?? new Uint32Array();
+				if (level < 64) leftDark += bins[level * 16];
+				if (level >= 192) rightBright += bins[level * 16 + 15];
+			}
+			expect(leftDark).toBeGreaterThan(0);
+			expect(rightBright).toBeGreaterThan(0);
+			const center =
+				sum(scopes.vectorscope, 7 * 16 + 7, 7 * 16 + 10) +
+				sum(scopes.vectorscope, 8 * 16 + 7, 8 * 16 + 10) +
+				sum(scopes.vectorscope, 9 * 16 + 7, 9 * 16 + 10);
+			expect(center).toBeGreaterThan(samples * 0.9);
+			expect(scopes.waveformImage?.data.length).toBe(16 * 256 * 4);
+		} finally {
+			controller.running = false;
+			await pumpTask;
+			receiver?.destroy();
+			sender.destroy();
+		}
+	}, 120_000);
+
+	test("scores motion in received video", async () => {
+		const width = 64;
+		const height = 36;
+		const stride = width * 2;
+		// UYVY whose left half flips between black and white every frame while
+		// the right half stays mid-grey.
+		const makeFrame = (left: number) => {
+			const data = Buffer.alloc(stride * height);
+			for (let y = 0; y < height; y++)
+				for (let x = 0; x < width; x++) {
+					data[y * stride + x * 2] = 128;
+					data[y * stride + x * 2 + 1] = x < width / 2 ? left : 126;
+				}
+			return {
+				type: "video" as const,
+				xres: width,
+				yres: height,
+				frameRateN: 30,
+				frameRateD: 1,
+				pictureAspectRatio: width / height,
+				fourCC: grandi.FourCC.UYVY,
+				frameFormatType: grandi.FrameType.Progressive,
+				lineStrideBytes: stride,
+				data,
+			};
+		};
+		const frames = [makeFrame(16), makeFrame(235)];
+		const senderName = `grandi-motion-${Date.now()}`;
+		const sender = await grandi.send({ name: senderName, clockVideo: true });
+		const controller = { running: true };
+		const pumpTask = (async () => {
+			for (let i = 0; controller.running; i++) {
+				await sender.video(frames[i % 2]);
+				await sleep(1000 / 30);
+			}
+		})();
+		let receiver: Receiver | undefined;
+
+		try {
+			const source = await waitForSourceByName(senderName);
+			await expect(
+				grandi.receive({ source, motion: { columns: 0 } }),
+			).rejects.toThrow(
+				"motion.columns must be an integer between 1 and 64.",
+			);
+			receiver = await grandi.receive({
+				source,
+				colorFormat: grandi.ColorFormat.UYVY_BGRA,
+				motion: { columns: 2, rows: 1, smoothing: 0, threshold: 0.2 },
+			});
+			await waitForVideoFrameSize(receiver, { xres: width, yres: height });
+			const motion = await receiver.motion({ waitForMotion: true }, 5_000);
+			expect(motion.xres).toBe(width);
+			expect(motion.motion).toBe(true);
+			expect(motion.reference).toBe(false);
+			expect(motion.scores).toHaveLength(2);
+			// NDI compression is lossy, so scores are compared in ranges.
+			expect(motion.active).toEqual([0]);
+			expect(motion.scores[0]).toBeGreaterThan(0.5);
+			expect(motion.scores[1]).toBeLessThan(0.05);
+			expect(motion.peak).toBe(motion.scores[0]);
+		} finally {
+			controller.running = false;
+			await pumpTask;
+			receiver?.destroy();
+			sender.destroy();
+		}
+	}, 120_000);
+
+	// Rings are visible as files under /dev/shm on Linux only.
+	(process.platform === "linux" ? test : test.skip)(
+		"publishes received video into a shared-memory ring",
+		async () => {
+			const width = 64;
+			const height = 36;
+			const frame = {
+				type: "video" as const,
+				xres: width,
+				yres: height,
+				frameRateN: 30,
+				frameRateD: 1,
+				pictureAspectRatio: width / height,
+				fourCC: grandi.FourCC.UYVY,
+				frameFormatType: grandi.FrameType.Progressive,
+				lineStrideBytes: width * 2,
+				data: Buffer.alloc(width * 2 * height, 0x80),
+			};
+			const senderName = `grandi-shm-${Date.now()}`;
+			const ringName = `grandi-test-${process.pid}`;
+			const sender = await grandi.send({ name: senderName, clockVideo: true });
+			const controller = { running: true };
+			const pumpTask = (async () => {
+				while (controller.running) {
+					await sender.video(frame);
+					await sleep(1000 / 30);
+				}
+			})();
+			let receiver: Receiver | undefined;
+			let ring: ShmPublisher | undefined;
+
+			try {
+				const source = await waitForSourceByName(senderName);
+				receiver = await grandi.receive({
+					source,
+					colorFormat: grandi.ColorFormat.UYVY_BGRA,
+				});
+				await expect(
+					grandi.publishShm({ receiver, name: "a/b" }),
+				).rejects.toThrow("name must be 1 to 200 characters");
+				ring = await grandi.publishShm({
+					receiver,
+					name: ringName,
+					slots: 3,
+					slotBytes: 10_000,
+					replace: true,
+				});
+				expect(ring.name).toBe(`/${ringName}`);
+				expect(ring.slotBytes).toBe(12_288);
+				await expect(
+					grandi.publishShm({ receiver, name: `${ringName}-2` }),
+				).rejects.toThrow("Receiver is already bound to a native consumer.");
+
+				const deadline = Date.now() + 10_000;
+				while (ring.stats().framesPublished < 3 && Date.now() < deadline)
+					await sleep(50);
+				expect(ring.stats().framesPublished).toBeGreaterThanOrEqual(3);
+
+				// Header and slot offsets follow include/grandi_shm.h.
+				const bytes = readFileSync(`/dev/shm/${ringName}`);
+				expect(bytes.readUInt32LE(0)).toBe(0x4d485347);
+				expect(bytes.readUInt32LE(4)).toBe(1);
+				expect(bytes.readUInt32LE(8)).toBe(3);
+				expect(bytes.readUInt32LE(12)).toBe(1);
+				const written = bytes.readBigUInt64LE(40);
+				expect(written).toBeGreaterThanOrEqual(3n);
+				const last = written - 1n;
+				const slot = 96 + Number(last % 3n) * 96;
+				expect(bytes.readBigUInt64LE(slot)).toBe(2n * last + 2n);
+				expect(bytes.readInt32LE(slot + 40)).toBe(width);
+				expect(bytes.readInt32LE(slot + 44)).toBe(height);
+
+				expect(ring.destroy()).toBe(true);
+				expect(() => readFileSync(`/dev/shm/${ringName}`)).toThrow();
+			} finally {
+				controller.running = false;
+				await pumpTask;
+				ring?.destroy();
+				receiver?.destroy();
+				sender.destroy();
+			}
+		},
+		120_000,
+	);
+
+	(process.platform === "linux" ? test : test.skip)(
+		"sends video from a shared-memory ring written by another process",
+		async () => {
+			// Writes a two-slot ring holding one UYVY frame, as an external
+			// writer would through include/grandi_shm.h.
+			const ringName = `grandi-input-${process.pid}`;
+			const path = `/dev/shm/${ringName}`;
+			const width = 64;
+			const height = 36;
+			const slotBytes = 12_288;
+			const header = Buffer.alloc(96 * 3);
+			header.writeUInt32LE(0x4d485347, 0);
+			header.writeUInt32LE(1, 4);
+			header.writeUInt32LE(2, 8);
+			header.writeUInt32LE(1, 12);
+			header.writeBigUInt64LE(BigInt(slotBytes), 16);
+			header.writeBigUInt64LE(4096n, 24);
+			header.writeBigUInt64LE(BigInt(4096 + 2 * slotBytes), 32);
+			header.writeBigUInt64LE(1n, 40);
+			const slot = 96;
+			header.writeBigUInt64LE(2n, slot);
+			header.writeBigInt64LE(0x7fffffffffffffffn, slot + 16);
+			header.writeUInt32LE(grandi.FourCC.UYVY, slot + 32);
+			header.writeInt32LE(width, slot + 40);
+			header.writeInt32LE(height, slot + 44);
+			header.writeInt32LE(width * 2, slot + 48);
+			header.writeInt32LE(30, slot + 52);
+			header.writeInt32LE(1, slot + 56);
+			header.writeFloatLE(width / height, slot + 60);
+			header.writeBigUInt64LE(BigInt(width * 2 * height), slot + 64);
+			const fd = openSync(path, "w+", 0o600);
+			ftruncateSync(fd, 4096 + 2 * slotBytes);
+			writeSync(fd, header, 0, header.length, 0);
+			const data = Buffer.alloc(width * 2 * height, 0x80);
+			writeSync(fd, data, 0, data.length, 4096);
+
+			const sender = await grandi.send({
+				name: `grandi-shm-input-${Date.now()}`,
+				clockVideo: true,
+			});
+			let input: ShmSender | undefined;
+			try {
+				await expect(
+					grandi.sendShm({ sender, name: `${ringName}-missing` }),
+				).rejects.toThrow("does not exist.");
+				input = await grandi.sendShm({ sender, name: ringName });
+				expect(input.slots).toBe(2);
+				expect(input.slotBytes).toBe(slotBytes);
+				await expect(
+					sender.video({
+						type: "video",
+						xres: width,
+						yres: height,
+						frameRateN: 30,
+						frameRateD: 1,
+						pictureAspectRatio: width / height,
+						fourCC: grandi.FourCC.UYVY,
+						frameFormatType: grandi.FrameType.Progressive,
+						lineStrideBytes: width * 2,
+						data,
+					}),
+				).rejects.toThrow("Sender video is fed by a native producer.");
+
+				// Close the ring; the sender drains it and releases every frame.
+				const state = Buffer.alloc(4);
+				state.writeUInt32LE(2);
+				writeSync(fd, state, 0, 4, 12);
+				const deadline = Date.now() + 10_000;
+				while (!input.stats().closed && Date.now() < deadline)
+					await sleep(50);
+				expect(input.stats()).toMatchObject({
+					framesSent: 1,
+					framesDropped: 0,
+					closed: true,
+				});
+				expect(readFileSync(path).readBigUInt64LE(48)).toBe(1n);
+				expect(input.destroy()).toBe(true);
+			} finally {
+				input?.destroy();
+				sender.destroy();
+				closeSync(fd);
+				unlinkSync(path);
+			}
+		},
+		120_000,
+	);
+
+	(process.platform === "win32" ? test.skip : test)(
+		"pipes received video into a file descriptor as YUV4MPEG2",
+		async () => {
+			const width = 64;
+			const height = 36;
+			const frame = {
+				type: "video" as const,
+				xres: width,
+				yres: height,
+				frameRateN: 30,
+				frameRateD: 1,
+				pictureAspectRatio: width / height,
+				fourCC: grandi.FourCC.UYVY,
+				frameFormatType: grandi.FrameType.Progressive,
+				lineStrideBytes: width * 2,
+				data: Buffer.alloc(width * 2 * height, 0x80),
+			};
+			const senderName = `grandi-pipe-${Date.now()}`;
+			const path = join(tmpdir(), `${senderName}.y4m`);
+			const sender = await grandi.send({ name: senderName, clockVideo: true });
+			const controller = { running: true };
+			const pumpTask = (async () => {
+				while (controller.running) {
+					await sender.video(frame);
+					await sleep(1000 / 30);
+				}
+			})();
+			const fd = openSync(path, "w");
+			let receiver: Receiver | undefined;
+			let pipe: FramePipe | undefined;
+
+			try {
+				const source = await waitForSourceByName(senderName);
+				receiver = await grandi.receive({
+					source,
+					colorFormat: grandi.ColorFormat.UYVY_BGRA,
+				});
+				await expect(
+					grandi.pipe({ receiver, fd, container: "y4m", audio: true }),
+				).rejects.toThrow("audio requires the nut container.");
+				pipe = await grandi.pipe({ receiver, fd, container: "y4m" });
+				expect(pipe.container).toBe("y4m");
+
+				const deadline = Date.now() + 10_000;
+				while (pipe.stats().framesWritten < 3 && Date.now() < deadline)
+					await sleep(50);
+				const stats = pipe.stats();
+				expect(stats.framesWritten).toBeGreaterThanOrEqual(3);
+				expect(stats.closed).toBe(false);
+				expect(pipe.destroy()).toBe(true);
+
+				// A header line, then FRAME and planar 4:2:2 per picture.
+				const bytes = readFileSync(path);
+				const text = bytes.toString("latin1");
+				const headerEnd = text.indexOf("\n") + 1;
+				expect(text.slice(0, headerEnd)).toBe(
+					`YUV4MPEG2 W${width} H${height} F30:1 Ip A1:1 C422\n`,
+				);
+				// Frames written after stats() was read are whole too.
+				const frameBytes = 6 + width * height * 2;
+				const written = (bytes.length - headerEnd) / frameBytes;
+				expect(Number.isInteger(written)).toBe(true);
+				expect(written).toBeGreaterThanOrEqual(stats.framesWritten);
+				expect(text.slice(headerEnd, headerEnd + 6)).toBe("FRAME\n");
+			} finally {
+				controller.running = false;
+				await pumpTask;
+				pipe?.destroy();
+				receiver?.destroy();
+				sender.destroy();
+				closeSync(fd);
+				unlinkSync(path);
+			}
+		},
+		120_000,
+	);
+
+	test("records received video into an LZ4 file with a seekable index", async () => {
+		const width = 64;
+		const height = 36;
+		const frame = {
+			type: "video" as const,
+			xres: width,
+			yres: height,
+			frameRateN: 30,
+			frameRateD: 1,
+			pictureAspectRatio: width / height,
+			fourCC: grandi.FourCC.UYVY,
+			frameFormatType: grandi.FrameType.Progressive,
+			lineStrideBytes: width * 2,
+			data: Buffer.alloc(width * 2 * height, 0x80),
+		};
+		const senderName = `grandi-record-${Date.now()}`;
+		const path = join(tmpdir(), `${senderName}.grec`);
+		const sender = await grandi.send({ name: senderName, clockVideo: true });
+		const controller = { running: true };
+		const pumpTask = (async () => {
+			while (controller.running) {
+				await sender.video(frame);
+				await sleep(1000 / 30);
+			}
+		})();
+		let receiver: Receiver | undefined;
+		let recorder: Recorder | undefined;
+		let recording: Recording | undefined;
+		const untimedPath = join(tmpdir(), `${senderName}-untimed.grec`);
+		let untimedRecording: Recording | undefined;
+
+		try {
+			const source = await waitForSourceByName(senderName);
+			receiver = await grandi.receive({
+				source,
+				colorFormat: grandi.ColorFormat.UYVY_BGRA,
+			});
+			await expect(
+				grandi.record({ receiver, path, compression: "zstd" as never }),
+			).rejects.toThrow('compression must be "lz4" or "none".');
+			recorder = await grandi.record({ receiver, path, threads: 2 });
+			expect(recorder.compression).toBe("lz4");
+			expect(recorder.threads).toBe(2);
+
+			const deadline = Date.now() + 10_000;
+			while (recorder.stats().framesRecorded < 3 && Date.now() < deadline)
+				await sleep(50);
+			const stats = recorder.stats();
+			expect(stats.framesRecorded).toBeGreaterThanOrEqual(3);
+			expect(stats.failed).toBe(false);
+			// A flat grey picture compresses far better than 2:1.
+			expect(stats.ratio).toBeGreaterThan(2);
+			expect(recorder.destroy()).toBe(true);
+
+			// The header points at the index, which ends the file.
+			const bytes = readFileSync(path);
+			expect(bytes.subarray(0, 8).toString("latin1")).toBe("GRANDREC");
+			const indexOffset = Number(bytes.readBigUInt64LE(16));
+			const entries = Number(bytes.readBigUInt64LE(24));
+			expect(entries).toBeGreaterThanOrEqual(stats.framesRecorded);
+			expect(indexOffset + entries * 32).toBe(bytes.length);
+			expect(Number(bytes.readBigUInt64LE(indexOffset))).toBe(32);
+			// The sidecar holds the same entries after its own header.
+			const sidecar = readFileSync(`${path}.idx`);
+			expect(sidecar.subarray(0, 8).toString("latin1")).toBe("GRANDIDX");
+			expect(sidecar.length).toBe(32 + entries * 32);
+
+			if (process.platform !== "win32") {
+				recording = await grandi.openRecording({ path });
+				expect(recording.length).toBe(entries);
+				const target = recording.entry(recording.length - 1);
+				expect(recording.seek({ timestamp: target.timestamp })).toBe(
+					target.position,
+				);
+				expect(recording.seek({ timestamp: 0n })).toBe(-1);
+				const video = await recording.read(target.position);
+				expect(video.type).toBe("video");
+				expect(video.timecode).toBe(target.timecode);
+				expect(video.data).toEqual(frame.data);
+				await expect(recording.read()).rejects.toThrow("End of recording.");
+
+				// An undefined timestamp, stored as INT64_MAX, in the middle of a
+				// copy without a sidecar breaks the index order.
+				const middle = Math.floor(entries / 2);
+				const untimed = Buffer.from(bytes);
+				untimed.writeBigInt64LE(2n ** 63n - 1n, indexOffset + middle * 32 + 8);
+				writeFileSync(untimedPath, untimed);
+				untimedRecording = await grandi.openRecording({ path: untimedPath });
+				expect(untimedRecording.seek({ timestamp: target.timestamp })).toBe(
+					target.position,
+				);
+				const { timestamp } = recording.entry(middle);
+				expect(untimedRecording.seek({ timestamp })).toBe(middle - 1);
+			}
+		} finally {
+			controller.running = false;
+			await pumpTask;
+			untimedRecording?.destroy();
+			recording?.destroy();
+			recorder?.destroy();
+			receiver?.destroy();
+			sender.destroy();
+			unlinkSync(path);
+			unlinkSync(`${path}.idx`);
+			if (untimedRecording) unlinkSync(untimedPath);
+		}
+	}, 120_000);
+
+	test("compares sent and received frames", async () => {
+		const width = 64;
+		const height = 36;
+		const stride = width * 2;
+		// UYVY horizontal luma ramp with neutral chroma.
+		const data = Buffer.alloc(stride * height);
+		for (let y = 0; y < height; y++)
+			for (let x = 0; x < width; x++) {
+				data[y * stride + x * 2] = 128;
+				data[y * stride + x * 2 + 1] = 16 + x * 3;
+			}
+		const frame = {
+			type: "video" as const,
+			xres: width,
+			yres: height,
+			frameRateN: 30,
+			frameRateD: 1,
+			pictureAspectRatio: width / height,
+			fourCC: grandi.FourCC.UYVY,
+			frameFormatType: grandi.FrameType.Progressive,
+			lineStrideBytes: stride,
+			data,
+		};
+
+		const same = await grandi.compareFrames(frame, {
+			...frame,
+			data: Buffer.from(data),
+		});
+		expect(same.psnr).toBe(Number.POSITIVE_INFINITY);
+		expect(same.ssim).toBe(1);
+		expect(same.channels.map((channel) => channel.name)).toEqual([
+			"y",
+			"cb",
+			"cr",
+		]);
+		const brighter = Buffer.from(data);
+		for (let i = 1; i < brighter.length; i += 2) brighter[i] += 4;
+		const shifted = await grandi.compareFrames(
+			frame,
+			{ ...frame, data: brighter },
+			{ ssim: false },
+		);
+		expect(shifted.channels[0].mse).toBe(16);
+		expect(shifted.mse).toBe(8);
+		expect(shifted.psnr).toBeCloseTo(10 * Math.log10((255 * 255) / 8), 6);
+		expect(shifted.ssim).toBeUndefined();
+		await expect(
+			grandi.compareFrames(frame, { ...frame, xres: width / 2 }),
+		).rejects.toThrow(
+			"Frames must have the same size and color model to be compared.",
+		);
+
+		const senderName = `grandi-quality-${Date.now()}`;
+		const sender = await grandi.send({ name: senderName, clockVideo: true });
+		const controller = { running: true };
+		const pumpTask = (async () => {
+			while (controller.running) {
+				await sender.video(frame);
+				await sleep(1000 / 30);
+			}
+		})();
+		let receiver: Receiver | undefined;
+
+		try {
+			const source = await waitForSourceByName(senderName);
+			receiver = await grandi.receive({
+				source,
+				colorFormat: grandi.ColorFormat.UYVY_BGRA,
+			});
+			const received = await waitForVideoFrameSize(receiver, {
+				xres: width,
+				yres: height,
+			});
+			// NDI compression is lossy, so quality is checked against floors.
+			const quality = await grandi.compareFrames(frame, received);
+			expect(quality.psnr).toBeGreaterThan(30);
+			expect(quality.ssim).toBeGreaterThan(0.9);
+		} finally {
+			controller.running = false;
+			await pumpTask;
+			receiver?.destroy();
+			sender.destroy();
+		}
+	}, 120_000);
+
+	test("hashes frames and skips duplicate received frames", async () => {
+		const width = 64;
+		const height = 36;
+		const stride = width * 2;
+		const data = Buffer.alloc(stride * height);
+		for (let i = 0; i < data.length; i += 2) {
+			data[i] = 128;
+			data[i + 1] = 16 + ((i >> 1) % 200);
+		}
+		const frame = {
+			type: "video" as const,
+			xres: width,
+			yres: height,
+			frameRateN: 30,
+			frameRateD: 1,
+			pictureAspectRatio: width / height,
+			fourCC: grandi.FourCC.UYVY,
+			frameFormatType: grandi.FrameType.Progressive,
+			lineStrideBytes: stride,
+			data,
+		};
+
+		const hash = grandi.hashFrame(frame);
+		expect(hash).toMatch(/^[0-9a-f]{32}$/);
+		expect(grandi.hashFrame(frame, "sampled")).toMatch(/^[0-9a-f]{16}$/);
+		// Line padding is not part of the picture.
+		const padded = Buffer.alloc((stride + 32) * height, 0xff);
+		for (let y = 0; y < height; y++)
+			data.copy(padded, y * (stride + 32), y * stride, (y + 1) * stride);
+		expect(
+			grandi.hashFrame({
+				...frame,
+				lineStrideBytes: stride + 32,
+				data: padded,
+			}),
+		).toBe(hash);
+		expect(() => grandi.hashFrame(frame, "md5" as never)).toThrow(
+			'algorithm must be "xxh3" or "sampled".',
+		);
+
+		const senderName = `grandi-hash-${Date.now()}`;
+		const sender = await grandi.send({ name: senderName, clockVideo: true });
+		const controller = { running: true };
+		const pumpTask = (async () => {
+			while (controller.running) {
+				await sender.video(frame);
+				await sleep(1000 / 30);
+			}
+		})();
+		let receiver: Receiver | undefined;
+
+		try {
+			const source = await waitForSourceByName(senderName);
+			await expect(
+				grandi.receive({
+					source,
+					hash: { skipDuplicates: true },
+					outputFrameRate: { frameRateN: 30, frameRateD: 1 },
+				}),
+			).rejects.toThrow(
+				"hash.skipDuplicates cannot be combined with outputFrameRate or deinterlace.",
+			);
+			receiver = await grandi.receive({
+				source,
+				colorFormat: grandi.ColorFormat.UYVY_BGRA,
+				hash: { algorithm: "xxh3", skipDuplicates: true },
+			});
+			const first = await waitForVideoFrameSize(receiver, {
+				xres: width,
+				yres: height,
+			});
+			expect(first.hash).toMatch(/^[0-9a-f]{32}$/);
+			expect(first.duplicate).toBe(false);
+			expect(typeof first.duplicatesSkipped).toBe("number");
+			// The sender repeats one picture, so later frames are either skipped
+			// or time out; none is delivered as a duplicate.
+			for (let i = 0; i < 5; i++) {
+				try {
+					const next = await receiver.video(200);
+					expect(next.duplicate).toBe(false);
+				} catch {
+					// Every captured frame was a duplicate.
+				}
+			}
+		} finally {
+			controller.running = false;
+			await pumpTask;
+			receiver?.destroy();
+			sender.destroy();
+		}
+	}, 120_000);
+
+	test("correlates source timestamps with the monotonic clock", async () => {
+		const senderName = `grandi-clock-${Date.now()}`;
+		const sender = await grandi.send({
+			name: senderName,
+			clockVideo: true,
+			clockAudio: true,
+		});
+		const controller = { running: true };
+		const pumpTask = pumpFrames(sender, controller);
+		let receiver: Receiver | undefined;
+
+		try {
+			const nowBefore = grandi.clock.now();
+			expect(typeof nowBefore).toBe("bigint");
+			expect(grandi.clock.now()).toBeGreaterThanOrEqual(nowBefore);
+
+			const source = await waitForSourceByName(senderName);
+			receiver = await grandi.receive({
+				source,
+				colorFormat: grandi.ColorFormat.BGRX_BGRA,
+			});
+
+			const deadline = Date.now() + 10_000;
+			let frame: ReceivedVideoFrame | undefined;
+			while (
+				!grandi.clock.sources().some((entry) => entry.name === source.name)
+			) {
+				if (Date.now() > deadline)
+					throw new Error("Timed out waiting for a clock estimate");
+				frame = await receiver.video(1_000);
+			}
+			const estimate = grandi.clock
+				.sources()
+				.find((entry) => entry.name === source.name);
+			expect(estimate?.samples).toBeGreaterThanOrEqual(1);
+			expect(estimate?.jitterMs).toBeGreaterThanOrEqual(0);
+
+			if (frame?.timestamp === undefined)
+				throw new Error("Received frame has no timestamp.");
+			const arrival = grandi.clock.toMonotonic(frame.timestamp, source.name);
+			const ageMs = Number(process.hrtime.bigint() - arrival) / 1e6;
+			expect(Math.abs(ageMs)).toBeLessThan(1_000);
+			expect(() => grandi.clock.toMonotonic(1 as never)).toThrow(
+				"timestamp must be a bigint.",
+			);
+		} finally {
+			controller.running = false;
+			await pumpTask;
+			receiver?.destroy();
+			sender.destroy();
+		}
+	}, 120_000);
+
+	test("converts received video to the output frame rate", async () => {
+		const senderName = `grandi-framerate-${Date.now()}`;
+		const sender = await grandi.send({ name: senderName, clockVideo: true });
+		const controller = { running: true };
+		const pumpTask = pumpFrames(sender, controller);
+		let receiver: Receiver | undefined;
+
+		try {
+			const source = await waitForSourceByName(senderName);
+			receiver = await grandi.receive({
+				source,
+				name: `${senderName}-receiver`,
+				colorFormat: grandi.ColorFormat.BGRX_BGRA,
+				outputFrameRate: { frameRateN: 15, frameRateD: 1 },
+			});
+			await expect(
+				grandi.receive({
+					source,
+					outputFrameRate: { frameRateN: 0, frameRateD: 1 },
+				}),
+			).rejects.toThrow(
+				"outputFrameRate.frameRateN must be between 1 and 1000000.",
+			);
+
+			for (let i = 0; i < 10; i++) {
+				const frame = await receiver.video(2_000);
+				expect(frame.frameRateN).toBe(15);
+				expect(frame.frameRateD).toBe(1);
+				expect(frame.data.length).toBe(frame.lineStrideBytes * frame.yres);
+			}
+
+			const stats = receiver.frameRateStats();
+			if (!stats) throw new Error("Frame rate stats were not reported.");
+			expect(stats.outputFrames).toBe(10);
+			expect(stats.droppedFrames).toBeGreaterThan(0);
+			expect(stats.inputFrames).toBeGreaterThan(stats.outputFrames);
+			expect(stats.blendedFrames).toBe(0);
+
+			// data() returns video from the same converter.
+			let converted = 0;
+			while (converted < 5) {
+				const payload = await receiver.data(2_000);
+				expect(payload.type).not.toBe("timeout");
+				if (payload.type !== "video") continue;
+				expect(payload.frameRateN).toBe(15);
+				expect(payload.frameRateD).toBe(1);
+				converted++;
+			}
+			expect(receiver.frameRateStats()?.outputFrames).toBe(15);
+		} finally {
+			controller.running = false;
+			await pumpTask;
+			receiver?.destroy();
+			sender.destroy();
+		}
+	}, 120_000);
 });
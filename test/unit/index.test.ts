@@ -32,6 +32,7 @@ function createAddonMock(): GrandiAddon {
 		}),
 		send: vi.fn().mockResolvedValue({
 			video: vi.fn(),
+			setOverlay: vi.fn(),
 			audio: vi.fn(),
 			connections: vi.fn(),
 			tally: vi.fn(),
@@ -47,6 +48,8 @@ function createAddonMock(): GrandiAddon {
 			audio: vi.fn(),
 			metadata: vi.fn(),
 			data: vi.fn(),
+			scopes: vi.fn(),
+			motion: vi.fn(),
 			destroy: vi.fn(),
 			embedded: {},
 			source: { name: "stub" },
@@ -62,6 +65,92 @@ function createAddonMock(): GrandiAddon {
 			destroy: vi.fn(),
 			embedded: {},
 		}),
+		syncGroup: vi.fn().mockResolvedValue({
+			stats: vi.fn(),
+			destroy: vi.fn(),
+			embedded: {},
+			size: 2,
+		}),
+		multiviewer: vi.fn().mockResolvedValue({
+			setLabel: vi.fn(),
+			setTally: vi.fn(),
+			stats: vi.fn(),
+			destroy: vi.fn(),
+			embedded: {},
+			size: 1,
+		}),
+		publishShm: vi.fn().mockResolvedValue({
+			stats: vi.fn(),
+			destroy: vi.fn(),
+			embedded: {},
+			name: "/unit-ring",
+		}),
+		sendShm: vi.fn().mockResolvedValue({
+			stats: vi.fn(),
+			destroy: vi.fn(),
+			embedded: {},
+			name: "/unit-input",
+		}),
+		pipe: vi.fn().mockResolvedValue({
+			stats: vi.fn(),
+			destroy: vi.fn(),
+			embedded: {},
+			fd: 9,
+			container: "nut",
+		}),
+		record: vi.fn().mockResolvedValue({
+			stats: vi.fn(),
+			destroy: vi.fn(),
+			embedded: {},
+			path: "/tmp/unit.grec",
+			compression: "lz4",
+			threads: 2,
+			stripes: 8,
+		}),
+		openRecording: vi.fn().mockResolvedValue({
+			entry: vi.fn(),
+			seek: vi.fn(),
+			read: vi.fn(),
+			refresh: vi.fn(),
+			destroy: vi.fn(),
+			embedded: {},
+			path: "/tmp/unit.grec",
+			length: 0,
+			sidecar: true,
+		}),
+		clockNow: vi.fn(() => 42n),
+		clockToMonotonic: vi.fn(() => 7n),
+		clockSources: vi.fn(() => []),
+		splitFields: vi.fn(() => [{}, {}]),
+		weaveFields: vi.fn(() => ({})),
+		formatTimecode: vi.fn(() => "00:00:00;00"),
+		frameTimecode: vi.fn(() => 0n),
+		compareFrames: vi.fn(async () => ({ psnr: 40 })),
+		hashFrame: vi.fn(() => "d1a90af11d79a67c"),
+		workerThreads: vi.fn(() => 8),
+		setWorkerThreads: vi.fn(),
+		copyStrategy: vi.fn(() => ({
+			mode: "auto",
+			threshold: 8 << 20,
+			streamingStores: true,
+		})),
+		setCopyStrategy: vi.fn(),
+		copyBuffer: vi.fn(),
+		frameAllocator: vi.fn(() => ({
+			hugePages: "transparent",
+			cacheBytes: 64 << 20,
+			hugePagesAvailable: true,
+		})),
+		setFrameAllocator: vi.fn(),
+		frameAllocatorStats: vi.fn(() => ({ allocations: 3, recycled: 1 })),
+		frameBudget: vi.fn(() => ({ bytes: 0, policy: "drop", waitMs: 100 })),
+		setFrameBudget: vi.fn(),
+		frameBudgetStats: vi.fn(() => ({ bytesInUse: 4096, dropped: 2 })),
+		threadTopology: vi.fn(() => [{ role: "javascript", cpus: [0] }]),
+		adopt: vi.fn(() => ({
+			sourcename: vi.fn(() => "stub-sender"),
+			tally: vi.fn(() => ({ on_program: true, on_preview: false })),
+		})),
 	};
 }
 
@@ -141,6 +230,16 @@ describe("src/index entrypoint", () => {
 		await expect(grandi.frameSync({} as never)).rejects.toThrow(
 			"Unsupported platform or CPU",
 		);
+		await expect(grandi.syncGroup({} as never)).rejects.toThrow(
+			"Unsupported platform or CPU",
+		);
+		expect(() => grandi.receiverPool()).toThrow("Unsupported platform or CPU");
+		expect(() => grandi.adopt({ kind: "receiver", id: 1 })).toThrow(
+			"Unsupported platform or CPU",
+		);
+		expect(typeof grandi.clock.now()).toBe("bigint");
+		expect(typeof grandi.clock.toMonotonic(0n)).toBe("bigint");
+		expect(grandi.clock.sources()).toEqual([]);
 	});
 
 	it("exposes enum-based constants on the default export", async () => {
@@ -300,6 +399,104 @@ describe("src/index entrypoint", () => {
 		await grandi.receive(receiveOpts as never);
 		expect(addon.receive).toHaveBeenLastCalledWith(receiveOpts);
 
+		const syncGroupOpts = {
+			receivers: [{}, {}],
+			toleranceMs: 5,
+			bufferMs: 40,
+			callback: vi.fn(),
+		};
+		await grandi.syncGroup(syncGroupOpts as never);
+		expect(addon.syncGroup).toHaveBeenLastCalledWith(syncGroupOpts);
+
+		const multiviewerOpts = {
+			name: "unit-wall",
+			tiles: [{ receiver: {}, width: 480, height: 270 }],
+		};
+		await grandi.multiviewer(multiviewerOpts as never);
+		expect(addon.multiviewer).toHaveBeenLastCalledWith(multiviewerOpts);
+
+		const shmOpts = { receiver: {}, name: "unit-ring", slots: 8 };
+		await grandi.default.publishShm(shmOpts as never);
+		expect(addon.publishShm).toHaveBeenLastCalledWith(shmOpts);
+		const inputOpts = { sender: {}, name: "unit-input" };
+		await grandi.sendShm(inputOpts as never);
+		expect(addon.sendShm).toHaveBeenLastCalledWith(inputOpts);
+		const pipeOpts = { receiver: {}, fd: 9, container: "y4m" };
+		await grandi.default.pipe(pipeOpts as never);
+		expect(addon.pipe).toHaveBeenLastCalledWith(pipeOpts);
+		const recordOpts = { receiver: {}, path: "/tmp/unit.grec", threads: 2 };
+		await grandi.default.record(recordOpts as never);
+		expect(addon.record).toHaveBeenLastCalledWith(recordOpts);
+		await grandi.default.openRecording({ path: "/tmp/unit.grec" });
+		expect(addon.openRecording).toHaveBeenLastCalledWith({
+			path: "/tmp/unit.grec",
+		});
+
+		expect(grandi.clock.now()).toBe(42n);
+		expect(grandi.clock.toMonotonic(5n, "source")).toBe(7n);
+		expect(addon.clockToMonotonic).toHaveBeenLastCalledWith(5n, "source");
+		expect(grandi.default.clock.sources()).toEqual([]);
+
+		const frame = { xres: 2, yres: 2 };
+		expect(grandi.splitFields(frame as never)).toHaveLength(2);
+		expect(addon.splitFields).toHaveBeenLastCalledWith(frame);
+		grandi.default.weaveFields(frame as never, frame as never);
+		expect(addon.weaveFields).toHaveBeenLastCalledWith(frame, frame);
+
+		const rate = { frameRateN: 30000, frameRateD: 1001 };
+		expect(grandi.formatTimecode(0n, rate)).toBe("00:00:00;00");
+		expect(addon.formatTimecode).toHaveBeenLastCalledWith(0n, rate);
+		expect(grandi.default.frameTimecode(0, rate)).toBe(0n);
+		expect(addon.frameTimecode).toHaveBeenLastCalledWith(0, rate);
+		const quality = await grandi.compareFrames(
+			frame as never,
+			frame as never,
+			{ ssim: false },
+		);
+		expect(quality.psnr).toBe(40);
+		expect(addon.compareFrames).toHaveBeenLastCalledWith(frame, frame, {
+			ssim: false,
+		});
+		expect(grandi.default.hashFrame(frame as never, "sampled")).toBe(
+			"d1a90af11d79a67c",
+		);
+		expect(addon.hashFrame).toHaveBeenLastCalledWith(frame, "sampled");
+		expect(grandi.default.workerThreads()).toBe(8);
+		grandi.setWorkerThreads(2);
+		expect(addon.setWorkerThreads).toHaveBeenLastCalledWith(2);
+		grandi.setWorkerThreads(2, { cpus: [1, 2] });
+		expect(addon.setWorkerThreads).toHaveBeenLastCalledWith(2, {
+			cpus: [1, 2],
+		});
+		expect(grandi.default.copyStrategy().mode).toBe("auto");
+		grandi.setCopyStrategy({ mode: "streaming" });
+		expect(addon.setCopyStrategy).toHaveBeenLastCalledWith({
+			mode: "streaming",
+		});
+		const target = Buffer.alloc(4);
+		const source = Buffer.from([1, 2]);
+		grandi.default.copyBuffer(target, source);
+		expect(addon.copyBuffer).toHaveBeenLastCalledWith(target, source);
+		expect(grandi.default.frameAllocator().hugePages).toBe("transparent");
+		grandi.setFrameAllocator({ hugePages: "off", cacheBytes: 0 });
+		expect(addon.setFrameAllocator).toHaveBeenLastCalledWith({
+			hugePages: "off",
+			cacheBytes: 0,
+		});
+		expect(grandi.frameAllocatorStats().recycled).toBe(1);
+		expect(grandi.default.frameBudget().policy).toBe("drop");
+		grandi.setFrameBudget({ bytes: 1 << 30, policy: "wait" });
+		expect(addon.setFrameBudget).toHaveBeenLastCalledWith({
+			bytes: 1 << 30,
+			policy: "wait",
+		});
+		expect(grandi.frameBudgetStats().dropped).toBe(2);
+		expect(grandi.default.threadTopology()[0].role).toBe("javascript");
+		const adopted = grandi.adopt({ kind: "sender", id: 2 });
+		expect(addon.adopt).toHaveBeenLastCalledWith({ kind: "sender", id: 2 });
+		expect(adopted.sourceName()).toBe("stub-sender");
+		expect(adopted.tally().onProgram).toBe(true);
+
 		const routingOpts = { name: "unit-route", groups: "g1" } as const;
 		await grandi.routing(routingOpts as never);
 		expect(addon.routing).toHaveBeenLastCalledWith(routingOpts);
@@ -323,6 +520,60 @@ describe("src/index entrypoint", () => {
 		expect(addon.destroy).toHaveBeenCalled();
 	});
 
+	it("validates receiver pools and reads empty frame channels", async () => {
+		const addon = createAddonMock();
+		const nodeGypBuild = Object.assign(vi.fn(() => addon), {
+			path: vi.fn(() => "/addon/grandi.node"),
+		});
+		restorePlatform = mockProcessProperty("platform", "linux");
+		restoreArch = mockProcessProperty("arch", "x64");
+		vi.doMock("node-gyp-build", () => ({ default: nodeGypBuild }));
+
+		const grandi = await import("../../src/index.js");
+
+		expect(() => grandi.receiverPool({ workers: 0 })).toThrow(
+			"workers must be an integer between 1 and 64.",
+		);
+		expect(() => grandi.default.receiverPool({ slots: 1.5 })).toThrow(
+			"slots must be an integer between 2 and 16.",
+		);
+
+		const channel = {
+			buffer: new SharedArrayBuffer(64 + 2 * 64 + 2 * 64),
+			slots: 2,
+			slotBytes: 64,
+		};
+		const frames = grandi.openFrameChannel(channel);
+		expect(frames.latest()).toBeUndefined();
+		await expect(frames.next(10)).resolves.toBeUndefined();
+		expect(frames.stats()).toEqual({
+			written: 0,
+			read: 0,
+			skipped: 0,
+			oversized: 0,
+			errors: 0,
+			closed: false,
+		});
+
+		// Frame 0 complete in slot 0, as the pool's worker writes it.
+		const records = new Int32Array(channel.buffer);
+		const times = new BigInt64Array(channel.buffer);
+		times[8] = 2n;
+		records[18] = 4;
+		records[19] = 2;
+		records[20] = 1;
+		times[0] = 1n;
+		const frame = frames.latest();
+		expect(frame).toMatchObject({ type: "video", xres: 2, yres: 1 });
+		expect(frame?.data.buffer).toBe(channel.buffer);
+		expect(frame?.data.byteOffset).toBe(64 + 2 * 64);
+		expect(frame?.valid()).toBe(true);
+		// The worker starts on frame 2, which shares the slot.
+		times[8] = 5n;
+		expect(frame?.valid()).toBe(false);
+		expect(frames.latest()).toBeUndefined();
+	});
+
 	it("retains supported-platform addon failures and their causes", async () => {
 		const localError = new Error("local binding is unavailable");
 		restorePlatform = mockProcessProperty("platform", "linux");